@@ -116,26 +116,23 @@ cShapeSphere* cursor[MAX_DEVICES];
 // some lines representing the velocity vector of each haptic device
 cShapeLine* velocity[MAX_DEVICES];
 
+// snapshots passing the pose of each cursor from its haptic loop to the graphics loop
+cSceneSnapshot* snapshot[MAX_DEVICES];
+
 // a flag for using damping (ON/OFF)
 bool useDamping = false;
 
 // a flag for using force field (ON/OFF)
 bool useForceField = true;
 
-// a flag to indicate if the haptic simulation currently running
-bool simulationRunning = false;
-
-// a flag to indicate if the haptic simulation has terminated
-bool simulationFinished = true;
-
 // a frequency counter to measure the simulation graphic rate
 cFrequencyCounter freqCounterGraphics;
 
 // a frequency counter to measure the simulation haptic rate
 cFrequencyCounter freqCounterHaptics;
 
-// haptic thread
-cThread* hapticsThread;
+// haptic scheduler running one haptic loop per device
+cHapticScheduler* hapticScheduler;
 
 // a handle to window display context
 GLFWwindow* window = NULL;
@@ -166,8 +163,8 @@ void keyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action,
 // this function renders the scene
 void updateGraphics(void);
 
-// this function contains the main haptics simulation loop
-void updateHaptics(void);
+// this function is called by the haptic scheduler at every cycle of each device loop
+void updateHaptics(cGenericHapticDevicePtr a_device, const double a_timeStep, void* a_userData);
 
 // this function closes the application
 void close(void);
@@ -365,6 +362,10 @@ int main(int argc, char* argv[])
         // insert cursor inside world
         world->addChild(cursor[i]);
 
+        // render the cursor from the poses published by its haptic loop
+        snapshot[i] = new cSceneSnapshot();
+        snapshot[i]->addObject(cursor[i]);
+
         // create small line to illustrate the velocity of the haptic device
         velocity[i] = new cShapeLine(cVector3d(0,0,0), cVector3d(0,0,0));
 
@@ -404,9 +405,13 @@ int main(int argc, char* argv[])
     // START SIMULATION
     //--------------------------------------------------------------------------
 
-    // create a thread which starts the main haptics rendering loop
-    hapticsThread = new cThread();
-    hapticsThread->start(updateHaptics, CTHREAD_PRIORITY_HAPTICS);
+    // create a scheduler which runs one haptic loop per device at 1 kHz
+    hapticScheduler = new cHapticScheduler();
+    for (int i=0; i<numHapticDevices; i++)
+    {
+        hapticScheduler->addDevice(hapticDevice[i], updateHaptics, (void*)(size_t)i, 1000.0);
+    }
+    hapticScheduler->start();
 
     // setup callback when application exits
     atexit(close);
@@ -554,11 +559,8 @@ void keyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action,
 
 void close(void)
 {
-    // stop the simulation
-    simulationRunning = false;
-
-    // wait for graphics and haptics loops to terminate
-    while (!simulationFinished) { cSleepMs(100); }
+    // stop the haptic loops and wait for them to terminate
+    hapticScheduler->stop();
 
     // close haptic device
     for (int i=0; i<numHapticDevices; i++)
@@ -567,7 +569,11 @@ void close(void)
     }
 
     // delete resources
-    delete hapticsThread;
+    delete hapticScheduler;
+    for (int i=0; i<numHapticDevices; i++)
+    {
+        delete snapshot[i];
+    }
     delete world;
     delete handler;
 }
@@ -593,8 +599,18 @@ void updateGraphics(void)
     }
     else
     {
+        // count deadline overruns over all haptic loops
+        int numOverruns = 0;
+        for (int i=0; i<numHapticDevices; i++)
+        {
+            cHapticSchedulerStatistics stats;
+            hapticScheduler->getStatistics(stats, i);
+            numOverruns += stats.m_numOverruns;
+        }
+
         labelRates->setText(cStr(freqCounterGraphics.getFrequency(), 0) + " Hz / " +
-            cStr(freqCounterHaptics.getFrequency(), 0) + " Hz");
+            cStr(freqCounterHaptics.getFrequency(), 0) + " Hz / " +
+            cStr(numOverruns) + " overruns");
     }
 
     // update position of label
@@ -605,6 +621,12 @@ void updateGraphics(void)
     // RENDER SCENE
     /////////////////////////////////////////////////////////////////////
 
+    // acquire the latest cursor poses published by the haptic loops
+    for (int i=0; i<numHapticDevices; i++)
+    {
+        snapshot[i]->update();
+    }
+
     // update shadow maps (if any)
     world->updateShadowMaps(false, mirroredDisplay);
 
@@ -622,161 +644,156 @@ void updateGraphics(void)
 
 //------------------------------------------------------------------------------
 
-void updateHaptics(void)
+void updateHaptics(cGenericHapticDevicePtr a_device, const double a_timeStep, void* a_userData)
 {
-    // simulation in now running
-    simulationRunning  = true;
-    simulationFinished = false;
+    // index of the device handled by this loop
+    int i = (int)(size_t)a_userData;
+
+    /////////////////////////////////////////////////////////////////////
+    // READ HAPTIC DEVICE
+    /////////////////////////////////////////////////////////////////////
+
+    // read position 
+    cVector3d position;
+    a_device->getPosition(position);
+
+    // read orientation 
+    cMatrix3d rotation;
+    a_device->getRotation(rotation);
+
+    // read gripper position
+    double gripperAngle;
+    a_device->getGripperAngleRad(gripperAngle);
+
+    // read linear velocity 
+    cVector3d linearVelocity;
+    a_device->getLinearVelocity(linearVelocity);
+
+    // read angular velocity
+    cVector3d angularVelocity;
+    a_device->getAngularVelocity(angularVelocity);
+
+    // read gripper angular velocity
+    double gripperAngularVelocity;
+    a_device->getGripperAngularVelocity(gripperAngularVelocity);
+
+    // read user-switch status (button 0)
+    bool button0, button1, button2, button3;
+    button0 = false;
+    button1 = false;
+    button2 = false;
+    button3 = false;
+
+    a_device->getUserSwitch(0, button0);
+    a_device->getUserSwitch(1, button1);
+    a_device->getUserSwitch(2, button2);
+    a_device->getUserSwitch(3, button3);
+
+
+    /////////////////////////////////////////////////////////////////////
+    // UPDATE 3D CURSOR MODEL
+    /////////////////////////////////////////////////////////////////////
+
+    // update arrow
+    velocity[i]->m_pointA = position;
+    velocity[i]->m_pointB = cAdd(position, linearVelocity);
 
-    // main haptic simulation loop
-    while(simulationRunning)
+    // update position and orientation of cursor
+    cursor[i]->setLocalPos(position);
+    cursor[i]->setLocalRot(rotation);
+
+    // adjust the  color of the cursor according to the status of
+    // the user-switch (ON = TRUE / OFF = FALSE)
+    if (button0)
     {
-        for (int i=0; i<numHapticDevices; i++)
-        {
-            /////////////////////////////////////////////////////////////////////
-            // READ HAPTIC DEVICE
-            /////////////////////////////////////////////////////////////////////
-
-            // read position 
-            cVector3d position;
-            hapticDevice[i]->getPosition(position);
-
-            // read orientation 
-            cMatrix3d rotation;
-            hapticDevice[i]->getRotation(rotation);
-
-            // read gripper position
-            double gripperAngle;
-            hapticDevice[i]->getGripperAngleRad(gripperAngle);
-
-            // read linear velocity 
-            cVector3d linearVelocity;
-            hapticDevice[i]->getLinearVelocity(linearVelocity);
-
-            // read angular velocity
-            cVector3d angularVelocity;
-            hapticDevice[i]->getAngularVelocity(angularVelocity);
-
-            // read gripper angular velocity
-            double gripperAngularVelocity;
-            hapticDevice[i]->getGripperAngularVelocity(gripperAngularVelocity);
-
-            // read user-switch status (button 0)
-            bool button0, button1, button2, button3;
-            button0 = false;
-            button1 = false;
-            button2 = false;
-            button3 = false;
-
-            hapticDevice[i]->getUserSwitch(0, button0);
-            hapticDevice[i]->getUserSwitch(1, button1);
-            hapticDevice[i]->getUserSwitch(2, button2);
-            hapticDevice[i]->getUserSwitch(3, button3);
-
-
-            /////////////////////////////////////////////////////////////////////
-            // UPDATE 3D CURSOR MODEL
-            /////////////////////////////////////////////////////////////////////
-       
-            // update arrow
-            velocity[i]->m_pointA = position;
-            velocity[i]->m_pointB = cAdd(position, linearVelocity);
-
-            // update position and orientation of cursor
-            cursor[i]->setLocalPos(position);
-            cursor[i]->setLocalRot(rotation);
-
-            // adjust the  color of the cursor according to the status of
-            // the user-switch (ON = TRUE / OFF = FALSE)
-            if (button0)
-            {
-                cursor[i]->m_material->setGreenMediumAquamarine(); 
-            }
-            else if (button1)
-            {
-                cursor[i]->m_material->setYellowGold();
-            }
-            else if (button2)
-            {
-                cursor[i]->m_material->setOrangeCoral();
-            }
-            else if (button3)
-            {
-                cursor[i]->m_material->setPurpleLavender();
-            }
-            else
-            {
-                cursor[i]->m_material->setBlueRoyal();
-            }
-
-            // update global variable for graphic display update
-            hapticDevicePosition[i] = position;
-
-
-            /////////////////////////////////////////////////////////////////////
-            // COMPUTE AND APPLY FORCES
-            /////////////////////////////////////////////////////////////////////
-            
-            // desired position
-            cVector3d desiredPosition;
-            desiredPosition.set(0.0, 0.0, 0.0);
-
-            // desired orientation
-            cMatrix3d desiredRotation;
-            desiredRotation.identity();
-
-            // variables for forces    
-            cVector3d force (0,0,0);
-            cVector3d torque (0,0,0);
-            double gripperForce = 0.0;
-
-            // apply force field
-            if (useForceField)
-            {
-                // compute linear force
-                double Kp = 25; // [N/m]
-                cVector3d forceField = Kp * (desiredPosition - position);
-                force.add(forceField);
-
-                // compute angular torque
-                double Kr = 0.05; // [N/m.rad]
-                cVector3d axis;
-                double angle;
-                cMatrix3d deltaRotation = cTranspose(rotation) * desiredRotation;
-                deltaRotation.toAxisAngle(axis, angle);
-                torque = rotation * ((Kr * angle) * axis);
-            }
+        cursor[i]->m_material->setGreenMediumAquamarine(); 
+    }
+    else if (button1)
+    {
+        cursor[i]->m_material->setYellowGold();
+    }
+    else if (button2)
+    {
+        cursor[i]->m_material->setOrangeCoral();
+    }
+    else if (button3)
+    {
+        cursor[i]->m_material->setPurpleLavender();
+    }
+    else
+    {
+        cursor[i]->m_material->setBlueRoyal();
+    }
+
+    // update global variable for graphic display update
+    hapticDevicePosition[i] = position;
+
+    // publish the new pose of the cursor to the graphics loop
+    snapshot[i]->publish();
+
+
+    /////////////////////////////////////////////////////////////////////
+    // COMPUTE AND APPLY FORCES
+    /////////////////////////////////////////////////////////////////////
     
-            // apply damping term
-            if (useDamping)
-            {
-                cHapticDeviceInfo info = hapticDevice[i]->getSpecifications();
-
-                // compute linear damping force
-                double Kv = 1.0 * info.m_maxLinearDamping;
-                cVector3d forceDamping = -Kv * linearVelocity;
-                force.add(forceDamping);
-
-                // compute angular damping force
-                double Kvr = 1.0 * info.m_maxAngularDamping;
-                cVector3d torqueDamping = -Kvr * angularVelocity;
-                torque.add(torqueDamping);
-
-                // compute gripper angular damping force
-                double Kvg = 1.0 * info.m_maxGripperAngularDamping;
-                gripperForce = gripperForce - Kvg * gripperAngularVelocity;
-            }
-
-            // send computed force, torque, and gripper force to haptic device
-            hapticDevice[i]->setForceAndTorqueAndGripperForce(force, torque, gripperForce);
-        }
+    // desired position
+    cVector3d desiredPosition;
+    desiredPosition.set(0.0, 0.0, 0.0);
+
+    // desired orientation
+    cMatrix3d desiredRotation;
+    desiredRotation.identity();
+
+    // variables for forces    
+    cVector3d force (0,0,0);
+    cVector3d torque (0,0,0);
+    double gripperForce = 0.0;
 
-        // update frequency counter
+    // apply force field
+    if (useForceField)
+    {
+        // compute linear force
+        double Kp = 25; // [N/m]
+        cVector3d forceField = Kp * (desiredPosition - position);
+        force.add(forceField);
+
+        // compute angular torque
+        double Kr = 0.05; // [N/m.rad]
+        cVector3d axis;
+        double angle;
+        cMatrix3d deltaRotation = cTranspose(rotation) * desiredRotation;
+        deltaRotation.toAxisAngle(axis, angle);
+        torque = rotation * ((Kr * angle) * axis);
+    }
+
+    // apply damping term
+    if (useDamping)
+    {
+        cHapticDeviceInfo info = a_device->getSpecifications();
+
+        // compute linear damping force
+        double Kv = 1.0 * info.m_maxLinearDamping;
+        cVector3d forceDamping = -Kv * linearVelocity;
+        force.add(forceDamping);
+
+        // compute angular damping force
+        double Kvr = 1.0 * info.m_maxAngularDamping;
+        cVector3d torqueDamping = -Kvr * angularVelocity;
+        torque.add(torqueDamping);
+
+        // compute gripper angular damping force
+        double Kvg = 1.0 * info.m_maxGripperAngularDamping;
+        gripperForce = gripperForce - Kvg * gripperAngularVelocity;
+    }
+
+    // send computed force, torque, and gripper force to haptic device
+    a_device->setForceAndTorqueAndGripperForce(force, torque, gripperForce);
+
+    // update frequency counter
+    if (i == 0)
+    {
         freqCounterHaptics.signal(1);
     }
-    
-    // exit haptics thread
-    simulationFinished = true;
 }
 
 //------------------------------------------------------------------------------
@@ -952,6 +952,7 @@ void mouseButtonCallback(GLFWwindow* a_window, int a_button, int a_action, int a
 
                 // update voxel data
                 object->m_texture->markForUpdate();
+                object->updateOccupancy(voxelX, voxelY, voxelZ, voxelX, voxelY, voxelZ);
             }
         }
     }
@@ -1138,6 +1139,10 @@ void updateHaptics(void)
                 cColorb color(0x00, 0x00, 0x00, 0x00);
                 object->m_texture->m_image->setVoxelColor(contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ, color);
 
+                // update occupancy used for collision detection
+                object->updateOccupancy(contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ,
+                                        contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ);
+
                 // mark voxel for update
                 mutexVoxel.acquire();
                 volumeUpdate.enclose(cVector3d(contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ));
@@ -1205,6 +1210,7 @@ void buildVoxelShape(double a_radiusSphere, double a_radiusCylinder)
     }
 
     texture->markForUpdate();
+    object->invalidateOccupancy();
 
     mutexVoxel.release();
 }
@@ -1235,6 +1241,7 @@ void buildVoxelCube()
     }
 
     texture->markForUpdate();
+    object->invalidateOccupancy();
 
     mutexVoxel.release();
 }
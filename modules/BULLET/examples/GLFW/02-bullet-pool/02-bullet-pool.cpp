@@ -313,6 +313,9 @@ int main(int argc, char* argv[])
     // set the background color of the environment
     bulletWorld->m_backgroundColor.setWhite();
 
+    // only test the objects located near the haptic points for collisions
+    bulletWorld->setUseBroadphase(true);
+
     // create a camera and insert it into the virtual world
     camera = new cCamera(bulletWorld);
     bulletWorld->addChild(camera);
@@ -102,6 +102,12 @@ public:
         m_externalForce = a_force;
     }
 
+    //! This method returns the external force applied to this mass particle.
+    inline const chai3d::cVector3d& getExternalForce() const
+    {
+        return (m_externalForce);
+    }
+
     //! This method updates the simulation over a specified time interval.
     inline void computeNextPose(double a_timeInterval)
     {
@@ -59,6 +59,100 @@ void cGELMesh::initialise()
     m_showMassParticleModel = false;
     m_useSkeletonModel = false;
     m_useMassParticleModel = false;
+    m_solverBackend = C_GEL_SOLVER_LIST;
+    m_integrator = C_GEL_INTEGRATOR_SYMPLECTIC_EULER;
+    m_particleSolver = NULL;
+    m_particleSolverValid = false;
+    m_particleSolverEnabled = false;
+    m_workerPool = NULL;
+    m_solverSelected = false;
+}
+
+
+//===========================================================================
+/*!
+    Destructor of cGELMesh.
+*/
+//===========================================================================
+cGELMesh::~cGELMesh()
+{
+    if (m_particleSolver != NULL)
+    {
+        delete m_particleSolver;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method selects the solver used to simulate the mass-particle model.
+    With __C_GEL_SOLVER_LIST__, each particle and spring updates itself.
+    With __C_GEL_SOLVER_SOA__, the model is simulated by a
+    cGELParticleSolver, optionally distributed over a worker pool. Both
+    backends produce identical results. The skeleton model is not affected
+    by this setting.
+
+    \param  a_backend     Solver backend.
+    \param  a_workerPool  Worker pool used by the particle solver (__NULL__
+                          to run on the calling thread only).
+*/
+//===========================================================================
+void cGELMesh::setSolverBackend(cGELSolverBackend a_backend,
+                                cWorkerPool* a_workerPool)
+{
+    if (a_backend != m_solverBackend)
+    {
+        m_particleSolverValid = false;
+    }
+    m_solverBackend = a_backend;
+    m_workerPool = a_workerPool;
+    m_solverSelected = true;
+}
+
+
+//===========================================================================
+/*!
+    This method returns __true__ if the mass-particle model is simulated by
+    the particle solver, which is the case with the __C_GEL_SOLVER_SOA__
+    backend or the backward Euler integrator. The solver is rebuilt when it
+    has been invalidated or when particles or springs have been added or
+    removed. If the model contains springs connected to particles of another
+    mesh, the list-based solver and symplectic Euler are used instead.
+
+    \return __true__ if the particle solver is used, __false__ otherwise.
+*/
+//===========================================================================
+bool cGELMesh::useParticleSolver()
+{
+    if ((!m_useMassParticleModel) ||
+        ((m_solverBackend != C_GEL_SOLVER_SOA) && (m_integrator != C_GEL_INTEGRATOR_BACKWARD_EULER)))
+    {
+        return (false);
+    }
+
+    if (m_particleSolver == NULL)
+    {
+        m_particleSolver = new cGELParticleSolver();
+    }
+
+    // check for added or removed particles and springs
+    if (m_particleSolverValid && m_particleSolverEnabled)
+    {
+        if ((m_particleSolver->getNumParticles() != m_gelVertices.size()) ||
+            (m_particleSolver->getNumSprings() != m_linearSprings.size()))
+        {
+            m_particleSolverValid = false;
+        }
+    }
+
+    // rebuild solver
+    if (!m_particleSolverValid)
+    {
+        m_particleSolverEnabled = m_particleSolver->build(m_gelVertices, m_linearSprings);
+        m_particleSolverValid = true;
+    }
+
+    return (m_particleSolverEnabled);
 }
 
 
@@ -78,7 +172,7 @@ void cGELMesh::clearForces()
             (*i)->clearForces();
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && !useParticleSolver())
     {
         vector<cGELVertex>::iterator i;
 
@@ -135,7 +229,7 @@ void cGELMesh::computeForces()
             (*i)->computeForces();
         }
     }
-    if (m_useMassParticleModel)
+    if (m_useMassParticleModel && !useParticleSolver())
     {
         list<cGELLinearSpring*>::iterator i;
 
@@ -168,11 +262,19 @@ void cGELMesh::computeNextPose(double a_timeInterval)
     }
     if (m_useMassParticleModel)
     {
-        vector<cGELVertex>::iterator i;
-
-        for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+        if (useParticleSolver())
         {
-            i->m_massParticle->computeNextPose(a_timeInterval);
+            m_particleSolver->setIntegrator(m_integrator);
+            m_particleSolver->computeNextPose(a_timeInterval, m_workerPool);
+        }
+        else
+        {
+            vector<cGELVertex>::iterator i;
+
+            for(i = m_gelVertices.begin(); i != m_gelVertices.end(); ++i)
+            {
+                i->m_massParticle->computeNextPose(a_timeInterval);
+            }
         }
     }
 }
@@ -49,6 +49,7 @@
 #include "CGELSkeletonLink.h"
 #include "CGELLinearSpring.h"
 #include "CGELVertex.h"
+#include "CGELParticleSolver.h"
 //---------------------------------------------------------------------------
 #include "chai3d.h"
 //---------------------------------------------------------------------------
@@ -84,7 +85,7 @@ public:
     cGELMesh(){ initialise(); };
 
     //! Destructor of cGELMesh.
-    virtual ~cGELMesh() {};
+    virtual ~cGELMesh();
 
 
     //-----------------------------------------------------------------------
@@ -120,6 +121,28 @@ public:
     //! This method renders the deformable mesh graphically.
     virtual void render(chai3d::cRenderOptions& a_options);
 
+    //! This method selects the solver used to simulate the mass-particle model.
+    void setSolverBackend(cGELSolverBackend a_backend,
+                          chai3d::cWorkerPool* a_workerPool = NULL);
+
+    //! This method returns the solver used to simulate the mass-particle model.
+    cGELSolverBackend getSolverBackend() const { return (m_solverBackend); }
+
+    //! This method requests the particle solver to be rebuilt after springs or particles have been modified.
+    void invalidateSolver() { m_particleSolverValid = false; }
+
+    //! This method selects the time integration scheme of the mass-particle model.
+    void setIntegrator(cGELIntegrator a_integrator) { m_integrator = a_integrator; m_solverSelected = true; }
+
+    //! This method returns the time integration scheme of the mass-particle model.
+    cGELIntegrator getIntegrator() const { return (m_integrator); }
+
+    //! This method returns __true__ if a solver or an integrator has been selected for this mesh, either directly or by its world.
+    bool getSolverSelected() const { return (m_solverSelected); }
+
+    //! This method returns the particle solver, or __NULL__ if the mass-particle model is updated by the list-based solver.
+    cGELParticleSolver* getParticleSolver() { return (useParticleSolver() ? m_particleSolver : NULL); }
+
 
     //-----------------------------------------------------------------------
     // MEMBERS:
@@ -160,6 +183,37 @@ private:
 
     //! This method initializes the deformable mesh.
     void initialise();
+
+    //! This method returns __true__ if the mass-particle model is simulated by the particle solver, rebuilding it if needed.
+    bool useParticleSolver();
+
+
+    //-----------------------------------------------------------------------
+    // MEMBERS - SOLVER:
+    //-----------------------------------------------------------------------
+
+private:
+
+    //! Solver used to simulate the mass-particle model.
+    cGELSolverBackend m_solverBackend;
+
+    //! Time integration scheme of the mass-particle model.
+    cGELIntegrator m_integrator;
+
+    //! Particle solver used by the __C_GEL_SOLVER_SOA__ backend.
+    cGELParticleSolver* m_particleSolver;
+
+    //! If __true__, then the particle solver has been built from the current particles and springs.
+    bool m_particleSolverValid;
+
+    //! If __true__, then the particle solver was built successfully and simulates the mass-particle model.
+    bool m_particleSolverEnabled;
+
+    //! Worker pool used by the particle solver (__NULL__ to run on the calling thread).
+    chai3d::cWorkerPool* m_workerPool;
+
+    //! If __true__, then a solver or an integrator has been selected for this mesh.
+    bool m_solverSelected;
 };
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,1127 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 1869 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include "CGELParticleSolver.h"
+//---------------------------------------------------------------------------
+#if !defined(C_DISABLE_SIMD) && defined(__AVX2__)
+#define C_GEL_SOLVER_AVX2
+#include <immintrin.h>
+#endif
+//---------------------------------------------------------------------------
+#include <map>
+//---------------------------------------------------------------------------
+using namespace chai3d;
+using namespace std;
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    Constructor of cGELParticleSolver.
+*/
+//===========================================================================
+cGELParticleSolver::cGELParticleSolver()
+{
+    m_timeInterval = 0.0;
+    m_integrator = C_GEL_INTEGRATOR_SYMPLECTIC_EULER;
+    m_alpha = 0.0;
+    m_beta = 0.0;
+    m_maxIterations = C_GEL_SOLVER_CG_MAX_ITERATIONS;
+    m_tolerance = C_GEL_SOLVER_CG_TOLERANCE;
+    m_numIterations = 0;
+    m_workerPool = NULL;
+}
+
+
+//===========================================================================
+/*!
+    This method builds the solver buffers from the mass particles of a set
+    of deformable vertices and from a list of springs.
+
+    \param  a_vertices  Deformable vertices owning the mass particles.
+    \param  a_springs   Linear springs connecting the mass particles.
+
+    \return __true__ if successful, __false__ if a spring is connected to a
+            particle that does not belong to __a_vertices__.
+*/
+//===========================================================================
+bool cGELParticleSolver::build(vector<cGELVertex>& a_vertices,
+                               list<cGELLinearSpring*>& a_springs)
+{
+    // particles
+    m_particles.clear();
+    map<cGELMassParticle*, int> indices;
+    vector<cGELVertex>::iterator it;
+    for (it = a_vertices.begin(); it != a_vertices.end(); ++it)
+    {
+        if (it->m_massParticle != NULL)
+        {
+            indices[it->m_massParticle] = (int)(m_particles.size());
+            m_particles.push_back(it->m_massParticle);
+        }
+    }
+
+    unsigned int numParticles = (unsigned int)(m_particles.size());
+    m_posX.resize(numParticles);
+    m_posY.resize(numParticles);
+    m_posZ.resize(numParticles);
+    m_velX.resize(numParticles);
+    m_velY.resize(numParticles);
+    m_velZ.resize(numParticles);
+    m_systemMass.resize(numParticles);
+    for (int k=0; k<3; k++)
+    {
+        m_diagonal[k].resize(numParticles);
+        m_solution[k].assign(numParticles, 0.0);
+        m_residual[k].resize(numParticles);
+        m_precondResidual[k].resize(numParticles);
+        m_direction[k].resize(numParticles);
+        m_product[k].resize(numParticles);
+    }
+
+    unsigned int numChunks = (numParticles + C_GEL_SOLVER_PARTICLE_CHUNK_SIZE - 1) / C_GEL_SOLVER_PARTICLE_CHUNK_SIZE;
+    m_partialSum0.resize(numChunks);
+    m_partialSum1.resize(numChunks);
+
+    // springs
+    m_springNode0.clear();
+    m_springNode1.clear();
+    m_springStiffness.clear();
+    m_springLength0.clear();
+
+    list<cGELLinearSpring*>::iterator is;
+    for (is = a_springs.begin(); is != a_springs.end(); ++is)
+    {
+        cGELLinearSpring* spring = *is;
+        map<cGELMassParticle*, int>::iterator node0 = indices.find(spring->m_node0);
+        map<cGELMassParticle*, int>::iterator node1 = indices.find(spring->m_node1);
+        if ((node0 == indices.end()) || (node1 == indices.end()))
+        {
+            clear();
+            return (false);
+        }
+
+        m_springNode0.push_back(node0->second);
+        m_springNode1.push_back(node1->second);
+        m_springStiffness.push_back(spring->m_kSpringElongation);
+        m_springLength0.push_back(spring->m_length0);
+    }
+
+    unsigned int numSprings = (unsigned int)(m_springNode0.size());
+    m_springForceX.resize(2 * numSprings);
+    m_springForceY.resize(2 * numSprings);
+    m_springForceZ.resize(2 * numSprings);
+    m_springStiffnessMatrix.resize(6 * numSprings);
+
+    // springs attached to each particle, in spring order
+    m_particleSpringOffsets.assign(numParticles + 1, 0);
+    for (unsigned int i=0; i<numSprings; i++)
+    {
+        m_particleSpringOffsets[m_springNode0[i] + 1]++;
+        m_particleSpringOffsets[m_springNode1[i] + 1]++;
+    }
+    for (unsigned int i=0; i<numParticles; i++)
+    {
+        m_particleSpringOffsets[i + 1] += m_particleSpringOffsets[i];
+    }
+
+    m_particleSprings.resize(2 * numSprings);
+    m_particleNeighbors.resize(2 * numSprings);
+    vector<unsigned int> count(m_particleSpringOffsets.begin(), m_particleSpringOffsets.end() - 1);
+    for (unsigned int i=0; i<numSprings; i++)
+    {
+        unsigned int index0 = count[m_springNode0[i]]++;
+        m_particleSprings[index0] = i;
+        m_particleNeighbors[index0] = m_springNode1[i];
+
+        unsigned int index1 = count[m_springNode1[i]]++;
+        m_particleSprings[index1] = numSprings + i;
+        m_particleNeighbors[index1] = m_springNode0[i];
+    }
+
+    return (true);
+}
+
+
+//===========================================================================
+/*!
+    This method releases all particles and springs from the solver.
+*/
+//===========================================================================
+void cGELParticleSolver::clear()
+{
+    m_particles.clear();
+    m_posX.clear();
+    m_posY.clear();
+    m_posZ.clear();
+    m_velX.clear();
+    m_velY.clear();
+    m_velZ.clear();
+    m_systemMass.clear();
+    for (int k=0; k<3; k++)
+    {
+        m_diagonal[k].clear();
+        m_solution[k].clear();
+        m_residual[k].clear();
+        m_precondResidual[k].clear();
+        m_direction[k].clear();
+        m_product[k].clear();
+    }
+    m_partialSum0.clear();
+    m_partialSum1.clear();
+    m_springNode0.clear();
+    m_springNode1.clear();
+    m_springStiffness.clear();
+    m_springLength0.clear();
+    m_springForceX.clear();
+    m_springForceY.clear();
+    m_springForceZ.clear();
+    m_particleSpringOffsets.clear();
+    m_particleSprings.clear();
+    m_particleNeighbors.clear();
+    m_springStiffnessMatrix.clear();
+}
+
+
+//===========================================================================
+/*!
+    This method computes the next position of every particle over a time
+    interval. The forces, accelerations, velocities, and next positions of
+    the particles are written back to the cGELMassParticle objects; the new
+    positions are applied by cGELMassParticle::applyNextPose().
+
+    \param  a_timeInterval  Time interval.
+    \param  a_workerPool    Worker pool used to distribute the computations
+                            (__NULL__ to run on the calling thread only).
+*/
+//===========================================================================
+void cGELParticleSolver::computeNextPose(const double a_timeInterval,
+                                         cWorkerPool* a_workerPool)
+{
+    m_timeInterval = a_timeInterval;
+    m_workerPool = a_workerPool;
+
+    unsigned int numParticles = getNumParticles();
+    unsigned int numSprings = getNumSprings();
+
+    execute(gatherParticlesTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+    execute(computeSpringForcesTask, numSprings, C_GEL_SOLVER_SPRING_CHUNK_SIZE);
+
+    if (m_integrator == C_GEL_INTEGRATOR_BACKWARD_EULER)
+    {
+        solveBackwardEuler();
+    }
+    else
+    {
+        execute(integrateParticlesTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+    }
+
+    m_workerPool = NULL;
+}
+
+
+//===========================================================================
+/*!
+    This method executes a task over a range of items split in chunks. The
+    chunks are distributed over the worker pool of the current step, or
+    processed in order on the calling thread if there is none.
+
+    \param  a_task       Task to execute.
+    \param  a_numItems   Number of items.
+    \param  a_chunkSize  Number of items per chunk.
+*/
+//===========================================================================
+void cGELParticleSolver::execute(cWorkerPoolTask a_task,
+                                 const unsigned int a_numItems,
+                                 const unsigned int a_chunkSize)
+{
+    if (m_workerPool != NULL)
+    {
+        m_workerPool->execute(a_task, this, a_numItems, a_chunkSize);
+        return;
+    }
+
+    for (unsigned int begin=0; begin<a_numItems; begin+=a_chunkSize)
+    {
+        unsigned int end = begin + a_chunkSize;
+        if (end > a_numItems) { end = a_numItems; }
+        a_task(this, begin, end);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the next position of every particle with the
+    backward Euler integrator. The spring forces are linearized around the
+    current positions, and the velocity change dv of the free particles is
+    obtained by solving:
+
+        ((1 + h * kd) * M + h^2 * K) * dv = h * (f - h * K * v)
+
+    where h is the time step, M the masses, kd the damping coefficients,
+    K the stiffness matrix of the springs, v the current velocities, and f
+    the forces applied at the beginning of the step. Spring forces must have
+    been computed beforehand.
+*/
+//===========================================================================
+void cGELParticleSolver::solveBackwardEuler()
+{
+    unsigned int numParticles = getNumParticles();
+    unsigned int numSprings = getNumSprings();
+    unsigned int numChunks = (unsigned int)(m_partialSum0.size());
+
+    execute(computeSpringStiffnessTask, numSprings, C_GEL_SOLVER_SPRING_CHUNK_SIZE);
+
+    // assemble system
+    execute(assembleSystemTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+
+    double bb = 0.0;
+    for (unsigned int i=0; i<numChunks; i++)
+    {
+        bb += m_partialSum1[i];
+    }
+
+    // initial residual, using the solution of the previous step as initial guess
+    execute(multiplySystemTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+    execute(initializeResidualTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+
+    double rz = 0.0;
+    double rr = 0.0;
+    for (unsigned int i=0; i<numChunks; i++)
+    {
+        rz += m_partialSum0[i];
+        rr += m_partialSum1[i];
+    }
+
+    // preconditioned conjugate gradient
+    m_numIterations = 0;
+    double threshold = m_tolerance * m_tolerance * bb;
+    while ((rr > threshold) && (m_numIterations < m_maxIterations))
+    {
+        m_numIterations++;
+
+        // step length
+        execute(multiplySystemTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+        double pq = 0.0;
+        for (unsigned int i=0; i<numChunks; i++)
+        {
+            pq += m_partialSum0[i];
+        }
+        if (pq <= 0.0) { break; }
+        m_alpha = rz / pq;
+
+        // solution and residual
+        execute(updateSolutionTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+        double rzNext = 0.0;
+        rr = 0.0;
+        for (unsigned int i=0; i<numChunks; i++)
+        {
+            rzNext += m_partialSum0[i];
+            rr += m_partialSum1[i];
+        }
+        if (rr <= threshold) { break; }
+
+        // search direction
+        m_beta = rzNext / rz;
+        rz = rzNext;
+        execute(updateDirectionTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+    }
+
+    // integrate
+    execute(applySolutionTask, numParticles, C_GEL_SOLVER_PARTICLE_CHUNK_SIZE);
+}
+
+
+//===========================================================================
+/*!
+    This method copies the positions and velocities of a range of particles
+    into the solver buffers. Fixed particles are given a zero velocity.
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::gatherParticles(const unsigned int a_begin, const unsigned int a_end)
+{
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        const cVector3d& pos = m_particles[i]->m_pos;
+        m_posX[i] = pos(0);
+        m_posY[i] = pos(1);
+        m_posZ[i] = pos(2);
+
+        if (m_particles[i]->m_fixed)
+        {
+            m_velX[i] = 0.0;
+            m_velY[i] = 0.0;
+            m_velZ[i] = 0.0;
+        }
+        else
+        {
+            const cVector3d& vel = m_particles[i]->m_vel;
+            m_velX[i] = vel(0);
+            m_velY[i] = vel(1);
+            m_velZ[i] = vel(2);
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the force applied by each spring of a range on its
+    first particle. The second particle receives the opposite force.
+
+    \param  a_begin  Index of the first spring.
+    \param  a_end    Index following the last spring.
+*/
+//===========================================================================
+void cGELParticleSolver::computeSpringForces(const unsigned int a_begin, const unsigned int a_end)
+{
+    const double* posX = &m_posX[0];
+    const double* posY = &m_posY[0];
+    const double* posZ = &m_posZ[0];
+
+    // forces applied on the second particles are stored after those applied on the first particles
+    unsigned int numSprings = getNumSprings();
+    double* forceX = &m_springForceX[0];
+    double* forceY = &m_springForceY[0];
+    double* forceZ = &m_springForceZ[0];
+
+    unsigned int i = a_begin;
+
+#ifdef C_GEL_SOLVER_AVX2
+    const __m256d minLength = _mm256_set1_pd(0.000001);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    for (; i + 4 <= a_end; i += 4)
+    {
+        __m128i node0 = _mm_loadu_si128((const __m128i*)&m_springNode0[i]);
+        __m128i node1 = _mm_loadu_si128((const __m128i*)&m_springNode1[i]);
+
+        __m256d dx = _mm256_sub_pd(_mm256_i32gather_pd(posX, node1, 8), _mm256_i32gather_pd(posX, node0, 8));
+        __m256d dy = _mm256_sub_pd(_mm256_i32gather_pd(posY, node1, 8), _mm256_i32gather_pd(posY, node0, 8));
+        __m256d dz = _mm256_sub_pd(_mm256_i32gather_pd(posZ, node1, 8), _mm256_i32gather_pd(posZ, node0, 8));
+
+        __m256d length = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx),
+                                                                    _mm256_mul_pd(dy, dy)),
+                                                      _mm256_mul_pd(dz, dz)));
+
+        __m256d f = _mm256_mul_pd(_mm256_loadu_pd(&m_springStiffness[i]),
+                                  _mm256_sub_pd(length, _mm256_loadu_pd(&m_springLength0[i])));
+        __m256d scale = _mm256_div_pd(f, length);
+        __m256d valid = _mm256_cmp_pd(length, minLength, _CMP_GT_OQ);
+
+        __m256d fx = _mm256_and_pd(valid, _mm256_mul_pd(scale, dx));
+        __m256d fy = _mm256_and_pd(valid, _mm256_mul_pd(scale, dy));
+        __m256d fz = _mm256_and_pd(valid, _mm256_mul_pd(scale, dz));
+
+        _mm256_storeu_pd(&forceX[i], fx);
+        _mm256_storeu_pd(&forceY[i], fy);
+        _mm256_storeu_pd(&forceZ[i], fz);
+        _mm256_storeu_pd(&forceX[numSprings + i], _mm256_xor_pd(fx, signMask));
+        _mm256_storeu_pd(&forceY[numSprings + i], _mm256_xor_pd(fy, signMask));
+        _mm256_storeu_pd(&forceZ[numSprings + i], _mm256_xor_pd(fz, signMask));
+    }
+#endif
+
+    for (; i<a_end; i++)
+    {
+        int node0 = m_springNode0[i];
+        int node1 = m_springNode1[i];
+
+        double dx = posX[node1] - posX[node0];
+        double dy = posY[node1] - posY[node0];
+        double dz = posZ[node1] - posZ[node0];
+        double length = sqrt((dx * dx) + (dy * dy) + (dz * dz));
+
+        // if distance too small, no forces are applied
+        if (length <= 0.000001)
+        {
+            forceX[i] = forceX[numSprings + i] = 0.0;
+            forceY[i] = forceY[numSprings + i] = 0.0;
+            forceZ[i] = forceZ[numSprings + i] = 0.0;
+            continue;
+        }
+
+        double f = m_springStiffness[i] * (length - m_springLength0[i]);
+        double scale = f / length;
+        forceX[i] = scale * dx;
+        forceY[i] = scale * dy;
+        forceZ[i] = scale * dz;
+        forceX[numSprings + i] = -forceX[i];
+        forceY[numSprings + i] = -forceY[i];
+        forceZ[numSprings + i] = -forceZ[i];
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method accumulates the gravity, spring, damping, and external forces
+    of a range of particles and integrates their motion with explicit Euler,
+    following the same sequence of operations as
+    cGELMassParticle::clearForces(), cGELLinearSpring::computeForces(), and
+    cGELMassParticle::computeNextPose().
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::integrateParticles(const unsigned int a_begin, const unsigned int a_end)
+{
+    const double dt = m_timeInterval;
+
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+        const double mass = particle->m_mass;
+
+        // gravity
+        double fx, fy, fz;
+        if (particle->m_useGravity)
+        {
+            fx = particle->m_gravity(0) * mass;
+            fy = particle->m_gravity(1) * mass;
+            fz = particle->m_gravity(2) * mass;
+        }
+        else
+        {
+            fx = 0.0;
+            fy = 0.0;
+            fz = 0.0;
+        }
+
+        // springs
+        unsigned int end = m_particleSpringOffsets[i + 1];
+        for (unsigned int j=m_particleSpringOffsets[i]; j<end; j++)
+        {
+            unsigned int index = m_particleSprings[j];
+            fx += m_springForceX[index];
+            fy += m_springForceY[index];
+            fz += m_springForceZ[index];
+        }
+
+        if (particle->m_fixed)
+        {
+            particle->m_force.set(fx, fy, fz);
+            particle->m_nextPos = particle->m_pos;
+            continue;
+        }
+
+        // damping
+        const cVector3d& vel = particle->m_vel;
+        double damping = -particle->m_kDampingPos * mass;
+        fx += vel(0) * damping;
+        fy += vel(1) * damping;
+        fz += vel(2) * damping;
+
+        // acceleration
+        const cVector3d& externalForce = particle->getExternalForce();
+        double factor = 1.0 / mass;
+        double ax = factor * (fx + externalForce(0));
+        double ay = factor * (fy + externalForce(1));
+        double az = factor * (fz + externalForce(2));
+
+        // Euler double integration for position
+        double vx = vel(0) + dt * ax;
+        double vy = vel(1) + dt * ay;
+        double vz = vel(2) + dt * az;
+
+        particle->m_force.set(fx, fy, fz);
+        particle->m_acc.set(ax, ay, az);
+        particle->m_vel.set(vx, vy, vz);
+        particle->m_nextPos.set(m_posX[i] + dt * vx,
+                                m_posY[i] + dt * vy,
+                                m_posZ[i] + dt * vz);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the stiffness matrix of each spring of a range,
+    that is the derivative of the force applied on its second particle with
+    respect to the position of its second particle (up to the sign). The
+    transverse term is clamped to zero for compressed springs so that the
+    system solved by the backward Euler integrator remains positive definite.
+
+    \param  a_begin  Index of the first spring.
+    \param  a_end    Index following the last spring.
+*/
+//===========================================================================
+void cGELParticleSolver::computeSpringStiffness(const unsigned int a_begin, const unsigned int a_end)
+{
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        int node0 = m_springNode0[i];
+        int node1 = m_springNode1[i];
+
+        double dx = m_posX[node1] - m_posX[node0];
+        double dy = m_posY[node1] - m_posY[node0];
+        double dz = m_posZ[node1] - m_posZ[node0];
+        double length = sqrt((dx * dx) + (dy * dy) + (dz * dz));
+
+        double* matrix = &m_springStiffnessMatrix[6 * i];
+
+        // if distance too small, spring has no effect
+        if (length <= 0.000001)
+        {
+            for (int k=0; k<6; k++)
+            {
+                matrix[k] = 0.0;
+            }
+            continue;
+        }
+
+        // K = k * (c * I + (1 - c) * u * u^T)
+        double k = m_springStiffness[i];
+        double c = 1.0 - m_springLength0[i] / length;
+        if (c < 0.0) { c = 0.0; }
+
+        double ux = dx / length;
+        double uy = dy / length;
+        double uz = dz / length;
+        double a = k * c;
+        double b = k * (1.0 - c);
+
+        matrix[0] = a + b * ux * ux;
+        matrix[1] = b * ux * uy;
+        matrix[2] = b * ux * uz;
+        matrix[3] = a + b * uy * uy;
+        matrix[4] = b * uy * uz;
+        matrix[5] = a + b * uz * uz;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method computes the forces applied on a range of particles and the
+    right-hand side and diagonal of the backward Euler system. The search
+    direction is set to the current solution, so that the initial residual
+    can be computed by multiplySystem() and initializeResidual(). The
+    squared norm of the right-hand side is stored per chunk.
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::assembleSystem(const unsigned int a_begin, const unsigned int a_end)
+{
+    const double h = m_timeInterval;
+    const double h2 = h * h;
+    const unsigned int numSprings = getNumSprings();
+
+    double bb = 0.0;
+
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+        const double mass = particle->m_mass;
+
+        // gravity
+        double f[3];
+        if (particle->m_useGravity)
+        {
+            f[0] = particle->m_gravity(0) * mass;
+            f[1] = particle->m_gravity(1) * mass;
+            f[2] = particle->m_gravity(2) * mass;
+        }
+        else
+        {
+            f[0] = 0.0;
+            f[1] = 0.0;
+            f[2] = 0.0;
+        }
+
+        // springs
+        double v[3] = { m_velX[i], m_velY[i], m_velZ[i] };
+        double kv[3] = { 0.0, 0.0, 0.0 };
+        double diagonal[3] = { 0.0, 0.0, 0.0 };
+
+        unsigned int end = m_particleSpringOffsets[i + 1];
+        for (unsigned int j=m_particleSpringOffsets[i]; j<end; j++)
+        {
+            unsigned int index = m_particleSprings[j];
+            f[0] += m_springForceX[index];
+            f[1] += m_springForceY[index];
+            f[2] += m_springForceZ[index];
+
+            unsigned int spring = (index < numSprings) ? index : index - numSprings;
+            const double* matrix = &m_springStiffnessMatrix[6 * spring];
+
+            int neighbor = m_particleNeighbors[j];
+            double dv[3] = { v[0] - m_velX[neighbor], v[1] - m_velY[neighbor], v[2] - m_velZ[neighbor] };
+
+            double kxx = matrix[0];
+            double kxy = matrix[1];
+            double kxz = matrix[2];
+            double kyy = matrix[3];
+            double kyz = matrix[4];
+            double kzz = matrix[5];
+
+            kv[0] += kxx * dv[0] + kxy * dv[1] + kxz * dv[2];
+            kv[1] += kxy * dv[0] + kyy * dv[1] + kyz * dv[2];
+            kv[2] += kxz * dv[0] + kyz * dv[1] + kzz * dv[2];
+
+            diagonal[0] += kxx;
+            diagonal[1] += kyy;
+            diagonal[2] += kzz;
+        }
+
+        if (particle->m_fixed)
+        {
+            particle->m_force.set(f[0], f[1], f[2]);
+            m_systemMass[i] = 0.0;
+            for (int k=0; k<3; k++)
+            {
+                m_diagonal[k][i] = 1.0;
+                m_solution[k][i] = 0.0;
+                m_residual[k][i] = 0.0;
+                m_precondResidual[k][i] = 0.0;
+                m_direction[k][i] = 0.0;
+            }
+            continue;
+        }
+
+        // damping
+        double damping = -particle->m_kDampingPos * mass;
+        f[0] += v[0] * damping;
+        f[1] += v[1] * damping;
+        f[2] += v[2] * damping;
+        particle->m_force.set(f[0], f[1], f[2]);
+
+        // external force
+        const cVector3d& externalForce = particle->getExternalForce();
+        f[0] += externalForce(0);
+        f[1] += externalForce(1);
+        f[2] += externalForce(2);
+
+        // system
+        double systemMass = (1.0 + h * particle->m_kDampingPos) * mass;
+        m_systemMass[i] = systemMass;
+
+        for (int k=0; k<3; k++)
+        {
+            double b = h * (f[k] - h * kv[k]);
+
+            m_diagonal[k][i] = systemMass + h2 * diagonal[k];
+            m_residual[k][i] = b;
+            m_direction[k][i] = m_solution[k][i];
+
+            bb += b * b;
+        }
+    }
+
+    m_partialSum1[a_begin / C_GEL_SOLVER_PARTICLE_CHUNK_SIZE] = bb;
+}
+
+
+//===========================================================================
+/*!
+    This method computes the initial residual of a range of particles from
+    the right-hand side and the product of the system matrix and the initial
+    solution, applies the preconditioner, and initializes the search
+    direction. The dot products of the residual are stored per chunk.
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::initializeResidual(const unsigned int a_begin, const unsigned int a_end)
+{
+    double rz = 0.0;
+    double rr = 0.0;
+
+    for (int k=0; k<3; k++)
+    {
+        double* r = &m_residual[k][0];
+        double* z = &m_precondResidual[k][0];
+        double* p = &m_direction[k][0];
+        const double* q = &m_product[k][0];
+        const double* d = &m_diagonal[k][0];
+
+        for (unsigned int i=a_begin; i<a_end; i++)
+        {
+            r[i] -= q[i];
+            z[i] = r[i] / d[i];
+            p[i] = z[i];
+
+            rz += r[i] * z[i];
+            rr += r[i] * r[i];
+        }
+    }
+
+    unsigned int chunk = a_begin / C_GEL_SOLVER_PARTICLE_CHUNK_SIZE;
+    m_partialSum0[chunk] = rz;
+    m_partialSum1[chunk] = rr;
+}
+
+
+//===========================================================================
+/*!
+    This method multiplies the search direction by the backward Euler system
+    matrix for a range of particles. The dot product of the search direction
+    and of the result is stored per chunk.
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::multiplySystem(const unsigned int a_begin, const unsigned int a_end)
+{
+    const double h2 = m_timeInterval * m_timeInterval;
+    const unsigned int numSprings = getNumSprings();
+
+    const double* px = &m_direction[0][0];
+    const double* py = &m_direction[1][0];
+    const double* pz = &m_direction[2][0];
+
+    double pq = 0.0;
+
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        // fixed particles do not take part in the system
+        double systemMass = m_systemMass[i];
+        if (systemMass == 0.0)
+        {
+            m_product[0][i] = 0.0;
+            m_product[1][i] = 0.0;
+            m_product[2][i] = 0.0;
+            continue;
+        }
+
+        double p[3] = { px[i], py[i], pz[i] };
+        double kp[3] = { 0.0, 0.0, 0.0 };
+
+        unsigned int end = m_particleSpringOffsets[i + 1];
+        for (unsigned int j=m_particleSpringOffsets[i]; j<end; j++)
+        {
+            int neighbor = m_particleNeighbors[j];
+            double dp[3] = { p[0] - px[neighbor], p[1] - py[neighbor], p[2] - pz[neighbor] };
+
+            unsigned int index = m_particleSprings[j];
+            unsigned int spring = (index < numSprings) ? index : index - numSprings;
+            const double* matrix = &m_springStiffnessMatrix[6 * spring];
+            double kxx = matrix[0];
+            double kxy = matrix[1];
+            double kxz = matrix[2];
+            double kyy = matrix[3];
+            double kyz = matrix[4];
+            double kzz = matrix[5];
+
+            kp[0] += kxx * dp[0] + kxy * dp[1] + kxz * dp[2];
+            kp[1] += kxy * dp[0] + kyy * dp[1] + kyz * dp[2];
+            kp[2] += kxz * dp[0] + kyz * dp[1] + kzz * dp[2];
+        }
+
+        for (int k=0; k<3; k++)
+        {
+            double q = systemMass * p[k] + h2 * kp[k];
+            m_product[k][i] = q;
+            pq += p[k] * q;
+        }
+    }
+
+    m_partialSum0[a_begin / C_GEL_SOLVER_PARTICLE_CHUNK_SIZE] = pq;
+}
+
+
+//===========================================================================
+/*!
+    This method advances the solution and residual of a range of particles
+    along the search direction, and applies the preconditioner. The dot
+    products of the new residual are stored per chunk.
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::updateSolution(const unsigned int a_begin, const unsigned int a_end)
+{
+    const double alpha = m_alpha;
+
+    double rz = 0.0;
+    double rr = 0.0;
+
+    for (int k=0; k<3; k++)
+    {
+        double* x = &m_solution[k][0];
+        double* r = &m_residual[k][0];
+        double* z = &m_precondResidual[k][0];
+        const double* p = &m_direction[k][0];
+        const double* q = &m_product[k][0];
+        const double* d = &m_diagonal[k][0];
+
+        for (unsigned int i=a_begin; i<a_end; i++)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+            z[i] = r[i] / d[i];
+
+            rz += r[i] * z[i];
+            rr += r[i] * r[i];
+        }
+    }
+
+    unsigned int chunk = a_begin / C_GEL_SOLVER_PARTICLE_CHUNK_SIZE;
+    m_partialSum0[chunk] = rz;
+    m_partialSum1[chunk] = rr;
+}
+
+
+//===========================================================================
+/*!
+    This method updates the search direction of a range of particles.
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::updateDirection(const unsigned int a_begin, const unsigned int a_end)
+{
+    const double beta = m_beta;
+
+    for (int k=0; k<3; k++)
+    {
+        double* p = &m_direction[k][0];
+        const double* z = &m_precondResidual[k][0];
+
+        for (unsigned int i=a_begin; i<a_end; i++)
+        {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method integrates a range of particles from the velocity changes
+    computed by the conjugate gradient, and writes the accelerations,
+    velocities, and next positions back to the particles.
+
+    \param  a_begin  Index of the first particle.
+    \param  a_end    Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::applySolution(const unsigned int a_begin, const unsigned int a_end)
+{
+    const double h = m_timeInterval;
+
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        cGELMassParticle* particle = m_particles[i];
+
+        if (particle->m_fixed)
+        {
+            particle->m_nextPos = particle->m_pos;
+            continue;
+        }
+
+        double dvx = m_solution[0][i];
+        double dvy = m_solution[1][i];
+        double dvz = m_solution[2][i];
+
+        double vx = m_velX[i] + dvx;
+        double vy = m_velY[i] + dvy;
+        double vz = m_velZ[i] + dvz;
+
+        particle->m_acc.set(dvx / h, dvy / h, dvz / h);
+        particle->m_vel.set(vx, vy, vz);
+        particle->m_nextPos.set(m_posX[i] + h * vx,
+                                m_posY[i] + h * vy,
+                                m_posZ[i] + h * vz);
+    }
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling gatherParticles().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::gatherParticlesTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->gatherParticles(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling computeSpringForces().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first spring.
+    \param  a_end     Index following the last spring.
+*/
+//===========================================================================
+void cGELParticleSolver::computeSpringForcesTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->computeSpringForces(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling integrateParticles().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::integrateParticlesTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->integrateParticles(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling computeSpringStiffness().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first spring.
+    \param  a_end     Index following the last spring.
+*/
+//===========================================================================
+void cGELParticleSolver::computeSpringStiffnessTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->computeSpringStiffness(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling assembleSystem().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::assembleSystemTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->assembleSystem(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling initializeResidual().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::initializeResidualTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->initializeResidual(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling multiplySystem().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::multiplySystemTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->multiplySystem(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling updateSolution().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::updateSolutionTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->updateSolution(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling updateDirection().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::updateDirectionTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->updateDirection(a_begin, a_end);
+}
+
+
+//===========================================================================
+/*!
+    Worker pool task calling applySolution().
+
+    \param  a_solver  Solver.
+    \param  a_begin   Index of the first particle.
+    \param  a_end     Index following the last particle.
+*/
+//===========================================================================
+void cGELParticleSolver::applySolutionTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end)
+{
+    ((cGELParticleSolver*)a_solver)->applySolution(a_begin, a_end);
+}
@@ -0,0 +1,382 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev: 1869 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#ifndef CGELParticleSolverH
+#define CGELParticleSolverH
+//---------------------------------------------------------------------------
+#include "CGELLinearSpring.h"
+#include "CGELVertex.h"
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+//---------------------------------------------------------------------------
+#include <list>
+#include <vector>
+//---------------------------------------------------------------------------
+
+//===========================================================================
+/*!
+    \file       CGELParticleSolver.h
+
+    \brief
+    Implementation of a structure-of-arrays solver for mass-particle models.
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+/*!
+    Defines the solver backends available for integrating the mass-particle
+    model of a deformable mesh.
+*/
+//---------------------------------------------------------------------------
+typedef enum
+{
+    C_GEL_SOLVER_LIST,      // particles and springs are updated one object at a time
+    C_GEL_SOLVER_SOA        // particles and springs are updated by cGELParticleSolver
+} cGELSolverBackend;
+
+//---------------------------------------------------------------------------
+/*!
+    Defines the time integration schemes available for the mass-particle
+    model of a deformable mesh.
+*/
+//---------------------------------------------------------------------------
+typedef enum
+{
+    C_GEL_INTEGRATOR_SYMPLECTIC_EULER,  // velocities are updated first, then positions from the new velocities
+    C_GEL_INTEGRATOR_BACKWARD_EULER     // velocities are obtained by solving the linearized implicit system
+} cGELIntegrator;
+
+//---------------------------------------------------------------------------
+//! Number of springs processed per task by the parallel solver.
+const unsigned int C_GEL_SOLVER_SPRING_CHUNK_SIZE = 4096;
+
+//! Number of particles processed per task by the parallel solver.
+const unsigned int C_GEL_SOLVER_PARTICLE_CHUNK_SIZE = 2048;
+
+//! Default maximum number of conjugate gradient iterations per backward Euler step.
+const unsigned int C_GEL_SOLVER_CG_MAX_ITERATIONS = 20;
+
+//! Default conjugate gradient tolerance, relative to the norm of the right-hand side.
+const double C_GEL_SOLVER_CG_TOLERANCE = 1e-3;
+//---------------------------------------------------------------------------
+
+
+//===========================================================================
+/*!
+    \class      cGELParticleSolver
+    \ingroup    GEL
+
+    \brief
+    This class integrates the mass-particle model of a deformable mesh using
+    contiguous buffers.
+
+    \details
+    The particles of a deformable mesh are stored as individual
+    cGELMassParticle objects, and its springs in a linked list. This class
+    copies the positions of the particles into structure-of-arrays buffers,
+    computes all spring forces in a single pass (using SIMD instructions
+    when available), and integrates the particles in a second pass. Both
+    passes can be distributed over a chai3d::cWorkerPool. \n
+
+    Spring forces are first stored per spring, and then gathered by each
+    particle from the list of springs attached to it, in the order in which
+    the springs appear in the mesh. No two threads ever write to the same
+    particle, and each particle accumulates its forces in the same order as
+    cGELLinearSpring::computeForces() would. Results are therefore
+    identical to those of the list-based path and independent of the
+    number of threads, provided floating-point contraction is disabled
+    (-ffp-contract=off), as set by the module build files. \n
+
+    Spring properties and topology are copied when the solver is built.
+    Particle states, masses, damping, gravity, and external forces are read
+    from the particle objects at every step, and results are written back
+    to them, so that application code can keep using cGELMassParticle. \n
+
+    Two integrators are available. Symplectic Euler reproduces
+    cGELMassParticle::computeNextPose() and is only stable for time steps
+    small compared to the period of the stiffest spring. Backward Euler
+    linearizes the spring and damping forces at the beginning of the step
+    and solves the resulting system for the velocity change with a
+    Jacobi-preconditioned conjugate gradient over the spring graph, starting
+    from the velocity change of the previous step. It
+    remains stable for stiff springs at haptic time steps, at the cost of
+    additional numerical damping. The number of iterations is bounded (see
+    setLinearSolverSettings()) to limit the computation time per haptic
+    cycle, in which case the velocity change is only approximate. Dot products are accumulated per chunk of
+    particles and summed in chunk order, so that results remain independent
+    of the number of threads.
+*/
+//===========================================================================
+class cGELParticleSolver
+{
+    //-----------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGELParticleSolver.
+    cGELParticleSolver();
+
+    //! Destructor of cGELParticleSolver.
+    virtual ~cGELParticleSolver() {};
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method builds the solver buffers from a set of particles and springs.
+    bool build(std::vector<cGELVertex>& a_vertices,
+               std::list<cGELLinearSpring*>& a_springs);
+
+    //! This method releases all particles and springs from the solver.
+    void clear();
+
+    //! This method returns the number of particles handled by the solver.
+    unsigned int getNumParticles() const { return ((unsigned int)(m_particles.size())); }
+
+    //! This method returns the number of springs handled by the solver.
+    unsigned int getNumSprings() const { return ((unsigned int)(m_springNode0.size())); }
+
+    //! This method computes the next position of every particle over a time interval.
+    void computeNextPose(const double a_timeInterval,
+                         chai3d::cWorkerPool* a_workerPool = NULL);
+
+    //! This method selects the time integration scheme.
+    void setIntegrator(const cGELIntegrator a_integrator) { m_integrator = a_integrator; }
+
+    //! This method returns the time integration scheme.
+    cGELIntegrator getIntegrator() const { return (m_integrator); }
+
+    //! This method sets the maximum number of iterations and the relative tolerance of the conjugate gradient.
+    void setLinearSolverSettings(const unsigned int a_maxIterations, const double a_tolerance) { m_maxIterations = a_maxIterations; m_tolerance = a_tolerance; }
+
+    //! This method returns the number of conjugate gradient iterations performed by the last backward Euler step.
+    unsigned int getNumIterations() const { return (m_numIterations); }
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! This method executes a task over a range of items, using the worker pool if available.
+    void execute(chai3d::cWorkerPoolTask a_task, const unsigned int a_numItems, const unsigned int a_chunkSize);
+
+    //! This method computes the next position of every particle with the backward Euler integrator.
+    void solveBackwardEuler();
+
+    //! This method copies the positions and velocities of a range of particles into the solver buffers.
+    void gatherParticles(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method computes the forces of a range of springs.
+    void computeSpringForces(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method accumulates forces and integrates a range of particles.
+    void integrateParticles(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method computes the stiffness matrices of a range of springs.
+    void computeSpringStiffness(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method computes the implicit system for a range of particles.
+    void assembleSystem(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method computes the initial conjugate gradient residual for a range of particles.
+    void initializeResidual(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method multiplies the search direction by the system matrix for a range of particles.
+    void multiplySystem(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method updates the solution and residual of a range of particles.
+    void updateSolution(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method updates the search direction of a range of particles.
+    void updateDirection(const unsigned int a_begin, const unsigned int a_end);
+
+    //! This method integrates a range of particles from the solved velocity changes.
+    void applySolution(const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling gatherParticles().
+    static void gatherParticlesTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling computeSpringForces().
+    static void computeSpringForcesTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling integrateParticles().
+    static void integrateParticlesTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling computeSpringStiffness().
+    static void computeSpringStiffnessTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling assembleSystem().
+    static void assembleSystemTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling initializeResidual().
+    static void initializeResidualTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling multiplySystem().
+    static void multiplySystemTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling updateSolution().
+    static void updateSolutionTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling updateDirection().
+    static void updateDirectionTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+    //! Worker pool task calling applySolution().
+    static void applySolutionTask(void* a_solver, const unsigned int a_begin, const unsigned int a_end);
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - PARTICLES:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Mass particles.
+    std::vector<cGELMassParticle*> m_particles;
+
+    //! Particle positions.
+    std::vector<double> m_posX, m_posY, m_posZ;
+
+    //! Particle velocities (zero for fixed particles).
+    std::vector<double> m_velX, m_velY, m_velZ;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - SPRINGS:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Index of the first particle of each spring.
+    std::vector<int> m_springNode0;
+
+    //! Index of the second particle of each spring.
+    std::vector<int> m_springNode1;
+
+    //! Stiffness of each spring.
+    std::vector<double> m_springStiffness;
+
+    //! Rest length of each spring.
+    std::vector<double> m_springLength0;
+
+    //! Force applied by each spring on its first particle, followed by the force applied on its second particle.
+    std::vector<double> m_springForceX, m_springForceY, m_springForceZ;
+
+    //! Offsets into m_particleSprings for each particle (size: number of particles + 1).
+    std::vector<unsigned int> m_particleSpringOffsets;
+
+    //! Spring forces applied on each particle, stored as indices into m_springForceX, m_springForceY, and m_springForceZ.
+    std::vector<unsigned int> m_particleSprings;
+
+    //! Particle at the other end of each spring listed in m_particleSprings.
+    std::vector<int> m_particleNeighbors;
+
+    //! Stiffness matrix of each spring, stored as 6 consecutive values (xx, xy, xz, yy, yz, zz).
+    std::vector<double> m_springStiffnessMatrix;
+
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS - BACKWARD EULER:
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Time integration scheme.
+    cGELIntegrator m_integrator;
+
+    //! Mass of each particle, scaled by its damping term (zero for fixed particles).
+    std::vector<double> m_systemMass;
+
+    //! Diagonal of the system matrix (preconditioner), per axis.
+    std::vector<double> m_diagonal[3];
+
+    //! Velocity change of each particle, per axis, kept as the initial guess of the next step.
+    std::vector<double> m_solution[3];
+
+    //! Conjugate gradient residual, per axis.
+    std::vector<double> m_residual[3];
+
+    //! Preconditioned residual, per axis.
+    std::vector<double> m_precondResidual[3];
+
+    //! Search direction, per axis.
+    std::vector<double> m_direction[3];
+
+    //! Product of the system matrix and the search direction, per axis.
+    std::vector<double> m_product[3];
+
+    //! Partial dot products computed by each chunk of particles.
+    std::vector<double> m_partialSum0, m_partialSum1;
+
+    //! Conjugate gradient step length.
+    double m_alpha;
+
+    //! Conjugate gradient direction update factor.
+    double m_beta;
+
+    //! Maximum number of conjugate gradient iterations per step.
+    unsigned int m_maxIterations;
+
+    //! Conjugate gradient tolerance, relative to the norm of the right-hand side.
+    double m_tolerance;
+
+    //! Number of conjugate gradient iterations performed by the last step.
+    unsigned int m_numIterations;
+
+    //! Worker pool used by the current step.
+    chai3d::cWorkerPool* m_workerPool;
+
+    //! Time interval of the current step.
+    double m_timeInterval;
+};
+
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
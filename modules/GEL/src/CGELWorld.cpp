@@ -89,6 +89,11 @@ cGELWorld::cGELWorld()
     // reset simulation time.
     m_simulationTime = 0.0;
 
+    // use list-based solver
+    m_solverBackend = C_GEL_SOLVER_LIST;
+    m_integrator = C_GEL_INTEGRATOR_SYMPLECTIC_EULER;
+    m_workerPool = NULL;
+
     // create a collision detector for world
     m_collisionDetector = new cGELWorldCollision(this);
 }
@@ -102,6 +107,85 @@ cGELWorld::cGELWorld()
 cGELWorld::~cGELWorld()
 {
     m_gelMeshes.clear();
+
+    if (m_workerPool != NULL)
+    {
+        delete m_workerPool;
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method selects the solver used to simulate the mass-particle models
+    of all deformable objects. __C_GEL_SOLVER_SOA__ stores particles and
+    springs in contiguous buffers and may distribute the computations over
+    several threads. Results are identical for both backends and for any
+    number of threads.
+
+    The number of threads also applies to the backward Euler integrator,
+    which always uses the particle solver. \n
+
+    The solver is assigned to the deformable objects of the world when this
+    method is called, and to objects added later for which no solver has
+    been selected yet (see cGELMesh::getSolverSelected()). A solver
+    selected afterwards for a single object with
+    cGELMesh::setSolverBackend() is kept until this method is called again.
+
+    \param  a_backend     Solver backend.
+    \param  a_numThreads  Number of threads used by the particle solver
+                          (0 to use one thread per processor core).
+*/
+//===========================================================================
+void cGELWorld::setSolverBackend(cGELSolverBackend a_backend,
+                                 const unsigned int a_numThreads)
+{
+    m_solverBackend = a_backend;
+
+    // release previous worker pool
+    if (m_workerPool != NULL)
+    {
+        delete m_workerPool;
+        m_workerPool = NULL;
+    }
+
+    // create worker pool
+    if (a_numThreads != 1)
+    {
+        m_workerPool = new cWorkerPool(a_numThreads, CTHREAD_PRIORITY_HAPTICS);
+    }
+
+    // assign solver to all objects
+    list<cGELMesh*>::iterator i;
+    for(i = m_gelMeshes.begin(); i != m_gelMeshes.end(); ++i)
+    {
+        (*i)->setSolverBackend(m_solverBackend, m_workerPool);
+    }
+}
+
+
+//===========================================================================
+/*!
+    This method selects the time integration scheme of the mass-particle
+    models of all deformable objects. As for setSolverBackend(), the scheme
+    is assigned to the objects of the world when this method is called, and
+    to objects added later for which no solver has been selected yet. A
+    scheme selected afterwards for a single object with
+    cGELMesh::setIntegrator() is kept until this method is called again.
+
+    \param  a_integrator  Time integration scheme.
+*/
+//===========================================================================
+void cGELWorld::setIntegrator(cGELIntegrator a_integrator)
+{
+    m_integrator = a_integrator;
+
+    // assign integrator to all objects
+    list<cGELMesh*>::iterator i;
+    for(i = m_gelMeshes.begin(); i != m_gelMeshes.end(); ++i)
+    {
+        (*i)->setIntegrator(m_integrator);
+    }
 }
 
 
@@ -158,6 +242,14 @@ void cGELWorld::updateDynamics(double a_timeInterval)
     for(i = m_gelMeshes.begin(); i != m_gelMeshes.end(); ++i)
     {
         cGELMesh *nextItem = *i;
+
+        // assign the settings of the world to objects added since they were selected
+        if (!nextItem->getSolverSelected())
+        {
+            nextItem->setSolverBackend(m_solverBackend, m_workerPool);
+            nextItem->setIntegrator(m_integrator);
+        }
+
         nextItem->clearForces();
     }
 
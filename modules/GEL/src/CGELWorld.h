@@ -100,6 +100,19 @@ public:
     //! This method updates the mesh of all deformable objects.
     void updateSkins(bool a_updateNormals = true);
 
+    //! This method selects the solver used to simulate the mass-particle models of all deformable objects.
+    void setSolverBackend(cGELSolverBackend a_backend,
+                          const unsigned int a_numThreads = 1);
+
+    //! This method returns the solver used to simulate the mass-particle models.
+    cGELSolverBackend getSolverBackend() const { return (m_solverBackend); }
+
+    //! This method selects the time integration scheme of the mass-particle models of all deformable objects.
+    void setIntegrator(cGELIntegrator a_integrator);
+
+    //! This method returns the time integration scheme of the mass-particle models.
+    cGELIntegrator getIntegrator() const { return (m_integrator); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -125,6 +138,22 @@ private:
 
     //! This method renders graphically all deformable objects contained in the world.
     virtual void render(chai3d::cRenderOptions& a_options);
+
+
+    //-----------------------------------------------------------------------
+    // PRIVATE MEMBERS:
+    //-----------------------------------------------------------------------
+
+private:
+
+    //! Solver used to simulate the mass-particle models.
+    cGELSolverBackend m_solverBackend;
+
+    //! Time integration scheme of the mass-particle models.
+    cGELIntegrator m_integrator;
+
+    //! Worker pool used by the particle solvers (__NULL__ if single threaded).
+    chai3d::cWorkerPool* m_workerPool;
 };
 
 
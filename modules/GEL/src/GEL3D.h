@@ -65,6 +65,7 @@
 #include "CGELSkeletonNode.h"
 #include "CGELSkeletonLink.h"
 #include "CGELVertex.h"
+#include "CGELParticleSolver.h"
 #include "CGELMesh.h"
 #include "CGELWorld.h"
 
@@ -0,0 +1,444 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2177 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+#include "GEL3D.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED TYPES
+//---------------------------------------------------------------------------
+
+// benchmark lattice
+struct BenchLattice
+{
+    cGELWorld* m_world;
+    cGELMesh* m_mesh;
+    vector<cGELMassParticle*> m_loadedParticles;
+};
+
+
+//---------------------------------------------------------------------------
+// DECLARED VARIABLES
+//---------------------------------------------------------------------------
+
+// number of particles along each side of the lattice
+int latticeSize = 26;
+
+// number of simulation steps per benchmark
+int numSteps = 200;
+
+// number of threads used by the parallel solver
+int numThreads = 4;
+
+// simulation time step
+const double timeStep = 0.001;
+
+// spacing between particles
+const double latticeSpacing = 0.01;
+
+// spring stiffness of the integrator benchmark
+double stiffness = 20000000.0;
+
+// state of the pseudo-random number generator
+unsigned int randomSeed = 12345;
+
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// deterministic pseudo-random number in [-1,1]
+double randomSigned()
+{
+    randomSeed = 1664525 * randomSeed + 1013904223;
+    return (2.0 * (double)(randomSeed >> 8) / (double)(0x00ffffff) - 1.0);
+}
+
+
+// create a lattice of mass particles connected by structural and shear springs
+void createLattice(BenchLattice& a_lattice)
+{
+    int n = latticeSize;
+    double spacing = latticeSpacing;
+
+    a_lattice.m_world = new cGELWorld();
+    a_lattice.m_mesh = new cGELMesh();
+    a_lattice.m_world->m_gelMeshes.push_back(a_lattice.m_mesh);
+
+    // create one vertex per particle
+    cMesh* mesh = a_lattice.m_mesh->newMesh();
+    for (int z=0; z<n; z++)
+    {
+        for (int y=0; y<n; y++)
+        {
+            for (int x=0; x<n; x++)
+            {
+                mesh->newVertex(spacing * x, spacing * y, spacing * z);
+            }
+        }
+    }
+
+    // create particles
+    a_lattice.m_mesh->buildVertices();
+    a_lattice.m_mesh->m_useMassParticleModel = true;
+    vector<cGELVertex>& vertices = a_lattice.m_mesh->m_gelVertices;
+
+    // fix bottom layer, apply loads on top layer
+    a_lattice.m_loadedParticles.clear();
+    for (int y=0; y<n; y++)
+    {
+        for (int x=0; x<n; x++)
+        {
+            vertices[y * n + x].m_massParticle->m_fixed = true;
+            a_lattice.m_loadedParticles.push_back(vertices[((n - 1) * n + y) * n + x].m_massParticle);
+        }
+    }
+
+    // create springs
+    const int offsets[9][3] = { {1,0,0}, {0,1,0}, {0,0,1},
+                                {1,1,0}, {1,-1,0}, {1,0,1},
+                                {1,0,-1}, {0,1,1}, {0,1,-1} };
+
+    for (int z=0; z<n; z++)
+    {
+        for (int y=0; y<n; y++)
+        {
+            for (int x=0; x<n; x++)
+            {
+                for (int i=0; i<9; i++)
+                {
+                    int x1 = x + offsets[i][0];
+                    int y1 = y + offsets[i][1];
+                    int z1 = z + offsets[i][2];
+                    if ((x1 < 0) || (y1 < 0) || (z1 < 0) || (x1 >= n) || (y1 >= n) || (z1 >= n)) continue;
+
+                    cGELLinearSpring* spring = new cGELLinearSpring(vertices[(z * n + y) * n + x].m_massParticle,
+                                                                    vertices[(z1 * n + y1) * n + x1].m_massParticle);
+                    a_lattice.m_mesh->m_linearSprings.push_back(spring);
+                }
+            }
+        }
+    }
+}
+
+
+// delete a lattice
+void deleteLattice(BenchLattice& a_lattice)
+{
+    list<cGELLinearSpring*>::iterator it;
+    for (it = a_lattice.m_mesh->m_linearSprings.begin(); it != a_lattice.m_mesh->m_linearSprings.end(); ++it)
+    {
+        delete (*it);
+    }
+
+    vector<cGELVertex>::iterator iv;
+    for (iv = a_lattice.m_mesh->m_gelVertices.begin(); iv != a_lattice.m_mesh->m_gelVertices.end(); ++iv)
+    {
+        delete iv->m_massParticle;
+    }
+
+    delete a_lattice.m_mesh;
+    delete a_lattice.m_world;
+}
+
+
+// simulate a lattice and return its final particle positions and the time per haptic step
+double simulateLattice(cGELSolverBackend a_backend,
+                       cGELIntegrator a_integrator,
+                       int a_numThreads,
+                       int a_numSubsteps,
+                       vector<cVector3d>& a_positions,
+                       double* a_numIterations = NULL)
+{
+    BenchLattice lattice;
+    createLattice(lattice);
+    lattice.m_world->setSolverBackend(a_backend, a_numThreads);
+    lattice.m_world->setIntegrator(a_integrator);
+    double iterations = 0.0;
+
+    // same sequence of loads for every run
+    randomSeed = 12345;
+
+    cPrecisionClock clock;
+    double time = 0.0;
+    for (int i=0; i<numSteps; i++)
+    {
+        for (unsigned int j=0; j<lattice.m_loadedParticles.size(); j++)
+        {
+            cVector3d force(randomSigned(), randomSigned(), randomSigned());
+            lattice.m_loadedParticles[j]->setExternalForce(force);
+        }
+
+        clock.start(true);
+        for (int j=0; j<a_numSubsteps; j++)
+        {
+            lattice.m_world->updateDynamics(timeStep / (double)a_numSubsteps);
+        }
+        time += clock.getCurrentTimeSeconds();
+
+        cGELParticleSolver* solver = lattice.m_mesh->getParticleSolver();
+        if (solver != NULL)
+        {
+            iterations += solver->getNumIterations();
+        }
+    }
+
+    if (a_numIterations != NULL)
+    {
+        *a_numIterations = iterations / (double)numSteps;
+    }
+
+    a_positions.clear();
+    for (unsigned int i=0; i<lattice.m_mesh->m_gelVertices.size(); i++)
+    {
+        a_positions.push_back(lattice.m_mesh->m_gelVertices[i].m_massParticle->m_pos);
+    }
+
+    deleteLattice(lattice);
+
+    return (time / (double)numSteps);
+}
+
+
+// count positions that differ from a reference
+int countMismatches(const vector<cVector3d>& a_reference, const vector<cVector3d>& a_positions)
+{
+    int count = 0;
+    for (unsigned int i=0; i<a_reference.size(); i++)
+    {
+        if ((a_reference[i](0) != a_positions[i](0)) ||
+            (a_reference[i](1) != a_positions[i](1)) ||
+            (a_reference[i](2) != a_positions[i](2)))
+        {
+            count++;
+        }
+    }
+    return (count);
+}
+
+
+// return __true__ if all particles remain within one lattice size of their initial position
+bool isStable(const vector<cVector3d>& a_positions)
+{
+    int n = latticeSize;
+    double limit = latticeSpacing * n;
+    for (unsigned int i=0; i<a_positions.size(); i++)
+    {
+        cVector3d initialPos(latticeSpacing * (i % n), latticeSpacing * ((i / n) % n), latticeSpacing * (i / (n * n)));
+        double distance = cDistance(a_positions[i], initialPos);
+        if (!(distance < limit)) return (false);
+    }
+    return (true);
+}
+
+
+// print result of an integrator benchmark run
+void printIntegratorRun(string a_label, double a_time, bool a_stable)
+{
+    cout << "  " << left << setw(32) << a_label << right << fixed << setprecision(3)
+         << setw(9) << 1e3 * a_time << " ms/step   "
+         << (a_stable ? "stable" : "unstable") << endl;
+}
+
+
+// compare integrators on a stiff lattice simulated at haptic rate
+int benchmarkIntegrators()
+{
+    double defaultStiffness = cGELLinearSpring::s_default_kSpringElongation;
+    cGELLinearSpring::s_default_kSpringElongation = stiffness;
+
+    cout << "stiff lattice: " << stiffness << " N/m springs, " << 1e3 * timeStep << " ms haptic step" << endl;
+
+    vector<cVector3d> positions;
+
+    // symplectic Euler, increasing number of substeps until stable
+    for (int substeps=1; substeps<=256; substeps*=2)
+    {
+        double time = simulateLattice(C_GEL_SOLVER_SOA, C_GEL_INTEGRATOR_SYMPLECTIC_EULER, 1, substeps, positions);
+        bool stable = isStable(positions);
+        printIntegratorRun("symplectic Euler (" + cStr(substeps) + " substeps)", time, stable);
+        if (stable) break;
+    }
+
+    // backward Euler, single step
+    double iterations = 0.0;
+    double time = simulateLattice(C_GEL_SOLVER_SOA, C_GEL_INTEGRATOR_BACKWARD_EULER, 1, 1, positions, &iterations);
+    bool stable = isStable(positions);
+    printIntegratorRun("backward Euler (1 step)", time, stable);
+    cout << "  " << left << setw(32) << "" << right << fixed << setprecision(1) << setw(9) << iterations << " CG iterations/step" << endl;
+
+    // backward Euler, multiple threads
+    vector<cVector3d> parallelPositions;
+    time = simulateLattice(C_GEL_SOLVER_SOA, C_GEL_INTEGRATOR_BACKWARD_EULER, numThreads, 1, parallelPositions);
+    int mismatches = countMismatches(positions, parallelPositions);
+    int threads = (numThreads > 0) ? numThreads : (int)(cThread::getNumCores());
+    printIntegratorRun("backward Euler (" + cStr(threads) + " threads)", time, isStable(parallelPositions));
+    cout << "  " << left << setw(32) << "" << right << "mismatches " << mismatches << endl << endl;
+
+    cGELLinearSpring::s_default_kSpringElongation = defaultStiffness;
+
+    return (((mismatches == 0) && stable) ? 0 : -1);
+}
+
+
+// print result of a benchmark run
+void printRun(string a_label, double a_time, double a_reference, int a_mismatches)
+{
+    cout << "  " << left << setw(24) << a_label << right << fixed << setprecision(3)
+         << setw(9) << 1e3 * a_time << " ms/step   "
+         << "speedup " << setw(6) << setprecision(2) << a_reference / a_time << "   "
+         << "mismatches " << a_mismatches << endl;
+}
+
+
+// simple usage printer
+int usage()
+{
+    cout << endl << "gelbench [-n size] [-s steps] [-t threads] [-k stiffness]" << endl;
+    cout << "\t-n\tnumber of particles along each side of the lattice (default " << latticeSize << ")" << endl;
+    cout << "\t-s\tnumber of simulation steps (default " << numSteps << ")" << endl;
+    cout << "\t-t\tnumber of threads of the parallel solver, 0 for all cores (default " << numThreads << ")" << endl;
+    cout << "\t-k\tspring stiffness of the integrator benchmark (default " << stiffness << ")" << endl;
+    cout << "\t-h\tdisplay this message" << endl << endl;
+
+    return -1;
+}
+
+
+//===========================================================================
+/*
+    UTILITY:    gelbench.cpp
+
+    This utility measures the performance of the GEL mass-particle solvers
+    on a lattice of particles connected by springs, and verifies that all
+    solver backends produce identical results.
+ */
+//===========================================================================
+
+int main(int argc, char* argv[])
+{
+    // process arguments
+    for (int i=1; i<argc; i++)
+    {
+        if (argv[i][0] != '-') return usage ();
+        else switch (argv[i][1]) {
+            case 'h':
+                return usage ();
+            case 'n':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    latticeSize = atoi(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 's':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    numSteps = atoi(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 't':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    numThreads = atoi(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 'k':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    stiffness = atof(argv[i]);
+                }
+                else return usage ();
+                break;
+            default:
+                return usage ();
+        }
+    }
+    if ((latticeSize < 2) || (numSteps <= 0) || (numThreads < 0) || (stiffness <= 0.0)) return usage();
+
+    // pretty message
+    cout << endl;
+    cout << "-----------------------------------" << endl;
+    cout << "CHAI3D" << endl;
+    cout << "GEL Benchmark" << endl;
+    cout << "Copyright 2003-2016" << endl;
+    cout << "-----------------------------------" << endl;
+    cout << endl;
+
+    int numParticles = latticeSize * latticeSize * latticeSize;
+    cout << "lattice: " << numParticles << " particles, " << numSteps << " steps" << endl;
+
+    // run benchmarks
+    vector<cVector3d> reference, positions;
+
+    double timeList = simulateLattice(C_GEL_SOLVER_LIST, C_GEL_INTEGRATOR_SYMPLECTIC_EULER, 1, 1, reference);
+    printRun("list", timeList, timeList, 0);
+
+    double timeSoA = simulateLattice(C_GEL_SOLVER_SOA, C_GEL_INTEGRATOR_SYMPLECTIC_EULER, 1, 1, positions);
+    int mismatches = countMismatches(reference, positions);
+    printRun("SoA (1 thread)", timeSoA, timeList, mismatches);
+
+    double timeParallel = simulateLattice(C_GEL_SOLVER_SOA, C_GEL_INTEGRATOR_SYMPLECTIC_EULER, numThreads, 1, positions);
+    int parallelMismatches = countMismatches(reference, positions);
+    int threads = (numThreads > 0) ? numThreads : (int)(cThread::getNumCores());
+    printRun("SoA (" + cStr(threads) + " threads)", timeParallel, timeList, parallelMismatches);
+    cout << endl;
+
+    int result = ((mismatches == 0) && (parallelMismatches == 0)) ? 0 : -1;
+    if (benchmarkIntegrators() < 0) result = -1;
+
+    return (result);
+}
+
+//---------------------------------------------------------------------------
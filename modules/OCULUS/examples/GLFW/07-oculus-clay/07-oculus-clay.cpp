@@ -457,6 +457,9 @@ int main(int argc, char **argv)
     // draw some 3D volumetric object
     buildVoxelShape(0.5, 0.2);
 
+    // build occupancy pyramid used by collision detection
+    object->invalidateOccupancy();
+
     // set default rendering mode
     object->setRenderingModeIsosurfaceMaterial();
 
@@ -664,6 +667,10 @@ void updateHaptics(void)
                 cColorb color(0x00, 0x00, 0x00, 0x00);
                 object->m_texture->m_image->setVoxelColor(contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ, color);
 
+                // update occupancy used for collision detection
+                object->updateOccupancy(contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ,
+                                        contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ);
+
                 // mark voxel for update
                 mutexVoxel.acquire();
                 volumeUpdate.enclose(cVector3d(contact->m_voxelIndexX, contact->m_voxelIndexY, contact->m_voxelIndexZ));
@@ -388,6 +388,45 @@ bool cODEGenericBody::computeCollisionDetection(const chai3d::cVector3d& a_segme
 }
 
 
+//===========================================================================
+/*!
+    This method computes a box, expressed in the local coordinates of this
+    object, that encloses all collisions that may be reported by this object,
+    its body image, and its children.
+
+    \param  a_boxMin  Returned minimum point of the box.
+    \param  a_boxMax  Returned maximum point of the box.
+    \param  a_moving  Set to __true__ if this object, its body image, or a child is moving.
+
+    \return __true__ if the box encloses all collisions, __false__ otherwise.
+*/
+//===========================================================================
+bool cODEGenericBody::computeCollisionBoundaryBox(cVector3d& a_boxMin,
+                                                  cVector3d& a_boxMax,
+                                                  bool& a_moving)
+{
+    // compute box of this object and its children
+    if (!cGenericObject::computeCollisionBoundaryBox(a_boxMin, a_boxMax, a_moving))
+    {
+        return (false);
+    }
+
+    // ghost objects never report collisions
+    if (m_ghostEnabled) { return (true); }
+
+    // enclose body image
+    if (m_imageModel != NULL)
+    {
+        if (!encloseCollisionBoundaryBox(m_imageModel, a_boxMin, a_boxMax, a_moving))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
 //===========================================================================
 /*!
     This method assigns a generic object such as a mesh or a shape that is 
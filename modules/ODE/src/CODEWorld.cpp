@@ -383,3 +383,43 @@ bool cODEWorld::computeCollisionDetection(const cVector3d& a_segmentPointA,
     // return whether there was a collision between the segment and this world
     return (hit);
 }
+
+
+//==============================================================================
+/*!
+    This method computes a box, expressed in the local coordinates of this
+    world, that encloses all collisions that may be reported by its bodies
+    and its children.
+
+    \param  a_boxMin  Returned minimum point of the box.
+    \param  a_boxMax  Returned maximum point of the box.
+    \param  a_moving  Set to __true__ if a body or a child is moving.
+
+    \return __true__ if the box encloses all collisions, __false__ otherwise.
+*/
+//==============================================================================
+bool cODEWorld::computeCollisionBoundaryBox(cVector3d& a_boxMin,
+                                            cVector3d& a_boxMax,
+                                            bool& a_moving)
+{
+    // compute box of this object and its children
+    if (!cGenericObject::computeCollisionBoundaryBox(a_boxMin, a_boxMax, a_moving))
+    {
+        return (false);
+    }
+
+    // ghost objects never report collisions
+    if (m_ghostEnabled) { return (true); }
+
+    // enclose bodies
+    list<cODEGenericBody*>::iterator i;
+    for(i = m_bodies.begin(); i != m_bodies.end(); ++i)
+    {
+        if (!encloseCollisionBoundaryBox(*i, a_boxMin, a_boxMax, a_moving))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
@@ -133,6 +133,11 @@ public:
                                            chai3d::cCollisionRecorder& a_recorder,
                                            chai3d::cCollisionSettings& a_settings);
 
+    //! This method computes a box, in local coordinates, enclosing all collisions that may be reported by this world, its bodies, and its children.
+    virtual bool computeCollisionBoundaryBox(chai3d::cVector3d& a_boxMin,
+                                             chai3d::cVector3d& a_boxMax,
+                                             bool& a_moving);
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -72,7 +72,9 @@
 #include "devices/CGenericDevice.h"
 #include "devices/CGenericHapticDevice.h"
 #include "devices/CHapticDeviceHandler.h"
+#include "devices/CHapticScheduler.h"
 #include "devices/CMyCustomDevice.h"
+#include "devices/CSimulatedDevice.h"
 #include "devices/CDeltaDevices.h"
 #include "devices/CLeapDevices.h"
 #include "devices/CPhantomDevices.h"
@@ -90,6 +92,7 @@
 #include "graphics/CFont.h"
 #include "graphics/CImage.h"
 #include "graphics/CMultiImage.h"
+#include "graphics/CBrickImage.h"
 #include "graphics/CVideo.h"
 #include "graphics/CPrimitives.h"
 #include "graphics/CRenderOptions.h"
@@ -98,6 +101,8 @@
 #include "graphics/CSegmentArray.h"
 #include "graphics/CTriangleArray.h"
 #include "graphics/CVertexArray.h"
+#include "graphics/CVertexWelder.h"
+#include "graphics/CMeshAdjacency.h"
 
 
 //---------------------------------------------------------------------------
@@ -161,6 +166,8 @@
 #include "world/CMultiMesh.h"
 #include "world/CMultiPoint.h"
 #include "world/CMultiSegment.h"
+#include "world/CRenderQueue.h"
+#include "world/CSceneSnapshot.h"
 #include "world/CShapeBox.h"
 #include "world/CShapeCylinder.h"
 #include "world/CShapeEllipsoid.h"
@@ -168,6 +175,7 @@
 #include "world/CShapeSphere.h"
 #include "world/CShapeTorus.h"
 #include "world/CVoxelObject.h"
+#include "world/CVoxelPolygonizer.h"
 #include "world/CWorld.h"
 
 
@@ -198,6 +206,7 @@
 #include "tools/CHapticPoint.h"
 #include "tools/CToolCursor.h"
 #include "tools/CToolGripper.h"
+#include "tools/CToolGroup.h"
 
 
 //---------------------------------------------------------------------------
@@ -230,6 +239,9 @@
 #include "collisions/CCollisionBasics.h"
 #include "collisions/CCollisionBrute.h"
 #include "collisions/CCollisionAABB.h"
+#include "collisions/CCollisionBroadphase.h"
+#include "collisions/CCollisionCache.h"
+#include "collisions/CVoxelOccupancy.h"
 
 
 //---------------------------------------------------------------------------
@@ -237,6 +249,7 @@
 //! \brief      Implements a frequency counter and high precision clock.
 //---------------------------------------------------------------------------
 #include "timers/CFrequencyCounter.h"
+#include "timers/CHapticTrace.h"
 #include "timers/CPrecisionClock.h"
 
 
@@ -252,6 +265,7 @@
 #include "files/CFileImagePPM.h"
 #include "files/CFileImageRAW.h"
 #include "files/CFileModel3DS.h"
+#include "files/CFileModelCMESH.h"
 #include "files/CFileModelOBJ.h"
 #include "files/CFileModelSTL.h"
 #include "files/CFileXML.h"
@@ -263,9 +277,12 @@
 //---------------------------------------------------------------------------
 #include "system/CGenericType.h"
 #include "system/CGlobals.h"
+#include "system/CMappedFile.h"
 #include "system/CMutex.h"
 #include "system/CString.h"
 #include "system/CThread.h"
+#include "system/CTripleBuffer.h"
+#include "system/CWorkerPool.h"
 
 
 //---------------------------------------------------------------------------
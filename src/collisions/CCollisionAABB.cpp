@@ -45,8 +45,20 @@
 
 //------------------------------------------------------------------------------
 #include "collisions/CCollisionAABB.h"
+#include "system/CThread.h"
 //------------------------------------------------------------------------------
 #include <iostream>
+#include <cfloat>
+//------------------------------------------------------------------------------
+#if !defined(C_DISABLE_SIMD)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define C_AABB_BUCKET_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define C_AABB_BUCKET_SSE
+#endif
+#endif
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -55,6 +67,63 @@ using namespace std;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+// Number of bins used to evaluate the surface area heuristic along each axis.
+static const int C_AABB_SAH_NUM_BINS = 16;
+
+// Minimum number of elements in a subtree before it is built in its own thread.
+static const int C_AABB_SAH_PARALLEL_MIN_ELEMENTS = 8192;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Relative tolerance added to the collision radius when culling triangles of a bucket.
+static const double C_AABB_BUCKET_TOLERANCE = 1e-5;
+
+// Segment expressed in single precision for culling the triangles of a bucket.
+struct cCollisionAABBBucketQuery
+{
+    float m_segmentMin[3];
+    float m_segmentMax[3];
+    float m_pointA[3];
+    float m_pointB[3];
+    float m_margin;
+};
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Subtree built by a separate thread when using the surface area heuristic.
+struct cCollisionAABBBuildTask
+{
+    cCollisionAABB* m_tree;
+    int m_indexFirstNode;
+    int m_indexLastNode;
+    int m_depth;
+    int m_spawnDepth;
+    std::vector<cCollisionAABBNode> m_nodes;
+    int m_maxDepth;
+    int m_root;
+};
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This function returns the surface area of a boundary box.
+
+    \param  a_box  Boundary box.
+
+    \return Surface area of the box.
+*/
+//==============================================================================
+static inline double cSurfaceArea(const cCollisionAABBBox& a_box)
+{
+    double dx = a_box.m_max(0) - a_box.m_min(0);
+    double dy = a_box.m_max(1) - a_box.m_min(1);
+    double dz = a_box.m_max(2) - a_box.m_min(2);
+    if ((dx < 0.0) || (dy < 0.0) || (dz < 0.0)) { return (0.0); }
+    return (2.0 * (dx * dy + dy * dz + dz * dx));
+}
+
+
 //==============================================================================
 /*!
     Constructor of cCollisionAABB.
@@ -78,6 +147,23 @@ cCollisionAABB::cCollisionAABB()
     m_rootIndex = -1;
     m_maxDepth = 0;
     m_radius = 0.0;
+
+    // use packed tree for collision queries
+    m_usePackedTree = true;
+    m_useTriangleBuckets = true;
+
+    // default build method
+    m_buildMethod = C_AABB_BUILD_CENTER;
+
+    // refit settings
+    m_numVertices = 0;
+    m_positionVersion = 0;
+    m_topologyVersion = 0;
+    m_sumArea = 0.0;
+    m_buildCost = 0.0;
+    m_rebuildThreshold = C_AABB_DEFAULT_REBUILD_THRESHOLD;
+    m_numRefits = 0;
+    m_numRebuilds = 0;
 }
 
 
@@ -90,6 +176,8 @@ cCollisionAABB::~cCollisionAABB()
 {
     // clear all nodes
     m_nodes.clear();
+    m_packedNodes.clear();
+    m_buckets.clear();
 }
 
 
@@ -102,13 +190,22 @@ cCollisionAABB::~cCollisionAABB()
     dimensions such that it fully encloses the element and is aligned with
     the coordinate axes (no rotations).  Each internal node is associated
     with a boundary box of minimal dimensions such that it fully encloses
-    the boundary boxes of its two children and is aligned with the axes.
+    the boundary boxes of its two children and is aligned with the axes. \n\n
+
+    With \ref C_AABB_BUILD_CENTER, nodes are split at the center of their
+    longest axis. With \ref C_AABB_BUILD_SAH, nodes are split using a binned
+    surface area heuristic and large subtrees are built in parallel. This
+    method is slower to build on small models but produces better trees for
+    large scanned meshes.
 
-    \param  a_elements  Pointer to element array.
-    \param  a_radius    Bounding radius to add around each elements.
+    \param  a_elements     Pointer to element array.
+    \param  a_radius       Bounding radius to add around each elements.
+    \param  a_buildMethod  Method used to build the tree.
 */
 //==============================================================================
-void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double a_radius)
+void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, 
+                                const double a_radius,
+                                const cAABBBuildMethod a_buildMethod)
 {
     ////////////////////////////////////////////////////////////////////////////
     // INITIALIZATION
@@ -122,14 +219,30 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
     }
     m_elements = a_elements;
 
-    // store radius
+    // store radius and build method
     m_radius = a_radius;
+    m_buildMethod = a_buildMethod;
 
     // clear previous tree
     m_nodes.clear();
-
-    // get number of elements
+    m_packedNodes.clear();
+    m_buckets.clear();
+    m_bucketSlots.clear();
+    m_parentNodes.clear();
+    m_packedNodeIndices.clear();
+    m_vertexLeafOffsets.clear();
+    m_vertexLeaves.clear();
+    m_sumArea = 0.0;
+    m_buildCost = 0.0;
+    m_version++;
+
+    // get number of elements and vertices
     m_numElements = m_elements->getNumElements();
+    m_numVertices = m_elements->m_vertices->getNumElements();
+
+    // vertex positions and connectivity are now up to date
+    m_positionVersion = m_elements->m_vertices->getPositionVersion();
+    m_topologyVersion = m_elements->getTopologyVersion();
 
     // init variables
     m_maxDepth = 0;
@@ -226,7 +339,19 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
     int indexLast = m_numElements - 1;
     int depth = 0;
 
-    if (m_numElements > 1)
+    if ((m_numElements > 1) && (m_buildMethod == C_AABB_BUILD_SAH))
+    {
+        // number of tree levels at which subtrees are handed to new threads
+        int spawnDepth = 0;
+        while ((1u << spawnDepth) < cThread::getNumCores()) { spawnDepth++; }
+
+        // build internal nodes in a separate list, then append them to the leaves
+        vector<cCollisionAABBNode> nodes;
+        nodes.reserve(m_numElements);
+        m_rootIndex = buildTreeSAH(indexFirst, indexLast, depth, spawnDepth, nodes, m_maxDepth);
+        m_nodes.insert(m_nodes.end(), nodes.begin(), nodes.end());
+    }
+    else if (m_numElements > 1)
     {
         m_rootIndex = buildTree(indexFirst, indexLast, depth);
     }
@@ -234,18 +359,503 @@ void cCollisionAABB::initialize(const cGenericArrayPtr a_elements, const double
     {
         m_rootIndex = 0;
     }
+
+    // create packed version of the tree
+    buildPackedTree();
+
+    // prepare tree for refitting
+    buildRefitData();
+}
+
+
+//==============================================================================
+/*!
+    This method initializes the collision tree from a list of nodes produced
+    by a previous build, such as the nodes returned by \ref getNodes() and
+    stored in a file, instead of building the tree again. \n\n
+
+    The nodes are checked to form a binary tree whose leaves reference each
+    element exactly once. Their boundary boxes are used as they are, so the
+    nodes must have been built for the same elements, with the same vertex 
+    positions and radius. The list passed as argument is swapped with the 
+    internal list of nodes and is left empty.
+
+    \param  a_elements     Pointer to element array.
+    \param  a_radius       Bounding radius used to build the nodes.
+    \param  a_buildMethod  Method used to build the nodes.
+    \param  a_nodes        List of nodes.
+    \param  a_rootIndex    Index number of the root node.
+
+    \return __true__ if the nodes describe a valid tree, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionAABB::initialize(const cGenericArrayPtr a_elements,
+                                const double a_radius,
+                                const cAABBBuildMethod a_buildMethod,
+                                vector<cCollisionAABBNode>& a_nodes,
+                                const int a_rootIndex)
+{
+    // clear previous tree
+    m_nodes.clear();
+    m_packedNodes.clear();
+    m_buckets.clear();
+    m_bucketSlots.clear();
+    m_parentNodes.clear();
+    m_packedNodeIndices.clear();
+    m_vertexLeafOffsets.clear();
+    m_vertexLeaves.clear();
+    m_sumArea = 0.0;
+    m_buildCost = 0.0;
+    m_numElements = 0;
+    m_rootIndex = -1;
+    m_maxDepth = 0;
+
+    // sanity check
+    if (a_elements == nullptr)
+    {
+        return (false);
+    }
+
+    // check that the nodes form a binary tree holding one leaf per element, 
+    // and recompute the depth of each node
+    int numElements = a_elements->getNumElements();
+    int numNodes = (int)(a_nodes.size());
+    if (numElements == 0)
+    {
+        if ((numNodes > 0) || (a_rootIndex != -1)) { return (false); }
+    }
+    else
+    {
+        if ((numNodes != 2 * numElements - 1) || (a_rootIndex < 0) || (a_rootIndex >= numNodes))
+        {
+            return (false);
+        }
+
+        vector<bool> visitedNodes(numNodes, false);
+        vector<bool> visitedElements(numElements, false);
+        vector<int> stack;
+        stack.push_back(a_rootIndex);
+        a_nodes[a_rootIndex].m_depth = 0;
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+            if (visitedNodes[index]) { return (false); }
+            visitedNodes[index] = true;
+
+            cCollisionAABBNode& node = a_nodes[index];
+            if (node.m_nodeType == C_AABB_NODE_LEAF)
+            {
+                int element = node.m_leftSubTree;
+                if ((element < 0) || (element >= numElements) || (visitedElements[element])) { return (false); }
+                visitedElements[element] = true;
+            }
+            else if (node.m_nodeType == C_AABB_NODE_INTERNAL)
+            {
+                if ((node.m_leftSubTree < 0) || (node.m_leftSubTree >= numNodes) ||
+                    (node.m_rightSubTree < 0) || (node.m_rightSubTree >= numNodes))
+                {
+                    return (false);
+                }
+                a_nodes[node.m_leftSubTree].m_depth = node.m_depth + 1;
+                a_nodes[node.m_rightSubTree].m_depth = node.m_depth + 1;
+                stack.push_back(node.m_rightSubTree);
+                stack.push_back(node.m_leftSubTree);
+            }
+            else
+            {
+                return (false);
+            }
+        }
+
+        // a binary tree with one leaf per element visits every node once
+        for (int i=0; i<numElements; i++)
+        {
+            if (!visitedElements[i]) { return (false); }
+        }
+    }
+
+    // store elements, radius and build method
+    m_elements = a_elements;
+    m_radius = a_radius;
+    m_buildMethod = a_buildMethod;
+    m_numElements = numElements;
+    m_numVertices = m_elements->m_vertices->getNumElements();
+
+    // vertex positions and connectivity are now up to date
+    m_positionVersion = m_elements->m_vertices->getPositionVersion();
+    m_topologyVersion = m_elements->getTopologyVersion();
+
+    // store nodes
+    m_nodes.swap(a_nodes);
+    a_nodes.clear();
+    m_rootIndex = a_rootIndex;
+    m_maxDepth = 0;
+    for (int i=0; i<numNodes; i++)
+    {
+        m_maxDepth = cMax(m_maxDepth, m_nodes[i].m_depth);
+    }
+
+    // create packed version of the tree
+    buildPackedTree();
+
+    // prepare tree for refitting
+    buildRefitData();
+
+    // elements and boxes have been modified
+    m_version++;
+
+    return (true);
 }
 
 
 //==============================================================================
 /*!
     This methods updates the collision detector and should be called if the 
-    3D model it represents is modified.
+    3D model it represents is modified. The tree is rebuilt from scratch. 
+    Applications that only displace vertices through 
+    \ref cVertexArray::setLocalPos() or \ref cVertexArray::markPositionModified()
+    may call \ref refit() instead.
 */
 //==============================================================================
 void cCollisionAABB::update()
 {
-    initialize(m_elements, m_radius);
+    rebuild();
+}
+
+
+//==============================================================================
+/*!
+    This method rebuilds the collision tree from scratch using the same 
+    elements, radius and build method.
+*/
+//==============================================================================
+void cCollisionAABB::rebuild()
+{
+    initialize(m_elements, m_radius, m_buildMethod);
+    m_numRebuilds++;
+}
+
+
+//==============================================================================
+/*!
+    This method updates the boundary boxes of the collision tree so that they
+    enclose the current position of the elements, without modifying the 
+    structure of the tree. Only vertex displacements recorded by the vertex
+    array are taken into account (see \ref cVertexArray::markPositionModified()).
+    \n\n
+
+    If the vertex array reports a list of vertices modified since the last 
+    update, only the leaves attached to these vertices are updated, and 
+    changes are propagated towards the root until a node boundary box is left
+    unchanged. If the vertex array reports that all vertices may have been 
+    modified, the whole tree is refitted. If no vertex has been modified, 
+    this method does nothing. \n\n
+
+    The tree is rebuilt instead if elements have been created, removed or 
+    connected to different vertices since the last build, if the number of 
+    vertices has changed, or if the SAH cost of the refitted tree exceeds the
+    cost measured after the last build by more than the rebuild threshold.
+*/
+//==============================================================================
+void cCollisionAABB::refit()
+{
+    // sanity check
+    if (m_elements == nullptr) { return; }
+
+    cVertexArrayPtr vertices = m_elements->m_vertices;
+
+    // rebuild tree if its structure no longer matches the elements
+    if ((m_rootIndex < 0) ||
+        (m_rebuildThreshold <= 1.0) ||
+        (m_elements->getTopologyVersion() != m_topologyVersion) ||
+        ((int)(m_elements->getNumElements()) != m_numElements) ||
+        ((int)(vertices->getNumElements()) != m_numVertices))
+    {
+        rebuild();
+        return;
+    }
+
+    // get vertices modified since the last update
+    const unsigned int* modified;
+    unsigned int numModified;
+    bool partial = vertices->getModifiedPositions(m_positionVersion, modified, numModified);
+    if (partial && (numModified == 0)) { return; }
+
+    // refit whole tree
+    if (!partial)
+    {
+        refitSubTree(m_rootIndex);
+
+        // recompute sum of areas to avoid accumulating rounding errors
+        m_sumArea = 0.0;
+        int numNodes = (int)(m_nodes.size());
+        for (int i=0; i<numNodes; i++)
+        {
+            m_sumArea += cSurfaceArea(m_nodes[i].m_bbox);
+        }
+    }
+
+    // refit leaves attached to modified vertices
+    else
+    {
+        if (m_vertexLeafOffsets.size() == 0)
+        {
+            buildVertexLeaves();
+        }
+
+        for (unsigned int i=0; i<numModified; i++)
+        {
+            int vertex = modified[i];
+            for (int j=m_vertexLeafOffsets[vertex]; j<m_vertexLeafOffsets[vertex+1]; j++)
+            {
+                // update leaf, then its ancestors until a box is left unchanged
+                int node = m_vertexLeaves[j];
+                if (refitLeaf(node))
+                {
+                    node = m_parentNodes[node];
+                    while ((node >= 0) && refitNode(node))
+                    {
+                        node = m_parentNodes[node];
+                    }
+                }
+            }
+        }
+    }
+
+    // vertex positions are now up to date
+    m_positionVersion = vertices->getPositionVersion();
+    m_numRefits++;
+    m_version++;
+
+    // rebuild tree if its quality has degraded too much
+    if (getQualityRatio() > m_rebuildThreshold)
+    {
+        rebuild();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the ratio between the current surface area heuristic 
+    (SAH) cost of the tree and its cost after the last build. This ratio 
+    grows as the tree is refitted to follow deformations of the model.
+
+    \return Ratio between the current and initial SAH cost.
+*/
+//==============================================================================
+double cCollisionAABB::getQualityRatio() const
+{
+    if ((m_rootIndex < 0) || (m_buildCost <= 0.0)) { return (1.0); }
+
+    double rootArea = cSurfaceArea(m_nodes[m_rootIndex].m_bbox);
+    if (rootArea <= 0.0) { return (1.0); }
+
+    return ((m_sumArea / rootArea) / m_buildCost);
+}
+
+
+//==============================================================================
+/*!
+    This method builds the list of parent nodes and computes the sum of the 
+    surface areas of all nodes, from which the SAH cost of the tree is derived.
+*/
+//==============================================================================
+void cCollisionAABB::buildRefitData()
+{
+    int numNodes = (int)(m_nodes.size());
+
+    // parent of each node
+    m_parentNodes.assign(numNodes, -1);
+    m_sumArea = 0.0;
+    for (int i=0; i<numNodes; i++)
+    {
+        const cCollisionAABBNode& node = m_nodes[i];
+        if (node.m_nodeType == C_AABB_NODE_INTERNAL)
+        {
+            m_parentNodes[node.m_leftSubTree] = i;
+            m_parentNodes[node.m_rightSubTree] = i;
+        }
+        m_sumArea += cSurfaceArea(node.m_bbox);
+    }
+
+    // cost of the tree after build
+    m_buildCost = 0.0;
+    if (m_rootIndex >= 0)
+    {
+        double rootArea = cSurfaceArea(m_nodes[m_rootIndex].m_bbox);
+        if (rootArea > 0.0)
+        {
+            m_buildCost = m_sumArea / rootArea;
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method builds the list of leaves attached to each vertex, stored in
+    compressed form: the leaves of vertex _i_ are stored in 
+    \ref m_vertexLeaves between offsets \ref m_vertexLeafOffsets[i] and 
+    \ref m_vertexLeafOffsets[i+1].
+*/
+//==============================================================================
+void cCollisionAABB::buildVertexLeaves()
+{
+    int numVerticesPerElement = m_elements->getNumVerticesPerElement();
+
+    // count leaves attached to each vertex
+    m_vertexLeafOffsets.assign(m_numVertices + 1, 0);
+    for (int i=0; i<m_numElements; i++)
+    {
+        int element = m_nodes[i].m_leftSubTree;
+        for (int j=0; j<numVerticesPerElement; j++)
+        {
+            int vertex = m_elements->getVertexIndex(element, j);
+            if ((vertex >= 0) && (vertex < m_numVertices))
+            {
+                m_vertexLeafOffsets[vertex + 1]++;
+            }
+        }
+    }
+
+    // compute offsets
+    for (int i=0; i<m_numVertices; i++)
+    {
+        m_vertexLeafOffsets[i + 1] += m_vertexLeafOffsets[i];
+    }
+
+    // store leaves
+    m_vertexLeaves.resize(m_vertexLeafOffsets[m_numVertices]);
+    vector<int> count(m_vertexLeafOffsets.begin(), m_vertexLeafOffsets.end() - 1);
+    for (int i=0; i<m_numElements; i++)
+    {
+        int element = m_nodes[i].m_leftSubTree;
+        for (int j=0; j<numVerticesPerElement; j++)
+        {
+            int vertex = m_elements->getVertexIndex(element, j);
+            if ((vertex >= 0) && (vertex < m_numVertices))
+            {
+                m_vertexLeaves[count[vertex]] = i;
+                count[vertex]++;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the boundary box of a leaf from the current position
+    of the vertices of its element.
+
+    \param  a_nodeIndex  Index of the leaf.
+
+    \return __true__ if the boundary box has changed, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionAABB::refitLeaf(const int a_nodeIndex)
+{
+    cCollisionAABBNode leaf;
+    int element = m_nodes[a_nodeIndex].m_leftSubTree;
+    cVertexArrayPtr vertices = m_elements->m_vertices;
+
+    switch (m_elements->getNumVerticesPerElement())
+    {
+    case 1:
+        {
+            cVector3d vertex0 = vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+            leaf.fitBBox(m_radius, vertex0);
+            break;
+        }
+
+    case 2:
+        {
+            cVector3d vertex0 = vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+            cVector3d vertex1 = vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+            leaf.fitBBox(m_radius, vertex0, vertex1);
+            break;
+        }
+
+    case 3:
+        {
+            cVector3d vertex0 = vertices->getLocalPos(m_elements->getVertexIndex(element, 0));
+            cVector3d vertex1 = vertices->getLocalPos(m_elements->getVertexIndex(element, 1));
+            cVector3d vertex2 = vertices->getLocalPos(m_elements->getVertexIndex(element, 2));
+            leaf.fitBBox(m_radius, vertex0, vertex1, vertex2);
+            break;
+        }
+
+    default:
+        return (false);
+    }
+
+    const cCollisionAABBBox& bbox = m_nodes[a_nodeIndex].m_bbox;
+    if (bbox.m_min.equals(leaf.m_bbox.m_min) && bbox.m_max.equals(leaf.m_bbox.m_max))
+    {
+        // the triangle may have changed within an unchanged box
+        if ((m_bucketSlots.size() > 0) && (m_bucketSlots[a_nodeIndex] >= 0))
+        {
+            updateBucketSlot(a_nodeIndex);
+        }
+        return (false);
+    }
+
+    setNodeBox(a_nodeIndex, leaf.m_bbox);
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the boundary box of an internal node so that it 
+    encloses the boundary boxes of its two children.
+
+    \param  a_nodeIndex  Index of the internal node.
+
+    \return __true__ if the boundary box has changed, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionAABB::refitNode(const int a_nodeIndex)
+{
+    const cCollisionAABBNode& node = m_nodes[a_nodeIndex];
+
+    cCollisionAABBBox box;
+    box.enclose(m_nodes[node.m_leftSubTree].m_bbox, m_nodes[node.m_rightSubTree].m_bbox);
+
+    if (node.m_bbox.m_min.equals(box.m_min) && node.m_bbox.m_max.equals(box.m_max))
+    {
+        return (false);
+    }
+
+    setNodeBox(a_nodeIndex, box);
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method recursively recomputes the boundary boxes of a node and of all
+    its children.
+
+    \param  a_nodeIndex  Index of the node.
+*/
+//==============================================================================
+void cCollisionAABB::refitSubTree(const int a_nodeIndex)
+{
+    const cCollisionAABBNode& node = m_nodes[a_nodeIndex];
+
+    if (node.m_nodeType == C_AABB_NODE_LEAF)
+    {
+        refitLeaf(a_nodeIndex);
+    }
+    else
+    {
+        refitSubTree(node.m_leftSubTree);
+        refitSubTree(node.m_rightSubTree);
+        refitNode(a_nodeIndex);
+    }
 }
 
 
@@ -372,10 +982,700 @@ int cCollisionAABB::buildTree(const int a_indexFirstNode, const int a_indexLastN
 
 //==============================================================================
 /*!
-    This method checks if the given line segment intersects any element of the 
-    mesh. 
+    Given a __start__ and __end__ index value of leaf nodes, this method creates
+    a collision tree using the binned surface area heuristic. \n\n
 
-    If a collision occurs, the method returns __true__, and the collision events
+    Internal nodes are appended to the list passed as argument. Child indices
+    smaller than the number of elements refer to leaf nodes. Larger indices
+    refer to internal nodes, offset by the number of elements. As long as
+    \p a_spawnDepth is positive, the right subtree of large nodes is built by
+    a separate thread and its nodes are appended to the list once the thread
+    has completed.
+
+    \param  a_indexFirstNode  Lower index value of leaf node.
+    \param  a_indexLastNode   Upper index value of leaf node
+    \param  a_depth           Current depth of the tree. Root starts at 0.
+    \param  a_spawnDepth      Number of levels at which new threads may be created.
+    \param  a_nodes           List of internal nodes.
+    \param  a_maxDepth        Maximum depth of the tree, updated by this method.
+
+    \return Index of the new node.
+*/
+//==============================================================================
+int cCollisionAABB::buildTreeSAH(const int a_indexFirstNode,
+                                 const int a_indexLastNode,
+                                 const int a_depth,
+                                 const int a_spawnDepth,
+                                 std::vector<cCollisionAABBNode>& a_nodes,
+                                 int& a_maxDepth)
+{
+    // create new node
+    cCollisionAABBNode node;
+    node.m_depth = a_depth;
+    node.m_nodeType = C_AABB_NODE_INTERNAL;
+
+    // create a box to enclose all the leafs below this internal node
+    node.m_bbox.setEmpty();
+    for (int i=a_indexFirstNode; i<=a_indexLastNode; i++)
+    {
+        node.m_bbox.enclose(m_nodes[i].m_bbox);
+    }
+
+    // increment depth for child nodes
+    int depth = a_depth + 1;
+    a_maxDepth = cMax(a_maxDepth, depth);
+
+    // split leaves into two groups
+    int mid = splitSAH(a_indexFirstNode, a_indexLastNode, node.m_bbox);
+
+    // build left subtree
+    bool spawn = (a_spawnDepth > 0) && ((a_indexLastNode - a_indexFirstNode + 1) >= C_AABB_SAH_PARALLEL_MIN_ELEMENTS);
+    cCollisionAABBBuildTask task;
+    cThread thread;
+    if (spawn)
+    {
+        // build right subtree in a separate thread
+        task.m_tree = this;
+        task.m_indexFirstNode = mid + 1;
+        task.m_indexLastNode = a_indexLastNode;
+        task.m_depth = depth;
+        task.m_spawnDepth = a_spawnDepth - 1;
+        task.m_maxDepth = 0;
+        task.m_root = -1;
+        thread.start(buildTreeSAHThread, CTHREAD_PRIORITY_GRAPHICS, &task);
+    }
+
+    if (mid > a_indexFirstNode)
+    {
+        node.m_leftSubTree = buildTreeSAH(a_indexFirstNode, mid, depth, a_spawnDepth - 1, a_nodes, a_maxDepth);
+    }
+    else
+    {
+        node.m_leftSubTree = a_indexFirstNode;
+        m_nodes[a_indexFirstNode].m_depth = depth;
+    }
+
+    // build right subtree
+    if (spawn)
+    {
+        thread.join();
+
+        // append nodes created by the thread and remap their internal node indices
+        int offset = (int)(a_nodes.size());
+        for (unsigned int i=0; i<task.m_nodes.size(); i++)
+        {
+            cCollisionAABBNode& child = task.m_nodes[i];
+            if (child.m_leftSubTree >= m_numElements) { child.m_leftSubTree += offset; }
+            if (child.m_rightSubTree >= m_numElements) { child.m_rightSubTree += offset; }
+        }
+        a_nodes.insert(a_nodes.end(), task.m_nodes.begin(), task.m_nodes.end());
+        node.m_rightSubTree = (task.m_root >= m_numElements) ? task.m_root + offset : task.m_root;
+        a_maxDepth = cMax(a_maxDepth, task.m_maxDepth);
+    }
+    else if ((mid+1) < a_indexLastNode)
+    {
+        node.m_rightSubTree = buildTreeSAH((mid+1), a_indexLastNode, depth, a_spawnDepth - 1, a_nodes, a_maxDepth);
+    }
+    else
+    {
+        node.m_rightSubTree = a_indexLastNode;
+        m_nodes[a_indexLastNode].m_depth = depth;
+    }
+
+    // insert node
+    a_nodes.push_back(node);
+    return (m_numElements + (int)(a_nodes.size()) - 1);
+}
+
+
+//==============================================================================
+/*!
+    This method is the thread function used to build a subtree using the
+    surface area heuristic.
+
+    \param  a_task  Pointer to the subtree to be built.
+*/
+//==============================================================================
+void cCollisionAABB::buildTreeSAHThread(void* a_task)
+{
+    cCollisionAABBBuildTask* task = (cCollisionAABBBuildTask*)(a_task);
+
+    if (task->m_indexFirstNode < task->m_indexLastNode)
+    {
+        task->m_root = task->m_tree->buildTreeSAH(task->m_indexFirstNode,
+                                                  task->m_indexLastNode,
+                                                  task->m_depth,
+                                                  task->m_spawnDepth,
+                                                  task->m_nodes,
+                                                  task->m_maxDepth);
+    }
+    else
+    {
+        task->m_root = task->m_indexFirstNode;
+        task->m_tree->m_nodes[task->m_indexFirstNode].m_depth = task->m_depth;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method reorders the leaves between a __start__ and __end__ index so
+    that the leaves of the left subtree come first. The split plane is chosen
+    among \ref C_AABB_SAH_NUM_BINS candidates along each axis to minimize the
+    surface area heuristic.
+
+    \param  a_indexFirstNode  Lower index value of leaf node.
+    \param  a_indexLastNode   Upper index value of leaf node
+    \param  a_bbox            Boundary box enclosing all leaves.
+
+    \return Index of the last leaf of the left subtree.
+*/
+//==============================================================================
+int cCollisionAABB::splitSAH(const int a_indexFirstNode,
+                             const int a_indexLastNode,
+                             const cCollisionAABBBox& a_bbox)
+{
+    // two leaves, nothing to sort
+    if ((a_indexLastNode - a_indexFirstNode) == 1)
+    {
+        return (a_indexFirstNode);
+    }
+
+    // compute box enclosing the centers of all leaves
+    cCollisionAABBBox centerBox;
+    centerBox.setEmpty();
+    for (int i=a_indexFirstNode; i<=a_indexLastNode; i++)
+    {
+        centerBox.enclose(m_nodes[i].m_bbox.m_center);
+    }
+
+    // evaluate candidate splits along each axis
+    double bestCost = C_LARGE;
+    int bestAxis = -1;
+    int bestBin = 0;
+    for (int axis=0; axis<3; axis++)
+    {
+        double lower = centerBox.m_min(axis);
+        double extent = centerBox.m_max(axis) - lower;
+        if (extent <= 0.0) { continue; }
+        double scale = (double)(C_AABB_SAH_NUM_BINS) / extent;
+
+        // distribute leaves into bins
+        int count[C_AABB_SAH_NUM_BINS];
+        cCollisionAABBBox box[C_AABB_SAH_NUM_BINS];
+        for (int j=0; j<C_AABB_SAH_NUM_BINS; j++)
+        {
+            count[j] = 0;
+            box[j].setEmpty();
+        }
+        for (int i=a_indexFirstNode; i<=a_indexLastNode; i++)
+        {
+            int bin = cMin((int)((m_nodes[i].m_bbox.m_center(axis) - lower) * scale), C_AABB_SAH_NUM_BINS - 1);
+            count[bin]++;
+            box[bin].enclose(m_nodes[i].m_bbox);
+        }
+
+        // sweep from the right to compute the cost of the right side of each split
+        double rightCost[C_AABB_SAH_NUM_BINS];
+        cCollisionAABBBox rightBox;
+        rightBox.setEmpty();
+        int rightCount = 0;
+        for (int j=C_AABB_SAH_NUM_BINS-1; j>0; j--)
+        {
+            if (count[j] > 0)
+            {
+                rightBox.enclose(box[j]);
+                rightCount += count[j];
+            }
+            rightCost[j] = (rightCount > 0) ? rightCount * cSurfaceArea(rightBox) : 0.0;
+        }
+
+        // sweep from the left and keep the best split
+        cCollisionAABBBox leftBox;
+        leftBox.setEmpty();
+        int leftCount = 0;
+        for (int j=0; j<C_AABB_SAH_NUM_BINS-1; j++)
+        {
+            if (count[j] > 0)
+            {
+                leftBox.enclose(box[j]);
+                leftCount += count[j];
+            }
+            if ((leftCount == 0) || (leftCount == (a_indexLastNode - a_indexFirstNode + 1))) { continue; }
+
+            double cost = leftCount * cSurfaceArea(leftBox) + rightCost[j+1];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = j;
+            }
+        }
+    }
+
+    // all centers coincide: split the range in two halves
+    if (bestAxis < 0)
+    {
+        return ((a_indexLastNode + a_indexFirstNode) / 2);
+    }
+
+    // move leaves of the left bins towards the beginning of the array
+    double lower = centerBox.m_min(bestAxis);
+    double scale = (double)(C_AABB_SAH_NUM_BINS) / (centerBox.m_max(bestAxis) - lower);
+    int i = a_indexFirstNode;
+    int j = a_indexLastNode;
+    while (i <= j)
+    {
+        int bin = cMin((int)((m_nodes[i].m_bbox.m_center(bestAxis) - lower) * scale), C_AABB_SAH_NUM_BINS - 1);
+        if (bin <= bestBin)
+        {
+            i++;
+        }
+        else
+        {
+            cSwap(m_nodes[i], m_nodes[j]);
+            j--;
+        }
+    }
+
+    // guarantee that neither subtree is empty
+    int mid = i - 1;
+    if ((mid < a_indexFirstNode) || (mid >= a_indexLastNode))
+    {
+        mid = (a_indexLastNode + a_indexFirstNode) / 2;
+    }
+
+    return (mid);
+}
+
+
+//==============================================================================
+/*!
+    This method computes statistics that describe the quality of the collision
+    tree, such as its surface area heuristic cost and depth.
+
+    \return Statistics of the collision tree.
+*/
+//==============================================================================
+cCollisionAABBStatistics cCollisionAABB::computeStatistics() const
+{
+    cCollisionAABBStatistics stats;
+    stats.m_sahCost = 0.0;
+    stats.m_numNodes = 0;
+    stats.m_numLeaves = 0;
+    stats.m_maxDepth = 0;
+    stats.m_averageLeafDepth = 0.0;
+    stats.m_averageLeafSize = 0.0;
+    stats.m_maxLeafSize = 0;
+
+    // sanity check
+    if (m_rootIndex < 0) { return (stats); }
+
+    double rootArea = cSurfaceArea(m_nodes[m_rootIndex].m_bbox);
+    if (rootArea <= 0.0) { rootArea = 1.0; }
+
+    // traverse tree
+    vector<int> stack;
+    vector<int> depths;
+    stack.push_back(m_rootIndex);
+    depths.push_back(0);
+    while (stack.size() > 0)
+    {
+        int index = stack.back();
+        int depth = depths.back();
+        stack.pop_back();
+        depths.pop_back();
+
+        const cCollisionAABBNode& node = m_nodes[index];
+        double probability = cSurfaceArea(node.m_bbox) / rootArea;
+        stats.m_numNodes++;
+        stats.m_maxDepth = cMax(stats.m_maxDepth, depth);
+
+        if (node.m_nodeType == C_AABB_NODE_LEAF)
+        {
+            stats.m_numLeaves++;
+            stats.m_averageLeafDepth += depth;
+            stats.m_sahCost += probability;
+            stats.m_maxLeafSize = 1;
+        }
+        else
+        {
+            stats.m_sahCost += probability;
+            stack.push_back(node.m_rightSubTree);
+            depths.push_back(depth + 1);
+            stack.push_back(node.m_leftSubTree);
+            depths.push_back(depth + 1);
+        }
+    }
+
+    if (stats.m_numLeaves > 0)
+    {
+        stats.m_averageLeafDepth /= (double)(stats.m_numLeaves);
+        stats.m_averageLeafSize = 1.0;
+    }
+
+    return (stats);
+}
+
+
+//==============================================================================
+/*!
+    This function rounds a double precision value to the largest single
+    precision value that is smaller or equal.
+
+    \param  a_value  Value to be rounded.
+
+    \return Rounded value.
+*/
+//==============================================================================
+static inline float cRoundDownFloat(const double a_value)
+{
+    float result = (float)a_value;
+    while ((double)result > a_value)
+    {
+        result -= cMax((float)fabs(result) * FLT_EPSILON, FLT_MIN);
+    }
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This function rounds a double precision value to the smallest single
+    precision value that is larger or equal.
+
+    \param  a_value  Value to be rounded.
+
+    \return Rounded value.
+*/
+//==============================================================================
+static inline float cRoundUpFloat(const double a_value)
+{
+    float result = (float)a_value;
+    while ((double)result < a_value)
+    {
+        result += cMax((float)fabs(result) * FLT_EPSILON, FLT_MIN);
+    }
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method builds the packed collision tree from the list of nodes created
+    by \ref buildTree(). Nodes are stored in depth-first order. If the tree is
+    too deep to be traversed with a stack of size \ref C_AABB_PACKED_STACK_SIZE,
+    the packed tree is left empty and collision queries use the original tree.
+*/
+//==============================================================================
+void cCollisionAABB::buildPackedTree()
+{
+    // clear previous tree
+    m_packedNodes.clear();
+    m_buckets.clear();
+    m_bucketSlots.clear();
+
+    // sanity check
+    if (m_rootIndex < 0) { return; }
+
+    // the traversal stack holds at most one node per level plus the current node
+    if ((m_maxDepth + 2) > C_AABB_PACKED_STACK_SIZE) { return; }
+
+    // count leaves below each node to find subtrees that fit in a bucket
+    vector<int> numLeaves;
+    if (m_useTriangleBuckets && (m_elements->getNumVerticesPerElement() == 3))
+    {
+        numLeaves.assign(m_nodes.size(), 0);
+        countLeaves(m_rootIndex, numLeaves);
+        m_bucketSlots.assign(m_nodes.size(), -1);
+    }
+
+    // copy nodes in depth-first order
+    m_packedNodes.reserve(m_nodes.size());
+    m_packedNodeIndices.assign(m_nodes.size(), -1);
+    buildPackedNode(m_rootIndex, numLeaves);
+}
+
+
+//==============================================================================
+/*!
+    This method enables or disables the storage of triangles in buckets in the
+    packed collision tree, and rebuilds the packed tree accordingly.
+
+    \param  a_useTriangleBuckets  If __true__, triangles are stored in buckets.
+*/
+//==============================================================================
+void cCollisionAABB::setUseTriangleBuckets(const bool a_useTriangleBuckets)
+{
+    if (m_useTriangleBuckets == a_useTriangleBuckets) { return; }
+
+    m_useTriangleBuckets = a_useTriangleBuckets;
+    buildPackedTree();
+}
+
+
+//==============================================================================
+/*!
+    This method recursively counts the number of leaves below each node.
+
+    \param  a_nodeIndex  Index of node.
+    \param  a_numLeaves  Number of leaves below each node, updated by this method.
+
+    \return Number of leaves below the node.
+*/
+//==============================================================================
+int cCollisionAABB::countLeaves(const int a_nodeIndex, vector<int>& a_numLeaves)
+{
+    const cCollisionAABBNode& node = m_nodes[a_nodeIndex];
+
+    int count = 1;
+    if (node.m_nodeType == C_AABB_NODE_INTERNAL)
+    {
+        count = countLeaves(node.m_leftSubTree, a_numLeaves) + countLeaves(node.m_rightSubTree, a_numLeaves);
+    }
+
+    a_numLeaves[a_nodeIndex] = count;
+    return (count);
+}
+
+
+//==============================================================================
+/*!
+    This method copies a node, and recursively its children, to the packed
+    collision tree.
+
+    Internal nodes with at most \ref C_AABB_BUCKET_SIZE leaves are stored as
+    a single leaf holding a bucket of triangles if \p a_numLeaves is not empty.
+
+    \param  a_nodeIndex  Index of node in the original tree.
+    \param  a_numLeaves  Number of leaves below each node, or an empty list.
+
+    \return Index of node in the packed tree.
+*/
+//==============================================================================
+int cCollisionAABB::buildPackedNode(const int a_nodeIndex, const vector<int>& a_numLeaves)
+{
+    const cCollisionAABBNode& node = m_nodes[a_nodeIndex];
+
+    // create packed node with conservative single precision bounds
+    cCollisionAABBPackedNode packedNode;
+    for (int i=0; i<3; i++)
+    {
+        packedNode.m_min[i] = cRoundDownFloat(node.m_bbox.m_min(i));
+        packedNode.m_max[i] = cRoundUpFloat(node.m_bbox.m_max(i));
+    }
+
+    // insert node
+    int index = (int)(m_packedNodes.size());
+    m_packedNodes.push_back(packedNode);
+    m_packedNodeIndices[a_nodeIndex] = index;
+
+    // leaf node
+    if (node.m_nodeType == C_AABB_NODE_LEAF)
+    {
+        m_packedNodes[index].m_leftSubTree  = node.m_leftSubTree;
+        m_packedNodes[index].m_rightSubTree = -1;
+    }
+
+    // small subtree stored as a bucket of triangles
+    else if ((a_numLeaves.size() > 0) && (a_numLeaves[a_nodeIndex] <= C_AABB_BUCKET_SIZE))
+    {
+        cCollisionAABBTriangleBucket bucket;
+        for (int i=0; i<C_AABB_BUCKET_SIZE; i++)
+        {
+            for (int j=0; j<3; j++)
+            {
+                bucket.m_min[j][i] =  FLT_MAX;
+                bucket.m_max[j][i] = -FLT_MAX;
+            }
+            for (int j=0; j<C_AABB_BUCKET_NUM_PLANES; j++)
+            {
+                for (int k=0; k<4; k++)
+                {
+                    bucket.m_planes[j][k][i] = 0.0f;
+                }
+            }
+            bucket.m_elementIndices[i] = -1;
+        }
+        bucket.m_numElements = 0;
+        cVector3d center = node.m_bbox.getCenter();
+        for (int j=0; j<3; j++)
+        {
+            bucket.m_origin[j] = center(j);
+        }
+        bucket.m_extent = 0.0;
+
+        int bucketIndex = (int)(m_buckets.size());
+        m_buckets.push_back(bucket);
+        addBucketLeaves(a_nodeIndex, bucketIndex);
+
+        m_packedNodes[index].m_leftSubTree  = bucketIndex;
+        m_packedNodes[index].m_rightSubTree = C_AABB_PACKED_BUCKET;
+    }
+
+    // internal node
+    else
+    {
+        int left  = buildPackedNode(node.m_leftSubTree, a_numLeaves);
+        int right = buildPackedNode(node.m_rightSubTree, a_numLeaves);
+        m_packedNodes[index].m_leftSubTree  = left;
+        m_packedNodes[index].m_rightSubTree = right;
+    }
+
+    return (index);
+}
+
+
+//==============================================================================
+/*!
+    This method recursively adds the leaves of a subtree to a bucket of 
+    triangles, in depth-first order.
+
+    \param  a_nodeIndex    Index of the root node of the subtree.
+    \param  a_bucketIndex  Index of the bucket.
+*/
+//==============================================================================
+void cCollisionAABB::addBucketLeaves(const int a_nodeIndex, const int a_bucketIndex)
+{
+    const cCollisionAABBNode& node = m_nodes[a_nodeIndex];
+
+    if (node.m_nodeType == C_AABB_NODE_LEAF)
+    {
+        cCollisionAABBTriangleBucket& bucket = m_buckets[a_bucketIndex];
+        int slot = bucket.m_numElements;
+        bucket.m_numElements++;
+        bucket.m_elementIndices[slot] = node.m_leftSubTree;
+        m_bucketSlots[a_nodeIndex] = a_bucketIndex * C_AABB_BUCKET_SIZE + slot;
+        updateBucketSlot(a_nodeIndex);
+    }
+    else
+    {
+        addBucketLeaves(node.m_leftSubTree, a_bucketIndex);
+        addBucketLeaves(node.m_rightSubTree, a_bucketIndex);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the bounding box and the planes of the triangle of a
+    leaf stored in a bucket.
+
+    \param  a_nodeIndex  Index of the leaf.
+*/
+//==============================================================================
+void cCollisionAABB::updateBucketSlot(const int a_nodeIndex)
+{
+    const cCollisionAABBNode& node = m_nodes[a_nodeIndex];
+    cCollisionAABBTriangleBucket& bucket = m_buckets[m_bucketSlots[a_nodeIndex] / C_AABB_BUCKET_SIZE];
+    int slot = m_bucketSlots[a_nodeIndex] % C_AABB_BUCKET_SIZE;
+
+    // bounding box, rounded as in the packed tree
+    for (int i=0; i<3; i++)
+    {
+        bucket.m_min[i][slot] = cRoundDownFloat(node.m_bbox.m_min(i));
+        bucket.m_max[i][slot] = cRoundUpFloat(node.m_bbox.m_max(i));
+    }
+
+    // vertices relative to the origin of the bucket
+    cVector3d origin(bucket.m_origin[0], bucket.m_origin[1], bucket.m_origin[2]);
+    cVector3d vertex[3];
+    for (int i=0; i<3; i++)
+    {
+        vertex[i] = m_elements->m_vertices->getLocalPos(m_elements->getVertexIndex(node.m_leftSubTree, i)) - origin;
+        for (int j=0; j<3; j++)
+        {
+            bucket.m_extent = cMax(bucket.m_extent, fabs(vertex[i](j)));
+        }
+    }
+
+    // planes are left to zero for degenerated triangles and edges, so they never reject a segment
+    for (int i=0; i<C_AABB_BUCKET_NUM_PLANES; i++)
+    {
+        for (int j=0; j<4; j++)
+        {
+            bucket.m_planes[i][j][slot] = 0.0f;
+        }
+    }
+
+    // supporting plane of the triangle
+    cVector3d normal = cCross(vertex[1] - vertex[0], vertex[2] - vertex[0]);
+    double length = normal.length();
+    if (!(length > 0.0)) { return; }
+    normal.div(length);
+    for (int j=0; j<3; j++)
+    {
+        bucket.m_planes[0][j][slot] = (float)normal(j);
+    }
+    bucket.m_planes[0][3][slot] = (float)cDot(normal, vertex[0]);
+
+    // plane through each edge, perpendicular to the triangle and pointing outwards
+    for (int i=0; i<3; i++)
+    {
+        const cVector3d& vertex0 = vertex[i];
+        const cVector3d& vertex1 = vertex[(i+1) % 3];
+        const cVector3d& vertex2 = vertex[(i+2) % 3];
+
+        cVector3d edgeNormal = cCross(vertex1 - vertex0, normal);
+        double edgeLength = edgeNormal.length();
+        if (!(edgeLength > 0.0)) { continue; }
+        edgeNormal.div(edgeLength);
+        if (cDot(edgeNormal, vertex2 - vertex0) > 0.0)
+        {
+            edgeNormal.negate();
+        }
+
+        for (int j=0; j<3; j++)
+        {
+            bucket.m_planes[i+1][j][slot] = (float)edgeNormal(j);
+        }
+        bucket.m_planes[i+1][3][slot] = (float)cDot(edgeNormal, vertex0);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method assigns a new boundary box to a node, and updates the sum of
+    node areas and the corresponding node of the packed collision tree.
+
+    \param  a_nodeIndex  Index of the node.
+    \param  a_bbox       New boundary box.
+*/
+//==============================================================================
+void cCollisionAABB::setNodeBox(const int a_nodeIndex, const cCollisionAABBBox& a_bbox)
+{
+    m_sumArea += cSurfaceArea(a_bbox) - cSurfaceArea(m_nodes[a_nodeIndex].m_bbox);
+    m_nodes[a_nodeIndex].m_bbox = a_bbox;
+
+    if (m_packedNodes.size() > 0)
+    {
+        // node of the packed tree
+        if (m_packedNodeIndices[a_nodeIndex] >= 0)
+        {
+            cCollisionAABBPackedNode& packedNode = m_packedNodes[m_packedNodeIndices[a_nodeIndex]];
+            for (int i=0; i<3; i++)
+            {
+                packedNode.m_min[i] = cRoundDownFloat(a_bbox.m_min(i));
+                packedNode.m_max[i] = cRoundUpFloat(a_bbox.m_max(i));
+            }
+        }
+
+        // triangle stored in a bucket
+        if ((m_bucketSlots.size() > 0) && (m_bucketSlots[a_nodeIndex] >= 0))
+        {
+            updateBucketSlot(a_nodeIndex);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method checks if the given line segment intersects any element of the 
+    mesh. 
+
+    If a collision occurs, the method returns __true__, and the collision events
     are reported through the collision recorder. Each collision event reports 
     pointers to the intersected element, the mesh of which this element is a part, 
     the point of intersection, and the distance from the origin of the segment to 
@@ -399,6 +1699,16 @@ bool cCollisionAABB::computeCollision(cGenericObject* a_object,
     // sanity check
     if (m_rootIndex == -1) { return (false); }
 
+    // use packed tree if available
+    if (m_usePackedTree && (m_packedNodes.size() > 0))
+    {
+        return (computeCollisionPacked(a_object,
+                                       a_segmentPointA,
+                                       a_segmentPointB,
+                                       a_recorder,
+                                       a_settings));
+    }
+
     // init stack
     std::vector<cCollisionAABBStack> stack;
     stack.resize(m_maxDepth+1);
@@ -534,6 +1844,519 @@ bool cCollisionAABB::computeCollision(cGenericObject* a_object,
 }
 
 
+//==============================================================================
+/*!
+    This function clips a segment against the slabs of a single precision 
+    bounding box, enlarged by a radius along each axis.
+
+    \param  a_origin    Start point of the segment.
+    \param  a_invDir    Inverse of the segment direction along each axis.
+    \param  a_parallel  __true__ for each axis along which the segment is degenerated.
+    \param  a_lower     Lower corner of the box.
+    \param  a_upper     Upper corner of the box.
+    \param  a_radius    Radius by which the box is enlarged.
+
+    \return __true__ if the segment intersects the box, __false__ otherwise.
+*/
+//==============================================================================
+static inline bool cIntersectionSegmentSlabs(const double* a_origin,
+                                             const double* a_invDir,
+                                             const bool* a_parallel,
+                                             const float a_lower[3],
+                                             const float a_upper[3],
+                                             const double a_radius)
+{
+    double tmin = 0.0;
+    double tmax = 1.0;
+    for (int i=0; i<3; i++)
+    {
+        double lower = (double)a_lower[i] - a_radius;
+        double upper = (double)a_upper[i] + a_radius;
+        if (a_parallel[i])
+        {
+            if ((a_origin[i] < lower) || (a_origin[i] > upper))
+            {
+                return (false);
+            }
+        }
+        else
+        {
+            double t0 = (lower - a_origin[i]) * a_invDir[i];
+            double t1 = (upper - a_origin[i]) * a_invDir[i];
+            if (t0 > t1) { cSwap(t0, t1); }
+            if (t0 > tmin) { tmin = t0; }
+            if (t1 < tmax) { tmax = t1; }
+            if (tmin > tmax)
+            {
+                return (false);
+            }
+        }
+    }
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This function returns the triangles of a bucket that may collide with a
+    segment. A triangle is rejected if the bounding box of the segment,
+    enlarged by the collision radius, does not overlap its bounding box, or
+    if both end points of the segment lie further than the margin outside
+    one of its planes. The margin includes the
+    collision radius and a tolerance for single precision rounding errors. \n\n
+
+    All triangles of the bucket are processed at once using AVX instructions,
+    or four at a time using SSE instructions. A scalar implementation is used
+    when neither is available.
+
+    \param  a_bucket  Bucket of triangles.
+    \param  a_query   Segment expressed in single precision.
+
+    \return Bit mask of the slots of the triangles that may collide with the segment.
+*/
+//==============================================================================
+static inline int cCollisionAABBBucketCandidates(const cCollisionAABBTriangleBucket& a_bucket,
+                                                 const cCollisionAABBBucketQuery& a_query)
+{
+#if defined(C_AABB_BUCKET_AVX)
+
+    __m256 candidates = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+    // bounding boxes
+    for (int i=0; i<3; i++)
+    {
+        candidates = _mm256_and_ps(candidates, _mm256_cmp_ps(_mm256_set1_ps(a_query.m_segmentMin[i]), _mm256_loadu_ps(a_bucket.m_max[i]), _CMP_NGT_UQ));
+        candidates = _mm256_and_ps(candidates, _mm256_cmp_ps(_mm256_set1_ps(a_query.m_segmentMax[i]), _mm256_loadu_ps(a_bucket.m_min[i]), _CMP_NLT_UQ));
+    }
+
+    // planes
+    __m256 margin = _mm256_set1_ps(a_query.m_margin);
+    __m256 negMargin = _mm256_set1_ps(-a_query.m_margin);
+    for (int i=0; i<C_AABB_BUCKET_NUM_PLANES; i++)
+    {
+        __m256 nx = _mm256_loadu_ps(a_bucket.m_planes[i][0]);
+        __m256 ny = _mm256_loadu_ps(a_bucket.m_planes[i][1]);
+        __m256 nz = _mm256_loadu_ps(a_bucket.m_planes[i][2]);
+        __m256 d  = _mm256_loadu_ps(a_bucket.m_planes[i][3]);
+
+        __m256 distanceA = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, _mm256_set1_ps(a_query.m_pointA[0])),
+                                                                     _mm256_mul_ps(ny, _mm256_set1_ps(a_query.m_pointA[1]))),
+                                                                     _mm256_mul_ps(nz, _mm256_set1_ps(a_query.m_pointA[2]))), d);
+        __m256 distanceB = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, _mm256_set1_ps(a_query.m_pointB[0])),
+                                                                     _mm256_mul_ps(ny, _mm256_set1_ps(a_query.m_pointB[1]))),
+                                                                     _mm256_mul_ps(nz, _mm256_set1_ps(a_query.m_pointB[2]))), d);
+
+        __m256 outside = _mm256_and_ps(_mm256_cmp_ps(distanceA, margin, _CMP_GT_OQ), _mm256_cmp_ps(distanceB, margin, _CMP_GT_OQ));
+        if (i == 0)
+        {
+            // the supporting plane also rejects segments located below the triangle
+            outside = _mm256_or_ps(outside, _mm256_and_ps(_mm256_cmp_ps(distanceA, negMargin, _CMP_LT_OQ), _mm256_cmp_ps(distanceB, negMargin, _CMP_LT_OQ)));
+        }
+        candidates = _mm256_andnot_ps(outside, candidates);
+    }
+
+    return (_mm256_movemask_ps(candidates));
+
+#elif defined(C_AABB_BUCKET_SSE)
+
+    int result = 0;
+    __m128 margin = _mm_set1_ps(a_query.m_margin);
+    __m128 negMargin = _mm_set1_ps(-a_query.m_margin);
+    for (int k=0; k<C_AABB_BUCKET_SIZE; k+=4)
+    {
+        __m128 candidates = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        // bounding boxes
+        for (int i=0; i<3; i++)
+        {
+            candidates = _mm_and_ps(candidates, _mm_cmpngt_ps(_mm_set1_ps(a_query.m_segmentMin[i]), _mm_loadu_ps(&a_bucket.m_max[i][k])));
+            candidates = _mm_and_ps(candidates, _mm_cmpnlt_ps(_mm_set1_ps(a_query.m_segmentMax[i]), _mm_loadu_ps(&a_bucket.m_min[i][k])));
+        }
+
+        // planes
+        for (int i=0; i<C_AABB_BUCKET_NUM_PLANES; i++)
+        {
+            __m128 nx = _mm_loadu_ps(&a_bucket.m_planes[i][0][k]);
+            __m128 ny = _mm_loadu_ps(&a_bucket.m_planes[i][1][k]);
+            __m128 nz = _mm_loadu_ps(&a_bucket.m_planes[i][2][k]);
+            __m128 d  = _mm_loadu_ps(&a_bucket.m_planes[i][3][k]);
+
+            __m128 distanceA = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps(a_query.m_pointA[0])),
+                                                                _mm_mul_ps(ny, _mm_set1_ps(a_query.m_pointA[1]))),
+                                                                _mm_mul_ps(nz, _mm_set1_ps(a_query.m_pointA[2]))), d);
+            __m128 distanceB = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps(a_query.m_pointB[0])),
+                                                                _mm_mul_ps(ny, _mm_set1_ps(a_query.m_pointB[1]))),
+                                                                _mm_mul_ps(nz, _mm_set1_ps(a_query.m_pointB[2]))), d);
+
+            __m128 outside = _mm_and_ps(_mm_cmpgt_ps(distanceA, margin), _mm_cmpgt_ps(distanceB, margin));
+            if (i == 0)
+            {
+                // the supporting plane also rejects segments located below the triangle
+                outside = _mm_or_ps(outside, _mm_and_ps(_mm_cmplt_ps(distanceA, negMargin), _mm_cmplt_ps(distanceB, negMargin)));
+            }
+            candidates = _mm_andnot_ps(outside, candidates);
+        }
+
+        result |= (_mm_movemask_ps(candidates) << k);
+    }
+
+    return (result);
+
+#else
+
+    int result = 0;
+    for (int k=0; k<a_bucket.m_numElements; k++)
+    {
+        // bounding box
+        bool candidate = true;
+        for (int i=0; i<3; i++)
+        {
+            if ((a_query.m_segmentMin[i] > a_bucket.m_max[i][k]) || (a_query.m_segmentMax[i] < a_bucket.m_min[i][k]))
+            {
+                candidate = false;
+            }
+        }
+
+        // planes
+        for (int i=0; (i<C_AABB_BUCKET_NUM_PLANES) && candidate; i++)
+        {
+            float distanceA = a_bucket.m_planes[i][0][k] * a_query.m_pointA[0] +
+                              a_bucket.m_planes[i][1][k] * a_query.m_pointA[1] +
+                              a_bucket.m_planes[i][2][k] * a_query.m_pointA[2] - a_bucket.m_planes[i][3][k];
+            float distanceB = a_bucket.m_planes[i][0][k] * a_query.m_pointB[0] +
+                              a_bucket.m_planes[i][1][k] * a_query.m_pointB[1] +
+                              a_bucket.m_planes[i][2][k] * a_query.m_pointB[2] - a_bucket.m_planes[i][3][k];
+
+            if ((distanceA > a_query.m_margin) && (distanceB > a_query.m_margin))
+            {
+                candidate = false;
+            }
+            if ((i == 0) && (distanceA < -a_query.m_margin) && (distanceB < -a_query.m_margin))
+            {
+                candidate = false;
+            }
+        }
+
+        if (candidate)
+        {
+            result |= (1 << k);
+        }
+    }
+
+    return (result);
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method checks if the given line segment intersects any element of the
+    mesh by traversing the packed collision tree. The traversal stack has a
+    fixed size and is allocated on the calling thread, therefore no memory is
+    allocated during the query. Nodes are visited in the same order as in
+    \ref computeCollision(), and the boxes of single elements are enlarged
+    by the collision radius of the settings before they are tested. \n\n
+
+    Both methods report identical results if the collision radius of the
+    settings does not exceed the radius passed to initialize(). Otherwise,
+    \ref computeCollision() culls internal nodes without the collision
+    radius and may miss collisions that this method reports.
+
+    \param  a_object         Object for which collision detector is being used.
+    \param  a_segmentPointA  Initial point of segment.
+    \param  a_segmentPointB  End point of segment.
+    \param  a_recorder       Recorder which stores all collision events.
+    \param  a_settings       Contains collision settings information.
+
+    \return  __true__ if a collision event has occurred, __false__otherwise.
+*/
+//==============================================================================
+bool cCollisionAABB::computeCollisionPacked(cGenericObject* a_object,
+                                            cVector3d& a_segmentPointA,
+                                            cVector3d& a_segmentPointB,
+                                            cCollisionRecorder& a_recorder,
+                                            cCollisionSettings& a_settings)
+{
+    // no collision occurred yet
+    bool result = false;
+
+    // compute segment origin, direction and inverse direction
+    double origin[3];
+    double dir[3];
+    double invDir[3];
+    bool parallel[3];
+    for (int i=0; i<3; i++)
+    {
+        origin[i] = a_segmentPointA(i);
+        dir[i] = a_segmentPointB(i) - a_segmentPointA(i);
+        parallel[i] = (fabs(dir[i]) < C_TINY);
+        invDir[i] = parallel[i] ? 0.0 : 1.0 / dir[i];
+    }
+
+    // collision radius, by which the boxes of single elements are enlarged
+    double radius = cMax(0.0, a_settings.m_collisionRadius);
+
+    // bounding box of the segment enlarged by the collision radius, rounded
+    // outwards to single precision
+    cCollisionAABBBucketQuery query;
+    for (int i=0; i<3; i++)
+    {
+        query.m_segmentMin[i] = cRoundDownFloat(cMin(a_segmentPointA(i), a_segmentPointB(i)) - radius);
+        query.m_segmentMax[i] = cRoundUpFloat(cMax(a_segmentPointA(i), a_segmentPointB(i)) + radius);
+    }
+
+    // init stack
+    int stack[C_AABB_PACKED_STACK_SIZE];
+    int index = 0;
+    stack[0] = 0;
+
+    // collision search
+    const cCollisionAABBPackedNode* nodes = &(m_packedNodes[0]);
+    while (index > -1)
+    {
+        // pop node from stack
+        const cCollisionAABBPackedNode& node = nodes[stack[index]];
+        index--;
+
+        // clip segment against the slabs of the node bounding box, enlarged
+        // by the collision radius if the node holds a single element
+        double nodeRadius = (node.isLeaf() && !node.isBucket()) ? radius : 0.0;
+        if (!cIntersectionSegmentSlabs(origin, invDir, parallel, node.m_min, node.m_max, nodeRadius)) { continue; }
+
+        //----------------------------------------------------------------------
+        // BUCKET OF TRIANGLES:
+        //----------------------------------------------------------------------
+        if (node.isBucket())
+        {
+            const cCollisionAABBTriangleBucket& bucket = m_buckets[node.m_leftSubTree];
+
+            // express segment relative to the origin of the bucket
+            double size = bucket.m_extent;
+            for (int i=0; i<3; i++)
+            {
+                double pointA = a_segmentPointA(i) - bucket.m_origin[i];
+                double pointB = a_segmentPointB(i) - bucket.m_origin[i];
+                query.m_pointA[i] = (float)pointA;
+                query.m_pointB[i] = (float)pointB;
+                size = cMax(size, cMax(fabs(pointA), fabs(pointB)));
+            }
+            query.m_margin = (float)(a_settings.m_collisionRadius + C_AABB_BUCKET_TOLERANCE * size);
+
+            // cull triangles of the bucket
+            int candidates = cCollisionAABBBucketCandidates(bucket, query);
+
+            // test remaining triangles in the same order as the original tree
+            for (int i=0; i<bucket.m_numElements; i++)
+            {
+                if ((candidates & (1 << i)) == 0) { continue; }
+
+                const float lower[3] = { bucket.m_min[0][i], bucket.m_min[1][i], bucket.m_min[2][i] };
+                const float upper[3] = { bucket.m_max[0][i], bucket.m_max[1][i], bucket.m_max[2][i] };
+                if (!cIntersectionSegmentSlabs(origin, invDir, parallel, lower, upper, radius)) { continue; }
+
+                int elementIndex = bucket.m_elementIndices[i];
+                if (m_elements->m_allocated[elementIndex])
+                {
+                    if (m_elements->computeCollision(elementIndex,
+                        a_object,
+                        a_segmentPointA,
+                        a_segmentPointB,
+                        a_recorder,
+                        a_settings))
+                    {
+                        result = true;
+                    }
+                }
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // LEAF NODE:
+        //----------------------------------------------------------------------
+        else if (node.isLeaf())
+        {
+            // get index of leaf element
+            int elementIndex = node.m_leftSubTree;
+
+            // call the element's collision detection method
+            if (m_elements->m_allocated[elementIndex])
+            {
+                if (m_elements->computeCollision(elementIndex,
+                    a_object,
+                    a_segmentPointA,
+                    a_segmentPointB,
+                    a_recorder,
+                    a_settings))
+                {
+                    result = true;
+                }
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // INTERNAL NODE:
+        //----------------------------------------------------------------------
+        else
+        {
+            // push right child first so that the left child is visited first
+            stack[++index] = node.m_rightSubTree;
+            stack[++index] = node.m_leftSubTree;
+        }
+    }
+
+    // return result
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method computes a box, expressed in the local coordinates of the
+    object, that encloses all collisions reported by this detector. Since the
+    boxes of the tree already include the radius passed to initialize(), the
+    box of the root node is returned. If the tree is empty, an empty box
+    is returned, whose minimum is larger than its maximum.
+
+    \param  a_boxMin  Returned minimum point of the box.
+    \param  a_boxMax  Returned maximum point of the box.
+
+    \return __true__ since the tree always bounds its elements.
+*/
+//==============================================================================
+bool cCollisionAABB::computeBoundaryBox(cVector3d& a_boxMin,
+                                        cVector3d& a_boxMax)
+{
+    // empty tree
+    if (m_rootIndex == -1)
+    {
+        a_boxMin.set( C_LARGE, C_LARGE, C_LARGE);
+        a_boxMax.set(-C_LARGE,-C_LARGE,-C_LARGE);
+        return (true);
+    }
+
+    // box of root node
+    const cCollisionAABBBox& bbox = m_nodes[m_rootIndex].m_bbox;
+    a_boxMin.set(bbox.getLowerX(), bbox.getLowerY(), bbox.getLowerZ());
+    a_boxMax.set(bbox.getUpperX(), bbox.getUpperY(), bbox.getUpperZ());
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method appends to a list the leaves of the collision tree whose boxes
+    intersect a box, together with their boxes. Leaves are appended in the
+    depth-first order in which computeCollision() visits them, so that
+    collisions found at equal distances are resolved identically.
+
+    \param  a_boxMin        Minimum point of the box, in local coordinates.
+    \param  a_boxMax        Maximum point of the box, in local coordinates.
+    \param  a_elements      List receiving the indices of the elements.
+    \param  a_elementBoxes  List receiving the boxes of the elements.
+
+    \return __true__ since the tree can always select its elements.
+*/
+//==============================================================================
+bool cCollisionAABB::computeElementsInBox(const cVector3d& a_boxMin,
+                                          const cVector3d& a_boxMax,
+                                          std::vector<int>& a_elements,
+                                          std::vector<cCollisionAABBBox>& a_elementBoxes)
+{
+    // empty tree
+    if (m_rootIndex == -1) { return (true); }
+
+    cCollisionAABBBox box;
+    box.setValue(a_boxMin, a_boxMax);
+
+    // traverse tree, left children first
+    std::vector<int> stack;
+    stack.reserve(m_maxDepth+1);
+    stack.push_back(m_rootIndex);
+    while (!stack.empty())
+    {
+        int nodeIndex = stack.back();
+        stack.pop_back();
+
+        const cCollisionAABBNode& node = m_nodes[nodeIndex];
+        if (!node.m_bbox.intersect(box)) { continue; }
+
+        if (node.m_nodeType == C_AABB_NODE_LEAF)
+        {
+            a_elements.push_back(node.m_leftSubTree);
+            a_elementBoxes.push_back(node.m_bbox);
+        }
+        else
+        {
+            stack.push_back(node.m_rightSubTree);
+            stack.push_back(node.m_leftSubTree);
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method computes all collisions between a segment and a list of
+    elements previously selected by computeElementsInBox(). Elements whose
+    boxes do not intersect the segment are skipped.
+
+    \param  a_object         Pointer to the object on which collision detection is being performed.
+    \param  a_segmentPointA  Initial point of segment.
+    \param  a_segmentPointB  End point of segment.
+    \param  a_elements       Indices of the elements.
+    \param  a_elementBoxes   Boxes of the elements.
+    \param  a_recorder       Stores all collision events.
+    \param  a_settings       Contains collision settings information.
+
+    \return __true__ if a collision has occurred, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionAABB::computeCollisionWithElements(cGenericObject* a_object,
+                                                  cVector3d& a_segmentPointA,
+                                                  cVector3d& a_segmentPointB,
+                                                  const std::vector<int>& a_elements,
+                                                  const std::vector<cCollisionAABBBox>& a_elementBoxes,
+                                                  cCollisionRecorder& a_recorder,
+                                                  cCollisionSettings& a_settings)
+{
+    bool result = false;
+
+    // create an axis-aligned boundary box for the line
+    cCollisionAABBBox lineBox;
+    lineBox.setEmpty();
+    lineBox.enclose(a_segmentPointA);
+    lineBox.enclose(a_segmentPointB);
+
+    int numElements = (int)(a_elements.size());
+    for (int i=0; i<numElements; i++)
+    {
+        const cCollisionAABBBox& bbox = a_elementBoxes[i];
+        if (!bbox.intersect(lineBox)) { continue; }
+        if (!bbox.intersect(a_segmentPointA, a_segmentPointB)) { continue; }
+
+        int elementIndex = a_elements[i];
+        if (m_elements->m_allocated[elementIndex])
+        {
+            if (m_elements->computeCollision(elementIndex,
+                a_object,
+                a_segmentPointA,
+                a_segmentPointB,
+                a_recorder,
+                a_settings))
+            {
+                result = true;
+            }
+        }
+    }
+
+    return (result);
+}
+
+
 //==============================================================================
 /*!
     This method graphically renders the boundary boxes of the collision tree 
@@ -58,6 +58,14 @@
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+//! Maximum number of nodes held by the fixed-size traversal stack of the packed AABB tree.
+const int C_AABB_PACKED_STACK_SIZE = 128;
+
+//! Default ratio between the current and initial SAH cost above which \ref cCollisionAABB::refit() rebuilds the tree.
+const double C_AABB_DEFAULT_REBUILD_THRESHOLD = 1.5;
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     \file       CCollisionAABB.h
@@ -78,7 +86,29 @@ namespace chai3d {
     \details
     This class implements an axis-aligned bounding box collision detection
     tree to efficiently detect for any collision between a line segment and 
-    a collection of elements (point, segment, triangle) that compose an object.
+    a collection of elements (point, segment, triangle) that compose an object.\n\n
+
+    Once built, the tree is also stored in a packed form (see
+    \ref cCollisionAABBPackedNode) which is traversed using a fixed-size stack
+    allocated on the calling thread. This mode avoids any memory allocation
+    during collision queries and is enabled by default. It can be disabled by
+    calling \ref setUsePackedTree() to revert to the original traversal.\n\n
+
+    When the elements are triangles, subtrees of the packed tree holding at 
+    most \ref C_AABB_BUCKET_SIZE triangles are stored as buckets (see
+    \ref cCollisionAABBTriangleBucket) whose triangles are culled together
+    using SSE or AVX instructions when available. Buckets can be disabled by
+    calling \ref setUseTriangleBuckets().\n\n
+
+    \ref update() rebuilds the tree from scratch. When vertices are only 
+    displaced, \ref refit() can be called instead: only the leaves whose 
+    vertices have been reported as modified by the vertex array (see 
+    \ref cVertexArray::markPositionModified()) and their ancestors are 
+    updated. The structure of the tree is kept until its surface area 
+    heuristic cost exceeds the cost measured after the last build by the
+    ratio set with \ref setRebuildThreshold(), or until the connectivity of
+    the elements changes (see \ref cGenericArray::getTopologyVersion()), at
+    which point the tree is rebuilt.
 */
 //==============================================================================
 class cCollisionAABB : public cGenericCollision
@@ -119,6 +149,12 @@ public:
     //! This methods updates the collision detector and should be called if the 3D model it represents is modified.
     virtual void update();
 
+    //! This method rebuilds the collision tree from scratch.
+    void rebuild();
+
+    //! This method updates the bounding boxes of the collision tree after vertices have been displaced, rebuilding the tree only when needed.
+    void refit();
+
     //! This method computes all collisions between a segment passed as argument and the attributed 3D object.
     virtual bool computeCollision(cGenericObject* a_object,
                                   cVector3d& a_segmentPointA,
@@ -126,12 +162,90 @@ public:
                                   cCollisionRecorder& a_recorder,
                                   cCollisionSettings& a_settings);
 
+    //! This method computes a box, in local coordinates, enclosing all collisions reported by this detector.
+    virtual bool computeBoundaryBox(cVector3d& a_boxMin,
+                                    cVector3d& a_boxMax);
+
+    //! This method appends the elements whose boxes, in local coordinates, intersect a box.
+    virtual bool computeElementsInBox(const cVector3d& a_boxMin,
+                                      const cVector3d& a_boxMax,
+                                      std::vector<int>& a_elements,
+                                      std::vector<cCollisionAABBBox>& a_elementBoxes);
+
+    //! This method computes all collisions between a segment and a list of elements selected by computeElementsInBox().
+    virtual bool computeCollisionWithElements(cGenericObject* a_object,
+                                              cVector3d& a_segmentPointA,
+                                              cVector3d& a_segmentPointB,
+                                              const std::vector<int>& a_elements,
+                                              const std::vector<cCollisionAABBBox>& a_elementBoxes,
+                                              cCollisionRecorder& a_recorder,
+                                              cCollisionSettings& a_settings);
+
     //! This method renders a visual representation of the collision tree.
     virtual void render(cRenderOptions& a_options);
 
     //! This method initializes and builds the AABB collision tree.
     void initialize(const cGenericArrayPtr a_elements,
-                    const double a_radius = 0.0);
+                    const double a_radius = 0.0,
+                    const cAABBBuildMethod a_buildMethod = C_AABB_BUILD_CENTER);
+
+    //! This method initializes the AABB collision tree from a list of nodes produced by a previous build.
+    bool initialize(const cGenericArrayPtr a_elements,
+                    const double a_radius,
+                    const cAABBBuildMethod a_buildMethod,
+                    std::vector<cCollisionAABBNode>& a_nodes,
+                    const int a_rootIndex);
+
+    //! This method returns the list of nodes of the collision tree.
+    const std::vector<cCollisionAABBNode>& getNodes() const { return (m_nodes); }
+
+    //! This method returns the index number of the root node, or -1 if the tree is empty.
+    int getRootIndex() const { return (m_rootIndex); }
+
+    //! This method returns the collision shell radius around elements.
+    double getRadius() const { return (m_radius); }
+
+    //! This method returns the method used to build the collision tree.
+    cAABBBuildMethod getBuildMethod() const { return (m_buildMethod); }
+
+    //! This method computes statistics that describe the quality of the collision tree.
+    cCollisionAABBStatistics computeStatistics() const;
+
+    //! This method enables or disables the traversal of the packed collision tree.
+    void setUsePackedTree(const bool a_usePackedTree) { m_usePackedTree = a_usePackedTree; }
+
+    //! This method returns __true__ if the packed collision tree is used for collision queries.
+    bool getUsePackedTree() const { return (m_usePackedTree); }
+
+    //! This method enables or disables the storage of triangles in buckets in the packed collision tree.
+    void setUseTriangleBuckets(const bool a_useTriangleBuckets);
+
+    //! This method returns __true__ if triangles are stored in buckets in the packed collision tree.
+    bool getUseTriangleBuckets() const { return (m_useTriangleBuckets); }
+
+    //! This method returns the number of triangle buckets in the packed collision tree.
+    int getNumTriangleBuckets() const { return ((int)(m_buckets.size())); }
+
+    //! This method returns the number of nodes in the collision tree.
+    int getNumNodes() const { return ((int)(m_nodes.size())); }
+
+    //! This method returns the maximum depth of the collision tree.
+    int getMaxDepth() const { return (m_maxDepth); }
+
+    //! This method sets the ratio between the current and initial SAH cost above which \ref refit() rebuilds the tree. A value of 1.0 or less always rebuilds the tree.
+    void setRebuildThreshold(const double a_rebuildThreshold) { m_rebuildThreshold = a_rebuildThreshold; }
+
+    //! This method returns the ratio between the current and initial SAH cost above which \ref refit() rebuilds the tree.
+    double getRebuildThreshold() const { return (m_rebuildThreshold); }
+
+    //! This method returns the ratio between the current SAH cost of the tree and its cost after the last build.
+    double getQualityRatio() const;
+
+    //! This method returns the number of times the tree has been refitted.
+    int getNumRefits() const { return (m_numRefits); }
+
+    //! This method returns the number of times the tree has been rebuilt by \ref update(), \ref refit() or \ref rebuild().
+    int getNumRebuilds() const { return (m_numRebuilds); }
 
 
     //--------------------------------------------------------------------------
@@ -143,6 +257,62 @@ protected:
     // This method is used to recursively build the collision tree.
     int buildTree(const int a_indexFirstNode, const int a_indexLastNode, const int a_depth);
 
+    //! This method is used to recursively build the collision tree using the surface area heuristic.
+    int buildTreeSAH(const int a_indexFirstNode,
+                     const int a_indexLastNode,
+                     const int a_depth,
+                     const int a_spawnDepth,
+                     std::vector<cCollisionAABBNode>& a_nodes,
+                     int& a_maxDepth);
+
+    //! This method returns the index of the last leaf of the left subtree of the SAH split.
+    int splitSAH(const int a_indexFirstNode,
+                 const int a_indexLastNode,
+                 const cCollisionAABBBox& a_bbox);
+
+    //! Thread function used to build subtrees in parallel.
+    static void buildTreeSAHThread(void* a_task);
+
+    //! This method builds the packed collision tree from the list of nodes.
+    void buildPackedTree();
+
+    //! This method recursively copies a node and its children to the packed collision tree.
+    int buildPackedNode(const int a_nodeIndex, const std::vector<int>& a_numLeaves);
+
+    //! This method recursively counts the number of leaves below each node.
+    int countLeaves(const int a_nodeIndex, std::vector<int>& a_numLeaves);
+
+    //! This method recursively adds the leaves of a subtree to a triangle bucket.
+    void addBucketLeaves(const int a_nodeIndex, const int a_bucketIndex);
+
+    //! This method updates the bounding box and planes of a triangle stored in a bucket.
+    void updateBucketSlot(const int a_nodeIndex);
+
+    //! This method builds the list of parent nodes and the sum of node areas used when refitting the tree.
+    void buildRefitData();
+
+    //! This method builds the list of leaves attached to each vertex.
+    void buildVertexLeaves();
+
+    //! This method recomputes the boundary box of a leaf and returns __true__ if it has changed.
+    bool refitLeaf(const int a_nodeIndex);
+
+    //! This method recomputes the boundary box of an internal node and returns __true__ if it has changed.
+    bool refitNode(const int a_nodeIndex);
+
+    //! This method recursively recomputes the boundary boxes of a node and its children.
+    void refitSubTree(const int a_nodeIndex);
+
+    //! This method assigns a new boundary box to a node.
+    void setNodeBox(const int a_nodeIndex, const cCollisionAABBBox& a_bbox);
+
+    //! This method computes all collisions by traversing the packed collision tree.
+    bool computeCollisionPacked(cGenericObject* a_object,
+                                cVector3d& a_segmentPointA,
+                                cVector3d& a_segmentPointB,
+                                cCollisionRecorder& a_recorder,
+                                cCollisionSettings& a_settings);
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -167,6 +337,60 @@ protected:
 
     //! Maximum depth of tree.
     int m_maxDepth;
+
+    //! List of nodes stored in depth-first order using a compact layout.
+    std::vector<cCollisionAABBPackedNode> m_packedNodes;
+
+    //! If __true__, collision queries traverse the packed collision tree.
+    bool m_usePackedTree;
+
+    //! List of triangle buckets of the packed collision tree.
+    std::vector<cCollisionAABBTriangleBucket> m_buckets;
+
+    //! For each node, index of its bucket slot (bucket index times \ref C_AABB_BUCKET_SIZE plus slot) or -1.
+    std::vector<int> m_bucketSlots;
+
+    //! If __true__, triangles are stored in buckets in the packed collision tree.
+    bool m_useTriangleBuckets;
+
+    //! Method used to build the collision tree.
+    cAABBBuildMethod m_buildMethod;
+
+    //! Number of vertices when the tree was built.
+    int m_numVertices;
+
+    //! Version of the vertex positions when the tree was last built or refitted.
+    unsigned long long m_positionVersion;
+
+    //! Topology version of the elements when the tree was built.
+    unsigned int m_topologyVersion;
+
+    //! For each node, index of its parent node or -1 for the root.
+    std::vector<int> m_parentNodes;
+
+    //! For each node, index of the corresponding node in the packed collision tree.
+    std::vector<int> m_packedNodeIndices;
+
+    //! For each vertex, offset of its first leaf in \ref m_vertexLeaves. Built on the first incremental refit.
+    std::vector<int> m_vertexLeafOffsets;
+
+    //! List of leaves attached to each vertex.
+    std::vector<int> m_vertexLeaves;
+
+    //! Sum of the surface areas of all nodes.
+    double m_sumArea;
+
+    //! SAH cost of the tree after the last build.
+    double m_buildCost;
+
+    //! Ratio between the current and initial SAH cost above which \ref refit() rebuilds the tree.
+    double m_rebuildThreshold;
+
+    //! Number of times the tree has been refitted.
+    int m_numRefits;
+
+    //! Number of times the tree has been rebuilt.
+    int m_numRebuilds;
 };
 
 //------------------------------------------------------------------------------
@@ -72,6 +72,24 @@ typedef enum
     C_AABB_NOT_DEFINED
 } cAABBNodeType;
 
+//------------------------------------------------------------------------------
+//! Maximum number of triangles stored in a bucket of the packed AABB tree.
+const int C_AABB_BUCKET_SIZE = 8;
+
+//! Number of planes stored for each triangle of a bucket (supporting plane and three edge planes).
+const int C_AABB_BUCKET_NUM_PLANES = 4;
+
+//! Value of \ref cCollisionAABBPackedNode::m_rightSubTree for a leaf holding a bucket of triangles.
+const int C_AABB_PACKED_BUCKET = -2;
+
+//------------------------------------------------------------------------------
+//! AABB tree build methods.
+typedef enum
+{
+    C_AABB_BUILD_CENTER,        // split at the center of the longest axis
+    C_AABB_BUILD_SAH            // binned surface area heuristic, built in parallel
+} cAABBBuildMethod;
+
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -154,6 +172,145 @@ public:
 };
 
 
+//==============================================================================
+/*!
+    \class      cCollisionAABBPackedNode
+    \ingroup    collisions
+
+    \brief
+    This structure implements a compact tree node inside an AABB collision tree.
+
+    \details
+    This structure stores a node of the AABB collision tree in 32 bytes so that
+    two nodes fit into a single cache line. Bounds are stored in single
+    precision and are rounded outwards so that the box always encloses the
+    original double precision box. Nodes are stored in depth-first order,
+    which places the left child of an internal node immediately after its
+    parent. \n\n
+
+    For internal nodes, \ref m_leftSubTree and \ref m_rightSubTree contain the
+    indices of the child nodes. For leaf nodes, \ref m_leftSubTree contains the
+    index of the element and \ref m_rightSubTree is set to -1. For leaf nodes 
+    holding a bucket of triangles (see \ref cCollisionAABBTriangleBucket), 
+    \ref m_leftSubTree contains the index of the bucket and 
+    \ref m_rightSubTree is set to \ref C_AABB_PACKED_BUCKET.
+*/
+//==============================================================================
+struct cCollisionAABBPackedNode
+{
+    //! Lower corner of the bounding box.
+    float m_min[3];
+
+    //! Upper corner of the bounding box.
+    float m_max[3];
+
+    //! Left child node index (internal node) or element index (leaf node).
+    int m_leftSubTree;
+
+    //! Right child node index (internal node) or -1 (leaf node).
+    int m_rightSubTree;
+
+    //! This method returns __true__ if this node is a leaf.
+    inline bool isLeaf() const { return (m_rightSubTree < 0); }
+
+    //! This method returns __true__ if this node is a leaf holding a bucket of triangles.
+    inline bool isBucket() const { return (m_rightSubTree == C_AABB_PACKED_BUCKET); }
+};
+
+
+//==============================================================================
+/*!
+    \class      cCollisionAABBTriangleBucket
+    \ingroup    collisions
+
+    \brief
+    This structure stores a small group of triangles of a packed AABB tree in
+    a structure-of-arrays layout.
+
+    \details
+    Subtrees of the packed AABB tree which contain at most 
+    \ref C_AABB_BUCKET_SIZE triangles are collapsed into a single bucket, so 
+    that a segment can be tested against all of its triangles at once using
+    SSE or AVX instructions. \n\n
+
+    For each triangle, the bucket stores the bounding box of its leaf node,
+    and four planes expressed relative to \ref m_origin: the supporting plane 
+    of the triangle, and the plane going through each edge, perpendicular to
+    the triangle and pointing outwards. A segment whose end points both lie 
+    further than the collision radius outside one of these planes cannot 
+    collide with the triangle. These tests are only used to reject triangles;
+    remaining triangles are tested by \ref cTriangleArray::computeCollision(),
+    so that no collision reported by the original tree is missed. \n\n
+
+    Unused slots have an empty bounding box.
+*/
+//==============================================================================
+struct cCollisionAABBTriangleBucket
+{
+    //! Lower corner of the bounding box of each triangle, per axis.
+    float m_min[3][C_AABB_BUCKET_SIZE];
+
+    //! Upper corner of the bounding box of each triangle, per axis.
+    float m_max[3][C_AABB_BUCKET_SIZE];
+
+    //! Planes of each triangle (normal X, Y, Z and offset), relative to \ref m_origin.
+    float m_planes[C_AABB_BUCKET_NUM_PLANES][4][C_AABB_BUCKET_SIZE];
+
+    //! Index of the element stored in each slot.
+    int m_elementIndices[C_AABB_BUCKET_SIZE];
+
+    //! Number of triangles stored in this bucket.
+    int m_numElements;
+
+    //! Origin of the coordinates used to express the planes.
+    double m_origin[3];
+
+    //! Largest distance along any axis between the origin and the vertices of the triangles.
+    double m_extent;
+};
+
+
+//==============================================================================
+/*!
+    \struct     cCollisionAABBStatistics
+    \ingroup    collisions
+
+    \brief
+    This structure reports the quality of an AABB collision tree.
+
+    \details
+    The surface area heuristic (SAH) cost estimates the expected cost of a
+    collision query by weighting each node by the probability that a random
+    segment crossing the root box also crosses the node box. Traversal and
+    element tests are both given a unit cost. Lower values indicate a better
+    tree.
+*/
+//==============================================================================
+struct cCollisionAABBStatistics
+{
+    //! Surface area heuristic cost of the tree.
+    double m_sahCost;
+
+    //! Number of nodes (internal and leaf).
+    int m_numNodes;
+
+    //! Number of leaf nodes.
+    int m_numLeaves;
+
+    //! Maximum depth of the tree.
+    int m_maxDepth;
+
+    //! Average depth of the leaf nodes.
+    double m_averageLeafDepth;
+
+    //! Average number of elements per leaf node.
+    double m_averageLeafSize;
+
+    //! Maximum number of elements per leaf node.
+    int m_maxLeafSize;
+};
+
+
 //------------------------------------------------------------------------------
 }   // namespace chai3d
 //------------------------------------------------------------------------------
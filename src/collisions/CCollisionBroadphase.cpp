@@ -0,0 +1,593 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "collisions/CCollisionBroadphase.h"
+//------------------------------------------------------------------------------
+#include "collisions/CCollisionAABBBox.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// HELPER FUNCTIONS:
+//------------------------------------------------------------------------------
+
+//! Returns the surface area of a box.
+static inline double cBroadphaseArea(const cVector3d& a_boxMin, const cVector3d& a_boxMax)
+{
+    double dx = a_boxMax(0) - a_boxMin(0);
+    double dy = a_boxMax(1) - a_boxMin(1);
+    double dz = a_boxMax(2) - a_boxMin(2);
+    return (2.0 * (dx * dy + dy * dz + dz * dx));
+}
+
+//! Returns the surface area of the box enclosing two boxes.
+static inline double cBroadphaseArea(const cVector3d& a_boxMinA, const cVector3d& a_boxMaxA,
+                                     const cVector3d& a_boxMinB, const cVector3d& a_boxMaxB)
+{
+    double dx = cMax(a_boxMaxA(0), a_boxMaxB(0)) - cMin(a_boxMinA(0), a_boxMinB(0));
+    double dy = cMax(a_boxMaxA(1), a_boxMaxB(1)) - cMin(a_boxMinA(1), a_boxMinB(1));
+    double dz = cMax(a_boxMaxA(2), a_boxMaxB(2)) - cMin(a_boxMinA(2), a_boxMinB(2));
+    return (2.0 * (dx * dy + dy * dz + dz * dx));
+}
+
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cCollisionBroadphase.
+*/
+//==============================================================================
+cCollisionBroadphase::cCollisionBroadphase()
+{
+    m_rootIndex = -1;
+    m_freeIndex = -1;
+    m_numProxies = 0;
+    m_numReinsertions = 0;
+    m_margin = C_BROADPHASE_DEFAULT_MARGIN;
+}
+
+
+//==============================================================================
+/*!
+    This method creates a proxy for a box and inserts it in the tree. The
+    identifier returned remains valid until the proxy is destroyed.
+
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+    \param  a_data    User data returned by queries.
+
+    \return Identifier of the proxy.
+*/
+//==============================================================================
+int cCollisionBroadphase::createProxy(const cVector3d& a_boxMin,
+                                      const cVector3d& a_boxMax,
+                                      const int a_data)
+{
+    int leaf = allocateNode();
+    m_nodes[leaf].m_data = a_data;
+    m_nodes[leaf].m_height = 0;
+    setLeafBox(leaf, a_boxMin, a_boxMax);
+    insertLeaf(leaf);
+    m_numProxies++;
+
+    return (leaf);
+}
+
+
+//==============================================================================
+/*!
+    This method removes a proxy from the tree.
+
+    \param  a_proxy  Identifier of the proxy.
+*/
+//==============================================================================
+void cCollisionBroadphase::destroyProxy(const int a_proxy)
+{
+    removeLeaf(a_proxy);
+    freeNode(a_proxy);
+    m_numProxies--;
+}
+
+
+//==============================================================================
+/*!
+    This method updates the box of a proxy. The proxy is reinserted in the
+    tree if the new box is not contained in the box stored by its leaf, or if
+    the stored box has become much larger than the new box. Otherwise, the
+    tree is left unchanged.
+
+    \param  a_proxy   Identifier of the proxy.
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+
+    \return __true__ if the proxy has been reinserted, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionBroadphase::moveProxy(const int a_proxy,
+                                     const cVector3d& a_boxMin,
+                                     const cVector3d& a_boxMax)
+{
+    const cCollisionBroadphaseNode& leaf = m_nodes[a_proxy];
+
+    // compute largest margin that is tolerated before refreshing the box
+    double size = cMax(a_boxMax(0) - a_boxMin(0), cMax(a_boxMax(1) - a_boxMin(1), a_boxMax(2) - a_boxMin(2)));
+    double margin = 4.0 * m_margin * size;
+
+    // keep leaf if its box still encloses the new box tightly enough
+    bool keep = true;
+    for (int i=0; i<3; i++)
+    {
+        if ((a_boxMin(i) < leaf.m_boxMin(i)) || (a_boxMax(i) > leaf.m_boxMax(i)) ||
+            (a_boxMin(i) - leaf.m_boxMin(i) > margin) || (leaf.m_boxMax(i) - a_boxMax(i) > margin))
+        {
+            keep = false;
+        }
+    }
+
+    if (keep) { return (false); }
+
+    // reinsert leaf
+    removeLeaf(a_proxy);
+    setLeafBox(a_proxy, a_boxMin, a_boxMax);
+    insertLeaf(a_proxy);
+    m_numReinsertions++;
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method destroys all proxies and releases the tree.
+*/
+//==============================================================================
+void cCollisionBroadphase::clear()
+{
+    m_nodes.clear();
+    m_rootIndex = -1;
+    m_freeIndex = -1;
+    m_numProxies = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method appends to a list the user data of all proxies whose box,
+    enlarged by a radius, is crossed by the line supporting a segment within
+    the box enclosing the segment. The test is conservative: proxies that do
+    not intersect the segment may be reported, but none that does is missed.
+
+    \param  a_segmentPointA  Start point of segment.
+    \param  a_segmentPointB  End point of segment.
+    \param  a_radius         Radius by which the boxes are enlarged.
+    \param  a_data           List to which the user data of the proxies is appended.
+*/
+//==============================================================================
+void cCollisionBroadphase::computeSegmentOverlaps(const cVector3d& a_segmentPointA,
+                                                  const cVector3d& a_segmentPointB,
+                                                  const double a_radius,
+                                                  std::vector<int>& a_data) const
+{
+    // sanity check
+    if (m_rootIndex == -1) { return; }
+
+    // compute box of segment, enlarged by the radius
+    double radius = cMax(0.0, a_radius);
+    cVector3d lineMin, lineMax;
+    for (int i=0; i<3; i++)
+    {
+        lineMin(i) = cMin(a_segmentPointA(i), a_segmentPointB(i)) - radius;
+        lineMax(i) = cMax(a_segmentPointA(i), a_segmentPointB(i)) + radius;
+    }
+    cVector3d padding(radius, radius, radius);
+
+    // init stack
+    std::vector<int> stack;
+    stack.reserve(2 * m_nodes[m_rootIndex].m_height + 2);
+    stack.push_back(m_rootIndex);
+
+    // traverse tree
+    while (stack.size() > 0)
+    {
+        int index = stack.back();
+        stack.pop_back();
+
+        const cCollisionBroadphaseNode& node = m_nodes[index];
+
+        // check if box of segment intersects box of node
+        if ((lineMin(0) > node.m_boxMax(0)) || (lineMax(0) < node.m_boxMin(0)) ||
+            (lineMin(1) > node.m_boxMax(1)) || (lineMax(1) < node.m_boxMin(1)) ||
+            (lineMin(2) > node.m_boxMax(2)) || (lineMax(2) < node.m_boxMin(2)))
+        {
+            continue;
+        }
+
+        if (node.m_height == 0)
+        {
+            // check if segment intersects enlarged box of leaf
+            cCollisionAABBBox box(node.m_boxMin - padding, node.m_boxMax + padding);
+            if (box.intersect(a_segmentPointA, a_segmentPointB))
+            {
+                a_data.push_back(node.m_data);
+            }
+        }
+        else
+        {
+            stack.push_back(node.m_left);
+            stack.push_back(node.m_right);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method allocates a node, reusing a free node if available.
+
+    \return Index of the node.
+*/
+//==============================================================================
+int cCollisionBroadphase::allocateNode()
+{
+    int index;
+    if (m_freeIndex != -1)
+    {
+        index = m_freeIndex;
+        m_freeIndex = m_nodes[index].m_parent;
+    }
+    else
+    {
+        index = (int)(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + 1);
+    }
+
+    cCollisionBroadphaseNode& node = m_nodes[index];
+    node.m_parent = -1;
+    node.m_left = -1;
+    node.m_right = -1;
+    node.m_height = 0;
+    node.m_data = -1;
+
+    return (index);
+}
+
+
+//==============================================================================
+/*!
+    This method returns a node to the list of free nodes.
+
+    \param  a_node  Index of the node.
+*/
+//==============================================================================
+void cCollisionBroadphase::freeNode(const int a_node)
+{
+    m_nodes[a_node].m_parent = m_freeIndex;
+    m_nodes[a_node].m_height = -1;
+    m_freeIndex = a_node;
+}
+
+
+//==============================================================================
+/*!
+    This method sets the box of a leaf to a box enlarged by the margin.
+
+    \param  a_leaf    Index of the leaf.
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+*/
+//==============================================================================
+void cCollisionBroadphase::setLeafBox(const int a_leaf,
+                                      const cVector3d& a_boxMin,
+                                      const cVector3d& a_boxMax)
+{
+    double size = cMax(a_boxMax(0) - a_boxMin(0), cMax(a_boxMax(1) - a_boxMin(1), a_boxMax(2) - a_boxMin(2)));
+    double margin = m_margin * size;
+
+    m_nodes[a_leaf].m_boxMin = a_boxMin - cVector3d(margin, margin, margin);
+    m_nodes[a_leaf].m_boxMax = a_boxMax + cVector3d(margin, margin, margin);
+}
+
+
+//==============================================================================
+/*!
+    This method inserts a leaf in the tree. The leaf becomes the sibling of
+    the node that minimizes the increase of surface area of the tree.
+
+    \param  a_leaf  Index of the leaf.
+*/
+//==============================================================================
+void cCollisionBroadphase::insertLeaf(const int a_leaf)
+{
+    // empty tree
+    if (m_rootIndex == -1)
+    {
+        m_rootIndex = a_leaf;
+        m_nodes[a_leaf].m_parent = -1;
+        return;
+    }
+
+    cVector3d leafMin = m_nodes[a_leaf].m_boxMin;
+    cVector3d leafMax = m_nodes[a_leaf].m_boxMax;
+
+    // find best sibling
+    int index = m_rootIndex;
+    while (m_nodes[index].m_height > 0)
+    {
+        const cCollisionBroadphaseNode& node = m_nodes[index];
+        const cCollisionBroadphaseNode& left = m_nodes[node.m_left];
+        const cCollisionBroadphaseNode& right = m_nodes[node.m_right];
+
+        double area = cBroadphaseArea(node.m_boxMin, node.m_boxMax);
+        double combinedArea = cBroadphaseArea(node.m_boxMin, node.m_boxMax, leafMin, leafMax);
+
+        // cost of creating a new parent for this node and the leaf
+        double cost = 2.0 * combinedArea;
+
+        // minimum cost of pushing the leaf further down the tree
+        double inheritanceCost = 2.0 * (combinedArea - area);
+
+        // cost of descending into the left child
+        double costLeft = cBroadphaseArea(left.m_boxMin, left.m_boxMax, leafMin, leafMax) + inheritanceCost;
+        if (left.m_height > 0)
+        {
+            costLeft -= cBroadphaseArea(left.m_boxMin, left.m_boxMax);
+        }
+
+        // cost of descending into the right child
+        double costRight = cBroadphaseArea(right.m_boxMin, right.m_boxMax, leafMin, leafMax) + inheritanceCost;
+        if (right.m_height > 0)
+        {
+            costRight -= cBroadphaseArea(right.m_boxMin, right.m_boxMax);
+        }
+
+        // stop descending if creating a parent here is cheapest
+        if ((cost < costLeft) && (cost < costRight))
+        {
+            break;
+        }
+
+        index = (costLeft < costRight) ? node.m_left : node.m_right;
+    }
+
+    // create a new parent for the sibling and the leaf
+    int sibling = index;
+    int oldParent = m_nodes[sibling].m_parent;
+    int newParent = allocateNode();
+
+    m_nodes[newParent].m_parent = oldParent;
+    m_nodes[newParent].m_left = sibling;
+    m_nodes[newParent].m_right = a_leaf;
+    m_nodes[sibling].m_parent = newParent;
+    m_nodes[a_leaf].m_parent = newParent;
+    refitNode(newParent);
+
+    if (oldParent != -1)
+    {
+        if (m_nodes[oldParent].m_left == sibling)
+        {
+            m_nodes[oldParent].m_left = newParent;
+        }
+        else
+        {
+            m_nodes[oldParent].m_right = newParent;
+        }
+    }
+    else
+    {
+        m_rootIndex = newParent;
+    }
+
+    // update ancestors
+    refitAncestors(oldParent);
+}
+
+
+//==============================================================================
+/*!
+    This method removes a leaf from the tree. The parent of the leaf is
+    replaced by the sibling of the leaf and released.
+
+    \param  a_leaf  Index of the leaf.
+*/
+//==============================================================================
+void cCollisionBroadphase::removeLeaf(const int a_leaf)
+{
+    // leaf is the root
+    if (a_leaf == m_rootIndex)
+    {
+        m_rootIndex = -1;
+        return;
+    }
+
+    int parent = m_nodes[a_leaf].m_parent;
+    int grandParent = m_nodes[parent].m_parent;
+    int sibling = (m_nodes[parent].m_left == a_leaf) ? m_nodes[parent].m_right : m_nodes[parent].m_left;
+
+    // replace parent by sibling
+    if (grandParent != -1)
+    {
+        if (m_nodes[grandParent].m_left == parent)
+        {
+            m_nodes[grandParent].m_left = sibling;
+        }
+        else
+        {
+            m_nodes[grandParent].m_right = sibling;
+        }
+    }
+    else
+    {
+        m_rootIndex = sibling;
+    }
+
+    m_nodes[sibling].m_parent = grandParent;
+    freeNode(parent);
+
+    // update ancestors
+    refitAncestors(grandParent);
+}
+
+
+//==============================================================================
+/*!
+    This method climbs the tree from a node to the root, balancing every
+    node and recomputing its box and height.
+
+    \param  a_node  Index of the first node to update, or -1.
+*/
+//==============================================================================
+void cCollisionBroadphase::refitAncestors(const int a_node)
+{
+    int index = a_node;
+    while (index != -1)
+    {
+        index = balance(index);
+        refitNode(index);
+        index = m_nodes[index].m_parent;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method balances a node whose children heights differ by more than
+    one, by rotating the grandchild with the largest height in place of the
+    node. The boxes and heights of the rotated nodes are updated.
+
+    \param  a_node  Index of the node.
+
+    \return Index of the node that replaces \p a_node in the tree.
+*/
+//==============================================================================
+int cCollisionBroadphase::balance(const int a_node)
+{
+    int iA = a_node;
+    if (m_nodes[iA].m_height < 2) { return (iA); }
+
+    int iB = m_nodes[iA].m_left;
+    int iC = m_nodes[iA].m_right;
+    int difference = m_nodes[iC].m_height - m_nodes[iB].m_height;
+
+    // nothing to do
+    if ((difference <= 1) && (difference >= -1)) { return (iA); }
+
+    // select the child to rotate up (iU) and the child that stays below A (iS)
+    int iU = (difference > 1) ? iC : iB;
+    int iF = m_nodes[iU].m_left;
+    int iG = m_nodes[iU].m_right;
+
+    // U takes the place of A
+    int parent = m_nodes[iA].m_parent;
+    m_nodes[iU].m_parent = parent;
+    m_nodes[iA].m_parent = iU;
+    if (parent != -1)
+    {
+        if (m_nodes[parent].m_left == iA)
+        {
+            m_nodes[parent].m_left = iU;
+        }
+        else
+        {
+            m_nodes[parent].m_right = iU;
+        }
+    }
+    else
+    {
+        m_rootIndex = iU;
+    }
+
+    // the highest grandchild stays under U, the other one replaces U under A
+    int iHigh = (m_nodes[iF].m_height > m_nodes[iG].m_height) ? iF : iG;
+    int iLow = (iHigh == iF) ? iG : iF;
+
+    m_nodes[iU].m_left = iA;
+    m_nodes[iU].m_right = iHigh;
+    if (iU == iC)
+    {
+        m_nodes[iA].m_right = iLow;
+    }
+    else
+    {
+        m_nodes[iA].m_left = iLow;
+    }
+    m_nodes[iLow].m_parent = iA;
+
+    // update boxes and heights
+    refitNode(iA);
+    refitNode(iU);
+
+    return (iU);
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the box and height of an internal node from its
+    children.
+
+    \param  a_node  Index of the node.
+*/
+//==============================================================================
+void cCollisionBroadphase::refitNode(const int a_node)
+{
+    cCollisionBroadphaseNode& node = m_nodes[a_node];
+    const cCollisionBroadphaseNode& left = m_nodes[node.m_left];
+    const cCollisionBroadphaseNode& right = m_nodes[node.m_right];
+
+    for (int i=0; i<3; i++)
+    {
+        node.m_boxMin(i) = cMin(left.m_boxMin(i), right.m_boxMin(i));
+        node.m_boxMax(i) = cMax(left.m_boxMax(i), right.m_boxMax(i));
+    }
+
+    node.m_height = 1 + cMax(left.m_height, right.m_height);
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,261 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CCollisionBroadphaseH
+#define CCollisionBroadphaseH
+//------------------------------------------------------------------------------
+#include "math/CMaths.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CCollisionBroadphase.h
+    \ingroup    collisions
+
+    \brief
+    Implements a dynamic bounding volume hierarchy over moving boxes.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Default ratio between the margin added around each proxy box and the largest dimension of the box.
+const double C_BROADPHASE_DEFAULT_MARGIN = 0.1;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \struct     cCollisionBroadphaseNode
+    \ingroup    collisions
+
+    \brief
+    This structure stores a node of a broadphase tree.
+*/
+//==============================================================================
+struct cCollisionBroadphaseNode
+{
+    //! Minimum point of the box of the node. Boxes of leaves include a margin.
+    cVector3d m_boxMin;
+
+    //! Maximum point of the box of the node. Boxes of leaves include a margin.
+    cVector3d m_boxMax;
+
+    //! Index of the parent node, -1 for the root, or index of the next free node.
+    int m_parent;
+
+    //! Index of the left child, or -1 for leaves.
+    int m_left;
+
+    //! Index of the right child, or -1 for leaves.
+    int m_right;
+
+    //! Height of the node in the tree: 0 for leaves, -1 for free nodes.
+    int m_height;
+
+    //! User data stored by a leaf.
+    int m_data;
+};
+
+
+//==============================================================================
+/*!
+    \class      cCollisionBroadphase
+    \ingroup    collisions
+
+    \brief
+    This class implements a dynamic bounding volume hierarchy over moving boxes.
+
+    \details
+    cCollisionBroadphase stores a set of axis-aligned boxes, called proxies,
+    in a binary tree whose nodes bound their children. Each proxy carries an
+    integer passed by the caller, such as the index of an object, which is
+    returned by queries. \n
+
+    Proxies are inserted incrementally by descending the tree along the
+    branch that least increases the surface area of the nodes, and the tree
+    is kept balanced by rotations. When a proxy moves, it is only reinserted
+    if its new box is no longer contained in the box stored by its leaf.
+    Stored boxes are enlarged by a margin proportional to their size (see
+    setMargin()), so that objects undergoing small motions are not
+    reinserted at every update. \n
+
+    Queries return the proxies whose boxes, enlarged by a radius, are crossed
+    by a segment. Since leaves store enlarged boxes, queries may return
+    proxies that do not intersect the segment, but never miss one that does.
+    The class is not thread safe.
+*/
+//==============================================================================
+class cCollisionBroadphase
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cCollisionBroadphase.
+    cCollisionBroadphase();
+
+    //! Destructor of cCollisionBroadphase.
+    virtual ~cCollisionBroadphase() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method creates a proxy for a box and returns its identifier.
+    int createProxy(const cVector3d& a_boxMin,
+                    const cVector3d& a_boxMax,
+                    const int a_data);
+
+    //! This method destroys a proxy.
+    void destroyProxy(const int a_proxy);
+
+    //! This method updates the box of a proxy. Returns __true__ if the proxy has been reinserted in the tree.
+    bool moveProxy(const int a_proxy,
+                   const cVector3d& a_boxMin,
+                   const cVector3d& a_boxMax);
+
+    //! This method returns the user data of a proxy.
+    int getProxyData(const int a_proxy) const { return (m_nodes[a_proxy].m_data); }
+
+    //! This method destroys all proxies.
+    void clear();
+
+    //! This method appends to a list the user data of all proxies whose box, enlarged by a radius, is crossed by a segment.
+    void computeSegmentOverlaps(const cVector3d& a_segmentPointA,
+                                const cVector3d& a_segmentPointB,
+                                const double a_radius,
+                                std::vector<int>& a_data) const;
+
+    //! This method sets the ratio between the margin added around each proxy box and the largest dimension of the box.
+    void setMargin(const double a_margin) { m_margin = cMax(0.0, a_margin); }
+
+    //! This method returns the ratio between the margin added around each proxy box and the largest dimension of the box.
+    double getMargin() const { return (m_margin); }
+
+    //! This method returns the number of proxies.
+    int getNumProxies() const { return (m_numProxies); }
+
+    //! This method returns the height of the tree.
+    int getHeight() const { return ((m_rootIndex == -1) ? 0 : m_nodes[m_rootIndex].m_height); }
+
+    //! This method returns the number of times proxies have been reinserted by moveProxy().
+    int getNumReinsertions() const { return (m_numReinsertions); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method allocates a node.
+    int allocateNode();
+
+    //! This method returns a node to the list of free nodes.
+    void freeNode(const int a_node);
+
+    //! This method sets the box of a leaf to a box enlarged by the margin.
+    void setLeafBox(const int a_leaf,
+                    const cVector3d& a_boxMin,
+                    const cVector3d& a_boxMax);
+
+    //! This method inserts a leaf in the tree.
+    void insertLeaf(const int a_leaf);
+
+    //! This method removes a leaf from the tree.
+    void removeLeaf(const int a_leaf);
+
+    //! This method recomputes the boxes and heights of the ancestors of a node, balancing them on the way.
+    void refitAncestors(const int a_node);
+
+    //! This method performs a rotation if a node is unbalanced, and returns the index of the node replacing it.
+    int balance(const int a_node);
+
+    //! This method recomputes the box and height of an internal node from its children.
+    void refitNode(const int a_node);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Nodes of the tree.
+    std::vector<cCollisionBroadphaseNode> m_nodes;
+
+    //! Index of the root node, or -1 if the tree is empty.
+    int m_rootIndex;
+
+    //! Index of the first free node, or -1.
+    int m_freeIndex;
+
+    //! Number of proxies.
+    int m_numProxies;
+
+    //! Number of times proxies have been reinserted by moveProxy().
+    int m_numReinsertions;
+
+    //! Ratio between the margin added around each proxy box and the largest dimension of the box.
+    double m_margin;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
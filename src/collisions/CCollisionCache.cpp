@@ -0,0 +1,792 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+//------------------------------------------------------------------------------
+#include "collisions/CCollisionCache.h"
+//------------------------------------------------------------------------------
+#include "collisions/CGenericCollision.h"
+#include "world/CMultiMesh.h"
+#include "world/CWorld.h"
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// returns true if two boxes overlap
+static inline bool cCollisionCacheBoxesOverlap(const cVector3d& a_minA,
+                                               const cVector3d& a_maxA,
+                                               const cVector3d& a_minB,
+                                               const cVector3d& a_maxB)
+{
+    for (int i=0; i<3; i++)
+    {
+        if ((a_minA(i) > a_maxB(i)) || (a_maxA(i) < a_minB(i))) { return (false); }
+    }
+    return (true);
+}
+
+// returns true if an object reports collisions for the given settings
+static inline bool cCollisionCacheIsActive(const cGenericObject* a_object,
+                                           const cCollisionSettings& a_settings)
+{
+    return ((a_object->getEnabled()) &&
+            ((a_settings.m_checkVisibleObjects && a_object->getShowEnabled()) ||
+             (a_settings.m_checkHapticObjects && a_object->getHapticEnabled())));
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cCollisionCache.
+*/
+//==============================================================================
+cCollisionCache::cCollisionCache()
+{
+    m_world = NULL;
+    m_numWorldChildren = 0;
+    m_worldChildrenVersion = 0;
+    m_regionMin.zero();
+    m_regionMax.zero();
+    m_margin = 0.0;
+    resetStatistics();
+}
+
+
+//==============================================================================
+/*!
+    This method computes all collisions between a segment and the objects of
+    a world. If the segment, enlarged by the collision radius, lies within
+    the region of the cache, the cached elements are tested directly.
+    Otherwise the region is rebuilt around the segment first. Queries are
+    forwarded to the world if the motion of objects is adjusted. \n
+
+    Since the cache is built and queried by the same thread, the state of
+    every object of the world is checked with isWorldUnchanged() before the
+    cached elements are used.
+
+    \param  a_world          World in which collisions are computed.
+    \param  a_segmentPointA  Initial point of segment, in world coordinates.
+    \param  a_segmentPointB  End point of segment, in world coordinates.
+    \param  a_recorder       Recorder used to store all collisions.
+    \param  a_settings       Settings related to collision detection process.
+
+    \return __true__ if a collision has occurred, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionCache::computeCollisionDetection(cWorld* a_world,
+                                                const cVector3d& a_segmentPointA,
+                                                const cVector3d& a_segmentPointB,
+                                                cCollisionRecorder& a_recorder,
+                                                cCollisionSettings& a_settings)
+{
+    // segments adjusted by moving objects may leave the region
+    if (a_settings.m_adjustObjectMotion)
+    {
+        m_numCacheMisses++;
+        return (a_world->computeCollisionDetection(a_segmentPointA, a_segmentPointB, a_recorder, a_settings));
+    }
+
+    // discard the cached elements if the world has changed
+    if ((m_world != NULL) && !isWorldUnchanged(a_world, a_settings))
+    {
+        invalidate();
+    }
+
+    // answer from the cache if possible
+    bool hit = false;
+    if (computeCachedCollisionDetection(a_world, a_segmentPointA, a_segmentPointB, a_recorder, a_settings, hit))
+    {
+        m_numCacheHits++;
+        return (hit);
+    }
+
+    // rebuild the region around the segment
+    m_numCacheMisses++;
+    build(a_world, a_segmentPointA, a_segmentPointB, a_settings);
+    computeCachedCollisionDetection(a_world, a_segmentPointA, a_segmentPointB, a_recorder, a_settings, hit);
+
+    return (hit);
+}
+
+
+//==============================================================================
+/*!
+    This method computes all collisions between a segment and the cached
+    elements, provided the segment, enlarged by the collision radius, lies
+    within the region and the objects holding cached elements, and their
+    parents, are unchanged. The rest of the world is not visited, so that
+    the cost of the query does not depend on the size of the world: the
+    caller must check it with isWorldUnchanged(). The region is never
+    rebuilt, so that the cache may be built by another thread.
+
+    \param  a_world          World in which collisions are computed.
+    \param  a_segmentPointA  Initial point of segment, in world coordinates.
+    \param  a_segmentPointB  End point of segment, in world coordinates.
+    \param  a_recorder       Recorder used to store all collisions.
+    \param  a_settings       Settings related to collision detection process.
+    \param  a_hit            Set to __true__ if a collision has occurred.
+
+    \return __true__ if the query has been answered from the cache, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionCache::computeCachedCollisionDetection(cWorld* a_world,
+                                                      const cVector3d& a_segmentPointA,
+                                                      const cVector3d& a_segmentPointB,
+                                                      cCollisionRecorder& a_recorder,
+                                                      cCollisionSettings& a_settings,
+                                                      bool& a_hit)
+{
+    a_hit = false;
+
+    // segments adjusted by moving objects may leave the region
+    if ((m_world == NULL) || a_settings.m_adjustObjectMotion) { return (false); }
+
+    // check if the segment lies within the region
+    double radius = a_settings.m_collisionRadius;
+    for (int i=0; i<3; i++)
+    {
+        if (((cMin(a_segmentPointA(i), a_segmentPointB(i)) - radius) < m_regionMin(i)) ||
+            ((cMax(a_segmentPointA(i), a_segmentPointB(i)) + radius) > m_regionMax(i)))
+        {
+            return (false);
+        }
+    }
+
+    // check if cached objects are unchanged
+    if (!isValid(a_world, a_settings)) { return (false); }
+
+    // test cached elements
+    int numEntries = (int)(m_entries.size());
+    for (int i=0; i<numEntries; i++)
+    {
+        cCollisionCacheEntry& entry = m_entries[i];
+
+        // convert the segment into the local coordinates of the object, as
+        // cGenericObject::computeCollisionDetection() does at each level
+        cVector3d localSegmentPointA = a_segmentPointA;
+        cVector3d localSegmentPointB = a_segmentPointB;
+        int numLevels = (int)(entry.m_path.size());
+        for (int j=0; j<numLevels; j++)
+        {
+            cGenericObject* object = entry.m_path[j];
+
+            cMatrix3d transLocalRot;
+            object->m_localRot.transr(transLocalRot);
+
+            localSegmentPointA.sub(object->m_localPos);
+            transLocalRot.mul(localSegmentPointA);
+
+            localSegmentPointB.sub(object->m_localPos);
+            transLocalRot.mul(localSegmentPointB);
+        }
+
+        if (entry.m_testElements)
+        {
+            if (entry.m_collisionDetector->computeCollisionWithElements(entry.m_object,
+                                                                        localSegmentPointA,
+                                                                        localSegmentPointB,
+                                                                        entry.m_elements,
+                                                                        entry.m_elementBoxes,
+                                                                        a_recorder,
+                                                                        a_settings))
+            {
+                a_hit = true;
+            }
+        }
+        else if (entry.m_testCollisionDetector)
+        {
+            if (entry.m_collisionDetector->computeCollision(entry.m_object,
+                                                            localSegmentPointA,
+                                                            localSegmentPointB,
+                                                            a_recorder,
+                                                            a_settings))
+            {
+                a_hit = true;
+            }
+        }
+
+        if (entry.m_testOtherCollisions)
+        {
+            if (entry.m_object->computeOtherCollisionDetection(localSegmentPointA,
+                                                               localSegmentPointB,
+                                                               a_recorder,
+                                                               a_settings))
+            {
+                a_hit = true;
+            }
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method discards the cached elements, so that the region is rebuilt
+    by the next query.
+*/
+//==============================================================================
+void cCollisionCache::invalidate()
+{
+    m_world = NULL;
+    m_entries.clear();
+    m_objects.clear();
+    m_checkedObjects.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of elements currently cached.
+
+    \return Number of cached elements.
+*/
+//==============================================================================
+int cCollisionCache::getNumCachedElements() const
+{
+    int numElements = 0;
+    for (unsigned int i=0; i<m_entries.size(); i++)
+    {
+        numElements += (int)(m_entries[i].m_elements.size());
+    }
+    return (numElements);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the ratio of queries answered from the cached
+    elements without rebuilding the region.
+
+    \return Hit rate between 0.0 and 1.0.
+*/
+//==============================================================================
+double cCollisionCache::getHitRate() const
+{
+    unsigned int numQueries = m_numCacheHits + m_numCacheMisses;
+    if (numQueries == 0) { return (0.0); }
+
+    return ((double)(m_numCacheHits) / (double)(numQueries));
+}
+
+
+//==============================================================================
+/*!
+    This method resets the statistics of the cache.
+*/
+//==============================================================================
+void cCollisionCache::resetStatistics()
+{
+    m_numCacheHits = 0;
+    m_numCacheMisses = 0;
+    m_numRebuilds = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method builds the region around a segment, enlarged by the
+    collision radius and the margin, and caches the elements of all
+    collision detectors that may intersect it.
+
+    \param  a_world          World in which collisions are computed.
+    \param  a_segmentPointA  Initial point of segment, in world coordinates.
+    \param  a_segmentPointB  End point of segment, in world coordinates.
+    \param  a_settings       Settings related to collision detection process.
+*/
+//==============================================================================
+void cCollisionCache::build(cWorld* a_world,
+                            const cVector3d& a_segmentPointA,
+                            const cVector3d& a_segmentPointB,
+                            const cCollisionSettings& a_settings)
+{
+    m_numRebuilds++;
+
+    // compute region
+    double margin = (m_margin > 0.0) ? m_margin : 2.0 * a_settings.m_collisionRadius;
+    double size = a_settings.m_collisionRadius + margin;
+    for (int i=0; i<3; i++)
+    {
+        m_regionMin(i) = cMin(a_segmentPointA(i), a_segmentPointB(i)) - size;
+        m_regionMax(i) = cMax(a_segmentPointA(i), a_segmentPointB(i)) + size;
+    }
+
+    m_world = a_world;
+    m_numWorldChildren = (unsigned int)(a_world->getNumChildren());
+    m_worldChildrenVersion = a_world->getChildrenVersion();
+    m_regionSettings = a_settings;
+    m_entries.clear();
+    m_objects.clear();
+    m_checkedObjects.clear();
+
+    // cache the elements of the children of the world, which collision
+    // queries receive in world coordinates
+    vector<cGenericObject*> path;
+    cVector3d pos(0.0, 0.0, 0.0);
+    cMatrix3d rot;
+    rot.identity();
+    for (unsigned int i=0; i<m_numWorldChildren; i++)
+    {
+        buildObject(a_world->getChild(i), -1, pos, rot, path, a_settings);
+    }
+
+    // list objects holding cached elements and their parents, which are
+    // recorded after their parents
+    int numObjects = (int)(m_objects.size());
+    vector<bool> checked(numObjects, false);
+    for (int i=numObjects-1; i>=0; i--)
+    {
+        if (m_objects[i].m_cached || checked[i])
+        {
+            checked[i] = true;
+            if (m_objects[i].m_parent >= 0)
+            {
+                checked[m_objects[i].m_parent] = true;
+            }
+        }
+    }
+    for (int i=0; i<numObjects; i++)
+    {
+        if (checked[i])
+        {
+            m_checkedObjects.push_back(i);
+        }
+    }
+
+    // allocate the buffers used by isWorldUnchanged()
+    m_objectMoved.assign(numObjects, false);
+    m_objectPos.resize(numObjects);
+    m_objectRot.resize(numObjects);
+}
+
+
+//==============================================================================
+/*!
+    This method caches the elements of an object and of its descendants that
+    may intersect the region. The traversal follows the order of
+    cGenericObject::computeCollisionDetection(), so that cached elements are
+    tested in the same order as by a query on the world. The state of every
+    object visited is recorded so that isValid() and isWorldUnchanged() can
+    detect modifications.
+
+    \param  a_object     Object to cache.
+    \param  a_parent     Index of the state recorded for the parent of the object, or -1 for a child of the world.
+    \param  a_parentPos  Position of the parent of the object in world coordinates.
+    \param  a_parentRot  Rotation of the parent of the object in world coordinates.
+    \param  a_path       Objects from a child of the world down to the parent of the object.
+    \param  a_settings   Settings related to collision detection process.
+*/
+//==============================================================================
+void cCollisionCache::buildObject(cGenericObject* a_object,
+                                  const int a_parent,
+                                  const cVector3d& a_parentPos,
+                                  const cMatrix3d& a_parentRot,
+                                  vector<cGenericObject*>& a_path,
+                                  const cCollisionSettings& a_settings)
+{
+    // compute frame of object in world coordinates
+    cVector3d pos = a_parentPos + a_parentRot * a_object->m_localPos;
+    cMatrix3d rot = a_parentRot * a_object->m_localRot;
+
+    bool active = cCollisionCacheIsActive(a_object, a_settings);
+
+    // record state of object
+    cCollisionCacheObject state;
+    state.m_object = a_object;
+    state.m_multiMesh = dynamic_cast<cMultiMesh*>(a_object);
+    state.m_parent = a_parent;
+    state.m_cached = false;
+    state.m_ghost = a_object->m_ghostEnabled;
+    state.m_active = active;
+    state.m_localPos = a_object->m_localPos;
+    state.m_localRot = a_object->m_localRot;
+    state.m_globalPos = pos;
+    state.m_globalRot = rot;
+    state.m_boundaryBoxMin = a_object->getBoundaryMin();
+    state.m_boundaryBoxMax = a_object->getBoundaryMax();
+    state.m_collisionDetector = a_object->m_collisionDetector;
+    state.m_collisionDetectorVersion = (state.m_collisionDetector != NULL) ? state.m_collisionDetector->getVersion() : 0;
+    state.m_childrenVersion = a_object->getChildrenVersion();
+    state.m_numMeshes = (state.m_multiMesh != NULL) ? state.m_multiMesh->getNumMeshes() : 0;
+
+    int index = (int)(m_objects.size());
+    m_objects.push_back(state);
+
+    // ghost objects and their children never report collisions
+    if (a_object->m_ghostEnabled) { return; }
+
+    a_path.push_back(a_object);
+
+    // compute a box enclosing the region in the local coordinates of the object
+    cVector3d center = 0.5 * (m_regionMin + m_regionMax);
+    cVector3d extent = 0.5 * (m_regionMax - m_regionMin);
+    cVector3d localCenter = cTranspose(rot) * (center - pos);
+    cVector3d localMin, localMax;
+    for (int i=0; i<3; i++)
+    {
+        double size = fabs(rot(0,i)) * extent(0) +
+                      fabs(rot(1,i)) * extent(1) +
+                      fabs(rot(2,i)) * extent(2) + C_SMALL;
+
+        localMin(i) = localCenter(i) - size;
+        localMax(i) = localCenter(i) + size;
+    }
+
+    if (active)
+    {
+        cCollisionCacheEntry entry;
+        entry.m_object = a_object;
+        entry.m_collisionDetector = a_object->m_collisionDetector;
+        entry.m_testElements = false;
+        entry.m_testCollisionDetector = false;
+        entry.m_testOtherCollisions = false;
+
+        // select the elements of the collision detector located in the
+        // region, or test the entire detector if it may reach the region
+        if (entry.m_collisionDetector != NULL)
+        {
+            if (entry.m_collisionDetector->computeElementsInBox(localMin, localMax, entry.m_elements, entry.m_elementBoxes))
+            {
+                entry.m_testElements = !entry.m_elements.empty();
+            }
+            else
+            {
+                cVector3d boxMin, boxMax;
+                entry.m_testCollisionDetector = !entry.m_collisionDetector->computeBoundaryBox(boxMin, boxMax) ||
+                                                cCollisionCacheBoxesOverlap(boxMin, boxMax, localMin, localMax);
+            }
+        }
+
+        // test other collisions if they may reach the region
+        if (a_object->hasOtherCollisionDetection(a_settings))
+        {
+            cVector3d boxMin( C_LARGE, C_LARGE, C_LARGE);
+            cVector3d boxMax(-C_LARGE,-C_LARGE,-C_LARGE);
+            entry.m_testOtherCollisions = !a_object->computeOtherCollisionBoundaryBox(boxMin, boxMax) ||
+                                          cCollisionCacheBoxesOverlap(boxMin, boxMax, localMin, localMax);
+        }
+
+        if (entry.m_testElements || entry.m_testCollisionDetector || entry.m_testOtherCollisions)
+        {
+            entry.m_path = a_path;
+            m_entries.push_back(entry);
+            m_objects[index].m_cached = true;
+        }
+    }
+
+    // cache meshes of multi-meshes
+    cMultiMesh* multiMesh = m_objects[index].m_multiMesh;
+    if (multiMesh != NULL)
+    {
+        int numMeshes = multiMesh->getNumMeshes();
+        for (int i=0; i<numMeshes; i++)
+        {
+            buildObject(multiMesh->getMesh(i), index, pos, rot, a_path, a_settings);
+        }
+    }
+
+    // cache children
+    for (unsigned int i=0; i<a_object->m_children.size(); i++)
+    {
+        buildObject(a_object->m_children[i], index, pos, rot, a_path, a_settings);
+    }
+
+    a_path.pop_back();
+}
+
+
+//==============================================================================
+/*!
+    This method checks that the region was built for the same world and
+    settings, and that the objects holding cached elements and their
+    parents are unchanged. The cached elements are discarded if one of
+    these objects has moved, been disabled, had its collision detector or
+    boundary box modified, or had children added or removed. Only these
+    objects are visited, parents first, so that the cost of the check does
+    not depend on the size of the world. Other objects of the world are
+    checked by isWorldUnchanged().
+
+    \param  a_world     World in which collisions are computed.
+    \param  a_settings  Settings related to collision detection process.
+
+    \return __true__ if the cached elements can be used, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionCache::isValid(cWorld* a_world, const cCollisionSettings& a_settings) const
+{
+    if ((a_world != m_world) ||
+        (a_world->getNumChildren() != m_numWorldChildren) ||
+        (a_world->getChildrenVersion() != m_worldChildrenVersion) ||
+        (a_settings.m_checkVisibleObjects != m_regionSettings.m_checkVisibleObjects) ||
+        (a_settings.m_checkHapticObjects != m_regionSettings.m_checkHapticObjects) ||
+        (a_settings.m_ignoreShapes != m_regionSettings.m_ignoreShapes))
+    {
+        return (false);
+    }
+
+    int numCheckedObjects = (int)(m_checkedObjects.size());
+    for (int i=0; i<numCheckedObjects; i++)
+    {
+        const cCollisionCacheObject& state = m_objects[m_checkedObjects[i]];
+        cGenericObject* object = state.m_object;
+
+        // added or removed children may be located anywhere
+        if ((object->m_ghostEnabled != state.m_ghost) ||
+            (object->getChildrenVersion() != state.m_childrenVersion) ||
+            ((state.m_multiMesh != NULL) && (state.m_multiMesh->getNumMeshes() != state.m_numMeshes)))
+        {
+            return (false);
+        }
+
+        // cached elements are outdated if the object or one of its parents has moved or changed
+        cGenericCollision* collisionDetector = object->m_collisionDetector;
+        if (!object->m_localPos.equals(state.m_localPos) ||
+            !state.m_localRot.equals(object->m_localRot) ||
+            (cCollisionCacheIsActive(object, a_settings) != state.m_active) ||
+            (collisionDetector != state.m_collisionDetector) ||
+            ((collisionDetector != NULL) && (collisionDetector->getVersion() != state.m_collisionDetectorVersion)) ||
+            !object->getBoundaryMin().equals(state.m_boundaryBoxMin) ||
+            !object->getBoundaryMax().equals(state.m_boundaryBoxMax))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method checks that the region was built for the same world and
+    settings, and that no modification of the world since then affects the
+    cached elements. The state recorded for every object of the world is
+    visited, parents first, so that an object removed from the world is
+    never accessed: the list of children of its parent is checked before.
+    This method is therefore called by the thread that builds the cache,
+    rather than before each query. \n
+
+    The cached elements are discarded if an object has been added or
+    removed, if an object holding cached elements, or one of its parents,
+    has moved, been disabled, or had its collision detector or boundary box
+    modified, or if another object modified in the same way may now reach
+    the region.
+
+    \param  a_world     World in which collisions are computed.
+    \param  a_settings  Settings related to collision detection process.
+
+    \return __true__ if the cached elements can be used, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionCache::isWorldUnchanged(cWorld* a_world, const cCollisionSettings& a_settings)
+{
+    if (m_world == NULL) { return (false); }
+
+    if ((a_world != m_world) ||
+        (a_world->getNumChildren() != m_numWorldChildren) ||
+        (a_world->getChildrenVersion() != m_worldChildrenVersion) ||
+        (a_settings.m_checkVisibleObjects != m_regionSettings.m_checkVisibleObjects) ||
+        (a_settings.m_checkHapticObjects != m_regionSettings.m_checkHapticObjects) ||
+        (a_settings.m_ignoreShapes != m_regionSettings.m_ignoreShapes))
+    {
+        return (false);
+    }
+
+    int numObjects = (int)(m_objects.size());
+    for (int i=0; i<numObjects; i++)
+    {
+        const cCollisionCacheObject& state = m_objects[i];
+        cGenericObject* object = state.m_object;
+
+        // objects becoming ghosts or leaving that state are not tracked
+        if (object->m_ghostEnabled != state.m_ghost) { return (false); }
+
+        // children of ghost objects are not recorded
+        if (state.m_ghost)
+        {
+            m_objectMoved[i] = false;
+            continue;
+        }
+
+        // added or removed objects may be located anywhere
+        if ((object->getChildrenVersion() != state.m_childrenVersion) ||
+            ((state.m_multiMesh != NULL) && (state.m_multiMesh->getNumMeshes() != state.m_numMeshes)))
+        {
+            return (false);
+        }
+
+        // compute the frame of objects that have moved, or whose parent has moved
+        int parent = state.m_parent;
+        bool moved = ((parent >= 0) && m_objectMoved[parent]) ||
+                     !object->m_localPos.equals(state.m_localPos) ||
+                     !state.m_localRot.equals(object->m_localRot);
+        m_objectMoved[i] = moved;
+
+        if (moved)
+        {
+            if (parent < 0)
+            {
+                m_objectPos[i] = object->m_localPos;
+                m_objectRot[i] = object->m_localRot;
+            }
+            else
+            {
+                const cVector3d& parentPos = m_objectMoved[parent] ? m_objectPos[parent] : m_objects[parent].m_globalPos;
+                const cMatrix3d& parentRot = m_objectMoved[parent] ? m_objectRot[parent] : m_objects[parent].m_globalRot;
+                m_objectPos[i] = parentPos + parentRot * object->m_localPos;
+                m_objectRot[i] = parentRot * object->m_localRot;
+            }
+        }
+
+        // check if the collisions of the object may have changed
+        bool active = cCollisionCacheIsActive(object, a_settings);
+        cGenericCollision* collisionDetector = object->m_collisionDetector;
+        bool modified = (active != state.m_active) ||
+                        (collisionDetector != state.m_collisionDetector) ||
+                        ((collisionDetector != NULL) && (collisionDetector->getVersion() != state.m_collisionDetectorVersion)) ||
+                        !object->getBoundaryMin().equals(state.m_boundaryBoxMin) ||
+                        !object->getBoundaryMax().equals(state.m_boundaryBoxMax);
+
+        if (moved || modified)
+        {
+            // cached elements are outdated
+            if (state.m_cached) { return (false); }
+
+            // other objects are only relevant if they now reach the region
+            if (active &&
+                reachesRegion(object,
+                              moved ? m_objectPos[i] : state.m_globalPos,
+                              moved ? m_objectRot[i] : state.m_globalRot,
+                              a_settings))
+            {
+                return (false);
+            }
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method checks if the collisions reported by an object itself,
+    excluding its children, may reach the region when the object is located
+    at a given frame.
+
+    \param  a_object    Object to check.
+    \param  a_pos       Position of the object in world coordinates.
+    \param  a_rot       Rotation of the object in world coordinates.
+    \param  a_settings  Settings related to collision detection process.
+
+    \return __true__ if the object may report collisions in the region, __false__ otherwise.
+*/
+//==============================================================================
+bool cCollisionCache::reachesRegion(cGenericObject* a_object,
+                                    const cVector3d& a_pos,
+                                    const cMatrix3d& a_rot,
+                                    const cCollisionSettings& a_settings) const
+{
+    // compute box enclosing the collisions of the object in local coordinates
+    cVector3d boxMin( C_LARGE, C_LARGE, C_LARGE);
+    cVector3d boxMax(-C_LARGE,-C_LARGE,-C_LARGE);
+
+    if (a_object->m_collisionDetector != NULL)
+    {
+        cVector3d detectorMin, detectorMax;
+        if (!a_object->m_collisionDetector->computeBoundaryBox(detectorMin, detectorMax))
+        {
+            return (true);
+        }
+
+        for (int i=0; i<3; i++)
+        {
+            boxMin(i) = cMin(boxMin(i), detectorMin(i));
+            boxMax(i) = cMax(boxMax(i), detectorMax(i));
+        }
+    }
+
+    if (a_object->hasOtherCollisionDetection(a_settings) &&
+        !a_object->computeOtherCollisionBoundaryBox(boxMin, boxMax))
+    {
+        return (true);
+    }
+
+    // empty box
+    if ((boxMin(0) > boxMax(0)) || (boxMin(1) > boxMax(1)) || (boxMin(2) > boxMax(2)))
+    {
+        return (false);
+    }
+
+    // convert box into world coordinates
+    cVector3d center = a_pos + a_rot * (0.5 * (boxMin + boxMax));
+    cVector3d extent = 0.5 * (boxMax - boxMin);
+    cVector3d worldMin, worldMax;
+    for (int i=0; i<3; i++)
+    {
+        double size = fabs(a_rot(i,0)) * extent(0) +
+                      fabs(a_rot(i,1)) * extent(1) +
+                      fabs(a_rot(i,2)) * extent(2) + C_SMALL;
+
+        worldMin(i) = center(i) - size;
+        worldMax(i) = center(i) + size;
+    }
+
+    return (cCollisionCacheBoxesOverlap(worldMin, worldMax, m_regionMin, m_regionMax));
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
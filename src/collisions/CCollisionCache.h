@@ -0,0 +1,388 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+//------------------------------------------------------------------------------
+#ifndef CCollisionCacheH
+#define CCollisionCacheH
+//------------------------------------------------------------------------------
+#include "collisions/CCollisionBasics.h"
+#include "collisions/CCollisionAABBBox.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+class cGenericCollision;
+class cGenericObject;
+class cMultiMesh;
+class cWorld;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CCollisionCache.h
+    \ingroup    collisions
+
+    \brief
+    Implements a cache of the collision elements located around a moving query.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \struct     cCollisionCacheEntry
+    \ingroup    collisions
+
+    \brief
+    This structure stores the elements of a collision detector that are
+    located in the region of a collision cache.
+*/
+//==============================================================================
+struct cCollisionCacheEntry
+{
+    //! Object owning the collision detector.
+    cGenericObject* m_object;
+
+    //! Collision detector of __m_object__ when the cache was built.
+    cGenericCollision* m_collisionDetector;
+
+    //! If __true__, the elements listed in __m_elements__ are tested.
+    bool m_testElements;
+
+    //! If __true__, all elements of the collision detector are tested, since the detector cannot select elements.
+    bool m_testCollisionDetector;
+
+    //! If __true__, the collisions computed by cGenericObject::computeOtherCollisionDetection() are tested.
+    bool m_testOtherCollisions;
+
+    //! Objects whose frames convert a segment from world coordinates into the frame of __m_object__, from a child of the world down to __m_object__.
+    std::vector<cGenericObject*> m_path;
+
+    //! Indices of the elements located in the region.
+    std::vector<int> m_elements;
+
+    //! Boxes of the elements, in the local coordinates of __m_object__.
+    std::vector<cCollisionAABBBox> m_elementBoxes;
+};
+
+
+//==============================================================================
+/*!
+    \struct     cCollisionCacheObject
+    \ingroup    collisions
+
+    \brief
+    This structure stores the state of an object of the world when a
+    collision cache was built, so that later modifications can be detected.
+*/
+//==============================================================================
+struct cCollisionCacheObject
+{
+    //! Object.
+    cGenericObject* m_object;
+
+    //! Object converted to a multi-mesh, or __NULL__ if it is not a multi-mesh.
+    cMultiMesh* m_multiMesh;
+
+    //! Index of the parent of the object, or -1 if the object is a child of the world.
+    int m_parent;
+
+    //! If __true__, the object holds cached elements.
+    bool m_cached;
+
+    //! If __true__, the object was a ghost.
+    bool m_ghost;
+
+    //! If __true__, the object was enabled for the collision settings of the cache.
+    bool m_active;
+
+    //! Local position of the object.
+    cVector3d m_localPos;
+
+    //! Local rotation of the object.
+    cMatrix3d m_localRot;
+
+    //! Position of the object in world coordinates.
+    cVector3d m_globalPos;
+
+    //! Rotation of the object in world coordinates.
+    cMatrix3d m_globalRot;
+
+    //! Minimum point of the boundary box of the object.
+    cVector3d m_boundaryBoxMin;
+
+    //! Maximum point of the boundary box of the object.
+    cVector3d m_boundaryBoxMax;
+
+    //! Collision detector of the object.
+    cGenericCollision* m_collisionDetector;
+
+    //! Version of the collision detector (see cGenericCollision::getVersion()).
+    unsigned int m_collisionDetectorVersion;
+
+    //! Version of the list of children of the object (see cGenericObject::getChildrenVersion()).
+    unsigned int m_childrenVersion;
+
+    //! Number of meshes of the object if it is a multi-mesh.
+    int m_numMeshes;
+};
+
+
+//==============================================================================
+/*!
+    \class      cCollisionCache
+    \ingroup    collisions
+
+    \brief
+    This class implements a cache of the collision elements located around a
+    moving segment query.
+
+    \details
+    Force algorithms issue several segment queries per haptic cycle, each
+    starting from the root of the world, although consecutive queries
+    usually involve the same few triangles. cCollisionCache stores, for a
+    box of the world called the region, the elements of every collision
+    detector that may intersect the box. A query whose segment, enlarged by
+    the collision radius, lies within the region can only collide with
+    these elements, and is answered by testing them directly. Other queries
+    rebuild the region around the segment, enlarged by a margin so that
+    subsequent queries fall within it. \n
+
+    Elements are selected by the collision detectors that support it (see
+    cGenericCollision::computeElementsInBox()), such as the AABB collision
+    tree. Objects overlapping the region whose collisions cannot be
+    restricted to a few elements, such as shapes, voxel objects, or objects
+    using other collision detectors, are referenced by the cache and tested
+    entirely. Queries that adjust the motion of objects are always
+    forwarded to the world. \n
+
+    A cache may also be built by another thread, then queried with
+    computeCachedCollisionDetection(), which never rebuilds the region. \n
+
+    Before each query answered from the cache, the state recorded for the
+    objects holding cached elements and for their parents is checked, so
+    that the cost of a query does not depend on the size of the world. The
+    cached elements are discarded if one of these objects has moved, been
+    disabled, had its collision detector or boundary box modified, or had
+    children added or removed. \n
+
+    Modifications of the rest of the world are detected by
+    isWorldUnchanged(), which visits the state recorded for every object:
+    an object added to or removed from the world, or another object now
+    reaching the region. computeCollisionDetection() calls it before each
+    query. Caches built by another thread are checked by that thread
+    instead, which discards them when the world has changed. Other changes,
+    such as modifications of the geometry of an object that update neither
+    its collision detector nor its boundary box, are not detected:
+    invalidate() must be called after them.
+*/
+//==============================================================================
+class cCollisionCache
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cCollisionCache.
+    cCollisionCache();
+
+    //! Destructor of cCollisionCache.
+    virtual ~cCollisionCache() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method computes all collisions between a segment and a world, using the cached elements when possible.
+    bool computeCollisionDetection(cWorld* a_world,
+                                   const cVector3d& a_segmentPointA,
+                                   const cVector3d& a_segmentPointB,
+                                   cCollisionRecorder& a_recorder,
+                                   cCollisionSettings& a_settings);
+
+    //! This method computes all collisions between a segment and the cached elements. Returns __false__ if the query cannot be answered from the cache.
+    bool computeCachedCollisionDetection(cWorld* a_world,
+                                         const cVector3d& a_segmentPointA,
+                                         const cVector3d& a_segmentPointB,
+                                         cCollisionRecorder& a_recorder,
+                                         cCollisionSettings& a_settings,
+                                         bool& a_hit);
+
+    //! This method builds the region around a segment.
+    void build(cWorld* a_world,
+               const cVector3d& a_segmentPointA,
+               const cVector3d& a_segmentPointB,
+               const cCollisionSettings& a_settings);
+
+    //! This method discards the cached elements.
+    void invalidate();
+
+    //! This method returns __true__ if no modification of the world since the region was built affects the cached elements.
+    bool isWorldUnchanged(cWorld* a_world, const cCollisionSettings& a_settings);
+
+    //! This method sets the margin added around segments when the region is built. A value of zero selects twice the collision radius.
+    void setMargin(const double a_margin) { m_margin = cMax(a_margin, 0.0); }
+
+    //! This method returns the margin added around segments when the region is built.
+    double getMargin() const { return (m_margin); }
+
+    //! This method returns the number of elements currently cached.
+    int getNumCachedElements() const;
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - STATISTICS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of queries answered from the cached elements.
+    unsigned int getNumCacheHits() const { return (m_numCacheHits); }
+
+    //! This method returns the number of queries forwarded to the world.
+    unsigned int getNumCacheMisses() const { return (m_numCacheMisses); }
+
+    //! This method returns the number of times the region has been built.
+    unsigned int getNumRebuilds() const { return (m_numRebuilds); }
+
+    //! This method returns the ratio of queries answered from the cached elements.
+    double getHitRate() const;
+
+    //! This method resets the statistics.
+    void resetStatistics();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method caches the elements of an object and of its descendants located in the region.
+    void buildObject(cGenericObject* a_object,
+                     const int a_parent,
+                     const cVector3d& a_parentPos,
+                     const cMatrix3d& a_parentRot,
+                     std::vector<cGenericObject*>& a_path,
+                     const cCollisionSettings& a_settings);
+
+    //! This method returns __true__ if the objects holding cached elements and their parents are unchanged.
+    bool isValid(cWorld* a_world, const cCollisionSettings& a_settings) const;
+
+    //! This method returns __true__ if the collisions of an object, located at a given frame, may reach the region.
+    bool reachesRegion(cGenericObject* a_object,
+                       const cVector3d& a_pos,
+                       const cMatrix3d& a_rot,
+                       const cCollisionSettings& a_settings) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! World for which the region was built, or __NULL__ if the cache is empty.
+    cWorld* m_world;
+
+    //! Number of children of the world when the region was built.
+    unsigned int m_numWorldChildren;
+
+    //! Version of the list of children of the world when the region was built.
+    unsigned int m_worldChildrenVersion;
+
+    //! Minimum point of the region, in world coordinates.
+    cVector3d m_regionMin;
+
+    //! Maximum point of the region, in world coordinates.
+    cVector3d m_regionMax;
+
+    //! Settings with which the region was built.
+    cCollisionSettings m_regionSettings;
+
+    //! Cached elements of each object overlapping the region.
+    std::vector<cCollisionCacheEntry> m_entries;
+
+    //! State of every object of the world when the region was built, parents first.
+    std::vector<cCollisionCacheObject> m_objects;
+
+    //! Indices in __m_objects__ of the objects holding cached elements and of their parents, parents first.
+    std::vector<int> m_checkedObjects;
+
+    //! Flags set by isWorldUnchanged() for objects that have moved since the region was built.
+    std::vector<bool> m_objectMoved;
+
+    //! Positions computed by isWorldUnchanged() in world coordinates for objects that have moved.
+    std::vector<cVector3d> m_objectPos;
+
+    //! Rotations computed by isWorldUnchanged() in world coordinates for objects that have moved.
+    std::vector<cMatrix3d> m_objectRot;
+
+    //! Margin added around segments when the region is built.
+    double m_margin;
+
+    //! Number of queries answered from the cached elements.
+    unsigned int m_numCacheHits;
+
+    //! Number of queries forwarded to the world.
+    unsigned int m_numCacheMisses;
+
+    //! Number of times the region has been built.
+    unsigned int m_numRebuilds;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
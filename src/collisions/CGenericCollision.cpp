@@ -65,6 +65,9 @@ cGenericCollision::cGenericCollision()
 
     // set default value for display depth (level 0 = root)
     m_displayDepth = 0;
+
+    // no modification yet
+    m_version = 0;
 }
 
 
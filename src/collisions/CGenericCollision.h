@@ -47,6 +47,9 @@
 #define CGenericCollisionH
 //------------------------------------------------------------------------------
 #include "collisions/CCollisionBasics.h"
+#include "collisions/CCollisionAABBBox.h"
+//------------------------------------------------------------------------------
+#include <atomic>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -131,6 +134,25 @@ public:
                                   cCollisionSettings& a_settings)
                                   { return (false); }
 
+    //! This method computes a box, in local coordinates, enclosing all collisions reported by this detector. Returns __false__ if no such box is available.
+    virtual bool computeBoundaryBox(cVector3d& a_boxMin,
+                                    cVector3d& a_boxMax) { return (false); }
+
+    //! This method appends the elements whose boxes, in local coordinates, intersect a box. Returns __false__ if the detector cannot select elements.
+    virtual bool computeElementsInBox(const cVector3d& a_boxMin,
+                                      const cVector3d& a_boxMax,
+                                      std::vector<int>& a_elements,
+                                      std::vector<cCollisionAABBBox>& a_elementBoxes) { return (false); }
+
+    //! This method computes all collisions between a segment and a list of elements selected by computeElementsInBox().
+    virtual bool computeCollisionWithElements(cGenericObject* a_object,
+                                              cVector3d& a_segmentPointA,
+                                              cVector3d& a_segmentPointB,
+                                              const std::vector<int>& a_elements,
+                                              const std::vector<cCollisionAABBBox>& a_elementBoxes,
+                                              cCollisionRecorder& a_recorder,
+                                              cCollisionSettings& a_settings) { return (false); }
+
     //! This method renders a visual representation of the collision tree.
     virtual void render(cRenderOptions& a_options) {};
 
@@ -143,6 +165,9 @@ public:
     //! This method returns the level inside the collision tree being displayed. (root = 0).
     double getDisplayDepth() const { return (m_displayDepth); }
 
+    //! This method returns a counter incremented every time the elements or boxes reported by this detector are modified.
+    unsigned int getVersion() const { return (m_version); }
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -169,6 +194,9 @@ protected:
         than the physical radius of the proxy.
     */
     double m_radiusAroundElements;
+
+    //! Counter incremented every time the elements or boxes reported by this detector are modified.
+    std::atomic<unsigned int> m_version;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,517 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "collisions/CVoxelOccupancy.h"
+//------------------------------------------------------------------------------
+#include "graphics/CBrickImage.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cVoxelOccupancy.
+*/
+//==============================================================================
+cVoxelOccupancy::cVoxelOccupancy()
+{
+    m_image = NULL;
+    m_size[0] = 0;
+    m_size[1] = 0;
+    m_size[2] = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method builds the pyramid from the alpha channel of an image. Each
+    image of a cMultiImage is treated as a slice of the volume.
+
+    \param  a_image  Image.
+*/
+//==============================================================================
+void cVoxelOccupancy::build(cImage* a_image)
+{
+    clear();
+
+    // sanity check
+    if (a_image == NULL)
+    {
+        return;
+    }
+
+    m_image = a_image;
+    m_size[0] = (int)(a_image->getWidth());
+    m_size[1] = (int)(a_image->getHeight());
+    m_size[2] = (int)(a_image->getImageCount());
+
+    if ((m_size[0] == 0) || (m_size[1] == 0) || (m_size[2] == 0))
+    {
+        clear();
+        return;
+    }
+
+    // create levels, from the bricks up to a single root node
+    int numNodes[3];
+    for (int i=0; i<3; i++)
+    {
+        numNodes[i] = (m_size[i] + C_VOXEL_OCCUPANCY_BRICK_SIZE - 1) / C_VOXEL_OCCUPANCY_BRICK_SIZE;
+    }
+
+    while (true)
+    {
+        cVoxelOccupancyLevel level;
+        level.m_numNodes[0] = numNodes[0];
+        level.m_numNodes[1] = numNodes[1];
+        level.m_numNodes[2] = numNodes[2];
+
+        unsigned int count = (unsigned int)(numNodes[0] * numNodes[1] * numNodes[2]);
+        level.m_min.assign(count, 0xff);
+        level.m_max.assign(count, 0x00);
+        m_levels.push_back(level);
+
+        if ((numNodes[0] == 1) && (numNodes[1] == 1) && (numNodes[2] == 1))
+        {
+            break;
+        }
+
+        for (int i=0; i<3; i++)
+        {
+            numNodes[i] = (numNodes[i] + 1) / 2;
+        }
+    }
+
+    // compute bricks
+    const cVoxelOccupancyLevel& bricks = m_levels[0];
+    for (int z=0; z<bricks.m_numNodes[2]; z++)
+    {
+        for (int y=0; y<bricks.m_numNodes[1]; y++)
+        {
+            for (int x=0; x<bricks.m_numNodes[0]; x++)
+            {
+                updateBrick(a_image, x, y, z);
+            }
+        }
+    }
+
+    // compute coarser levels
+    int numLevels = (int)(m_levels.size());
+    for (int l=1; l<numLevels; l++)
+    {
+        const cVoxelOccupancyLevel& level = m_levels[l];
+        for (int z=0; z<level.m_numNodes[2]; z++)
+        {
+            for (int y=0; y<level.m_numNodes[1]; y++)
+            {
+                for (int x=0; x<level.m_numNodes[0]; x++)
+                {
+                    updateNode(l, x, y, z);
+                }
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the nodes covering a range of voxels after the
+    image has been modified. The range is inclusive and is clamped to the
+    size of the volume. Only the bricks overlapping the range and their
+    ancestors are updated.
+
+    \param  a_image  Image.
+    \param  a_minX   Minimum voxel coordinate along __x__.
+    \param  a_minY   Minimum voxel coordinate along __y__.
+    \param  a_minZ   Minimum voxel coordinate along __z__.
+    \param  a_maxX   Maximum voxel coordinate along __x__.
+    \param  a_maxY   Maximum voxel coordinate along __y__.
+    \param  a_maxZ   Maximum voxel coordinate along __z__.
+*/
+//==============================================================================
+void cVoxelOccupancy::update(cImage* a_image,
+                             const int a_minX, const int a_minY, const int a_minZ,
+                             const int a_maxX, const int a_maxY, const int a_maxZ)
+{
+    // sanity check
+    if ((a_image == NULL) || (m_levels.size() == 0))
+    {
+        return;
+    }
+
+    // clamp range to volume
+    int rangeMin[3] = { cMax(a_minX, 0), cMax(a_minY, 0), cMax(a_minZ, 0) };
+    int rangeMax[3] = { cMin(a_maxX, m_size[0] - 1), cMin(a_maxY, m_size[1] - 1), cMin(a_maxZ, m_size[2] - 1) };
+    for (int i=0; i<3; i++)
+    {
+        if (rangeMin[i] > rangeMax[i])
+        {
+            return;
+        }
+
+        rangeMin[i] = rangeMin[i] / C_VOXEL_OCCUPANCY_BRICK_SIZE;
+        rangeMax[i] = rangeMax[i] / C_VOXEL_OCCUPANCY_BRICK_SIZE;
+    }
+
+    // update bricks
+    for (int z=rangeMin[2]; z<=rangeMax[2]; z++)
+    {
+        for (int y=rangeMin[1]; y<=rangeMax[1]; y++)
+        {
+            for (int x=rangeMin[0]; x<=rangeMax[0]; x++)
+            {
+                updateBrick(a_image, x, y, z);
+            }
+        }
+    }
+
+    // update ancestors
+    int numLevels = (int)(m_levels.size());
+    for (int l=1; l<numLevels; l++)
+    {
+        for (int i=0; i<3; i++)
+        {
+            rangeMin[i] = rangeMin[i] / 2;
+            rangeMax[i] = rangeMax[i] / 2;
+        }
+
+        for (int z=rangeMin[2]; z<=rangeMax[2]; z++)
+        {
+            for (int y=rangeMin[1]; y<=rangeMax[1]; y++)
+            {
+                for (int x=rangeMin[0]; x<=rangeMax[0]; x++)
+                {
+                    updateNode(l, x, y, z);
+                }
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method clears the pyramid.
+*/
+//==============================================================================
+void cVoxelOccupancy::clear()
+{
+    m_image = NULL;
+    m_size[0] = 0;
+    m_size[1] = 0;
+    m_size[2] = 0;
+    m_levels.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if a box of voxels may contain a voxel whose
+    alpha value is greater than or equal to __a_threshold__. The test is
+    conservative: a brick partially overlapping the box is considered
+    occupied if any of its voxels is. If the pyramid has not been built, the
+    method returns __true__.
+
+    \param  a_min        Minimum voxel coordinates of the box.
+    \param  a_max        Maximum voxel coordinates of the box (inclusive).
+    \param  a_threshold  Alpha value from which a voxel is considered occupied.
+
+    \return __true__ if the box may contain an occupied voxel, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelOccupancy::isOccupied(const int a_min[3], const int a_max[3], const int a_threshold) const
+{
+    if (m_levels.size() == 0)
+    {
+        return (true);
+    }
+
+    // clamp box to volume; voxels outside of the volume are empty
+    int boxMin[3], boxMax[3];
+    for (int i=0; i<3; i++)
+    {
+        boxMin[i] = cMax(a_min[i], 0);
+        boxMax[i] = cMin(a_max[i], m_size[i] - 1);
+        if (boxMin[i] > boxMax[i])
+        {
+            return (false);
+        }
+    }
+
+    return (isNodeOccupied((int)(m_levels.size()) - 1, 0, 0, 0, boxMin, boxMax, a_threshold));
+}
+
+
+//==============================================================================
+/*!
+    This method searches for the largest node of the pyramid that contains
+    voxel __a_voxel__, and such that no voxel of the node, nor any voxel
+    located within __a_margin__ voxels of the node, is occupied. \n
+
+    The returned region is clamped to the volume. Collision queries use it
+    to skip all sample points whose voxel falls inside the region.
+
+    \param  a_voxel      Voxel coordinates. These must lie inside the volume.
+    \param  a_margin     Margin, in voxels, along each axis.
+    \param  a_threshold  Alpha value from which a voxel is considered occupied.
+    \param  a_regionMin  Returned minimum voxel coordinates of the region.
+    \param  a_regionMax  Returned maximum voxel coordinates of the region (inclusive).
+
+    \return __true__ if an empty region was found, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelOccupancy::getEmptyRegion(const int a_voxel[3],
+                                     const int a_margin[3],
+                                     const int a_threshold,
+                                     int a_regionMin[3],
+                                     int a_regionMax[3]) const
+{
+    bool result = false;
+
+    // climb the pyramid for as long as the node and its margin remain empty
+    int numLevels = (int)(m_levels.size());
+    for (int l=0; l<numLevels; l++)
+    {
+        int nodeSize = C_VOXEL_OCCUPANCY_BRICK_SIZE << l;
+
+        int nodeMin[3], nodeMax[3];
+        int boxMin[3], boxMax[3];
+        for (int i=0; i<3; i++)
+        {
+            nodeMin[i] = (a_voxel[i] / nodeSize) * nodeSize;
+            nodeMax[i] = cMin(nodeMin[i] + nodeSize - 1, m_size[i] - 1);
+            boxMin[i] = nodeMin[i] - a_margin[i];
+            boxMax[i] = nodeMax[i] + a_margin[i];
+        }
+
+        if (isOccupied(boxMin, boxMax, a_threshold))
+        {
+            break;
+        }
+
+        for (int i=0; i<3; i++)
+        {
+            a_regionMin[i] = nodeMin[i];
+            a_regionMax[i] = nodeMax[i];
+        }
+        result = true;
+    }
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the values of a brick from the image. Regions of
+    a \ref cBrickImage that are not allocated are not scanned, since all
+    their voxels take the background color.
+
+    \param  a_image  Image.
+    \param  a_x      Brick index along __x__.
+    \param  a_y      Brick index along __y__.
+    \param  a_z      Brick index along __z__.
+*/
+//==============================================================================
+void cVoxelOccupancy::updateBrick(cImage* a_image, const int a_x, const int a_y, const int a_z)
+{
+    cVoxelOccupancyLevel& bricks = m_levels[0];
+
+    int voxelMin[3] = { a_x * C_VOXEL_OCCUPANCY_BRICK_SIZE, a_y * C_VOXEL_OCCUPANCY_BRICK_SIZE, a_z * C_VOXEL_OCCUPANCY_BRICK_SIZE };
+    int voxelMax[3];
+    for (int i=0; i<3; i++)
+    {
+        voxelMax[i] = cMin(voxelMin[i] + C_VOXEL_OCCUPANCY_BRICK_SIZE, m_size[i]);
+    }
+
+    int index = a_x + a_y * bricks.m_numNodes[0] + a_z * bricks.m_numNodes[0] * bricks.m_numNodes[1];
+
+    // unallocated region of a sparse image
+    cBrickImage* brickImage = dynamic_cast<cBrickImage*>(a_image);
+    if (brickImage != NULL)
+    {
+        int regionMax[3] = { voxelMax[0] - 1, voxelMax[1] - 1, voxelMax[2] - 1 };
+        if (brickImage->isRegionEmpty(voxelMin, regionMax))
+        {
+            bricks.m_min[index] = brickImage->getBackgroundColor().getA();
+            bricks.m_max[index] = brickImage->getBackgroundColor().getA();
+            return;
+        }
+    }
+
+    unsigned char valueMin = 0xff;
+    unsigned char valueMax = 0x00;
+    for (int z=voxelMin[2]; z<voxelMax[2]; z++)
+    {
+        for (int y=voxelMin[1]; y<voxelMax[1]; y++)
+        {
+            for (int x=voxelMin[0]; x<voxelMax[0]; x++)
+            {
+                cColorb color;
+                unsigned char alpha = 0;
+                if (a_image->getVoxelColor(x, y, z, color))
+                {
+                    alpha = color.getA();
+                }
+
+                if (alpha < valueMin) { valueMin = alpha; }
+                if (alpha > valueMax) { valueMax = alpha; }
+            }
+        }
+    }
+
+    bricks.m_min[index] = valueMin;
+    bricks.m_max[index] = valueMax;
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the values of a node from its children.
+
+    \param  a_level  Level of the node (must be greater than 0).
+    \param  a_x      Node index along __x__.
+    \param  a_y      Node index along __y__.
+    \param  a_z      Node index along __z__.
+*/
+//==============================================================================
+void cVoxelOccupancy::updateNode(const int a_level, const int a_x, const int a_y, const int a_z)
+{
+    const cVoxelOccupancyLevel& children = m_levels[a_level - 1];
+    cVoxelOccupancyLevel& level = m_levels[a_level];
+
+    int childMax[3] = { cMin(2 * a_x + 2, children.m_numNodes[0]),
+                        cMin(2 * a_y + 2, children.m_numNodes[1]),
+                        cMin(2 * a_z + 2, children.m_numNodes[2]) };
+
+    unsigned char valueMin = 0xff;
+    unsigned char valueMax = 0x00;
+    for (int z=2*a_z; z<childMax[2]; z++)
+    {
+        for (int y=2*a_y; y<childMax[1]; y++)
+        {
+            for (int x=2*a_x; x<childMax[0]; x++)
+            {
+                int index = x + y * children.m_numNodes[0] + z * children.m_numNodes[0] * children.m_numNodes[1];
+                if (children.m_min[index] < valueMin) { valueMin = children.m_min[index]; }
+                if (children.m_max[index] > valueMax) { valueMax = children.m_max[index]; }
+            }
+        }
+    }
+
+    int index = a_x + a_y * level.m_numNodes[0] + a_z * level.m_numNodes[0] * level.m_numNodes[1];
+    level.m_min[index] = valueMin;
+    level.m_max[index] = valueMax;
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if a node, or one of its descendants
+    overlapping a box of voxels, may contain an occupied voxel.
+
+    \param  a_level      Level of the node.
+    \param  a_x          Node index along __x__.
+    \param  a_y          Node index along __y__.
+    \param  a_z          Node index along __z__.
+    \param  a_min        Minimum voxel coordinates of the box, clamped to the volume.
+    \param  a_max        Maximum voxel coordinates of the box, clamped to the volume.
+    \param  a_threshold  Alpha value from which a voxel is considered occupied.
+
+    \return __true__ if the node may contain an occupied voxel inside the box, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelOccupancy::isNodeOccupied(const int a_level,
+                                     const int a_x, const int a_y, const int a_z,
+                                     const int a_min[3], const int a_max[3],
+                                     const int a_threshold) const
+{
+    const cVoxelOccupancyLevel& level = m_levels[a_level];
+    int index = a_x + a_y * level.m_numNodes[0] + a_z * level.m_numNodes[0] * level.m_numNodes[1];
+
+    if ((int)(level.m_max[index]) < a_threshold)
+    {
+        return (false);
+    }
+
+    if (a_level == 0)
+    {
+        return (true);
+    }
+
+    // visit children overlapping the box
+    const cVoxelOccupancyLevel& children = m_levels[a_level - 1];
+    int childSize = C_VOXEL_OCCUPANCY_BRICK_SIZE << (a_level - 1);
+
+    int childMin[3], childMax[3];
+    int node[3] = { a_x, a_y, a_z };
+    for (int i=0; i<3; i++)
+    {
+        childMin[i] = cMax(2 * node[i], a_min[i] / childSize);
+        childMax[i] = cMin(cMin(2 * node[i] + 1, a_max[i] / childSize), children.m_numNodes[i] - 1);
+    }
+
+    for (int z=childMin[2]; z<=childMax[2]; z++)
+    {
+        for (int y=childMin[1]; y<=childMax[1]; y++)
+        {
+            for (int x=childMin[0]; x<=childMax[0]; x++)
+            {
+                if (isNodeOccupied(a_level - 1, x, y, z, a_min, a_max, a_threshold))
+                {
+                    return (true);
+                }
+            }
+        }
+    }
+
+    return (false);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
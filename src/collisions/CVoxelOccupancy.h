@@ -0,0 +1,223 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CVoxelOccupancyH
+#define CVoxelOccupancyH
+//------------------------------------------------------------------------------
+#include "graphics/CImage.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CVoxelOccupancy.h
+    \ingroup    collisions
+
+    \brief
+    Implements a hierarchical occupancy map for voxel volumes.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cVoxelOccupancy;
+typedef std::shared_ptr<cVoxelOccupancy> cVoxelOccupancyPtr;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//! Edge length, in voxels, of the bricks stored at the finest level of an occupancy pyramid.
+const int C_VOXEL_OCCUPANCY_BRICK_SIZE = 8;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \struct     cVoxelOccupancyLevel
+    \ingroup    collisions
+
+    \brief
+    This structure stores one level of an occupancy pyramid.
+*/
+//==============================================================================
+struct cVoxelOccupancyLevel
+{
+    //! Number of nodes along each axis.
+    int m_numNodes[3];
+
+    //! Smallest alpha value found in each node.
+    std::vector<unsigned char> m_min;
+
+    //! Largest alpha value found in each node.
+    std::vector<unsigned char> m_max;
+};
+
+
+//==============================================================================
+/*!
+    \class      cVoxelOccupancy
+    \ingroup    collisions
+
+    \brief
+    This class implements a min/max occupancy pyramid over the alpha channel
+    of a voxel volume.
+
+    \details
+    The volume is divided into bricks of C_VOXEL_OCCUPANCY_BRICK_SIZE voxels
+    along each axis. The finest level of the pyramid stores the smallest
+    and largest alpha value found in every brick, and every coarser level
+    stores the minimum and maximum over groups of 2x2x2 nodes of the level
+    below, up to a single node covering the whole volume. \n
+
+    Since values are stored rather than a binary occupancy, the pyramid
+    remains valid when the isosurface threshold changes. A region is
+    considered occupied when it may contain a voxel whose alpha value is
+    greater than or equal to the threshold; voxels located outside of the
+    volume are considered empty. \n
+
+    The pyramid is not notified when the image is modified. After editing
+    voxels, call update() with the range of modified voxels, or build() to
+    recompute the entire pyramid.
+*/
+//==============================================================================
+class cVoxelOccupancy
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cVoxelOccupancy.
+    cVoxelOccupancy();
+
+    //! Destructor of cVoxelOccupancy.
+    virtual ~cVoxelOccupancy() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds the pyramid from the alpha channel of an image.
+    void build(cImage* a_image);
+
+    //! This method recomputes the nodes covering a range of voxels after the image has been modified.
+    void update(cImage* a_image,
+                const int a_minX, const int a_minY, const int a_minZ,
+                const int a_maxX, const int a_maxY, const int a_maxZ);
+
+    //! This method clears the pyramid.
+    void clear();
+
+    //! This method returns the number of levels of the pyramid (0 if the pyramid has not been built).
+    int getNumLevels() const { return ((int)(m_levels.size())); }
+
+    //! This method returns the image from which the pyramid was built, or __NULL__ if the pyramid has not been built.
+    const cImage* getImage() const { return (m_image); }
+
+    //! This method returns the number of voxels along axis __a_axis__ of the volume.
+    int getSize(const int a_axis) const { return (m_size[a_axis]); }
+
+    //! This method returns a level of the pyramid. Level 0 contains the bricks.
+    const cVoxelOccupancyLevel& getLevel(const int a_level) const { return (m_levels[a_level]); }
+
+    //! This method returns __true__ if a box of voxels may contain a voxel whose alpha value is at least __a_threshold__.
+    bool isOccupied(const int a_min[3], const int a_max[3], const int a_threshold) const;
+
+    //! This method returns the largest empty node containing a voxel, such that all voxels within a margin around the node are empty too.
+    bool getEmptyRegion(const int a_voxel[3],
+                        const int a_margin[3],
+                        const int a_threshold,
+                        int a_regionMin[3],
+                        int a_regionMax[3]) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method recomputes the values of a brick from the image.
+    void updateBrick(cImage* a_image, const int a_x, const int a_y, const int a_z);
+
+    //! This method recomputes the values of a node from its children.
+    void updateNode(const int a_level, const int a_x, const int a_y, const int a_z);
+
+    //! This method returns __true__ if a node, or one of its descendants overlapping a box, may contain an occupied voxel.
+    bool isNodeOccupied(const int a_level,
+                        const int a_x, const int a_y, const int a_z,
+                        const int a_min[3], const int a_max[3],
+                        const int a_threshold) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Image from which the pyramid was built.
+    const cImage* m_image;
+
+    //! Number of voxels along each axis.
+    int m_size[3];
+
+    //! Levels of the pyramid, from the bricks to the root.
+    std::vector<cVoxelOccupancyLevel> m_levels;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,492 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "devices/CHapticScheduler.h"
+#include "timers/CHapticTrace.h"
+//------------------------------------------------------------------------------
+#if defined(LINUX) || defined(MACOSX)
+#include <time.h>
+#endif
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This method returns the upper bound of the histogram bin below which a
+    given fraction of all recorded samples fall.
+
+    \param  a_histogram  Histogram (jitter or duration).
+    \param  a_fraction   Fraction of samples (0.0 - 1.0).
+
+    \return Time value in seconds.
+*/
+//==============================================================================
+double cHapticSchedulerStatistics::computePercentile(const unsigned int* a_histogram,
+                                                     const double a_fraction) const
+{
+    double total = 0.0;
+    for (int i=0; i<C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE; i++)
+    {
+        total += (double)a_histogram[i];
+    }
+
+    if (total == 0.0) { return (0.0); }
+
+    double target = a_fraction * total;
+    double count = 0.0;
+    for (int i=0; i<C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE; i++)
+    {
+        count += (double)a_histogram[i];
+        if (count >= target)
+        {
+            return (getHistogramBinTime(i + 1));
+        }
+    }
+
+    return (getHistogramBinTime(C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE));
+}
+
+
+//==============================================================================
+/*!
+    Constructor of cHapticScheduler.
+*/
+//==============================================================================
+cHapticScheduler::cHapticScheduler()
+{
+    m_running = false;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cHapticScheduler. Running loops are stopped first.
+*/
+//==============================================================================
+cHapticScheduler::~cHapticScheduler()
+{
+    stop();
+
+    std::vector<cHapticSchedulerLoop*>::iterator it;
+    for (it = m_loops.begin(); it != m_loops.end(); ++it)
+    {
+        delete (*it);
+    }
+    m_loops.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method registers a haptic device with the scheduler. When the
+    scheduler is started, a dedicated thread calls __a_callback__ at
+    __a_frequency__ Hz for this device.\n
+
+    If __a_core__ is -1, the loop is pinned automatically, starting from the
+    last processor core and moving down, so that core 0 remains available to
+    the graphics thread. If no core can be reserved, the loop is not pinned.
+    Devices cannot be added while the scheduler is running.
+
+    \param  a_device     Haptic device.
+    \param  a_callback   Function called at every cycle.
+    \param  a_userData   User data passed to the callback.
+    \param  a_frequency  Update rate of the loop in Hz.
+    \param  a_core       Processor core to which the loop is pinned (-1 for automatic selection).
+
+    \return Index of the new loop, or -1 if the device could not be registered.
+*/
+//==============================================================================
+int cHapticScheduler::addDevice(cGenericHapticDevicePtr a_device,
+                                cHapticSchedulerCallback a_callback,
+                                void* a_userData,
+                                const double a_frequency,
+                                const int a_core)
+{
+    // sanity check
+    if ((m_running) || (a_device == nullptr) || (a_callback == NULL) || (a_frequency <= 0.0))
+    {
+        return (-1);
+    }
+
+    int index = (int)(m_loops.size());
+
+    // select processor core
+    int core = a_core;
+    if (core < 0)
+    {
+        int numCores = (int)(cThread::getNumCores());
+        if (index < numCores - 1)
+        {
+            core = numCores - 1 - index;
+        }
+        else
+        {
+            core = -1;
+        }
+    }
+
+    // create loop
+    cHapticSchedulerLoop* loop = new cHapticSchedulerLoop();
+    loop->m_device = a_device;
+    loop->m_callback = a_callback;
+    loop->m_userData = a_userData;
+    loop->m_period = 1.0 / a_frequency;
+    loop->m_core = core;
+    loop->m_running = false;
+    loop->m_resetRequested = false;
+    loop->m_statistics.m_period = loop->m_period;
+    loop->m_statistics.reset();
+    for (unsigned int i=0; i<3; i++)
+    {
+        loop->m_publishedStatistics.getBuffer(i) = loop->m_statistics;
+    }
+
+    m_loops.push_back(loop);
+
+    return (index);
+}
+
+
+//==============================================================================
+/*!
+    This method starts one thread per registered device. Statistics are
+    cleared before the threads are created.
+
+    \return __true__ if the loops were started, __false__ if the scheduler is
+            already running or no device has been registered.
+*/
+//==============================================================================
+bool cHapticScheduler::start()
+{
+    if ((m_running) || (m_loops.size() == 0))
+    {
+        return (false);
+    }
+
+    std::vector<cHapticSchedulerLoop*>::iterator it;
+    for (it = m_loops.begin(); it != m_loops.end(); ++it)
+    {
+        cHapticSchedulerLoop* loop = (*it);
+        clearStatistics(loop);
+        loop->m_resetRequested = false;
+        loop->m_running = true;
+        loop->m_thread.start(cHapticScheduler::loop, CTHREAD_PRIORITY_HAPTICS, loop);
+    }
+
+    m_running = true;
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method requests all haptic loops to terminate and blocks until every
+    thread has completed its current cycle and exited.
+*/
+//==============================================================================
+void cHapticScheduler::stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    std::vector<cHapticSchedulerLoop*>::iterator it;
+    for (it = m_loops.begin(); it != m_loops.end(); ++it)
+    {
+        (*it)->m_running = false;
+    }
+
+    for (it = m_loops.begin(); it != m_loops.end(); ++it)
+    {
+        (*it)->m_thread.join();
+    }
+
+    m_running = false;
+}
+
+
+//==============================================================================
+/*!
+    This method returns a copy of the timing statistics of a haptic loop, as
+    published at the end of its latest cycle. It can be called safely while 
+    the loop is running, and never blocks the haptic thread.
+
+    \param  a_statistics  Returned statistics.
+    \param  a_index       Index of the loop.
+
+    \return __true__ if the index is valid, __false__ otherwise.
+*/
+//==============================================================================
+bool cHapticScheduler::getStatistics(cHapticSchedulerStatistics& a_statistics,
+                                     const unsigned int a_index)
+{
+    if (a_index >= m_loops.size())
+    {
+        return (false);
+    }
+
+    cHapticSchedulerLoop* loop = m_loops[a_index];
+    loop->m_readMutex.acquire();
+    loop->m_publishedStatistics.update();
+    a_statistics = loop->m_publishedStatistics.getReadBuffer();
+    loop->m_readMutex.release();
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method clears the timing statistics of a haptic loop. If the loop 
+    is running, the statistics are cleared by the loop itself at the 
+    beginning of its next cycle.
+
+    \param  a_index  Index of the loop.
+*/
+//==============================================================================
+void cHapticScheduler::resetStatistics(const unsigned int a_index)
+{
+    if (a_index >= m_loops.size())
+    {
+        return;
+    }
+
+    cHapticSchedulerLoop* loop = m_loops[a_index];
+    if (m_running)
+    {
+        loop->m_resetRequested = true;
+    }
+    else
+    {
+        clearStatistics(loop);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method clears the timing statistics of a haptic loop and publishes
+    them. It is called by the loop thread, or while the loop is stopped.
+
+    \param  a_loop  Haptic loop.
+*/
+//==============================================================================
+void cHapticScheduler::clearStatistics(cHapticSchedulerLoop* a_loop)
+{
+    a_loop->m_statistics.reset();
+    a_loop->m_publishedStatistics.getWriteBuffer() = a_loop->m_statistics;
+    a_loop->m_publishedStatistics.publish();
+}
+
+
+//==============================================================================
+/*!
+    This method executes a haptic loop until it is stopped.\n
+
+    Cycles are scheduled on absolute deadlines so that timing errors do not
+    accumulate. When a callback returns after the start of the next cycle,
+    an overrun is recorded and every cycle whose deadline has already
+    elapsed is dropped, so the loop resynchronizes instead of firing a
+    burst of late cycles.
+
+    \param  a_loop  Pointer to the loop (cHapticSchedulerLoop).
+*/
+//==============================================================================
+void cHapticScheduler::loop(void* a_loop)
+{
+    cHapticSchedulerLoop* loop = (cHapticSchedulerLoop*)a_loop;
+
+    // pin thread
+    if (loop->m_core >= 0)
+    {
+        cThread::setCurrentThreadAffinity((unsigned int)(loop->m_core));
+    }
+
+    C_HAPTIC_TRACE_THREAD_NAME("haptic loop");
+
+    const double period = loop->m_period;
+    const double binWidth = 2.0 * period / (double)C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE;
+
+    cPrecisionClock clock;
+    clock.start(true);
+
+    double deadline = clock.getCurrentTimeSeconds();
+    double previousTime = deadline - period;
+
+    while (loop->m_running)
+    {
+        // clear statistics if requested by another thread
+        if (loop->m_resetRequested.exchange(false))
+        {
+            clearStatistics(loop);
+        }
+
+        // wait for the start of the cycle
+        waitUntil(clock, deadline);
+
+        double startTime = clock.getCurrentTimeSeconds();
+        double jitter = startTime - deadline;
+        double timeStep = startTime - previousTime;
+        previousTime = startTime;
+
+        // update device
+        {
+            C_HAPTIC_TRACE_SCOPE("haptic cycle");
+            loop->m_callback(loop->m_device, timeStep, loop->m_userData);
+        }
+
+        double endTime = clock.getCurrentTimeSeconds();
+        double duration = endTime - startTime;
+
+        // schedule next cycle
+        deadline += period;
+        bool overrun = (endTime > deadline);
+        unsigned int numSkipped = 0;
+        if (overrun)
+        {
+            C_HAPTIC_TRACE_DEADLINE_MISS();
+            numSkipped = (unsigned int)((endTime - deadline) / period);
+            deadline += (double)numSkipped * period;
+        }
+
+        // update statistics
+        cHapticSchedulerStatistics& stats = loop->m_statistics;
+        stats.m_numCycles++;
+        if (overrun) { stats.m_numOverruns++; }
+        stats.m_numSkippedCycles += numSkipped;
+
+        double n = (double)stats.m_numCycles;
+        stats.m_meanJitter += (jitter - stats.m_meanJitter) / n;
+        stats.m_meanDuration += (duration - stats.m_meanDuration) / n;
+        if (jitter > stats.m_maxJitter) { stats.m_maxJitter = jitter; }
+        if (duration > stats.m_maxDuration) { stats.m_maxDuration = duration; }
+
+        addHistogramSample(stats.m_jitterHistogram, jitter, binWidth);
+        addHistogramSample(stats.m_durationHistogram, duration, binWidth);
+
+        // publish statistics
+        loop->m_publishedStatistics.getWriteBuffer() = stats;
+        loop->m_publishedStatistics.publish();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method blocks the calling thread until a clock reaches a given time.
+    The thread sleeps while the remaining time is larger than
+    \ref C_HAPTIC_SCHEDULER_SPIN_TIME, then busy-waits to absorb the
+    wake-up latency of the operating system.
+
+    \param  a_clock  Clock of the haptic loop.
+    \param  a_time   Time to wait for in seconds.
+*/
+//==============================================================================
+void cHapticScheduler::waitUntil(const cPrecisionClock& a_clock, const double a_time)
+{
+    double remaining = a_time - a_clock.getCurrentTimeSeconds();
+
+    // sleep
+    while (remaining > C_HAPTIC_SCHEDULER_SPIN_TIME)
+    {
+        double interval = remaining - C_HAPTIC_SCHEDULER_SPIN_TIME;
+
+#if defined(WIN32) | defined(WIN64)
+        Sleep((DWORD)(1000.0 * interval));
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+        struct timespec t;
+        t.tv_sec  = (time_t)interval;
+        t.tv_nsec = (long)(1e9 * (interval - (double)t.tv_sec));
+        nanosleep(&t, NULL);
+#endif
+
+        remaining = a_time - a_clock.getCurrentTimeSeconds();
+    }
+
+    // spin
+    while (a_clock.getCurrentTimeSeconds() < a_time) {}
+}
+
+
+//==============================================================================
+/*!
+    This method adds a sample to a histogram. Values beyond the last bin are
+    accumulated in the last bin.
+
+    \param  a_histogram  Histogram.
+    \param  a_value      Sample value in seconds.
+    \param  a_binWidth   Width of a bin in seconds.
+*/
+//==============================================================================
+void cHapticScheduler::addHistogramSample(unsigned int* a_histogram,
+                                          const double a_value,
+                                          const double a_binWidth)
+{
+    int bin = 0;
+    if (a_value > 0.0)
+    {
+        double index = a_value / a_binWidth;
+        if (index >= (double)(C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE - 1))
+        {
+            bin = C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE - 1;
+        }
+        else
+        {
+            bin = (int)index;
+        }
+    }
+    a_histogram[bin]++;
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,330 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CHapticSchedulerH
+#define CHapticSchedulerH
+//------------------------------------------------------------------------------
+#include "devices/CGenericHapticDevice.h"
+#include "system/CMutex.h"
+#include "system/CThread.h"
+#include "system/CTripleBuffer.h"
+#include "timers/CPrecisionClock.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CHapticScheduler.h
+
+    \brief
+    Implements a scheduler that runs one real-time haptic loop per device.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Number of bins of the jitter and duration histograms.
+const int C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE = 100;
+
+//! Time (in seconds) spent busy-waiting before the start of each cycle.
+const double C_HAPTIC_SCHEDULER_SPIN_TIME = 0.0002;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/*!
+    Defines the callback executed at every cycle of a haptic loop. The callback
+    receives the device handled by the loop, the time elapsed since the
+    previous cycle (in seconds), and the user data passed to
+    cHapticScheduler::addDevice().
+*/
+//------------------------------------------------------------------------------
+typedef void (*cHapticSchedulerCallback)(cGenericHapticDevicePtr a_device,
+                                         const double a_timeStep,
+                                         void* a_userData);
+
+
+//==============================================================================
+/*!
+    \struct     cHapticSchedulerStatistics
+    \ingroup    devices
+
+    \brief
+    This structure holds the timing statistics of a haptic loop.
+
+    \details
+    The __jitter__ of a cycle is the delay between its scheduled start time
+    and the time at which the callback is actually invoked. The __duration__
+    of a cycle is the time spent inside the callback. A cycle __overruns__
+    when its callback returns after the start time of the next cycle.
+    Cycles that could not be started on time because of an overrun are
+    dropped and counted as __skipped__.\n
+
+    Both histograms cover the interval [0, 2 x period]. Each bin is
+    period / 50 wide, and the last bin also accumulates all values that
+    exceed two periods.
+*/
+//==============================================================================
+struct cHapticSchedulerStatistics
+{
+    //! Nominal period of the loop in seconds.
+    double m_period;
+
+    //! Number of cycles executed.
+    unsigned int m_numCycles;
+
+    //! Number of cycles whose callback returned after the next deadline.
+    unsigned int m_numOverruns;
+
+    //! Number of cycles dropped to recover from overruns.
+    unsigned int m_numSkippedCycles;
+
+    //! Mean jitter in seconds.
+    double m_meanJitter;
+
+    //! Maximum jitter in seconds.
+    double m_maxJitter;
+
+    //! Mean callback duration in seconds.
+    double m_meanDuration;
+
+    //! Maximum callback duration in seconds.
+    double m_maxDuration;
+
+    //! Histogram of jitter values.
+    unsigned int m_jitterHistogram[C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE];
+
+    //! Histogram of callback durations.
+    unsigned int m_durationHistogram[C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE];
+
+    //! This method clears all counters and histograms.
+    void reset()
+    {
+        m_numCycles = 0;
+        m_numOverruns = 0;
+        m_numSkippedCycles = 0;
+        m_meanJitter = 0.0;
+        m_maxJitter = 0.0;
+        m_meanDuration = 0.0;
+        m_maxDuration = 0.0;
+        for (int i=0; i<C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE; i++)
+        {
+            m_jitterHistogram[i] = 0;
+            m_durationHistogram[i] = 0;
+        }
+    }
+
+    //! This method returns the width of a histogram bin in seconds.
+    double getHistogramBinWidth() const { return (2.0 * m_period / (double)C_HAPTIC_SCHEDULER_HISTOGRAM_SIZE); }
+
+    //! This method returns the time value (in seconds) at the lower bound of the n-th histogram bin.
+    double getHistogramBinTime(const int a_index) const { return ((double)a_index * getHistogramBinWidth()); }
+
+    //! This method returns the value below which a given fraction (0.0 - 1.0) of the recorded jitter values fall.
+    double getJitterPercentile(const double a_fraction) const { return (computePercentile(m_jitterHistogram, a_fraction)); }
+
+    //! This method returns the value below which a given fraction (0.0 - 1.0) of the recorded durations fall.
+    double getDurationPercentile(const double a_fraction) const { return (computePercentile(m_durationHistogram, a_fraction)); }
+
+    //! This method returns the upper bound of the histogram bin containing a given fraction of all samples.
+    double computePercentile(const unsigned int* a_histogram, const double a_fraction) const;
+};
+
+
+//==============================================================================
+/*!
+    \class      cHapticScheduler
+    \ingroup    devices
+
+    \brief
+    This class implements a scheduler that runs one haptic loop per device.
+
+    \details
+    Instead of writing its own `while(simulationRunning)` loop, an application
+    registers a callback for each haptic device by calling addDevice(). When
+    start() is called, the scheduler creates one thread per device with
+    haptic priority, pins it to its own processor core when possible, and
+    invokes the callback at the requested rate using absolute deadlines.
+    Each cycle is timed with cPrecisionClock and the results are accumulated
+    in a cHapticSchedulerStatistics structure, which the application can read
+    at any time from another thread by calling getStatistics(). The loop 
+    publishes its statistics through a \ref cTripleBuffer at the end of every
+    cycle, so that reading them never blocks the haptic thread.\n
+
+    The scheduler does not open or close devices; this remains the
+    responsibility of the application, typically inside its callback or
+    before calling start().
+*/
+//==============================================================================
+class cHapticScheduler
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cHapticScheduler.
+    cHapticScheduler();
+
+    //! Destructor of cHapticScheduler.
+    virtual ~cHapticScheduler();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method registers a device and the callback that updates it. It returns the index of the new loop, or -1 on failure.
+    int addDevice(cGenericHapticDevicePtr a_device,
+                  cHapticSchedulerCallback a_callback,
+                  void* a_userData = NULL,
+                  const double a_frequency = 1000.0,
+                  const int a_core = -1);
+
+    //! This method returns the number of loops registered with the scheduler.
+    unsigned int getNumDevices() const { return ((unsigned int)(m_loops.size())); }
+
+    //! This method starts all haptic loops.
+    bool start();
+
+    //! This method requests all haptic loops to terminate and waits until they have exited.
+    void stop();
+
+    //! This method returns __true__ if the haptic loops are running, __false__ otherwise.
+    bool isRunning() const { return (m_running); }
+
+    //! This method returns a copy of the timing statistics of the n-th loop.
+    bool getStatistics(cHapticSchedulerStatistics& a_statistics, const unsigned int a_index = 0);
+
+    //! This method clears the timing statistics of the n-th loop.
+    void resetStatistics(const unsigned int a_index = 0);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED TYPES:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! State of a haptic loop.
+    struct cHapticSchedulerLoop
+    {
+        //! Haptic device updated by the loop.
+        cGenericHapticDevicePtr m_device;
+
+        //! Callback executed at every cycle.
+        cHapticSchedulerCallback m_callback;
+
+        //! User data passed to the callback.
+        void* m_userData;
+
+        //! Nominal period of the loop in seconds.
+        double m_period;
+
+        //! Processor core to which the loop is pinned (-1 if not pinned).
+        int m_core;
+
+        //! Thread executing the loop.
+        cThread m_thread;
+
+        //! If __true__, the loop keeps running.
+        volatile bool m_running;
+
+        //! Timing statistics, only accessed by the thread executing the loop.
+        cHapticSchedulerStatistics m_statistics;
+
+        //! Copies of the timing statistics published at the end of every cycle.
+        cTripleBuffer<cHapticSchedulerStatistics> m_publishedStatistics;
+
+        //! Mutex serializing readers of the published statistics. It is never acquired by the loop.
+        cMutex m_readMutex;
+
+        //! If __true__, the loop clears its statistics at the beginning of the next cycle.
+        std::atomic<bool> m_resetRequested;
+    };
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method executes a haptic loop. It is the entry point of every scheduler thread.
+    static void loop(void* a_loop);
+
+    //! This method waits until a given time on the clock of a haptic loop.
+    static void waitUntil(const cPrecisionClock& a_clock, const double a_time);
+
+    //! This method clears the statistics of a loop and publishes them. It must only be called by the thread owning the loop statistics.
+    static void clearStatistics(cHapticSchedulerLoop* a_loop);
+
+    //! This method adds a sample to a histogram.
+    static void addHistogramSample(unsigned int* a_histogram, const double a_value, const double a_binWidth);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Haptic loops handled by the scheduler.
+    std::vector<cHapticSchedulerLoop*> m_loops;
+
+    //! If __true__, the haptic loops are running.
+    bool m_running;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,471 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "devices/CSimulatedDevice.h"
+//------------------------------------------------------------------------------
+#include <cstdio>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cSimulatedDevice. The specifications are those of a
+    generic desktop device.
+*/
+//==============================================================================
+cSimulatedDevice::cSimulatedDevice()
+{
+    m_deviceReady = false;
+
+    // device specifications
+    m_specifications.m_model                         = C_HAPTIC_DEVICE_VIRTUAL;
+    m_specifications.m_manufacturerName              = "CHAI3D";
+    m_specifications.m_modelName                     = "Simulated Device";
+    m_specifications.m_maxLinearForce                = 5.0;     // [N]
+    m_specifications.m_maxAngularTorque              = 0.2;     // [N*m]
+    m_specifications.m_maxGripperForce               = 3.0;     // [N]
+    m_specifications.m_maxLinearStiffness            = 1000.0;  // [N/m]
+    m_specifications.m_maxAngularStiffness           = 1.0;     // [N*m/Rad]
+    m_specifications.m_maxGripperLinearStiffness     = 1000;    // [N*m]
+    m_specifications.m_workspaceRadius               = 0.2;     // [m]
+    m_specifications.m_gripperMaxAngleRad            = cDegToRad(30.0);
+    m_specifications.m_maxLinearDamping              = 20.0;    // [N/(m/s)]
+    m_specifications.m_maxAngularDamping             = 0.0;     // [N*m/(Rad/s)]
+    m_specifications.m_maxGripperAngularDamping      = 0.0;     // [N*m/(Rad/s)]
+    m_specifications.m_sensedPosition                = true;
+    m_specifications.m_sensedRotation                = true;
+    m_specifications.m_sensedGripper                 = true;
+    m_specifications.m_actuatedPosition              = true;
+    m_specifications.m_actuatedRotation              = true;
+    m_specifications.m_actuatedGripper               = true;
+    m_specifications.m_leftHand                      = true;
+    m_specifications.m_rightHand                     = true;
+
+    // trajectory
+    m_timeStep = 0.001;
+    m_index = 0;
+    m_loop = false;
+
+    // the simulated device is always available
+    m_deviceAvailable = true;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cSimulatedDevice.
+*/
+//==============================================================================
+cSimulatedDevice::~cSimulatedDevice()
+{
+    close();
+}
+
+
+//==============================================================================
+/*!
+    This method opens a connection to the simulated device.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::open()
+{
+    m_deviceReady = true;
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method closes the connection to the simulated device.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::close()
+{
+    m_deviceReady = false;
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method calibrates the simulated device. No calibration is required.
+
+    \param  a_forceCalibration  Unused.
+
+    \return __true__ if the device is ready, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::calibrate(bool a_forceCalibration)
+{
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the position of the device at the current sample of
+    the trajectory.
+
+    \param  a_position  Return value.
+
+    \return __true__ if the device is ready, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::getPosition(cVector3d& a_position)
+{
+    a_position = getCurrentState().m_position;
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the orientation of the device at the current sample
+    of the trajectory.
+
+    \param  a_rotation  Return value.
+
+    \return __true__ if the device is ready, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::getRotation(cMatrix3d& a_rotation)
+{
+    a_rotation = getCurrentState().m_rotation;
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the gripper angle at the current sample of the
+    trajectory.
+
+    \param  a_angle  Return value.
+
+    \return __true__ if the device is ready, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::getGripperAngleRad(double& a_angle)
+{
+    a_angle = getCurrentState().m_gripperAngle;
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the status of the user switches at the current
+    sample of the trajectory.
+
+    \param  a_userSwitches  Return value.
+
+    \return __true__ if the device is ready, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::getUserSwitches(unsigned int& a_userSwitches)
+{
+    a_userSwitches = getCurrentState().m_userSwitches;
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method stores the force, torque and gripper force sent to the
+    simulated device. They can be read back with getForce(), getTorque() and
+    getGripperForce().
+
+    \param  a_force         Force command.
+    \param  a_torque        Torque command.
+    \param  a_gripperForce  Gripper force command.
+
+    \return __true__ if the device is ready, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::setForceAndTorqueAndGripperForce(const cVector3d& a_force,
+                                                        const cVector3d& a_torque,
+                                                        double a_gripperForce)
+{
+    m_prevForce = a_force;
+    m_prevTorque = a_torque;
+    m_prevGripperForce = a_gripperForce;
+
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method removes all samples of the trajectory, rewinds the device
+    and resets its velocities.
+*/
+//==============================================================================
+void cSimulatedDevice::clearTrajectory()
+{
+    m_trajectory.clear();
+    setIndex(0);
+}
+
+
+//==============================================================================
+/*!
+    This method loads a trajectory from a text file. Each line describes one
+    sample with 14 values separated by spaces: the position (3 values), the
+    rotation matrix (9 values, row by row), the gripper angle, and the user
+    switches. Lines starting with '#' are ignored, except for a line of the
+    form "# timestep <value>", which sets the time step of the trajectory.
+
+    \param  a_filename  Name of the file.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::loadTrajectory(const std::string& a_filename)
+{
+    FILE* file = fopen(a_filename.c_str(), "r");
+    if (file == NULL)
+    {
+        return (C_ERROR);
+    }
+
+    std::vector<cSimulatedDeviceState> trajectory;
+    bool result = C_SUCCESS;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        // comments
+        if (line[0] == '#')
+        {
+            double timeStep;
+            if (sscanf(line, "# timestep %lf", &timeStep) == 1)
+            {
+                setTimeStep(timeStep);
+            }
+            continue;
+        }
+
+        // samples
+        double v[13];
+        unsigned int userSwitches;
+        int numValues = sscanf(line, "%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %u",
+                               &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+                               &v[7], &v[8], &v[9], &v[10], &v[11], &v[12], &userSwitches);
+        if (numValues <= 0)
+        {
+            continue;
+        }
+        if (numValues != 14)
+        {
+            result = C_ERROR;
+            break;
+        }
+
+        cSimulatedDeviceState state;
+        state.m_position.set(v[0], v[1], v[2]);
+        state.m_rotation.set(v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10], v[11]);
+        state.m_gripperAngle = v[12];
+        state.m_userSwitches = userSwitches;
+        trajectory.push_back(state);
+    }
+
+    fclose(file);
+
+    if (result)
+    {
+        m_trajectory = trajectory;
+        setIndex(0);
+    }
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method saves the trajectory to a text file, in the format read by
+    loadTrajectory().
+
+    \param  a_filename  Name of the file.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cSimulatedDevice::saveTrajectory(const std::string& a_filename)
+{
+    FILE* file = fopen(a_filename.c_str(), "w");
+    if (file == NULL)
+    {
+        return (C_ERROR);
+    }
+
+    fprintf(file, "# timestep %.17g\n", m_timeStep);
+    fprintf(file, "# x y z r00 r01 r02 r10 r11 r12 r20 r21 r22 gripper switches\n");
+    for (unsigned int i=0; i<m_trajectory.size(); i++)
+    {
+        const cSimulatedDeviceState& state = m_trajectory[i];
+        const cMatrix3d& r = state.m_rotation;
+        fprintf(file, "%.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %.17g %u\n",
+                state.m_position(0), state.m_position(1), state.m_position(2),
+                r(0,0), r(0,1), r(0,2), r(1,0), r(1,1), r(1,2), r(2,0), r(2,1), r(2,2),
+                state.m_gripperAngle, state.m_userSwitches);
+    }
+
+    bool result = (ferror(file) == 0);
+    fclose(file);
+
+    return (result ? C_SUCCESS : C_ERROR);
+}
+
+
+//==============================================================================
+/*!
+    This method moves the device to the next sample of the trajectory, and
+    computes its velocities by finite differences. Once the end of the
+    trajectory has been reached, the device either restarts from the first
+    sample (see setLoop()) or stays at the last sample with zero velocity.
+
+    \return __true__ if the device has moved, __false__ if the end of the trajectory has been reached.
+*/
+//==============================================================================
+bool cSimulatedDevice::step()
+{
+    unsigned int numStates = (unsigned int)(m_trajectory.size());
+
+    // end of trajectory
+    if (m_index + 1 >= numStates)
+    {
+        if (m_loop && (numStates > 0))
+        {
+            setIndex(0);
+            return (true);
+        }
+
+        m_linearVelocity.zero();
+        m_angularVelocity.zero();
+        m_gripperAngularVelocity = 0.0;
+        return (false);
+    }
+
+    const cSimulatedDeviceState& state0 = m_trajectory[m_index];
+    const cSimulatedDeviceState& state1 = m_trajectory[m_index + 1];
+    m_index++;
+
+    // linear velocity
+    m_linearVelocity = (1.0 / m_timeStep) * (state1.m_position - state0.m_position);
+
+    // angular velocity, from the rotation between both samples. The axis
+    // scaled by the sine of the angle is given by the antisymmetric part of
+    // the rotation matrix, which remains accurate for small rotations.
+    cMatrix3d r = cMul(cTranspose(state0.m_rotation), state1.m_rotation);
+    cVector3d axis(0.5 * (r(2,1) - r(1,2)), 0.5 * (r(0,2) - r(2,0)), 0.5 * (r(1,0) - r(0,1)));
+    double sinAngle = axis.length();
+    double angle = atan2(sinAngle, 0.5 * (r(0,0) + r(1,1) + r(2,2) - 1.0));
+    if (sinAngle > C_SMALL)
+    {
+        m_angularVelocity = (angle / (sinAngle * m_timeStep)) * cMul(state0.m_rotation, axis);
+    }
+    else
+    {
+        m_angularVelocity.zero();
+    }
+
+    // gripper angular velocity
+    m_gripperAngularVelocity = (state1.m_gripperAngle - state0.m_gripperAngle) / m_timeStep;
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method moves the device to a sample of the trajectory and resets
+    its velocities.
+
+    \param  a_index  Index of the sample.
+*/
+//==============================================================================
+void cSimulatedDevice::setIndex(const unsigned int a_index)
+{
+    m_index = a_index;
+    m_linearVelocity.zero();
+    m_angularVelocity.zero();
+    m_gripperAngularVelocity = 0.0;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the current sample of the trajectory, or a sample
+    at the origin if the trajectory is empty.
+
+    \return Current sample.
+*/
+//==============================================================================
+cSimulatedDeviceState cSimulatedDevice::getCurrentState() const
+{
+    if (m_index < m_trajectory.size())
+    {
+        return (m_trajectory[m_index]);
+    }
+    else if (m_trajectory.size() > 0)
+    {
+        return (m_trajectory.back());
+    }
+    else
+    {
+        return (cSimulatedDeviceState());
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
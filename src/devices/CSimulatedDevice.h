@@ -0,0 +1,255 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CSimulatedDeviceH
+#define CSimulatedDeviceH
+//------------------------------------------------------------------------------
+#include "devices/CGenericHapticDevice.h"
+//------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CSimulatedDevice.h
+
+    \brief
+    Implements a simulated haptic device replaying a trajectory.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cSimulatedDevice;
+typedef std::shared_ptr<cSimulatedDevice> cSimulatedDevicePtr;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \struct     cSimulatedDeviceState
+    \ingroup    devices
+
+    \brief
+    This structure stores one sample of the trajectory of a cSimulatedDevice.
+*/
+//==============================================================================
+struct cSimulatedDeviceState
+{
+    //! Position of the device in meters.
+    cVector3d m_position;
+
+    //! Orientation of the device end-effector.
+    cMatrix3d m_rotation;
+
+    //! Gripper angle in radians.
+    double m_gripperAngle;
+
+    //! Status of the user switches.
+    unsigned int m_userSwitches;
+
+    //! Constructor of cSimulatedDeviceState.
+    cSimulatedDeviceState() : m_position(0.0, 0.0, 0.0), m_gripperAngle(0.0), m_userSwitches(0) { m_rotation.identity(); }
+};
+
+
+//==============================================================================
+/*!
+    \class      cSimulatedDevice
+    \ingroup    devices
+
+    \brief
+    This class implements a simulated haptic device replaying a trajectory.
+
+    \details
+    cSimulatedDevice follows the structure of the cMyCustomDevice template,
+    but instead of communicating with hardware, it replays a trajectory of
+    positions, orientations, gripper angles and user switches sampled at a
+    fixed time step. The trajectory can be generated by the application,
+    recorded from another device with addState(), and saved to or loaded
+    from a text file. \n
+
+    The device does not depend on time: it only moves to the next sample
+    when step() is called, and velocities are computed by finite differences
+    between consecutive samples. Forces sent to the device are stored and
+    can be read back with getForce(), getTorque() and getGripperForce().
+    A haptic loop driven by a simulated device therefore produces the same
+    results on every run, which makes the device suitable for benchmarks
+    and regression tests that must run without hardware.
+*/
+//==============================================================================
+class cSimulatedDevice : public cGenericHapticDevice
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cSimulatedDevice.
+    cSimulatedDevice();
+
+    //! Destructor of cSimulatedDevice.
+    virtual ~cSimulatedDevice();
+
+    //! Shared cSimulatedDevice allocator.
+    static cSimulatedDevicePtr create() { return (std::make_shared<cSimulatedDevice>()); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method opens a connection to the haptic device.
+    virtual bool open();
+
+    //! This method closes the connection to the haptic device.
+    virtual bool close();
+
+    //! This method calibrates the haptic device.
+    virtual bool calibrate(bool a_forceCalibration = false);
+
+    //! This method returns the position of the device.
+    virtual bool getPosition(cVector3d& a_position);
+
+    //! This method returns the orientation frame of the device end-effector.
+    virtual bool getRotation(cMatrix3d& a_rotation);
+
+    //! This method returns the gripper angle in radian [rad].
+    virtual bool getGripperAngleRad(double& a_angle);
+
+    //! This method returns the status of all user switches [__true__ = __ON__ / __false__ = __OFF__].
+    virtual bool getUserSwitches(unsigned int& a_userSwitches);
+
+    //! This method sends a force [N] and a torque [N*m] and gripper force [N] to the haptic device.
+    virtual bool setForceAndTorqueAndGripperForce(const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - TRAJECTORY:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the time step between two samples of the trajectory.
+    void setTimeStep(const double a_timeStep) { m_timeStep = cMax(a_timeStep, C_TINY); }
+
+    //! This method returns the time step between two samples of the trajectory.
+    double getTimeStep() const { return (m_timeStep); }
+
+    //! This method appends a sample to the trajectory.
+    void addState(const cSimulatedDeviceState& a_state) { m_trajectory.push_back(a_state); }
+
+    //! This method removes all samples of the trajectory and rewinds the device.
+    void clearTrajectory();
+
+    //! This method returns the number of samples of the trajectory.
+    unsigned int getNumStates() const { return ((unsigned int)(m_trajectory.size())); }
+
+    //! This method returns a sample of the trajectory.
+    const cSimulatedDeviceState& getState(const unsigned int a_index) const { return (m_trajectory[a_index]); }
+
+    //! This method loads a trajectory from a text file.
+    bool loadTrajectory(const std::string& a_filename);
+
+    //! This method saves the trajectory to a text file.
+    bool saveTrajectory(const std::string& a_filename);
+
+    //! This method enables or disables restarting the trajectory once its end has been reached.
+    void setLoop(const bool a_loop) { m_loop = a_loop; }
+
+    //! This method returns __true__ if the trajectory restarts once its end has been reached.
+    bool getLoop() const { return (m_loop); }
+
+    //! This method moves the device to the next sample of the trajectory.
+    bool step();
+
+    //! This method moves the device to a sample of the trajectory. Velocities are reset.
+    void setIndex(const unsigned int a_index);
+
+    //! This method returns the index of the current sample of the trajectory.
+    unsigned int getIndex() const { return (m_index); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns the current sample of the trajectory.
+    cSimulatedDeviceState getCurrentState() const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Samples of the trajectory.
+    std::vector<cSimulatedDeviceState> m_trajectory;
+
+    //! Time step between two samples in seconds.
+    double m_timeStep;
+
+    //! Index of the current sample.
+    unsigned int m_index;
+
+    //! If __true__, the trajectory restarts once its end has been reached.
+    bool m_loop;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -114,6 +114,9 @@ cCamera::cCamera(cWorld* a_parentWorld)
     // disable multipass transparency rendering by default
     m_useMultipassTransparency = false;
 
+    // traverse the scene graph for every rendering pass, preserving the order of objects
+    m_useRenderQueue = false;
+
     // reset display status
     m_markForUpdate = false;
 
@@ -1092,6 +1095,11 @@ void cCamera::renderView(const int a_windowWidth,
     //-----------------------------------------------------------------------
     // (4) RENDER THE ENTIRE SCENE
     //-----------------------------------------------------------------------
+
+    // reset culling statistics
+    m_numDrawnObjects.clear();
+    m_numCulledObjects.clear();
+
     for (unsigned int i=0; i<numStereoPass; i++)
     {
         //-------------------------------------------------------------------
@@ -1405,6 +1413,23 @@ void cCamera::renderView(const int a_windowWidth,
         // rendering options
         cRenderOptions options;
 
+        // skip objects located outside of the view frustum
+        if (m_parentWorld != NULL)
+        {
+            options.m_frustumCulling = m_parentWorld->getUseFrustumCulling();
+            options.m_frustumMatrix = m_projectionMatrix * m_modelViewMatrix;
+        }
+
+        // traverse the world once for all rendering passes. Object positions
+        // have already been stored when shadow maps are used.
+        if ((m_parentWorld != NULL) && m_useRenderQueue)
+        {
+            options.m_storeObjectPositions  = !useShadowCasting;
+            options.m_markForUpdate         = m_markForUpdate;
+            m_renderQueue.build(m_parentWorld, options);
+            m_renderQueue.sort(m_modelViewMatrix);
+        }
+
         if (m_parentWorld != NULL)
         {
             // optionally perform multiple rendering passes for transparency
@@ -1435,7 +1460,7 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_markForUpdate                         = m_markForUpdate;
 
                     // render 1st pass (opaque objects - shadowed regions)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
 
                     // setup rendering options
                     options.m_rendering_shadow                      = false;
@@ -1450,7 +1475,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1474,7 +1499,7 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_rendering_shadow                      = false;
 
                     // render 3rd pass (transparent objects - back faces only)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
 
                     // modify rendering options for third pass
                     options.m_render_opaque_objects_only            = false;
@@ -1484,7 +1509,7 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_shadow_light_level                    = 1.0 - m_parentWorld->getShadowIntensity();
 
                     // render 4th pass (transparent objects - front faces only - shadowed areas)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
                 
                     for(lst = m_parentWorld->m_shadowMaps.begin(); lst != m_parentWorld->m_shadowMaps.end(); ++lst)
                     {
@@ -1493,7 +1518,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1518,7 +1543,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1556,7 +1581,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render 1st pass (opaque objects - all faces)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
 
                     // modify rendering options
@@ -1567,7 +1592,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render 2nd pass (transparent objects - back faces only)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
 
                     // modify rendering options
@@ -1577,7 +1602,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render 3rd pass (transparent objects - front faces only)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
                 }
             }
@@ -1604,7 +1629,7 @@ void cCamera::renderView(const int a_windowWidth,
                     options.m_markForUpdate                         = m_markForUpdate;
 
                     // render 1st pass (opaque objects - all faces - shadowed regions)
-                    m_parentWorld->renderSceneGraph(options);
+                    renderWorld(options);
 
                     // setup rendering options
                     options.m_rendering_shadow                      = false;
@@ -1619,7 +1644,7 @@ void cCamera::renderView(const int a_windowWidth,
 
                         if (m_parentWorld != NULL)
                         {
-                            m_parentWorld->renderSceneGraph(options);
+                            renderWorld(options);
                         }
 
                         // restore states
@@ -1640,7 +1665,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render 3rd pass (transparent objects - all faces)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options);
+                        renderWorld(options);
                     }
                 }
 
@@ -1668,7 +1693,7 @@ void cCamera::renderView(const int a_windowWidth,
                     // render single pass (all objects)
                     if (m_parentWorld != NULL)
                     {
-                        m_parentWorld->renderSceneGraph(options); 
+                        renderWorld(options);
                     }
                 }
             }
@@ -1881,6 +1906,39 @@ void cCamera::renderLayer(cGenericObject* a_graph,
 }
 
 
+//==============================================================================
+/*!
+    This method renders the world for one rendering pass, either from the
+    render queue or by traversing the scene graph, and records the number of 
+    objects drawn and skipped by frustum culling during that pass.
+
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cCamera::renderWorld(cRenderOptions& a_options)
+{
+    if (m_parentWorld == NULL) { return; }
+
+    // reset counters
+    a_options.m_numDrawnObjects = 0;
+    a_options.m_numCulledObjects = 0;
+
+    // render world
+    if (m_useRenderQueue)
+    {
+        m_renderQueue.render(a_options);
+    }
+    else
+    {
+        m_parentWorld->renderSceneGraph(a_options);
+    }
+
+    // store counters
+    m_numDrawnObjects.push_back(a_options.m_numDrawnObjects);
+    m_numCulledObjects.push_back(a_options.m_numCulledObjects);
+}
+
+
 //==============================================================================
 /*!
     This method updates all display lists and textures to the GPU.
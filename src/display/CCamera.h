@@ -50,6 +50,7 @@
 #include "world/CGenericObject.h"
 #include "math/CMaths.h"
 #include "graphics/CImage.h"
+#include "world/CRenderQueue.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -352,6 +353,15 @@ public:
     //! This method returns __true__ if multipass rendering is enabled, __false__ otherwise.
     bool getUseMultipassTransparency() { return (m_useMultipassTransparency); }
 
+    //! This method enables or disables the render queue, which executes all rendering passes from a single traversal of the world. Disabled by default, since opaque objects are reordered by state.
+    void setUseRenderQueue(bool a_enabled) { m_useRenderQueue = a_enabled; }
+
+    //! This method returns __true__ if the render queue is enabled, __false__ otherwise.
+    bool getUseRenderQueue() const { return (m_useRenderQueue); }
+
+    //! This method returns the render queue built during the last call to renderView().
+    const cRenderQueue* getRenderQueue() const { return (&m_renderQueue); }
+
     //! This method returns the width of the current window display in pixels.
     int getDisplayWidth() { return (m_lastDisplayWidth); }
 
@@ -361,6 +371,15 @@ public:
     //! This method resets textures and display lists for the world associated with this camera.
     void updateGPU();
 
+    //! This method returns the number of passes through the world performed by the last call to renderView().
+    unsigned int getNumRenderPasses() const { return ((unsigned int)(m_numDrawnObjects.size())); }
+
+    //! This method returns the number of objects rendered during a pass of the last call to renderView().
+    unsigned int getNumDrawnObjects(const unsigned int a_pass) const { return (m_numDrawnObjects[a_pass]); }
+
+    //! This method returns the number of objects skipped by frustum culling during a pass of the last call to renderView().
+    unsigned int getNumCulledObjects(const unsigned int a_pass) const { return (m_numCulledObjects[a_pass]); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - STEREO:
@@ -510,6 +529,18 @@ protected:
     //! Optionally attached audio device.
     cAudioDevice* m_audioDevice;
 
+    //! If __true__, then rendering passes are executed from a render queue.
+    bool m_useRenderQueue;
+
+    //! Render queue collecting the objects of the world.
+    cRenderQueue m_renderQueue;
+
+    //! Number of objects rendered during each pass of the last call to renderView().
+    std::vector<unsigned int> m_numDrawnObjects;
+
+    //! Number of objects skipped by frustum culling during each pass of the last call to renderView().
+    std::vector<unsigned int> m_numCulledObjects;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -519,6 +550,9 @@ protected:
 
     //! Renders a 2D layer within this camera's view.
     void renderLayer(cGenericObject* a_graph, int a_width, int a_height);
+
+    //! This method renders one pass through the world and records the number of drawn and culled objects.
+    void renderWorld(cRenderOptions& a_options);
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,790 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "files/CFileModelCMESH.h"
+#include "files/CFileModelOBJ.h"
+#include "files/CFileModelSTL.h"
+#include "collisions/CCollisionAABB.h"
+#include "materials/CTexture2d.h"
+#include "system/CMappedFile.h"
+#include "system/CString.h"
+//------------------------------------------------------------------------------
+#include "stdint.h"
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <vector>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+bool g_meshLoaderUseCache = false;
+string g_meshLoaderCacheDirectory = "";
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// identifier found at the beginning of CMESH files
+static const char C_CMESH_MAGIC[8] = { 'C', 'M', 'E', 'S', 'H', 0, 0, 0 };
+
+// version of the CMESH format
+static const uint32_t C_CMESH_VERSION = 1;
+
+// value used to detect files written with a different byte order
+static const uint32_t C_CMESH_BYTE_ORDER = 0x01020304;
+
+// flags describing a mesh and the data stored for it
+enum cCMESHFlags
+{
+    C_CMESH_USE_MATERIAL        = 0x00001,
+    C_CMESH_USE_TEXTURE         = 0x00002,
+    C_CMESH_USE_VERTEX_COLORS   = 0x00004,
+    C_CMESH_USE_TRANSPARENCY    = 0x00008,
+    C_CMESH_USE_CULLING         = 0x00010,
+    C_CMESH_NORMAL_DATA         = 0x00100,
+    C_CMESH_TEXCOORD_DATA       = 0x00200,
+    C_CMESH_COLOR_DATA          = 0x00400,
+    C_CMESH_TANGENT_DATA        = 0x00800,
+    C_CMESH_BITANGENT_DATA      = 0x01000,
+    C_CMESH_USER_DATA           = 0x02000,
+    C_CMESH_MATERIAL            = 0x10000,
+    C_CMESH_COLLISION_TREE      = 0x20000
+};
+
+// description of the file from which a CMESH file was created
+struct cCMESHSource
+{
+    string m_filename;
+    uint64_t m_size;
+    int64_t m_time;
+    uint32_t m_loaderOptions;
+    double m_loaderTolerance;
+};
+
+// node of an AABB collision tree, as stored in a CMESH file
+struct cCMESHNode
+{
+    double m_min[3];
+    double m_max[3];
+    int32_t m_nodeType;
+    int32_t m_leftSubTree;
+    int32_t m_rightSubTree;
+    int32_t m_reserved;
+};
+
+// vertex arrays are written and read in bulk
+static_assert(sizeof(cVector3d) == 3 * sizeof(double), "unexpected layout of cVector3d");
+
+// writes the content of a CMESH file
+struct cCMESHWriter
+{
+    cCMESHWriter(const string& a_filename) : m_file(a_filename.c_str(), ios::binary) {}
+
+    void write(const void* a_data, size_t a_size)
+    {
+        if (a_size > 0) { m_file.write((const char*)(a_data), a_size); }
+    }
+
+    template <typename T> void write(const T& a_value) { write(&a_value, sizeof(T)); }
+
+    template <typename T> void writeArray(const vector<T>& a_values)
+    {
+        if (a_values.size() > 0) { write(&a_values[0], a_values.size() * sizeof(T)); }
+    }
+
+    void writeString(const string& a_value)
+    {
+        uint32_t length = (uint32_t)(a_value.size());
+        write(length);
+        write(a_value.data(), length);
+    }
+
+    ofstream m_file;
+};
+
+// reads the content of a CMESH file and checks that it does not read past its end
+struct cCMESHReader
+{
+    cCMESHReader(const char* a_data, size_t a_size) : m_pos(a_data), m_end(a_data + a_size) {}
+
+    size_t getRemaining() const { return ((size_t)(m_end - m_pos)); }
+
+    bool read(void* a_data, size_t a_size)
+    {
+        if (getRemaining() < a_size) { return (false); }
+        if (a_size > 0) { memcpy(a_data, m_pos, a_size); }
+        m_pos += a_size;
+        return (true);
+    }
+
+    template <typename T> bool read(T& a_value) { return (read(&a_value, sizeof(T))); }
+
+    template <typename T> bool readArray(vector<T>& a_values)
+    {
+        if (a_values.size() == 0) { return (true); }
+        return (read(&a_values[0], a_values.size() * sizeof(T)));
+    }
+
+    bool readString(string& a_value)
+    {
+        uint32_t length;
+        if (!read(length) || (getRemaining() < length)) { return (false); }
+        a_value.assign(m_pos, length);
+        m_pos += length;
+        return (true);
+    }
+
+    const char* m_pos;
+    const char* m_end;
+};
+
+
+//==============================================================================
+/*!
+    This function describes the source file of a CMESH file by its size, 
+    modification time, and the options of the loader that reads it.
+
+    \param  a_filename  Filename of the source file.
+    \param  a_source    Returned description.
+
+    \return __true__ if the file exists, __false__ otherwise.
+*/
+//==============================================================================
+static bool cGetSourceCMESH(const string& a_filename, cCMESHSource& a_source)
+{
+#if defined(WIN32) | defined(WIN64)
+    struct _stat64 info;
+    if (_stat64(a_filename.c_str(), &info) != 0) { return (false); }
+#else
+    struct stat info;
+    if (stat(a_filename.c_str(), &info) != 0) { return (false); }
+#endif
+
+    a_source.m_filename = a_filename;
+    a_source.m_size = (uint64_t)(info.st_size);
+    a_source.m_time = (int64_t)(info.st_mtime);
+    a_source.m_loaderOptions = 0;
+    a_source.m_loaderTolerance = 0.0;
+
+    // options of the loaders that change the loaded model
+    string fileType = cStrToLower(cGetFileExtension(a_filename));
+    if (fileType == "obj")
+    {
+        a_source.m_loaderOptions = 0x01;
+        if (g_objLoaderShouldGenerateExtraVertices) { a_source.m_loaderOptions |= 0x02; }
+        if (g_objLoaderWeldVertices) 
+        {
+            a_source.m_loaderOptions |= 0x04;
+            a_source.m_loaderTolerance = g_objLoaderWeldingTolerance;
+        }
+    }
+    else if (fileType == "stl")
+    {
+        a_source.m_loaderOptions = 0x10;
+        if (g_stlLoaderWeldVertices) 
+        {
+            a_source.m_loaderOptions |= 0x20;
+            a_source.m_loaderTolerance = g_stlLoaderWeldingTolerance;
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This function writes a mesh to a CMESH file.
+
+    \param  a_writer  CMESH file.
+    \param  a_mesh    Mesh.
+*/
+//==============================================================================
+static void cWriteMeshCMESH(cCMESHWriter& a_writer, cMesh* a_mesh)
+{
+    cVertexArrayPtr vertices = a_mesh->m_vertices;
+    cTriangleArrayPtr triangles = a_mesh->m_triangles;
+    cCollisionAABB* tree = dynamic_cast<cCollisionAABB*>(a_mesh->getCollisionDetector());
+
+    // get name of texture image
+    string textureFilename = "";
+    if ((a_mesh->m_texture != nullptr) && (a_mesh->m_texture->m_image != nullptr))
+    {
+        textureFilename = a_mesh->m_texture->m_image->getFilename();
+    }
+
+    // write flags
+    uint32_t flags = 0;
+    if (a_mesh->getUseMaterial())           { flags |= C_CMESH_USE_MATERIAL; }
+    if (a_mesh->getUseTexture())            { flags |= C_CMESH_USE_TEXTURE; }
+    if (a_mesh->getUseVertexColors())       { flags |= C_CMESH_USE_VERTEX_COLORS; }
+    if (a_mesh->getUseTransparency())       { flags |= C_CMESH_USE_TRANSPARENCY; }
+    if (a_mesh->getUseCulling())            { flags |= C_CMESH_USE_CULLING; }
+    if (vertices->getUseNormalData())       { flags |= C_CMESH_NORMAL_DATA; }
+    if (vertices->getUseTexCoordData())     { flags |= C_CMESH_TEXCOORD_DATA; }
+    if (vertices->getUseColorData())        { flags |= C_CMESH_COLOR_DATA; }
+    if (vertices->getUseTangentData())      { flags |= C_CMESH_TANGENT_DATA; }
+    if (vertices->getUseBitangentData())    { flags |= C_CMESH_BITANGENT_DATA; }
+    if (vertices->getUseUserData())         { flags |= C_CMESH_USER_DATA; }
+    if (a_mesh->m_material != nullptr)      { flags |= C_CMESH_MATERIAL; }
+    if (tree != NULL)                       { flags |= C_CMESH_COLLISION_TREE; }
+
+    a_writer.writeString(a_mesh->m_name);
+    a_writer.write(flags);
+
+    // write material
+    if (a_mesh->m_material != nullptr)
+    {
+        cMaterialPtr material = a_mesh->m_material;
+        cColorf* colors[4] = { &material->m_ambient, &material->m_diffuse, &material->m_specular, &material->m_emission };
+        for (int i=0; i<4; i++)
+        {
+            float color[4] = { colors[i]->getR(), colors[i]->getG(), colors[i]->getB(), colors[i]->getA() };
+            a_writer.write(color, sizeof(color));
+        }
+        a_writer.write((uint32_t)(material->getShininess()));
+    }
+
+    // write texture
+    a_writer.writeString(textureFilename);
+
+    // write vertices
+    uint32_t numVertices = vertices->getNumElements();
+    a_writer.write(numVertices);
+    a_writer.writeArray(vertices->m_localPos);
+    if (vertices->getUseNormalData())   { a_writer.writeArray(vertices->m_normal); }
+    if (vertices->getUseTexCoordData()) { a_writer.writeArray(vertices->m_texCoord); }
+    if (vertices->getUseColorData())
+    {
+        vector<float> colors(4 * numVertices);
+        for (unsigned int i=0; i<numVertices; i++)
+        {
+            colors[4*i+0] = vertices->m_color[i].getR();
+            colors[4*i+1] = vertices->m_color[i].getG();
+            colors[4*i+2] = vertices->m_color[i].getB();
+            colors[4*i+3] = vertices->m_color[i].getA();
+        }
+        a_writer.writeArray(colors);
+    }
+    if (vertices->getUseTangentData())   { a_writer.writeArray(vertices->m_tangent); }
+    if (vertices->getUseBitangentData()) { a_writer.writeArray(vertices->m_bitangent); }
+    if (vertices->getUseUserData())      { a_writer.writeArray(vertices->m_userData); }
+
+    // write triangles
+    uint32_t numTriangles = triangles->getNumElements();
+    a_writer.write(numTriangles);
+    a_writer.writeArray(triangles->m_indices);
+    vector<unsigned char> allocated(numTriangles);
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        allocated[i] = triangles->m_allocated[i] ? 1 : 0;
+    }
+    a_writer.writeArray(allocated);
+
+    // write collision tree
+    if (tree != NULL)
+    {
+        const vector<cCollisionAABBNode>& nodes = tree->getNodes();
+        uint32_t numNodes = (uint32_t)(nodes.size());
+
+        a_writer.write(tree->getRadius());
+        a_writer.write((uint32_t)(tree->getBuildMethod()));
+        a_writer.write((int32_t)(tree->getRootIndex()));
+        a_writer.write(numNodes);
+
+        vector<cCMESHNode> records(numNodes);
+        for (unsigned int i=0; i<numNodes; i++)
+        {
+            cCMESHNode& record = records[i];
+            for (int j=0; j<3; j++)
+            {
+                record.m_min[j] = nodes[i].m_bbox.m_min(j);
+                record.m_max[j] = nodes[i].m_bbox.m_max(j);
+            }
+            record.m_nodeType = (int32_t)(nodes[i].m_nodeType);
+            record.m_leftSubTree = nodes[i].m_leftSubTree;
+            record.m_rightSubTree = nodes[i].m_rightSubTree;
+            record.m_reserved = 0;
+        }
+        a_writer.writeArray(records);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This function reads a mesh from a CMESH file.
+
+    \param  a_reader  CMESH file.
+    \param  a_mesh    Mesh.
+
+    \return __true__ if the mesh is valid, __false__ otherwise.
+*/
+//==============================================================================
+static bool cReadMeshCMESH(cCMESHReader& a_reader, cMesh* a_mesh)
+{
+    cVertexArrayPtr vertices = a_mesh->m_vertices;
+    cTriangleArrayPtr triangles = a_mesh->m_triangles;
+
+    // read flags
+    uint32_t flags;
+    if (!a_reader.readString(a_mesh->m_name) || !a_reader.read(flags)) { return (false); }
+
+    // read material
+    if (flags & C_CMESH_MATERIAL)
+    {
+        float colors[16];
+        uint32_t shininess;
+        if (!a_reader.read(colors, sizeof(colors)) || !a_reader.read(shininess)) { return (false); }
+
+        cMaterialPtr material = a_mesh->m_material;
+        material->m_ambient.set(colors[0], colors[1], colors[2], colors[3]);
+        material->m_diffuse.set(colors[4], colors[5], colors[6], colors[7]);
+        material->m_specular.set(colors[8], colors[9], colors[10], colors[11]);
+        material->m_emission.set(colors[12], colors[13], colors[14], colors[15]);
+        material->setShininess(shininess);
+    }
+
+    // read texture
+    string textureFilename;
+    if (!a_reader.readString(textureFilename)) { return (false); }
+    bool useTexture = false;
+    if (textureFilename.length() > 0)
+    {
+        cTexture2dPtr texture = cTexture2d::create();
+        if (texture->loadFromFile(textureFilename))
+        {
+            a_mesh->setTexture(texture);
+            useTexture = ((flags & C_CMESH_USE_TEXTURE) != 0);
+        }
+    }
+
+    // read vertices
+    uint32_t numVertices;
+    if (!a_reader.read(numVertices)) { return (false); }
+    if (a_reader.getRemaining() / sizeof(cVector3d) < numVertices) { return (false); }
+
+    vertices->clear();
+    vertices->allocateData(numVertices,
+                           (flags & C_CMESH_NORMAL_DATA) != 0,
+                           (flags & C_CMESH_TEXCOORD_DATA) != 0,
+                           (flags & C_CMESH_COLOR_DATA) != 0,
+                           (flags & C_CMESH_TANGENT_DATA) != 0,
+                           (flags & C_CMESH_BITANGENT_DATA) != 0,
+                           (flags & C_CMESH_USER_DATA) != 0);
+
+    if (!a_reader.readArray(vertices->m_localPos)) { return (false); }
+    if (!a_reader.readArray(vertices->m_normal)) { return (false); }
+    if (!a_reader.readArray(vertices->m_texCoord)) { return (false); }
+    if (vertices->getUseColorData())
+    {
+        vector<float> colors(4 * numVertices);
+        if (!a_reader.readArray(colors)) { return (false); }
+        for (unsigned int i=0; i<numVertices; i++)
+        {
+            vertices->m_color[i].set(colors[4*i+0], colors[4*i+1], colors[4*i+2], colors[4*i+3]);
+        }
+    }
+    if (!a_reader.readArray(vertices->m_tangent)) { return (false); }
+    if (!a_reader.readArray(vertices->m_bitangent)) { return (false); }
+    if (!a_reader.readArray(vertices->m_userData)) { return (false); }
+
+    // read triangles
+    uint32_t numTriangles;
+    if (!a_reader.read(numTriangles)) { return (false); }
+    if (a_reader.getRemaining() / (3 * sizeof(uint32_t) + 1) < numTriangles) { return (false); }
+
+    triangles->clear();
+    triangles->m_indices.resize(3 * numTriangles);
+    if (!a_reader.readArray(triangles->m_indices)) { return (false); }
+    for (unsigned int i=0; i<3*numTriangles; i++)
+    {
+        if (triangles->m_indices[i] >= numVertices) { return (false); }
+    }
+
+    vector<unsigned char> allocated(numTriangles);
+    if (!a_reader.readArray(allocated)) { return (false); }
+    triangles->m_allocated.assign(numTriangles, true);
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (allocated[i] == 0) { triangles->removeTriangle(i); }
+    }
+
+    // read collision tree
+    if (flags & C_CMESH_COLLISION_TREE)
+    {
+        double radius;
+        uint32_t buildMethod;
+        int32_t rootIndex;
+        uint32_t numNodes;
+        if (!a_reader.read(radius) || !a_reader.read(buildMethod) || 
+            !a_reader.read(rootIndex) || !a_reader.read(numNodes))
+        {
+            return (false);
+        }
+        if (a_reader.getRemaining() / sizeof(cCMESHNode) < numNodes) { return (false); }
+
+        vector<cCollisionAABBNode> nodes(numNodes);
+        for (unsigned int i=0; i<numNodes; i++)
+        {
+            cCMESHNode record;
+            a_reader.read(record);
+            nodes[i].m_bbox.setValue(cVector3d(record.m_min[0], record.m_min[1], record.m_min[2]),
+                                     cVector3d(record.m_max[0], record.m_max[1], record.m_max[2]));
+            nodes[i].m_nodeType = (cAABBNodeType)(record.m_nodeType);
+            nodes[i].m_leftSubTree = record.m_leftSubTree;
+            nodes[i].m_rightSubTree = record.m_rightSubTree;
+        }
+
+        cCollisionAABB* tree = new cCollisionAABB();
+        if (!tree->initialize(triangles, radius, (cAABBBuildMethod)(buildMethod), nodes, rootIndex))
+        {
+            delete tree;
+            return (false);
+        }
+        a_mesh->deleteCollisionDetector();
+        a_mesh->setCollisionDetector(tree);
+    }
+
+    // set rendering options
+    a_mesh->setUseMaterial((flags & C_CMESH_USE_MATERIAL) != 0);
+    a_mesh->setUseTexture(useTexture);
+    a_mesh->setUseVertexColors((flags & C_CMESH_USE_VERTEX_COLORS) != 0);
+    a_mesh->setUseTransparency((flags & C_CMESH_USE_TRANSPARENCY) != 0);
+    a_mesh->setUseCulling((flags & C_CMESH_USE_CULLING) != 0);
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This function adds data to a checksum.
+
+    \param  a_checksum  Checksum.
+    \param  a_data      Data.
+    \param  a_size      Size of data in bytes.
+*/
+//==============================================================================
+static void cAddChecksumCMESH(unsigned long long& a_checksum, const void* a_data, size_t a_size)
+{
+    const unsigned long long prime = 0x100000001b3ULL;
+    const unsigned char* data = (const unsigned char*)(a_data);
+
+    while (a_size >= 8)
+    {
+        unsigned long long word;
+        memcpy(&word, data, 8);
+        a_checksum = (a_checksum ^ word) * prime;
+        a_checksum ^= (a_checksum >> 32);
+        data += 8;
+        a_size -= 8;
+    }
+    while (a_size > 0)
+    {
+        a_checksum = (a_checksum ^ *data) * prime;
+        data++;
+        a_size--;
+    }
+}
+
+//------------------------------------------------------------------------------
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function loads a CMESH file into a cMultiMesh structure.
+    If the operation succeeds, then the functions returns __true__ and the
+    meshes stored in the file are loaded into cMultiMesh, together with the
+    collision trees that had been built for them.
+    If the operation fails, then the function returns __false__. \n
+
+    If __a_sourceFilename__ is not empty, the file is only loaded if it was 
+    created from this source file, and if the size and modification time of
+    the source file and the options of its loader are unchanged.
+
+    \param  a_object          Multimesh object.
+    \param  a_filename        Filename.
+    \param  a_sourceFilename  Filename of the model file the CMESH file was created from.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cLoadFileCMESH(cMultiMesh* a_object, 
+                    const std::string& a_filename,
+                    const std::string& a_sourceFilename)
+{
+    // sanity check
+    if (a_object == NULL)
+        return (C_ERROR);
+
+    // map file
+    cMappedFile file;
+    if (!file.open(a_filename))
+        return (C_ERROR);
+
+    cCMESHReader reader(file.getData(), file.getSize());
+
+    // read header
+    char magic[8];
+    uint32_t version, byteOrder;
+    if (!reader.read(magic, sizeof(magic)) || (memcmp(magic, C_CMESH_MAGIC, sizeof(magic)) != 0) ||
+        !reader.read(version) || (version != C_CMESH_VERSION) ||
+        !reader.read(byteOrder) || (byteOrder != C_CMESH_BYTE_ORDER))
+    {
+        return (C_ERROR);
+    }
+
+    cCMESHSource source;
+    if (!reader.readString(source.m_filename) ||
+        !reader.read(source.m_size) ||
+        !reader.read(source.m_time) ||
+        !reader.read(source.m_loaderOptions) ||
+        !reader.read(source.m_loaderTolerance))
+    {
+        return (C_ERROR);
+    }
+
+    // check that the source file is unchanged
+    if (a_sourceFilename.length() > 0)
+    {
+        cCMESHSource current;
+        if (!cGetSourceCMESH(a_sourceFilename, current) ||
+            (source.m_filename != current.m_filename) ||
+            (source.m_size != current.m_size) ||
+            (source.m_time != current.m_time) ||
+            (source.m_loaderOptions != current.m_loaderOptions) ||
+            (source.m_loaderTolerance != current.m_loaderTolerance))
+        {
+            return (C_ERROR);
+        }
+    }
+
+    uint32_t flags, numMeshes;
+    if (!reader.read(flags) || !reader.read(numMeshes))
+    {
+        return (C_ERROR);
+    }
+
+    // set rendering options of the root before creating meshes, which store their own
+    a_object->deleteAllMeshes();
+    a_object->setUseMaterial((flags & C_CMESH_USE_MATERIAL) != 0);
+    a_object->setUseTexture((flags & C_CMESH_USE_TEXTURE) != 0);
+    a_object->setUseVertexColors((flags & C_CMESH_USE_VERTEX_COLORS) != 0);
+    a_object->setUseTransparency((flags & C_CMESH_USE_TRANSPARENCY) != 0);
+
+    // read meshes
+    for (unsigned int i=0; i<numMeshes; i++)
+    {
+        if (!cReadMeshCMESH(reader, a_object->newMesh()))
+        {
+            a_object->deleteAllMeshes();
+            return (C_ERROR);
+        }
+    }
+
+    // compute global positions of vertices
+    a_object->computeGlobalPositionsFromRoot(true);
+
+    // return success
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This function saves a cMultiMesh object to a CMESH file, together with the
+    AABB collision trees of its meshes.
+    If the operation succeeds, then the functions returns __true__ and the 
+    model data is saved to a file.
+    If the operation fails, then the function returns __false__. \n
+
+    If __a_sourceFilename__ is not empty, the size and modification time of 
+    this file and the options of its loader are recorded, so that 
+    \ref cLoadFileCMESH() can check that the CMESH file is up to date.
+
+    \param  a_object          Multimesh object.
+    \param  a_filename        Filename.
+    \param  a_sourceFilename  Filename of the model file the object was loaded from.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cSaveFileCMESH(cMultiMesh* a_object,
+                    const std::string& a_filename,
+                    const std::string& a_sourceFilename)
+{
+    // sanity check
+    if (a_object == NULL) 
+        return (C_ERROR);
+
+    // describe source file
+    cCMESHSource source;
+    source.m_filename = "";
+    source.m_size = 0;
+    source.m_time = 0;
+    source.m_loaderOptions = 0;
+    source.m_loaderTolerance = 0.0;
+    if ((a_sourceFilename.length() > 0) && !cGetSourceCMESH(a_sourceFilename, source))
+        return (C_ERROR);
+
+    // create file
+    cCMESHWriter writer(a_filename);
+    if (!writer.m_file)
+        return (C_ERROR);
+
+    // write header
+    writer.write(C_CMESH_MAGIC, sizeof(C_CMESH_MAGIC));
+    writer.write(C_CMESH_VERSION);
+    writer.write(C_CMESH_BYTE_ORDER);
+    writer.writeString(source.m_filename);
+    writer.write(source.m_size);
+    writer.write(source.m_time);
+    writer.write(source.m_loaderOptions);
+    writer.write(source.m_loaderTolerance);
+
+    uint32_t flags = 0;
+    if (a_object->getUseMaterial())     { flags |= C_CMESH_USE_MATERIAL; }
+    if (a_object->getUseTexture())      { flags |= C_CMESH_USE_TEXTURE; }
+    if (a_object->getUseVertexColors()) { flags |= C_CMESH_USE_VERTEX_COLORS; }
+    if (a_object->getUseTransparency()) { flags |= C_CMESH_USE_TRANSPARENCY; }
+    writer.write(flags);
+
+    // write meshes
+    uint32_t numMeshes = a_object->getNumMeshes();
+    writer.write(numMeshes);
+    for (unsigned int i=0; i<numMeshes; i++)
+    {
+        cWriteMeshCMESH(writer, a_object->getMesh(i));
+    }
+
+    // close file
+    writer.m_file.close();
+
+    // return result
+    return (!writer.m_file.fail());
+}
+
+
+//==============================================================================
+/*!
+    This function returns the name of the CMESH file in which 
+    cMultiMesh::loadFromFile() caches a model file when 
+    __g_meshLoaderUseCache__ is set.
+
+    \param  a_sourceFilename  Filename of the model file.
+
+    \return Filename of the CMESH file.
+*/
+//==============================================================================
+std::string cGetCacheFilenameCMESH(const std::string& a_sourceFilename)
+{
+    if (g_meshLoaderCacheDirectory.length() == 0)
+    {
+        return (a_sourceFilename + ".cmesh");
+    }
+
+    string directory = g_meshLoaderCacheDirectory;
+    char last = directory[directory.length() - 1];
+    if ((last != '/') && (last != '\\'))
+    {
+        directory = directory + "/";
+    }
+
+    return (directory + cGetFilename(a_sourceFilename, true) + ".cmesh");
+}
+
+
+//==============================================================================
+/*!
+    This function computes a checksum of the vertex positions and triangles
+    of all meshes of a multi-mesh. It is used to detect whether a model has
+    been modified since it was loaded.
+
+    \param  a_object  Multimesh object.
+
+    \return Checksum.
+*/
+//==============================================================================
+unsigned long long cComputeChecksumCMESH(cMultiMesh* a_object)
+{
+    unsigned long long checksum = 0xcbf29ce484222325ULL;
+
+    int numMeshes = a_object->getNumMeshes();
+    for (int i=0; i<numMeshes; i++)
+    {
+        cMesh* mesh = a_object->getMesh(i);
+
+        unsigned int numVertices = mesh->m_vertices->getNumElements();
+        cAddChecksumCMESH(checksum, &numVertices, sizeof(numVertices));
+        if (numVertices > 0)
+        {
+            cAddChecksumCMESH(checksum, &mesh->m_vertices->m_localPos[0], numVertices * sizeof(cVector3d));
+        }
+
+        unsigned int numIndices = (unsigned int)(mesh->m_triangles->m_indices.size());
+        cAddChecksumCMESH(checksum, &numIndices, sizeof(numIndices));
+        if (numIndices > 0)
+        {
+            cAddChecksumCMESH(checksum, &mesh->m_triangles->m_indices[0], numIndices * sizeof(unsigned int));
+        }
+    }
+
+    return (checksum);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
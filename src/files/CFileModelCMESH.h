@@ -0,0 +1,135 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CFileModelCMESHH
+#define CFileModelCMESHH
+//------------------------------------------------------------------------------
+#include "world/CMultiMesh.h"
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CFileModelCMESH.h
+    \ingroup    files
+
+    \brief
+    Implements CMESH model file support.
+
+    \details
+    CMESH is the native binary format of CHAI3D. A CMESH file stores the
+    vertex and triangle arrays of each mesh of a cMultiMesh as raw arrays,
+    together with materials, texture filenames, and the nodes of the AABB
+    collision trees that have been built. Files are read through a memory
+    mapping and the arrays are copied in bulk, so that a model is restored
+    without parsing each element and without rebuilding its collision tree.
+    \n
+
+    CMESH files are not meant to be exchanged: they use the byte order and
+    floating-point layout of the computer that wrote them, and are used to
+    cache models loaded from other formats (see __g_meshLoaderUseCache__).
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*!
+    \addtogroup files
+*/
+//------------------------------------------------------------------------------
+
+//@{
+
+//! This function loads a CMESH model file.
+bool cLoadFileCMESH(cMultiMesh* a_object, 
+                    const std::string& a_filename,
+                    const std::string& a_sourceFilename = "");
+
+//! This function saves a CMESH model file.
+bool cSaveFileCMESH(cMultiMesh* a_object,
+                    const std::string& a_filename,
+                    const std::string& a_sourceFilename = "");
+
+//! This function returns the name of the CMESH file that caches a model file.
+std::string cGetCacheFilenameCMESH(const std::string& a_sourceFilename);
+
+//! This function computes a checksum of the vertex positions and triangles of a multi-mesh.
+unsigned long long cComputeChecksumCMESH(cMultiMesh* a_object);
+
+//@}
+
+
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to tell cMultiMesh::loadFromFile() to cache the
+    models it loads. \n
+    If __true__, loading a .obj, .3ds, or .stl file first looks for a CMESH
+    file created by a previous load. If it exists and the source file has
+    the same size, modification time, and loader options as when it was
+    written, the model is restored from it. Otherwise the source file is 
+    loaded and the CMESH file is written. When cMultiMesh::createAABBCollisionDetector()
+    is then called on the unmodified model, the collision trees are added
+    to the CMESH file. After the next loads, they are attached instead of
+    being built when cMultiMesh::createAABBCollisionDetector() is called on
+    the unmodified model. \n
+    If __false__ (default), models are always loaded from their source file.
+*/
+//------------------------------------------------------------------------------
+extern bool g_meshLoaderUseCache;
+
+
+//------------------------------------------------------------------------------
+/*!
+    Directory in which the CMESH files of __g_meshLoaderUseCache__ are written.
+    If empty (default), the CMESH file of a model is written next to it and
+    named after it, followed by the .cmesh extension.
+*/
+//------------------------------------------------------------------------------
+extern std::string g_meshLoaderCacheDirectory;
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -44,7 +44,11 @@
 
 //------------------------------------------------------------------------------
 #include "files/CFileModelOBJ.h"
+#include "graphics/CVertexWelder.h"
+#include "system/CMappedFile.h"
+#include "system/CWorkerPool.h"
 //------------------------------------------------------------------------------
+#include <cfloat>
 #include <iostream>
 #include <iomanip>
 #include <ostream>
@@ -63,6 +67,203 @@ namespace chai3d {
 
 //------------------------------------------------------------------------------
 bool g_objLoaderShouldGenerateExtraVertices = false;
+bool g_objLoaderWeldVertices = false;
+double g_objLoaderWeldingTolerance = 0.0;
+bool g_objLoaderUseFastParser = true;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// maps each entry of an array to the first entry located within a tolerance
+static void cWeldOBJArray(const cVector3d* a_data,
+                          const unsigned int a_count,
+                          const double a_tolerance,
+                          vector<int>& a_map)
+{
+    vector<int> first;
+    first.reserve(a_count);
+    a_map.resize(a_count);
+
+    cVertexWelder welder(a_tolerance);
+    welder.reserve(a_count);
+    for (unsigned int i=0; i<a_count; i++)
+    {
+        bool added;
+        unsigned int index = welder.weld(a_data[i], added);
+        if (added)
+        {
+            first.push_back((int)i);
+        }
+        a_map[i] = first[index];
+    }
+}
+
+// replaces the indices of a face vertex by the indices of their first occurrence
+static inline void cWeldOBJIndices(vertexIndexSet& a_vis,
+                                   const vector<int>& a_vertices,
+                                   const vector<int>& a_normals,
+                                   const vector<int>& a_texCoords)
+{
+    if ((a_vis.vIndex >= 0) && (a_vis.vIndex < (int)a_vertices.size())) a_vis.vIndex = a_vertices[a_vis.vIndex];
+    if ((a_vis.nIndex >= 0) && (a_vis.nIndex < (int)a_normals.size())) a_vis.nIndex = a_normals[a_vis.nIndex];
+    if ((a_vis.tIndex >= 0) && (a_vis.tIndex < (int)a_texCoords.size())) a_vis.tIndex = a_texCoords[a_vis.tIndex];
+}
+
+// mesh vertex created for a combination of position, normal and texture coordinate indices
+struct cOBJVertexEntry
+{
+    int m_normal;
+    int m_texCoord;
+    int m_mesh;
+    unsigned int m_index;
+    int m_next;
+};
+
+// builds the meshes of a model from faces stored in compact form
+static void cBuildOBJMeshes(cMultiMesh* a_object,
+                            cOBJModel& a_model,
+                            const bool a_weld,
+                            const vector<int>& a_weldedVertices,
+                            const vector<int>& a_weldedNormals,
+                            const vector<int>& a_weldedTexCoords)
+{
+    unsigned int numFaces = (unsigned int)(a_model.m_faceRecords.size());
+    unsigned int numVertices = a_model.m_OBJInfo.m_vertexCount;
+
+    // object has no faces, copy vertex and color data into the main mesh
+    if (numFaces == 0)
+    {
+        cMesh* mesh = a_object->getMesh(0);
+        bool useVertexColors = false;
+        for (unsigned int i=0; i<numVertices; i++)
+        {
+            mesh->newVertex(a_model.m_pVertices[i], cVector3d(1,0,0), cVector3d(0,0,0), a_model.m_pColors[i]);
+            useVertexColors |= a_model.m_pColors[i].m_flag_color;
+        }
+        if (numVertices > 0)
+        {
+            mesh->setUseVertexColors(useVertexColors);
+        }
+        return;
+    }
+
+    // vertices created so far, chained from the position they share. this table
+    // replaces the ordered map of the standard parser: positions are its hash keys.
+    vector<int> firstEntry(numVertices, -1);
+    vector<cOBJVertexEntry> entries;
+    entries.reserve(numVertices);
+
+    vector<unsigned int> cornerVertices;
+    for (unsigned int j=0; j<numFaces; j++)
+    {
+        const cOBJFaceRecord& face = a_model.m_faceRecords[j];
+        if (face.m_numVertices < 3) continue;
+
+        // the mesh that we're reading this face into
+        cMesh* curMesh = a_object->getMesh(face.m_materialIndex);
+        if ((face.m_groupIndex >= 0) && (a_model.m_groupNames.size() > 0))
+        {
+            curMesh->m_name = a_model.m_groupNames[face.m_groupIndex];
+        }
+
+        const int* corners = &a_model.m_faceCorners[3 * face.m_firstCorner];
+
+        // get the mesh vertex of every corner, in the same order as the standard parser
+        if (!g_objLoaderShouldGenerateExtraVertices)
+        {
+            cornerVertices.resize(face.m_numVertices);
+            for (unsigned int k=0; k<face.m_numVertices; k++)
+            {
+                vertexIndexSet vis(corners[3*k]);
+                if (face.m_hasNormals) vis.nIndex = corners[3*k+2];
+                if (face.m_hasTexCoords) vis.tIndex = corners[3*k+1];
+                if (a_weld) cWeldOBJIndices(vis, a_weldedVertices, a_weldedNormals, a_weldedTexCoords);
+
+                int entry = firstEntry[vis.vIndex];
+                while ((entry >= 0) &&
+                       ((entries[entry].m_normal != vis.nIndex) ||
+                        (entries[entry].m_texCoord != vis.tIndex) ||
+                        (entries[entry].m_mesh != face.m_materialIndex)))
+                {
+                    entry = entries[entry].m_next;
+                }
+
+                if (entry < 0)
+                {
+                    cOBJVertexEntry newEntry;
+                    newEntry.m_normal = vis.nIndex;
+                    newEntry.m_texCoord = vis.tIndex;
+                    newEntry.m_mesh = face.m_materialIndex;
+                    newEntry.m_index = curMesh->newVertex(a_model.m_pVertices[vis.vIndex]);
+                    newEntry.m_next = firstEntry[vis.vIndex];
+                    entry = (int)(entries.size());
+                    entries.push_back(newEntry);
+                    firstEntry[vis.vIndex] = entry;
+                }
+                cornerVertices[k] = entries[entry].m_index;
+            }
+        }
+
+        // triangulate the face as a fan
+        for (unsigned int k=2; k<face.m_numVertices; k++)
+        {
+            const int* corner0 = &corners[0];
+            const int* corner1 = &corners[3*(k-1)];
+            const int* corner2 = &corners[3*k];
+
+            // create triangle
+            unsigned int indexTriangle;
+            if (!g_objLoaderShouldGenerateExtraVertices)
+            {
+                unsigned int indexV1 = cornerVertices[0];
+                unsigned int indexV2 = cornerVertices[k-1];
+                unsigned int indexV3 = cornerVertices[k];
+
+                // skip triangles collapsed by welding
+                if (a_weld && ((indexV1 == indexV2) || (indexV2 == indexV3) || (indexV1 == indexV3)))
+                {
+                    continue;
+                }
+
+                indexTriangle = curMesh->newTriangle(indexV1, indexV2, indexV3);
+            }
+            else
+            {
+                indexTriangle = curMesh->newTriangle(a_model.m_pVertices[corner0[0]],
+                                                     a_model.m_pVertices[corner1[0]],
+                                                     a_model.m_pVertices[corner2[0]]);
+            }
+            curMesh->m_triangles->computeNormal(indexTriangle, true);
+
+            // assign normals
+            if (face.m_hasNormals)
+            {
+                cVector3d normal0 = a_model.m_pNormals[corner0[2]];
+                cVector3d normal1 = a_model.m_pNormals[corner1[2]];
+                cVector3d normal2 = a_model.m_pNormals[corner2[2]];
+                normal0.normalize();
+                normal1.normalize();
+                normal2.normalize();
+                curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex0(indexTriangle), normal0);
+                curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex1(indexTriangle), normal1);
+                curMesh->m_vertices->setNormal(curMesh->m_triangles->getVertexIndex2(indexTriangle), normal2);
+            }
+
+            // assign texture coordinates
+            if (face.m_hasTexCoords)
+            {
+                curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex0(indexTriangle), a_model.m_pTexCoords[corner0[1]]);
+                curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex1(indexTriangle), a_model.m_pTexCoords[corner1[1]]);
+                curMesh->m_vertices->setTexCoord(curMesh->m_triangles->getVertexIndex2(indexTriangle), a_model.m_pTexCoords[corner2[1]]);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -85,7 +286,15 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
         cOBJModel fileObj;
 
         // load file into memory. If an error occurs, exit.
-        if (!fileObj.LoadModel(a_filename.c_str())) { return (false); }
+        bool mapped = g_objLoaderUseFastParser;
+        if (mapped)
+        {
+            if (!fileObj.LoadModelMapped(a_filename.c_str())) { return (false); }
+        }
+        else
+        {
+            if (!fileObj.LoadModel(a_filename.c_str())) { return (false); }
+        }
 
         // clear all vertices and triangle of current mesh
         a_object->deleteAllMeshes();
@@ -199,7 +408,24 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
         vertexIndexSet_uint_map* vertexMaps = new vertexIndexSet_uint_map[nMeshes];
         vertexIndexSet_uint_map::iterator vertexMapIter;
 
+        // map duplicate positions, normals and texture coordinates to their first occurrence
+        bool weld = g_objLoaderWeldVertices && !g_objLoaderShouldGenerateExtraVertices;
+        vector<int> weldedVertices, weldedNormals, weldedTexCoords;
+        if (weld)
+        {
+            cWeldOBJArray(fileObj.m_pVertices, fileObj.m_OBJInfo.m_vertexCount, g_objLoaderWeldingTolerance, weldedVertices);
+            cWeldOBJArray(fileObj.m_pNormals, fileObj.m_OBJInfo.m_normalCount, 0.0, weldedNormals);
+            cWeldOBJArray(fileObj.m_pTexCoords, fileObj.m_OBJInfo.m_texCoordCount, 0.0, weldedTexCoords);
+        }
+
+        // build object from faces stored in compact form
+        if (mapped)
+        {
+            cBuildOBJMeshes(a_object, fileObj, weld, weldedVertices, weldedNormals, weldedTexCoords);
+        }
+
         // build object
+        else
         {
             int i = 0;
 
@@ -241,6 +467,7 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
                             vertexIndexSet vis(indexV1);
                             if (face.m_pNormals != NULL) vis.nIndex = face.m_pNormalIndices[0];
                             if (face.m_pTexCoords != NULL) vis.tIndex = face.m_pTextureIndices[0];
+                            if (weld) cWeldOBJIndices(vis, weldedVertices, weldedNormals, weldedTexCoords);
                             indexV1 = getVertexIndex(curMesh, &fileObj, curVertexMap, vis);
                         }                
 
@@ -253,11 +480,19 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
                                 vertexIndexSet vis(indexV2);
                                 if (face.m_pNormals != NULL) vis.nIndex = face.m_pNormalIndices[triangleVert-1];
                                 if (face.m_pTexCoords) vis.tIndex = face.m_pTextureIndices[triangleVert-1];
+                                if (weld) cWeldOBJIndices(vis, weldedVertices, weldedNormals, weldedTexCoords);
                                 indexV2 = getVertexIndex(curMesh, &fileObj, curVertexMap, vis);
                                 vis.vIndex = indexV3;
                                 if (face.m_pNormals != NULL) vis.nIndex = face.m_pNormalIndices[triangleVert];
                                 if (face.m_pTexCoords) vis.tIndex = face.m_pTextureIndices[triangleVert];
+                                if (weld) cWeldOBJIndices(vis, weldedVertices, weldedNormals, weldedTexCoords);
                                 indexV3 = getVertexIndex(curMesh, &fileObj, curVertexMap, vis);
+
+                                // skip triangles collapsed by welding
+                                if (weld && ((indexV1 == indexV2) || (indexV2 == indexV3) || (indexV1 == indexV3)))
+                                {
+                                    continue;
+                                }
                             }
 
                             // for debugging, I want to look for degenerate triangles, but
@@ -840,6 +1075,688 @@ bool cOBJModel::LoadModel(const char a_fileName[])
 
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// approximate size of the blocks of lines parsed in parallel
+static const size_t C_OBJ_PARSER_BLOCK_SIZE = 1 << 20;
+
+// maximum number of characters of a number handed to the standard library
+static const int C_OBJ_PARSER_MAX_NUMBER_SIZE = 64;
+
+// exact powers of ten representable by a double
+static const double C_OBJ_PARSER_POW10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// line types recognized by the memory-mapped parser
+enum cOBJLineType
+{
+    C_OBJ_LINE_OTHER,
+    C_OBJ_LINE_VERTEX,
+    C_OBJ_LINE_TEXCOORD,
+    C_OBJ_LINE_NORMAL,
+    C_OBJ_LINE_FACE,
+    C_OBJ_LINE_GROUP,
+    C_OBJ_LINE_USE_MTL,
+    C_OBJ_LINE_MTL_LIB
+};
+
+// block of lines parsed by a single thread
+struct cOBJParserBlock
+{
+    const char* m_begin;
+    const char* m_end;
+
+    unsigned int m_numVertices;
+    unsigned int m_numTexCoords;
+    unsigned int m_numNormals;
+    unsigned int m_numFaces;
+    unsigned int m_numGroups;
+
+    unsigned int m_firstVertex;
+    unsigned int m_firstTexCoord;
+    unsigned int m_firstNormal;
+    unsigned int m_firstFace;
+    unsigned int m_firstGroup;
+
+    vector<string> m_materialLibs;
+    vector<int> m_corners;
+
+    cOBJParserBlock()
+    {
+        m_begin = m_end = NULL;
+        m_numVertices = m_numTexCoords = m_numNormals = m_numFaces = m_numGroups = 0;
+        m_firstVertex = m_firstTexCoord = m_firstNormal = m_firstFace = m_firstGroup = 0;
+    }
+};
+
+// data shared by the parsing tasks
+struct cOBJParserJob
+{
+    const char* m_data;
+    cOBJModel* m_model;
+    vector<cOBJParserBlock> m_blocks;
+};
+
+// returns true if a character separates the fields of a line, including line continuations
+static inline bool cIsOBJSpace(const char a_char)
+{
+    return ((a_char == ' ') || (a_char == '\t') || (a_char == '\r') || (a_char == '\n') || (a_char == '\\'));
+}
+
+// returns the end of the line containing a_pos, joining lines terminated by a backslash
+static const char* cFindOBJLineEnd(const char* a_begin, const char* a_pos, const char* a_end)
+{
+    while (a_pos < a_end)
+    {
+        const char* eol = (const char*)memchr(a_pos, '\n', a_end - a_pos);
+        if (eol == NULL)
+        {
+            return (a_end);
+        }
+        const char* last = eol;
+        if ((last > a_begin) && (last[-1] == '\r')) last--;
+        if ((last == a_begin) || (last[-1] != '\\'))
+        {
+            return (eol);
+        }
+        a_pos = eol + 1;
+    }
+    return (a_end);
+}
+
+// reads the type of a line and advances past its first token
+static cOBJLineType cReadOBJLineType(const char*& a_pos, const char* a_end)
+{
+    const char* p = a_pos;
+    while ((p < a_end) && cIsOBJSpace(*p)) p++;
+    const char* token = p;
+    while ((p < a_end) && !cIsOBJSpace(*p)) p++;
+    size_t length = p - token;
+    a_pos = p;
+
+    if (length == 1)
+    {
+        if (token[0] == 'v') return (C_OBJ_LINE_VERTEX);
+        if (token[0] == 'f') return (C_OBJ_LINE_FACE);
+        if (token[0] == 'g') return (C_OBJ_LINE_GROUP);
+    }
+    else if (length == 2)
+    {
+        if ((token[0] == 'v') && (token[1] == 't')) return (C_OBJ_LINE_TEXCOORD);
+        if ((token[0] == 'v') && (token[1] == 'n')) return (C_OBJ_LINE_NORMAL);
+    }
+    else if (length == 6)
+    {
+        if (!strncmp(token, C_OBJ_USE_MTL_ID, 6)) return (C_OBJ_LINE_USE_MTL);
+        if (!strncmp(token, C_OBJ_MTL_LIB_ID, 6)) return (C_OBJ_LINE_MTL_LIB);
+    }
+    return (C_OBJ_LINE_OTHER);
+}
+
+// returns the parameter of a line, without leading spaces and line terminator
+static string cReadOBJLineParameter(const char* a_pos, const char* a_end)
+{
+    while ((a_pos < a_end) && (*a_pos == ' ')) a_pos++;
+    if ((a_end > a_pos) && (a_end[-1] == '\r')) a_end--;
+    return (string(a_pos, a_end));
+}
+
+// parses a floating point number with the standard library
+static bool cParseOBJFloatStd(const char*& a_pos, const char* a_end, float& a_value)
+{
+    char str[C_OBJ_PARSER_MAX_NUMBER_SIZE];
+    int length = (int)cMin((size_t)(a_end - a_pos), (size_t)(C_OBJ_PARSER_MAX_NUMBER_SIZE - 1));
+    memcpy(str, a_pos, length);
+    str[length] = '\0';
+
+    char* end;
+    a_value = strtof(str, &end);
+    if (end == str)
+    {
+        return (false);
+    }
+    a_pos += (end - str);
+    return (true);
+}
+
+// parses a floating point number
+static bool cParseOBJFloat(const char*& a_pos, const char* a_end, float& a_value)
+{
+    const char* p = a_pos;
+    while ((p < a_end) && cIsOBJSpace(*p)) p++;
+    const char* start = p;
+
+    // sign
+    bool negative = false;
+    if ((p < a_end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // integer and fractional digits, of which the 19 first significant ones are kept
+    unsigned long long mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool truncated = false;
+    bool digits = false;
+    while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+    {
+        if (numDigits < 19)
+        {
+            mantissa = 10 * mantissa + (*p - '0');
+            if (mantissa != 0) numDigits++;
+        }
+        else
+        {
+            exponent++;
+            truncated |= (*p != '0');
+        }
+        digits = true;
+        p++;
+    }
+    if ((p < a_end) && (*p == '.'))
+    {
+        p++;
+        while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+        {
+            if (numDigits < 19)
+            {
+                mantissa = 10 * mantissa + (*p - '0');
+                if (mantissa != 0) numDigits++;
+                exponent--;
+            }
+            else
+            {
+                truncated |= (*p != '0');
+            }
+            digits = true;
+            p++;
+        }
+    }
+
+    // special values are handled by the standard library
+    if (!digits)
+    {
+        a_pos = start;
+        return (cParseOBJFloatStd(a_pos, a_end, a_value));
+    }
+
+    // exponent
+    if ((p < a_end) && ((*p == 'e') || (*p == 'E')))
+    {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if ((q < a_end) && ((*q == '-') || (*q == '+')))
+        {
+            negativeExponent = (*q == '-');
+            q++;
+        }
+        if ((q < a_end) && (*q >= '0') && (*q <= '9'))
+        {
+            int value = 0;
+            while ((q < a_end) && (*q >= '0') && (*q <= '9'))
+            {
+                if (value < 100000) value = 10 * value + (*q - '0');
+                q++;
+            }
+            exponent += negativeExponent ? -value : value;
+            p = q;
+        }
+    }
+
+    // the product of an integer below 2^53 and an exact power of ten is correctly rounded
+    if (truncated || (mantissa > (1ULL << 53)) || (exponent < -22) || (exponent > 22))
+    {
+        a_pos = start;
+        return (cParseOBJFloatStd(a_pos, a_end, a_value));
+    }
+    double value = (double)mantissa;
+    if (exponent < 0)
+    {
+        value /= C_OBJ_PARSER_POW10[-exponent];
+    }
+    else
+    {
+        value *= C_OBJ_PARSER_POW10[exponent];
+    }
+
+    // rounding to single precision is exact, unless the value lies halfway between two floats
+    if (value != 0.0)
+    {
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        if (((bits & 0x1fffffffULL) == 0x10000000ULL) || (value < FLT_MIN) || (value > FLT_MAX))
+        {
+            a_pos = start;
+            return (cParseOBJFloatStd(a_pos, a_end, a_value));
+        }
+    }
+
+    a_value = (float)(negative ? -value : value);
+    a_pos = p;
+    return (true);
+}
+
+// parses up to a_maxValues floating point numbers and returns the number of values read
+static int cParseOBJFloats(const char* a_pos, const char* a_end, float* a_values, const int a_maxValues)
+{
+    int count = 0;
+    while ((count < a_maxValues) && cParseOBJFloat(a_pos, a_end, a_values[count]))
+    {
+        count++;
+    }
+    for (int i=count; i<a_maxValues; i++)
+    {
+        a_values[i] = 0.0f;
+    }
+    return (count);
+}
+
+// parses an integer
+static inline bool cParseOBJInt(const char*& a_pos, const char* a_end, int& a_value)
+{
+    const char* p = a_pos;
+    bool negative = false;
+    if ((p < a_end) && ((*p == '-') || (*p == '+')))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+    if ((p >= a_end) || (*p < '0') || (*p > '9'))
+    {
+        return (false);
+    }
+    int value = 0;
+    while ((p < a_end) && (*p >= '0') && (*p <= '9'))
+    {
+        value = 10 * value + (*p - '0');
+        p++;
+    }
+    a_value = negative ? -value : value;
+    a_pos = p;
+    return (true);
+}
+
+// converts a one-based or relative index of a face into an array index, or returns -1 if invalid
+static inline int cResolveOBJIndex(const int a_index, const unsigned int a_numDefined, const unsigned int a_numTotal)
+{
+    int index = (a_index > 0) ? (a_index - 1) : ((int)a_numDefined + a_index);
+    if ((a_index == 0) || (index < 0) || (index >= (int)a_numTotal))
+    {
+        return (-1);
+    }
+    return (index);
+}
+
+// counts the lines of each type in a range of blocks, and collects material libraries
+static void cCountOBJLines(void* a_data, const unsigned int a_begin, const unsigned int a_end)
+{
+    cOBJParserJob* job = (cOBJParserJob*)a_data;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        cOBJParserBlock& block = job->m_blocks[i];
+        const char* pos = block.m_begin;
+        while (pos < block.m_end)
+        {
+            const char* eol = cFindOBJLineEnd(job->m_data, pos, block.m_end);
+
+            switch (cReadOBJLineType(pos, eol))
+            {
+                case C_OBJ_LINE_VERTEX:   block.m_numVertices++; break;
+                case C_OBJ_LINE_TEXCOORD: block.m_numTexCoords++; break;
+                case C_OBJ_LINE_NORMAL:   block.m_numNormals++; break;
+                case C_OBJ_LINE_FACE:     block.m_numFaces++; break;
+                case C_OBJ_LINE_GROUP:    block.m_numGroups++; break;
+                case C_OBJ_LINE_MTL_LIB:  block.m_materialLibs.push_back(cReadOBJLineParameter(pos, eol)); break;
+                default: break;
+            }
+
+            pos = eol + 1;
+        }
+    }
+}
+
+// parses the lines of a range of blocks
+static void cParseOBJLines(void* a_data, const unsigned int a_begin, const unsigned int a_end)
+{
+    cOBJParserJob* job = (cOBJParserJob*)a_data;
+    cOBJModel* model = job->m_model;
+    const cOBJFileInfo& info = model->m_OBJInfo;
+
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        cOBJParserBlock& block = job->m_blocks[i];
+        unsigned int vertex = block.m_firstVertex;
+        unsigned int texCoord = block.m_firstTexCoord;
+        unsigned int normal = block.m_firstNormal;
+        unsigned int face = block.m_firstFace;
+        unsigned int group = block.m_firstGroup;
+        int material = -1;
+
+        const char* pos = block.m_begin;
+        while (pos < block.m_end)
+        {
+            const char* eol = cFindOBJLineEnd(job->m_data, pos, block.m_end);
+
+            float values[6];
+            switch (cReadOBJLineType(pos, eol))
+            {
+                case C_OBJ_LINE_VERTEX:
+                {
+                    int count = cParseOBJFloats(pos, eol, values, 6);
+                    model->m_pVertices[vertex].set(values[0], values[1], values[2]);
+                    model->m_pColors[vertex].set(values[3], values[4], values[5]);
+                    model->m_pColors[vertex].m_flag_color = (count >= 6);
+                    vertex++;
+                }
+                break;
+
+                case C_OBJ_LINE_TEXCOORD:
+                {
+                    cParseOBJFloats(pos, eol, values, 3);
+                    model->m_pTexCoords[texCoord++].set(values[0], values[1], values[2]);
+                }
+                break;
+
+                case C_OBJ_LINE_NORMAL:
+                {
+                    cParseOBJFloats(pos, eol, values, 3);
+                    model->m_pNormals[normal++].set(values[0], values[1], values[2]);
+                }
+                break;
+
+                case C_OBJ_LINE_FACE:
+                {
+                    cOBJFaceRecord& record = model->m_faceRecords[face++];
+                    record.m_firstCorner = (unsigned int)(block.m_corners.size() / 3);
+                    record.m_numVertices = 0;
+                    record.m_materialIndex = material;
+                    record.m_groupIndex = (int)group - 1;
+                    record.m_hasTexCoords = true;
+                    record.m_hasNormals = true;
+
+                    // parse the vertex/texture/normal triplets
+                    bool valid = true;
+                    unsigned int numVertices = 0;
+                    const char* p = pos;
+                    while (valid)
+                    {
+                        while ((p < eol) && cIsOBJSpace(*p)) p++;
+                        if (p >= eol) break;
+
+                        int v = 0, t = 0, n = 0;
+                        bool hasTexCoord = false, hasNormal = false;
+                        valid = cParseOBJInt(p, eol, v);
+                        if (valid && (p < eol) && (*p == '/'))
+                        {
+                            p++;
+                            if ((p < eol) && (*p != '/'))
+                            {
+                                hasTexCoord = cParseOBJInt(p, eol, t);
+                            }
+                            if ((p < eol) && (*p == '/'))
+                            {
+                                p++;
+                                hasNormal = cParseOBJInt(p, eol, n);
+                            }
+                        }
+                        valid = valid && ((p >= eol) || cIsOBJSpace(*p));
+
+                        // convert to array indices
+                        v = cResolveOBJIndex(v, vertex, info.m_vertexCount);
+                        t = hasTexCoord ? cResolveOBJIndex(t, texCoord, info.m_texCoordCount) : -1;
+                        n = hasNormal ? cResolveOBJIndex(n, normal, info.m_normalCount) : -1;
+                        valid = valid && (v >= 0) && (!hasTexCoord || (t >= 0)) && (!hasNormal || (n >= 0));
+                        record.m_hasTexCoords &= hasTexCoord;
+                        record.m_hasNormals &= hasNormal;
+
+                        block.m_corners.push_back(v);
+                        block.m_corners.push_back(t);
+                        block.m_corners.push_back(n);
+                        numVertices++;
+                    }
+
+                    // faces with invalid indices are ignored
+                    if (valid)
+                    {
+                        record.m_numVertices = numVertices;
+                    }
+                    else
+                    {
+                        block.m_corners.resize(3 * record.m_firstCorner);
+                    }
+                }
+                break;
+
+                case C_OBJ_LINE_GROUP:
+                {
+                    string name = cReadOBJLineParameter(pos, eol);
+                    char* str = new char[name.size() + 1];
+                    strcpy(str, name.c_str());
+                    model->m_groupNames[group++] = str;
+                }
+                break;
+
+                case C_OBJ_LINE_USE_MTL:
+                {
+                    string name = cReadOBJLineParameter(pos, eol);
+                    if (model->m_pMaterials)
+                    {
+                        for (unsigned int j=0; j<info.m_materialCount; j++)
+                        {
+                            if (name == model->m_pMaterials[j].m_name)
+                            {
+                                material = j;
+                                break;
+                            }
+                        }
+                    }
+                }
+                break;
+
+                default: break;
+            }
+
+            pos = eol + 1;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+bool cOBJModel::LoadModelMapped(const char a_fileName[])
+{
+    /////////////////////////////////////////////////////////////////////////
+    // MAP THE OBJ FILE IN MEMORY AND PARSE ITS DATA IN PARALLEL
+    /////////////////////////////////////////////////////////////////////////
+
+    char basePath[C_OBJ_SIZE_PATH];     // path were all paths in the OBJ start
+
+    // get base path
+    strcpy(basePath, a_fileName);
+    makePath(basePath);
+
+    // map the file
+    cMappedFile file;
+    if (!file.open(a_fileName))
+    {
+        return (false);
+    }
+    const char* data = file.getData();
+    size_t size = file.getSize();
+
+    /////////////////////////////////////////////////////////////////////////
+    // SPLIT THE FILE INTO BLOCKS OF LINES
+    /////////////////////////////////////////////////////////////////////////
+
+    cOBJParserJob job;
+    job.m_data = data;
+    job.m_model = this;
+
+    unsigned int numBlocks = (unsigned int)(size / C_OBJ_PARSER_BLOCK_SIZE) + 1;
+    job.m_blocks.resize(numBlocks);
+    const char* begin = data;
+    for (unsigned int i=0; i<numBlocks; i++)
+    {
+        cOBJParserBlock& block = job.m_blocks[i];
+
+        // blocks end after a line terminator
+        const char* end = data + size;
+        if (i < numBlocks - 1)
+        {
+            end = cMax(begin, data + (size * (i + 1)) / numBlocks);
+            end = cFindOBJLineEnd(data, end, data + size);
+            end = cMin(end + 1, data + size);
+        }
+        block.m_begin = begin;
+        block.m_end = end;
+        begin = end;
+    }
+
+    // large files are parsed by the threads of the shared worker pool
+    cWorkerPool* pool = NULL;
+    if (numBlocks > 1)
+    {
+        pool = cWorkerPool::getSharedPool();
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+    // COUNT ALL IMPORTANT IDENTIFIERS
+    /////////////////////////////////////////////////////////////////////////
+
+    if (pool)
+    {
+        pool->execute(cCountOBJLines, &job, numBlocks, 1);
+    }
+    else
+    {
+        cCountOBJLines(&job, 0, numBlocks);
+    }
+
+    // compute the index of the first element of each block
+    m_OBJInfo.init();
+    unsigned int numGroups = 0;
+    vector<string> materialLibs;
+    for (unsigned int i=0; i<numBlocks; i++)
+    {
+        cOBJParserBlock& block = job.m_blocks[i];
+        block.m_firstVertex = m_OBJInfo.m_vertexCount;
+        block.m_firstTexCoord = m_OBJInfo.m_texCoordCount;
+        block.m_firstNormal = m_OBJInfo.m_normalCount;
+        block.m_firstFace = m_OBJInfo.m_faceCount;
+        block.m_firstGroup = numGroups;
+        m_OBJInfo.m_vertexCount += block.m_numVertices;
+        m_OBJInfo.m_texCoordCount += block.m_numTexCoords;
+        m_OBJInfo.m_normalCount += block.m_numNormals;
+        m_OBJInfo.m_faceCount += block.m_numFaces;
+        numGroups += block.m_numGroups;
+        materialLibs.insert(materialLibs.end(), block.m_materialLibs.begin(), block.m_materialLibs.end());
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+    // LOAD MATERIAL LIBRARIES
+    /////////////////////////////////////////////////////////////////////////
+
+    vector<unsigned int> numLibraryMaterials(materialLibs.size());
+    for (unsigned int i=0; i<materialLibs.size(); i++)
+    {
+        string libraryFile = string(basePath) + materialLibs[i];
+        numLibraryMaterials[i] = countMaterials(libraryFile.c_str());
+        m_OBJInfo.m_materialCount += numLibraryMaterials[i];
+    }
+
+    if (m_OBJInfo.m_materialCount)
+    {
+        m_pMaterials = new cMaterialInfo[m_OBJInfo.m_materialCount];
+
+        unsigned int materialIndex = 0;
+        for (unsigned int i=0; i<materialLibs.size(); i++)
+        {
+            if (numLibraryMaterials[i] > 0)
+            {
+                string libraryFile = string(basePath) + materialLibs[i];
+                loadMaterialLib(libraryFile.c_str(), m_pMaterials, &materialIndex, basePath);
+            }
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+    // ALLOCATE SPACE FOR STRUCTURES THAT HOLD THE MODEL DATA
+    /////////////////////////////////////////////////////////////////////////
+
+    m_pVertices = new cVector3d[m_OBJInfo.m_vertexCount];
+    m_pColors = new cColorf[m_OBJInfo.m_vertexCount];
+    if (m_OBJInfo.m_normalCount)
+        m_pNormals = new cVector3d[m_OBJInfo.m_normalCount];
+    if (m_OBJInfo.m_texCoordCount)
+        m_pTexCoords = new cVector3d[m_OBJInfo.m_texCoordCount];
+    m_faceRecords.resize(m_OBJInfo.m_faceCount);
+    m_groupNames.resize(numGroups, NULL);
+
+    /////////////////////////////////////////////////////////////////////////
+    // READ THE FILE CONTENTS
+    /////////////////////////////////////////////////////////////////////////
+
+    if (pool)
+    {
+        pool->execute(cParseOBJLines, &job, numBlocks, 1);
+    }
+    else
+    {
+        cParseOBJLines(&job, 0, numBlocks);
+    }
+
+    // gather the corners of all faces
+    size_t numCornerIndices = 0;
+    for (unsigned int i=0; i<numBlocks; i++)
+    {
+        numCornerIndices += job.m_blocks[i].m_corners.size();
+    }
+    m_faceCorners.resize(numCornerIndices);
+
+    unsigned int firstCorner = 0;
+    for (unsigned int i=0; i<numBlocks; i++)
+    {
+        cOBJParserBlock& block = job.m_blocks[i];
+        if (block.m_corners.size() > 0)
+        {
+            memcpy(&m_faceCorners[3 * firstCorner], &block.m_corners[0], block.m_corners.size() * sizeof(int));
+        }
+        for (unsigned int j=0; j<block.m_numFaces; j++)
+        {
+            m_faceRecords[block.m_firstFace + j].m_firstCorner += firstCorner;
+        }
+        firstCorner += (unsigned int)(block.m_corners.size() / 3);
+        vector<int>().swap(block.m_corners);
+    }
+
+    // faces preceding the first material selection of a block use the last material of the previous faces
+    int curMaterial = 0;
+    for (unsigned int i=0; i<m_OBJInfo.m_faceCount; i++)
+    {
+        if (m_faceRecords[i].m_materialIndex < 0)
+        {
+            m_faceRecords[i].m_materialIndex = curMaterial;
+        }
+        curMaterial = m_faceRecords[i].m_materialIndex;
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+    // SUCCESS
+    /////////////////////////////////////////////////////////////////////////
+    return (true);
+}
+
+//------------------------------------------------------------------------------
+
 void cOBJModel::parseFaceString(char a_faceString[], cFace *a_faceOut,
                 const cVector3d *a_pVertices,
                 const cVector3d *a_pNormals,
@@ -1239,36 +2156,53 @@ void cOBJModel::getFileInfo(FILE *a_hStream, cOBJFileInfo *a_info, const char a_
             // append .mtl
             //strcat(szBasePath, ".mtl");
 
-            // open the library file
-            FILE *hMaterialLib = fopen(basePath, "r");
+            // count materials defined in the library
+            a_info->m_materialCount += countMaterials(basePath);
+        }
 
-            // success?
-            if (hMaterialLib)
+       // clear string two avoid counting something twice
+       memset(str, '\0', sizeof(str));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+unsigned int cOBJModel::countMaterials(const char a_fileName[])
+{
+    /////////////////////////////////////////////////////////////////////////
+    // COUNT THE "NEW MATERIAL" IDENTIFIERS OF A MATERIAL LIBRARY
+    /////////////////////////////////////////////////////////////////////////
+
+    char str[C_OBJ_MAX_STR_SIZE];    // Buffer for reading the file
+    unsigned int count = 0;
+
+    // open the library file
+    FILE *hMaterialLib = fopen(a_fileName, "r");
+
+    // success?
+    if (hMaterialLib)
+    {
+        // quit reading when end of file has been reached
+        while (!feof(hMaterialLib))
+        {
+            // read next string
+            if (fscanf(hMaterialLib, "%1023s" ,str) > 0)
             {
-                // quit reading when end of file has been reached
-                while (!feof(hMaterialLib))
-                {
-                    // read next string
-                    if (fscanf(hMaterialLib, "%1024s" ,str) > 0)
-                    {
 
-                        // is it a "new material" identifier ?
-                        if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
-                        {
-                            // one more material defined
-                            a_info->m_materialCount++;
-                        }
-                    }
+                // is it a "new material" identifier ?
+                if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
+                {
+                    // one more material defined
+                    count++;
                 }
-
-                // close material library
-                fclose(hMaterialLib);
             }
         }
 
-       // clear string two avoid counting something twice
-       memset(str, '\0', sizeof(str));
+        // close material library
+        fclose(hMaterialLib);
     }
+
+    return (count);
 }
 
 //------------------------------------------------------------------------------
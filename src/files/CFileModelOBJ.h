@@ -93,6 +93,40 @@ bool cSaveFileOBJ(cMultiMesh* a_object, const std::string& a_filename);
 extern bool g_objLoaderShouldGenerateExtraVertices;
 
 
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to tell the OBJ file loader to merge vertices whose
+    positions lie within __g_objLoaderWeldingTolerance__ of each other,
+    together with duplicate normals and texture coordinates. \n
+    If __false__ (default), vertices are only shared by faces that reference
+    the same position, normal, and texture coordinate entries of the file.
+    Welding is ignored when __g_objLoaderShouldGenerateExtraVertices__ is set.
+*/
+//------------------------------------------------------------------------------
+extern bool g_objLoaderWeldVertices;
+
+
+//------------------------------------------------------------------------------
+/*!
+    Distance below which vertex positions are merged by the OBJ file loader
+    when __g_objLoaderWeldVertices__ is set. A value of zero (default) merges
+    identical positions only.
+*/
+//------------------------------------------------------------------------------
+extern double g_objLoaderWeldingTolerance;
+
+
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to select the parser used by the OBJ file loader. \n
+    If __true__ (default), the file is mapped in memory, and split into
+    blocks of lines that are parsed in parallel. If __false__, the file is
+    read with the standard C library, as in previous versions of CHAI3D.
+*/
+//------------------------------------------------------------------------------
+extern bool g_objLoaderUseFastParser;
+
+
 //------------------------------------------------------------------------------
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -238,6 +272,17 @@ struct cFace
     }
 };
 
+// Compact information about a surface face, filled by the memory-mapped parser.
+struct cOBJFaceRecord
+{
+    unsigned int m_firstCorner;
+    unsigned int m_numVertices;
+    int          m_materialIndex;
+    int          m_groupIndex;
+    bool         m_hasTexCoords;
+    bool         m_hasNormals;
+};
+
 // Information about a material property
 struct cMaterialInfo
 {
@@ -301,6 +346,9 @@ class cOBJModel
     //! Load model file.
     bool LoadModel(const char szFileName[]);
 
+    //! Load model file by mapping it in memory and parsing it in parallel. Faces are stored in compact form.
+    bool LoadModelMapped(const char szFileName[]);
+
 
     //--------------------------------------------------------------------------
     // MEMBERS:
@@ -330,6 +378,12 @@ class cOBJModel
     //! List of names obtained from 'g' commands, with the most recent at the back...
     std::vector<char*> m_groupNames;
 
+    //! List of faces in compact form, filled by LoadModelMapped().
+    std::vector<cOBJFaceRecord> m_faceRecords;
+
+    //! Vertex, texture coordinate and normal indices of the corners of the faces in compact form (-1 if absent).
+    std::vector<int> m_faceCorners;
+
 
     //--------------------------------------------------------------------------
     // METHODS:
@@ -356,6 +410,9 @@ class cOBJModel
 
     //! Read information about file.
     void  getFileInfo(FILE *a_hStream, cOBJFileInfo *a_stat, const char a_constBasePath[]);
+
+    //! Count materials defined in a material file [mtl].
+    unsigned int countMaterials(const char a_fileName[]);
 };
 
 //! Internal: get a (possibly new) vertex index for a vertex.
@@ -43,11 +43,13 @@
 
 //------------------------------------------------------------------------------
 #include "files/CFileModelSTL.h"
+#include "graphics/CVertexWelder.h"
 //------------------------------------------------------------------------------
 #include "stdint.h"
 #include <stdio.h>
 #include <math.h>
 #include <fstream>
+#include <vector>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -57,10 +59,21 @@ using namespace chai3d;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+bool g_stlLoaderWeldVertices = false;
+double g_stlLoaderWeldingTolerance = 0.0;
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
 
+// size of a triangle record in a binary STL file
+static const int C_STL_TRIANGLE_SIZE = 50;
+
+// number of triangle records read from the file at once
+static const int C_STL_TRIANGLES_PER_READ = 4096;
+
 struct cHeaderSTL
 {
     char m_header[80];
@@ -86,7 +99,12 @@ struct cTriangleSTL
     This function loads an STL (binary format) 3D model from a file into a cMultiMesh structure.
     If the operation succeeds, then the functions returns __true__ and the
     3D model is loaded into cMultiMesh as a single mesh.
-    If the operation fails, then the function returns __false__.
+    If the operation fails, then the function returns __false__. \n
+
+    STL files store three positions per triangle. By default, each triangle
+    receives its own vertices. If __g_stlLoaderWeldVertices__ is set, vertices
+    located within __g_stlLoaderWeldingTolerance__ of each other are merged
+    as the file is read, and triangles collapsed by merging are discarded.
 
     \param  a_object    Multimesh object.
     \param  a_filename  Filename.
@@ -138,18 +156,62 @@ bool cLoadFileSTL(cMultiMesh* a_object, const std::string& a_filename)
     // create mesh
     cMesh* mesh = a_object->newMesh();
 
-    // load triangles
-    for (int i=0; i<(int)numTriangles; i++)
+    // setup vertex welding
+    bool weld = g_stlLoaderWeldVertices;
+    cVertexWelder welder(g_stlLoaderWeldingTolerance);
+    if (weld)
     {
-        cTriangleSTL triangle;
+        // closed surfaces have about half as many vertices as triangles
+        welder.reserve(numTriangles / 2);
+    }
 
+    // load triangles, several records at a time
+    vector<char> buffer(C_STL_TRIANGLES_PER_READ * C_STL_TRIANGLE_SIZE);
+    unsigned int numRead = 0;
+    while (numRead < numTriangles)
+    {
         // read triangle data from file
-        file.read((char*)(&triangle), 50);
+        unsigned int count = cMin(numTriangles - numRead, (unsigned int)C_STL_TRIANGLES_PER_READ);
+        file.read(&buffer[0], count * C_STL_TRIANGLE_SIZE);
+        count = (unsigned int)(file.gcount() / C_STL_TRIANGLE_SIZE);
+        if (count == 0)
+        {
+            break;
+        }
+        numRead += count;
 
-        // create triangle entity
-        mesh->newTriangle(cVector3d(triangle.m_vertex0[0], triangle.m_vertex0[1], triangle.m_vertex0[2]),
-                          cVector3d(triangle.m_vertex1[0], triangle.m_vertex1[1], triangle.m_vertex1[2]),
-                          cVector3d(triangle.m_vertex2[0], triangle.m_vertex2[1], triangle.m_vertex2[2]));
+        for (unsigned int i=0; i<count; i++)
+        {
+            cTriangleSTL triangle;
+            memcpy(&triangle, &buffer[i * C_STL_TRIANGLE_SIZE], C_STL_TRIANGLE_SIZE);
+
+            cVector3d vertex0(triangle.m_vertex0[0], triangle.m_vertex0[1], triangle.m_vertex0[2]);
+            cVector3d vertex1(triangle.m_vertex1[0], triangle.m_vertex1[1], triangle.m_vertex1[2]);
+            cVector3d vertex2(triangle.m_vertex2[0], triangle.m_vertex2[1], triangle.m_vertex2[2]);
+
+            if (weld)
+            {
+                // merge vertices. the mesh is empty, so that its vertex indices match those of the welder.
+                bool added;
+                unsigned int index0 = welder.weld(vertex0, added);
+                if (added) mesh->newVertex(vertex0);
+                unsigned int index1 = welder.weld(vertex1, added);
+                if (added) mesh->newVertex(vertex1);
+                unsigned int index2 = welder.weld(vertex2, added);
+                if (added) mesh->newVertex(vertex2);
+
+                // create triangle entity, unless it has collapsed
+                if ((index0 != index1) && (index1 != index2) && (index0 != index2))
+                {
+                    mesh->newTriangle(index0, index1, index2);
+                }
+            }
+            else
+            {
+                // create triangle entity
+                mesh->newTriangle(vertex0, vertex1, vertex2);
+            }
+        }
     }
 
     // compute normals
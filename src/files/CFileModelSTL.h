@@ -76,6 +76,27 @@ bool cSaveFileSTL(cMultiMesh* a_object, const std::string& a_filename);
 
 //@}
 
+
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to tell the STL file loader to merge vertices shared
+    by adjacent triangles. \n
+    If __false__ (default), loaded STL files will have three _distinct_ vertices
+    per triangle, which preserves sharp edges when normals are computed.
+*/
+//------------------------------------------------------------------------------
+extern bool g_stlLoaderWeldVertices;
+
+
+//------------------------------------------------------------------------------
+/*!
+    Distance below which vertex positions are merged by the STL file loader
+    when __g_stlLoaderWeldVertices__ is set. A value of zero (default) merges
+    identical positions only.
+*/
+//------------------------------------------------------------------------------
+extern double g_stlLoaderWeldingTolerance;
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -44,6 +44,8 @@
 //------------------------------------------------------------------------------
 #include "forces/CAlgorithmFingerProxy.h"
 //------------------------------------------------------------------------------
+#include "timers/CHapticTrace.h"
+#include "timers/CPrecisionClock.h"
 #include "world/CWorld.h"
 //------------------------------------------------------------------------------
 
@@ -112,11 +114,40 @@ cAlgorithmFingerProxy::cAlgorithmFingerProxy()
     // initialize algorithm variables
     m_algoCounter = 0;
 
+    // the contact cache is disabled by default
+    m_useContactCache = false;
+
+    // the local model is disabled by default
+    m_useLocalModel = false;
+    m_localModelUpdateRate = 150.0;
+    m_localModelMargin = 0.0;
+    m_localModelThread = NULL;
+    m_localModelQuit = false;
+    m_localModelInputValid = false;
+    m_localModelWorldMutex = NULL;
+    m_localModelVersion = 0;
+    m_localModelPublishedVersion = 0;
+    m_localModelCurrentVersion = 0;
+    m_numLocalModelHits = 0;
+    m_numLocalModelMisses = 0;
+    m_numLocalModelUpdates = 0;
+
     // render settings (for debug purposes)
     m_showEnabled = true;
 }
 
 
+//==============================================================================
+/*!
+    Destructor of cAlgorithmFingerProxy.
+*/
+//==============================================================================
+cAlgorithmFingerProxy::~cAlgorithmFingerProxy()
+{
+    stopLocalModel();
+}
+
+
 //==============================================================================
 /*!
     This method Initializes the algorithm, including setting the pointer to the world
@@ -147,6 +178,12 @@ void cAlgorithmFingerProxy::initialize(cWorld* a_world, const cVector3d& a_initi
 
     // set pointer to world in which force algorithm operates
     m_world = a_world;
+
+    // discard triangles cached for a previous world
+    m_contactCache.invalidate();
+
+    // discard local model extracted from a previous world
+    invalidateLocalModel();
 }
 
 
@@ -172,6 +209,9 @@ void cAlgorithmFingerProxy::reset()
 
     // set proxy position to be equal to the device position
     m_proxyGlobalPos = m_deviceGlobalPos;
+
+    // discard cached triangles
+    m_contactCache.invalidate();
 }
 
 
@@ -204,12 +244,37 @@ void cAlgorithmFingerProxy::setEpsilonBaseValue(double a_value)
 cVector3d cAlgorithmFingerProxy::computeForces(const cVector3d& a_toolPos,
                                               const cVector3d& a_toolVel)
 {
+    C_HAPTIC_TRACE_SCOPE("finger proxy");
+
     // update device position
     m_deviceGlobalPos = a_toolPos;
 
     // check if world has been defined; if so, compute forces
     if (m_world != NULL)
     {
+        // exchange positions and local model with the background thread,
+        // unless it is currently publishing a new local model. A local model
+        // that is no longer used is handed to the background thread, which
+        // frees it, so that this thread never releases memory.
+        if ((m_useLocalModel || (m_localModel != nullptr)) && m_localModelMutex.tryAcquire())
+        {
+            if (m_useLocalModel)
+            {
+                m_localModelInputValid = true;
+                m_localModelProxyPos = m_proxyGlobalPos;
+                m_localModelDevicePos = m_deviceGlobalPos;
+                m_localModelSettings = m_collisionSettings;
+                m_localModel = m_localModelPublished;
+                m_localModelCurrentVersion = m_localModelPublishedVersion;
+            }
+            else
+            {
+                m_localModelRetired.push_back(m_localModel);
+                m_localModel.reset();
+            }
+            m_localModelMutex.release();
+        }
+
         // compute next best position of proxy
         computeNextBestProxyPosition(m_deviceGlobalPos);
 
@@ -469,10 +534,9 @@ bool cAlgorithmFingerProxy::computeNextProxyPositionWithContraints0(const cVecto
     // search for a collision between the first segment (proxy-device)
     // and the environment.
     m_collisionRecorderConstraint0.clear();
-    bool hit = m_world->computeCollisionDetection(m_proxyGlobalPos,
-                                                  targetPos,
-                                                  m_collisionRecorderConstraint0,
-                                                  m_collisionSettings);
+    bool hit = computeProxyCollisionDetection(m_proxyGlobalPos,
+                                              targetPos,
+                                              m_collisionRecorderConstraint0);
 
     // check if collision occurred between proxy and goal positions.
     double collisionDistance;
@@ -642,10 +706,9 @@ bool cAlgorithmFingerProxy::computeNextProxyPositionWithContraints1(const cVecto
     // search for collision
     m_collisionSettings.m_adjustObjectMotion = false;
     m_collisionRecorderConstraint1.clear();
-    bool hit = m_world->computeCollisionDetection( m_proxyGlobalPos,
-                                                   targetPos,
-                                                   m_collisionRecorderConstraint1,
-                                                   m_collisionSettings);
+    bool hit = computeProxyCollisionDetection(m_proxyGlobalPos,
+                                              targetPos,
+                                              m_collisionRecorderConstraint1);
 
     // check if collision occurred between proxy and goal positions.
     double collisionDistance;
@@ -810,10 +873,9 @@ bool cAlgorithmFingerProxy::computeNextProxyPositionWithContraints2(const cVecto
     // search for collision
     m_collisionSettings.m_adjustObjectMotion = false;
     m_collisionRecorderConstraint2.clear();
-    bool hit = m_world->computeCollisionDetection( m_proxyGlobalPos,
-                                                   targetPos,
-                                                   m_collisionRecorderConstraint2,
-                                                   m_collisionSettings);
+    bool hit = computeProxyCollisionDetection(m_proxyGlobalPos,
+                                              targetPos,
+                                              m_collisionRecorderConstraint2);
 
     // check if collision occurred between proxy and goal positions.
     double collisionDistance;
@@ -913,6 +975,308 @@ bool cAlgorithmFingerProxy::computeNextProxyPositionWithContraints2(const cVecto
 }
 
 
+//==============================================================================
+/*!
+    This method enables or disables the local model. When enabled, a
+    background thread extracts the collision primitives located around the
+    proxy and the device at the given rate, and collision queries of the
+    haptic thread are answered from the most recent extraction whenever
+    possible. The contact cache is not used while the local model is
+    enabled. \n
+
+    The background thread reads the world concurrently with the haptic and
+    graphics threads. Applications that modify the world while the local
+    model is enabled must hold the mutex passed to
+    setLocalModelWorldMutex() while doing so.
+
+    \param  a_useLocalModel  If __true__, the local model is enabled.
+    \param  a_updateRate     Rate (Hz) at which the local model is extracted.
+*/
+//==============================================================================
+void cAlgorithmFingerProxy::setUseLocalModel(const bool a_useLocalModel, const double a_updateRate)
+{
+    stopLocalModel();
+
+    m_useLocalModel = a_useLocalModel;
+    m_localModelUpdateRate = cMax(a_updateRate, 1.0);
+
+    // free the local models the haptic thread no longer uses
+    releaseRetiredLocalModels();
+
+    if (m_useLocalModel)
+    {
+        m_numLocalModelHits = 0;
+        m_numLocalModelMisses = 0;
+        m_numLocalModelUpdates = 0;
+        m_localModelQuit = false;
+        m_localModelThread = new cThread();
+        m_localModelThread->start(localModelLoop, CTHREAD_PRIORITY_GRAPHICS, this);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method stops the thread extracting the local model and discards the
+    last local model it has published. The haptic thread may still hold this
+    model, so it is kept in the list of retired models.
+*/
+//==============================================================================
+void cAlgorithmFingerProxy::stopLocalModel()
+{
+    if (m_localModelThread != NULL)
+    {
+        m_localModelQuit = true;
+        m_localModelThread->join();
+        delete m_localModelThread;
+        m_localModelThread = NULL;
+    }
+
+    m_localModelMutex.acquire();
+    m_localModelInputValid = false;
+    if (m_localModelPublished != nullptr)
+    {
+        m_localModelRetired.push_back(m_localModelPublished);
+        m_localModelPublished.reset();
+    }
+    m_localModelMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method discards the local models extracted so far. Queries are
+    computed with the entire world until the background thread extracts a
+    new local model. \n
+
+    Modifications of the world that the local model detects by itself are
+    listed in \ref cCollisionCache. This method must be called after other
+    modifications, such as changes of the geometry of an object that update
+    neither its collision detector nor its boundary box.
+*/
+//==============================================================================
+void cAlgorithmFingerProxy::invalidateLocalModel()
+{
+    m_localModelMutex.acquire();
+    m_localModelVersion++;
+    m_localModelInputValid = false;
+    if (m_localModelPublished != nullptr)
+    {
+        m_localModelRetired.push_back(m_localModelPublished);
+        m_localModelPublished.reset();
+    }
+    m_localModelMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method sets a mutex that the background thread holds while it
+    extracts the local model from the world. Applications that modify the
+    world from another thread while the local model is enabled must hold
+    the same mutex during the modification.
+
+    \param  a_mutex  Mutex protecting the world, or __NULL__.
+*/
+//==============================================================================
+void cAlgorithmFingerProxy::setLocalModelWorldMutex(cMutex* a_mutex)
+{
+    m_localModelMutex.acquire();
+    m_localModelWorldMutex = a_mutex;
+    m_localModelMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method frees the retired local models that the haptic thread no
+    longer uses. A model in the list that is only referenced by the list
+    can no longer be acquired by the haptic thread.
+*/
+//==============================================================================
+void cAlgorithmFingerProxy::releaseRetiredLocalModels()
+{
+    std::vector<std::shared_ptr<cCollisionCache> > unusedModels;
+
+    m_localModelMutex.acquire();
+    for (unsigned int i=0; i<m_localModelRetired.size();)
+    {
+        if (m_localModelRetired[i].use_count() == 1)
+        {
+            unusedModels.push_back(m_localModelRetired[i]);
+            m_localModelRetired[i] = m_localModelRetired.back();
+            m_localModelRetired.pop_back();
+        }
+        else
+        {
+            i++;
+        }
+    }
+    m_localModelMutex.release();
+
+    // models are freed here, outside of the mutex
+    unusedModels.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method is the main loop of the thread extracting the local model.
+    At each period, the collision primitives located around the segment
+    between the last proxy and device positions reported by the haptic
+    thread are extracted into a new cache, which is then published. Before
+    the extraction, the published local model is checked against the entire
+    world with cCollisionCache::isWorldUnchanged(), and discarded at once if
+    the world has changed, since the haptic thread only checks the objects
+    located in the local model. The world is read while holding the mutex
+    set by setLocalModelWorldMutex(), if any. Published models are tagged with the number of calls to
+    invalidateLocalModel() at the time of the extraction, so that the haptic
+    thread ignores models extracted before an invalidation.
+
+    \param  a_algorithm  Finger-proxy algorithm owning the thread.
+*/
+//==============================================================================
+void cAlgorithmFingerProxy::localModelLoop(void* a_algorithm)
+{
+    cAlgorithmFingerProxy* algorithm = (cAlgorithmFingerProxy*)(a_algorithm);
+
+    cPrecisionClock clock;
+    clock.start(true);
+
+    while (!algorithm->m_localModelQuit)
+    {
+        double startTime = clock.getCurrentTimeSeconds();
+
+        // read the positions reported by the haptic thread
+        algorithm->m_localModelMutex.acquire();
+        bool valid = algorithm->m_localModelInputValid;
+        cWorld* world = algorithm->m_world;
+        cVector3d proxyPos = algorithm->m_localModelProxyPos;
+        cVector3d devicePos = algorithm->m_localModelDevicePos;
+        cCollisionSettings settings = algorithm->m_localModelSettings;
+        cMutex* worldMutex = algorithm->m_localModelWorldMutex;
+        unsigned int version = algorithm->m_localModelVersion;
+        algorithm->m_localModelMutex.release();
+
+        if (valid && (world != NULL))
+        {
+            // discard the published local model if the world has changed
+            algorithm->m_localModelMutex.acquire();
+            std::shared_ptr<cCollisionCache> publishedModel = algorithm->m_localModelPublished;
+            algorithm->m_localModelMutex.release();
+
+            if (publishedModel != nullptr)
+            {
+                if (worldMutex != NULL) { worldMutex->acquire(); }
+                bool unchanged = publishedModel->isWorldUnchanged(world, settings);
+                if (worldMutex != NULL) { worldMutex->release(); }
+
+                if (!unchanged)
+                {
+                    algorithm->m_localModelMutex.acquire();
+                    if (algorithm->m_localModelPublished == publishedModel)
+                    {
+                        algorithm->m_localModelVersion++;
+                        algorithm->m_localModelRetired.push_back(publishedModel);
+                        algorithm->m_localModelPublished.reset();
+                    }
+                    version = algorithm->m_localModelVersion;
+                    algorithm->m_localModelMutex.release();
+                }
+                publishedModel.reset();
+            }
+
+            // extract local model
+            double margin = algorithm->m_localModelMargin;
+            if (margin <= 0.0)
+            {
+                margin = 10.0 * settings.m_collisionRadius;
+            }
+
+            std::shared_ptr<cCollisionCache> localModel = std::make_shared<cCollisionCache>();
+            localModel->setMargin(margin);
+
+            if (worldMutex != NULL) { worldMutex->acquire(); }
+            localModel->build(world, proxyPos, devicePos, settings);
+            if (worldMutex != NULL) { worldMutex->release(); }
+
+            // publish local model, unless it was invalidated during the extraction
+            algorithm->m_localModelMutex.acquire();
+            if (version == algorithm->m_localModelVersion)
+            {
+                if (algorithm->m_localModelPublished != nullptr)
+                {
+                    algorithm->m_localModelRetired.push_back(algorithm->m_localModelPublished);
+                }
+                algorithm->m_localModelPublished = localModel;
+                algorithm->m_localModelPublishedVersion = version;
+                algorithm->m_numLocalModelUpdates++;
+            }
+            algorithm->m_localModelMutex.release();
+        }
+
+        // free the models the haptic thread no longer uses
+        algorithm->releaseRetiredLocalModels();
+
+        // wait for next period
+        double remainingTime = 1.0 / algorithm->m_localModelUpdateRate - (clock.getCurrentTimeSeconds() - startTime);
+        cSleepMs(cMax(1, (int)(1000.0 * remainingTime)));
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the collisions between a segment and the world. If
+    the local model or the contact cache is enabled, the query is answered
+    from the triangles cached around the proxy whenever they are the only
+    ones the segment can reach.
+
+    \param  a_segmentPointA  Initial point of segment.
+    \param  a_segmentPointB  End point of segment.
+    \param  a_recorder       Recorder used to store the collisions.
+
+    \return __true__ if a collision has occurred, __false__ otherwise.
+*/
+//==============================================================================
+bool cAlgorithmFingerProxy::computeProxyCollisionDetection(const cVector3d& a_segmentPointA,
+                                                           const cVector3d& a_segmentPointB,
+                                                           cCollisionRecorder& a_recorder)
+{
+    if (m_useLocalModel)
+    {
+        bool hit = false;
+        if ((m_localModel != nullptr) &&
+            (m_localModelCurrentVersion == m_localModelVersion) &&
+            (m_localModel->computeCachedCollisionDetection(m_world,
+                                                           a_segmentPointA,
+                                                           a_segmentPointB,
+                                                           a_recorder,
+                                                           m_collisionSettings,
+                                                           hit)))
+        {
+            m_numLocalModelHits++;
+            return (hit);
+        }
+
+        m_numLocalModelMisses++;
+    }
+    else if (m_useContactCache)
+    {
+        return (m_contactCache.computeCollisionDetection(m_world,
+                                                         a_segmentPointA,
+                                                         a_segmentPointB,
+                                                         a_recorder,
+                                                         m_collisionSettings));
+    }
+
+    return (m_world->computeCollisionDetection(a_segmentPointA,
+                                               a_segmentPointB,
+                                               a_recorder,
+                                               m_collisionSettings));
+}
+
+
 //==============================================================================
 /*!
     This method tests whether the proxy has reached the goal point, allowing
@@ -45,12 +45,17 @@
 #ifndef CAlgorithmFingerProxyH
 #define CAlgorithmFingerProxyH
 //------------------------------------------------------------------------------
+#include "collisions/CCollisionCache.h"
 #include "collisions/CGenericCollision.h"
 #include "forces/CGenericForceAlgorithm.h"
 #include "math/CVector3d.h"
 #include "math/CMatrix3d.h"
+#include "system/CMutex.h"
+#include "system/CThread.h"
 //------------------------------------------------------------------------------
+#include <atomic>
 #include <map>
+#include <memory>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -80,7 +85,20 @@ class cWorld;
 
     \details
     This class implements a finger-proxy force rendering algorithm for polygonal 
-    objects.
+    objects. \n
+
+    When the local model is enabled (see setUseLocalModel()), a background
+    thread extracts, at a low rate, the triangles and other collision
+    primitives located around the proxy and the device into a
+    \ref cCollisionCache. The haptic thread then computes collisions with this
+    local model, so that the cost of each haptic cycle no longer depends on
+    the size of the world. Queries leaving the local model before the next
+    extraction, or issued after a modification of the world that affects the
+    local model, are computed with the entire world (see
+    \ref cCollisionCache for the modifications that are detected, and
+    invalidateLocalModel() for the others). The haptic thread only checks
+    the objects located in the local model; modifications of the rest of
+    the world are detected by the background thread at its next period.
 */
 //==============================================================================
 class cAlgorithmFingerProxy : public cGenericForceAlgorithm
@@ -95,7 +113,7 @@ public:
     cAlgorithmFingerProxy();
 
     //! Destructor of cAlgorithmFingerProxy.
-    virtual ~cAlgorithmFingerProxy() {}
+    virtual ~cAlgorithmFingerProxy();
 
 
     //----------------------------------------------------------------------
@@ -198,6 +216,56 @@ public:
     double getEpsilonBaseValue() { return (m_epsilonBaseValue); }
 
 
+    //----------------------------------------------------------------------
+    // METHODS - CONTACT CACHE
+    //----------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables the cache of the triangles located around the __proxy__.
+    void setUseContactCache(const bool a_useContactCache) { m_useContactCache = a_useContactCache; m_contactCache.invalidate(); }
+
+    //! This method returns __true__ if the cache of the triangles located around the __proxy__ is enabled.
+    bool getUseContactCache() const { return (m_useContactCache); }
+
+    //! This method returns the cache of the triangles located around the __proxy__.
+    cCollisionCache& getContactCache() { return (m_contactCache); }
+
+
+    //----------------------------------------------------------------------
+    // METHODS - LOCAL MODEL
+    //----------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables the local model extracted around the __proxy__ by a background thread at a given rate (Hz).
+    void setUseLocalModel(const bool a_useLocalModel, const double a_updateRate = 150.0);
+
+    //! This method returns __true__ if the local model is enabled.
+    bool getUseLocalModel() const { return (m_useLocalModel); }
+
+    //! This method discards the local models extracted so far, after a modification of the world that the local model cannot detect.
+    void invalidateLocalModel();
+
+    //! This method sets a mutex held by the background thread while it extracts the local model from the world, or __NULL__.
+    void setLocalModelWorldMutex(cMutex* a_mutex);
+
+    //! This method sets the margin around the __proxy__ and __device__ covered by the local model. A value of zero selects ten times the radius of the __proxy__.
+    void setLocalModelMargin(const double a_margin) { m_localModelMargin = cMax(a_margin, 0.0); }
+
+    //! This method returns the margin around the __proxy__ and __device__ covered by the local model.
+    double getLocalModelMargin() const { return (m_localModelMargin); }
+
+    //! This method returns the number of collision queries answered from the local model.
+    unsigned int getNumLocalModelHits() const { return (m_numLocalModelHits); }
+
+    //! This method returns the number of collision queries computed with the entire world since they left the local model.
+    unsigned int getNumLocalModelMisses() const { return (m_numLocalModelMisses); }
+
+    //! This method returns the number of local models extracted by the background thread.
+    unsigned int getNumLocalModelUpdates() const { return (m_numLocalModelUpdates); }
+
+
     //--------------------------------------------------------------------------
     // PROTECTED METHODS - GRAPHICS:
     //--------------------------------------------------------------------------
@@ -308,6 +376,72 @@ protected:
     //! Value of state machine.
     unsigned int m_algoCounter;
 
+    //! If __true__, collision queries are answered from the cache of the triangles located around the proxy when possible.
+    bool m_useContactCache;
+
+    //! Cache of the triangles located around the proxy.
+    cCollisionCache m_contactCache;
+
+    //! If __true__, collision queries are answered from the local model when possible.
+    std::atomic<bool> m_useLocalModel;
+
+    //! Rate (Hz) at which the local model is extracted.
+    double m_localModelUpdateRate;
+
+    //! Margin around the proxy and device covered by the local model.
+    double m_localModelMargin;
+
+    //! Thread extracting the local model.
+    cThread* m_localModelThread;
+
+    //! If __true__, the thread extracting the local model terminates.
+    std::atomic<bool> m_localModelQuit;
+
+    //! Mutex protecting the exchange of data with the thread extracting the local model.
+    cMutex m_localModelMutex;
+
+    //! Most recent local model published by the background thread.
+    std::shared_ptr<cCollisionCache> m_localModelPublished;
+
+    //! Local model used by the haptic thread during the current cycle.
+    std::shared_ptr<cCollisionCache> m_localModel;
+
+    //! Local models replaced or discarded, freed by the background thread once the haptic thread no longer uses them.
+    std::vector<std::shared_ptr<cCollisionCache> > m_localModelRetired;
+
+    //! Number of calls to invalidateLocalModel().
+    std::atomic<unsigned int> m_localModelVersion;
+
+    //! Value of __m_localModelVersion__ when the published local model was extracted.
+    unsigned int m_localModelPublishedVersion;
+
+    //! Value of __m_localModelVersion__ when the local model used by the haptic thread was extracted.
+    unsigned int m_localModelCurrentVersion;
+
+    //! Mutex held by the background thread while it reads the world, or __NULL__.
+    cMutex* m_localModelWorldMutex;
+
+    //! If __true__, the proxy and device positions passed to the background thread are valid.
+    bool m_localModelInputValid;
+
+    //! Proxy position passed to the background thread.
+    cVector3d m_localModelProxyPos;
+
+    //! Device position passed to the background thread.
+    cVector3d m_localModelDevicePos;
+
+    //! Collision settings passed to the background thread.
+    cCollisionSettings m_localModelSettings;
+
+    //! Number of collision queries answered from the local model.
+    std::atomic<unsigned int> m_numLocalModelHits;
+
+    //! Number of collision queries computed with the entire world.
+    std::atomic<unsigned int> m_numLocalModelMisses;
+
+    //! Number of local models extracted by the background thread.
+    std::atomic<unsigned int> m_numLocalModelUpdates;
+
 
     //----------------------------------------------------------------------
     // PROTECTED METHODS - PROXY ALGORITHM
@@ -330,6 +464,20 @@ protected:
     //! This method computes the local surface normal from interpolated vertex normals 
     cVector3d computeShadedSurfaceNormal(cCollisionEvent* a_contactPoint);
 
+    //! This method is the main loop of the thread extracting the local model.
+    static void localModelLoop(void* a_algorithm);
+
+    //! This method stops the thread extracting the local model.
+    void stopLocalModel();
+
+    //! This method frees the retired local models that the haptic thread no longer uses.
+    void releaseRetiredLocalModels();
+
+    //! This method computes the collisions between a segment and the world, using the local model or the contact cache if enabled.
+    bool computeProxyCollisionDetection(const cVector3d& a_segmentPointA,
+                                        const cVector3d& a_segmentPointB,
+                                        cCollisionRecorder& a_recorder);
+
 
     //----------------------------------------------------------------------
     // DEBUG PURPOSES
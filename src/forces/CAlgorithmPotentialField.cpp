@@ -45,6 +45,7 @@
 #include "forces/CAlgorithmPotentialField.h"
 //------------------------------------------------------------------------------
 #include "forces/CInteractionBasics.h"
+#include "timers/CHapticTrace.h"
 #include "world/CWorld.h"
 //------------------------------------------------------------------------------
 
@@ -83,6 +84,8 @@ cAlgorithmPotentialField::cAlgorithmPotentialField()
 cVector3d cAlgorithmPotentialField::computeForces(const cVector3d& a_toolPos,
                                                   const cVector3d& a_toolVel)
 {
+    C_HAPTIC_TRACE_SCOPE("potential field");
+
     // initialize force
     cVector3d force;
     force.zero();
@@ -0,0 +1,739 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CBrickImage.h"
+//------------------------------------------------------------------------------
+#include <cstring>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Default constructor of cBrickImage.
+*/
+//==============================================================================
+cBrickImage::cBrickImage()
+{
+    m_depth = 0;
+    m_currentIndex = 0;
+    m_numBricks[0] = 0;
+    m_numBricks[1] = 0;
+    m_numBricks[2] = 0;
+    m_brickSizeInBytes = 0;
+    m_numAllocatedBricks = 0;
+    m_backgroundColor.set(0x00, 0x00, 0x00, 0x00);
+    memset(m_backgroundVoxel, 0, sizeof(m_backgroundVoxel));
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cBrickImage.
+*/
+//==============================================================================
+cBrickImage::~cBrickImage()
+{
+    erase();
+}
+
+
+//==============================================================================
+/*!
+    This method allocates a new volume by defining its size and voxel
+    format. The indirection table is created, but no brick is allocated:
+    all voxels take the background color, which is set to transparent black.
+
+    \param  a_width   Width of the volume.
+    \param  a_height  Height of the volume.
+    \param  a_depth   Number of slices of the volume.
+    \param  a_format  Voxel format. Accepted values are: GL_LUMINANCE, GL_RGB, GL_RGBA
+    \param  a_type    Voxel type. Accepted value is: GL_UNSIGNED_BYTE
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBrickImage::allocate(const unsigned int a_width,
+                           const unsigned int a_height,
+                           const unsigned int a_depth,
+                           const GLenum a_format,
+                           const GLenum a_type)
+{
+    // verify size makes sense
+    if ((a_width == 0) || (a_height == 0) || (a_depth == 0))
+    {
+        return (false);
+    }
+
+    // verify format
+    if (((a_format != GL_LUMINANCE) && (a_format != GL_RGB) && (a_format != GL_RGBA)) ||
+        (a_type != GL_UNSIGNED_BYTE))
+    {
+        return (false);
+    }
+
+    // delete current data
+    erase();
+
+    // set properties
+    m_width         = a_width;
+    m_height        = a_height;
+    m_depth         = a_depth;
+    m_format        = a_format;
+    m_type          = a_type;
+    m_bytesPerPixel = queryBytesPerPixel(a_format, a_type);
+    m_memorySize    = 0;
+    m_currentIndex  = 0;
+
+    // create indirection table
+    m_numBricks[0] = (int)((m_width  + C_BRICK_IMAGE_BRICK_SIZE - 1) / C_BRICK_IMAGE_BRICK_SIZE);
+    m_numBricks[1] = (int)((m_height + C_BRICK_IMAGE_BRICK_SIZE - 1) / C_BRICK_IMAGE_BRICK_SIZE);
+    m_numBricks[2] = (int)((m_depth  + C_BRICK_IMAGE_BRICK_SIZE - 1) / C_BRICK_IMAGE_BRICK_SIZE);
+
+    unsigned int numBricks = (unsigned int)(m_numBricks[0] * m_numBricks[1] * m_numBricks[2]);
+    m_bricks.assign(numBricks, (unsigned char*)NULL);
+    m_brickCounts.assign(numBricks, 0);
+    m_brickSizeInBytes = m_bytesPerPixel * C_BRICK_IMAGE_BRICK_SIZE * C_BRICK_IMAGE_BRICK_SIZE * C_BRICK_IMAGE_BRICK_SIZE;
+
+    // image has been allocated
+    m_allocated = true;
+    m_responsibleForMemoryAllocation = true;
+
+    // set background
+    clear();
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method deletes all image data from memory, including released
+    bricks.
+*/
+//==============================================================================
+void cBrickImage::erase()
+{
+    releaseBricks();
+    releaseFreeBricks();
+
+    m_bricks.clear();
+    m_brickCounts.clear();
+    m_backgroundBrick.clear();
+
+    m_width = 0;
+    m_height = 0;
+    m_depth = 0;
+    m_currentIndex = 0;
+    m_numBricks[0] = 0;
+    m_numBricks[1] = 0;
+    m_numBricks[2] = 0;
+    m_brickSizeInBytes = 0;
+    m_allocated = false;
+}
+
+
+//==============================================================================
+/*!
+    This method sets the current slice, which is accessed by the pixel
+    methods inherited from \ref cImage.
+
+    \param  a_index  Index of the slice.
+
+    \return __true__ if operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBrickImage::selectImage(unsigned long a_index)
+{
+    if (a_index >= m_depth)
+    {
+        return (false);
+    }
+
+    m_currentIndex = a_index;
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the voxel data of a brick. Voxels are stored along
+    __x__ first, then __y__, then __z__, with C_BRICK_IMAGE_BRICK_SIZE voxels
+    along each axis, including for bricks located at the border of the
+    volume.
+
+    \param  a_x  Brick index along __x__.
+    \param  a_y  Brick index along __y__.
+    \param  a_z  Brick index along __z__.
+
+    \return Pointer to the brick data, or __NULL__ if the brick is not allocated.
+*/
+//==============================================================================
+const unsigned char* cBrickImage::getBrickData(const int a_x, const int a_y, const int a_z) const
+{
+    if ((a_x < 0) || (a_y < 0) || (a_z < 0) ||
+        (a_x >= m_numBricks[0]) || (a_y >= m_numBricks[1]) || (a_z >= m_numBricks[2]))
+    {
+        return (NULL);
+    }
+
+    return (m_bricks[a_x + a_y * m_numBricks[0] + a_z * m_numBricks[0] * m_numBricks[1]]);
+}
+
+
+//==============================================================================
+/*!
+    This method returns __true__ if a box of voxels only overlaps bricks that
+    are not allocated, in which case every voxel of the box takes the
+    background color.
+
+    \param  a_min  Minimum voxel coordinates of the box.
+    \param  a_max  Maximum voxel coordinates of the box (inclusive).
+
+    \return __true__ if the box only overlaps unallocated bricks, __false__ otherwise.
+*/
+//==============================================================================
+bool cBrickImage::isRegionEmpty(const int a_min[3], const int a_max[3]) const
+{
+    int brickMin[3], brickMax[3];
+    for (int i=0; i<3; i++)
+    {
+        brickMin[i] = cMax(a_min[i], 0) / C_BRICK_IMAGE_BRICK_SIZE;
+        brickMax[i] = cMin(a_max[i] / C_BRICK_IMAGE_BRICK_SIZE, m_numBricks[i] - 1);
+    }
+
+    for (int z=brickMin[2]; z<=brickMax[2]; z++)
+    {
+        for (int y=brickMin[1]; y<=brickMax[1]; y++)
+        {
+            for (int x=brickMin[0]; x<=brickMax[0]; x++)
+            {
+                if (m_bricks[x + y * m_numBricks[0] + z * m_numBricks[0] * m_numBricks[1]] != NULL)
+                {
+                    return (false);
+                }
+            }
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method makes the bricks released since the last call available for
+    reuse. Released bricks are otherwise retired, since other threads, such
+    as the haptic thread computing collisions or the graphic thread
+    uploading the texture, may still be reading them: reusing a brick for
+    another location would let these threads read voxels of that location.
+    This method must therefore only be called when no other thread holds
+    bricks read before the call, for instance between two haptic cycles.
+*/
+//==============================================================================
+void cBrickImage::recycleRetiredBricks()
+{
+    m_freeBricks.insert(m_freeBricks.end(), m_retiredBricks.begin(), m_retiredBricks.end());
+    m_retiredBricks.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method returns released bricks to the system, including retired
+    bricks. Released bricks are otherwise kept for reuse, since other
+    threads, such as the graphic thread uploading the texture, may still be
+    reading them. This method must therefore only be called when no other
+    thread accesses the image.
+*/
+//==============================================================================
+void cBrickImage::releaseFreeBricks()
+{
+    recycleRetiredBricks();
+
+    for (unsigned int i=0; i<m_freeBricks.size(); i++)
+    {
+        delete [] m_freeBricks[i];
+    }
+    m_freeBricks.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method releases all bricks and sets the background color. All
+    voxels of the volume take this color.
+
+    \param  a_color  New background color.
+*/
+//==============================================================================
+void cBrickImage::clear(const cColorb& a_color)
+{
+    // check if image exists
+    if (!m_allocated) { return; }
+
+    releaseBricks();
+
+    // store background color as it reads back from the voxel format
+    encodeVoxel(a_color, m_backgroundVoxel);
+    decodeVoxel(m_backgroundVoxel, m_backgroundColor);
+
+    unsigned int numVoxels = C_BRICK_IMAGE_BRICK_SIZE * C_BRICK_IMAGE_BRICK_SIZE * C_BRICK_IMAGE_BRICK_SIZE;
+    m_backgroundBrick.resize(m_brickSizeInBytes);
+    for (unsigned int i=0; i<numVoxels; i++)
+    {
+        memcpy(&m_backgroundBrick[i * m_bytesPerPixel], m_backgroundVoxel, m_bytesPerPixel);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method retrieves the nearest voxel location from a texture coordinate.
+
+    \param  a_texCoord  Texture coordinate.
+    \param  a_voxelX    Return value for voxel coordinate X.
+    \param  a_voxelY    Return value for voxel coordinate Y.
+    \param  a_voxelZ    Return value for voxel coordinate Z.
+    \param  a_clampToImageSize  If __true__ then pixel value is clamped to image size.
+*/
+//==============================================================================
+void cBrickImage::getVoxelLocation(const cVector3d& a_texCoord,
+                                   int& a_voxelX,
+                                   int& a_voxelY,
+                                   int& a_voxelZ,
+                                   bool a_clampToImageSize) const
+{
+    double maxZ = (double)(m_depth - 1);
+    double pz = (double)(m_depth) * a_texCoord.z();
+
+    if (a_clampToImageSize)
+    {
+        a_voxelZ = (int)(cClamp(pz, 0.0, maxZ));
+    }
+    else
+    {
+        a_voxelZ = (int)(floor(pz));
+    }
+
+    getPixelLocation(a_texCoord, a_voxelX, a_voxelY, a_clampToImageSize);
+}
+
+
+//==============================================================================
+/*!
+    This method retrieves the voxel location from a texture coordinate.
+
+    \param  a_texCoord  Texture coordinate.
+    \param  a_voxelX    Return value for voxel coordinate X.
+    \param  a_voxelY    Return value for voxel coordinate Y.
+    \param  a_voxelZ    Return value for voxel coordinate Z.
+    \param  a_clampToImageSize  If __true__ then pixel value is clamped to image size.
+*/
+//==============================================================================
+void cBrickImage::getVoxelLocationInterpolated(const cVector3d& a_texCoord,
+                                               double& a_voxelX,
+                                               double& a_voxelY,
+                                               double& a_voxelZ,
+                                               bool a_clampToImageSize) const
+{
+    double maxZ = (double)(m_depth - 1);
+    double pz = (double)(m_depth) * a_texCoord.z();
+
+    if (a_clampToImageSize)
+    {
+        a_voxelZ = cClamp(pz, 0.0, maxZ);
+    }
+    else
+    {
+        a_voxelZ = pz;
+    }
+
+    getPixelLocationInterpolated(a_texCoord, a_voxelX, a_voxelY, a_clampToImageSize);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the color of a voxel. Voxels located in unallocated
+    bricks take the background color.
+
+    \param  a_x      X coordinate of the voxel.
+    \param  a_y      Y coordinate of the voxel.
+    \param  a_z      Z coordinate of the voxel.
+    \param  a_color  Return color of the voxel.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBrickImage::getVoxelColor(const unsigned int a_x,
+                                const unsigned int a_y,
+                                const unsigned int a_z,
+                                cColorb& a_color) const
+{
+    if ((!m_allocated) || (a_x >= m_width) || (a_y >= m_height) || (a_z >= m_depth))
+    {
+        a_color = m_borderColor;
+        return (false);
+    }
+
+    const unsigned int brickIndex = (a_x / C_BRICK_IMAGE_BRICK_SIZE) +
+                                    (a_y / C_BRICK_IMAGE_BRICK_SIZE) * m_numBricks[0] +
+                                    (a_z / C_BRICK_IMAGE_BRICK_SIZE) * m_numBricks[0] * m_numBricks[1];
+
+    const unsigned char* brick = m_bricks[brickIndex];
+    if (brick == NULL)
+    {
+        a_color = m_backgroundColor;
+        return (true);
+    }
+
+    const unsigned int voxelIndex = (a_x % C_BRICK_IMAGE_BRICK_SIZE) +
+                                    (a_y % C_BRICK_IMAGE_BRICK_SIZE) * C_BRICK_IMAGE_BRICK_SIZE +
+                                    (a_z % C_BRICK_IMAGE_BRICK_SIZE) * C_BRICK_IMAGE_BRICK_SIZE * C_BRICK_IMAGE_BRICK_SIZE;
+
+    decodeVoxel(&brick[voxelIndex * m_bytesPerPixel], a_color);
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the interpolated color of a voxel at a fractional
+    location, by trilinear interpolation of its eight neighbors.
+
+    \param  a_x      X coordinate of the voxel.
+    \param  a_y      Y coordinate of the voxel.
+    \param  a_z      Z coordinate of the voxel.
+    \param  a_color  Return color of the voxel.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBrickImage::getVoxelColorInterpolated(const double a_x,
+                                            const double a_y,
+                                            const double a_z,
+                                            cColorb& a_color) const
+{
+    cColorf color;
+    bool result = getVoxelColorInterpolated(a_x, a_y, a_z, color);
+    a_color = color.getColorb();
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the interpolated color of a voxel at a fractional
+    location, by trilinear interpolation of its eight neighbors.
+
+    \param  a_x      X coordinate of the voxel.
+    \param  a_y      Y coordinate of the voxel.
+    \param  a_z      Z coordinate of the voxel.
+    \param  a_color  Return color of the voxel.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cBrickImage::getVoxelColorInterpolated(const double a_x,
+                                            const double a_y,
+                                            const double a_z,
+                                            cColorf& a_color) const
+{
+    // compute fractional and integral parts of voxel position
+    double dpx, dpy, dpz;
+    double t[3];
+    t[0] = modf(a_x, &dpx);
+    t[1] = modf(a_y, &dpy);
+    t[2] = modf(a_z, &dpz);
+
+    int px = (int)dpx;
+    int py = (int)dpy;
+    int pz = (int)dpz;
+
+    // accumulate the eight neighbors
+    bool result = false;
+    double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+    for (int i=0; i<8; i++)
+    {
+        int dx = (i & 1);
+        int dy = (i >> 1) & 1;
+        int dz = (i >> 2) & 1;
+
+        double weight = (dx ? t[0] : 1.0 - t[0]) *
+                        (dy ? t[1] : 1.0 - t[1]) *
+                        (dz ? t[2] : 1.0 - t[2]);
+
+        cColorb color;
+        if (getVoxelColor(px + dx, py + dy, pz + dz, color))
+        {
+            result = true;
+        }
+
+        for (int j=0; j<4; j++)
+        {
+            sum[j] += weight * (double)(color[j]);
+        }
+    }
+
+    const double CONVERSION_FACTOR = 1.0 / 255.0;
+    a_color.set((float)(CONVERSION_FACTOR * sum[0]),
+                (float)(CONVERSION_FACTOR * sum[1]),
+                (float)(CONVERSION_FACTOR * sum[2]),
+                (float)(CONVERSION_FACTOR * sum[3]));
+
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the color of a voxel. Setting a voxel to a color other
+    than the background allocates its brick if needed. Setting the last
+    non-background voxel of a brick back to the background color releases
+    the brick.
+
+    \param  a_x      X coordinate of the voxel.
+    \param  a_y      Y coordinate of the voxel.
+    \param  a_z      Z coordinate of the voxel.
+    \param  a_color  New color of the voxel.
+*/
+//==============================================================================
+void cBrickImage::setVoxelColor(const unsigned int a_x,
+                                const unsigned int a_y,
+                                const unsigned int a_z,
+                                const cColorb& a_color)
+{
+    unsigned char voxel[4];
+    encodeVoxel(a_color, voxel);
+    writeVoxel(a_x, a_y, a_z, voxel);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the gray level of a voxel.
+
+    \param  a_x          X coordinate of the voxel.
+    \param  a_y          Y coordinate of the voxel.
+    \param  a_z          Z coordinate of the voxel.
+    \param  a_grayLevel  New gray level of the voxel.
+*/
+//==============================================================================
+void cBrickImage::setVoxelColor(const unsigned int a_x,
+                                const unsigned int a_y,
+                                const unsigned int a_z,
+                                const unsigned char a_grayLevel)
+{
+    unsigned char voxel[4] = { a_grayLevel, a_grayLevel, a_grayLevel, a_grayLevel };
+    writeVoxel(a_x, a_y, a_z, voxel);
+}
+
+
+//==============================================================================
+/*!
+    This method encodes a color into the voxel format of the image. The
+    alpha component is stored for GL_LUMINANCE images, as in \ref cMultiImage.
+
+    \param  a_color  Color.
+    \param  a_voxel  Returned voxel data.
+*/
+//==============================================================================
+void cBrickImage::encodeVoxel(const cColorb& a_color, unsigned char* a_voxel) const
+{
+    if (m_format == GL_RGBA)
+    {
+        a_voxel[0] = a_color.getR();
+        a_voxel[1] = a_color.getG();
+        a_voxel[2] = a_color.getB();
+        a_voxel[3] = a_color.getA();
+    }
+    else if (m_format == GL_RGB)
+    {
+        a_voxel[0] = a_color.getR();
+        a_voxel[1] = a_color.getG();
+        a_voxel[2] = a_color.getB();
+    }
+    else
+    {
+        a_voxel[0] = a_color.getA();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method decodes a voxel of the image into a color.
+
+    \param  a_voxel  Voxel data.
+    \param  a_color  Returned color.
+*/
+//==============================================================================
+void cBrickImage::decodeVoxel(const unsigned char* a_voxel, cColorb& a_color) const
+{
+    if (m_format == GL_RGBA)
+    {
+        a_color.set(a_voxel[0], a_voxel[1], a_voxel[2], a_voxel[3]);
+    }
+    else if (m_format == GL_RGB)
+    {
+        a_color.set(a_voxel[0], a_voxel[1], a_voxel[2]);
+    }
+    else
+    {
+        a_color.set(a_voxel[0], a_voxel[0], a_voxel[0], a_voxel[0]);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method writes an encoded voxel. The brick of the voxel is allocated
+    if the voxel differs from the background, and retired once all its
+    voxels equal the background. New bricks are taken from the bricks made
+    available by recycleRetiredBricks(), never from retired bricks.
+
+    \param  a_x      X coordinate of the voxel.
+    \param  a_y      Y coordinate of the voxel.
+    \param  a_z      Z coordinate of the voxel.
+    \param  a_voxel  Encoded voxel data.
+*/
+//==============================================================================
+void cBrickImage::writeVoxel(const unsigned int a_x,
+                             const unsigned int a_y,
+                             const unsigned int a_z,
+                             const unsigned char* a_voxel)
+{
+    if ((!m_allocated) || (a_x >= m_width) || (a_y >= m_height) || (a_z >= m_depth))
+    {
+        return;
+    }
+
+    const unsigned int brickIndex = (a_x / C_BRICK_IMAGE_BRICK_SIZE) +
+                                    (a_y / C_BRICK_IMAGE_BRICK_SIZE) * m_numBricks[0] +
+                                    (a_z / C_BRICK_IMAGE_BRICK_SIZE) * m_numBricks[0] * m_numBricks[1];
+
+    bool isBackground = (memcmp(a_voxel, m_backgroundVoxel, m_bytesPerPixel) == 0);
+
+    // allocate brick
+    unsigned char* brick = m_bricks[brickIndex];
+    if (brick == NULL)
+    {
+        if (isBackground)
+        {
+            return;
+        }
+
+        if (m_freeBricks.size() > 0)
+        {
+            brick = m_freeBricks.back();
+            m_freeBricks.pop_back();
+        }
+        else
+        {
+            brick = new unsigned char[m_brickSizeInBytes];
+        }
+
+        // fill brick before publishing it in the indirection table
+        memcpy(brick, &m_backgroundBrick[0], m_brickSizeInBytes);
+        m_brickCounts[brickIndex] = 0;
+        m_bricks[brickIndex] = brick;
+        m_numAllocatedBricks++;
+    }
+
+    // write voxel
+    const unsigned int voxelIndex = (a_x % C_BRICK_IMAGE_BRICK_SIZE) +
+                                    (a_y % C_BRICK_IMAGE_BRICK_SIZE) * C_BRICK_IMAGE_BRICK_SIZE +
+                                    (a_z % C_BRICK_IMAGE_BRICK_SIZE) * C_BRICK_IMAGE_BRICK_SIZE * C_BRICK_IMAGE_BRICK_SIZE;
+
+    unsigned char* data = &brick[voxelIndex * m_bytesPerPixel];
+    bool wasBackground = (memcmp(data, m_backgroundVoxel, m_bytesPerPixel) == 0);
+    memcpy(data, a_voxel, m_bytesPerPixel);
+
+    // update count of non-background voxels
+    if (wasBackground && !isBackground)
+    {
+        m_brickCounts[brickIndex]++;
+    }
+    else if (!wasBackground && isBackground)
+    {
+        m_brickCounts[brickIndex]--;
+    }
+
+    // retire brick, which other threads may still be reading
+    if (m_brickCounts[brickIndex] == 0)
+    {
+        m_bricks[brickIndex] = NULL;
+        m_retiredBricks.push_back(brick);
+        m_numAllocatedBricks--;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method releases all bricks. They are retired until
+    recycleRetiredBricks() is called.
+*/
+//==============================================================================
+void cBrickImage::releaseBricks()
+{
+    for (unsigned int i=0; i<m_bricks.size(); i++)
+    {
+        if (m_bricks[i] != NULL)
+        {
+            m_retiredBricks.push_back(m_bricks[i]);
+            m_bricks[i] = NULL;
+        }
+        m_brickCounts[i] = 0;
+    }
+    m_numAllocatedBricks = 0;
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
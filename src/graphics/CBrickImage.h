@@ -0,0 +1,349 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CBrickImageH
+#define CBrickImageH
+//------------------------------------------------------------------------------
+#include "graphics/CImage.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CBrickImage.h
+
+    \brief
+    Implements a sparse 3D image stored as bricks.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cBrickImage;
+typedef std::shared_ptr<cBrickImage> cBrickImagePtr;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//! Edge length, in voxels, of the bricks of a cBrickImage.
+const int C_BRICK_IMAGE_BRICK_SIZE = 16;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \class      cBrickImage
+    \ingroup    graphics
+
+    \brief
+    This class implements a sparse 3D image stored as bricks.
+
+    \details
+    cBrickImage stores a volume of voxels as bricks of
+    C_BRICK_IMAGE_BRICK_SIZE voxels along each axis. An indirection table
+    holds one pointer per brick. Bricks whose voxels all equal the
+    background color are not allocated, so that the memory used by the
+    image grows with the number of non-empty bricks rather than with the
+    size of the volume. \n
+
+    Bricks are allocated when a voxel is set to a color other than the
+    background, and released when their last non-background voxel is
+    cleared. Since other threads may still be reading a released brick,
+    released bricks are retired: they are neither reused nor returned to
+    the system until recycleRetiredBricks() or releaseFreeBricks() is
+    called at a point where no other thread reads the image, for instance
+    between two haptic cycles. Until then, a thread holding a released
+    brick keeps reading its last voxels, never those of another brick. \n
+
+    The class implements the voxel interface of \ref cImage, so that it can
+    be assigned to the texture of a \ref cVoxelObject in place of a
+    \ref cMultiImage. Collision detection reads voxels through this
+    interface, and cTexture3d uploads the volume brick by brick. Only
+    unsigned byte images in the GL_LUMINANCE, GL_RGB, and GL_RGBA formats
+    are supported. Methods that operate on a contiguous pixel array, such
+    as getData(), convert(), or file operations, are not available.
+*/
+//==============================================================================
+class cBrickImage : public cImage
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Default constructor of cBrickImage.
+    cBrickImage();
+
+    //! Destructor of cBrickImage.
+    virtual ~cBrickImage();
+
+    //! Shared cBrickImage allocator.
+    static cBrickImagePtr create() { return (std::make_shared<cBrickImage>()); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - GENERAL COMMANDS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method allocates a new volume by defining its size and voxel format. No brick is allocated.
+    bool allocate(const unsigned int a_width,
+                  const unsigned int a_height,
+                  const unsigned int a_depth,
+                  const GLenum a_format = GL_RGBA,
+                  const GLenum a_type = GL_UNSIGNED_BYTE);
+
+    //! This method deletes all image data from memory.
+    void erase();
+
+    //! This method returns the number of slices of the volume.
+    virtual unsigned int getImageCount() const { return (m_depth); }
+
+    //! This method returns the index number of the current slice.
+    virtual unsigned long getCurrentIndex() { return (m_currentIndex); }
+
+    //! This method sets the current slice, used by the pixel access methods.
+    virtual bool selectImage(unsigned long a_index);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - BRICKS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of bricks along axis __a_axis__.
+    int getNumBricks(const int a_axis) const { return (m_numBricks[a_axis]); }
+
+    //! This method returns the number of bricks currently allocated.
+    unsigned int getNumAllocatedBricks() const { return (m_numAllocatedBricks); }
+
+    //! This method returns the number of bytes used by a single brick.
+    unsigned int getBrickSizeInBytes() const { return (m_brickSizeInBytes); }
+
+    //! This method returns the voxel data of a brick, or __NULL__ if the brick is not allocated.
+    const unsigned char* getBrickData(const int a_x, const int a_y, const int a_z) const;
+
+    //! This method returns the data of a brick filled with the background color.
+    const unsigned char* getBackgroundBrickData() const { return (m_backgroundBrick.size() > 0 ? &m_backgroundBrick[0] : NULL); }
+
+    //! This method returns the background color, which unallocated bricks are filled with.
+    cColorb getBackgroundColor() const { return (m_backgroundColor); }
+
+    //! This method returns __true__ if a box of voxels only overlaps unallocated bricks.
+    bool isRegionEmpty(const int a_min[3], const int a_max[3]) const;
+
+    //! This method makes retired bricks available for reuse. No other thread may read the image meanwhile.
+    void recycleRetiredBricks();
+
+    //! This method returns bricks that have been released to the system. No other thread may access the image meanwhile.
+    void releaseFreeBricks();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - MANIPULATING PIXELS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method releases all bricks and sets the background color to black.
+    virtual void clear() { clear(cColorb(0x00, 0x00, 0x00, 0x00)); }
+
+    //! This method releases all bricks and sets the background color.
+    virtual void clear(const cColorb& a_color);
+
+    //! This method returns the color of a pixel of the current slice at location (x,y).
+    virtual bool getPixelColor(const unsigned int a_x,
+        const unsigned int a_y,
+        cColorb& a_color) const { return (getVoxelColor(a_x, a_y, m_currentIndex, a_color)); }
+
+    //! This method sets the color of a pixel of the current slice at location (x,y).
+    virtual void setPixelColor(const unsigned int a_x,
+        const unsigned int a_y,
+        const cColorb& a_color) { setVoxelColor(a_x, a_y, m_currentIndex, a_color); }
+
+    //! This method sets the gray scale of a pixel of the current slice at location (x,y).
+    virtual void setPixelColor(const unsigned int a_x,
+        const unsigned int a_y,
+        const unsigned char a_grayLevel) { setVoxelColor(a_x, a_y, m_currentIndex, a_grayLevel); }
+
+    //! This method is not supported by cBrickImage.
+    virtual void setTransparentColor(const cColorb &a_color,
+        const unsigned char a_transparencyLevel) {}
+
+    //! This method is not supported by cBrickImage.
+    virtual void setTransparency(const unsigned char a_transparencyLevel) {}
+
+    //! This method is not supported by cBrickImage.
+    virtual void flipHorizontal() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - MANIPULATING VOXELS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method retrieves the nearest voxel location from a texture coordinate.
+    virtual void getVoxelLocation(const cVector3d& a_texCoord, int& a_voxelX, int& a_voxelY, int& a_voxelZ, bool a_clampToImageSize = true) const;
+
+    //! This method retrieves the voxel location from a texture coordinate.
+    virtual void getVoxelLocationInterpolated(const cVector3d& a_texCoord, double& a_voxelX, double& a_voxelY, double& a_voxelZ, bool a_clampToImageSize = true) const;
+
+    //! This method returns the color of an image voxel at location (x,y,z).
+    virtual bool getVoxelColor(const unsigned int a_x,
+        const unsigned int a_y,
+        const unsigned int a_z,
+        cColorb& a_color) const;
+
+    //! This method returns the interpolated color of an image voxel at location (x,y,z).
+    virtual bool getVoxelColorInterpolated(const double a_x,
+        const double a_y,
+        const double a_z,
+        cColorb& a_color) const;
+
+    //! This method returns the interpolated color of an image voxel at location (x,y,z).
+    virtual bool getVoxelColorInterpolated(const double a_x,
+        const double a_y,
+        const double a_z,
+        cColorf& a_color) const;
+
+    //! This method sets the color of an image voxel at location (x,y,z).
+    virtual void setVoxelColor(const unsigned int a_x,
+        const unsigned int a_y,
+        const unsigned int a_z,
+        const cColorb& a_color);
+
+    //! This method sets the color of an image voxel at location (x,y,z).
+    virtual void setVoxelColor(const unsigned int a_x,
+        const unsigned int a_y,
+        const unsigned int a_z,
+        const unsigned char a_r,
+        const unsigned char a_g,
+        const unsigned char a_b) { cColorb color(a_r, a_g, a_b); setVoxelColor(a_x, a_y, a_z, color); }
+
+    //! This method sets the gray level of an image voxel at location (x,y,z).
+    virtual void setVoxelColor(const unsigned int a_x,
+        const unsigned int a_y,
+        const unsigned int a_z,
+        const unsigned char a_grayLevel);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method encodes a color into the voxel format of the image.
+    void encodeVoxel(const cColorb& a_color, unsigned char* a_voxel) const;
+
+    //! This method decodes a voxel of the image into a color.
+    void decodeVoxel(const unsigned char* a_voxel, cColorb& a_color) const;
+
+    //! This method writes an encoded voxel, allocating or releasing its brick when needed.
+    void writeVoxel(const unsigned int a_x,
+        const unsigned int a_y,
+        const unsigned int a_z,
+        const unsigned char* a_voxel);
+
+    //! This method releases all bricks.
+    void releaseBricks();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of slices of the volume.
+    unsigned int m_depth;
+
+    //! Index of the current slice.
+    unsigned long m_currentIndex;
+
+    //! Number of bricks along each axis.
+    int m_numBricks[3];
+
+    //! Number of bytes used by a single brick.
+    unsigned int m_brickSizeInBytes;
+
+    //! Indirection table, holding the data of each brick or __NULL__ if the brick is not allocated.
+    std::vector<unsigned char*> m_bricks;
+
+    //! Number of voxels differing from the background color in each brick.
+    std::vector<unsigned int> m_brickCounts;
+
+    //! Number of bricks currently allocated.
+    unsigned int m_numAllocatedBricks;
+
+    //! Released bricks that no thread reads anymore, kept for reuse.
+    std::vector<unsigned char*> m_freeBricks;
+
+    //! Released bricks that other threads may still be reading, which are not reused until recycleRetiredBricks() is called.
+    std::vector<unsigned char*> m_retiredBricks;
+
+    //! Background color.
+    cColorb m_backgroundColor;
+
+    //! Background color, encoded in the voxel format of the image.
+    unsigned char m_backgroundVoxel[4];
+
+    //! Brick filled with the background color.
+    std::vector<unsigned char> m_backgroundBrick;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -104,6 +104,9 @@ public:
     //--------------------------------------------------------------------------
     cGenericArray(cVertexArrayPtr a_vertexArray)
     {
+        // initialize topology counter
+        m_topologyVersion       = 0;
+
         // clear all elements
         clear();
 
@@ -127,6 +130,7 @@ public:
         m_indices.clear();
         m_freeElements.clear();
         m_flagMarkForUpdate     = true;
+        m_topologyVersion++;
         m_flagMarkForResize     = true;
     }
 
@@ -150,6 +154,12 @@ public:
     //! This method removes non used elements. This compresses the array.
     void compress();
 
+    //! This method returns a counter that changes each time elements are created, removed, or connected to different vertices.
+    unsigned int getTopologyVersion() const { return (m_topologyVersion); }
+
+    //! This method records a change of connectivity. It must be called by applications that modify \ref m_indices or \ref m_allocated directly.
+    void markTopologyModified() { m_topologyVersion++; }
+
 
     //--------------------------------------------------------------------------
     /*!
@@ -257,6 +267,9 @@ protected:
 
     //! List of free elements.
     std::list<unsigned int> m_freeElements;
+
+    //! Counter incremented each time elements are created, removed, or connected to different vertices.
+    unsigned int m_topologyVersion;
 };
 
 //------------------------------------------------------------------------------
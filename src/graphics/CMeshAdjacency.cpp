@@ -0,0 +1,517 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CMeshAdjacency.h"
+//------------------------------------------------------------------------------
+#include "system/CWorkerPool.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// number of items sorted by each task of a parallel sort
+const unsigned int C_MESH_ADJACENCY_SORT_CHUNK = 65536;
+
+// key of a half-edge excluded from the pairing
+const unsigned long long C_MESH_ADJACENCY_NO_KEY = 0xffffffffffffffffULL;
+
+// key of a half-edge, and half-edge index
+typedef std::pair<unsigned long long, unsigned int> cHalfEdgeKey;
+
+// data shared by the tasks building the adjacency index
+struct cMeshAdjacencyJob
+{
+    const unsigned int* m_indices;
+    const std::vector<bool>* m_allocated;
+    const unsigned int* m_positionIds;
+    cHalfEdgeKey* m_keys;
+    unsigned int m_numKeys;
+};
+
+// computes the keys of the half-edges of a range of triangles
+void cComputeHalfEdgeKeys(void* a_data,
+                          const unsigned int a_begin,
+                          const unsigned int a_end)
+{
+    cMeshAdjacencyJob* job = (cMeshAdjacencyJob*)a_data;
+    for (unsigned int t=a_begin; t<a_end; t++)
+    {
+        for (unsigned int k=0; k<3; k++)
+        {
+            unsigned int h = 3 * t + k;
+            cHalfEdgeKey& key = job->m_keys[h];
+            key.second = h;
+            key.first = C_MESH_ADJACENCY_NO_KEY;
+            if ((*job->m_allocated)[t])
+            {
+                unsigned int a = job->m_positionIds[job->m_indices[h]];
+                unsigned int b = job->m_positionIds[job->m_indices[(k == 2) ? h - 2 : h + 1]];
+                if (a != b)
+                {
+                    key.first = ((unsigned long long)(cMin(a, b)) << 32) | (unsigned long long)(cMax(a, b));
+                }
+            }
+        }
+    }
+}
+
+// sorts a range of chunks of half-edge keys
+void cSortHalfEdgeKeys(void* a_data,
+                       const unsigned int a_begin,
+                       const unsigned int a_end)
+{
+    cMeshAdjacencyJob* job = (cMeshAdjacencyJob*)a_data;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        unsigned int begin = i * C_MESH_ADJACENCY_SORT_CHUNK;
+        unsigned int end = cMin(begin + C_MESH_ADJACENCY_SORT_CHUNK, job->m_numKeys);
+        std::sort(job->m_keys + begin, job->m_keys + end);
+    }
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cMeshAdjacency. The index is empty until build() is called.
+
+    \param  a_vertices   Vertex array of the mesh.
+    \param  a_triangles  Triangle array of the mesh.
+*/
+//==============================================================================
+cMeshAdjacency::cMeshAdjacency(cVertexArrayPtr a_vertices, cTriangleArrayPtr a_triangles)
+{
+    m_vertices = a_vertices;
+    m_triangles = a_triangles;
+    m_topologyVersion = m_triangles->getTopologyVersion();
+}
+
+
+//==============================================================================
+/*!
+    This method builds the index for all allocated triangles of the mesh.
+    The keys of all edges are computed and sorted, then half-edges with
+    equal keys are paired. Large meshes are processed by the threads of the
+    shared worker pool.
+*/
+//==============================================================================
+void cMeshAdjacency::build()
+{
+    clear();
+
+    unsigned int numTriangles = m_triangles->getNumElements();
+    unsigned int numHalfEdges = 3 * numTriangles;
+
+    // the index matches the current triangles once built
+    setUpToDate();
+
+    // assign position identifiers to all vertices
+    m_welder.reserve(m_vertices->getNumElements());
+    updatePositionIds();
+
+    if (numTriangles == 0)
+    {
+        return;
+    }
+
+    // large meshes are processed by several threads
+    cWorkerPool* pool = NULL;
+    if (numTriangles >= C_MESH_ADJACENCY_PARALLEL_THRESHOLD)
+    {
+        pool = cWorkerPool::getSharedPool();
+    }
+
+    std::vector<cHalfEdgeKey> keys(numHalfEdges);
+
+    cMeshAdjacencyJob job;
+    job.m_indices = &m_triangles->m_indices[0];
+    job.m_allocated = &m_triangles->m_allocated;
+    job.m_positionIds = m_positionIds.empty() ? NULL : &m_positionIds[0];
+    job.m_keys = &keys[0];
+    job.m_numKeys = numHalfEdges;
+
+    // compute the key of every half-edge, then sort the keys by chunks
+    unsigned int numChunks = (numHalfEdges + C_MESH_ADJACENCY_SORT_CHUNK - 1) / C_MESH_ADJACENCY_SORT_CHUNK;
+    if (pool)
+    {
+        pool->execute(cComputeHalfEdgeKeys, &job, numTriangles, C_MESH_ADJACENCY_SORT_CHUNK / 3);
+        pool->execute(cSortHalfEdgeKeys, &job, numChunks, 1);
+    }
+    else
+    {
+        cComputeHalfEdgeKeys(&job, 0, numTriangles);
+        cSortHalfEdgeKeys(&job, 0, numChunks);
+    }
+
+    // merge the sorted chunks
+    for (unsigned int width=C_MESH_ADJACENCY_SORT_CHUNK; width<numHalfEdges; width*=2)
+    {
+        for (unsigned int begin=0; begin+width<numHalfEdges; begin+=2*width)
+        {
+            unsigned int end = cMin(begin + 2 * width, numHalfEdges);
+            std::inplace_merge(keys.begin() + begin, keys.begin() + begin + width, keys.begin() + end);
+        }
+    }
+
+    // pair consecutive half-edges sharing the same key
+    m_twins.assign(numHalfEdges, -1);
+    unsigned int i = 0;
+    while ((i + 1 < numHalfEdges) && (keys[i].first != C_MESH_ADJACENCY_NO_KEY))
+    {
+        if (keys[i].first == keys[i+1].first)
+        {
+            m_twins[keys[i].second] = (int)(keys[i+1].second);
+            m_twins[keys[i+1].second] = (int)(keys[i].second);
+            i += 2;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    // link the half-edges leaving each position, in increasing order
+    m_nextHalfEdges.assign(numHalfEdges, -1);
+    for (unsigned int h=numHalfEdges; h>0; h--)
+    {
+        if (m_triangles->m_allocated[(h - 1) / 3])
+        {
+            unsigned int id = m_positionIds[m_triangles->m_indices[h - 1]];
+            m_nextHalfEdges[h - 1] = m_firstHalfEdges[id];
+            m_firstHalfEdges[id] = (int)(h - 1);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method clears the index.
+*/
+//==============================================================================
+void cMeshAdjacency::clear()
+{
+    m_welder.clear();
+    m_positionIds.clear();
+    m_firstHalfEdges.clear();
+    m_nextHalfEdges.clear();
+    m_twins.clear();
+    setUpToDate();
+}
+
+
+//==============================================================================
+/*!
+    This method adds a newly allocated triangle to the index. Its half-edges
+    are paired with unpaired half-edges joining the same positions.
+
+    \param  a_triangleIndex  Index of the triangle.
+*/
+//==============================================================================
+void cMeshAdjacency::addTriangle(const unsigned int a_triangleIndex)
+{
+    // assign position identifiers to new vertices
+    updatePositionIds();
+
+    unsigned int first = 3 * a_triangleIndex;
+    if (first + 3 > m_twins.size())
+    {
+        m_twins.resize(first + 3, -1);
+        m_nextHalfEdges.resize(first + 3, -1);
+    }
+
+    // link the half-edges to the positions they leave from
+    for (unsigned int h=first; h<first+3; h++)
+    {
+        unsigned int id = m_positionIds[getOrigin(h)];
+        m_nextHalfEdges[h] = m_firstHalfEdges[id];
+        m_firstHalfEdges[id] = (int)(h);
+        m_twins[h] = -1;
+    }
+
+    // find twins
+    for (unsigned int h=first; h<first+3; h++)
+    {
+        pairHalfEdge(h);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method removes a triangle from the index. The method must be
+    called while the triangle is still allocated, since it reads the
+    indices of its vertices. Former twins of its half-edges are paired
+    again with other half-edges joining the same positions, if any.
+
+    \param  a_triangleIndex  Index of the triangle.
+*/
+//==============================================================================
+void cMeshAdjacency::removeTriangle(const unsigned int a_triangleIndex)
+{
+    // sanity check
+    unsigned int first = 3 * a_triangleIndex;
+    if ((first + 3 > m_twins.size()) || (!m_triangles->getAllocated(a_triangleIndex)))
+    {
+        return;
+    }
+
+    // unlink the half-edges from the positions they leave from
+    for (unsigned int h=first; h<first+3; h++)
+    {
+        unsigned int id = m_positionIds[getOrigin(h)];
+        int* link = &m_firstHalfEdges[id];
+        while (*link >= 0)
+        {
+            if (*link == (int)(h))
+            {
+                *link = m_nextHalfEdges[h];
+                break;
+            }
+            link = &m_nextHalfEdges[*link];
+        }
+        m_nextHalfEdges[h] = -1;
+    }
+
+    // release the twins
+    int twins[3];
+    for (unsigned int k=0; k<3; k++)
+    {
+        twins[k] = m_twins[first + k];
+        m_twins[first + k] = -1;
+        if (twins[k] >= 0)
+        {
+            m_twins[twins[k]] = -1;
+        }
+    }
+    for (unsigned int k=0; k<3; k++)
+    {
+        if (twins[k] >= 0)
+        {
+            pairHalfEdge(twins[k]);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the allocated triangles having a vertex located at
+    the position of a vertex.
+
+    \param  a_vertexIndex  Index of the vertex.
+    \param  a_triangles    Returned indices of the triangles.
+*/
+//==============================================================================
+void cMeshAdjacency::getVertexTriangles(const unsigned int a_vertexIndex,
+                                        std::vector<unsigned int>& a_triangles) const
+{
+    a_triangles.clear();
+    if (a_vertexIndex >= m_positionIds.size())
+    {
+        return;
+    }
+
+    int h = m_firstHalfEdges[m_positionIds[a_vertexIndex]];
+    while (h >= 0)
+    {
+        unsigned int triangle = getTriangle(h);
+        if (std::find(a_triangles.begin(), a_triangles.end(), triangle) == a_triangles.end())
+        {
+            a_triangles.push_back(triangle);
+        }
+        h = m_nextHalfEdges[h];
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the vertices connected by an edge to the position of
+    a vertex. A single vertex is returned for each neighboring position.
+
+    \param  a_vertexIndex  Index of the vertex.
+    \param  a_vertices     Returned indices of the neighboring vertices.
+*/
+//==============================================================================
+void cMeshAdjacency::getVertexNeighbors(const unsigned int a_vertexIndex,
+                                        std::vector<unsigned int>& a_vertices) const
+{
+    a_vertices.clear();
+    if (a_vertexIndex >= m_positionIds.size())
+    {
+        return;
+    }
+
+    unsigned int id = m_positionIds[a_vertexIndex];
+    int h = m_firstHalfEdges[id];
+    while (h >= 0)
+    {
+        // both the destination of the half-edge and the origin of the
+        // previous one are neighbors, so that boundaries are handled
+        unsigned int neighbors[2] = { getDestination(h), getOrigin(getPrevious(h)) };
+        for (unsigned int i=0; i<2; i++)
+        {
+            unsigned int neighborId = m_positionIds[neighbors[i]];
+            if (neighborId == id)
+            {
+                continue;
+            }
+
+            bool found = false;
+            for (unsigned int j=0; j<a_vertices.size(); j++)
+            {
+                if (m_positionIds[a_vertices[j]] == neighborId)
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                a_vertices.push_back(neighbors[i]);
+            }
+        }
+        h = m_nextHalfEdges[h];
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the triangles sharing an edge with a triangle.
+
+    \param  a_triangleIndex  Index of the triangle.
+    \param  a_triangles      Returned indices of the neighboring triangles.
+*/
+//==============================================================================
+void cMeshAdjacency::getTriangleNeighbors(const unsigned int a_triangleIndex,
+                                          std::vector<unsigned int>& a_triangles) const
+{
+    a_triangles.clear();
+    unsigned int first = 3 * a_triangleIndex;
+    if (first + 3 > m_twins.size())
+    {
+        return;
+    }
+
+    for (unsigned int h=first; h<first+3; h++)
+    {
+        if (m_twins[h] >= 0)
+        {
+            a_triangles.push_back(getTriangle(m_twins[h]));
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method assigns position identifiers to the vertices created since
+    the identifiers were last updated.
+*/
+//==============================================================================
+void cMeshAdjacency::updatePositionIds()
+{
+    unsigned int numVertices = m_vertices->getNumElements();
+    for (unsigned int i=(unsigned int)(m_positionIds.size()); i<numVertices; i++)
+    {
+        m_positionIds.push_back(m_welder.weld(m_vertices->m_localPos[i]));
+    }
+    m_firstHalfEdges.resize(m_welder.getNumVertices(), -1);
+}
+
+
+//==============================================================================
+/*!
+    This method pairs a half-edge with an unpaired half-edge joining the
+    same positions. Half-edges of opposite orientation are preferred.
+
+    \param  a_halfEdge  Half-edge.
+*/
+//==============================================================================
+void cMeshAdjacency::pairHalfEdge(const unsigned int a_halfEdge)
+{
+    unsigned int a = m_positionIds[getOrigin(a_halfEdge)];
+    unsigned int b = m_positionIds[getDestination(a_halfEdge)];
+    if (a == b)
+    {
+        return;
+    }
+
+    // search the half-edges leaving the destination, then the origin
+    unsigned int origins[2] = { b, a };
+    unsigned int destinations[2] = { a, b };
+    for (unsigned int i=0; i<2; i++)
+    {
+        int h = m_firstHalfEdges[origins[i]];
+        while (h >= 0)
+        {
+            if ((h != (int)(a_halfEdge)) &&
+                (m_twins[h] < 0) &&
+                (m_positionIds[getDestination(h)] == destinations[i]))
+            {
+                m_twins[h] = (int)(a_halfEdge);
+                m_twins[a_halfEdge] = h;
+                return;
+            }
+            h = m_nextHalfEdges[h];
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,270 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CMeshAdjacencyH
+#define CMeshAdjacencyH
+//------------------------------------------------------------------------------
+#include "graphics/CVertexArray.h"
+#include "graphics/CTriangleArray.h"
+#include "graphics/CVertexWelder.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CMeshAdjacency.h
+
+    \brief
+    Implements a half-edge adjacency index for triangle meshes.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Minimum number of triangles for which the adjacency index is built by several threads.
+const unsigned int C_MESH_ADJACENCY_PARALLEL_THRESHOLD = 65536;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \class      cMeshAdjacency
+    \ingroup    graphics
+
+    \brief
+    This class implements a half-edge adjacency index for a triangle array.
+
+    \details
+    Each triangle __t__ owns three half-edges numbered 3t, 3t+1 and 3t+2,
+    which respectively go from vertex 0 to vertex 1, from vertex 1 to
+    vertex 2, and from vertex 2 to vertex 0 of the triangle. The index
+    stores, for every half-edge, its twin on the neighbouring triangle
+    (or -1 on a boundary), and for every vertex, the list of half-edges
+    leaving it. \n
+
+    Meshes loaded from files often duplicate vertices along texture or
+    normal seams. The index therefore connects vertices that share the same
+    position: every vertex is assigned a position identifier, and vertices
+    located at exactly the same position share the same identifier. Two
+    triangles are adjacent when they share two vertex positions, which
+    preserves the behavior of cMesh::computeAllEdges() on such meshes. When more
+    than two triangles share an edge, they are paired in increasing
+    half-edge order and the remaining one is considered a boundary. \n
+
+    The index is built with build() from the sorted keys of all edges, and
+    is kept up to date by addTriangle() and removeTriangle(), which cMesh
+    calls when triangles are created or removed. The index records the
+    topology version of the triangle array (see
+    cGenericArray::getTopologyVersion()) it matches, so that isUpToDate()
+    detects triangles created, removed or reconnected directly through the
+    triangle array. Such changes, and changes to vertex positions that make
+    coincident vertices part, require the index to be built again. Vertices created after the index was built are
+    matched against the positions vertices had when they were added to the
+    index.
+*/
+//==============================================================================
+class cMeshAdjacency
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cMeshAdjacency.
+    cMeshAdjacency(cVertexArrayPtr a_vertices, cTriangleArrayPtr a_triangles);
+
+    //! Destructor of cMeshAdjacency.
+    virtual ~cMeshAdjacency() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - BUILDING:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds the index for all allocated triangles.
+    void build();
+
+    //! This method clears the index.
+    void clear();
+
+    //! This method adds a newly allocated triangle to the index.
+    void addTriangle(const unsigned int a_triangleIndex);
+
+    //! This method removes a triangle from the index. It must be called before the triangle is deallocated.
+    void removeTriangle(const unsigned int a_triangleIndex);
+
+    //! This method returns __true__ if the triangle array has not been modified since the index was last brought up to date.
+    bool isUpToDate() const { return (m_triangles->getTopologyVersion() == m_topologyVersion); }
+
+    //! This method records that the index matches the triangle array, once all modifications of the array have been applied to it.
+    void setUpToDate() { m_topologyVersion = m_triangles->getTopologyVersion(); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - HALF-EDGES:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of half-edges of the index, including those of deallocated triangles.
+    unsigned int getNumHalfEdges() const { return ((unsigned int)(m_twins.size())); }
+
+    //! This method returns the triangle owning a half-edge.
+    static unsigned int getTriangle(const unsigned int a_halfEdge) { return (a_halfEdge / 3); }
+
+    //! This method returns the next half-edge around the triangle owning a half-edge.
+    static unsigned int getNext(const unsigned int a_halfEdge) { return ((a_halfEdge % 3 == 2) ? a_halfEdge - 2 : a_halfEdge + 1); }
+
+    //! This method returns the previous half-edge around the triangle owning a half-edge.
+    static unsigned int getPrevious(const unsigned int a_halfEdge) { return ((a_halfEdge % 3 == 0) ? a_halfEdge + 2 : a_halfEdge - 1); }
+
+    //! This method returns the index of the vertex a half-edge leaves from.
+    unsigned int getOrigin(const unsigned int a_halfEdge) const { return (m_triangles->m_indices[a_halfEdge]); }
+
+    //! This method returns the index of the vertex a half-edge points to.
+    unsigned int getDestination(const unsigned int a_halfEdge) const { return (m_triangles->m_indices[getNext(a_halfEdge)]); }
+
+    //! This method returns the twin of a half-edge, or -1 if the half-edge lies on a boundary.
+    int getTwin(const unsigned int a_halfEdge) const { return (m_twins[a_halfEdge]); }
+
+    //! This method returns __true__ if a half-edge lies on a boundary.
+    bool isBoundary(const unsigned int a_halfEdge) const { return (m_twins[a_halfEdge] < 0); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - VERTICES:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of distinct vertex positions of the index.
+    unsigned int getNumPositions() const { return ((unsigned int)(m_firstHalfEdges.size())); }
+
+    //! This method returns the position identifier of a vertex.
+    unsigned int getPositionId(const unsigned int a_vertexIndex) const { return (m_positionIds[a_vertexIndex]); }
+
+    //! This method returns the first half-edge leaving a position, or -1 if there is none.
+    int getFirstHalfEdge(const unsigned int a_positionId) const { return (m_firstHalfEdges[a_positionId]); }
+
+    //! This method returns the next half-edge leaving the same position as a half-edge, or -1 if there is none.
+    int getNextHalfEdge(const unsigned int a_halfEdge) const { return (m_nextHalfEdges[a_halfEdge]); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - NEIGHBOURHOOD QUERIES:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the triangles sharing a vertex position with a vertex.
+    void getVertexTriangles(const unsigned int a_vertexIndex,
+                            std::vector<unsigned int>& a_triangles) const;
+
+    //! This method returns the vertices connected to a vertex by an edge.
+    void getVertexNeighbors(const unsigned int a_vertexIndex,
+                            std::vector<unsigned int>& a_vertices) const;
+
+    //! This method returns the triangles sharing an edge with a triangle.
+    void getTriangleNeighbors(const unsigned int a_triangleIndex,
+                              std::vector<unsigned int>& a_triangles) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method assigns position identifiers to vertices created since the index was built.
+    void updatePositionIds();
+
+    //! This method pairs a half-edge with an unpaired half-edge joining the same positions, if any.
+    void pairHalfEdge(const unsigned int a_halfEdge);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Vertex array of the mesh.
+    cVertexArrayPtr m_vertices;
+
+    //! Triangle array of the mesh.
+    cTriangleArrayPtr m_triangles;
+
+    //! Position identifier of each vertex.
+    std::vector<unsigned int> m_positionIds;
+
+    //! Table assigning position identifiers to vertex positions.
+    cVertexWelder m_welder;
+
+    //! First half-edge leaving each position.
+    std::vector<int> m_firstHalfEdges;
+
+    //! Next half-edge leaving the same position as each half-edge.
+    std::vector<int> m_nextHalfEdges;
+
+    //! Twin of each half-edge.
+    std::vector<int> m_twins;
+
+    //! Topology version of the triangle array when the index was last brought up to date.
+    unsigned int m_topologyVersion;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -271,6 +271,9 @@ void cPointArray::compress()
     unsigned size = j+1;
     m_allocated.resize(size);
     m_indices.resize(1*size);
+
+    // element indices have changed
+    m_topologyVersion++;
 }
 
 
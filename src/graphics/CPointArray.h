@@ -145,6 +145,7 @@ public:
         m_indices.clear();
         m_freeElements.clear();
         m_flagMarkForResize     = true;
+        m_topologyVersion++;
     }
 
 
@@ -203,6 +204,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
 
         // return index number to new point
         return (index);
@@ -234,6 +236,7 @@ public:
 
             // mark for update
             m_flagMarkForUpdate = true;
+            m_topologyVersion++;
         }
     }
 
@@ -254,6 +257,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
     }
 
 
@@ -45,6 +45,8 @@
 #ifndef CRenderOptionsH
 #define CRenderOptionsH
 //------------------------------------------------------------------------------
+#include "math/CTransform.h"
+//------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
@@ -77,10 +79,38 @@ class cCamera;
     \details
     cRenderOptions provides a description about the options and entities that 
     need to be rendered in the world during a rendering pass. \n
+
+    When frustum culling is enabled, __m_frustumMatrix__ holds the product of
+    the projection, view and model matrices of the object currently being
+    rendered. Objects whose boundary boxes lie outside of the clipping volume
+    defined by this matrix are skipped, and the number of objects rendered
+    and skipped during the pass are accumulated in __m_numDrawnObjects__ and
+    __m_numCulledObjects__.
 */
 //==============================================================================
 struct cRenderOptions
 {
+    //! Constructor of cRenderOptions.
+    cRenderOptions()
+    {
+        m_camera                                = NULL;
+        m_single_pass_only                      = true;
+        m_render_opaque_objects_only            = false;
+        m_render_transparent_front_faces_only   = false;
+        m_render_transparent_back_faces_only    = false;
+        m_enable_lighting                       = true;
+        m_render_materials                      = true;
+        m_render_textures                       = true;
+        m_creating_shadow_map                   = false;
+        m_rendering_shadow                      = false;
+        m_shadow_light_level                    = 1.0;
+        m_storeObjectPositions                  = true;
+        m_markForUpdate                         = false;
+        m_frustumCulling                        = false;
+        m_numDrawnObjects                       = 0;
+        m_numCulledObjects                      = 0;
+    }
+
     //! Pointer to the current camera from which the scene is being rendered.
     cCamera* m_camera;
 
@@ -119,6 +149,18 @@ struct cRenderOptions
 
     //! If __true__, then reset OpenGL display lists and texture objects.
     bool m_markForUpdate;
+
+    //! If __true__, then objects located outside of the clipping volume are not rendered.
+    bool m_frustumCulling;
+
+    //! Product of the projection, view and model matrices of the object being rendered.
+    cTransform m_frustumMatrix;
+
+    //! Number of objects rendered during the current pass.
+    unsigned int m_numDrawnObjects;
+
+    //! Number of objects skipped by frustum culling during the current pass.
+    unsigned int m_numCulledObjects;
 };
 
 
@@ -133,7 +175,7 @@ struct cRenderOptions
     \return Result as described above.
 */
 //==============================================================================
-inline bool SECTION_RENDER_PARTS_WITH_MATERIALS(cRenderOptions a_options, bool a_useTransparency)
+inline bool SECTION_RENDER_PARTS_WITH_MATERIALS(const cRenderOptions& a_options, bool a_useTransparency)
 {
     return (!(
         ((a_options.m_render_opaque_objects_only) && (a_useTransparency)) ||
@@ -151,7 +193,7 @@ inline bool SECTION_RENDER_PARTS_WITH_MATERIALS(cRenderOptions a_options, bool a
     \return Result as described above.
 */
 //==============================================================================
-inline bool SECTION_RENDER_OPAQUE_PARTS_ONLY(cRenderOptions a_options)
+inline bool SECTION_RENDER_OPAQUE_PARTS_ONLY(const cRenderOptions& a_options)
 {
     return(!(a_options.m_render_transparent_back_faces_only ||
              a_options.m_render_transparent_front_faces_only));
@@ -320,6 +320,9 @@ void cSegmentArray::compress()
     unsigned size = j+1;
     m_allocated.resize(size);
     m_indices.resize(2*size);
+
+    // element indices have changed
+    m_topologyVersion++;
 }
 
 
@@ -143,6 +143,7 @@ public:
         m_indices.clear();
         m_freeElements.clear();
         m_flagMarkForUpdate     = true;
+        m_topologyVersion++;
         m_flagMarkForResize     = true;
     }
 
@@ -205,6 +206,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
 
         // return index to new segment
         return (index);
@@ -236,6 +238,7 @@ public:
 
             // mark for update
             m_flagMarkForUpdate = true;
+            m_topologyVersion++;
         }
     }
 
@@ -259,6 +262,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
     }
 
 
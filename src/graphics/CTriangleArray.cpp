@@ -536,6 +536,9 @@ void cTriangleArray::compress()
     unsigned size = j+1;
     m_allocated.resize(size);
     m_indices.resize(3*size);
+
+    // element indices have changed
+    m_topologyVersion++;
 }
 
 
@@ -144,6 +144,7 @@ public:
         m_indices.clear();
         m_freeElements.clear();
         m_flagMarkForUpdate     = true;
+        m_topologyVersion++;
         m_flagMarkForResize     = true;
     }
 
@@ -209,6 +210,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
 
         // return index to new triangle
         return (index);
@@ -240,6 +242,7 @@ public:
 
             // mark for update
             m_flagMarkForUpdate = true;
+            m_topologyVersion++;
         }
     }
 
@@ -266,6 +269,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
     }
 
 
@@ -284,6 +288,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
     };
 
 
@@ -317,6 +322,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
     };
 
 
@@ -350,6 +356,7 @@ public:
 
         // mark for update
         m_flagMarkForUpdate = true;
+        m_topologyVersion++;
     };
 
 
@@ -483,90 +490,109 @@ public:
 
     //--------------------------------------------------------------------------
     /*!
-         This method computes the normal matrix vectors for all triangles.
+         This method computes the tangent and bitangent vectors of a triangle
+         from the texture coordinates of its vertices. The vectors are not
+         normalized.
+
+         \param  a_triangleIndex  Index of triangle.
+         \param  a_tangent        Returned tangent vector.
+         \param  a_bitangent      Returned bitangent vector.
+
+         \return __false__ if the texture coordinates of the triangle are degenerate, __true__ otherwise.
     */
     //--------------------------------------------------------------------------
-    inline void computeBTN()
+    inline bool computeTriangleBTN(const unsigned int a_triangleIndex,
+                                   cVector3d& a_tangent,
+                                   cVector3d& a_bitangent) const
     {
-        unsigned int numTriangles = getNumElements();
-        for (unsigned i=0; i<numTriangles; i++)
+        unsigned int index0 = getVertexIndex0(a_triangleIndex);
+        unsigned int index1 = getVertexIndex1(a_triangleIndex);
+        unsigned int index2 = getVertexIndex2(a_triangleIndex);
+
+        // calculate the vectors from the current vertex to the two other vertices in the triangle
+        cVector3d v1v0 = m_vertices->m_localPos[index1] - m_vertices->m_localPos[index0];
+        cVector3d v2v0 = m_vertices->m_localPos[index2] - m_vertices->m_localPos[index0];
+
+        const cVector3d& tex0 = m_vertices->m_texCoord[index0];
+        const cVector3d& tex1 = m_vertices->m_texCoord[index1];
+        const cVector3d& tex2 = m_vertices->m_texCoord[index2];
+
+        // calculate c1c0_T and c1c0_B
+        double c1c0_T = tex1.x() - tex0.x();
+        double c1c0_B = tex1.y() - tex0.y();
+
+        // calculate c2c0_T and c2c0_B
+        double c2c0_T = tex2.x() - tex0.x();
+        double c2c0_B = tex2.y() - tex0.y();
+
+        double fDenominator = c1c0_T * c2c0_B - c2c0_T * c1c0_B;
+        if (fabs(fDenominator) < C_TINY)
         {
-            cVector3d T,B;
+            // we won't risk a divide by zero, so set the tangent matrix to the identity matrix
+            a_tangent.set(1.0, 0.0, 0.0);
+            a_bitangent.set(0.0, 1.0, 0.0);
+            return (false);
+        }
 
-            unsigned int index0 = getVertexIndex0(i);
-            unsigned int index1 = getVertexIndex1(i);
-            unsigned int index2 = getVertexIndex2(i);
+        // calculate the reciprocal value once and for all (to achieve speed)
+        double fScale1 = 1.0f / fDenominator;
 
-            // calculate the vectors from the current vertex to the two other vertices in the triangle
-            cVector3d v1v0 = m_vertices->getLocalPos(index1) - m_vertices->getLocalPos(index0);
-            cVector3d v2v0 = m_vertices->getLocalPos(index2) - m_vertices->getLocalPos(index0);
+        // T and B are calculated just as the equation in the article states
+        a_tangent.set((c2c0_B * v1v0.x() - c1c0_B * v2v0.x()) * fScale1,
+                      (c2c0_B * v1v0.y() - c1c0_B * v2v0.y()) * fScale1,
+                      (c2c0_B * v1v0.z() - c1c0_B * v2v0.z()) * fScale1);
 
-            cVector3d tex0 = m_vertices->getTexCoord(index0);
-            cVector3d tex1 = m_vertices->getTexCoord(index1);
-            cVector3d tex2 = m_vertices->getTexCoord(index2);
+        a_bitangent.set((-c2c0_T * v1v0.x() + c1c0_T * v2v0.x()) * fScale1,
+                        (-c2c0_T * v1v0.y() + c1c0_T * v2v0.y()) * fScale1,
+                        (-c2c0_T * v1v0.z() + c1c0_T * v2v0.z()) * fScale1);
 
-            // calculate c1c0_T and c1c0_B
-            double c1c0_T = tex1.x() - tex0.x();
-            double c1c0_B = tex1.y() - tex0.y();
+        return (true);
+    }
 
-            // calculate c2c0_T and c2c0_B
-            double c2c0_T = tex2.x() - tex0.x();
-            double c2c0_B = tex2.y() - tex0.y();
 
-            double fDenominator = c1c0_T * c2c0_B - c2c0_T * c1c0_B;
-            if (fabs(fDenominator) < C_TINY)
-            {
-                // we won't risk a divide by zero, so set the tangent matrix to the identity matrix
-                T = cVector3d(1.0, 0.0, 0.0);
-                B = cVector3d(0.0, 1.0, 0.0);
-            }
-            else
+    //--------------------------------------------------------------------------
+    /*!
+         This method computes the tangent and bitangent vectors of a vertex
+         by projecting the vectors of a triangle onto the plane normal to the
+         vertex normal.
+
+         \param  a_vertexIndex  Index of vertex.
+         \param  a_tangent      Tangent vector of the triangle.
+         \param  a_bitangent    Bitangent vector of the triangle.
+    */
+    //--------------------------------------------------------------------------
+    inline void setVertexBTN(const unsigned int a_vertexIndex,
+                             const cVector3d& a_tangent,
+                             const cVector3d& a_bitangent)
+    {
+        cVector3d N = m_vertices->m_normal[a_vertexIndex];
+        cVector3d T = cProjectPointOnPlane(a_tangent, cVector3d(0, 0, 0), N);
+        cVector3d B = cProjectPointOnPlane(a_bitangent, cVector3d(0, 0, 0), N);
+        T.normalize();
+        B.normalize();
+        m_vertices->m_tangent[a_vertexIndex] = T;
+        m_vertices->m_bitangent[a_vertexIndex] = B;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+         This method computes the normal matrix vectors for all triangles.
+         Each vertex receives the vectors of the last triangle it belongs to.
+    */
+    //--------------------------------------------------------------------------
+    inline void computeBTN()
+    {
+        unsigned int numTriangles = getNumElements();
+        for (unsigned i=0; i<numTriangles; i++)
+        {
+            cVector3d T,B;
+            if (computeTriangleBTN(i, T, B))
             {
-                // calculate the reciprocal value once and for all (to achieve speed)
-                double fScale1 = 1.0f / fDenominator;
-
-                // T and B are calculated just as the equation in the article states
-                T = cVector3d((c2c0_B * v1v0.x() - c1c0_B * v2v0.x()) * fScale1,
-                              (c2c0_B * v1v0.y() - c1c0_B * v2v0.y()) * fScale1,
-                              (c2c0_B * v1v0.z() - c1c0_B * v2v0.z()) * fScale1);
-
-                B = cVector3d((-c2c0_T * v1v0.x() + c1c0_T * v2v0.x()) * fScale1,
-                              (-c2c0_T * v1v0.y() + c1c0_T * v2v0.y()) * fScale1,
-                              (-c2c0_T * v1v0.z() + c1c0_T * v2v0.z()) * fScale1);
-
-                // Calculate the reciprocal value once and for all (to achieve speed)
-                /*
-                double fScale2 = 1.0f / ((T.x() * B.y() * N.z() - T.z() * B.y() * N.x()) +
-                                         (B.x() * N.y() * T.z() - B.z() * N.y() * T.x()) +
-                                         (N.x() * T.y() * B.z() - N.z() * T.y() * B.x()));
-                */
-
-                // compute tangent and bi-tangent vector for vertex 0
-                cVector3d N0 = m_vertices->getNormal(index0);
-                cVector3d T0 = cProjectPointOnPlane(T, cVector3d(0, 0, 0), N0);
-                cVector3d B0 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N0);
-                T0.normalize();
-                B0.normalize();
-                m_vertices->m_tangent[index0] = T0;
-                m_vertices->m_bitangent[index0] = B0;
-
-                // compute tangent and bi-tangent vector for vertex 1
-                cVector3d N1 = m_vertices->getNormal(index1);
-                cVector3d T1 = cProjectPointOnPlane(T, cVector3d(0, 0, 0), N1);
-                cVector3d B1 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N1);
-                T1.normalize();
-                B1.normalize();
-                m_vertices->m_tangent[index1] = T1;
-                m_vertices->m_bitangent[index1] = B1;
-
-                // compute tangent and bi-tangent vector for vertex 2
-                cVector3d N2 = m_vertices->getNormal(index2);
-                cVector3d T2 = cProjectPointOnPlane(T, cVector3d(0, 0, 0), N2);
-                cVector3d B2 = cProjectPointOnPlane(B, cVector3d(0, 0, 0), N2);
-                T2.normalize();
-                B2.normalize();
-                m_vertices->m_tangent[index2] = T2;
-                m_vertices->m_bitangent[index2] = B2;
+                // compute tangent and bi-tangent vectors for all three vertices
+                setVertexBTN(getVertexIndex0(i), T, B);
+                setVertexBTN(getVertexIndex1(i), T, B);
+                setVertexBTN(getVertexIndex2(i), T, B);
 
                 // mark for update
                 m_vertices->m_flagTangentData = true;
@@ -700,7 +726,6 @@ public:
                 m_vertices->setNormal(vertex0, normal);
                 m_vertices->setNormal(vertex1, normal);
                 m_vertices->setNormal(vertex2, normal);
-                m_vertices->m_flagNormalData = true;
             }
             return (normal);
         }
@@ -0,0 +1,564 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CVertexArray.h"
+//------------------------------------------------------------------------------
+#include "math/CMaths.h"
+//------------------------------------------------------------------------------
+#include <cstring>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// converts a single precision float to a half float, rounding to nearest
+static inline unsigned short cFloatToHalf(const float a_value)
+{
+    unsigned int bits;
+    memcpy(&bits, &a_value, sizeof(bits));
+
+    unsigned int sign = (bits >> 16) & 0x8000;
+    int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    unsigned int mantissa = bits & 0x007fffff;
+
+    // infinity and NaN
+    if (exponent == 128 + 15)
+    {
+        return ((unsigned short)(sign | 0x7c00 | (mantissa ? 0x0200 : 0)));
+    }
+
+    // overflow
+    if (exponent >= 31)
+    {
+        return ((unsigned short)(sign | 0x7c00));
+    }
+
+    // subnormal numbers and underflow
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+        {
+            return ((unsigned short)(sign));
+        }
+        mantissa = mantissa | 0x00800000;
+        unsigned int shift = (unsigned int)(14 - exponent);
+        unsigned int half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+        {
+            half++;
+        }
+        return ((unsigned short)(sign | half));
+    }
+
+    // normal numbers; a carry out of the mantissa correctly increments the exponent
+    unsigned int half = sign | ((unsigned int)(exponent) << 10) | (mantissa >> 13);
+    if (mantissa & 0x00001000)
+    {
+        half++;
+    }
+    return ((unsigned short)(half));
+}
+
+// converts a vector to a signed normalized 10-10-10-2 integer
+static inline unsigned int cVectorToSnorm10(const cVector3d& a_vector)
+{
+    unsigned int packed = 0;
+    for (int i=0; i<3; i++)
+    {
+        // the bias keeps the value positive, so that truncation rounds to nearest
+        double value = 511.0 * cClamp(a_vector(i), -1.0, 1.0);
+        int component = (int)(value + 512.5) - 512;
+        packed = packed | (((unsigned int)(component) & 0x3ff) << (10 * i));
+    }
+    return (packed);
+}
+
+// converts a color component to an unsigned normalized byte
+static inline unsigned char cColorToUnorm8(const float a_value)
+{
+    return ((unsigned char)(255.0f * cClamp(a_value, 0.0f, 1.0f) + 0.5f));
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    This method computes the offset of each property in a vertex of the
+    vertex buffers for the current buffer format.
+*/
+//==============================================================================
+void cVertexArray::updateBufferLayout()
+{
+    bool packed = (m_bufferFormat == C_VERTEX_BUFFER_FORMAT_PACKED);
+
+    // geometry buffer: position followed by normal
+    unsigned int offset = 3 * sizeof(float);
+
+    if (m_useNormalData)
+    {
+        m_bufferNormalOffset = offset;
+        offset += packed ? sizeof(unsigned int) : 3 * sizeof(float);
+    }
+
+    m_bufferStride[C_VERTEX_BUFFER_GEOMETRY] = offset;
+
+    // attribute buffer
+    offset = 0;
+
+    if (m_useTexCoordData)
+    {
+        m_bufferTexCoordOffset = offset;
+        offset += packed ? 4 * sizeof(unsigned short) : 3 * sizeof(float);
+    }
+
+    if (m_useColorData)
+    {
+        m_bufferColorOffset = offset;
+        offset += packed ? 4 * sizeof(unsigned char) : 4 * sizeof(float);
+    }
+
+    if (m_useTangentData)
+    {
+        m_bufferTangentOffset = offset;
+        offset += packed ? sizeof(unsigned int) : 3 * sizeof(float);
+    }
+
+    if (m_useBitangentData)
+    {
+        m_bufferBitangentOffset = offset;
+        offset += packed ? sizeof(unsigned int) : 3 * sizeof(float);
+    }
+
+    m_bufferStride[C_VERTEX_BUFFER_ATTRIBUTES] = offset;
+    m_bufferLayoutFormat = m_bufferFormat;
+}
+
+
+//==============================================================================
+/*!
+    This method converts a range of vertices to the format of a vertex
+    buffer and stores them in its client copy.
+
+    \param  a_buffer  __C_VERTEX_BUFFER_GEOMETRY__ or __C_VERTEX_BUFFER_ATTRIBUTES__.
+    \param  a_first   Index of the first vertex.
+    \param  a_last    Index following the last vertex.
+*/
+//==============================================================================
+void cVertexArray::packVertices(const unsigned int a_buffer,
+                                const unsigned int a_first,
+                                const unsigned int a_last)
+{
+    bool packed = (m_bufferLayoutFormat == C_VERTEX_BUFFER_FORMAT_PACKED);
+    unsigned int stride = m_bufferStride[a_buffer];
+
+    for (unsigned int i=a_first; i<a_last; i++)
+    {
+        unsigned char* vertex = &m_bufferData[a_buffer][i * stride];
+
+        if (a_buffer == C_VERTEX_BUFFER_GEOMETRY)
+        {
+            float* pos = (float*)(vertex);
+            pos[0] = (float)(m_localPos[i](0));
+            pos[1] = (float)(m_localPos[i](1));
+            pos[2] = (float)(m_localPos[i](2));
+
+            if (m_useNormalData)
+            {
+                if (packed)
+                {
+                    *(unsigned int*)(vertex + m_bufferNormalOffset) = cVectorToSnorm10(m_normal[i]);
+                }
+                else
+                {
+                    float* normal = (float*)(vertex + m_bufferNormalOffset);
+                    normal[0] = (float)(m_normal[i](0));
+                    normal[1] = (float)(m_normal[i](1));
+                    normal[2] = (float)(m_normal[i](2));
+                }
+            }
+            continue;
+        }
+
+        if (m_useTexCoordData)
+        {
+            if (packed)
+            {
+                unsigned short* texCoord = (unsigned short*)(vertex + m_bufferTexCoordOffset);
+                texCoord[0] = cFloatToHalf((float)(m_texCoord[i](0)));
+                texCoord[1] = cFloatToHalf((float)(m_texCoord[i](1)));
+                texCoord[2] = cFloatToHalf((float)(m_texCoord[i](2)));
+                texCoord[3] = 0;
+            }
+            else
+            {
+                float* texCoord = (float*)(vertex + m_bufferTexCoordOffset);
+                texCoord[0] = (float)(m_texCoord[i](0));
+                texCoord[1] = (float)(m_texCoord[i](1));
+                texCoord[2] = (float)(m_texCoord[i](2));
+            }
+        }
+
+        if (m_useColorData)
+        {
+            if (packed)
+            {
+                unsigned char* color = vertex + m_bufferColorOffset;
+                color[0] = cColorToUnorm8(m_color[i].getR());
+                color[1] = cColorToUnorm8(m_color[i].getG());
+                color[2] = cColorToUnorm8(m_color[i].getB());
+                color[3] = cColorToUnorm8(m_color[i].getA());
+            }
+            else
+            {
+                memcpy(vertex + m_bufferColorOffset, m_color[i].getData(), 4 * sizeof(float));
+            }
+        }
+
+        if (m_useTangentData)
+        {
+            if (packed)
+            {
+                *(unsigned int*)(vertex + m_bufferTangentOffset) = cVectorToSnorm10(m_tangent[i]);
+            }
+            else
+            {
+                float* tangent = (float*)(vertex + m_bufferTangentOffset);
+                tangent[0] = (float)(m_tangent[i](0));
+                tangent[1] = (float)(m_tangent[i](1));
+                tangent[2] = (float)(m_tangent[i](2));
+            }
+        }
+
+        if (m_useBitangentData)
+        {
+            if (packed)
+            {
+                *(unsigned int*)(vertex + m_bufferBitangentOffset) = cVectorToSnorm10(m_bitangent[i]);
+            }
+            else
+            {
+                float* bitangent = (float*)(vertex + m_bufferBitangentOffset);
+                bitangent[0] = (float)(m_bitangent[i](0));
+                bitangent[1] = (float)(m_bitangent[i](1));
+                bitangent[2] = (float)(m_bitangent[i](2));
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method converts the vertices modified since its last call to the
+    format of the vertex buffers and stores them in their client copies. If
+    the buffer format or the number of vertices has changed, or if a
+    property has been flagged as modified for all vertices, the entire
+    buffer storing this property is packed. Otherwise, only the blocks of
+    vertices marked by \ref markVertexModified() are packed. The packed
+    vertices of each buffer are reported by \ref getBufferSpans(). \n
+
+    This method is called by \ref renderInitialize().
+*/
+//==============================================================================
+void cVertexArray::updateBufferData()
+{
+    // update layout if the format or the number of vertices has changed
+    bool layout = m_flagBufferResize ||
+                  (m_bufferLayoutFormat != m_bufferFormat);
+
+    if (layout)
+    {
+        updateBufferLayout();
+        for (int i=0; i<2; i++)
+        {
+            m_bufferData[i].resize(m_numVertices * m_bufferStride[i]);
+        }
+        m_flagBufferResize = false;
+        m_flagBufferReallocate = true;
+    }
+
+    bool entireBuffer[2];
+    entireBuffer[C_VERTEX_BUFFER_GEOMETRY] = layout ||
+                                             m_flagPositionData ||
+                                             m_flagNormalData;
+    entireBuffer[C_VERTEX_BUFFER_ATTRIBUTES] = layout ||
+                                               m_flagTexCoordData ||
+                                               m_flagColorData ||
+                                               m_flagTangentData ||
+                                               m_flagBitangentData;
+
+    for (unsigned int i=0; i<2; i++)
+    {
+        m_bufferSpans[i].clear();
+
+        // the attribute buffer is empty if the vertices only store positions and normals
+        bool used = (m_bufferStride[i] > 0);
+
+        // pack entire buffer
+        if (used && entireBuffer[i])
+        {
+            packVertices(i, 0, m_numVertices);
+            m_bufferSpans[i].push_back(std::make_pair(0u, m_numVertices));
+        }
+
+        // pack modified blocks, merging adjacent blocks into spans
+        else if (used && m_flagModifiedBlocks[i])
+        {
+            std::vector<unsigned char>& blocks = m_modifiedBlocks[i];
+            unsigned int numBlocks = (unsigned int)(blocks.size());
+            unsigned int block = 0;
+            while (block < numBlocks)
+            {
+                if (!blocks[block])
+                {
+                    block++;
+                    continue;
+                }
+
+                unsigned int firstBlock = block;
+                while ((block < numBlocks) && (blocks[block]))
+                {
+                    block++;
+                }
+
+                unsigned int first = firstBlock << C_VERTEX_BUFFER_BLOCK_SHIFT;
+                unsigned int last = cMin(block << C_VERTEX_BUFFER_BLOCK_SHIFT, m_numVertices);
+                if (first < last)
+                {
+                    packVertices(i, first, last);
+                    m_bufferSpans[i].push_back(std::make_pair(first, last - first));
+                }
+            }
+        }
+
+        // clear modification flags
+        if (m_flagModifiedBlocks[i])
+        {
+            m_modifiedBlocks[i].assign(m_modifiedBlocks[i].size(), 0);
+            m_flagModifiedBlocks[i] = false;
+        }
+    }
+
+    m_flagPositionData  = false;
+    m_flagNormalData    = false;
+    m_flagTexCoordData  = false;
+    m_flagColorData     = false;
+    m_flagTangentData   = false;
+    m_flagBitangentData = false;
+}
+
+
+//==============================================================================
+/*!
+    This method allocates or updates the OpenGL vertex buffers and binds
+    their attributes. If the OpenGL context does not support packed
+    attributes, the buffer format falls back to
+    __C_VERTEX_BUFFER_FORMAT_FLOAT__.
+*/
+//==============================================================================
+void cVertexArray::renderInitialize()
+{
+#ifdef C_USE_OPENGL
+    // sanity check
+    if (m_numVertices == 0) { return; }
+
+    // packed attributes require OpenGL 3.3 or the corresponding extensions
+    if (m_bufferFormat == C_VERTEX_BUFFER_FORMAT_PACKED)
+    {
+        bool supported = false;
+#ifdef GLEW_VERSION
+        supported = (GLEW_VERSION_3_3 || (GLEW_ARB_vertex_type_2_10_10_10_rev && GLEW_ARB_half_float_vertex));
+#endif
+        if (!supported)
+        {
+            m_bufferFormat = C_VERTEX_BUFFER_FORMAT_FLOAT;
+        }
+    }
+
+    // create buffers first time
+    for (int i=0; i<2; i++)
+    {
+        if (m_vertexBuffer[i] == (GLuint)(-1))
+        {
+            glGenBuffers(1, &m_vertexBuffer[i]);
+            m_flagBufferReallocate = true;
+        }
+    }
+
+    // pack modified vertices
+    updateBufferData();
+
+    // upload buffers
+    for (int i=0; i<2; i++)
+    {
+        if (m_bufferData[i].size() == 0) { continue; }
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer[i]);
+        if (m_flagBufferReallocate)
+        {
+            glBufferData(GL_ARRAY_BUFFER, m_bufferData[i].size(), &(m_bufferData[i][0]), GL_STATIC_DRAW);
+        }
+        else
+        {
+            for (unsigned int j=0; j<m_bufferSpans[i].size(); j++)
+            {
+                unsigned int offset = m_bufferSpans[i][j].first * m_bufferStride[i];
+                unsigned int size = m_bufferSpans[i][j].second * m_bufferStride[i];
+                glBufferSubData(GL_ARRAY_BUFFER, offset, size, &(m_bufferData[i][offset]));
+            }
+        }
+    }
+    m_flagBufferReallocate = false;
+
+    // bind attributes
+    bool packed = (m_bufferLayoutFormat == C_VERTEX_BUFFER_FORMAT_PACKED);
+    GLsizei stride = (GLsizei)(m_bufferStride[C_VERTEX_BUFFER_GEOMETRY]);
+
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer[C_VERTEX_BUFFER_GEOMETRY]);
+        glEnableVertexAttribArray(C_VB_POSITION);
+        glVertexAttribPointer(C_VB_POSITION, 3, GL_FLOAT, GL_FALSE, stride, 0);
+        glVertexPointer(3, GL_FLOAT, stride, 0);
+    }
+
+    if (m_useNormalData)
+    {
+        const GLvoid* offset = (const GLvoid*)((size_t)(m_bufferNormalOffset));
+        glEnableVertexAttribArray(C_VB_NORMAL);
+        if (packed)
+        {
+            glVertexAttribPointer(C_VB_NORMAL, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, offset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_NORMAL);
+    }
+
+    stride = (GLsizei)(m_bufferStride[C_VERTEX_BUFFER_ATTRIBUTES]);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer[C_VERTEX_BUFFER_ATTRIBUTES]);
+
+    if (m_useTexCoordData)
+    {
+        const GLvoid* offset = (const GLvoid*)((size_t)(m_bufferTexCoordOffset));
+        glEnableVertexAttribArray(C_VB_TEXCOORD);
+        glVertexAttribPointer(C_VB_TEXCOORD, 3, packed ? GL_HALF_FLOAT : GL_FLOAT, GL_FALSE, stride, offset);
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_TEXCOORD);
+    }
+
+    if (m_useColorData)
+    {
+        const GLvoid* offset = (const GLvoid*)((size_t)(m_bufferColorOffset));
+        glEnableVertexAttribArray(C_VB_COLOR);
+        if (packed)
+        {
+            glVertexAttribPointer(C_VB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_COLOR, 4, GL_FLOAT, GL_FALSE, stride, offset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_COLOR);
+    }
+
+    if (m_useTangentData)
+    {
+        const GLvoid* offset = (const GLvoid*)((size_t)(m_bufferTangentOffset));
+        glEnableVertexAttribArray(C_VB_TANGENT);
+        if (packed)
+        {
+            glVertexAttribPointer(C_VB_TANGENT, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_TANGENT, 3, GL_FLOAT, GL_FALSE, stride, offset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_TANGENT);
+    }
+
+    if (m_useBitangentData)
+    {
+        const GLvoid* offset = (const GLvoid*)((size_t)(m_bufferBitangentOffset));
+        glEnableVertexAttribArray(C_VB_BITANGENT);
+        if (packed)
+        {
+            glVertexAttribPointer(C_VB_BITANGENT, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset);
+        }
+        else
+        {
+            glVertexAttribPointer(C_VB_BITANGENT, 3, GL_FLOAT, GL_FALSE, stride, offset);
+        }
+    }
+    else
+    {
+        glDisableVertexAttribArray(C_VB_BITANGENT);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -52,6 +52,7 @@
 //------------------------------------------------------------------------------
 #include <vector>
 #include <list>
+#include <utility>
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
@@ -66,6 +67,39 @@ namespace chai3d {
 //==============================================================================
 
 
+//------------------------------------------------------------------------------
+/*!
+    \brief
+    Format of the OpenGL vertex buffers of a vertex array.
+
+    \details
+    With __C_VERTEX_BUFFER_FORMAT_FLOAT__, every attribute is stored with
+    single precision floats. With __C_VERTEX_BUFFER_FORMAT_PACKED__,
+    positions are stored as floats, normals, tangents and bitangents as
+    signed normalized 10-10-10-2 integers, texture coordinates as half
+    floats and colors as unsigned bytes. Half float texture coordinates are
+    accurate to about 1/2048 within [0,1], which may not be sufficient for
+    very large textures or repeated texture coordinates.
+*/
+//------------------------------------------------------------------------------
+enum cVertexBufferFormat
+{
+    C_VERTEX_BUFFER_FORMAT_FLOAT,
+    C_VERTEX_BUFFER_FORMAT_PACKED
+};
+
+//------------------------------------------------------------------------------
+//! Vertex buffer storing positions and normals, which change when a mesh deforms.
+const unsigned int C_VERTEX_BUFFER_GEOMETRY     = 0;
+
+//! Vertex buffer storing texture coordinates, colors, tangents and bitangents.
+const unsigned int C_VERTEX_BUFFER_ATTRIBUTES   = 1;
+
+//! Number of vertices, as a power of two, covered by each modification flag of a vertex buffer.
+const unsigned int C_VERTEX_BUFFER_BLOCK_SHIFT  = 6;
+//------------------------------------------------------------------------------
+
+
 //==============================================================================
 /*!
     \struct     cVertexArrayOptions
@@ -128,6 +162,16 @@ typedef std::shared_ptr<cVertexArray> cVertexArrayPtr;
     The properties of each vertex can be modified by calling the appropriate 
     methods and by passing the vertex index as argument with the associated
     data. \n
+
+    For rendering, vertex properties are interleaved into two OpenGL vertex
+    buffers whose format is selected by \ref setBufferFormat(): one for
+    positions and normals, which change when a mesh deforms, and one for
+    all other properties. The setters record which blocks of vertices have
+    been modified, so that only those are packed and uploaded again.
+    Applications that write to the public arrays directly must either call
+    \ref markVertexModified() for each modified vertex, or set the flag of
+    the modified property (such as \ref m_flagNormalData) to upload it
+    entirely. \n
 */
 //==============================================================================
 class cVertexArray
@@ -149,6 +193,7 @@ public:
     //--------------------------------------------------------------------------
     cVertexArray(const cVertexArrayOptions& a_options)
     {
+        m_positionVersion = 0;
         clear();
         m_useNormalData     = a_options.m_useNormalData;
         m_useTexCoordData   = a_options.m_useTexCoordData;
@@ -164,12 +209,19 @@ public:
         m_flagBitangentData = false;
         m_flagUserData      = false;
         m_flagBufferResize  = true;
-        m_positionBuffer    = (GLuint)(-1);
-        m_normalBuffer      = (GLuint)(-1);
-        m_texCoordBuffer    = (GLuint)(-1);
-        m_colorBuffer       = (GLuint)(-1);
-        m_tangentBuffer     = (GLuint)(-1);
-        m_bitangentBuffer   = (GLuint)(-1);
+        m_flagBufferReallocate = true;
+        m_bufferFormat      = C_VERTEX_BUFFER_FORMAT_PACKED;
+        m_bufferLayoutFormat = C_VERTEX_BUFFER_FORMAT_PACKED;
+        m_bufferNormalOffset    = 0;
+        m_bufferTexCoordOffset  = 0;
+        m_bufferColorOffset     = 0;
+        m_bufferTangentOffset   = 0;
+        m_bufferBitangentOffset = 0;
+        for (int i=0; i<2; i++)
+        {
+            m_bufferStride[i] = 0;
+            m_vertexBuffer[i] = (GLuint)(-1);
+        }
     }
 
 
@@ -234,6 +286,15 @@ public:
         m_userData.clear();
         m_numVertices = 0;
         m_flagBufferResize = true;
+        m_modifiedPositions.clear();
+        m_allPositionsModifiedVersion = ++m_positionVersion;
+        for (int i=0; i<2; i++)
+        {
+            m_modifiedBlocks[i].clear();
+            m_flagModifiedBlocks[i] = false;
+            m_bufferData[i].clear();
+            m_bufferSpans[i].clear();
+        }
     }
 
 
@@ -269,6 +330,9 @@ public:
         vertexArray->m_useBitangentData = m_useBitangentData;
         vertexArray->m_useUserData = m_useUserData;
         vertexArray->m_numVertices = m_numVertices;
+        vertexArray->m_modifiedBlocks[0].assign(m_modifiedBlocks[0].size(), 0);
+        vertexArray->m_modifiedBlocks[1].assign(m_modifiedBlocks[1].size(), 0);
+        vertexArray->m_bufferFormat = m_bufferFormat;
 
         // return new vertex array
         return (vertexArray);
@@ -329,7 +393,7 @@ public:
                             const double& a_z)
     {
         m_localPos[a_vertexIndex].set(a_x, a_y, a_z);
-        m_flagPositionData = true;
+        markPositionModified(a_vertexIndex);
     }
 
 
@@ -345,7 +409,7 @@ public:
                             const cVector3d& a_pos)
     {
         m_localPos[a_vertexIndex] = a_pos;
-        m_flagPositionData = true;
+        markPositionModified(a_vertexIndex);
     }
 
 
@@ -362,7 +426,7 @@ public:
                           const cVector3d& a_translation)
     {
         m_localPos[a_vertexIndex].add(a_translation);
-        m_flagPositionData = true;
+        markPositionModified(a_vertexIndex);
     }
 
 
@@ -380,6 +444,123 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method records that the position of a selected vertex has been
+        modified. It is called by \ref setLocalPos() and \ref translate(), and
+        should be called by applications that write to \ref m_localPos 
+        directly. The vertex is appended to a list of modified vertices, which
+        collision detectors read to update only the parts of their trees that
+        have changed. Each reader keeps the version returned by 
+        \ref getPositionVersion() when it last read the list, so that several
+        readers can share the same vertex array. If the list grows beyond half
+        the number of vertices, it is discarded and all vertices are 
+        considered modified. The vertex is also marked for upload to the
+        vertex buffer.
+
+        \param  a_vertexIndex  Vertex index number.
+    */
+    //--------------------------------------------------------------------------
+    inline void markPositionModified(const unsigned int a_vertexIndex)
+    {
+        markVertexModified(a_vertexIndex);
+
+        if (2 * m_modifiedPositions.size() >= m_numVertices)
+        {
+            markAllPositionsModified();
+            return;
+        }
+
+        m_modifiedPositions.push_back(a_vertexIndex);
+        m_positionVersion++;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method records that one or more properties of a selected vertex
+        have been modified, so that the vertex is uploaded to the vertex buffer
+        storing these properties at the next rendering pass. It is called by
+        all setters, and should be called by applications that write to the
+        public arrays directly.
+
+        \param  a_vertexIndex  Vertex index number.
+        \param  a_buffer       __C_VERTEX_BUFFER_GEOMETRY__ for positions and normals, __C_VERTEX_BUFFER_ATTRIBUTES__ for other properties.
+    */
+    //--------------------------------------------------------------------------
+    inline void markVertexModified(const unsigned int a_vertexIndex,
+                                   const unsigned int a_buffer = C_VERTEX_BUFFER_GEOMETRY)
+    {
+        m_modifiedBlocks[a_buffer][a_vertexIndex >> C_VERTEX_BUFFER_BLOCK_SHIFT] = 1;
+        m_flagModifiedBlocks[a_buffer] = true;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method records that the position of all vertices may have been
+        modified.
+    */
+    //--------------------------------------------------------------------------
+    inline void markAllPositionsModified()
+    {
+        m_flagPositionData = true;
+        m_modifiedPositions.clear();
+        m_allPositionsModifiedVersion = ++m_positionVersion;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns a counter that is incremented each time a vertex
+        position is recorded as modified. Readers of the list of modified
+        vertices store this value after reading it, and pass it to
+        \ref getModifiedPositions() at the next update.
+
+        \return Current version of the vertex positions.
+    */
+    //--------------------------------------------------------------------------
+    inline unsigned long long getPositionVersion() const
+    {
+        return (m_positionVersion);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the vertices whose positions have been modified
+        since a version returned by \ref getPositionVersion(). A vertex may
+        appear several times in the list. The list is left untouched, so that
+        other readers can still retrieve it.
+
+        \param  a_version       Version at which the caller last read the list.
+        \param  a_positions     Returned pointer to the first modified vertex index.
+        \param  a_numPositions  Returned number of modified vertex indices.
+
+        \return __false__ if all vertex positions must be considered modified, __true__ otherwise.
+    */
+    //--------------------------------------------------------------------------
+    inline bool getModifiedPositions(const unsigned long long a_version,
+                                     const unsigned int*& a_positions,
+                                     unsigned int& a_numPositions) const
+    {
+        a_positions = NULL;
+        a_numPositions = 0;
+
+        if ((a_version < m_allPositionsModifiedVersion) || (a_version > m_positionVersion))
+        {
+            return (false);
+        }
+
+        a_numPositions = (unsigned int)(m_positionVersion - a_version);
+        if (a_numPositions > 0)
+        {
+            a_positions = &(m_modifiedPositions[m_modifiedPositions.size() - a_numPositions]);
+        }
+        return (true);
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method returns the global position of a selected vertex. This value 
@@ -410,7 +591,7 @@ public:
         if (m_useNormalData)
         {
             m_normal[a_vertexIndex] = a_normal;
-            m_flagNormalData = true;
+            markVertexModified(a_vertexIndex);
         }
     }
 
@@ -433,7 +614,7 @@ public:
         if (m_useNormalData)
         {
             m_normal[a_vertexIndex].set(a_x, a_y, a_z);
-            m_flagNormalData = true;
+            markVertexModified(a_vertexIndex);
         }
     }
 
@@ -466,7 +647,7 @@ public:
         if (m_useTexCoordData)
         {
             m_texCoord[a_vertexIndex] = a_texCoord;
-            m_flagTexCoordData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -490,7 +671,7 @@ public:
         if (m_useTexCoordData)
         {
             m_texCoord[a_vertexIndex].set(a_tx, a_ty,a_tz);
-            m_flagTexCoordData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -523,7 +704,7 @@ public:
         if (m_useColorData)
         {
             m_color[a_vertexIndex] = a_color;
-            m_flagColorData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -549,7 +730,7 @@ public:
         if (m_useColorData)
         {
             m_color[a_vertexIndex].set(a_red, a_green, a_blue, a_alpha);
-            m_flagColorData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -568,7 +749,7 @@ public:
         if (m_useColorData)
         {
             m_color[a_vertexIndex] = a_color.getColorf();
-            m_flagColorData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -601,7 +782,7 @@ public:
         if (m_useTangentData)
         {
             m_tangent[a_vertexIndex] = a_tangent;
-            m_flagTangentData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -624,7 +805,7 @@ public:
         if (m_useTangentData)
         {
             m_tangent[a_vertexIndex].set(a_x, a_y, a_z);
-            m_flagTangentData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -657,7 +838,7 @@ public:
         if (m_useBitangentData)
         {
             m_bitangent[a_vertexIndex] = a_bitangent;
-            m_flagBitangentData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -680,7 +861,7 @@ public:
         if (m_useBitangentData)
         {
             m_bitangent[a_vertexIndex].set(a_x, a_y, a_z);
-            m_flagBitangentData = true;
+            markVertexModified(a_vertexIndex, C_VERTEX_BUFFER_ATTRIBUTES);
         }
     }
 
@@ -850,190 +1031,84 @@ public:
 
     //--------------------------------------------------------------------------
     /*!
-        This method allocates or updates all OpenGL buffers.
+        This method sets the format of the OpenGL vertex buffers. The buffers
+        are packed and uploaded again at the next rendering pass.
+
+        \param  a_bufferFormat  Vertex buffer format.
     */
     //--------------------------------------------------------------------------
-    inline void renderInitialize()
-    { 
-#ifdef C_USE_OPENGL
-        // create buffers first time
-        if (m_positionBuffer == (GLuint)(-1))
-        {
-            glGenBuffers(1, &m_positionBuffer);
-        }
-        
-        if ((m_normalBuffer == (GLuint)(-1)) && (m_useNormalData))
-        {
-            glGenBuffers(1, &m_normalBuffer);
-        }
-        
-        if ((m_texCoordBuffer == (GLuint)(-1)) && (m_useTexCoordData))
-        {
-            glGenBuffers(1, &m_texCoordBuffer);
-        }
-        
-        if ((m_colorBuffer == (GLuint)(-1)) && (m_useColorData))
-        {
-            glGenBuffers(1, &m_colorBuffer);
-        }
-        
-        if ((m_tangentBuffer == (GLuint)(-1)) && (m_useTangentData))
-        {
-            glGenBuffers(1, &m_tangentBuffer);
-        }
-        
-        if ((m_bitangentBuffer == (GLuint)(-1)) && (m_useBitangentData))
-        {
-            glGenBuffers(1, &m_bitangentBuffer);
-        }
+    inline void setBufferFormat(const cVertexBufferFormat a_bufferFormat)
+    {
+        m_bufferFormat = a_bufferFormat;
+    }
 
-        // resize buffers
-        if (m_flagBufferResize)
-        {
-            if (true)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_localPos[0]), GL_STATIC_DRAW);
-            }
 
-            if (m_useNormalData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_normal[0]), GL_STATIC_DRAW);
-            }
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the format of the OpenGL vertex buffers.
 
-            if (m_useTexCoordData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]), GL_STATIC_DRAW);
-            }
+        \return Vertex buffer format.
+    */
+    //--------------------------------------------------------------------------
+    inline cVertexBufferFormat getBufferFormat() const
+    {
+        return (m_bufferFormat);
+    }
 
-            if (m_useColorData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cColorf), &(m_color[0]), GL_STATIC_DRAW);
-            }
 
-            if (m_useTangentData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_tangent[0]), GL_STATIC_DRAW);
-            }
-        
-            if (m_useBitangentData)
-            {
-                glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-                glBufferData(GL_ARRAY_BUFFER, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]), GL_STATIC_DRAW);
-            }
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the size in bytes of a vertex in a vertex buffer.
+        It is only valid once the buffers have been updated.
 
-            m_flagBufferResize = false;
-        }
+        \param  a_buffer  __C_VERTEX_BUFFER_GEOMETRY__ or __C_VERTEX_BUFFER_ATTRIBUTES__.
 
-        // update buffers if needed
-        if (m_flagPositionData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_localPos[0]));
-            m_flagPositionData = false;
-        }
-        if (m_flagNormalData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_normal[0]));
-            m_flagNormalData = false;
-        }
-        if (m_flagTexCoordData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_texCoord[0]));
-            m_flagTexCoordData = false;
-        }
-        if (m_flagColorData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cColorf), &(m_color[0]));
-            m_flagColorData = false;
-        }
-        if (m_flagTangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_tangent[0]));
-            m_flagTangentData = false;
-        }
-        if (m_flagBitangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, m_numVertices * sizeof(cVector3d), &(m_bitangent[0]));
-            m_flagBitangentData = false;
-        }
+        \return Size of a vertex in bytes.
+    */
+    //--------------------------------------------------------------------------
+    inline unsigned int getBufferStride(const unsigned int a_buffer) const
+    {
+        return (m_bufferStride[a_buffer]);
+    }
 
-        // bind buffers and set client state
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
-            glEnableVertexAttribArray(C_VB_POSITION);
-            glVertexAttribPointer(C_VB_POSITION, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-            glVertexPointer(3, GL_DOUBLE, 0, 0);
-        }
-        
-        if (m_useNormalData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_normalBuffer);
-            glEnableVertexAttribArray(C_VB_NORMAL);
-            glVertexAttribPointer(C_VB_NORMAL, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_NORMAL);
-        }
 
-        if (m_useTexCoordData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
-            glEnableVertexAttribArray(C_VB_TEXCOORD);
-            glVertexAttribPointer(C_VB_TEXCOORD, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_TEXCOORD);
-        }
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the spans of vertices of a vertex buffer, given as
+        pairs of first vertex and number of vertices, that were packed by the
+        last call to \ref updateBufferData().
 
-        if (m_useColorData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_colorBuffer);
-            glEnableVertexAttribArray(C_VB_COLOR);
-            glVertexAttribPointer(C_VB_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(cColorf), 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_COLOR);
-        }
+        \param  a_buffer  __C_VERTEX_BUFFER_GEOMETRY__ or __C_VERTEX_BUFFER_ATTRIBUTES__.
 
-        if (m_useTangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_tangentBuffer);
-            glEnableVertexAttribArray(C_VB_TANGENT);
-            glVertexAttribPointer(C_VB_TANGENT, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_TANGENT);
-        }
+        \return Spans of modified vertices.
+    */
+    //--------------------------------------------------------------------------
+    inline const std::vector<std::pair<unsigned int, unsigned int> >& getBufferSpans(const unsigned int a_buffer) const
+    {
+        return (m_bufferSpans[a_buffer]);
+    }
 
-        if (m_useBitangentData)
-        {
-            glBindBuffer(GL_ARRAY_BUFFER, m_bitangentBuffer);
-            glEnableVertexAttribArray(C_VB_BITANGENT);
-            glVertexAttribPointer(C_VB_BITANGENT, 3, GL_DOUBLE, GL_FALSE, 0, 0);
-        }
-        else
-        {
-            glDisableVertexAttribArray(C_VB_BITANGENT);
-        }
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-#endif
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns the client copy of a vertex buffer.
+
+        \param  a_buffer  __C_VERTEX_BUFFER_GEOMETRY__ or __C_VERTEX_BUFFER_ATTRIBUTES__.
+
+        \return Packed vertex data.
+    */
+    //--------------------------------------------------------------------------
+    inline const std::vector<unsigned char>& getBufferData(const unsigned int a_buffer) const
+    {
+        return (m_bufferData[a_buffer]);
     }
 
+    //! This method packs the modified vertices into the client copies of the vertex buffers.
+    void updateBufferData();
+
+    //! This method allocates or updates the OpenGL vertex buffers and binds their attributes.
+    void renderInitialize();
+
 
     //--------------------------------------------------------------------------
     /*!
@@ -1082,6 +1157,13 @@ public:
         m_localPos.resize(m_numVertices, pos);
         m_globalPos.resize(m_numVertices, pos);
 
+        // new vertices invalidate the list of modified positions
+        markAllPositionsModified();
+
+        // update modification flags of the vertex buffers
+        m_modifiedBlocks[0].resize((m_numVertices >> C_VERTEX_BUFFER_BLOCK_SHIFT) + 1, 0);
+        m_modifiedBlocks[1].resize((m_numVertices >> C_VERTEX_BUFFER_BLOCK_SHIFT) + 1, 0);
+
         // update normal data allocation
         m_useNormalData = a_useNormalData;
         if (m_useNormalData)
@@ -1265,6 +1347,67 @@ protected:
     //! If __true__ then surface bitangent data will be allocated for each new vertex.
     bool m_useUserData;
 
+    //! List of vertices whose positions have been modified since \ref m_allPositionsModifiedVersion.
+    std::vector<unsigned int> m_modifiedPositions;
+
+    //! Counter incremented each time a vertex position is recorded as modified.
+    unsigned long long m_positionVersion;
+
+    //! Value of \ref m_positionVersion when all vertex positions were last marked as modified.
+    unsigned long long m_allPositionsModifiedVersion;
+
+    //! For each vertex buffer and block of vertices, nonzero if a vertex of the block must be uploaded.
+    std::vector<unsigned char> m_modifiedBlocks[2];
+
+    //! For each vertex buffer, __true__ if at least one entry of \ref m_modifiedBlocks is set.
+    bool m_flagModifiedBlocks[2];
+
+    //! If __true__ then the OpenGL vertex buffers must be reallocated.
+    bool m_flagBufferReallocate;
+
+    //! Requested format of the vertex buffer.
+    cVertexBufferFormat m_bufferFormat;
+
+    //! Format of the data currently stored in \ref m_bufferData.
+    cVertexBufferFormat m_bufferLayoutFormat;
+
+    //! Size in bytes of a vertex in each vertex buffer.
+    unsigned int m_bufferStride[2];
+
+    //! Offset in bytes of the normal in a vertex of the geometry buffer.
+    unsigned int m_bufferNormalOffset;
+
+    //! Offset in bytes of the texture coordinate in a vertex of the attribute buffer.
+    unsigned int m_bufferTexCoordOffset;
+
+    //! Offset in bytes of the color in a vertex of the attribute buffer.
+    unsigned int m_bufferColorOffset;
+
+    //! Offset in bytes of the tangent in a vertex of the attribute buffer.
+    unsigned int m_bufferTangentOffset;
+
+    //! Offset in bytes of the bitangent in a vertex of the attribute buffer.
+    unsigned int m_bufferBitangentOffset;
+
+    //! Client copy of each vertex buffer.
+    std::vector<unsigned char> m_bufferData[2];
+
+    //! Spans of vertices of each vertex buffer packed by the last call to \ref updateBufferData().
+    std::vector<std::pair<unsigned int, unsigned int> > m_bufferSpans[2];
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method computes the layout of a vertex in the vertex buffers.
+    void updateBufferLayout();
+
+    //! This method packs a range of vertices into the client copy of a vertex buffer.
+    void packVertices(const unsigned int a_buffer, const unsigned int a_first, const unsigned int a_last);
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -1272,22 +1415,22 @@ protected:
 
 public:
 
-    //! If __true__ then position data has been modified.
+    //! If __true__ then position data of all vertices has been modified.
     bool m_flagPositionData;
 
-    //! If __true__ then normal data has been modified.
+    //! If __true__ then normal data of all vertices has been modified.
     bool m_flagNormalData;
 
-    //! If __true__ then texture coordinate data has been modified.
+    //! If __true__ then texture coordinate data of all vertices has been modified.
     bool m_flagTexCoordData;
 
-    //! If __true__ then vertex color data has been modified.
+    //! If __true__ then vertex color data of all vertices has been modified.
     bool m_flagColorData;
 
-    //! If __true__ then surface tangent data has been modified.
+    //! If __true__ then surface tangent data of all vertices has been modified.
     bool m_flagTangentData;
 
-    //! If __true__ then surface bitangent data has been modified.
+    //! If __true__ then surface bitangent data of all vertices has been modified.
     bool m_flagBitangentData;
 
     //! If __true__ then user data has been modified.
@@ -1303,23 +1446,8 @@ public:
 
 public:
 
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_positionBuffer;
-
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_normalBuffer;
-
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_texCoordBuffer;
-
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_colorBuffer;
-
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_tangentBuffer;
-
-    //! OpenGL Buffer for storing triangle indices.
-    GLuint m_bitangentBuffer;
+    //! OpenGL Buffers for storing the interleaved geometry and attribute data.
+    GLuint m_vertexBuffer[2];
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,357 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CVertexWelder.h"
+#include "math/CMaths.h"
+//------------------------------------------------------------------------------
+#include <cmath>
+#include <cstring>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// ratio between the edge length of a cell and the welding tolerance
+static const double C_WELDER_CELL_RATIO = 8.0;
+
+// initial number of buckets
+static const unsigned int C_WELDER_MIN_BUCKETS = 1024;
+
+// mixes a 64-bit value into a hash key
+static inline unsigned long long cWelderMix(unsigned long long a_hash, unsigned long long a_value)
+{
+    a_hash ^= a_value + 0x9e3779b97f4a7c15ULL + (a_hash << 6) + (a_hash >> 2);
+    a_hash ^= a_hash >> 33;
+    a_hash *= 0xff51afd7ed558ccdULL;
+    a_hash ^= a_hash >> 33;
+    return (a_hash);
+}
+
+//------------------------------------------------------------------------------
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cVertexWelder.
+
+    \param  a_tolerance  Distance below which two positions are merged.
+*/
+//==============================================================================
+cVertexWelder::cVertexWelder(const double a_tolerance)
+{
+    setTolerance(a_tolerance);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the distance below which two positions are merged.
+    Positions already stored in the table are removed.
+
+    \param  a_tolerance  Distance below which two positions are merged.
+*/
+//==============================================================================
+void cVertexWelder::setTolerance(const double a_tolerance)
+{
+    m_tolerance = (a_tolerance > 0.0) ? a_tolerance : 0.0;
+    m_cellSize = C_WELDER_CELL_RATIO * m_tolerance;
+    clear();
+}
+
+
+//==============================================================================
+/*!
+    This method removes all positions from the table.
+*/
+//==============================================================================
+void cVertexWelder::clear()
+{
+    m_vertices.clear();
+    m_keys.clear();
+    m_next.clear();
+    m_buckets.assign(C_WELDER_MIN_BUCKETS, -1);
+}
+
+
+//==============================================================================
+/*!
+    This method reserves memory for a number of distinct positions, so that
+    the table does not need to grow while they are added.
+
+    \param  a_numVertices  Expected number of distinct positions.
+*/
+//==============================================================================
+void cVertexWelder::reserve(const unsigned int a_numVertices)
+{
+    m_vertices.reserve(a_numVertices);
+    m_keys.reserve(a_numVertices);
+    m_next.reserve(a_numVertices);
+
+    // keep the load factor of the table below one half
+    unsigned int numBuckets = (unsigned int)(m_buckets.size());
+    while (numBuckets < 2 * a_numVertices)
+    {
+        numBuckets *= 2;
+    }
+    if (numBuckets > m_buckets.size())
+    {
+        m_buckets.assign(numBuckets, -1);
+        for (unsigned int i=0; i<m_vertices.size(); i++)
+        {
+            insert(i, m_keys[i]);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the index of a position. If a position located within
+    the tolerance of __a_pos__ is already stored in the table, the index of
+    the first such position is returned. Otherwise __a_pos__ is added to the
+    table, and receives the next available index.
+
+    \param  a_pos  Position.
+    \param  a_new  Set to __true__ if the position has been added to the table.
+
+    \return Index of the position.
+*/
+//==============================================================================
+unsigned int cVertexWelder::weld(const cVector3d& a_pos, bool& a_new)
+{
+    unsigned int mask = (unsigned int)(m_buckets.size()) - 1;
+    unsigned int key;
+
+    if (m_tolerance == 0.0)
+    {
+        // exact matching: a single bucket may contain the position
+        key = computeKey(a_pos);
+        int index = findInBucket(key & mask, a_pos);
+        if (index >= 0)
+        {
+            a_new = false;
+            return ((unsigned int)index);
+        }
+    }
+    else
+    {
+        // compute cell containing the position, and neighboring cells located within the tolerance
+        long long cell[3];
+        int lower[3], upper[3];
+        for (int i=0; i<3; i++)
+        {
+            double c = floor(a_pos(i) / m_cellSize);
+            double offset = a_pos(i) - c * m_cellSize;
+            cell[i] = (long long)c;
+            lower[i] = (offset <= m_tolerance) ? -1 : 0;
+            upper[i] = (m_cellSize - offset <= m_tolerance) ? 1 : 0;
+        }
+        key = computeKey(cell);
+
+        // search all cells, keeping the position that was added first
+        int index = -1;
+        for (int x=lower[0]; x<=upper[0]; x++)
+        {
+            for (int y=lower[1]; y<=upper[1]; y++)
+            {
+                for (int z=lower[2]; z<=upper[2]; z++)
+                {
+                    long long neighbor[3] = { cell[0] + x, cell[1] + y, cell[2] + z };
+                    int result = findInBucket(computeKey(neighbor) & mask, a_pos);
+                    if ((result >= 0) && ((index < 0) || (result < index)))
+                    {
+                        index = result;
+                    }
+                }
+            }
+        }
+        if (index >= 0)
+        {
+            a_new = false;
+            return ((unsigned int)index);
+        }
+    }
+
+    // add new position
+    unsigned int index = (unsigned int)(m_vertices.size());
+    m_vertices.push_back(a_pos);
+    m_keys.push_back(key);
+    m_next.push_back(-1);
+    insert(index, key);
+
+    // grow table
+    if (m_vertices.size() > m_buckets.size() / 2)
+    {
+        rehash();
+    }
+
+    a_new = true;
+    return (index);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the hash key of a position, computed from the bit
+    patterns of its coordinates. Negative zero is treated as positive zero,
+    so that both compare equal.
+
+    \param  a_pos  Position.
+
+    \return Hash key.
+*/
+//==============================================================================
+unsigned int cVertexWelder::computeKey(const cVector3d& a_pos) const
+{
+    unsigned long long hash = 0;
+    for (int i=0; i<3; i++)
+    {
+        double value = (a_pos(i) == 0.0) ? 0.0 : a_pos(i);
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        hash = cWelderMix(hash, bits);
+    }
+    return ((unsigned int)(hash ^ (hash >> 32)));
+}
+
+
+//==============================================================================
+/*!
+    This method returns the hash key of a cell.
+
+    \param  a_cell  Integer coordinates of the cell.
+
+    \return Hash key.
+*/
+//==============================================================================
+unsigned int cVertexWelder::computeKey(const long long a_cell[3]) const
+{
+    unsigned long long hash = 0;
+    for (int i=0; i<3; i++)
+    {
+        hash = cWelderMix(hash, (unsigned long long)(a_cell[i]));
+    }
+    return ((unsigned int)(hash ^ (hash >> 32)));
+}
+
+
+//==============================================================================
+/*!
+    This method returns the smallest index of the positions stored in a
+    bucket that match __a_pos__.
+
+    \param  a_bucket  Bucket index.
+    \param  a_pos     Position.
+
+    \return Index of the matching position, or -1 if none matches.
+*/
+//==============================================================================
+int cVertexWelder::findInBucket(const unsigned int a_bucket, const cVector3d& a_pos) const
+{
+    // positions are inserted at the head of the chains, so the last match is the oldest
+    int result = -1;
+    double tolerance2 = m_tolerance * m_tolerance;
+    for (int i = m_buckets[a_bucket]; i >= 0; i = m_next[i])
+    {
+        const cVector3d& v = m_vertices[i];
+        if (m_tolerance == 0.0)
+        {
+            if ((v(0) == a_pos(0)) && (v(1) == a_pos(1)) && (v(2) == a_pos(2)))
+            {
+                result = i;
+            }
+        }
+        else if (cDistanceSq(v, a_pos) <= tolerance2)
+        {
+            result = i;
+        }
+    }
+    return (result);
+}
+
+
+//==============================================================================
+/*!
+    This method inserts a stored position at the head of its bucket.
+
+    \param  a_index  Index of the position.
+    \param  a_key    Hash key of the position.
+*/
+//==============================================================================
+void cVertexWelder::insert(const unsigned int a_index, const unsigned int a_key)
+{
+    unsigned int bucket = a_key & ((unsigned int)(m_buckets.size()) - 1);
+    m_next[a_index] = m_buckets[bucket];
+    m_buckets[bucket] = (int)a_index;
+}
+
+
+//==============================================================================
+/*!
+    This method doubles the number of buckets and redistributes the stored
+    positions. Positions are inserted in increasing order, so that chains
+    remain sorted from the newest to the oldest position.
+*/
+//==============================================================================
+void cVertexWelder::rehash()
+{
+    m_buckets.assign(2 * m_buckets.size(), -1);
+    unsigned int numVertices = (unsigned int)(m_vertices.size());
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        insert(i, m_keys[i]);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
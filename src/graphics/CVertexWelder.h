@@ -0,0 +1,188 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CVertexWelderH
+#define CVertexWelderH
+//------------------------------------------------------------------------------
+#include "math/CVector3d.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CVertexWelder.h
+
+    \brief
+    Implements a hash table for merging coincident vertices.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cVertexWelder
+    \ingroup    graphics
+
+    \brief
+    This class implements a hash table that merges coincident vertices.
+
+    \details
+    cVertexWelder assigns an index to every position it is given. Positions
+    located within a tolerance of a position added earlier receive the index
+    of that position, so that file loaders can build meshes whose triangles
+    share their vertices in a single pass over the file. \n
+
+    When the tolerance is zero, positions are merged only if they are
+    exactly equal. Otherwise, space is divided into cells several times
+    larger than the tolerance, and a position is compared against the
+    positions stored in its own cell, and in the neighboring cells it lies
+    within the tolerance of. When several stored positions match, the one
+    that was added first is returned, so that the result does not depend on
+    how positions are distributed in the table.
+*/
+//==============================================================================
+class cVertexWelder
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cVertexWelder.
+    cVertexWelder(const double a_tolerance = 0.0);
+
+    //! Destructor of cVertexWelder.
+    virtual ~cVertexWelder() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets the distance below which two positions are merged. The table is cleared.
+    void setTolerance(const double a_tolerance);
+
+    //! This method returns the distance below which two positions are merged.
+    double getTolerance() const { return (m_tolerance); }
+
+    //! This method removes all positions from the table.
+    void clear();
+
+    //! This method reserves memory for a number of distinct positions.
+    void reserve(const unsigned int a_numVertices);
+
+    //! This method returns the index of a position, adding it to the table if no stored position matches.
+    unsigned int weld(const cVector3d& a_pos, bool& a_new);
+
+    //! This method returns the index of a position, adding it to the table if no stored position matches.
+    unsigned int weld(const cVector3d& a_pos) { bool added; return (weld(a_pos, added)); }
+
+    //! This method returns the number of distinct positions stored in the table.
+    unsigned int getNumVertices() const { return ((unsigned int)(m_vertices.size())); }
+
+    //! This method returns the position stored at index __a_index__.
+    const cVector3d& getVertex(const unsigned int a_index) const { return (m_vertices[a_index]); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns the hash key of a position.
+    unsigned int computeKey(const cVector3d& a_pos) const;
+
+    //! This method returns the hash key of a cell.
+    unsigned int computeKey(const long long a_cell[3]) const;
+
+    //! This method returns the index of the first position matching __a_pos__ in a bucket, or -1.
+    int findInBucket(const unsigned int a_bucket, const cVector3d& a_pos) const;
+
+    //! This method inserts a stored position in the buckets.
+    void insert(const unsigned int a_index, const unsigned int a_key);
+
+    //! This method doubles the number of buckets.
+    void rehash();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Distance below which two positions are merged.
+    double m_tolerance;
+
+    //! Edge length of the cells dividing space when the tolerance is not zero.
+    double m_cellSize;
+
+    //! Distinct positions stored in the table.
+    std::vector<cVector3d> m_vertices;
+
+    //! Hash key of each stored position.
+    std::vector<unsigned int> m_keys;
+
+    //! Next position in the same bucket for each stored position, or -1.
+    std::vector<int> m_next;
+
+    //! First position of each bucket, or -1. The number of buckets is a power of two.
+    std::vector<int> m_buckets;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
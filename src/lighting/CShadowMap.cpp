@@ -73,6 +73,10 @@ cShadowMap::cShadowMap()
 
     // assign texture unit for shadows.
     m_depthBuffer->setTextureUnit(GL_TEXTURE1);
+
+    // reset culling statistics
+    m_numDrawnObjects = 0;
+    m_numCulledObjects = 0;
 }
 
 
@@ -332,10 +336,16 @@ bool cShadowMap::updateMap(cWorld* a_world,
         options.m_shadow_light_level                    = 1.0;
         options.m_storeObjectPositions                  = true;
         options.m_markForUpdate                         = false;
+        options.m_frustumCulling                        = a_world->getUseFrustumCulling();
+        options.m_frustumMatrix                         = projectionMatrix * viewMatrix;
 
         // render single pass (all objects)
         a_world->renderSceneGraph(options);
 
+        // store culling statistics
+        m_numDrawnObjects = options.m_numDrawnObjects;
+        m_numCulledObjects = options.m_numCulledObjects;
+
         // finalize
         renderFinalize();
 
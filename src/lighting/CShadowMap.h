@@ -115,6 +115,12 @@ public:
     //! This method sets the quality resolution of the shadow map to 4096 x 4096 pixels.
     void setQualityVeryHigh() { setSize(4096, 4096); }
 
+    //! This method returns the number of objects rendered during the last update of the shadow map.
+    unsigned int getNumDrawnObjects() const { return (m_numDrawnObjects); }
+
+    //! This method returns the number of objects skipped by frustum culling during the last update of the shadow map.
+    unsigned int getNumCulledObjects() const { return (m_numCulledObjects); }
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -158,6 +164,12 @@ protected:
 
     //! If __true__, then shadow map is enabled, __false__ otherwise.
     bool m_enabled;
+
+    //! Number of objects rendered during the last update of the shadow map.
+    unsigned int m_numDrawnObjects;
+
+    //! Number of objects skipped by frustum culling during the last update of the shadow map.
+    unsigned int m_numCulledObjects;
 };
 
 //------------------------------------------------------------------------------
@@ -357,6 +357,14 @@ void cTexture3d::update(cRenderOptions& a_options)
         m_deleteTextureFlag = false;
     }
 
+    // sparse images are uploaded brick by brick
+    cBrickImage* brickImage = dynamic_cast<cBrickImage*>(m_image.get());
+    if (brickImage != NULL)
+    {
+        updateBricks(brickImage);
+        return;
+    }
+
     if (m_textureID == 0)
     {
         glGenTextures(1, &m_textureID);
@@ -474,6 +482,113 @@ void cTexture3d::update(cRenderOptions& a_options)
 }
 
 
+//==============================================================================
+/*!
+    This method updates the texture from a sparse brick image to GPU. The
+    texture is allocated at the full size of the volume, and each brick is
+    uploaded separately, so that no contiguous copy of the volume is ever
+    created in memory. Unallocated bricks are uploaded from a single brick
+    filled with the background color. When a partial update has been
+    requested, only the bricks overlapping the updated region are uploaded.
+
+    \param  a_image  Brick image.
+*/
+//==============================================================================
+void cTexture3d::updateBricks(cBrickImage* a_image)
+{
+#ifdef C_USE_OPENGL
+
+    bool allocateTexture = (m_textureID == 0);
+    if (allocateTexture)
+    {
+        glGenTextures(1, &m_textureID);
+    }
+
+    glBindTexture(GL_TEXTURE_3D, m_textureID);
+
+    glTexParameteri(GL_TEXTURE_3D ,GL_TEXTURE_WRAP_S, m_wrapModeS);
+    glTexParameteri(GL_TEXTURE_3D ,GL_TEXTURE_WRAP_T, m_wrapModeT);
+    glTexParameteri(GL_TEXTURE_3D ,GL_TEXTURE_WRAP_R, m_wrapModeT);
+    glTexParameteri(GL_TEXTURE_3D ,GL_TEXTURE_MAG_FILTER, m_magFunction);
+    glTexParameteri(GL_TEXTURE_3D ,GL_TEXTURE_MIN_FILTER, m_minFunction);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    GLsizei sizeFull[3];
+    sizeFull[0] = (GLsizei)a_image->getWidth();
+    sizeFull[1] = (GLsizei)a_image->getHeight();
+    sizeFull[2] = (GLsizei)a_image->getImageCount();
+
+    if (allocateTexture)
+    {
+        glTexImage3D(GL_TEXTURE_3D,
+            0,
+            GL_RGBA,
+            sizeFull[0],
+            sizeFull[1],
+            sizeFull[2],
+            0,
+            a_image->getFormat(),
+            a_image->getType(),
+            NULL
+            );
+    }
+
+    // compute range of bricks to upload
+    int brickMin[3] = { 0, 0, 0 };
+    int brickMax[3] = { a_image->getNumBricks(0) - 1, a_image->getNumBricks(1) - 1, a_image->getNumBricks(2) - 1 };
+
+    if (m_markPartialUpdate && !allocateTexture)
+    {
+        brickMin[0] = cMax(0, (int)(m_voxelUpdateMin.x()) / C_BRICK_IMAGE_BRICK_SIZE);
+        brickMin[1] = cMax(0, (int)(m_voxelUpdateMin.y()) / C_BRICK_IMAGE_BRICK_SIZE);
+        brickMin[2] = cMax(0, (int)(m_voxelUpdateMin.z()) / C_BRICK_IMAGE_BRICK_SIZE);
+        brickMax[0] = cMin(brickMax[0], (int)(m_voxelUpdateMax.x()) / C_BRICK_IMAGE_BRICK_SIZE);
+        brickMax[1] = cMin(brickMax[1], (int)(m_voxelUpdateMax.y()) / C_BRICK_IMAGE_BRICK_SIZE);
+        brickMax[2] = cMin(brickMax[2], (int)(m_voxelUpdateMax.z()) / C_BRICK_IMAGE_BRICK_SIZE);
+    }
+    m_markPartialUpdate = false;
+
+    // upload bricks
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, C_BRICK_IMAGE_BRICK_SIZE);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, C_BRICK_IMAGE_BRICK_SIZE);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_IMAGES, 0);
+
+    for (int z=brickMin[2]; z<=brickMax[2]; z++)
+    {
+        for (int y=brickMin[1]; y<=brickMax[1]; y++)
+        {
+            for (int x=brickMin[0]; x<=brickMax[0]; x++)
+            {
+                const unsigned char* data = a_image->getBrickData(x, y, z);
+                if (data == NULL)
+                {
+                    data = a_image->getBackgroundBrickData();
+                }
+
+                GLint offset[3] = { x * C_BRICK_IMAGE_BRICK_SIZE, y * C_BRICK_IMAGE_BRICK_SIZE, z * C_BRICK_IMAGE_BRICK_SIZE };
+
+                glTexSubImage3D(GL_TEXTURE_3D,
+                                0,
+                                offset[0],
+                                offset[1],
+                                offset[2],
+                                cMin((GLsizei)C_BRICK_IMAGE_BRICK_SIZE, sizeFull[0] - offset[0]),
+                                cMin((GLsizei)C_BRICK_IMAGE_BRICK_SIZE, sizeFull[1] - offset[1]),
+                                cMin((GLsizei)C_BRICK_IMAGE_BRICK_SIZE, sizeFull[2] - offset[2]),
+                                a_image->getFormat(),
+                                a_image->getType(),
+                                data);
+            }
+        }
+    }
+
+#endif
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -45,6 +45,7 @@
 #ifndef CTexture3dH
 #define CTexture3dH
 //------------------------------------------------------------------------------
+#include "graphics/CBrickImage.h"
 #include "graphics/CMultiImage.h"
 #include "materials/CTexture2d.h"
 //------------------------------------------------------------------------------
@@ -134,6 +135,9 @@ protected:
     //! This method updates this texture to GPU.
     virtual void update(cRenderOptions& a_options);
 
+    //! This method updates this texture to GPU from a sparse brick image.
+    void updateBricks(cBrickImage* a_image);
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
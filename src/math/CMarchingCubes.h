@@ -80,112 +80,44 @@ typedef struct {
     double val[8];
 } cMarchingCubeGridCell;
 
-//==============================================================================
-/*!
-    \brief
-    This function linearly interpolate the position where an isosurface cuts
-    an edge between two vertices, each with their own scalar value.
-
-    \details
-    This function linearly interpolate the position where an isosurface cuts
-    an edge between two vertices, each with their own scalar value.
-
-    \param  a_isolevel  Iso value.
-    \param  a_p1  Point 1.
-    \param  a_p2  Point 2.
-    \param  a_valp1  Value at point 1.
-    \param  a_valp2  Value at point 2.
-
-    \return The interpolated point.
-*/
-//==============================================================================
-inline cVector3d cVertexInterpolation(double a_isolevel,
-                                      cVector3d a_p1,
-                                      cVector3d a_p2,
-                                      double a_valp1,
-                                      double a_valp2)
-{
-    double mu;
-    cVector3d p;
-
-    if (cAbs(a_isolevel - a_valp1) < 0.00001)
-        return(a_p1);
-    if (cAbs(a_isolevel - a_valp2) < 0.00001)
-        return(a_p2);
-    if (cAbs(a_valp1 - a_valp2) < 0.00001)
-        return(a_p1);
-    mu = (a_isolevel - a_valp1) / (a_valp2 - a_valp1);
-
-    p(0) = a_p1(0) + mu * (a_p2(0) - a_p1(0));
-    p(1) = a_p1(1) + mu * (a_p2(1) - a_p1(1));
-    p(2) = a_p1(2) + mu * (a_p2(2) - a_p1(2));
-
-    return(p);
-}
-
-
-//==============================================================================
-/*!
-    \brief
-    This function calculates the triangular facets required to represent the
-    isosurface through the cell.
-
-    \details
-    Given a grid cell and an isolevel, this function calculates the triangular
-    facets required to represent the isosurface through the cell.
-    The function returns the number of triangular facets and at most 5 of them.
-    0 will be returned if the grid cell is either totally above of totally below
-    the isolevel.
-
-    \param  a_grid  Grid composed of 8 voxels
-    \param  a_isolevel  Isovalue.
-    \param a_triangles  Returned triangles.
-
-    \return The number of triangles.
-*/
-//==============================================================================
-inline int cPolygonize(cMarchingCubeGridCell a_grid, 
-                       double a_isolevel, 
-                       cMarchingCubeTriangle *a_triangles)
-{
-    int i, numTriangles;
-    int cubeindex;
-    cVector3d vertlist[12];
-
-    int edgeTable[256] = {
-        0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
-        0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
-        0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
-        0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
-        0x230, 0x339, 0x33 , 0x13a, 0x636, 0x73f, 0x435, 0x53c,
-        0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
-        0x3a0, 0x2a9, 0x1a3, 0xaa , 0x7a6, 0x6af, 0x5a5, 0x4ac,
-        0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
-        0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
-        0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
-        0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff , 0x3f5, 0x2fc,
-        0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
-        0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55 , 0x15c,
-        0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
-        0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc ,
-        0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
-        0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
-        0xcc , 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
-        0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
-        0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
-        0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
-        0x2fc, 0x3f5, 0xff , 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
-        0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
-        0x36c, 0x265, 0x16f, 0x66 , 0x76a, 0x663, 0x569, 0x460,
-        0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
-        0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa , 0x1a3, 0x2a9, 0x3a0,
-        0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
-        0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33 , 0x339, 0x230,
-        0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
-        0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99 , 0x190,
-        0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
-        0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0 };
-    int triTable[256][16] =
+//------------------------------------------------------------------------------
+//! Edges of a grid cell intersected by the isosurface, for each of the 256 cell configurations.
+const int C_MARCHING_CUBES_EDGE_TABLE[256] = {
+    0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
+    0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
+    0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
+    0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
+    0x230, 0x339, 0x33 , 0x13a, 0x636, 0x73f, 0x435, 0x53c,
+    0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
+    0x3a0, 0x2a9, 0x1a3, 0xaa , 0x7a6, 0x6af, 0x5a5, 0x4ac,
+    0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
+    0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
+    0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
+    0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff , 0x3f5, 0x2fc,
+    0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
+    0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55 , 0x15c,
+    0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
+    0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc ,
+    0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
+    0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
+    0xcc , 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
+    0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
+    0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
+    0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
+    0x2fc, 0x3f5, 0xff , 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
+    0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
+    0x36c, 0x265, 0x16f, 0x66 , 0x76a, 0x663, 0x569, 0x460,
+    0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
+    0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa , 0x1a3, 0x2a9, 0x3a0,
+    0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
+    0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33 , 0x339, 0x230,
+    0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
+    0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99 , 0x190,
+    0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
+    0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0 };
+
+//! Triangles of a grid cell, given as triplets of edge indices terminated by -1, for each of the 256 cell configurations.
+const int C_MARCHING_CUBES_TRIANGLE_TABLE[256][16] =
     { { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
     { 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
     { 0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
@@ -442,6 +374,79 @@ inline int cPolygonize(cMarchingCubeGridCell a_grid,
     { 0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
     { 0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
     { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 } };
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \brief
+    This function linearly interpolate the position where an isosurface cuts
+    an edge between two vertices, each with their own scalar value.
+
+    \details
+    This function linearly interpolate the position where an isosurface cuts
+    an edge between two vertices, each with their own scalar value.
+
+    \param  a_isolevel  Iso value.
+    \param  a_p1  Point 1.
+    \param  a_p2  Point 2.
+    \param  a_valp1  Value at point 1.
+    \param  a_valp2  Value at point 2.
+
+    \return The interpolated point.
+*/
+//==============================================================================
+inline cVector3d cVertexInterpolation(double a_isolevel,
+                                      cVector3d a_p1,
+                                      cVector3d a_p2,
+                                      double a_valp1,
+                                      double a_valp2)
+{
+    double mu;
+    cVector3d p;
+
+    if (cAbs(a_isolevel - a_valp1) < 0.00001)
+        return(a_p1);
+    if (cAbs(a_isolevel - a_valp2) < 0.00001)
+        return(a_p2);
+    if (cAbs(a_valp1 - a_valp2) < 0.00001)
+        return(a_p1);
+    mu = (a_isolevel - a_valp1) / (a_valp2 - a_valp1);
+
+    p(0) = a_p1(0) + mu * (a_p2(0) - a_p1(0));
+    p(1) = a_p1(1) + mu * (a_p2(1) - a_p1(1));
+    p(2) = a_p1(2) + mu * (a_p2(2) - a_p1(2));
+
+    return(p);
+}
+
+
+//==============================================================================
+/*!
+    \brief
+    This function calculates the triangular facets required to represent the
+    isosurface through the cell.
+
+    \details
+    Given a grid cell and an isolevel, this function calculates the triangular
+    facets required to represent the isosurface through the cell.
+    The function returns the number of triangular facets and at most 5 of them.
+    0 will be returned if the grid cell is either totally above of totally below
+    the isolevel.
+
+    \param  a_grid  Grid composed of 8 voxels
+    \param  a_isolevel  Isovalue.
+    \param a_triangles  Returned triangles.
+
+    \return The number of triangles.
+*/
+//==============================================================================
+inline int cPolygonize(cMarchingCubeGridCell a_grid, 
+                       double a_isolevel, 
+                       cMarchingCubeTriangle *a_triangles)
+{
+    int i, numTriangles;
+    int cubeindex;
+    cVector3d vertlist[12];
 
     // determine the index into the edge table which tells us which vertices 
     // are inside of the surface
@@ -457,55 +462,55 @@ inline int cPolygonize(cMarchingCubeGridCell a_grid,
     if (a_grid.val[7] < a_isolevel) cubeindex |= 128;
 
     // cube is entirely in/out of the surface
-    if (edgeTable[cubeindex] == 0)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] == 0)
         return(0);
 
     // find the vertices where the surface intersects the cube
-    if (edgeTable[cubeindex] & 1)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 1)
         vertlist[0] =
         cVertexInterpolation(a_isolevel, a_grid.p[0], a_grid.p[1], a_grid.val[0], a_grid.val[1]);
-    if (edgeTable[cubeindex] & 2)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 2)
         vertlist[1] =
         cVertexInterpolation(a_isolevel, a_grid.p[1], a_grid.p[2], a_grid.val[1], a_grid.val[2]);
-    if (edgeTable[cubeindex] & 4)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 4)
         vertlist[2] =
         cVertexInterpolation(a_isolevel, a_grid.p[2], a_grid.p[3], a_grid.val[2], a_grid.val[3]);
-    if (edgeTable[cubeindex] & 8)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 8)
         vertlist[3] =
         cVertexInterpolation(a_isolevel, a_grid.p[3], a_grid.p[0], a_grid.val[3], a_grid.val[0]);
-    if (edgeTable[cubeindex] & 16)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 16)
         vertlist[4] =
         cVertexInterpolation(a_isolevel, a_grid.p[4], a_grid.p[5], a_grid.val[4], a_grid.val[5]);
-    if (edgeTable[cubeindex] & 32)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 32)
         vertlist[5] =
         cVertexInterpolation(a_isolevel, a_grid.p[5], a_grid.p[6], a_grid.val[5], a_grid.val[6]);
-    if (edgeTable[cubeindex] & 64)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 64)
         vertlist[6] =
         cVertexInterpolation(a_isolevel, a_grid.p[6], a_grid.p[7], a_grid.val[6], a_grid.val[7]);
-    if (edgeTable[cubeindex] & 128)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 128)
         vertlist[7] =
         cVertexInterpolation(a_isolevel, a_grid.p[7], a_grid.p[4], a_grid.val[7], a_grid.val[4]);
-    if (edgeTable[cubeindex] & 256)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 256)
         vertlist[8] =
         cVertexInterpolation(a_isolevel, a_grid.p[0], a_grid.p[4], a_grid.val[0], a_grid.val[4]);
-    if (edgeTable[cubeindex] & 512)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 512)
         vertlist[9] =
         cVertexInterpolation(a_isolevel, a_grid.p[1], a_grid.p[5], a_grid.val[1], a_grid.val[5]);
-    if (edgeTable[cubeindex] & 1024)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 1024)
         vertlist[10] =
         cVertexInterpolation(a_isolevel, a_grid.p[2], a_grid.p[6], a_grid.val[2], a_grid.val[6]);
-    if (edgeTable[cubeindex] & 2048)
+    if (C_MARCHING_CUBES_EDGE_TABLE[cubeindex] & 2048)
         vertlist[11] =
         cVertexInterpolation(a_isolevel, a_grid.p[3], a_grid.p[7], a_grid.val[3], a_grid.val[7]);
 
     // create the triangles
     numTriangles = 0;
-    for (i = 0; triTable[cubeindex][i] != -1; i += 3) {
+    for (i = 0; C_MARCHING_CUBES_TRIANGLE_TABLE[cubeindex][i] != -1; i += 3) {
 
         // swap vertex order to be in counter-clock wise form
-        a_triangles[numTriangles].p[2] = vertlist[triTable[cubeindex][i]];
-        a_triangles[numTriangles].p[1] = vertlist[triTable[cubeindex][i + 1]];
-        a_triangles[numTriangles].p[0] = vertlist[triTable[cubeindex][i + 2]];
+        a_triangles[numTriangles].p[2] = vertlist[C_MARCHING_CUBES_TRIANGLE_TABLE[cubeindex][i]];
+        a_triangles[numTriangles].p[1] = vertlist[C_MARCHING_CUBES_TRIANGLE_TABLE[cubeindex][i + 1]];
+        a_triangles[numTriangles].p[0] = vertlist[C_MARCHING_CUBES_TRIANGLE_TABLE[cubeindex][i + 2]];
         numTriangles++;
     }
 
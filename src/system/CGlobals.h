@@ -75,6 +75,8 @@
     - __C_USE_FILE_GIF__: Enable of disable external support for GIF files.\n
     - __C_USE_FILE_JPG__: Enable of disable external support for JPG files.\n
     - __C_USE_FILE_PNG__: Enable of disable external support for PNG files.\n
+    - __C_USE_HAPTIC_TRACE__: Enable or disable the recording of haptic loop
+                     timings by cHapticTrace.\n
                         
     Disabling one or more features will reduce the overall capabilities of 
     CHAI3D and may affect some of the examples provided with the framework.
@@ -129,6 +131,11 @@
 // Enable of disable external support for PNG files.
 #define C_USE_FILE_PNG 
 
+// HAPTIC TRACE
+// Enable or disable the recording of haptic loop timings (see cHapticTrace).
+// When disabled, the instrumentation compiles to nothing.
+// #define C_USE_HAPTIC_TRACE
+
 
 //==============================================================================
 // OPERATING SYSTEM SPECIFIC
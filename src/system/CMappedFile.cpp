@@ -0,0 +1,229 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CMappedFile.h"
+//------------------------------------------------------------------------------
+#if defined(LINUX) || defined(MACOSX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cMappedFile.
+*/
+//==============================================================================
+cMappedFile::cMappedFile()
+{
+    m_open = false;
+    m_data = NULL;
+    m_size = 0;
+
+#if defined(WIN32) | defined(WIN64)
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = NULL;
+#else
+    m_file = -1;
+#endif
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cMappedFile.
+*/
+//==============================================================================
+cMappedFile::~cMappedFile()
+{
+    close();
+}
+
+
+//==============================================================================
+/*!
+    This method opens a file and maps its entire content in memory for
+    reading. Any file previously opened is closed first. Empty files can be
+    opened, in which case getData() returns __NULL__.
+
+    \param  a_filename  Filename.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cMappedFile::open(const std::string& a_filename)
+{
+    close();
+
+#if defined(WIN32) | defined(WIN64)
+
+    // open file
+    m_file = CreateFileA(a_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        return (false);
+    }
+
+    // get file size
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size))
+    {
+        close();
+        return (false);
+    }
+    m_size = (size_t)(size.QuadPart);
+    m_open = true;
+    if (m_size == 0)
+    {
+        return (true);
+    }
+
+    // map file
+    m_mapping = CreateFileMapping(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mapping == NULL)
+    {
+        close();
+        return (false);
+    }
+    m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == NULL)
+    {
+        close();
+        return (false);
+    }
+
+#else
+
+    // open file
+    m_file = ::open(a_filename.c_str(), O_RDONLY);
+    if (m_file < 0)
+    {
+        return (false);
+    }
+
+    // get file size
+    struct stat status;
+    if ((fstat(m_file, &status) != 0) || !S_ISREG(status.st_mode))
+    {
+        close();
+        return (false);
+    }
+    m_size = (size_t)(status.st_size);
+    m_open = true;
+    if (m_size == 0)
+    {
+        return (true);
+    }
+
+    // map file, and tell the system that it will be read from start to end
+    void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+    if (data == MAP_FAILED)
+    {
+        close();
+        return (false);
+    }
+    madvise(data, m_size, MADV_SEQUENTIAL);
+    m_data = (const char*)data;
+
+#endif
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method releases the mapping and closes the file. Pointers returned
+    by getData() become invalid.
+*/
+//==============================================================================
+void cMappedFile::close()
+{
+#if defined(WIN32) | defined(WIN64)
+
+    if (m_data != NULL)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != NULL)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+
+#else
+
+    if (m_data != NULL)
+    {
+        munmap((void*)m_data, m_size);
+    }
+    if (m_file >= 0)
+    {
+        ::close(m_file);
+        m_file = -1;
+    }
+
+#endif
+
+    m_open = false;
+    m_data = NULL;
+    m_size = 0;
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
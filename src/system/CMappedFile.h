@@ -0,0 +1,158 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CMappedFileH
+#define CMappedFileH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+#include <string>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CMappedFile.h
+    \ingroup    system
+
+    \brief
+    Implements read-only memory-mapped files.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cMappedFile
+    \ingroup    system
+
+    \brief
+    This class maps the content of a file in memory for reading.
+
+    \details
+    cMappedFile maps an entire file in the address space of the process, so
+    that file loaders can parse its content in place without copying it
+    into intermediate buffers. Pages are loaded by the operating system as
+    they are accessed, and the mapping can be read by several threads
+    simultaneously. The mapping is released when the file is closed or when
+    the object is destroyed.
+*/
+//==============================================================================
+class cMappedFile
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cMappedFile.
+    cMappedFile();
+
+    //! Destructor of cMappedFile.
+    virtual ~cMappedFile();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method maps a file in memory.
+    bool open(const std::string& a_filename);
+
+    //! This method releases the mapping and closes the file.
+    void close();
+
+    //! This method returns __true__ if a file is open.
+    bool isOpen() const { return (m_open); }
+
+    //! This method returns the content of the file, or __NULL__ if the file is empty or not open.
+    const char* getData() const { return (m_data); }
+
+    //! This method returns the size of the file in bytes.
+    size_t getSize() const { return (m_size); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__, a file is open.
+    bool m_open;
+
+    //! Content of the file.
+    const char* m_data;
+
+    //! Size of the file in bytes.
+    size_t m_size;
+
+#if defined(WIN32) | defined(WIN64)
+
+    //! Handle of the file.
+    HANDLE m_file;
+
+    //! Handle of the file mapping.
+    HANDLE m_mapping;
+
+#else
+
+    //! Descriptor of the file.
+    int m_file;
+
+#endif
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
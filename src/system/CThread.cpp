@@ -45,6 +45,14 @@
 //------------------------------------------------------------------------------
 #include "system/CThread.h"
 //------------------------------------------------------------------------------
+#if defined(LINUX) || defined(MACOSX)
+#include <unistd.h>
+#endif
+#if defined(MACOSX)
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#endif
+//------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
@@ -66,6 +74,7 @@ cThread::cThread()
     // default handle
 #if defined(WIN32) | defined(WIN64)
     m_threadId = 0;
+    m_handle = NULL;
 #endif
 #if defined(LINUX) || defined(MACOSX)
     m_handle = 0;
@@ -80,6 +89,13 @@ cThread::cThread()
 //==============================================================================
 cThread::~cThread()
 {
+#if defined(WIN32) | defined(WIN64)
+    // release thread handle (the thread itself keeps running)
+    if (m_handle != NULL)
+    {
+        CloseHandle(m_handle);
+    }
+#endif
 }
 
 
@@ -97,7 +113,11 @@ void cThread::start(void(*a_function)(void), CThreadPriority a_level)
 {
     // create thread
 #if defined(WIN32) | defined(WIN64)
-    CreateThread(
+    if (m_handle != NULL)
+    {
+        CloseHandle(m_handle);
+    }
+    m_handle = CreateThread(
           0,
           0,
           (LPTHREAD_START_ROUTINE)(a_function),
@@ -136,7 +156,11 @@ void cThread::start(void(*a_function)(void*), CThreadPriority a_level, void *a_a
 {
     // create thread
 #if defined(WIN32) | defined(WIN64)
-    CreateThread(
+    if (m_handle != NULL)
+    {
+        CloseHandle(m_handle);
+    }
+    m_handle = CreateThread(
           0,
           0,
           (LPTHREAD_START_ROUTINE)(a_function),
@@ -178,6 +202,32 @@ void cThread::stop()
 }
 
 
+//==============================================================================
+/*!
+    This method blocks the calling thread until the thread function returns.
+*/
+//==============================================================================
+void cThread::join()
+{
+#if defined(WIN32) | defined(WIN64)
+    if (m_handle != NULL)
+    {
+        WaitForSingleObject(m_handle, INFINITE);
+        CloseHandle(m_handle);
+        m_handle = NULL;
+    }
+#endif
+
+#if defined (LINUX) || defined (MACOSX)
+    if (m_handle != 0)
+    {
+        pthread_join(m_handle, NULL);
+        m_handle = 0;
+    }
+#endif
+}
+
+
 //==============================================================================
 /*!
     This method adjusts the priority level of the thread.
@@ -241,6 +291,73 @@ void cThread::setPriority(CThreadPriority a_level)
 }
 
 
+//==============================================================================
+/*!
+    This method returns the number of processor cores available on this
+    computer.
+
+    \return Number of processor cores.
+*/
+//==============================================================================
+unsigned int cThread::getNumCores()
+{
+    unsigned int numCores = 1;
+
+#if defined(WIN32) | defined(WIN64)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    numCores = (unsigned int)(info.dwNumberOfProcessors);
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+    long result = sysconf(_SC_NPROCESSORS_ONLN);
+    if (result > 0)
+    {
+        numCores = (unsigned int)(result);
+    }
+#endif
+
+    return (numCores);
+}
+
+
+//==============================================================================
+/*!
+    This method restricts the calling thread to run on a single processor core.
+    On Mac OS X, threads cannot be pinned to a core; the core index is instead
+    passed to the scheduler as an affinity tag, which only acts as a hint.
+
+    \param  a_core  Index of the processor core.
+
+    \return __true__ if the request was accepted by the operating system, __false__ otherwise.
+*/
+//==============================================================================
+bool cThread::setCurrentThreadAffinity(const unsigned int a_core)
+{
+    if (a_core >= getNumCores()) { return (false); }
+
+#if defined(WIN32) | defined(WIN64)
+    DWORD_PTR mask = ((DWORD_PTR)1) << a_core;
+    return (SetThreadAffinityMask(GetCurrentThread(), mask) != 0);
+#endif
+
+#if defined(LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(a_core, &set);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set) == 0);
+#endif
+
+#if defined(MACOSX)
+    thread_affinity_policy_data_t policy = { (integer_t)(a_core + 1) };
+    return (thread_policy_set(pthread_mach_thread_np(pthread_self()),
+                              THREAD_AFFINITY_POLICY,
+                              (thread_policy_t)&policy,
+                              THREAD_AFFINITY_POLICY_COUNT) == KERN_SUCCESS);
+#endif
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -127,6 +127,9 @@ public:
     //! This method terminates the thread (not recommended!).
     void stop();
 
+    //! This method waits for the thread function to return.
+    void join();
+
     //! This method sets the thread priority level.
     void setPriority(CThreadPriority a_level);
 
@@ -134,6 +137,19 @@ public:
     CThreadPriority getPriority() const { return (m_priorityLevel); }
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of processor cores available on this computer.
+    static unsigned int getNumCores();
+
+    //! This method restricts the calling thread to run on a single processor core.
+    static bool setCurrentThreadAffinity(const unsigned int a_core);
+
+
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
     //--------------------------------------------------------------------------
@@ -141,8 +157,11 @@ public:
 protected:
 
 #if defined(WIN32) | defined(WIN64)
-    //! Thread handle.
+    //! Thread identifier.
     DWORD m_threadId;
+
+    //! Thread handle, returned when the thread is created.
+    HANDLE m_handle;
 #endif
 
 #if defined(LINUX) || defined(MACOSX)
@@ -0,0 +1,180 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CTripleBufferH
+#define CTripleBufferH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+#include <atomic>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CTripleBuffer.h
+    \ingroup    system
+
+    \brief
+    Implements a lock-free triple buffer.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cTripleBuffer
+    \ingroup    system
+
+    \brief
+    This class implements a lock-free triple buffer for passing data from one
+    producer thread to one consumer thread.
+
+    \details
+    The triple buffer holds three copies of the data. The producer always owns
+    a __write__ buffer and the consumer always owns a __read__ buffer. The
+    third buffer holds the latest published data. \n
+
+    When the producer has finished filling its write buffer, it calls
+    publish(), which atomically exchanges the write buffer with the latest
+    one. When the consumer calls update(), it exchanges its read buffer with
+    the latest one if new data has been published since its previous call.
+    Neither thread ever waits for the other: the producer may publish at a
+    much higher rate than the consumer reads, in which case intermediate
+    updates are simply dropped, and the consumer always sees a complete,
+    consistent copy of the data. \n
+
+    Only one thread may call getWriteBuffer() and publish(), and only one
+    thread may call update() and getReadBuffer().
+*/
+//==============================================================================
+template <class T> class cTripleBuffer
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cTripleBuffer.
+    cTripleBuffer() : m_latest(1)
+    {
+        m_write = 0;
+        m_read = 2;
+    }
+
+    //! Destructor of cTripleBuffer.
+    virtual ~cTripleBuffer() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the buffer owned by the producer thread.
+    T& getWriteBuffer() { return (m_buffers[m_write]); }
+
+    //! This method makes the content of the write buffer available to the consumer thread.
+    void publish()
+    {
+        int latest = m_latest.exchange(m_write | C_NEW_DATA, std::memory_order_acq_rel);
+        m_write = latest & C_INDEX_MASK;
+    }
+
+    //! This method acquires the latest published data. It returns __true__ if new data was available.
+    bool update()
+    {
+        if ((m_latest.load(std::memory_order_relaxed) & C_NEW_DATA) == 0)
+        {
+            return (false);
+        }
+
+        int latest = m_latest.exchange(m_read, std::memory_order_acq_rel);
+        m_read = latest & C_INDEX_MASK;
+        return (true);
+    }
+
+    //! This method returns the buffer owned by the consumer thread.
+    const T& getReadBuffer() const { return (m_buffers[m_read]); }
+
+    //! This method returns any of the three buffers. It must only be used while neither thread is accessing the triple buffer.
+    T& getBuffer(const unsigned int a_index) { return (m_buffers[a_index]); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Flag set in the latest buffer index when data has not been read yet.
+    static const int C_NEW_DATA = 4;
+
+    //! Mask extracting a buffer index.
+    static const int C_INDEX_MASK = 3;
+
+    //! Buffers.
+    T m_buffers[3];
+
+    //! Index of the buffer owned by the producer.
+    int m_write;
+
+    //! Index of the buffer owned by the consumer.
+    int m_read;
+
+    //! Index of the latest published buffer, combined with flag C_NEW_DATA.
+    std::atomic<int> m_latest;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,370 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CWorkerPool.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// data of a reduction job
+struct cWorkerPoolReduceJob
+{
+    cWorkerPoolReduceTask m_task;
+    void* m_data;
+    unsigned int m_chunkSize;
+    unsigned char* m_results;
+    size_t m_resultSize;
+};
+
+// executes a reduction task on a chunk, and stores its result in the slot of the chunk
+void cWorkerPoolReduceChunk(void* a_data,
+                            const unsigned int a_begin,
+                            const unsigned int a_end)
+{
+    cWorkerPoolReduceJob* job = (cWorkerPoolReduceJob*)a_data;
+    unsigned char* result = job->m_results + (a_begin / job->m_chunkSize) * job->m_resultSize;
+    job->m_task(job->m_data, a_begin, a_end, result);
+}
+
+// shared worker pool
+cWorkerPool* s_sharedWorkerPool = NULL;
+
+// mutex protecting the creation of the shared worker pool
+std::mutex s_sharedWorkerPoolMutex;
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cWorkerPool. The pool creates __a_numThreads__ - 1 worker
+    threads, since the thread calling execute() also processes chunks.
+
+    \param  a_numThreads  Total number of threads (0 to use one thread per processor core).
+    \param  a_priority    Priority level of the worker threads.
+*/
+//==============================================================================
+cWorkerPool::cWorkerPool(const unsigned int a_numThreads,
+                         const CThreadPriority a_priority) : m_nextChunk(0), m_busy(false)
+{
+    m_jobIndex = 0;
+    m_numBusyWorkers = 0;
+    m_quit = false;
+    m_task = NULL;
+    m_data = NULL;
+    m_numItems = 0;
+    m_chunkSize = 1;
+    m_numChunks = 0;
+
+    unsigned int numThreads = a_numThreads;
+    if (numThreads == 0)
+    {
+        numThreads = cThread::getNumCores();
+    }
+
+    for (unsigned int i=1; i<numThreads; i++)
+    {
+        cThread* thread = new cThread();
+        m_threads.push_back(thread);
+        thread->start(workerLoop, a_priority, this);
+    }
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cWorkerPool. Worker threads are terminated and joined.
+*/
+//==============================================================================
+cWorkerPool::~cWorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_jobCondition.notify_all();
+
+    for (unsigned int i=0; i<m_threads.size(); i++)
+    {
+        m_threads[i]->join();
+        delete m_threads[i];
+    }
+    m_threads.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method splits the range [0, __a_numItems__) into chunks of
+    __a_chunkSize__ items and calls __a_task__ once per chunk. Chunks are
+    distributed dynamically between the worker threads and the calling
+    thread. The method returns when all chunks have been processed. \n
+
+    If the pool is already executing a job, because the method is called
+    concurrently from another thread or from within a task, all chunks are
+    processed by the calling thread.
+
+    \param  a_task       Task to execute.
+    \param  a_data       Data passed to the task.
+    \param  a_numItems   Number of items.
+    \param  a_chunkSize  Number of items per chunk.
+*/
+//==============================================================================
+void cWorkerPool::execute(cWorkerPoolTask a_task,
+                          void* a_data,
+                          const unsigned int a_numItems,
+                          const unsigned int a_chunkSize)
+{
+    // sanity check
+    if ((a_task == NULL) || (a_numItems == 0))
+    {
+        return;
+    }
+
+    unsigned int chunkSize = (a_chunkSize > 0) ? a_chunkSize : 1;
+    unsigned int numChunks = getNumChunks(a_numItems, chunkSize);
+
+    // small jobs, no worker threads, or busy pool: process chunks on the calling thread
+    bool busy = false;
+    if ((numChunks == 1) || (m_threads.size() == 0) || (!m_busy.compare_exchange_strong(busy, true)))
+    {
+        for (unsigned int i=0; i<numChunks; i++)
+        {
+            unsigned int begin = i * chunkSize;
+            unsigned int end = begin + chunkSize;
+            if (end > a_numItems) { end = a_numItems; }
+            a_task(a_data, begin, end);
+        }
+        return;
+    }
+
+    // submit job
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task = a_task;
+        m_data = a_data;
+        m_numItems = a_numItems;
+        m_chunkSize = chunkSize;
+        m_numChunks = numChunks;
+        m_nextChunk.store(0);
+        m_numBusyWorkers = (unsigned int)(m_threads.size());
+        m_jobIndex++;
+    }
+    m_jobCondition.notify_all();
+
+    // take part in the job
+    processChunks();
+
+    // wait for workers
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_numBusyWorkers > 0)
+        {
+            m_doneCondition.wait(lock);
+        }
+    }
+
+    m_busy.store(false);
+}
+
+
+//==============================================================================
+/*!
+    This method splits the range [0, __a_numItems__) into chunks of
+    __a_chunkSize__ items and calls __a_task__ once per chunk, like
+    execute(). The partial result of chunk __i__ is stored at offset
+    __i__ * __a_resultSize__ of __a_results__, which must hold
+    getNumChunks() results. Combining the partial results in chunk order
+    gives a result which does not depend on the number of threads.
+
+    \param  a_task        Reduction task to execute.
+    \param  a_data        Data passed to the task.
+    \param  a_numItems    Number of items.
+    \param  a_chunkSize   Number of items per chunk.
+    \param  a_results     Array receiving the partial result of each chunk.
+    \param  a_resultSize  Size in bytes of a partial result.
+*/
+//==============================================================================
+void cWorkerPool::reduce(cWorkerPoolReduceTask a_task,
+                         void* a_data,
+                         const unsigned int a_numItems,
+                         const unsigned int a_chunkSize,
+                         void* a_results,
+                         const size_t a_resultSize)
+{
+    // sanity check
+    if ((a_task == NULL) || (a_results == NULL))
+    {
+        return;
+    }
+
+    cWorkerPoolReduceJob job;
+    job.m_task = a_task;
+    job.m_data = a_data;
+    job.m_chunkSize = (a_chunkSize > 0) ? a_chunkSize : 1;
+    job.m_results = (unsigned char*)a_results;
+    job.m_resultSize = a_resultSize;
+
+    execute(cWorkerPoolReduceChunk, &job, a_numItems, job.m_chunkSize);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of chunks of __a_chunkSize__ items a
+    range of __a_numItems__ items is split in.
+
+    \param  a_numItems   Number of items.
+    \param  a_chunkSize  Number of items per chunk.
+
+    \return Number of chunks.
+*/
+//==============================================================================
+unsigned int cWorkerPool::getNumChunks(const unsigned int a_numItems,
+                                       const unsigned int a_chunkSize)
+{
+    unsigned int chunkSize = (a_chunkSize > 0) ? a_chunkSize : 1;
+    return ((a_numItems + chunkSize - 1) / chunkSize);
+}
+
+
+//==============================================================================
+/*!
+    This method returns a worker pool shared by the components of the
+    library, such as meshes processing their vertices. The pool is created
+    at the first call, with one thread per processor core, and lives until
+    the application exits.
+
+    \return Shared worker pool.
+*/
+//==============================================================================
+cWorkerPool* cWorkerPool::getSharedPool()
+{
+    std::unique_lock<std::mutex> lock(s_sharedWorkerPoolMutex);
+    if (s_sharedWorkerPool == NULL)
+    {
+        s_sharedWorkerPool = new cWorkerPool();
+    }
+    return (s_sharedWorkerPool);
+}
+
+
+//==============================================================================
+/*!
+    This method processes chunks of the current job until none remain.
+*/
+//==============================================================================
+void cWorkerPool::processChunks()
+{
+    while (true)
+    {
+        unsigned int chunk = m_nextChunk.fetch_add(1);
+        if (chunk >= m_numChunks)
+        {
+            return;
+        }
+
+        unsigned int begin = chunk * m_chunkSize;
+        unsigned int end = begin + m_chunkSize;
+        if (end > m_numItems) { end = m_numItems; }
+        m_task(m_data, begin, end);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method is executed by every worker thread. It waits for jobs and
+    processes their chunks until the pool is destroyed.
+
+    \param  a_pool  Pointer to the worker pool.
+*/
+//==============================================================================
+void cWorkerPool::workerLoop(void* a_pool)
+{
+    cWorkerPool* pool = (cWorkerPool*)a_pool;
+    unsigned int jobIndex = 0;
+
+    while (true)
+    {
+        // wait for a new job
+        {
+            std::unique_lock<std::mutex> lock(pool->m_mutex);
+            while ((!pool->m_quit) && (pool->m_jobIndex == jobIndex))
+            {
+                pool->m_jobCondition.wait(lock);
+            }
+            if (pool->m_quit)
+            {
+                return;
+            }
+            jobIndex = pool->m_jobIndex;
+        }
+
+        // process job
+        pool->processChunks();
+
+        // signal completion
+        {
+            std::unique_lock<std::mutex> lock(pool->m_mutex);
+            pool->m_numBusyWorkers--;
+            if (pool->m_numBusyWorkers == 0)
+            {
+                pool->m_doneCondition.notify_one();
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
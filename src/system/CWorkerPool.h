@@ -0,0 +1,236 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CWorkerPoolH
+#define CWorkerPoolH
+//------------------------------------------------------------------------------
+#include "system/CThread.h"
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CWorkerPool.h
+    \ingroup    system
+
+    \brief
+    Implements a fixed pool of worker threads.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+/*!
+    Defines a task executed by a worker pool. The task processes all items
+    in the range [__a_begin__, __a_end__).
+*/
+//------------------------------------------------------------------------------
+typedef void (*cWorkerPoolTask)(void* a_data,
+                                const unsigned int a_begin,
+                                const unsigned int a_end);
+
+//------------------------------------------------------------------------------
+/*!
+    Defines a reduction task executed by a worker pool. The task processes
+    all items in the range [__a_begin__, __a_end__) and stores its partial
+    result at address __a_result__.
+*/
+//------------------------------------------------------------------------------
+typedef void (*cWorkerPoolReduceTask)(void* a_data,
+                                      const unsigned int a_begin,
+                                      const unsigned int a_end,
+                                      void* a_result);
+
+
+//==============================================================================
+/*!
+    \class      cWorkerPool
+    \ingroup    system
+
+    \brief
+    This class implements a fixed pool of worker threads.
+
+    \details
+    A worker pool creates its threads once, at construction, and keeps them
+    waiting until work is submitted. execute() splits a range of items into
+    chunks of fixed size and distributes the chunks to the workers and to the
+    calling thread, which also takes part in the computation. The method
+    returns once every chunk has been processed. \n
+
+    Chunk boundaries only depend on the number of items and on the chunk
+    size, never on the number of threads. A task that writes its results per
+    item therefore produces identical results regardless of how many threads
+    are used or in which order the chunks are processed. For the same
+    reason, reduce() stores one partial result per chunk, which the caller
+    combines in chunk order. \n
+
+    A pool executes one job at a time. When execute() is called while the
+    pool is busy, either from another thread or from within a task, the
+    chunks are processed by the calling thread alone. This allows library
+    components to share the pool returned by getSharedPool().
+*/
+//==============================================================================
+class cWorkerPool
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cWorkerPool.
+    cWorkerPool(const unsigned int a_numThreads = 0,
+                const CThreadPriority a_priority = CTHREAD_PRIORITY_GRAPHICS);
+
+    //! Destructor of cWorkerPool.
+    virtual ~cWorkerPool();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of threads taking part in the computations, including the calling thread.
+    unsigned int getNumThreads() const { return ((unsigned int)(m_threads.size()) + 1); }
+
+    //! This method executes a task over a range of items split in chunks, and waits until all chunks are processed.
+    void execute(cWorkerPoolTask a_task,
+                 void* a_data,
+                 const unsigned int a_numItems,
+                 const unsigned int a_chunkSize);
+
+    //! This method executes a reduction task over a range of items split in chunks, and stores the partial result of each chunk.
+    void reduce(cWorkerPoolReduceTask a_task,
+                void* a_data,
+                const unsigned int a_numItems,
+                const unsigned int a_chunkSize,
+                void* a_results,
+                const size_t a_resultSize);
+
+    //! This method returns the number of chunks a range of items is split in.
+    static unsigned int getNumChunks(const unsigned int a_numItems,
+                                     const unsigned int a_chunkSize);
+
+    //! This method returns a pool shared by the components of the library, with one thread per processor core.
+    static cWorkerPool* getSharedPool();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method is the main loop of every worker thread.
+    static void workerLoop(void* a_pool);
+
+    //! This method processes chunks until none remain.
+    void processChunks();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Worker threads.
+    std::vector<cThread*> m_threads;
+
+    //! Mutex protecting the job state.
+    std::mutex m_mutex;
+
+    //! Condition signaled when a new job is submitted or when the pool is destroyed.
+    std::condition_variable m_jobCondition;
+
+    //! Condition signaled when the last worker has completed the current job.
+    std::condition_variable m_doneCondition;
+
+    //! Job counter, incremented every time a job is submitted.
+    unsigned int m_jobIndex;
+
+    //! Number of workers that have not completed the current job.
+    unsigned int m_numBusyWorkers;
+
+    //! If __true__, worker threads exit.
+    bool m_quit;
+
+    //! Task of the current job.
+    cWorkerPoolTask m_task;
+
+    //! Data passed to the task of the current job.
+    void* m_data;
+
+    //! Number of items of the current job.
+    unsigned int m_numItems;
+
+    //! Number of items per chunk of the current job.
+    unsigned int m_chunkSize;
+
+    //! Number of chunks of the current job.
+    unsigned int m_numChunks;
+
+    //! Index of the next chunk to be processed.
+    std::atomic<unsigned int> m_nextChunk;
+
+    //! If __true__, the pool is executing a job.
+    std::atomic<bool> m_busy;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,467 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "timers/CHapticTrace.h"
+#include "timers/CPrecisionClock.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// thread-local storage of a plain pointer, supported by all our compilers
+#if defined(_MSC_VER)
+#define C_HAPTIC_TRACE_THREAD_LOCAL __declspec(thread)
+#else
+#define C_HAPTIC_TRACE_THREAD_LOCAL __thread
+#endif
+
+// trace buffer of the calling thread
+static C_HAPTIC_TRACE_THREAD_LOCAL cHapticTraceBuffer* s_threadBuffer = NULL;
+
+// write a string to a JSON file, escaping quotes and backslashes
+static void writeJSONString(FILE* a_file, const char* a_string)
+{
+    fputc('"', a_file);
+    for (const char* c = a_string; *c != '\0'; c++)
+    {
+        if ((*c == '"') || (*c == '\\'))
+        {
+            fputc('\\', a_file);
+        }
+        if ((unsigned char)(*c) >= 0x20)
+        {
+            fputc(*c, a_file);
+        }
+    }
+    fputc('"', a_file);
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// STATIC MEMBERS:
+//------------------------------------------------------------------------------
+
+std::atomic<bool> cHapticTrace::m_enabled(true);
+unsigned int cHapticTrace::m_bufferSize = C_HAPTIC_TRACE_DEFAULT_BUFFER_SIZE;
+std::vector<cHapticTraceBuffer*> cHapticTrace::m_buffers;
+std::mutex cHapticTrace::m_mutex;
+std::atomic<double> cHapticTrace::m_clearTime(0.0);
+std::atomic<unsigned int> cHapticTrace::m_numDeadlineMisses(0);
+std::atomic<bool> cHapticTrace::m_deadlineMissRequested(false);
+std::atomic<bool> cHapticTrace::m_deadlineMissQuit(false);
+cThread* cHapticTrace::m_deadlineMissThread = NULL;
+std::string cHapticTrace::m_deadlineMissFilename;
+double cHapticTrace::m_deadlineMissDuration = 0.0;
+
+
+//==============================================================================
+/*!
+    This method sets the number of events kept by the buffer of each thread.
+    The value is rounded up to a power of two. Buffers of threads that have
+    already recorded events keep their size. \n
+
+    At 1 kHz, a haptic loop recording __n__ sections per cycle keeps the
+    history of the last __a_bufferSize__ / (1000 __n__) seconds.
+
+    \param  a_bufferSize  Number of events per thread.
+*/
+//==============================================================================
+void cHapticTrace::setBufferSize(const unsigned int a_bufferSize)
+{
+    unsigned int bufferSize = 16;
+    while ((bufferSize < a_bufferSize) && (bufferSize < 0x80000000))
+    {
+        bufferSize *= 2;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bufferSize = bufferSize;
+}
+
+
+//==============================================================================
+/*!
+    This method sets the name under which the calling thread appears in
+    saved files.
+
+    \param  a_name  Name of the thread.
+*/
+//==============================================================================
+void cHapticTrace::setThreadName(const std::string& a_name)
+{
+    cHapticTraceBuffer* buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    buffer->m_threadName = a_name;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the current time of the monotonic clock used by
+    recorded events.
+
+    \return Time in seconds.
+*/
+//==============================================================================
+double cHapticTrace::getTime()
+{
+    return (cPrecisionClock::getCPUTimeSeconds());
+}
+
+
+//==============================================================================
+/*!
+    This method records a timed section for the calling thread. The oldest
+    event of the thread is overwritten if its buffer is full.
+
+    \param  a_name       Name of the section. The string is not copied.
+    \param  a_startTime  Start time of the section, as returned by getTime().
+    \param  a_endTime    End time of the section, as returned by getTime().
+*/
+//==============================================================================
+void cHapticTrace::record(const char* a_name,
+                          const double a_startTime,
+                          const double a_endTime)
+{
+    cHapticTraceBuffer* buffer = getThreadBuffer();
+
+    unsigned int index = buffer->m_numWrittenEvents.load(std::memory_order_relaxed);
+    cHapticTraceEvent& event = buffer->m_events[index & (buffer->m_events.size() - 1)];
+    event.m_name = a_name;
+    event.m_startTime = a_startTime;
+    event.m_duration = a_endTime - a_startTime;
+    event.m_instant = false;
+
+    buffer->m_numWrittenEvents.store(index + 1, std::memory_order_release);
+}
+
+
+//==============================================================================
+/*!
+    This method records an instant for the calling thread.
+
+    \param  a_name  Name of the instant. The string is not copied.
+*/
+//==============================================================================
+void cHapticTrace::recordInstant(const char* a_name)
+{
+    if (!m_enabled) { return; }
+
+    cHapticTraceBuffer* buffer = getThreadBuffer();
+
+    unsigned int index = buffer->m_numWrittenEvents.load(std::memory_order_relaxed);
+    cHapticTraceEvent& event = buffer->m_events[index & (buffer->m_events.size() - 1)];
+    event.m_name = a_name;
+    event.m_startTime = getTime();
+    event.m_duration = 0.0;
+    event.m_instant = true;
+
+    buffer->m_numWrittenEvents.store(index + 1, std::memory_order_release);
+}
+
+
+//==============================================================================
+/*!
+    This method records a deadline miss for the calling thread. If a
+    filename has been set with setDeadlineMissFile(), the recorded events
+    are saved by a background thread shortly after.
+*/
+//==============================================================================
+void cHapticTrace::signalDeadlineMiss()
+{
+    recordInstant("deadline miss");
+    m_numDeadlineMisses++;
+    m_deadlineMissRequested = true;
+}
+
+
+//==============================================================================
+/*!
+    This method enables or disables saving the recorded events when a
+    deadline miss is signaled. Files are written by a background thread,
+    which polls for deadline misses every 10 ms. Each deadline miss
+    overwrites the previous file. \n
+
+    This method must not be called concurrently from several threads. Call
+    it with an empty filename before the application exits.
+
+    \param  a_filename  Name of the file, or an empty string to disable the feature.
+    \param  a_duration  Duration of the history to save in seconds (0 to save all events).
+*/
+//==============================================================================
+void cHapticTrace::setDeadlineMissFile(const std::string& a_filename,
+                                       const double a_duration)
+{
+    // stop current thread
+    if (m_deadlineMissThread != NULL)
+    {
+        m_deadlineMissQuit = true;
+        m_deadlineMissThread->join();
+        delete m_deadlineMissThread;
+        m_deadlineMissThread = NULL;
+    }
+
+    if (a_filename.empty())
+    {
+        return;
+    }
+
+    // update settings
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_deadlineMissFilename = a_filename;
+        m_deadlineMissDuration = a_duration;
+    }
+
+    // start thread
+    m_deadlineMissRequested = false;
+    m_deadlineMissQuit = false;
+    m_deadlineMissThread = new cThread();
+    m_deadlineMissThread->start(deadlineMissLoop, CTHREAD_PRIORITY_GRAPHICS);
+}
+
+
+//==============================================================================
+/*!
+    This method saves the events recorded by all threads to a file in the
+    Chrome trace event format. Threads may keep recording events while the
+    file is written. \n
+
+    Each section is saved as a complete event, and each instant as a global
+    instant event. Times are expressed in microseconds from the oldest event
+    of the file.
+
+    \param  a_filename  Name of the file.
+    \param  a_duration  Duration of the history to save in seconds (0 to save all events).
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cHapticTrace::saveToFile(const std::string& a_filename,
+                              const double a_duration)
+{
+    // copy the list of buffers and thread names
+    std::vector<cHapticTraceBuffer*> buffers;
+    std::vector<std::string> threadNames;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffers = m_buffers;
+        for (unsigned int i=0; i<buffers.size(); i++)
+        {
+            threadNames.push_back(buffers[i]->m_threadName);
+        }
+    }
+
+    double minTime = m_clearTime;
+    if (a_duration > 0.0)
+    {
+        minTime = std::max(minTime, getTime() - a_duration);
+    }
+
+    // copy the events of each thread
+    std::vector< std::vector<cHapticTraceEvent> > events(buffers.size());
+    double originTime = -1.0;
+    for (unsigned int i=0; i<buffers.size(); i++)
+    {
+        cHapticTraceBuffer* buffer = buffers[i];
+        unsigned int size = (unsigned int)(buffer->m_events.size());
+
+        unsigned int end = buffer->m_numWrittenEvents.load(std::memory_order_acquire);
+        unsigned int begin = (end > size) ? end - size : 0;
+        std::vector<cHapticTraceEvent> copy(end - begin);
+        for (unsigned int j=begin; j!=end; j++)
+        {
+            copy[j - begin] = buffer->m_events[j & (size - 1)];
+        }
+
+        // discard events that may have been overwritten while copying
+        unsigned int written = buffer->m_numWrittenEvents.load(std::memory_order_acquire);
+        unsigned int validBegin = (written + 1 > size) ? written + 1 - size : 0;
+
+        for (unsigned int j=begin; j!=end; j++)
+        {
+            const cHapticTraceEvent& event = copy[j - begin];
+            if ((j < validBegin) || (event.m_startTime < minTime))
+            {
+                continue;
+            }
+
+            events[i].push_back(event);
+            if ((originTime < 0.0) || (event.m_startTime < originTime))
+            {
+                originTime = event.m_startTime;
+            }
+        }
+    }
+
+    // write file
+    FILE* file = fopen(a_filename.c_str(), "w");
+    if (file == NULL)
+    {
+        return (C_ERROR);
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (unsigned int i=0; i<buffers.size(); i++)
+    {
+        // thread name
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", i);
+        writeJSONString(file, threadNames[i].c_str());
+        fprintf(file, "}}");
+        first = false;
+
+        // events
+        for (unsigned int j=0; j<events[i].size(); j++)
+        {
+            const cHapticTraceEvent& event = events[i][j];
+            fprintf(file, ",\n{\"name\":");
+            writeJSONString(file, event.m_name);
+            if (event.m_instant)
+            {
+                fprintf(file, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":0,\"tid\":%u}",
+                        1e6 * (event.m_startTime - originTime), i);
+            }
+            else
+            {
+                fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+                        1e6 * (event.m_startTime - originTime), 1e6 * event.m_duration, i);
+            }
+        }
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+    bool result = (ferror(file) == 0);
+    fclose(file);
+
+    return (result ? C_SUCCESS : C_ERROR);
+}
+
+
+//==============================================================================
+/*!
+    This method discards all events recorded so far. Buffers are not
+    released.
+*/
+//==============================================================================
+void cHapticTrace::clear()
+{
+    m_clearTime = getTime();
+}
+
+
+//==============================================================================
+/*!
+    This method returns the buffer of the calling thread. The buffer is
+    created and registered the first time a thread records an event, and
+    is kept until the application exits.
+
+    \return Buffer of the calling thread.
+*/
+//==============================================================================
+cHapticTraceBuffer* cHapticTrace::getThreadBuffer()
+{
+    if (s_threadBuffer == NULL)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        cHapticTraceBuffer* buffer = new cHapticTraceBuffer();
+        buffer->m_events.resize(m_bufferSize);
+        buffer->m_numWrittenEvents = 0;
+
+        char name[32];
+        sprintf(name, "thread %u", (unsigned int)(m_buffers.size()));
+        buffer->m_threadName = name;
+
+        m_buffers.push_back(buffer);
+        s_threadBuffer = buffer;
+    }
+
+    return (s_threadBuffer);
+}
+
+
+//==============================================================================
+/*!
+    This method is the main loop of the thread saving files when deadline
+    misses are signaled.
+*/
+//==============================================================================
+void cHapticTrace::deadlineMissLoop()
+{
+    while (!m_deadlineMissQuit)
+    {
+        cSleepMs(10);
+
+        if (m_deadlineMissRequested.exchange(false))
+        {
+            std::string filename;
+            double duration;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                filename = m_deadlineMissFilename;
+                duration = m_deadlineMissDuration;
+            }
+
+            saveToFile(filename, duration);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,336 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CHapticTraceH
+#define CHapticTraceH
+//------------------------------------------------------------------------------
+#include "math/CConstants.h"
+#include "system/CGlobals.h"
+#include "system/CThread.h"
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CHapticTrace.h
+    \ingroup    timers
+
+    \brief
+    Implements a flight recorder for the timing of haptic loops.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Default number of events kept by the trace buffer of each thread.
+const unsigned int C_HAPTIC_TRACE_DEFAULT_BUFFER_SIZE = 65536;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \struct     cHapticTraceEvent
+    \ingroup    timers
+
+    \brief
+    This structure stores a timed section, or an instant, recorded by
+    cHapticTrace.
+*/
+//==============================================================================
+struct cHapticTraceEvent
+{
+    //! Name of the event. The string must remain valid for the lifetime of the application.
+    const char* m_name;
+
+    //! Start time of the event in seconds.
+    double m_startTime;
+
+    //! Duration of the event in seconds.
+    double m_duration;
+
+    //! If __true__, the event marks an instant and has no duration.
+    bool m_instant;
+};
+
+
+//==============================================================================
+/*!
+    \struct     cHapticTraceBuffer
+    \ingroup    timers
+
+    \brief
+    This structure implements the ring buffer of events of a single thread.
+
+    \details
+    A buffer is written by its thread only. The write counter is published
+    after every event, so that other threads can copy the latest events
+    without locking.
+*/
+//==============================================================================
+struct cHapticTraceBuffer
+{
+    //! Events, used as a ring buffer.
+    std::vector<cHapticTraceEvent> m_events;
+
+    //! Total number of events written to the buffer.
+    std::atomic<unsigned int> m_numWrittenEvents;
+
+    //! Name of the thread.
+    std::string m_threadName;
+};
+
+
+//==============================================================================
+/*!
+    \class      cHapticTrace
+    \ingroup    timers
+
+    \brief
+    This class implements a flight recorder for the timing of haptic loops.
+
+    \details
+    cHapticTrace records the start time and duration of named sections of
+    code, such as device input and output, proxy computations, or haptic
+    effects. Each thread records events into its own ring buffer, which is
+    allocated the first time the thread records an event. Recording never
+    locks nor allocates memory afterwards. Once a buffer is full, the oldest
+    events are overwritten, so that the buffers always hold the most recent
+    history of each thread. \n
+
+    The recorded events can be saved at any time with saveToFile() in the
+    Chrome trace event format (JSON), which can be opened with
+    chrome://tracing or Perfetto. A file can also be written automatically
+    whenever a deadline miss is signaled. The file is then written by a
+    background thread, so that the haptic loop is not delayed. \n
+
+    Sections are instrumented with the C_HAPTIC_TRACE_SCOPE macro. Unless
+    __C_USE_HAPTIC_TRACE__ is defined when compiling CHAI3D and the
+    application (see CGlobals.h), the macros compile to nothing and the
+    instrumentation has no cost.
+*/
+//==============================================================================
+class cHapticTrace
+{
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables recording at runtime.
+    static void setEnabled(const bool a_enabled) { m_enabled = a_enabled; }
+
+    //! This method returns __true__ if recording is enabled.
+    static bool getEnabled() { return (m_enabled); }
+
+    //! This method sets the number of events kept by the buffers of threads that have not recorded any event yet.
+    static void setBufferSize(const unsigned int a_bufferSize);
+
+    //! This method returns the number of events kept by the buffers of new threads.
+    static unsigned int getBufferSize() { return (m_bufferSize); }
+
+    //! This method sets the name under which the calling thread appears in saved files.
+    static void setThreadName(const std::string& a_name);
+
+    //! This method returns the current time in seconds, as used by recorded events.
+    static double getTime();
+
+    //! This method records a timed section for the calling thread.
+    static void record(const char* a_name,
+                       const double a_startTime,
+                       const double a_endTime);
+
+    //! This method records an instant for the calling thread.
+    static void recordInstant(const char* a_name);
+
+    //! This method records a deadline miss, and requests a file to be saved if enabled with setDeadlineMissFile().
+    static void signalDeadlineMiss();
+
+    //! This method returns the number of deadline misses signaled so far.
+    static unsigned int getNumDeadlineMisses() { return (m_numDeadlineMisses); }
+
+    //! This method enables or disables saving a file when a deadline miss is signaled.
+    static void setDeadlineMissFile(const std::string& a_filename,
+                                    const double a_duration = 0.0);
+
+    //! This method saves the recorded events to a file in the Chrome trace event format.
+    static bool saveToFile(const std::string& a_filename,
+                           const double a_duration = 0.0);
+
+    //! This method discards all events recorded so far.
+    static void clear();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns the buffer of the calling thread, and creates it if needed.
+    static cHapticTraceBuffer* getThreadBuffer();
+
+    //! This method is the main loop of the thread saving files on deadline misses.
+    static void deadlineMissLoop();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED STATIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__, events are recorded.
+    static std::atomic<bool> m_enabled;
+
+    //! Number of events kept by the buffers of new threads.
+    static unsigned int m_bufferSize;
+
+    //! Buffers of all threads that have recorded events.
+    static std::vector<cHapticTraceBuffer*> m_buffers;
+
+    //! Mutex protecting the list of buffers and the deadline miss settings.
+    static std::mutex m_mutex;
+
+    //! Events recorded before this time have been discarded by clear().
+    static std::atomic<double> m_clearTime;
+
+    //! Number of deadline misses signaled.
+    static std::atomic<unsigned int> m_numDeadlineMisses;
+
+    //! If __true__, a file is saved by the deadline miss thread.
+    static std::atomic<bool> m_deadlineMissRequested;
+
+    //! If __true__, the deadline miss thread exits.
+    static std::atomic<bool> m_deadlineMissQuit;
+
+    //! Thread saving files on deadline misses.
+    static cThread* m_deadlineMissThread;
+
+    //! Filename of the file saved on deadline misses.
+    static std::string m_deadlineMissFilename;
+
+    //! Duration of the history saved on deadline misses.
+    static double m_deadlineMissDuration;
+};
+
+
+//==============================================================================
+/*!
+    \class      cHapticTraceScope
+    \ingroup    timers
+
+    \brief
+    This class records the section of code between its construction and
+    its destruction.
+*/
+//==============================================================================
+class cHapticTraceScope
+{
+public:
+
+    //! Constructor of cHapticTraceScope.
+    cHapticTraceScope(const char* a_name) : m_name(a_name), m_startTime(cHapticTrace::getEnabled() ? cHapticTrace::getTime() : -1.0) {}
+
+    //! Destructor of cHapticTraceScope.
+    ~cHapticTraceScope() { if (m_startTime >= 0.0) { cHapticTrace::record(m_name, m_startTime, cHapticTrace::getTime()); } }
+
+protected:
+
+    //! Name of the section.
+    const char* m_name;
+
+    //! Start time of the section, or -1 if recording was disabled.
+    double m_startTime;
+};
+
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+#define C_HAPTIC_TRACE_CONCAT_(a, b) a##b
+#define C_HAPTIC_TRACE_CONCAT(a, b) C_HAPTIC_TRACE_CONCAT_(a, b)
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+#if defined(C_USE_HAPTIC_TRACE)
+
+//! Records the time spent until the end of the enclosing block under the name __a_name__ (a string literal).
+#define C_HAPTIC_TRACE_SCOPE(a_name) chai3d::cHapticTraceScope C_HAPTIC_TRACE_CONCAT(hapticTraceScope, __LINE__)(a_name)
+
+//! Records an instant under the name __a_name__ (a string literal).
+#define C_HAPTIC_TRACE_INSTANT(a_name) chai3d::cHapticTrace::recordInstant(a_name)
+
+//! Signals a deadline miss.
+#define C_HAPTIC_TRACE_DEADLINE_MISS() chai3d::cHapticTrace::signalDeadlineMiss()
+
+//! Sets the name under which the calling thread appears in saved files.
+#define C_HAPTIC_TRACE_THREAD_NAME(a_name) chai3d::cHapticTrace::setThreadName(a_name)
+
+#else
+
+#define C_HAPTIC_TRACE_SCOPE(a_name)
+#define C_HAPTIC_TRACE_INSTANT(a_name)
+#define C_HAPTIC_TRACE_DEADLINE_MISS()
+#define C_HAPTIC_TRACE_THREAD_NAME(a_name)
+
+#endif
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -43,6 +43,7 @@
 
 //------------------------------------------------------------------------------
 #include "tools/CGenericTool.h"
+#include "timers/CHapticTrace.h"
 #include "world/CMesh.h"
 //------------------------------------------------------------------------------
 using namespace std;
@@ -711,6 +712,8 @@ void cGenericTool::initialize()
 //==============================================================================
 void cGenericTool::updateFromDevice()
 {
+    C_HAPTIC_TRACE_SCOPE("device read");
+
     // check if device is available
     if ((m_hapticDevice == nullptr) || (!m_enabled)) 
     {
@@ -882,6 +885,8 @@ void cGenericTool::computeInteractionForces()
 //==============================================================================
 bool cGenericTool::applyToDevice()
 {
+    C_HAPTIC_TRACE_SCOPE("device write");
+
     // check if device is available
     if ((m_hapticDevice == nullptr) || (!m_enabled)) { return (C_ERROR); }
 
@@ -439,6 +439,9 @@ public:
     //! This method returns a pointer to a haptic point by passing its index number.
     cHapticPoint* getHapticPoint(int a_index) { return (m_hapticPoints[a_index]); }
 
+    //! This method returns the goal position of a haptic point in world coordinates, for the current position of the haptic device.
+    virtual cVector3d getHapticPointGoalGlobalPos(const int a_index) { return (m_deviceGlobalPos); }
+
     //! This method sets the radius size of all haptic points.
     virtual void setRadius(double a_radius);
 
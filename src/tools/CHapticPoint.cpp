@@ -79,6 +79,9 @@ cHapticPoint::cHapticPoint(cGenericTool* a_parentTool)
     m_audioProxyContacts[1]	= NULL;
     m_audioProxyContacts[2]	= NULL;
     m_useAudioSources = false;
+    m_proxyForceComputed = false;
+    m_proxyForceGoalPos.zero();
+    m_proxyForce.zero();
 
     // create finger-proxy algorithm used for modelling contacts with 
     // cMesh objects.
@@ -228,6 +231,7 @@ void cHapticPoint::initialize()
     // reset finger proxy algorithm by placing the proxy and the same position 
     // as the goal.
     m_algorithmFingerProxy->reset();
+    m_proxyForceComputed = false;
 
     // update position of proxy and goal spheres in tool coordinates
     updateSpherePositions();
@@ -248,6 +252,7 @@ void cHapticPoint::initialize(cVector3d a_globalPos)
     // initialize proxy algorithm.
     m_algorithmFingerProxy->initialize(m_parentTool->getParentWorld(), a_globalPos);
     m_algorithmPotentialField->initialize(m_parentTool->getParentWorld(), a_globalPos);
+    m_proxyForceComputed = false;
 
     // update position of proxy and goal spheres in tool coordinates
     updateSpherePositions();
@@ -435,7 +440,18 @@ cVector3d cHapticPoint::computeInteractionForces(cVector3d& a_globalPos,
 
     // we now update the new position of a goal point and update the proxy position.
     // As a result, the force contribution from the proxy is now calculated.
-    cVector3d force0 = m_algorithmFingerProxy->computeForces(a_globalPos, a_globalLinVel);
+    // If the force has already been computed for this goal by computeProxyForces(),
+    // the result is used as is.
+    cVector3d force0;
+    if (m_proxyForceComputed && m_proxyForceGoalPos.equals(a_globalPos))
+    {
+        force0 = m_proxyForce;
+    }
+    else
+    {
+        force0 = m_algorithmFingerProxy->computeForces(a_globalPos, a_globalLinVel);
+    }
+    m_proxyForceComputed = false;
 
     // we now flag each mesh for which the proxy may be interacting with. This information is 
     // necessary for haptic effects that may be associated with these mesh objects.
@@ -571,6 +587,32 @@ cVector3d cHapticPoint::computeInteractionForces(cVector3d& a_globalPos,
 }
 
 
+//==============================================================================
+/*!
+    This method runs the finger-proxy algorithm for a new goal position and
+    stores the resulting force, which is then used by the next call to
+    computeInteractionForces() with the same goal position. \n
+
+    The finger-proxy algorithm only reads the world, and only modifies the
+    state of this haptic point. Haptic points of one or more tools may
+    therefore call this method concurrently, as long as the world is not
+    modified meanwhile. Flagging the objects in contact, haptic effects, and
+    audio are then handled by computeInteractionForces(), which must be
+    called sequentially.
+
+    \param  a_globalPos     New desired goal position.
+    \param  a_globalLinVel  Linear velocity of tool.
+*/
+//==============================================================================
+void cHapticPoint::computeProxyForces(const cVector3d& a_globalPos,
+                                      const cVector3d& a_globalLinVel)
+{
+    m_proxyForce = m_algorithmFingerProxy->computeForces(a_globalPos, a_globalLinVel);
+    m_proxyForceGoalPos = a_globalPos;
+    m_proxyForceComputed = true;
+}
+
+
 //==============================================================================
 /*!
     This method checks if the tool is touching a particular object passed
@@ -653,8 +695,8 @@ void cHapticPoint::render(cRenderOptions& a_options)
             glDisable(GL_LIGHTING);
 
             // points describe line extremities
-            cVector3d posA = m_sphereProxy->getLocalPos();
-            cVector3d posB = m_sphereGoal->getLocalPos(); 
+            cVector3d posA = m_sphereProxy->getRenderLocalTransform().getLocalPos();
+            cVector3d posB = m_sphereGoal->getRenderLocalTransform().getLocalPos();
 
             // draw line
             glBegin(GL_LINES);
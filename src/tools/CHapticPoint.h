@@ -209,6 +209,10 @@ public:
                                        cVector3d& a_globalLinVel,
                                        cVector3d& a_globalAngVel);
 
+    //! This method computes the finger-proxy force ahead of computeInteractionForces(), so that haptic points can be processed concurrently.
+    void computeProxyForces(const cVector3d& a_globalPos,
+                            const cVector3d& a_globalLinVel);
+
     //! This method returns the last computed force in global world coordinates.
     cVector3d getLastComputedForce() { return (m_lastComputedGlobalForce); }
 
@@ -286,6 +290,15 @@ protected:
     //! Pointer to mesh objects for which the proxy is in contact with.
     cGenericObject* m_meshProxyContacts[3];
 
+    //! If __true__, the finger-proxy force has been computed by computeProxyForces() and awaits the next call to computeInteractionForces().
+    bool m_proxyForceComputed;
+
+    //! Goal position for which the finger-proxy force has been computed by computeProxyForces().
+    cVector3d m_proxyForceGoalPos;
+
+    //! Finger-proxy force computed by computeProxyForces().
+    cVector3d m_proxyForce;
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS - AUDIO
@@ -90,11 +90,16 @@ cToolGripper::~cToolGripper()
 
 //==============================================================================
 /*!
-    This method computes the interaction forces between the tool and all
-    objects located inside the virtual world.
+    This method computes the positions of the thumb and finger in world
+    coordinates from the position, orientation and gripper angle of the
+    haptic device.
+
+    \param  a_posThumb   Returned position of the thumb.
+    \param  a_posFinger  Returned position of the finger.
 */
 //==============================================================================
-void cToolGripper::computeInteractionForces()
+void cToolGripper::computeGripperGlobalPos(cVector3d& a_posThumb,
+                                           cVector3d& a_posFinger)
 {
     // convert the angle of the gripper into a position in device coordinates. 
     // this value is device dependent.
@@ -127,17 +132,56 @@ void cToolGripper::computeInteractionForces()
     cVector3d pFinger = m_gripperWorkspaceScale * m_workspaceScaleFactor * gripperPositionFinger * lineFingerThumb;
     cVector3d pThumb  = m_gripperWorkspaceScale * m_workspaceScaleFactor * gripperPositionThumb  * lineFingerThumb;
 
-    cVector3d posFinger, posThumb;
     if (m_hapticDevice->m_specifications.m_rightHand)
     {
-        posFinger = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (1.0 * pFinger));
-        posThumb = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (1.0 * pThumb));
+        a_posFinger = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (1.0 * pFinger));
+        a_posThumb = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (1.0 * pThumb));
     }
     else
     {
-        posFinger = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (-1.0 * pFinger));
-        posThumb  = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (-1.0 * pThumb));
+        a_posFinger = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (-1.0 * pFinger));
+        a_posThumb  = m_deviceGlobalPos + cMul(m_deviceGlobalRot, (-1.0 * pThumb));
     }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the goal position of a haptic point of the gripper
+    in world coordinates, for the current state of the haptic device.
+
+    \param  a_index  Index of the haptic point (0 for the thumb, 1 for the finger).
+
+    \return Goal position of the haptic point.
+*/
+//==============================================================================
+cVector3d cToolGripper::getHapticPointGoalGlobalPos(const int a_index)
+{
+    cVector3d posThumb, posFinger;
+    computeGripperGlobalPos(posThumb, posFinger);
+
+    if (m_hapticPoints[a_index] == m_hapticPointThumb)
+    {
+        return (posThumb);
+    }
+    else
+    {
+        return (posFinger);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the interaction forces between the tool and all
+    objects located inside the virtual world.
+*/
+//==============================================================================
+void cToolGripper::computeInteractionForces()
+{
+    // compute new position of thumb and finger
+    cVector3d posFinger, posThumb;
+    computeGripperGlobalPos(posThumb, posFinger);
 
     // compute forces
     cVector3d forceThumb = m_hapticPointThumb->computeInteractionForces(posThumb, 
@@ -123,6 +123,20 @@ public:
     //! This method returns the workspace scale factor of the gripper.
     virtual double getGripperWorskpaceScale() { return (m_gripperWorkspaceScale); }
 
+    //! This method returns the goal position of the thumb (index 0) or finger (index 1) haptic point in world coordinates.
+    virtual cVector3d getHapticPointGoalGlobalPos(const int a_index);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method computes the positions of the thumb and finger in world coordinates from the gripper angle.
+    void computeGripperGlobalPos(cVector3d& a_posThumb,
+                                 cVector3d& a_posFinger);
+
 
     //--------------------------------------------------------------------------
     // MEMBERS
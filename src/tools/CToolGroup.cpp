@@ -0,0 +1,243 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "tools/CToolGroup.h"
+#include "timers/CHapticTrace.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cToolGroup. The worker threads run at haptic priority.
+    Since a haptic point is processed in a few microseconds, a small number
+    of threads is usually sufficient.
+
+    \param  a_numThreads  Total number of threads used during the collision phase, including the calling thread (0 to use one thread per processor core).
+*/
+//==============================================================================
+cToolGroup::cToolGroup(const unsigned int a_numThreads)
+{
+    m_workerPool = new cWorkerPool(a_numThreads, CTHREAD_PRIORITY_HAPTICS);
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cToolGroup. Tools are not deleted.
+*/
+//==============================================================================
+cToolGroup::~cToolGroup()
+{
+    delete m_workerPool;
+}
+
+
+//==============================================================================
+/*!
+    This method adds a tool to the group. Tools are processed in the order
+    in which they are added.
+
+    \param  a_tool  Tool to be added.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cToolGroup::addTool(cGenericTool* a_tool)
+{
+    // sanity check
+    if (a_tool == NULL)
+    {
+        return (C_ERROR);
+    }
+
+    // check if tool is already part of the group
+    if (std::find(m_tools.begin(), m_tools.end(), a_tool) != m_tools.end())
+    {
+        return (C_ERROR);
+    }
+
+    m_tools.push_back(a_tool);
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method removes a tool from the group. The tool is not deleted.
+
+    \param  a_tool  Tool to be removed.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cToolGroup::removeTool(cGenericTool* a_tool)
+{
+    std::vector<cGenericTool*>::iterator it = std::find(m_tools.begin(), m_tools.end(), a_tool);
+    if (it == m_tools.end())
+    {
+        return (C_ERROR);
+    }
+
+    m_tools.erase(it);
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method updates the position, orientation, velocity and other
+    degrees of freedom of all tools by reading their haptic devices. Devices
+    are read sequentially, since device drivers are not guaranteed to be
+    thread-safe.
+*/
+//==============================================================================
+void cToolGroup::updateFromDevices()
+{
+    for (unsigned int i=0; i<m_tools.size(); i++)
+    {
+        m_tools[i]->updateFromDevice();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method computes the interaction forces of all tools. The finger-proxy
+    algorithms of all haptic points are first executed concurrently, then
+    the interaction forces of each tool are computed sequentially in the
+    order in which tools were added to the group.
+*/
+//==============================================================================
+void cToolGroup::computeInteractionForces()
+{
+    // collect the goal position of every haptic point of every tool
+    m_points.clear();
+    for (unsigned int i=0; i<m_tools.size(); i++)
+    {
+        cGenericTool* tool = m_tools[i];
+        cVector3d globalLinVel = tool->getDeviceGlobalLinVel();
+
+        int numHapticPoints = tool->getNumHapticPoints();
+        for (int j=0; j<numHapticPoints; j++)
+        {
+            cToolGroupPoint point;
+            point.m_hapticPoint = tool->getHapticPoint(j);
+            point.m_globalPos = tool->getHapticPointGoalGlobalPos(j);
+            point.m_globalLinVel = globalLinVel;
+            m_points.push_back(point);
+        }
+    }
+
+    // collision phase: compute all proxies concurrently. Each haptic point
+    // only modifies its own state, while the world is only read.
+    unsigned int numPoints = (unsigned int)(m_points.size());
+    {
+        C_HAPTIC_TRACE_SCOPE("tool group proxies");
+        if (numPoints > 1)
+        {
+            m_workerPool->execute(computeProxyForces, this, numPoints, 1);
+        }
+        else
+        {
+            computeProxyForces(this, 0, numPoints);
+        }
+    }
+
+    // force phase: flag contacts, compute haptic effects, and combine forces
+    // of each tool in a fixed order
+    for (unsigned int i=0; i<m_tools.size(); i++)
+    {
+        m_tools[i]->computeInteractionForces();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method sends the latest computed force, torque, and gripper force of
+    all tools to their haptic devices.
+*/
+//==============================================================================
+void cToolGroup::applyToDevices()
+{
+    for (unsigned int i=0; i<m_tools.size(); i++)
+    {
+        m_tools[i]->applyToDevice();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method runs the finger-proxy algorithm of a range of haptic points.
+
+    \param  a_data   Tool group.
+    \param  a_begin  Index of the first haptic point.
+    \param  a_end    Index following the last haptic point.
+*/
+//==============================================================================
+void cToolGroup::computeProxyForces(void* a_data,
+                                    const unsigned int a_begin,
+                                    const unsigned int a_end)
+{
+    cToolGroup* group = (cToolGroup*)(a_data);
+
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        cToolGroupPoint& point = group->m_points[i];
+        point.m_hapticPoint->computeProxyForces(point.m_globalPos, point.m_globalLinVel);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,205 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CToolGroupH
+#define CToolGroupH
+//------------------------------------------------------------------------------
+#include "tools/CGenericTool.h"
+#include "system/CWorkerPool.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CToolGroup.h
+
+    \brief
+    Implements a group of tools updated together within a haptic loop.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//! Haptic point processed by a cToolGroup during the collision phase.
+struct cToolGroupPoint
+{
+    //! Haptic point.
+    cHapticPoint* m_hapticPoint;
+
+    //! Goal position of the haptic point in world coordinates.
+    cVector3d m_globalPos;
+
+    //! Linear velocity of the tool in world coordinates.
+    cVector3d m_globalLinVel;
+};
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \class      cToolGroup
+    \ingroup    tools
+
+    \brief
+    This class implements a group of tools updated together within a haptic
+    loop.
+
+    \details
+    When several tools are driven by the same haptic thread, cToolGroup
+    replaces the sequential calls to updateFromDevice(),
+    computeInteractionForces() and applyToDevice() of every tool. \n
+
+    Force computations are split in two phases. During the collision phase,
+    the finger-proxy algorithms of all haptic points of all tools are
+    executed concurrently on a small pool of worker threads. These
+    algorithms only read the world, which must therefore not be modified
+    by other threads until computeInteractionForces() returns. During the
+    second phase, each tool computes its interaction forces in the order in
+    which tools were added to the group, using the proxy forces computed
+    previously. Flagging objects in contact, haptic effects, audio, and the
+    combination of forces and torques are thus executed sequentially, in a
+    fixed order, and produce the same results as calling
+    computeInteractionForces() on each tool in turn. \n
+
+    Tools that override computeInteractionForces() must also override
+    cGenericTool::getHapticPointGoalGlobalPos() when their haptic points do
+    not follow the position of the haptic device, otherwise the proxy of
+    those haptic points is computed a second time during the sequential
+    phase.
+*/
+//==============================================================================
+class cToolGroup
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cToolGroup.
+    cToolGroup(const unsigned int a_numThreads = 2);
+
+    //! Destructor of cToolGroup.
+    virtual ~cToolGroup();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method adds a tool to the group.
+    bool addTool(cGenericTool* a_tool);
+
+    //! This method removes a tool from the group.
+    bool removeTool(cGenericTool* a_tool);
+
+    //! This method removes all tools from the group.
+    void clearTools() { m_tools.clear(); }
+
+    //! This method returns the number of tools of the group.
+    unsigned int getNumTools() const { return ((unsigned int)(m_tools.size())); }
+
+    //! This method returns a tool of the group by passing its index number.
+    cGenericTool* getTool(const unsigned int a_index) { return (m_tools[a_index]); }
+
+    //! This method returns the number of threads used during the collision phase, including the calling thread.
+    unsigned int getNumThreads() const { return (m_workerPool->getNumThreads()); }
+
+    //! This method updates all tools from their haptic devices.
+    void updateFromDevices();
+
+    //! This method computes the interaction forces of all tools.
+    void computeInteractionForces();
+
+    //! This method sends the latest computed forces of all tools to their haptic devices.
+    void applyToDevices();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method runs the finger-proxy algorithm of a range of haptic points.
+    static void computeProxyForces(void* a_data,
+                                   const unsigned int a_begin,
+                                   const unsigned int a_end);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Tools of the group, in the order in which their forces are computed.
+    std::vector<cGenericTool*> m_tools;
+
+    //! Haptic points of all tools, processed during the collision phase.
+    std::vector<cToolGroupPoint> m_points;
+
+    //! Worker threads used during the collision phase.
+    cWorkerPool* m_workerPool;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -424,6 +424,31 @@ bool cLabel::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
     return (hit);
 }
 
+
+//==============================================================================
+/*!
+    This method enlarges a box so that it encloses the collisions computed
+    with the rectangle covered by this label.
+
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+
+    \return __true__ since the rectangle always bounds the label.
+*/
+//==============================================================================
+bool cLabel::computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+                                              cVector3d& a_boxMax)
+{
+    a_boxMin(0) = cMin(a_boxMin(0), cMin(0.0, m_width));
+    a_boxMin(1) = cMin(a_boxMin(1), cMin(0.0, m_height));
+    a_boxMin(2) = cMin(a_boxMin(2), 0.0);
+    a_boxMax(0) = cMax(a_boxMax(0), cMax(0.0, m_width));
+    a_boxMax(1) = cMax(a_boxMax(1), cMax(0.0, m_height));
+    a_boxMax(2) = cMax(a_boxMax(2), 0.0);
+
+    return (true);
+}
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
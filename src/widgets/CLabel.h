@@ -148,6 +148,13 @@ public:
                                                 cCollisionRecorder& a_recorder,
                                                 cCollisionSettings& a_settings);
 
+    //! This method enlarges a box to enclose the collisions computed with this label.
+    virtual bool computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+                                                  cVector3d& a_boxMax);
+
+    //! This method returns __true__ since collisions with this label are computed with all settings.
+    virtual bool hasOtherCollisionDetection(const cCollisionSettings& a_settings) const { return (true); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -53,6 +53,8 @@
 #include "effects/CEffectVibration.h"
 #include "effects/CEffectViscosity.h"
 #include "shaders/CShaderProgram.h"
+#include "world/CSceneSnapshot.h"
+#include "world/CRenderQueue.h"
 //------------------------------------------------------------------------------
 #include <float.h>
 #include <vector>
@@ -69,6 +71,55 @@ cMaterialPtr cGenericObject::s_defaultMaterial = nullptr;
 cColorf cGenericObject::s_boundaryBoxColor(0.7f, 0.7f, 0.7f);
 //------------------------------------------------------------------------------
 
+//==============================================================================
+/*!
+    This function tests a box, expressed in the coordinates of an object,
+    against the clipping volume defined by the product of the projection, view
+    and model matrices of this object. The six clipping planes are extracted
+    from the rows of the matrix, and the box is considered outside of the
+    clipping volume if its corner furthest along the normal of one of the planes
+    lies behind that plane. The test is conservative: boxes crossing the corner
+    of the clipping volume may be reported as visible.
+
+    \param  a_matrix  Product of the projection, view and model matrices.
+    \param  a_boxMin  Minimum corner of the box.
+    \param  a_boxMax  Maximum corner of the box.
+
+    \return __true__ if the box may intersect the clipping volume, __false__ otherwise.
+*/
+//==============================================================================
+static inline bool cIsBoxInFrustum(const cTransform& a_matrix,
+                                   const cVector3d& a_boxMin,
+                                   const cVector3d& a_boxMax)
+{
+    // matrix elements are stored in column-major order: m[column][row]
+    const double (*m)[4] = a_matrix.m;
+
+    for (int i=0; i<6; i++)
+    {
+        // plane i: row 3 plus or minus row (i/2)
+        int row = i / 2;
+        double sign = (i % 2 == 0) ? 1.0 : -1.0;
+        double a = m[0][3] + sign * m[0][row];
+        double b = m[1][3] + sign * m[1][row];
+        double c = m[2][3] + sign * m[2][row];
+        double d = m[3][3] + sign * m[3][row];
+
+        // corner of the box furthest along the plane normal
+        double x = (a >= 0.0) ? a_boxMax(0) : a_boxMin(0);
+        double y = (b >= 0.0) ? a_boxMax(1) : a_boxMin(1);
+        double z = (c >= 0.0) ? a_boxMax(2) : a_boxMin(2);
+
+        if (a * x + b * y + c * z + d < 0.0)
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     Constructor of cGenericObject.
@@ -92,6 +143,10 @@ cGenericObject::cGenericObject()
     // initialize OpenGL matrix with position vector and orientation matrix
     m_frameGL.set(m_globalPos, m_globalRot);
 
+    // object is not registered with a scene snapshot
+    m_snapshot = NULL;
+    m_snapshotIndex = -1;
+
     // initialize name
     m_name = "";
 
@@ -131,6 +186,9 @@ cGenericObject::cGenericObject()
     // disable ghost setting
     m_ghostEnabled = false;
 
+    // no child added yet
+    m_childrenVersion = 0;
+
     // no external parent defined
     m_owner = this;
 
@@ -164,6 +222,13 @@ cGenericObject::cGenericObject()
     m_boundaryBoxMax.set(0.0, 0.0, 0.0);
     m_boundaryBoxEmpty = true;
 
+    // render boundary box
+    m_renderBoundaryBoxMin.set(0.0, 0.0, 0.0);
+    m_renderBoundaryBoxMax.set(0.0, 0.0, 0.0);
+    m_renderBoundaryBoxEmpty = true;
+    m_renderBoundaryBoxValid = false;
+    m_renderNumObjects = 1;
+
     // collision detector
     m_collisionDetector = NULL; 
     m_showCollisionDetector = false;
@@ -184,6 +249,12 @@ cGenericObject::cGenericObject()
 //==============================================================================
 cGenericObject::~cGenericObject()
 {
+    // unregister from scene snapshot
+    if (m_snapshot != NULL)
+    {
+        m_snapshot->removeObject(this);
+    }
+
     // delete collision detector
     deleteCollisionDetector(false);
 
@@ -226,6 +297,29 @@ void cGenericObject::setEnabled(bool a_enabled, const bool a_affectChildren)
 }
 
 
+//==============================================================================
+/*!
+    This method returns the local position and rotation of this object as seen
+    by the graphic renderer. If the object is registered with a cSceneSnapshot,
+    the transformation acquired by the last call to cSceneSnapshot::update()
+    is returned; otherwise the current local position and rotation are used.
+
+    \return Local transformation used for rendering.
+*/
+//==============================================================================
+cTransform cGenericObject::getRenderLocalTransform() const
+{
+    if (m_snapshot != NULL)
+    {
+        return (m_snapshot->getLocalTransform(m_snapshotIndex));
+    }
+    else
+    {
+        return (cTransform(m_localPos, m_localRot));
+    }
+}
+
+
 //==============================================================================
 /*!
     This method translate this object by a specified offset passed as argument.
@@ -1706,6 +1800,170 @@ bool cGenericObject::computeCollisionDetection(const cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method computes a box, expressed in the local coordinates of this
+    object, that encloses all collisions that may be reported by
+    computeCollisionDetection() for this object and its children. The box is
+    computed from the collision detector, from
+    computeOtherCollisionBoundaryBox() and from the boxes of the children. It
+    does not include the radius defined in the collision settings. \n
+
+    If this object or one of its children cannot be bounded, for instance
+    because its collision detector does not provide a box, the method returns
+    __false__ and the object must always be tested. If no collision can be
+    reported, the returned box is empty: its minimum is larger than its
+    maximum. \n
+
+    Argument \p a_moving is set to __true__ if the global position of this
+    object or one of its children has changed during the last call to
+    computeGlobalPositions(), and is left unchanged otherwise. Such objects
+    adjust the collision segment when motion adjustment is enabled in the
+    collision settings.
+
+    \param  a_boxMin  Returned minimum point of the box.
+    \param  a_boxMax  Returned maximum point of the box.
+    \param  a_moving  Set to __true__ if this object or one of its children is moving.
+
+    \return __true__ if the box encloses all collisions, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::computeCollisionBoundaryBox(cVector3d& a_boxMin,
+                                                 cVector3d& a_boxMax,
+                                                 bool& a_moving)
+{
+    // initialize empty box
+    a_boxMin.set( C_LARGE, C_LARGE, C_LARGE);
+    a_boxMax.set(-C_LARGE,-C_LARGE,-C_LARGE);
+
+    // ghost objects and their children never report collisions
+    if (m_ghostEnabled) { return (true); }
+
+    // check if object has moved
+    if (!m_globalPos.equals(m_prevGlobalPos) || !m_globalRot.equals(m_prevGlobalRot))
+    {
+        a_moving = true;
+    }
+
+    // enclose box of collision detector
+    if (m_collisionDetector != NULL)
+    {
+        cVector3d boxMin, boxMax;
+        if (!m_collisionDetector->computeBoundaryBox(boxMin, boxMax))
+        {
+            return (false);
+        }
+
+        for (int i=0; i<3; i++)
+        {
+            a_boxMin(i) = cMin(a_boxMin(i), boxMin(i));
+            a_boxMax(i) = cMax(a_boxMax(i), boxMax(i));
+        }
+    }
+
+    // enclose any other collisions
+    if (!computeOtherCollisionBoundaryBox(a_boxMin, a_boxMax))
+    {
+        return (false);
+    }
+
+    // enclose children
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        if (!encloseCollisionBoundaryBox(m_children[i], a_boxMin, a_boxMax, a_moving))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method enlarges a box, expressed in the local coordinates of this
+    object, so that it encloses the collisions computed by
+    computeOtherCollisionDetection(). \n
+
+    The default implementation encloses the boundary box of the object if it
+    is not empty. Classes that override computeOtherCollisionDetection()
+    without maintaining their boundary box must override this method too.
+
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+
+    \return __true__ if the box encloses all collisions, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+                                                      cVector3d& a_boxMax)
+{
+    if (!m_boundaryBoxEmpty)
+    {
+        for (int i=0; i<3; i++)
+        {
+            a_boxMin(i) = cMin(a_boxMin(i), m_boundaryBoxMin(i));
+            a_boxMax(i) = cMax(a_boxMax(i), m_boundaryBoxMax(i));
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method enlarges a box, expressed in the local coordinates of this
+    object, so that it encloses the collision boundary box of an object whose
+    position and orientation are defined relative to this object, such as a
+    child.
+
+    \param  a_object  Object to enclose.
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+    \param  a_moving  Set to __true__ if the object or one of its children is moving.
+
+    \return __true__ if the box encloses all collisions, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::encloseCollisionBoundaryBox(cGenericObject* a_object,
+                                                 cVector3d& a_boxMin,
+                                                 cVector3d& a_boxMax,
+                                                 bool& a_moving)
+{
+    // compute box of object in its own reference frame
+    cVector3d boxMin, boxMax;
+    if (!a_object->computeCollisionBoundaryBox(boxMin, boxMax, a_moving))
+    {
+        return (false);
+    }
+
+    // nothing to enclose
+    if ((boxMin(0) > boxMax(0)) || (boxMin(1) > boxMax(1)) || (boxMin(2) > boxMax(2)))
+    {
+        return (true);
+    }
+
+    // transform center and extent of box into the reference frame of this object
+    const cMatrix3d& rot = a_object->m_localRot;
+    cVector3d center = a_object->m_localPos + rot * (0.5 * (boxMin + boxMax));
+    cVector3d extent = 0.5 * (boxMax - boxMin);
+    for (int i=0; i<3; i++)
+    {
+        double size = fabs(rot(i,0)) * extent(0) +
+                      fabs(rot(i,1)) * extent(1) +
+                      fabs(rot(i,2)) * extent(2);
+
+        // enlarge box
+        a_boxMin(i) = cMin(a_boxMin(i), center(i) - size);
+        a_boxMax(i) = cMax(a_boxMax(i), center(i) + size);
+    }
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This method enables or disables graphic representation of the collision 
@@ -1794,6 +2052,7 @@ bool cGenericObject::addChild(cGenericObject* a_object)
     if (a_object->m_parent == NULL)
     {
         m_children.push_back(a_object);
+        m_childrenVersion++;
         a_object->m_parent = this;
         return (true);
     }
@@ -1803,6 +2062,7 @@ bool cGenericObject::addChild(cGenericObject* a_object)
     else if (m_ghostEnabled)
     {
         m_children.push_back(a_object);
+        m_childrenVersion++;
         return (true);
     }
 
@@ -1842,6 +2102,7 @@ bool cGenericObject::removeChild(cGenericObject* a_object)
 
             // remove this object from my list of children
             m_children.erase(it);
+            m_childrenVersion++;
 
             // return success
             return (true);
@@ -1920,6 +2181,7 @@ void cGenericObject::clearAllChildren()
 
     // clear children list
     m_children.clear();
+    m_childrenVersion++;
 }
 
 
@@ -1940,6 +2202,7 @@ void cGenericObject::deleteAllChildren()
 
     // clear my list of children
     m_children.clear();
+    m_childrenVersion++;
 }
 
 
@@ -2137,7 +2400,14 @@ void cGenericObject::copyGenericObjectProperties(cGenericObject* a_obj,
     does not generally need to be over-ridden in subclasses. \n
 
     The a_options parameter is used to allow multiple rendering passes. 
-    See CRenderOptionh.h for more information.
+    See CRenderOptionh.h for more information. \n
+
+    If frustum culling is enabled in the rendering options, objects located
+    outside of the clipping volume are skipped. During the pass that stores
+    object positions, every object is visited, each object is tested
+    individually, and the box enclosing each object and its children is 
+    computed. During the following passes, an object whose box lies outside of
+    the clipping volume is skipped together with all of its children.
 
     \param  a_options  Rendering options.
 */
@@ -2155,7 +2425,19 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
     // rendering pass
     if (a_options.m_storeObjectPositions)
     {
-        m_frameGL.set(m_localPos, m_localRot);
+        m_frameGL = getRenderLocalTransform();
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+    // Frustum culling
+    /////////////////////////////////////////////////////////////////////////
+
+    cTransform parentFrustumMatrix = a_options.m_frustumMatrix;
+    bool visible;
+    if (!cullSceneGraph(a_options, visible))
+    {
+        a_options.m_frustumMatrix = parentFrustumMatrix;
+        return;
     }
 
     // push object position/orientation on stack
@@ -2163,114 +2445,193 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
     glMultMatrixd( (const double *)m_frameGL.getData() );
 
     // render if object is enabled
-    if (m_enabled)
+    if (m_enabled && visible)
     {
-        //--------------------------------------------------------------------------
-        // Request for RESET
-        //-----------------------------------------------------------------------
-        if(a_options.m_markForUpdate)
-        {
-            // invalidate display list 
-            markForUpdate(false);
+        renderObject(a_options);
+    }
 
-            // invalidate texture
-            if (m_texture != nullptr)
-            {
-                m_texture->markForUpdate();
-            }
-        }
+    // render children
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        m_children[i]->renderSceneGraph(a_options);
+    }
 
-        //-----------------------------------------------------------------------
-        // Init
-        //-----------------------------------------------------------------------
+    // update box enclosing this object and its children
+    if (a_options.m_storeObjectPositions && a_options.m_frustumCulling)
+    {
+        encloseChildrenRenderBoundaryBoxes();
+    }
 
-        glEnable(GL_LIGHTING);
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
-        glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
+    // restore clipping volume of parent
+    a_options.m_frustumMatrix = parentFrustumMatrix;
 
-        //-----------------------------------------------------------------------
-        // Render bounding box, frame, collision detector. (opaque components)
-        //-----------------------------------------------------------------------
-        if (SECTION_RENDER_OPAQUE_PARTS_ONLY(a_options) && (!a_options.m_rendering_shadow))
-        {
-            // disable lighting
-            glDisable(GL_LIGHTING);
+    // pop current matrix
+    glPopMatrix();
 
-            // render boundary box
-            if (m_showBoundaryBox)
-            {
-                // set size on lines
-                glLineWidth(1.0);
+#endif
+}
 
-                // set color of boundary box
-                glColor4fv(s_boundaryBoxColor.getData());
 
-                // draw box line
-                cDrawWireBox(m_boundaryBoxMin(0) , m_boundaryBoxMax(0) ,
-                             m_boundaryBoxMin(1) , m_boundaryBoxMax(1) ,
-                             m_boundaryBoxMin(2) , m_boundaryBoxMax(2) );
-            }
+//==============================================================================
+/*!
+    This method renders this object, without its children, for the rendering
+    pass described by \p a_options. It renders the boundary box, reference 
+    frame and collision tree when enabled, sets up face culling and blending 
+    for the current pass, and calls render(). The modelview matrix must 
+    already contain the transformation of the object.
 
-            // render collision tree
-            if (m_showCollisionDetector && (m_collisionDetector != NULL))
-            {
-                m_collisionDetector->render(a_options);
-            }
+    \param  a_options  Rendering options.
+*/
+//==============================================================================
+void cGenericObject::renderObject(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
 
-            // enable lighting
-            glEnable(GL_LIGHTING);
+    //--------------------------------------------------------------------------
+    // Request for RESET
+    //-----------------------------------------------------------------------
+    if(a_options.m_markForUpdate)
+    {
+        // invalidate display list 
+        markForUpdate(false);
+
+        // invalidate texture
+        if (m_texture != nullptr)
+        {
+            m_texture->markForUpdate();
         }
+    }
+
+    //-----------------------------------------------------------------------
+    // Init
+    //-----------------------------------------------------------------------
+
+    glEnable(GL_LIGHTING);
+    glDisable(GL_BLEND);
+    glDepthMask(GL_TRUE);
+    glEnable(GL_DEPTH_TEST);
+    glColorMaterial(GL_FRONT_AND_BACK,GL_AMBIENT_AND_DIFFUSE);
 
-        // render frame
-        if (m_showFrame && (a_options.m_single_pass_only || a_options.m_render_opaque_objects_only))
+    //-----------------------------------------------------------------------
+    // Render bounding box, frame, collision detector. (opaque components)
+    //-----------------------------------------------------------------------
+    if (SECTION_RENDER_OPAQUE_PARTS_ONLY(a_options) && (!a_options.m_rendering_shadow))
+    {
+        // disable lighting
+        glDisable(GL_LIGHTING);
+
+        // render boundary box
+        if (m_showBoundaryBox)
         {
-            glDisableClientState(GL_COLOR_ARRAY);
-            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-            glDisableClientState(GL_INDEX_ARRAY);
-            glDisableClientState(GL_EDGE_FLAG_ARRAY);
-            glDisable(GL_COLOR_MATERIAL);
+            // set size on lines
+            glLineWidth(1.0);
 
-            glEnable(GL_COLOR_MATERIAL);
-            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
-            glColor4f(1.0,1.0,1.0,1.0);
+            // set color of boundary box
+            glColor4fv(s_boundaryBoxColor.getData());
 
-            // set rendering properties
-            glPolygonMode(GL_FRONT, GL_FILL);
-                
-            // draw frame
-            cDrawFrame(m_frameSize, m_frameThicknessScale);
+            // draw box line
+            cDrawWireBox(m_boundaryBoxMin(0) , m_boundaryBoxMax(0) ,
+                         m_boundaryBoxMin(1) , m_boundaryBoxMax(1) ,
+                         m_boundaryBoxMin(2) , m_boundaryBoxMax(2) );
+        }
+
+        // render collision tree
+        if (m_showCollisionDetector && (m_collisionDetector != NULL))
+        {
+            m_collisionDetector->render(a_options);
         }
 
-        //-----------------------------------------------------------------------
-        // Render graphical representation of object
-        //-----------------------------------------------------------------------
-        if (m_showEnabled)
+        // enable lighting
+        glEnable(GL_LIGHTING);
+    }
+
+    // render frame
+    if (m_showFrame && (a_options.m_single_pass_only || a_options.m_render_opaque_objects_only))
+    {
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_INDEX_ARRAY);
+        glDisableClientState(GL_EDGE_FLAG_ARRAY);
+        glDisable(GL_COLOR_MATERIAL);
+
+        glEnable(GL_COLOR_MATERIAL);
+        glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+        glColor4f(1.0,1.0,1.0,1.0);
+
+        // set rendering properties
+        glPolygonMode(GL_FRONT, GL_FILL);
+            
+        // draw frame
+        cDrawFrame(m_frameSize, m_frameThicknessScale);
+    }
+
+    //-----------------------------------------------------------------------
+    // Render graphical representation of object
+    //-----------------------------------------------------------------------
+    if (m_showEnabled)
+    {
+        // set polygon and face mode
+        glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
+
+        // initialize line width
+        glLineWidth(1.0f);
+
+        /////////////////////////////////////////////////////////////////////
+        // CREATING SHADOW DEPTH MAP
+        /////////////////////////////////////////////////////////////////////
+        if (a_options.m_creating_shadow_map)
         {
-            // set polygon and face mode
-            glPolygonMode(GL_FRONT_AND_BACK, m_triangleMode);
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
 
-            // initialize line width
-            glLineWidth(1.0f);
+            // render object
+            render(a_options);
+            glDisable(GL_CULL_FACE);
+        }
 
-            /////////////////////////////////////////////////////////////////////
-            // CREATING SHADOW DEPTH MAP
-            /////////////////////////////////////////////////////////////////////
-            if (a_options.m_creating_shadow_map)
+        /////////////////////////////////////////////////////////////////////
+        // SINGLE PASS RENDERING
+        /////////////////////////////////////////////////////////////////////
+        else if (a_options.m_single_pass_only)
+        {
+            if (m_cullingEnabled)
             {
                 glEnable(GL_CULL_FACE);
-                glCullFace(GL_FRONT);
-
-                // render object
-                render(a_options);
+                glCullFace(GL_BACK);
+            }
+            else
+            {
                 glDisable(GL_CULL_FACE);
             }
 
-            /////////////////////////////////////////////////////////////////////
-            // SINGLE PASS RENDERING
-            /////////////////////////////////////////////////////////////////////
-            else if (a_options.m_single_pass_only)
+            if (m_useTransparency)
+            {
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                glDepthMask(GL_FALSE);
+            }
+            else
+            {
+                glDisable(GL_BLEND);
+                glDepthMask(GL_TRUE);
+            }
+
+            // render object
+            render(a_options);
+
+            // disable blending
+            glDisable(GL_BLEND);
+            glDepthMask(GL_TRUE);
+        }
+
+
+        /////////////////////////////////////////////////////////////////////
+        // MULTI PASS RENDERING
+        /////////////////////////////////////////////////////////////////////
+        else
+        {
+            // opaque objects
+            if (a_options.m_render_opaque_objects_only)
             {
                 if (m_cullingEnabled)
                 {
@@ -2282,6 +2643,12 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
                     glDisable(GL_CULL_FACE);
                 }
 
+                render(a_options);
+            }
+
+            // render transparent back triangles
+            if (a_options.m_render_transparent_back_faces_only)
+            {
                 if (m_useTransparency)
                 {
                     glEnable(GL_BLEND);
@@ -2294,7 +2661,9 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
                     glDepthMask(GL_TRUE);
                 }
 
-                // render object
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_FRONT);
+                
                 render(a_options);
 
                 // disable blending
@@ -2302,91 +2671,278 @@ void cGenericObject::renderSceneGraph(cRenderOptions& a_options)
                 glDepthMask(GL_TRUE);
             }
 
-
-            /////////////////////////////////////////////////////////////////////
-            // MULTI PASS RENDERING
-            /////////////////////////////////////////////////////////////////////
-            else
+            // render transparent front triangles
+            if (a_options.m_render_transparent_front_faces_only)
             {
-                // opaque objects
-                if (a_options.m_render_opaque_objects_only)
+                if (m_useTransparency)
                 {
-                    if (m_cullingEnabled)
-                    {
-                        glEnable(GL_CULL_FACE);
-                        glCullFace(GL_BACK);
-                    }
-                    else
-                    {
-                        glDisable(GL_CULL_FACE);
-                    }
-
-                    render(a_options);
+                    glEnable(GL_BLEND);
+                    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                    glDepthMask(GL_FALSE);
                 }
-
-                // render transparent back triangles
-                if (a_options.m_render_transparent_back_faces_only)
+                else
                 {
-                    if (m_useTransparency)
-                    {
-                        glEnable(GL_BLEND);
-                        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                        glDepthMask(GL_FALSE);
-                    }
-                    else
-                    {
-                        glDisable(GL_BLEND);
-                        glDepthMask(GL_TRUE);
-                    }
-
-                    glEnable(GL_CULL_FACE);
-                    glCullFace(GL_FRONT);
-                    
-                    render(a_options);
-
-                    // disable blending
                     glDisable(GL_BLEND);
                     glDepthMask(GL_TRUE);
                 }
 
-                // render transparent front triangles
-                if (a_options.m_render_transparent_front_faces_only)
-                {
-                    if (m_useTransparency)
-                    {
-                        glEnable(GL_BLEND);
-                        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                        glDepthMask(GL_FALSE);
-                    }
-                    else
-                    {
-                        glDisable(GL_BLEND);
-                        glDepthMask(GL_TRUE);
-                    }
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_BACK);
 
-                    glEnable(GL_CULL_FACE);
-                    glCullFace(GL_BACK);
+                render(a_options);
 
-                    render(a_options);
-    
-                    // disable blending
-                    glDisable(GL_BLEND);
-                    glDepthMask(GL_TRUE);
-                }
+                // disable blending
+                glDisable(GL_BLEND);
+                glDepthMask(GL_TRUE);
             }
         }
     }
 
-    // render children
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method tests this object against the clipping volume described by
+    the rendering options, and updates the counters of drawn and culled 
+    objects. The clipping volume is first expressed in the coordinates of this
+    object; the caller restores the clipping volume of the parent once this 
+    object and its children have been visited. \n
+
+    During the pass that stores object positions, the object is tested alone 
+    and its children are always visited. During the following passes, the box
+    enclosing the object and its children is tested, and the entire subtree
+    is skipped when it lies outside of the clipping volume.
+
+    \param  a_options  Rendering options.
+    \param  a_visible  Returns __true__ if the object itself must be rendered.
+
+    \return __false__ if the object and its children are skipped, __true__ otherwise.
+*/
+//==============================================================================
+bool cGenericObject::cullSceneGraph(cRenderOptions& a_options, bool& a_visible)
+{
+    // objects are never skipped when display lists and textures are reset
+    bool culling = a_options.m_frustumCulling && !a_options.m_markForUpdate;
+    a_visible = true;
+
+    // express the clipping volume in the coordinates of this object
+    if (a_options.m_frustumCulling)
+    {
+        a_options.m_frustumMatrix.mul(m_frameGL);
+    }
+
+    if (a_options.m_storeObjectPositions)
+    {
+        if (a_options.m_frustumCulling)
+        {
+            // the boxes of the children are updated once they have been visited
+            initRenderBoundaryBox();
+
+            // test this object only
+            if (culling && m_renderBoundaryBoxValid)
+            {
+                a_visible = !m_renderBoundaryBoxEmpty &&
+                            cIsBoxInFrustum(a_options.m_frustumMatrix, m_renderBoundaryBoxMin, m_renderBoundaryBoxMax);
+            }
+        }
+        else
+        {
+            m_renderBoundaryBoxValid = false;
+        }
+    }
+    else if (culling && m_renderBoundaryBoxValid)
+    {
+        // skip this object and all of its children
+        if (m_renderBoundaryBoxEmpty ||
+            !cIsBoxInFrustum(a_options.m_frustumMatrix, m_renderBoundaryBoxMin, m_renderBoundaryBoxMax))
+        {
+            a_options.m_numCulledObjects += m_renderNumObjects;
+            return (false);
+        }
+    }
+
+    // update counters
+    if (a_visible)
+    {
+        a_options.m_numDrawnObjects++;
+    }
+    else
+    {
+        a_options.m_numCulledObjects++;
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method traverses the scene graph starting at this object and adds
+    every enabled object located inside the clipping volume to a render queue.
+    Object positions are stored and objects are culled exactly as they would
+    be by renderSceneGraph(), but nothing is rendered.
+
+    \param  a_queue         Render queue.
+    \param  a_options       Rendering options.
+    \param  a_parentMatrix  Transformation of the parent object, relative to the root of the traversal.
+*/
+//==============================================================================
+void cGenericObject::buildRenderQueue(cRenderQueue* a_queue,
+                                      cRenderOptions& a_options,
+                                      const cTransform& a_parentMatrix)
+{
+    // store position and orientation of the object
+    if (a_options.m_storeObjectPositions)
+    {
+        m_frameGL = getRenderLocalTransform();
+    }
+
+    // frustum culling
+    cTransform parentFrustumMatrix = a_options.m_frustumMatrix;
+    bool visible;
+    if (!cullSceneGraph(a_options, visible))
+    {
+        a_options.m_frustumMatrix = parentFrustumMatrix;
+        return;
+    }
+
+    // compute transformation relative to the root of the traversal
+    cTransform matrix;
+    a_parentMatrix.mulr(m_frameGL, matrix);
+
+    // add object to queue
+    if (m_enabled && visible)
+    {
+        a_queue->addObject(this, matrix);
+    }
+
+    // add children
     for (unsigned int i=0; i<m_children.size(); i++)
     {
-        m_children[i]->renderSceneGraph(a_options);
+        m_children[i]->buildRenderQueue(a_queue, a_options, matrix);
     }
 
-    // pop current matrix
-    glPopMatrix();
+    // update box enclosing this object and its children
+    if (a_options.m_storeObjectPositions && a_options.m_frustumCulling)
+    {
+        encloseChildrenRenderBoundaryBoxes();
+    }
 
-#endif
+    // restore clipping volume of parent
+    a_options.m_frustumMatrix = parentFrustumMatrix;
+}
+
+
+//==============================================================================
+/*!
+    This method initializes the render boundary box of this object with the
+    parts drawn by the object itself: its boundary box, which encloses the
+    geometry drawn by render(), and its reference frame when displayed. \n
+
+    Objects whose boundary box is empty while they are displayed have no known
+    extent, and the render boundary box is then marked as invalid.
+*/
+//==============================================================================
+void cGenericObject::initRenderBoundaryBox()
+{
+    m_renderBoundaryBoxValid = true;
+    m_renderBoundaryBoxEmpty = true;
+    m_renderNumObjects = 1;
+
+    // disabled objects draw nothing
+    if (!m_enabled) { return; }
+
+    // check if the object draws anything without a known extent
+    bool showCollisionDetector = m_showCollisionDetector && (m_collisionDetector != NULL);
+    if (m_boundaryBoxEmpty && (m_showEnabled || m_showBoundaryBox || showCollisionDetector))
+    {
+        m_renderBoundaryBoxValid = false;
+        return;
+    }
+
+    // boundary box
+    if (!m_boundaryBoxEmpty)
+    {
+        m_renderBoundaryBoxMin = m_boundaryBoxMin;
+        m_renderBoundaryBoxMax = m_boundaryBoxMax;
+        m_renderBoundaryBoxEmpty = false;
+    }
+
+    // reference frame
+    if (m_showFrame)
+    {
+        cVector3d frameMin(-m_frameSize, -m_frameSize, -m_frameSize);
+        cVector3d frameMax( m_frameSize,  m_frameSize,  m_frameSize);
+        if (m_renderBoundaryBoxEmpty)
+        {
+            m_renderBoundaryBoxMin = frameMin;
+            m_renderBoundaryBoxMax = frameMax;
+            m_renderBoundaryBoxEmpty = false;
+        }
+        else
+        {
+            for (int i=0; i<3; i++)
+            {
+                m_renderBoundaryBoxMin(i) = cMin(m_renderBoundaryBoxMin(i), frameMin(i));
+                m_renderBoundaryBoxMax(i) = cMax(m_renderBoundaryBoxMax(i), frameMax(i));
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method enlarges the render boundary box of this object to enclose the
+    render boundary boxes of its children, transformed by the local
+    transformation used to render each child. It is called once the children
+    have been visited during the rendering pass that stores object positions.
+*/
+//==============================================================================
+void cGenericObject::encloseChildrenRenderBoundaryBoxes()
+{
+    for (unsigned int i=0; i<m_children.size(); i++)
+    {
+        cGenericObject* child = m_children[i];
+
+        m_renderNumObjects += child->m_renderNumObjects;
+
+        // a child without a known extent prevents this object from being skipped
+        if (!child->m_renderBoundaryBoxValid)
+        {
+            m_renderBoundaryBoxValid = false;
+            continue;
+        }
+
+        if (child->m_renderBoundaryBoxEmpty) { continue; }
+
+        // transform the box of the child into the coordinates of this object
+        cVector3d center;
+        child->m_frameGL.mulr(0.5 * (child->m_renderBoundaryBoxMin + child->m_renderBoundaryBoxMax), center);
+        cVector3d extent = 0.5 * (child->m_renderBoundaryBoxMax - child->m_renderBoundaryBoxMin);
+        const double (*m)[4] = child->m_frameGL.m;
+
+        for (int j=0; j<3; j++)
+        {
+            double size = fabs(m[0][j]) * extent(0) +
+                          fabs(m[1][j]) * extent(1) +
+                          fabs(m[2][j]) * extent(2);
+
+            if (m_renderBoundaryBoxEmpty)
+            {
+                m_renderBoundaryBoxMin(j) = center(j) - size;
+                m_renderBoundaryBoxMax(j) = center(j) + size;
+            }
+            else
+            {
+                m_renderBoundaryBoxMin(j) = cMin(m_renderBoundaryBoxMin(j), center(j) - size);
+                m_renderBoundaryBoxMax(j) = cMax(m_renderBoundaryBoxMax(j), center(j) + size);
+            }
+        }
+        m_renderBoundaryBoxEmpty = false;
+    }
 }
 
 
@@ -73,6 +73,9 @@ class cGenericForceAlgorithm;
 class cMultiMesh;
 class cShaderProgram;
 class cInteractionRecorder;
+class cSceneSnapshot;
+class cRenderQueue;
+class cCollisionCache;
 //------------------------------------------------------------------------------
 typedef std::shared_ptr<cShaderProgram> cShaderProgramPtr;
 //------------------------------------------------------------------------------
@@ -112,6 +115,9 @@ typedef std::shared_ptr<cShaderProgram> cShaderProgramPtr;
 class cGenericObject : public cGenericType
 {
     friend class cMultiMesh;
+    friend class cSceneSnapshot;
+    friend class cRenderQueue;
+    friend class cCollisionCache;
 
     //--------------------------------------------------------------------------
     // CONSTRUCTOR & DESTRUCTOR:
@@ -221,6 +227,12 @@ public:
     //! This method returns the global position and rotation matrix in a transformation matrix.
     inline cTransform getGlobalTransform() { return (cTransform(m_globalPos, m_globalRot)); }
 
+    //! This method returns the local position and rotation matrix used by the graphic renderer.
+    cTransform getRenderLocalTransform() const;
+
+    //! This method returns the scene snapshot with which this object is registered, if any.
+    inline cSceneSnapshot* getSceneSnapshot() const { return (m_snapshot); }
+
     //! This method translates this object by a specified offset.
     void translate(const cVector3d& a_translation);
 
@@ -600,6 +612,11 @@ public:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings);
 
+    //! This method computes a box, in local coordinates, enclosing all collisions that may be reported by this object and its children.
+    virtual bool computeCollisionBoundaryBox(cVector3d& a_boxMin,
+        cVector3d& a_boxMax,
+        bool& a_moving);
+
     //! This method enables or disables the display of the collision detector, optionally propagating the change to its children.
     virtual void setShowCollisionDetector(const bool a_showCollisionDetector, const bool a_affectChildren = false);
 
@@ -654,6 +671,9 @@ public:
     //! This method returns the number of children from its list of children.
     inline unsigned int getNumChildren() { return ((unsigned int)m_children.size()); }
 
+    //! This method returns a counter incremented each time a child is added or removed.
+    inline unsigned int getChildrenVersion() const { return (m_childrenVersion); }
+
     //! This method returns the total number of descendants, optionally including this object.
     inline unsigned int getNumDescendants(bool a_includeCurrentObject = false);
 
@@ -738,6 +758,9 @@ protected:
     //! List of children.
     std::vector<cGenericObject*> m_children;
 
+    //! Counter incremented each time a child is added to or removed from \ref m_children.
+    unsigned int m_childrenVersion;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED MEMBERS - POSITION & ORIENTATION:
@@ -763,6 +786,12 @@ protected:
     //! Previous rotation since last haptic computation.
     cMatrix3d m_prevGlobalRot;
 
+    //! Scene snapshot from which the local position and rotation are read during rendering (NULL if none).
+    cSceneSnapshot* m_snapshot;
+
+    //! Index of this object in the scene snapshot.
+    int m_snapshotIndex;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED MEMBERS - BOUNDARY BOX
@@ -867,6 +896,21 @@ protected:
     //! OpenGL matrix describing my position and orientation transformation.
     cTransform m_frameGL;
 
+    //! Minimum corner of the box, in local coordinates, enclosing everything drawn by this object and its children.
+    cVector3d m_renderBoundaryBoxMin;
+
+    //! Maximum corner of the box, in local coordinates, enclosing everything drawn by this object and its children.
+    cVector3d m_renderBoundaryBoxMax;
+
+    //! If __true__, then this object and its children draw nothing.
+    bool m_renderBoundaryBoxEmpty;
+
+    //! If __false__, then the render boundary box is unknown and frustum culling does not skip this object and its children.
+    bool m_renderBoundaryBoxValid;
+
+    //! Number of objects in the scene graph starting at this object.
+    unsigned int m_renderNumObjects;
+
 
     //-----------------------------------------------------------------------
     // PROTECTED MEMBERS - COLLISION DETECTION:
@@ -923,6 +967,13 @@ protected:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings) {return(false);}
 
+    //! This method enlarges a box, in local coordinates, to enclose the collisions computed by computeOtherCollisionDetection().
+    virtual bool computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+        cVector3d& a_boxMax);
+
+    //! This method returns __true__ if computeOtherCollisionDetection() may report collisions with the given settings. Classes that override computeOtherCollisionDetection() must override this method too.
+    virtual bool hasOtherCollisionDetection(const cCollisionSettings& a_settings) const { return (false); }
+
 
     //-----------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -937,6 +988,29 @@ protected:
         const bool a_duplicateMeshData,
         const bool a_buildCollisionDetector);
 
+    //! This method enlarges a box, in local coordinates, to enclose the collision boundary box of a child object.
+    bool encloseCollisionBoundaryBox(cGenericObject* a_object,
+        cVector3d& a_boxMin,
+        cVector3d& a_boxMax,
+        bool& a_moving);
+
+    //! This method initializes the render boundary box with the parts drawn by this object only.
+    void initRenderBoundaryBox();
+
+    //! This method enlarges the render boundary box to enclose the render boundary boxes of the children.
+    void encloseChildrenRenderBoundaryBoxes();
+
+    //! This method tests this object against the clipping volume. Returns __false__ if the object and its children are skipped.
+    bool cullSceneGraph(cRenderOptions& a_options, bool& a_visible);
+
+    //! This method renders this object, without its children, for the current rendering pass.
+    void renderObject(cRenderOptions& a_options);
+
+    //! This method adds this object and its children to a render queue.
+    void buildRenderQueue(cRenderQueue* a_queue,
+        cRenderOptions& a_options,
+        const cTransform& a_parentMatrix);
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS - INTERACTIONS:
@@ -52,6 +52,7 @@
 #include "files/CFileModel3DS.h"
 #include "files/CFileModelOBJ.h"
 #include "shaders/CShaderProgram.h"
+#include "system/CWorkerPool.h"
 //------------------------------------------------------------------------------
 #include <algorithm>
 #include <vector>
@@ -66,6 +67,231 @@ using namespace std;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// number of vertices or triangles processed by each task of the mesh kernels
+const unsigned int C_MESH_CHUNK_SIZE = 4096;
+
+// data shared by the tasks processing the vertices and triangles of a mesh
+struct cMeshKernelJob
+{
+    cVertexArray* m_vertices;
+    cTriangleArray* m_triangles;
+    cMeshAdjacency* m_adjacency;
+    cVector3d* m_triangleVectors0;
+    cVector3d* m_triangleVectors1;
+    unsigned char* m_triangleFlags;
+    cVector3d* m_vertexVectors;
+    unsigned char* m_vertexFlags;
+    int* m_vertexTriangles;
+    cVector3d m_globalPos;
+    cMatrix3d m_globalRot;
+};
+
+// bounding box of a range of triangles
+struct cMeshBounds
+{
+    cVector3d m_min;
+    cVector3d m_max;
+    bool m_empty;
+};
+
+// executes a task over a range of items, using the shared worker pool for large meshes
+void cExecuteMeshKernel(cWorkerPoolTask a_task,
+                        cMeshKernelJob* a_job,
+                        const unsigned int a_numItems)
+{
+    if (a_numItems >= C_MESH_PARALLEL_THRESHOLD)
+    {
+        cWorkerPool::getSharedPool()->execute(a_task, a_job, a_numItems, C_MESH_CHUNK_SIZE);
+    }
+    else
+    {
+        a_task(a_job, 0, a_numItems);
+    }
+}
+
+// computes the unit normal of a range of triangles, or zero for degenerate triangles
+void cComputeTriangleNormals(void* a_data,
+                             const unsigned int a_begin,
+                             const unsigned int a_end)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    const cVector3d* positions = &job->m_vertices->m_localPos[0];
+    const unsigned int* indices = &job->m_triangles->m_indices[0];
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        const cVector3d& vertex0 = positions[indices[3*i+0]];
+        const cVector3d& vertex1 = positions[indices[3*i+1]];
+        const cVector3d& vertex2 = positions[indices[3*i+2]];
+
+        cVector3d& normal = job->m_triangleVectors0[i];
+        cVector3d v01, v02;
+        vertex1.subr(vertex0, v01);
+        vertex2.subr(vertex0, v02);
+        v01.crossr(v02, normal);
+        double length = normal.length();
+        if (length > 0.0)
+        {
+            normal.div(length);
+        }
+        else
+        {
+            normal.zero();
+        }
+    }
+}
+
+// adds the normals of the triangles leaving a range of positions to their vertices
+void cGatherVertexNormals(void* a_data,
+                          const unsigned int a_begin,
+                          const unsigned int a_end)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    const cMeshAdjacency* adjacency = job->m_adjacency;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        int h = adjacency->getFirstHalfEdge(i);
+        while (h >= 0)
+        {
+            job->m_vertexVectors[adjacency->getOrigin(h)].add(job->m_triangleVectors0[cMeshAdjacency::getTriangle(h)]);
+            h = adjacency->getNextHalfEdge(h);
+        }
+    }
+}
+
+// normalizes a range of vertex normals, and flags those which differ from the current normals
+void cNormalizeVertexNormals(void* a_data,
+                             const unsigned int a_begin,
+                             const unsigned int a_end)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        cVector3d& normal = job->m_vertexVectors[i];
+        if (normal.length() > 0.000000001)
+        {
+            normal.normalize();
+        }
+        job->m_vertexFlags[i] = !normal.equals(job->m_vertices->m_normal[i]);
+    }
+}
+
+// computes the tangent and bitangent vectors of a range of triangles
+void cComputeTriangleBTN(void* a_data,
+                         const unsigned int a_begin,
+                         const unsigned int a_end)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        job->m_triangleFlags[i] = job->m_triangles->computeTriangleBTN(i, job->m_triangleVectors0[i], job->m_triangleVectors1[i]);
+    }
+}
+
+// finds the last valid triangle of the vertices of a range of positions
+void cGatherVertexTriangles(void* a_data,
+                            const unsigned int a_begin,
+                            const unsigned int a_end)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    const cMeshAdjacency* adjacency = job->m_adjacency;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        int h = adjacency->getFirstHalfEdge(i);
+        while (h >= 0)
+        {
+            int triangle = (int)(cMeshAdjacency::getTriangle(h));
+            int& lastTriangle = job->m_vertexTriangles[adjacency->getOrigin(h)];
+            if (job->m_triangleFlags[triangle] && (triangle > lastTriangle))
+            {
+                lastTriangle = triangle;
+            }
+            h = adjacency->getNextHalfEdge(h);
+        }
+    }
+}
+
+// assigns the tangent and bitangent vectors of their last triangle to a range of vertices
+void cSetVertexBTN(void* a_data,
+                   const unsigned int a_begin,
+                   const unsigned int a_end)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        int triangle = job->m_vertexTriangles[i];
+        if (triangle >= 0)
+        {
+            job->m_triangles->setVertexBTN(i, job->m_triangleVectors0[triangle], job->m_triangleVectors1[triangle]);
+        }
+    }
+}
+
+// computes the global position of a range of vertices
+void cComputeGlobalPositions(void* a_data,
+                             const unsigned int a_begin,
+                             const unsigned int a_end)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    const cVector3d* localPos = &job->m_vertices->m_localPos[0];
+    cVector3d* globalPos = &job->m_vertices->m_globalPos[0];
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        job->m_globalRot.mulr(localPos[i], globalPos[i]);
+        globalPos[i].add(job->m_globalPos);
+    }
+}
+
+// computes the bounding box of the vertices of a range of allocated triangles
+void cComputeTriangleBounds(void* a_data,
+                            const unsigned int a_begin,
+                            const unsigned int a_end,
+                            void* a_result)
+{
+    cMeshKernelJob* job = (cMeshKernelJob*)a_data;
+    const cVector3d* positions = &job->m_vertices->m_localPos[0];
+    const unsigned int* indices = &job->m_triangles->m_indices[0];
+    const std::vector<bool>& allocated = job->m_triangles->m_allocated;
+
+    double xMin = C_LARGE;
+    double yMin = C_LARGE;
+    double zMin = C_LARGE;
+    double xMax = -C_LARGE;
+    double yMax = -C_LARGE;
+    double zMax = -C_LARGE;
+    bool empty = true;
+
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        if (allocated[i])
+        {
+            for (unsigned int j=3*i; j<3*i+3; j++)
+            {
+                const cVector3d& vertex = positions[indices[j]];
+                xMin = cMin(vertex(0), xMin);
+                yMin = cMin(vertex(1), yMin);
+                zMin = cMin(vertex(2), zMin);
+                xMax = cMax(vertex(0), xMax);
+                yMax = cMax(vertex(1), yMax);
+                zMax = cMax(vertex(2), zMax);
+            }
+            empty = false;
+        }
+    }
+
+    cMeshBounds* bounds = (cMeshBounds*)a_result;
+    bounds->m_min.set(xMin, yMin, zMin);
+    bounds->m_max.set(xMax, yMax, zMax);
+    bounds->m_empty = empty;
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     Constructor of cMesh.
@@ -111,6 +337,9 @@ cMesh::cMesh(cMaterialPtr a_material)
     // set default collision detector
     m_collisionDetector = NULL;
 
+    // no adjacency index by default
+    m_adjacency = NULL;
+
     // display lists disabled by default
     m_useDisplayList = false;
 
@@ -136,6 +365,9 @@ cMesh::~cMesh()
     // delete any allocated display lists
     m_displayList.invalidate();
     m_displayListEdges.invalidate();
+
+    // delete adjacency index
+    deleteAdjacency();
 }
 
 
@@ -208,11 +440,17 @@ void cMesh::copyMeshProperties(cMesh* a_obj,
         if (a_buildCollisionDetector)
         {
             double radius = 0.0;
+            cAABBBuildMethod buildMethod = C_AABB_BUILD_CENTER;
             if (m_collisionDetector)
             {
                 radius = m_collisionDetector->getBoundaryRadius();
+                cCollisionAABB* collisionAABB = dynamic_cast<cCollisionAABB*>(m_collisionDetector);
+                if (collisionAABB != NULL)
+                {
+                    buildMethod = collisionAABB->getBuildMethod();
+                }
             }
-            a_obj->createAABBCollisionDetector(radius);
+            a_obj->createAABBCollisionDetector(radius, buildMethod);
         }
     }
     else
@@ -233,6 +471,12 @@ void cMesh::copyMeshProperties(cMesh* a_obj,
         }
     }
 
+    // build adjacency index
+    if (m_adjacency)
+    {
+        a_obj->createAdjacency();
+    }
+
     // extras
     a_obj->m_normalsColor = m_normalsColor;
     a_obj->m_normalsLength = m_normalsLength;
@@ -364,8 +608,18 @@ unsigned int cMesh::newTriangle(const unsigned int a_indexVertex0,
                                 const unsigned int a_indexVertex1,
                                 const unsigned int a_indexVertex2)
 {
+    // the adjacency index is only updated if no other change was missed
+    bool updateAdjacency = (m_adjacency != NULL) && m_adjacency->isUpToDate();
+
     int index = m_triangles->newTriangle(a_indexVertex0, a_indexVertex1, a_indexVertex2);
 
+    // update adjacency index
+    if (updateAdjacency)
+    {
+        m_adjacency->addTriangle(index);
+        m_adjacency->setUpToDate();
+    }
+
     // mark mesh for update
     markForUpdate(false);
 
@@ -413,6 +667,9 @@ unsigned int cMesh::newTriangle(const cVector3d& a_vertex0,
     unsigned int indexVertex1 = m_vertices->newVertex();
     unsigned int indexVertex2 = m_vertices->newVertex();
 
+    // the adjacency index is only updated if no other change was missed
+    bool updateAdjacency = (m_adjacency != NULL) && m_adjacency->isUpToDate();
+
     int index = m_triangles->newTriangle(indexVertex0, indexVertex1, indexVertex2);
 
     m_vertices->setLocalPos(indexVertex0, a_vertex0);
@@ -431,6 +688,13 @@ unsigned int cMesh::newTriangle(const cVector3d& a_vertex0,
     m_vertices->setColor(indexVertex1, a_colorVertex1);
     m_vertices->setColor(indexVertex2, a_colorVertex2);
 
+    // update adjacency index
+    if (updateAdjacency)
+    {
+        m_adjacency->addTriangle(index);
+        m_adjacency->setUpToDate();
+    }
+
     // mark mesh for update
     markForUpdate(false);
 
@@ -450,8 +714,21 @@ unsigned int cMesh::newTriangle(const cVector3d& a_vertex0,
 //==============================================================================
 bool cMesh::removeTriangle(const unsigned int a_index)
 {
+    // update adjacency index while the triangle is still allocated, unless
+    // another change was missed
+    bool updateAdjacency = (m_adjacency != NULL) && m_adjacency->isUpToDate();
+    if (updateAdjacency)
+    {
+        m_adjacency->removeTriangle(a_index);
+    }
+
     m_triangles->removeTriangle(a_index);
 
+    if (updateAdjacency)
+    {
+        m_adjacency->setUpToDate();
+    }
+
     // clear edges
     clearAllEdges();
 
@@ -479,6 +756,12 @@ void cMesh::clear()
     // clear all edges
     m_edges.clear();
 
+    // clear adjacency index
+    if (m_adjacency)
+    {
+        m_adjacency->clear();
+    }
+
     // mark for update
     markForUpdate(false);
 }
@@ -487,7 +770,15 @@ void cMesh::clear()
 //==============================================================================
 /*!
     This method computes all surface normals for every vertex in the mesh, by 
-    averaging the face normals of the triangle that include each vertex.
+    averaging the face normals of the triangle that include each vertex. \n
+
+    For meshes of at least C_MESH_PARALLEL_THRESHOLD vertices or triangles
+    that have an up-to-date adjacency index (see createAdjacency()), the
+    normals are computed by the shared worker pool if it has worker
+    threads. Each vertex then gathers the normals of its triangles through
+    the index. The result does not depend on the number of threads, but may
+    differ in the last bits from the result computed by the calling thread
+    alone. The adjacency index is never rebuilt by this method.
 */
 //==============================================================================
 void cMesh::computeAllNormals()
@@ -496,44 +787,93 @@ void cMesh::computeAllNormals()
     unsigned int numTriangles = m_triangles->getNumElements();
     unsigned int numVertices = m_vertices->getNumElements();
 
-    // initialize all normals to zero
-    for (unsigned int i=0; i<numVertices; i++)
-    {
-        m_vertices->setNormal(i, 0, 0, 0);
-    }
+    // sanity check
+    if (!m_vertices->getUseNormalData()) { return; }
+    if (numVertices == 0) { return; }
 
-    // compute the normal of each triangle, add contribution to each vertex
-    for (unsigned int i=0; i<numTriangles; i++)
-    {
-        unsigned int vertexIndex0 = m_triangles->getVertexIndex0(i);
-        unsigned int vertexIndex1 = m_triangles->getVertexIndex1(i);
-        unsigned int vertexIndex2 = m_triangles->getVertexIndex2(i);
+    // initialize all normals to zero; normals are accumulated separately so
+    // that only those which change are uploaded to the vertex buffer
+    std::vector<cVector3d> normals(numVertices, cVector3d(0.0, 0.0, 0.0));
 
-        cVector3d vertex0 = m_vertices->getLocalPos(vertexIndex0);
-        cVector3d vertex1 = m_vertices->getLocalPos(vertexIndex1);
-        cVector3d vertex2 = m_vertices->getLocalPos(vertexIndex2);
+    // the kernels are slower than a single loop on one thread, so they are
+    // only used if the work can be shared with other threads
+    bool parallel = ((numTriangles >= C_MESH_PARALLEL_THRESHOLD) || (numVertices >= C_MESH_PARALLEL_THRESHOLD)) &&
+                    (m_adjacency != NULL) && m_adjacency->isUpToDate() &&
+                    (cWorkerPool::getSharedPool()->getNumThreads() > 1);
 
-        // compute normal vector
-        cVector3d normal, v01, v02;
-        vertex1.subr(vertex0, v01);
-        vertex2.subr(vertex0, v02);
-        v01.crossr(v02, normal);
-        double length = normal.length();
-        if (length > 0.0)
+    if (!parallel)
+    {
+        // compute the normal of each triangle, add contribution to each vertex
+        for (unsigned int i=0; i<numTriangles; i++)
         {
-            normal.div(length);
-            m_vertices->m_normal[vertexIndex0].add(normal);
-            m_vertices->m_normal[vertexIndex1].add(normal);
-            m_vertices->m_normal[vertexIndex2].add(normal);
+            unsigned int vertexIndex0 = m_triangles->getVertexIndex0(i);
+            unsigned int vertexIndex1 = m_triangles->getVertexIndex1(i);
+            unsigned int vertexIndex2 = m_triangles->getVertexIndex2(i);
+
+            cVector3d vertex0 = m_vertices->getLocalPos(vertexIndex0);
+            cVector3d vertex1 = m_vertices->getLocalPos(vertexIndex1);
+            cVector3d vertex2 = m_vertices->getLocalPos(vertexIndex2);
+
+            // compute normal vector
+            cVector3d normal, v01, v02;
+            vertex1.subr(vertex0, v01);
+            vertex2.subr(vertex0, v02);
+            v01.crossr(v02, normal);
+            double length = normal.length();
+            if (length > 0.0)
+            {
+                normal.div(length);
+                normals[vertexIndex0].add(normal);
+                normals[vertexIndex1].add(normal);
+                normals[vertexIndex2].add(normal);
+            }
         }
+
+        // normalize all triangles
+        for (unsigned int i=0; i<numVertices; i++)
+        {
+            if (normals[i].length() > 0.000000001)
+            {
+                normals[i].normalize();
+            }
+            if (!normals[i].equals(m_vertices->m_normal[i]))
+            {
+                m_vertices->setNormal(i, normals[i]);
+            }
+        }
+
+        return;
     }
 
-    // normalize all triangles
+    std::vector<cVector3d> triangleNormals(numTriangles);
+    std::vector<unsigned char> modified(numVertices);
+
+    cMeshKernelJob job;
+    job.m_vertices = m_vertices.get();
+    job.m_triangles = m_triangles.get();
+    job.m_adjacency = m_adjacency;
+    job.m_triangleVectors0 = triangleNormals.empty() ? NULL : &triangleNormals[0];
+    job.m_vertexVectors = &normals[0];
+    job.m_vertexFlags = &modified[0];
+
+    // compute the normal of each triangle
+    cExecuteMeshKernel(cComputeTriangleNormals, &job, numTriangles);
+
+    // add the contribution of each triangle to its vertices. Each position
+    // gathers the normals of the triangles leaving it; every vertex belongs
+    // to a single position, so positions are processed independently of
+    // each other.
+    cExecuteMeshKernel(cGatherVertexNormals, &job, m_adjacency->getNumPositions());
+
+    // normalize all vertex normals
+    cExecuteMeshKernel(cNormalizeVertexNormals, &job, numVertices);
+
+    // update the normals which have changed
     for (unsigned int i=0; i<numVertices; i++)
     {
-        if (m_vertices->m_normal[i].length() > 0.000000001)
+        if (modified[i])
         {
-            m_vertices->m_normal[i].normalize();
+            m_vertices->setNormal(i, normals[i]);
         }
     }
 }
@@ -541,12 +881,65 @@ void cMesh::computeAllNormals()
 
 //==============================================================================
 /*!
-    This method computes the normal matrix vectors for all triangles.
+    This method computes the normal matrix vectors for all triangles. Each
+    vertex receives the tangent and bitangent vectors of the last triangle it
+    belongs to, as computed by cTriangleArray::computeBTN(). \n
+
+    For meshes of at least C_MESH_PARALLEL_THRESHOLD vertices or triangles
+    that have an up-to-date adjacency index (see createAdjacency()), the
+    vectors are computed by the shared worker pool if it has worker
+    threads. Each vertex then finds its last triangle through the index.
+    The adjacency index is never rebuilt by this method.
 */
 //==============================================================================
 void cMesh::computeBTN()
 {
-    m_triangles->computeBTN();
+    unsigned int numTriangles = m_triangles->getNumElements();
+    unsigned int numVertices = m_vertices->getNumElements();
+
+    // the kernels are slower than a single loop on one thread, so they are
+    // only used if the work can be shared with other threads
+    bool parallel = ((numTriangles >= C_MESH_PARALLEL_THRESHOLD) || (numVertices >= C_MESH_PARALLEL_THRESHOLD)) &&
+                    (m_adjacency != NULL) && m_adjacency->isUpToDate() &&
+                    (cWorkerPool::getSharedPool()->getNumThreads() > 1);
+
+    if (!parallel)
+    {
+        m_triangles->computeBTN();
+        return;
+    }
+
+    std::vector<cVector3d> tangents(numTriangles);
+    std::vector<cVector3d> bitangents(numTriangles);
+    std::vector<unsigned char> valid(numTriangles);
+    std::vector<int> lastTriangles(numVertices, -1);
+
+    cMeshKernelJob job;
+    job.m_vertices = m_vertices.get();
+    job.m_triangles = m_triangles.get();
+    job.m_adjacency = m_adjacency;
+    job.m_triangleVectors0 = tangents.empty() ? NULL : &tangents[0];
+    job.m_triangleVectors1 = bitangents.empty() ? NULL : &bitangents[0];
+    job.m_triangleFlags = valid.empty() ? NULL : &valid[0];
+    job.m_vertexTriangles = lastTriangles.empty() ? NULL : &lastTriangles[0];
+
+    // compute the vectors of each triangle
+    cExecuteMeshKernel(cComputeTriangleBTN, &job, numTriangles);
+
+    // find the last valid triangle of each vertex. Each position visits the
+    // triangles leaving it, so positions are processed independently.
+    cExecuteMeshKernel(cGatherVertexTriangles, &job, m_adjacency->getNumPositions());
+    bool flag = (std::find(valid.begin(), valid.end(), 1) != valid.end());
+
+    // compute the vectors of each vertex
+    cExecuteMeshKernel(cSetVertexBTN, &job, numVertices);
+
+    // mark for update
+    if (flag)
+    {
+        m_vertices->m_flagTangentData = true;
+        m_vertices->m_flagBitangentData = true;
+    }
 }
 
 
@@ -568,6 +961,7 @@ void cMesh::scaleXYZ(const double a_scaleX, const double a_scaleY, const double
     {
         m_vertices->m_localPos[i].mul(a_scaleX, a_scaleY, a_scaleZ);
     }
+    m_vertices->markAllPositionsModified();
 
     m_boundaryBoxMax.mul(a_scaleX, a_scaleY, a_scaleZ);
     m_boundaryBoxMin.mul(a_scaleX, a_scaleY, a_scaleZ);
@@ -579,7 +973,8 @@ void cMesh::scaleXYZ(const double a_scaleX, const double a_scaleY, const double
 
 //==============================================================================
 /*!
-    This method computes the global position of all vertices.
+    This method computes the global position of all vertices. Vertices of
+    large meshes are processed by the shared worker pool.
 
     \param  a_frameOnly  If __false__, then the global position of all vertices is computed.
 */
@@ -588,12 +983,15 @@ void cMesh::updateGlobalPositions(const bool a_frameOnly)
 {
     if (a_frameOnly) return;
 
-    int numVertices = m_vertices->getNumElements();
+    unsigned int numVertices = m_vertices->getNumElements();
+    if (numVertices == 0) return;
 
-    for (int i=0; i<numVertices; i++)
-    {
-        m_vertices->computeGlobalPosition(i, m_globalPos, m_globalRot);
-    }
+    cMeshKernelJob job;
+    job.m_vertices = m_vertices.get();
+    job.m_globalPos = m_globalPos;
+    job.m_globalRot = m_globalRot;
+
+    cExecuteMeshKernel(cComputeGlobalPositions, &job, numVertices);
 }
 
 
@@ -693,6 +1091,7 @@ void cMesh::offsetVertices(const cVector3d& a_offset,
     {
         m_vertices->m_localPos[i].add(a_offset);
     }
+    m_vertices->markAllPositionsModified();
 
     // update boundary box
     m_boundaryBoxMin+=a_offset;
@@ -725,6 +1124,7 @@ void cMesh::reverseAllNormals()
     {
         m_vertices->m_normal[i].negate();
     }
+    m_vertices->m_flagNormalData = true;
 }
 
 
@@ -747,7 +1147,8 @@ void cMesh::setNormalsProperties(const double a_length,
 //==============================================================================
 /*!
     This method compute the axis-aligned boundary box that encloses all
-    triangles in this mesh.
+    triangles in this mesh. Large meshes are split in chunks of triangles,
+    whose boxes are computed by the shared worker pool and then merged.
 */
 //==============================================================================
 void cMesh::updateBoundaryBox()
@@ -762,51 +1163,44 @@ void cMesh::updateBoundaryBox()
         return;
     }
 
-    double xMin = C_LARGE;
-    double yMin = C_LARGE;
-    double zMin = C_LARGE;
-    double xMax = -C_LARGE;
-    double yMax = -C_LARGE;
-    double zMax = -C_LARGE;
-    bool flag = false;
+    cMeshKernelJob job;
+    job.m_vertices = m_vertices.get();
+    job.m_triangles = m_triangles.get();
 
-    // loop over all my triangles
-    for(unsigned int i=0; i<numTriangles; i++)
+    // compute the bounding box of each chunk of triangles
+    std::vector<cMeshBounds> bounds;
+    if (numTriangles >= C_MESH_PARALLEL_THRESHOLD)
     {
-        if (m_triangles->m_allocated[i])
-        {
-            cVector3d tVertex0 = m_vertices->getLocalPos(m_triangles->getVertexIndex0(i));
-            xMin = cMin(tVertex0(0) , xMin);
-            yMin = cMin(tVertex0(1) , yMin);
-            zMin = cMin(tVertex0(2) , zMin);
-            xMax = cMax(tVertex0(0) , xMax);
-            yMax = cMax(tVertex0(1) , yMax);
-            zMax = cMax(tVertex0(2) , zMax);
-
-            cVector3d tVertex1 = m_vertices->getLocalPos(m_triangles->getVertexIndex1(i));
-            xMin = cMin(tVertex1(0) , xMin);
-            yMin = cMin(tVertex1(1) , yMin);
-            zMin = cMin(tVertex1(2) , zMin);
-            xMax = cMax(tVertex1(0) , xMax);
-            yMax = cMax(tVertex1(1) , yMax);
-            zMax = cMax(tVertex1(2) , zMax);
-
-            cVector3d tVertex2 = m_vertices->getLocalPos(m_triangles->getVertexIndex2(i));
-            xMin = cMin(tVertex2(0) , xMin);
-            yMin = cMin(tVertex2(1) , yMin);
-            zMin = cMin(tVertex2(2) , zMin);
-            xMax = cMax(tVertex2(0) , xMax);
-            yMax = cMax(tVertex2(1) , yMax);
-            zMax = cMax(tVertex2(2) , zMax);
+        bounds.resize(cWorkerPool::getNumChunks(numTriangles, C_MESH_CHUNK_SIZE));
+        cWorkerPool::getSharedPool()->reduce(cComputeTriangleBounds, &job, numTriangles, C_MESH_CHUNK_SIZE, &bounds[0], sizeof(cMeshBounds));
+    }
+    else
+    {
+        bounds.resize(1);
+        cComputeTriangleBounds(&job, 0, numTriangles, &bounds[0]);
+    }
 
+    // merge the bounding boxes
+    bool flag = false;
+    cVector3d boundaryBoxMin(C_LARGE, C_LARGE, C_LARGE);
+    cVector3d boundaryBoxMax(-C_LARGE, -C_LARGE, -C_LARGE);
+    for (unsigned int i=0; i<bounds.size(); i++)
+    {
+        if (!bounds[i].m_empty)
+        {
+            for (int j=0; j<3; j++)
+            {
+                boundaryBoxMin(j) = cMin(boundaryBoxMin(j), bounds[i].m_min(j));
+                boundaryBoxMax(j) = cMax(boundaryBoxMax(j), bounds[i].m_max(j));
+            }
             flag = true;
         }
     }
 
     if (flag)
     {
-        m_boundaryBoxMin.set(xMin, yMin, zMin);
-        m_boundaryBoxMax.set(xMax, yMax, zMax);
+        m_boundaryBoxMin = boundaryBoxMin;
+        m_boundaryBoxMax = boundaryBoxMax;
         m_boundaryBoxEmpty = false;
     }
     else
@@ -844,6 +1238,62 @@ void cMesh::computeAllEdges(double a_angleThresholdDeg)
     // setup angle threshold
     double angleThresholdRad = cDegToRad(a_angleThresholdDeg);
 
+    // with an adjacency index, each pair of twin half-edges is visited once
+    if (m_adjacency)
+    {
+        unsigned int numTriangles = m_triangles->getNumElements();
+
+        // rebuild the index if the triangles were modified without notifying it
+        if (!m_adjacency->isUpToDate())
+        {
+            m_adjacency->build();
+        }
+
+        // compute the normal of each triangle
+        vector<cVector3d> normals(numTriangles);
+        for (unsigned int i=0; i<numTriangles; i++)
+        {
+            if (m_triangles->getAllocated(i))
+            {
+                normals[i] = cComputeSurfaceNormal(m_vertices->getLocalPos(m_triangles->getVertexIndex0(i)),
+                                                   m_vertices->getLocalPos(m_triangles->getVertexIndex1(i)),
+                                                   m_vertices->getLocalPos(m_triangles->getVertexIndex2(i)));
+            }
+            else
+            {
+                normals[i].zero();
+            }
+        }
+
+        // an edge is stored if it lies on a boundary, or if the angle
+        // between the triangles sharing it exceeds the threshold. Degenerate
+        // triangles are ignored.
+        for (unsigned int h=0; h<3*numTriangles; h++)
+        {
+            unsigned int triangle = cMeshAdjacency::getTriangle(h);
+            if (normals[triangle].length() == 0.0)
+            {
+                continue;
+            }
+
+            int twin = m_adjacency->getTwin(h);
+            if ((twin >= 0) && (normals[cMeshAdjacency::getTriangle(twin)].length() > 0.0))
+            {
+                if ((twin > (int)(h)) ||
+                    (cAngle(normals[triangle], normals[cMeshAdjacency::getTriangle(twin)]) < angleThresholdRad))
+                {
+                    continue;
+                }
+            }
+
+            edge.m_triangle = triangle;
+            edge.set(this, m_adjacency->getOrigin(h), m_adjacency->getDestination(h));
+            m_edges.push_back(edge);
+        }
+
+        return;
+    }
+
     // process all triangles
     for (int i=0; i<numtriangles; i++)
     {
@@ -972,6 +1422,41 @@ void cMesh::clearAllEdges()
 }
 
 
+//==============================================================================
+/*!
+    This method builds an adjacency index for this mesh. The index connects
+    triangles sharing edges, and is kept up to date by newTriangle() and
+    removeTriangle(). Once created, it is also used by computeAllEdges(). \n
+
+    Calling this method again rebuilds the index, which is required after
+    modifying the triangle array directly.
+*/
+//==============================================================================
+void cMesh::createAdjacency()
+{
+    // the arrays of the mesh may have been replaced since the last call
+    deleteAdjacency();
+
+    m_adjacency = new cMeshAdjacency(m_vertices, m_triangles);
+    m_adjacency->build();
+}
+
+
+//==============================================================================
+/*!
+    This method deletes the adjacency index of this mesh.
+*/
+//==============================================================================
+void cMesh::deleteAdjacency()
+{
+    if (m_adjacency)
+    {
+        delete m_adjacency;
+        m_adjacency = NULL;
+    }
+}
+
+
 //==============================================================================
 /*!
     This method sets the graphic properties for edge-rendering.
@@ -1011,10 +1496,12 @@ void cMesh::createBruteForceCollisionDetector()
 /*!
     This method builds an AABB collision detector for this mesh.
 
-    \param  a_radius  Bounding radius.
+    \param  a_radius       Bounding radius.
+    \param  a_buildMethod  Method used to build the collision tree.
 */
 //==============================================================================
-void cMesh::createAABBCollisionDetector(const double a_radius)
+void cMesh::createAABBCollisionDetector(const double a_radius,
+                                        const cAABBBuildMethod a_buildMethod)
 {
     // delete previous collision detector
     if (m_collisionDetector != NULL)
@@ -1025,7 +1512,7 @@ void cMesh::createAABBCollisionDetector(const double a_radius)
 
     // create AABB and initialize collision detector 
     cCollisionAABB* collisionDetector = new cCollisionAABB();
-    collisionDetector->initialize(m_triangles, a_radius);
+    collisionDetector->initialize(m_triangles, a_radius, a_buildMethod);
 
     // assign new collision detector
     m_collisionDetector = collisionDetector;
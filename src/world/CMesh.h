@@ -52,9 +52,11 @@
 #define CMeshH
 //------------------------------------------------------------------------------
 #include "world/CGenericObject.h"
+#include "collisions/CCollisionAABBTree.h"
 #include "materials/CMaterial.h"
 #include "materials/CTexture2d.h"
 #include "graphics/CColor.h"
+#include "graphics/CMeshAdjacency.h"
 //------------------------------------------------------------------------------
 #include <vector>
 #include <list>
@@ -91,6 +93,11 @@ struct cEdge;
 
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+//! Minimum number of vertices or triangles from which cMesh processes vertex data on the shared worker pool.
+const unsigned int C_MESH_PARALLEL_THRESHOLD = 16384;
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     \class      cMesh
@@ -253,6 +260,22 @@ public:
     void setEdgeLineWidth(const double a_width) { setEdgeProperties(a_width, m_edgeLineColor); }
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - ADJACENCY
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method builds an adjacency index for this mesh, which newTriangle() and removeTriangle() keep up to date.
+    void createAdjacency();
+
+    //! This method deletes the adjacency index of this mesh.
+    void deleteAdjacency();
+
+    //! This method returns the adjacency index of this mesh, or __NULL__ if none has been created.
+    cMeshAdjacency* getAdjacency() const { return (m_adjacency); }
+
+
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - SURFACE NORMALS, TANGENTS, BITANGENTS
     //--------------------------------------------------------------------------
@@ -297,7 +320,8 @@ public:
     virtual void createBruteForceCollisionDetector();
 
     //! This method builds an AABB collision detector for this mesh.
-    virtual void createAABBCollisionDetector(const double a_radius);
+    virtual void createAABBCollisionDetector(const double a_radius,
+                                             const cAABBBuildMethod a_buildMethod = C_AABB_BUILD_CENTER);
 
 
     //--------------------------------------------------------------------------
@@ -388,6 +412,16 @@ protected:
     cDisplayList m_displayListEdges;
 
 
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - ADJACENCY:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Adjacency index of this mesh, or __NULL__ if none has been created.
+    cMeshAdjacency* m_adjacency;
+
+
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS - DISPLAY PROPERTIES:
     //--------------------------------------------------------------------------
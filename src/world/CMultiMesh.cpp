@@ -48,6 +48,7 @@
 #include "collisions/CCollisionBrute.h"
 #include "collisions/CCollisionAABB.h"
 #include "files/CFileModel3DS.h"
+#include "files/CFileModelCMESH.h"
 #include "files/CFileModelOBJ.h"
 #include "files/CFileModelSTL.h"
 #include "math/CMaths.h"
@@ -72,6 +73,9 @@ cMultiMesh::cMultiMesh()
 {
     // create array of mesh primitives
     m_meshes = new vector<cMesh*>;
+
+    // no cache file
+    m_cacheChecksum = 0;
 }
 
 
@@ -82,6 +86,9 @@ cMultiMesh::cMultiMesh()
 //==============================================================================
 cMultiMesh::~cMultiMesh()
 {
+    // delete collision trees restored from a CMESH file
+    deleteCacheCollisionTrees();
+
     // delete all meshes
     deleteAllMeshes();
 
@@ -965,6 +972,45 @@ bool cMultiMesh::computeCollisionDetection(const cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method computes a box, expressed in the local coordinates of this
+    object, that encloses all collisions that may be reported by this object,
+    its meshes, and its children.
+
+    \param  a_boxMin  Returned minimum point of the box.
+    \param  a_boxMax  Returned maximum point of the box.
+    \param  a_moving  Set to __true__ if this object, a mesh, or a child is moving.
+
+    \return __true__ if the box encloses all collisions, __false__ otherwise.
+*/
+//==============================================================================
+bool cMultiMesh::computeCollisionBoundaryBox(cVector3d& a_boxMin,
+                                             cVector3d& a_boxMax,
+                                             bool& a_moving)
+{
+    // compute box of this object and its children
+    if (!cGenericObject::computeCollisionBoundaryBox(a_boxMin, a_boxMax, a_moving))
+    {
+        return (false);
+    }
+
+    // ghost objects never report collisions
+    if (m_ghostEnabled) { return (true); }
+
+    // enclose meshes
+    for (unsigned int i=0; i<m_meshes->size(); i++)
+    {
+        if (!encloseCollisionBoundaryBox(m_meshes->at(i), a_boxMin, a_boxMax, a_moving))
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
 //==============================================================================
 /*!
     This method enables or disables graphic representation of the collision 
@@ -1540,7 +1586,16 @@ void cMultiMesh::convertToSingleMesh(cMesh* a_mesh)
 //==============================================================================
 /*!
     This method loads a 3D mesh file. \n
-    CHAI3D currently supports .obj, .3ds, and .stl files.
+    CHAI3D currently supports .obj, .3ds, .stl, and .cmesh files. \n
+
+    If __g_meshLoaderUseCache__ is set, models are restored from the CMESH
+    file created by a previous load if the model file is unchanged, and a
+    CMESH file is created otherwise (see \ref cLoadFileCMESH()). \n
+
+    Collision trees stored in a CMESH file are not attached to the meshes
+    by this method, so that models restored from a CMESH file behave as
+    models loaded from their source file: they are attached by
+    createAABBCollisionDetector() if the model has not been modified.
 
     \param  a_filename  Filename of 3D model.
 
@@ -1564,6 +1619,25 @@ bool cMultiMesh::loadFromFile(string a_filename)
     // result for loading file
     bool result = false;
 
+    // discard collision trees restored by a previous load
+    deleteCacheCollisionTrees();
+
+    // restore model from its cache file if it is up to date
+    m_cacheFilename = "";
+    string cacheFilename = "";
+    if (g_meshLoaderUseCache && (fileType != "cmesh"))
+    {
+        cacheFilename = cGetCacheFilenameCMESH(a_filename);
+        if (cLoadFileCMESH(this, cacheFilename, a_filename))
+        {
+            m_cacheFilename = cacheFilename;
+            m_cacheSourceFilename = a_filename;
+            m_cacheChecksum = cComputeChecksumCMESH(this);
+            detachCacheCollisionTrees();
+            return (C_SUCCESS);
+        }
+    }
+
     //--------------------------------------------------------------------
     // .3DS FORMAT
     //--------------------------------------------------------------------
@@ -1588,6 +1662,30 @@ bool cMultiMesh::loadFromFile(string a_filename)
         result = cLoadFileSTL(this, a_filename);
     }
 
+    //--------------------------------------------------------------------
+    // .CMESH FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "cmesh")
+    {
+        result = cLoadFileCMESH(this, a_filename);
+        if (result)
+        {
+            m_cacheChecksum = cComputeChecksumCMESH(this);
+            detachCacheCollisionTrees();
+        }
+    }
+
+    // create cache file
+    if (result && (cacheFilename.length() > 0))
+    {
+        if (cSaveFileCMESH(this, cacheFilename, a_filename))
+        {
+            m_cacheFilename = cacheFilename;
+            m_cacheSourceFilename = a_filename;
+            m_cacheChecksum = cComputeChecksumCMESH(this);
+        }
+    }
+
     return (result);
 }
 
@@ -1595,7 +1693,7 @@ bool cMultiMesh::loadFromFile(string a_filename)
 //==============================================================================
 /*!
     This method saves a mesh object to file. \n
-    CHAI3D currently supports .obj, .3ds, and .stl files.
+    CHAI3D currently supports .obj, .3ds, .stl, and .cmesh files.
 
     \param  a_filename  Filename of 3D model.
 
@@ -1643,6 +1741,14 @@ bool cMultiMesh::saveToFile(std::string a_filename)
         result = cSaveFileSTL(this, a_filename);
     }
 
+    //--------------------------------------------------------------------
+    // .CMESH FORMAT
+    //--------------------------------------------------------------------
+    else if (fileType == "cmesh")
+    {
+        result = cSaveFileCMESH(this, a_filename);
+    }
+
     return (result);
 }
 
@@ -1925,18 +2031,114 @@ void cMultiMesh::createBruteForceCollisionDetector()
 
 //==============================================================================
 /*!
-    This method builds an AABB collision detector for this mesh.
+    This method builds an AABB collision detector for this mesh. \n
+
+    If the model has been loaded from a CMESH file, or restored from a cache
+    file (see __g_meshLoaderUseCache__), and has not been modified since it
+    was loaded, the collision trees stored in the file are attached to the
+    meshes if they were built with the same radius and method. Otherwise
+    the trees are built, and added to the cache file if the model is
+    unchanged.
 
-    \param  a_radius  Bounding radius.
+    \param  a_radius       Bounding radius.
+    \param  a_buildMethod  Method used to build the collision tree.
 */
 //==============================================================================
-void cMultiMesh::createAABBCollisionDetector(const double a_radius)
+void cMultiMesh::createAABBCollisionDetector(const double a_radius,
+                                             const cAABBBuildMethod a_buildMethod)
 {
     vector<cMesh*>::iterator it;
+
+    // check if the model is unchanged since it was loaded from a CMESH file
+    bool unchanged = ((m_cacheFilename.length() > 0) || (m_cacheCollisionTrees.size() > 0)) &&
+                     (cComputeChecksumCMESH(this) == m_cacheChecksum);
+    bool cached = unchanged && (m_cacheFilename.length() > 0);
+
+    // attach collision trees restored from the CMESH file
+    if (unchanged && (m_cacheCollisionTrees.size() == m_meshes->size()))
+    {
+        bool restored = true;
+        for (unsigned int i=0; i<m_cacheCollisionTrees.size(); i++)
+        {
+            cCollisionAABB* tree = dynamic_cast<cCollisionAABB*>(m_cacheCollisionTrees[i]);
+            if ((tree == NULL) || (tree->getRadius() != a_radius) || (tree->getBuildMethod() != a_buildMethod))
+            {
+                restored = false;
+            }
+        }
+
+        if (restored)
+        {
+            for (unsigned int i=0; i<m_cacheCollisionTrees.size(); i++)
+            {
+                cMesh* mesh = (*m_meshes)[i];
+                mesh->deleteCollisionDetector();
+                mesh->setCollisionDetector(m_cacheCollisionTrees[i]);
+            }
+            m_cacheCollisionTrees.clear();
+            return;
+        }
+    }
+
+    // restored collision trees cannot be used
+    deleteCacheCollisionTrees();
+
+    // build collision trees
     for (it = m_meshes->begin(); it < m_meshes->end(); it++)
     {
-        (*it)->createAABBCollisionDetector(a_radius);
+        (*it)->createAABBCollisionDetector(a_radius, a_buildMethod);
+    }
+
+    // store collision trees in the cache file
+    if (cached)
+    {
+        cSaveFileCMESH(this, m_cacheFilename, m_cacheSourceFilename);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method detaches the collision detectors of the meshes that have just
+    been loaded from a CMESH file, and keeps them until
+    createAABBCollisionDetector() is called. If the model is modified before,
+    they are deleted instead of being attached.
+*/
+//==============================================================================
+void cMultiMesh::detachCacheCollisionTrees()
+{
+    deleteCacheCollisionTrees();
+
+    bool found = false;
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        cGenericCollision* tree = (*it)->getCollisionDetector();
+        (*it)->setCollisionDetector(NULL);
+        m_cacheCollisionTrees.push_back(tree);
+        found = found || (tree != NULL);
+    }
+
+    if (!found)
+    {
+        m_cacheCollisionTrees.clear();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method deletes the collision trees restored from a CMESH file that
+    have not been attached by createAABBCollisionDetector().
+*/
+//==============================================================================
+void cMultiMesh::deleteCacheCollisionTrees()
+{
+    for (unsigned int i=0; i<m_cacheCollisionTrees.size(); i++)
+    {
+        delete m_cacheCollisionTrees[i];
     }
+    m_cacheCollisionTrees.clear();
 }
 
 
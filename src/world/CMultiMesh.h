@@ -239,6 +239,11 @@ public:
                                            cCollisionRecorder& a_recorder,
                                            cCollisionSettings& a_settings);
 
+    //! This method computes a box, in local coordinates, enclosing all collisions that may be reported by this object, its meshes, and its children.
+    virtual bool computeCollisionBoundaryBox(cVector3d& a_boxMin,
+                                             cVector3d& a_boxMax,
+                                             bool& a_moving);
+
     //! This method enables or disables the display of the collision detector, optionally propagating the change to its children.
     virtual void setShowCollisionDetector(const bool a_showCollisionDetector, 
                                           const bool a_affectChildren = false);
@@ -252,7 +257,8 @@ public:
     virtual void createBruteForceCollisionDetector();
 
     //! Set up an AABB collision detector for this mesh.
-    virtual void createAABBCollisionDetector(const double a_radius);
+    virtual void createAABBCollisionDetector(const double a_radius,
+                                             const cAABBBuildMethod a_buildMethod = C_AABB_BUILD_CENTER);
 
 
     //-----------------------------------------------------------------------
@@ -442,6 +448,12 @@ protected:
         const bool a_duplicateMeshData,
         const bool a_buildCollisionDetector);
 
+    //! This method detaches the collision trees restored from a CMESH file, until they are attached by createAABBCollisionDetector().
+    void detachCacheCollisionTrees();
+
+    //! This method deletes the collision trees restored from a CMESH file that have not been attached.
+    void deleteCacheCollisionTrees();
+
 
     //-----------------------------------------------------------------------
     // PUBLIC MEMBERS
@@ -452,6 +464,24 @@ public:
     //! Array of meshes.
     std::vector<cMesh*> *m_meshes;
 
+
+    //-----------------------------------------------------------------------
+    // PROTECTED MEMBERS
+    //-----------------------------------------------------------------------
+
+protected:
+
+    //! Name of the CMESH file caching the model loaded by this multi-mesh, or empty if the model is not cached.
+    std::string m_cacheFilename;
+
+    //! Name of the model file cached in \ref m_cacheFilename.
+    std::string m_cacheSourceFilename;
+
+    //! Checksum of the vertices and triangles of the model when it was loaded from, or saved to, a CMESH file.
+    unsigned long long m_cacheChecksum;
+
+    //! Collision trees restored from a CMESH file for each mesh, kept until createAABBCollisionDetector() is called.
+    std::vector<cGenericCollision*> m_cacheCollisionTrees;
 };
 
 //------------------------------------------------------------------------------
@@ -394,6 +394,7 @@ void cMultiPoint::scaleXYZ(const double a_scaleX, const double a_scaleY, const d
     {
         m_vertices->m_localPos[i].mul(a_scaleX, a_scaleY, a_scaleZ);
     }
+    m_vertices->markAllPositionsModified();
 
     m_boundaryBoxMax.mul(a_scaleX, a_scaleY, a_scaleZ);
     m_boundaryBoxMin.mul(a_scaleX, a_scaleY, a_scaleZ);
@@ -509,6 +510,7 @@ void cMultiPoint::offsetVertices(const cVector3d& a_offset,
     {
         m_vertices->m_localPos[i].add(a_offset);
     }
+    m_vertices->markAllPositionsModified();
 
     // update boundary box
     m_boundaryBoxMin+=a_offset;
@@ -603,10 +605,12 @@ void cMultiPoint::createBruteForceCollisionDetector()
 /*!
     This method builds an AABB collision detector for this point cloud.
 
-    \param  a_radius  Bounding radius.
+    \param  a_radius       Bounding radius.
+    \param  a_buildMethod  Method used to build the collision tree.
 */
 //==============================================================================
-void cMultiPoint::createAABBCollisionDetector(const double a_radius)
+void cMultiPoint::createAABBCollisionDetector(const double a_radius,
+                                              const cAABBBuildMethod a_buildMethod)
 {
     // delete previous collision detector
     if (m_collisionDetector != NULL)
@@ -617,7 +621,7 @@ void cMultiPoint::createAABBCollisionDetector(const double a_radius)
 
     // create AABB collision detector
     cCollisionAABB* collisionDetector = new cCollisionAABB();
-    collisionDetector->initialize(m_points, a_radius);
+    collisionDetector->initialize(m_points, a_radius, a_buildMethod);
 
     // assign new collision detector
     m_collisionDetector = collisionDetector;
@@ -46,6 +46,7 @@
 #define CMultiPointH
 //------------------------------------------------------------------------------
 #include "world/CGenericObject.h"
+#include "collisions/CCollisionAABBTree.h"
 #include "materials/CMaterial.h"
 #include "materials/CTexture2d.h"
 #include "graphics/CColor.h"
@@ -212,7 +213,8 @@ public:
     virtual void createBruteForceCollisionDetector();
 
     //! This method builds an AABB collision detector for this mesh.
-    virtual void createAABBCollisionDetector(const double a_radius);
+    virtual void createAABBCollisionDetector(const double a_radius,
+                                             const cAABBBuildMethod a_buildMethod = C_AABB_BUILD_CENTER);
 
 
     //--------------------------------------------------------------------------
@@ -408,6 +408,7 @@ void cMultiSegment::scaleXYZ(const double a_scaleX, const double a_scaleY, const
     {
         m_vertices->m_localPos[i].mul(a_scaleX, a_scaleY, a_scaleZ);
     }
+    m_vertices->markAllPositionsModified();
 
     m_boundaryBoxMax.mul(a_scaleX, a_scaleY, a_scaleZ);
     m_boundaryBoxMin.mul(a_scaleX, a_scaleY, a_scaleZ);
@@ -523,6 +524,7 @@ void cMultiSegment::offsetVertices(const cVector3d& a_offset,
     {
         m_vertices->m_localPos[i].add(a_offset);
     }
+    m_vertices->markAllPositionsModified();
 
     // update boundary box
     m_boundaryBoxMin+=a_offset;
@@ -627,10 +629,12 @@ void cMultiSegment::createBruteForceCollisionDetector()
     This method builds an AABB collision detector for this multi-segment 
     object.
 
-    \param  a_radius  Bounding radius.
+    \param  a_radius       Bounding radius.
+    \param  a_buildMethod  Method used to build the collision tree.
 */
 //==============================================================================
-void cMultiSegment::createAABBCollisionDetector(const double a_radius)
+void cMultiSegment::createAABBCollisionDetector(const double a_radius,
+                                                const cAABBBuildMethod a_buildMethod)
 {
     // delete previous collision detector
     if (m_collisionDetector != NULL)
@@ -641,7 +645,7 @@ void cMultiSegment::createAABBCollisionDetector(const double a_radius)
 
     // create AABB collision detector
     cCollisionAABB* collisionDetector = new cCollisionAABB();
-    collisionDetector->initialize(m_segments, a_radius);
+    collisionDetector->initialize(m_segments, a_radius, a_buildMethod);
 
     // assign new collision detector
     m_collisionDetector = collisionDetector;
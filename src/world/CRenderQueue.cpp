@@ -0,0 +1,382 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "world/CRenderQueue.h"
+//------------------------------------------------------------------------------
+#include "world/CGenericObject.h"
+#include "shaders/CShaderProgram.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// orders objects by shader program, texture and material, then by scene graph order
+struct cRenderQueueStateOrder
+{
+    const std::vector<cRenderQueueItem>* m_items;
+
+    bool operator()(const unsigned int a_index0, const unsigned int a_index1) const
+    {
+        const cRenderQueueItem& item0 = (*m_items)[a_index0];
+        const cRenderQueueItem& item1 = (*m_items)[a_index1];
+        if (item0.m_shaderKey != item1.m_shaderKey) { return (item0.m_shaderKey < item1.m_shaderKey); }
+        if (item0.m_textureKey != item1.m_textureKey) { return (item0.m_textureKey < item1.m_textureKey); }
+        if (item0.m_materialKey != item1.m_materialKey) { return (item0.m_materialKey < item1.m_materialKey); }
+        return (a_index0 < a_index1);
+    }
+};
+
+// orders objects from back to front, then by scene graph order
+struct cRenderQueueDepthOrder
+{
+    const std::vector<cRenderQueueItem>* m_items;
+
+    bool operator()(const unsigned int a_index0, const unsigned int a_index1) const
+    {
+        const cRenderQueueItem& item0 = (*m_items)[a_index0];
+        const cRenderQueueItem& item1 = (*m_items)[a_index1];
+        if (item0.m_depth != item1.m_depth) { return (item0.m_depth > item1.m_depth); }
+        return (a_index0 < a_index1);
+    }
+};
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cRenderQueue.
+*/
+//==============================================================================
+cRenderQueue::cRenderQueue()
+{
+    m_root = NULL;
+    m_numCulledObjects = 0;
+    m_numStateChangesUnsorted = 0;
+    m_numStateChanges = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method removes all objects from the queue.
+*/
+//==============================================================================
+void cRenderQueue::clear()
+{
+    m_items.clear();
+    m_opaqueOrder.clear();
+    m_transparentOrder.clear();
+    m_singlePassOrder.clear();
+    for (int i=0; i<3; i++)
+    {
+        m_keys[i].clear();
+    }
+    m_root = NULL;
+    m_numCulledObjects = 0;
+    m_numStateChangesUnsorted = 0;
+    m_numStateChanges = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method clears the queue, then traverses the scene graph starting at
+    object \p a_root and collects every enabled object located inside the
+    clipping volume. Object positions are stored if requested by the 
+    rendering options, so that the queue may be built in place of the first
+    rendering pass of a frame.
+
+    \param  a_root     Root of the scene graph.
+    \param  a_options  Rendering options of the first rendering pass.
+*/
+//==============================================================================
+void cRenderQueue::build(cGenericObject* a_root, const cRenderOptions& a_options)
+{
+    clear();
+    if (a_root == NULL) { return; }
+
+    // traverse the scene graph
+    cRenderOptions options = a_options;
+    options.m_numDrawnObjects = 0;
+    options.m_numCulledObjects = 0;
+
+    cTransform identity;
+    identity.identity();
+    a_root->buildRenderQueue(this, options, identity);
+
+    // the root sets up the world and is always rendered first
+    m_root = a_root;
+    m_numCulledObjects = options.m_numCulledObjects;
+}
+
+
+//==============================================================================
+/*!
+    This method adds an object to the queue.
+
+    \param  a_object  Object to be rendered.
+    \param  a_matrix  Transformation of the object, relative to the root of the traversal.
+*/
+//==============================================================================
+void cRenderQueue::addObject(cGenericObject* a_object, const cTransform& a_matrix)
+{
+    cRenderQueueItem item;
+    item.m_object = a_object;
+    item.m_matrix = a_matrix;
+    item.m_shaderKey = getKey(0, a_object->m_shaderProgram.get());
+    item.m_textureKey = getKey(1, a_object->m_texture.get());
+    item.m_materialKey = getKey(2, a_object->m_material.get());
+    item.m_depth = 0.0;
+    item.m_transparent = a_object->m_useTransparency;
+
+    if (a_object->m_boundaryBoxEmpty)
+    {
+        item.m_center.zero();
+    }
+    else
+    {
+        item.m_center = 0.5 * (a_object->m_boundaryBoxMin + a_object->m_boundaryBoxMax);
+    }
+
+    m_items.push_back(item);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the sort key of a shader program, texture or material.
+    Keys are numbered in order of first appearance, so that the order of the
+    queue does not depend on memory addresses.
+
+    \param  a_type   0 for shader programs, 1 for textures, 2 for materials.
+    \param  a_state  Shader program, texture or material. May be __NULL__.
+
+    \return Sort key.
+*/
+//==============================================================================
+unsigned int cRenderQueue::getKey(const int a_type, const void* a_state)
+{
+    std::map<const void*, unsigned int>& keys = m_keys[a_type];
+    std::map<const void*, unsigned int>::iterator it = keys.find(a_state);
+    if (it != keys.end())
+    {
+        return (it->second);
+    }
+
+    unsigned int key = (unsigned int)(keys.size());
+    keys[a_state] = key;
+    return (key);
+}
+
+
+//==============================================================================
+/*!
+    This method sorts the objects of the queue for each kind of rendering 
+    pass. Opaque passes group objects sharing the same shader program, texture
+    and material. Transparent passes order objects from back to front, using
+    the distance from the camera to the center of each object.
+
+    \param  a_viewMatrix  View matrix of the camera.
+*/
+//==============================================================================
+void cRenderQueue::sort(const cTransform& a_viewMatrix)
+{
+    unsigned int numItems = (unsigned int)(m_items.size());
+
+    // compute depth of each object
+    for (unsigned int i=0; i<numItems; i++)
+    {
+        cVector3d center, eye;
+        m_items[i].m_matrix.mulr(m_items[i].m_center, center);
+        a_viewMatrix.mulr(center, eye);
+        m_items[i].m_depth = -eye(2);
+    }
+
+    // the root is never reordered
+    unsigned int first = ((numItems > 0) && (m_items[0].m_object == m_root)) ? 1 : 0;
+
+    m_opaqueOrder.resize(numItems);
+    m_transparentOrder.resize(numItems);
+    for (unsigned int i=0; i<numItems; i++)
+    {
+        m_opaqueOrder[i] = i;
+        m_transparentOrder[i] = i;
+    }
+
+    m_numStateChangesUnsorted = countStateChanges(m_opaqueOrder);
+
+    cRenderQueueStateOrder stateOrder;
+    stateOrder.m_items = &m_items;
+    std::sort(m_opaqueOrder.begin() + first, m_opaqueOrder.end(), stateOrder);
+
+    cRenderQueueDepthOrder depthOrder;
+    depthOrder.m_items = &m_items;
+    std::sort(m_transparentOrder.begin() + first, m_transparentOrder.end(), depthOrder);
+
+    m_numStateChanges = countStateChanges(m_opaqueOrder);
+
+    // single passes render opaque objects first, then transparent objects
+    m_singlePassOrder.clear();
+    m_singlePassOrder.reserve(numItems);
+    for (unsigned int i=0; i<first; i++)
+    {
+        m_singlePassOrder.push_back(i);
+    }
+    for (unsigned int i=first; i<numItems; i++)
+    {
+        if (!m_items[m_opaqueOrder[i]].m_transparent)
+        {
+            m_singlePassOrder.push_back(m_opaqueOrder[i]);
+        }
+    }
+    for (unsigned int i=first; i<numItems; i++)
+    {
+        if (m_items[m_transparentOrder[i]].m_transparent)
+        {
+            m_singlePassOrder.push_back(m_transparentOrder[i]);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method executes a rendering pass from the queue. Each object is
+    rendered with its stored transformation, as it would be by 
+    cGenericObject::renderSceneGraph(), but without visiting the scene graph.
+
+    \param  a_options  Rendering options of the pass.
+*/
+//==============================================================================
+void cRenderQueue::render(cRenderOptions& a_options)
+{
+#ifdef C_USE_OPENGL
+
+    // select order of the pass
+    const std::vector<unsigned int>* order;
+    if (a_options.m_creating_shadow_map)
+    {
+        order = &m_opaqueOrder;
+    }
+    else if (a_options.m_single_pass_only)
+    {
+        order = &m_singlePassOrder;
+    }
+    else if (a_options.m_render_opaque_objects_only)
+    {
+        order = &m_opaqueOrder;
+    }
+    else
+    {
+        order = &m_transparentOrder;
+    }
+
+    // render objects
+    cTransform frustumMatrix = a_options.m_frustumMatrix;
+    unsigned int numItems = (unsigned int)(order->size());
+    for (unsigned int i=0; i<numItems; i++)
+    {
+        cRenderQueueItem& item = m_items[(*order)[i]];
+
+        // objects rendered by this object are culled in its coordinates
+        if (a_options.m_frustumCulling)
+        {
+            frustumMatrix.mulr(item.m_matrix, a_options.m_frustumMatrix);
+        }
+
+        glPushMatrix();
+        glMultMatrixd( (const double *)item.m_matrix.getData() );
+
+        item.m_object->renderObject(a_options);
+
+        glPopMatrix();
+    }
+    a_options.m_frustumMatrix = frustumMatrix;
+
+    // update counters
+    a_options.m_numDrawnObjects += numItems;
+    a_options.m_numCulledObjects += m_numCulledObjects;
+
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of times the shader program, texture or
+    material changes between consecutive objects of a rendering order.
+
+    \param  a_order  Rendering order.
+
+    \return Number of state changes.
+*/
+//==============================================================================
+unsigned int cRenderQueue::countStateChanges(const std::vector<unsigned int>& a_order) const
+{
+    unsigned int numChanges = 0;
+    for (unsigned int i=1; i<a_order.size(); i++)
+    {
+        const cRenderQueueItem& item0 = m_items[a_order[i-1]];
+        const cRenderQueueItem& item1 = m_items[a_order[i]];
+        if (item0.m_shaderKey != item1.m_shaderKey) { numChanges++; }
+        if (item0.m_textureKey != item1.m_textureKey) { numChanges++; }
+        if (item0.m_materialKey != item1.m_materialKey) { numChanges++; }
+    }
+
+    return (numChanges);
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,249 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CRenderQueueH
+#define CRenderQueueH
+//------------------------------------------------------------------------------
+#include "graphics/CRenderOptions.h"
+#include "math/CTransform.h"
+//------------------------------------------------------------------------------
+#include <map>
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CRenderQueue.h
+    \ingroup    world
+
+    \brief
+    Implements a render queue that executes several rendering passes from a
+    single traversal of the scene graph.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cGenericObject;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \struct     cRenderQueueItem
+    \ingroup    world
+
+    \brief
+    This structure stores an object collected in a render queue.
+*/
+//==============================================================================
+struct cRenderQueueItem
+{
+    //! Object to be rendered.
+    cGenericObject* m_object;
+
+    //! Transformation of the object, relative to the root of the traversal.
+    cTransform m_matrix;
+
+    //! Center of the object, in local coordinates.
+    cVector3d m_center;
+
+    //! Sort key of the shader program of the object.
+    unsigned int m_shaderKey;
+
+    //! Sort key of the texture of the object.
+    unsigned int m_textureKey;
+
+    //! Sort key of the material of the object.
+    unsigned int m_materialKey;
+
+    //! Distance from the camera to the center of the object.
+    double m_depth;
+
+    //! If __true__, then the object uses transparency.
+    bool m_transparent;
+};
+
+
+//==============================================================================
+/*!
+    \class      cRenderQueue
+    \ingroup    world
+
+    \brief
+    This class implements a render queue that executes several rendering
+    passes from a single traversal of the scene graph.
+
+    \details
+    Rendering a world with multipass transparency or shadows traverses the
+    scene graph once per pass. A render queue instead traverses the scene 
+    graph once with build(), which stores object positions and performs 
+    frustum culling exactly as cGenericObject::renderSceneGraph() would, and
+    collects every object to be rendered with its transformation. \n
+
+    sort() then orders the objects for each kind of pass. Opaque passes and
+    shadow maps render the objects grouped by shader program, texture and
+    material, to minimize state changes between consecutive objects.
+    Transparent passes render all objects from back to front. Single passes 
+    render opaque objects first, grouped by state, followed by transparent 
+    objects from back to front. The root of the traversal is always rendered
+    first, since it sets up the light sources of the world. \n
+
+    render() finally executes a rendering pass from the queue, and may be 
+    called any number of times per frame with different rendering options.
+    The modelview matrix must contain the view transformation when render() 
+    is called, as it would be when rendering the scene graph directly. \n
+
+    Since opaque objects are not rendered in scene graph order, objects 
+    whose appearance depends on that order, such as overlays drawn without
+    depth testing or objects that leave OpenGL state modified for the next
+    object, may render differently. For this reason, cCamera only uses a 
+    render queue when enabled with cCamera::setUseRenderQueue().
+*/
+//==============================================================================
+class cRenderQueue
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cRenderQueue.
+    cRenderQueue();
+
+    //! Destructor of cRenderQueue.
+    virtual ~cRenderQueue() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method removes all objects from the queue.
+    void clear();
+
+    //! This method traverses a scene graph and collects the objects to be rendered.
+    void build(cGenericObject* a_root, const cRenderOptions& a_options);
+
+    //! This method adds an object to the queue.
+    void addObject(cGenericObject* a_object, const cTransform& a_matrix);
+
+    //! This method sorts the objects of the queue for each kind of rendering pass.
+    void sort(const cTransform& a_viewMatrix);
+
+    //! This method executes a rendering pass from the queue.
+    void render(cRenderOptions& a_options);
+
+    //! This method returns the number of objects in the queue.
+    unsigned int getNumObjects() const { return ((unsigned int)(m_items.size())); }
+
+    //! This method returns the number of objects skipped by frustum culling when the queue was built.
+    unsigned int getNumCulledObjects() const { return (m_numCulledObjects); }
+
+    //! This method returns the number of state changes between consecutive objects of opaque passes, in scene graph order.
+    unsigned int getNumStateChangesUnsorted() const { return (m_numStateChangesUnsorted); }
+
+    //! This method returns the number of state changes between consecutive objects of opaque passes, once sorted.
+    unsigned int getNumStateChanges() const { return (m_numStateChanges); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns the sort key of a shader program, texture or material.
+    unsigned int getKey(const int a_type, const void* a_state);
+
+    //! This method returns the number of state changes between consecutive objects of a rendering order.
+    unsigned int countStateChanges(const std::vector<unsigned int>& a_order) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Objects of the queue, in scene graph order.
+    std::vector<cRenderQueueItem> m_items;
+
+    //! Rendering order of opaque passes and shadow maps.
+    std::vector<unsigned int> m_opaqueOrder;
+
+    //! Rendering order of transparent passes.
+    std::vector<unsigned int> m_transparentOrder;
+
+    //! Rendering order of single passes.
+    std::vector<unsigned int> m_singlePassOrder;
+
+    //! Sort keys of the shader programs, textures and materials, numbered in order of appearance.
+    std::map<const void*, unsigned int> m_keys[3];
+
+    //! Root of the last traversal, always rendered first.
+    cGenericObject* m_root;
+
+    //! Number of objects skipped by frustum culling when the queue was built.
+    unsigned int m_numCulledObjects;
+
+    //! Number of state changes of opaque passes, in scene graph order.
+    unsigned int m_numStateChangesUnsorted;
+
+    //! Number of state changes of opaque passes, once sorted.
+    unsigned int m_numStateChanges;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
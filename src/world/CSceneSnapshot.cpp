@@ -0,0 +1,198 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "world/CSceneSnapshot.h"
+//------------------------------------------------------------------------------
+#include "world/CGenericObject.h"
+#include "tools/CGenericTool.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cSceneSnapshot.
+*/
+//==============================================================================
+cSceneSnapshot::cSceneSnapshot()
+{
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cSceneSnapshot. Registered objects are detached from the
+    snapshot and return to rendering their current local transformation.
+*/
+//==============================================================================
+cSceneSnapshot::~cSceneSnapshot()
+{
+    std::vector<cGenericObject*>::iterator it;
+    for (it = m_objects.begin(); it != m_objects.end(); ++it)
+    {
+        if ((*it) != NULL)
+        {
+            (*it)->m_snapshot = NULL;
+            (*it)->m_snapshotIndex = -1;
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method registers an object with the snapshot. The current local
+    transformation of the object is copied into all buffers, so that the
+    object is rendered at its current pose until the first call to publish().
+    This method must not be called while the haptic or graphic threads are
+    accessing the snapshot.
+
+    \param  a_object  Object to register.
+
+    \return __true__ if the object was registered, __false__ if it is already
+            registered with a snapshot.
+*/
+//==============================================================================
+bool cSceneSnapshot::addObject(cGenericObject* a_object)
+{
+    // sanity check
+    if ((a_object == NULL) || (a_object->m_snapshot != NULL))
+    {
+        return (false);
+    }
+
+    // register object
+    a_object->m_snapshot = this;
+    a_object->m_snapshotIndex = (int)(m_objects.size());
+    m_objects.push_back(a_object);
+
+    // initialize buffers
+    cTransform transform(a_object->getLocalPos(), a_object->getLocalRot());
+    for (unsigned int i=0; i<3; i++)
+    {
+        m_transforms.getBuffer(i).push_back(transform);
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method registers a tool with the snapshot, together with the objects
+    whose pose the tool updates from the haptic thread: its image and the
+    proxy and goal spheres of each of its haptic points.
+
+    \param  a_tool  Tool to register.
+*/
+//==============================================================================
+void cSceneSnapshot::addTool(cGenericTool* a_tool)
+{
+    if (a_tool == NULL) { return; }
+
+    addObject(a_tool);
+    addObject(a_tool->m_image);
+
+    int numHapticPoints = a_tool->getNumHapticPoints();
+    for (int i=0; i<numHapticPoints; i++)
+    {
+        cHapticPoint* point = a_tool->getHapticPoint(i);
+        addObject(point->m_sphereProxy);
+        addObject(point->m_sphereGoal);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method unregisters an object from the snapshot. Its slot is kept
+    empty so that the indices of the other objects remain valid.
+
+    \param  a_object  Object to unregister.
+*/
+//==============================================================================
+void cSceneSnapshot::removeObject(cGenericObject* a_object)
+{
+    if ((a_object == NULL) || (a_object->m_snapshot != this))
+    {
+        return;
+    }
+
+    m_objects[a_object->m_snapshotIndex] = NULL;
+    a_object->m_snapshot = NULL;
+    a_object->m_snapshotIndex = -1;
+}
+
+
+//==============================================================================
+/*!
+    This method copies the local position and orientation of every registered
+    object into the write buffer and makes it available to the graphic thread.
+    It should be called by the haptic thread once all poses have been updated
+    for the current cycle.
+*/
+//==============================================================================
+void cSceneSnapshot::publish()
+{
+    std::vector<cTransform>& transforms = m_transforms.getWriteBuffer();
+
+    unsigned int numObjects = (unsigned int)(m_objects.size());
+    for (unsigned int i=0; i<numObjects; i++)
+    {
+        cGenericObject* object = m_objects[i];
+        if (object != NULL)
+        {
+            transforms[i].set(object->getLocalPos(), object->getLocalRot());
+        }
+    }
+
+    m_transforms.publish();
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
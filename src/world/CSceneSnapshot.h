@@ -0,0 +1,167 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CSceneSnapshotH
+#define CSceneSnapshotH
+//------------------------------------------------------------------------------
+#include "math/CTransform.h"
+#include "system/CTripleBuffer.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CSceneSnapshot.h
+    \ingroup    world
+
+    \brief
+    Implements a lock-free snapshot of object poses shared between the haptic
+    and graphic threads.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cGenericObject;
+class cGenericTool;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cSceneSnapshot
+    \ingroup    world
+
+    \brief
+    This class passes the local position and orientation of a set of objects
+    from the haptic thread to the graphic thread without locks.
+
+    \details
+    The haptic thread typically modifies the position and orientation of
+    tools, cursors and dynamic objects while the graphic thread renders them.
+    Without synchronization, the renderer may read a position from one haptic
+    cycle and an orientation from another, or the pose of a tool and of its
+    proxy from different cycles. \n
+
+    A scene snapshot solves this problem for the objects registered with
+    addObject() or addTool(). At the end of each haptic cycle, the haptic
+    thread calls publish(), which copies the local transformation of every
+    registered object into a cTripleBuffer. Before rendering, the graphic
+    thread calls update() to acquire the most recent complete snapshot.
+    While an object is registered, cGenericObject::renderSceneGraph() uses
+    the transformation stored in the snapshot instead of reading
+    __m_localPos__ and __m_localRot__ directly. Neither thread ever blocks
+    the other. \n
+
+    Only one thread may call publish(), and only one thread may call
+    update(). Objects must be registered before the haptic and graphic
+    threads are started.
+*/
+//==============================================================================
+class cSceneSnapshot
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cSceneSnapshot.
+    cSceneSnapshot();
+
+    //! Destructor of cSceneSnapshot.
+    virtual ~cSceneSnapshot();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method registers an object whose local transformation is published by the haptic thread.
+    bool addObject(cGenericObject* a_object);
+
+    //! This method registers a tool, its image, and the proxy and goal spheres of its haptic points.
+    void addTool(cGenericTool* a_tool);
+
+    //! This method unregisters an object.
+    void removeObject(cGenericObject* a_object);
+
+    //! This method returns the number of object slots in the snapshot.
+    unsigned int getNumObjects() const { return ((unsigned int)(m_objects.size())); }
+
+    //! This method publishes the current local transformations of all registered objects. It is called by the haptic thread.
+    void publish();
+
+    //! This method acquires the latest published snapshot. It is called by the graphic thread and returns __true__ if new data was available.
+    bool update() { return (m_transforms.update()); }
+
+    //! This method returns the local transformation of the n-th object in the snapshot acquired by the graphic thread.
+    const cTransform& getLocalTransform(const unsigned int a_index) const { return (m_transforms.getReadBuffer()[a_index]); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Registered objects. Slots of removed objects are set to NULL.
+    std::vector<cGenericObject*> m_objects;
+
+    //! Local transformations of the registered objects.
+    cTripleBuffer< std::vector<cTransform> > m_transforms;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
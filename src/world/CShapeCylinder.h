@@ -158,6 +158,9 @@ protected:
                                                 cCollisionRecorder& a_recorder,
                                                 cCollisionSettings& a_settings);
 
+    //! This method returns __true__ since collisions with cylinders are computed with all settings.
+    virtual bool hasOtherCollisionDetection(const cCollisionSettings& a_settings) const { return (true); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED METHODS:
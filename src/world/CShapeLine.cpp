@@ -580,6 +580,38 @@ bool cShapeLine::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method enlarges a box so that it encloses the collisions computed
+    with this line. When an extremity of the line is attached to another
+    object, the line follows that object and cannot be bounded in advance.
+
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+
+    \return __true__ if the box encloses the line, __false__ otherwise.
+*/
+//==============================================================================
+bool cShapeLine::computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+                                                  cVector3d& a_boxMax)
+{
+    // line follows other objects
+    if ((m_objectA != NULL) || (m_objectB != NULL))
+    {
+        return (false);
+    }
+
+    // enlarge box
+    for (int i=0; i<3; i++)
+    {
+        a_boxMin(i) = cMin(a_boxMin(i), cMin(m_linePointA(i), m_linePointB(i)));
+        a_boxMax(i) = cMax(a_boxMax(i), cMax(m_linePointA(i), m_linePointB(i)));
+    }
+
+    return (true);
+}
+
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
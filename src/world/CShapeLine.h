@@ -178,6 +178,13 @@ protected:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings);
 
+    //! This method enlarges a box to enclose the collisions computed with this line.
+    virtual bool computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+        cVector3d& a_boxMax);
+
+    //! This method returns __true__ if collisions with this line are computed with the given settings.
+    virtual bool hasOtherCollisionDetection(const cCollisionSettings& a_settings) const { return (!a_settings.m_ignoreShapes); }
+
 
     //-----------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -144,6 +144,9 @@ protected:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings);
 
+    //! This method returns __true__ if collisions with this shape are computed with the given settings.
+    virtual bool hasOtherCollisionDetection(const cCollisionSettings& a_settings) const { return (!a_settings.m_ignoreShapes); }
+
 
     //-----------------------------------------------------------------------
     // PROTECTED METHODS:
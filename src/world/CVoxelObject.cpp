@@ -141,6 +141,13 @@ cVoxelObject::cVoxelObject()
     
     // render only front faces
     setUseCulling(true);
+
+    // enable empty space skipping
+    m_useOccupancy = true;
+
+    // polygonize using one thread per processor core
+    m_numPolygonizationThreads = 0;
+    m_polygonizationPool = NULL;
 }
 
 
@@ -151,6 +158,10 @@ cVoxelObject::cVoxelObject()
 //==============================================================================
 cVoxelObject::~cVoxelObject()
 {
+    if (m_polygonizationPool != NULL)
+    {
+        delete m_polygonizationPool;
+    }
 }
 
 
@@ -327,6 +338,9 @@ void cVoxelObject::render(cRenderOptions& a_options)
     {
         // update model
         update(a_options);
+
+        // free occupancy pyramids replaced since the last frame
+        releaseRetiredOccupancy();
     }
 
     /////////////////////////////////////////////////////////////////////////
@@ -963,6 +977,152 @@ void cVoxelObject::loadRenderingShaders()
 }
 
 
+//==============================================================================
+/*!
+    This method updates the occupancy pyramid after the voxels located in a
+    range have been modified. The range is inclusive and is expressed in
+    voxel coordinates. The published pyramid is updated in place, as the 
+    voxels of the image are. If no pyramid matching the current image has
+    been published, this method does nothing; call invalidateOccupancy() to
+    build one.
+
+    \param  a_minX  Minimum voxel coordinate along __x__.
+    \param  a_minY  Minimum voxel coordinate along __y__.
+    \param  a_minZ  Minimum voxel coordinate along __z__.
+    \param  a_maxX  Maximum voxel coordinate along __x__.
+    \param  a_maxY  Maximum voxel coordinate along __y__.
+    \param  a_maxZ  Maximum voxel coordinate along __z__.
+*/
+//==============================================================================
+void cVoxelObject::updateOccupancy(const int a_minX, const int a_minY, const int a_minZ,
+                                   const int a_maxX, const int a_maxY, const int a_maxZ)
+{
+    m_occupancyMutex.acquire();
+
+    cVoxelOccupancyPtr occupancy = getOccupancy();
+    if (occupancy != nullptr)
+    {
+        occupancy->update(m_texture->m_image.get(), a_minX, a_minY, a_minZ, a_maxX, a_maxY, a_maxZ);
+    }
+
+    m_occupancyMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method builds the occupancy pyramid from the entire volume on the
+    calling thread, then publishes it to collision queries. Queries that 
+    started before the new pyramid is published keep using the previous one.
+*/
+//==============================================================================
+void cVoxelObject::invalidateOccupancy()
+{
+    m_occupancyMutex.acquire();
+
+    // build new pyramid
+    cVoxelOccupancyPtr occupancy = nullptr;
+    if ((m_texture != nullptr) && (m_texture->m_image != nullptr))
+    {
+        occupancy = std::make_shared<cVoxelOccupancy>();
+        occupancy->build(m_texture->m_image.get());
+    }
+
+    // publish it, and keep the previous one so that it is not released by a collision query
+    cVoxelOccupancyPtr previousOccupancy = std::atomic_exchange(&m_occupancy, occupancy);
+    if (previousOccupancy != nullptr)
+    {
+        m_retiredOccupancy.push_back(previousOccupancy);
+    }
+
+    m_occupancyMutex.release();
+
+    // free the pyramids that collision queries no longer use
+    releaseRetiredOccupancy();
+}
+
+
+//==============================================================================
+/*!
+    This method frees the retired occupancy pyramids that collision queries
+    no longer use. A pyramid in the list that is only referenced by the list
+    can no longer be acquired by a collision query. The method is called by
+    invalidateOccupancy() and by the graphic thread when rendering, and
+    returns without waiting if another thread is building a pyramid.
+*/
+//==============================================================================
+void cVoxelObject::releaseRetiredOccupancy()
+{
+    std::vector<cVoxelOccupancyPtr> unusedOccupancy;
+
+    if (!m_occupancyMutex.tryAcquire()) { return; }
+    for (unsigned int i=0; i<m_retiredOccupancy.size();)
+    {
+        if (m_retiredOccupancy[i].use_count() == 1)
+        {
+            unusedOccupancy.push_back(m_retiredOccupancy[i]);
+            m_retiredOccupancy[i] = m_retiredOccupancy.back();
+            m_retiredOccupancy.pop_back();
+        }
+        else
+        {
+            i++;
+        }
+    }
+    m_occupancyMutex.release();
+
+    // pyramids are freed here, outside of the mutex
+    unusedOccupancy.clear();
+}
+
+
+//==============================================================================
+/*!
+    This method returns the published occupancy pyramid if it has been built
+    from the current image of the texture and the size of the image has not
+    changed since. It can be called from any thread.
+
+    \return Occupancy pyramid, or __nullptr__ if none matches the current image.
+*/
+//==============================================================================
+cVoxelOccupancyPtr cVoxelObject::getOccupancy() const
+{
+    cVoxelOccupancyPtr occupancy = std::atomic_load(&m_occupancy);
+    if ((occupancy == nullptr) || (occupancy->getNumLevels() == 0) || (m_texture == nullptr))
+    {
+        return (nullptr);
+    }
+
+    const cImage* image = m_texture->m_image.get();
+    if ((image == NULL) ||
+        (image != occupancy->getImage()) ||
+        (occupancy->getSize(0) != (int)(image->getWidth())) ||
+        (occupancy->getSize(1) != (int)(image->getHeight())) ||
+        (occupancy->getSize(2) != (int)(image->getImageCount())))
+    {
+        return (nullptr);
+    }
+
+    return (occupancy);
+}
+
+
+//==============================================================================
+/*!
+    This method sets a texture to this object, then builds the occupancy 
+    pyramid of its image on the calling thread.
+
+    \param  a_texture         Texture.
+    \param  a_affectChildren  If __true__ then children are updated too.
+*/
+//==============================================================================
+void cVoxelObject::setTexture(cTexture1dPtr a_texture, const bool a_affectChildren)
+{
+    cMesh::setTexture(a_texture, a_affectChildren);
+    invalidateOccupancy();
+}
+
+
 //==============================================================================
 /*!
     This method determines whether a given segment intersects this object or any
@@ -1074,13 +1234,8 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
 
 
     ////////////////////////////////////////////////////////////////////////////
-    // COMPUTE COLLISIONS
+    // PREPARE EMPTY SPACE SKIPPING
     ////////////////////////////////////////////////////////////////////////////
-    int counter = 0;
-
-    // compute collision radius; this also handle the case when the tool has radius 0.
-    double r = cMax(collisionRadius + 0.9 * voxelLargestSize, 0.9 * voxelLargestSize);
-    double r2 = cSqr(r);
 
     // compute range of object
     cVector3d objectRange = m_maxCorner - m_minCorner;
@@ -1088,6 +1243,48 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
     // compute range of texture
     cVector3d texRange = m_maxTextureCoord - m_minTextureCoord;
 
+    // empty space skipping requires a valid mapping between texels and local space
+    bool useOccupancy = m_useOccupancy;
+    for (int i=0; i<3; i++)
+    {
+        if ((objectRange(i) == 0.0) || (texRange(i) == 0.0))
+        {
+            useOccupancy = false;
+        }
+    }
+
+    // use the published pyramid, if any; it is never built here
+    cVoxelOccupancyPtr occupancy = nullptr;
+    if (useOccupancy)
+    {
+        occupancy = getOccupancy();
+        useOccupancy = (occupancy != nullptr);
+    }
+
+    // compute smallest alpha value for which a voxel is considered solid
+    const float CONVERSION_FACTOR = (1.0f / 255.0f);
+    int threshold = 0;
+    while ((threshold < 256) && ((CONVERSION_FACTOR * (float)threshold) < m_isosurfaceValue))
+    {
+        threshold++;
+    }
+
+    // every step checks the texels located within this margin
+    int margin[3];
+    margin[0] = texRadius[0] + 1;
+    margin[1] = texRadius[1] + 1;
+    margin[2] = texRadius[2] + 1;
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // COMPUTE COLLISIONS
+    ////////////////////////////////////////////////////////////////////////////
+    int counter = 0;
+
+    // compute collision radius; this also handle the case when the tool has radius 0.
+    double r = cMax(collisionRadius + 0.9 * voxelLargestSize, 0.9 * voxelLargestSize);
+    double r2 = cSqr(r);
+
     // no collision has occurred yet
     bool hit = false;
 
@@ -1104,12 +1301,14 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
 
     // distance counter
     double distance = 0.0;
+    unsigned int step = 0;
 
     // search for collision
     while ((!hit) && (distance < distanceAB))
     {
         // increment step
-        distance = cMin((distance + voxelSmallestSize), distanceAB);
+        step++;
+        distance = cMin(((double)step * voxelSmallestSize), distanceAB);
 
         // compute next point
         cVector3d pointB = a_segmentPointA + distance * dir;
@@ -1124,6 +1323,46 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
         int texel[3];
         m_texture->m_image->getVoxelLocation(texCoord, texel[0], texel[1], texel[2], true);
 
+        // skip all steps located inside an empty region of the volume
+        int regionMin[3], regionMax[3];
+        if (useOccupancy && occupancy->getEmptyRegion(texel, margin, threshold, regionMin, regionMax))
+        {
+            // compute distance at which the segment leaves the region. Texels
+            // located on the border of the volume also cover all points beyond
+            // the border, since texel locations are clamped to the image size.
+            double exitDistance = C_LARGE;
+            for (int i=0; i<3; i++)
+            {
+                double scale = objectRange(i) / texRange(i);
+                double speed = dir(i) * scale;
+
+                if ((speed > 0.0) && (regionMax[i] < (int)(texSize[i]) - 1))
+                {
+                    double bound = m_minCorner(i) + ((double)(regionMax[i] + 1) / texSize[i] - m_minTextureCoord(i)) * scale;
+                    exitDistance = cMin(exitDistance, (bound - a_segmentPointA(i)) / dir(i));
+                }
+                else if ((speed < 0.0) && (regionMin[i] > 0))
+                {
+                    double bound = m_minCorner(i) + ((double)(regionMin[i]) / texSize[i] - m_minTextureCoord(i)) * scale;
+                    exitDistance = cMin(exitDistance, (bound - a_segmentPointA(i)) / dir(i));
+                }
+            }
+
+            // keep a small tolerance so that no step located at the border of the region is skipped
+            exitDistance = exitDistance - 1e-6 * voxelSmallestSize;
+            if (exitDistance >= distanceAB)
+            {
+                break;
+            }
+
+            unsigned int lastStep = (unsigned int)(cMax(0.0, exitDistance) / voxelSmallestSize);
+            if (lastStep > step)
+            {
+                step = lastStep;
+            }
+            continue;
+        }
+
         // check the area covered by the radius
         int tmin[3];
         tmin[0] = texel[0] - texRadius[0] - 1;
@@ -1154,7 +1393,6 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
 
                         if (result)
                         {
-                            const float CONVERSION_FACTOR = (1.0f / 255.0f);
                             float level = CONVERSION_FACTOR * (float)(color.getA());
 
                             if (level >= m_isosurfaceValue)
@@ -1332,7 +1570,76 @@ bool cVoxelObject::computeOtherCollisionDetection(cVector3d& a_segmentPointA,
 
 //==============================================================================
 /*!
-    This method converts this voxel object into a triangle multi-mesh.\n
+    This method enlarges a box so that it encloses the collisions computed with
+    the voxels of this object. Since voxels are modeled as ellipsoids that
+    extend slightly beyond their cells, the volume is padded by the size of a
+    voxel along each axis.
+
+    \param  a_boxMin  Minimum point of the box.
+    \param  a_boxMax  Maximum point of the box.
+
+    \return __true__ since the volume always bounds the voxels.
+*/
+//==============================================================================
+bool cVoxelObject::computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+                                                    cVector3d& a_boxMax)
+{
+    for (int i=0; i<3; i++)
+    {
+        // compute size of texels along axis, which never exceeds the size of the volume
+        double s = fabs(m_maxCorner(i) - m_minCorner(i));
+        double voxelSize = s;
+        if ((m_texture != nullptr) && (m_texture->m_image != nullptr) && (m_maxTextureCoord(i) != m_minTextureCoord(i)))
+        {
+            double texSize = 0.0;
+            if (i == 0) { texSize = (double)(m_texture->m_image->getWidth()); }
+            if (i == 1) { texSize = (double)(m_texture->m_image->getHeight()); }
+            if (i == 2) { texSize = (double)(m_texture->m_image->getImageCount()); }
+
+            if (texSize > 0.0)
+            {
+                voxelSize = cMin(s, fabs(s / ((m_maxTextureCoord(i) - m_minTextureCoord(i)) * texSize)));
+            }
+        }
+
+        // enlarge box
+        a_boxMin(i) = cMin(a_boxMin(i), cMin(m_minCorner(i), m_maxCorner(i)) - voxelSize);
+        a_boxMax(i) = cMax(a_boxMax(i), cMax(m_minCorner(i), m_maxCorner(i)) + voxelSize);
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the number of threads used to polygonize this object.
+
+    \param  a_numThreads  Number of threads (0 to use one thread per processor core).
+*/
+//==============================================================================
+void cVoxelObject::setNumPolygonizationThreads(const unsigned int a_numThreads)
+{
+    if (a_numThreads == m_numPolygonizationThreads)
+    {
+        return;
+    }
+
+    m_numPolygonizationThreads = a_numThreads;
+
+    // release worker pool; a new one is created by the next polygonization
+    if (m_polygonizationPool != NULL)
+    {
+        delete m_polygonizationPool;
+        m_polygonizationPool = NULL;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method converts this voxel object into a triangle multi-mesh. A
+    single mesh is added to the multi-mesh.
 
     \param  a_multiMesh  Multi-mesh.
     \param  a_gridSizeX  Sampling grid size along __x__-axis
@@ -1363,9 +1670,18 @@ bool cVoxelObject::polygonize(cMultiMesh* a_multiMesh, double a_gridSizeX, doubl
 
 //==============================================================================
 /*!
-    This method converts this voxel object into a triangle mesh.\n
+    This method converts this voxel object into a triangle multi-mesh
+    composed of blocks. \n
 
-    \param  a_mesh  Mesh object.
+    The volume is split into blocks of C_VOXEL_POLYGONIZATION_BLOCK_SIZE
+    grid cells along each axis, and one mesh is added to the multi-mesh for
+    every block, including empty ones, so that each block keeps its mesh
+    when voxels are modified. Blocks are ordered along the __x__-axis
+    first, then along the __y__- and __z__-axes. After voxels have been
+    modified, call updatePolygonization() to recompute only the affected
+    blocks.
+
+    \param  a_multiMesh  Multi-mesh.
     \param  a_gridSizeX  Sampling grid size along __x__-axis
     \param  a_gridSizeY  Sampling grid size along __y__-axis
     \param  a_gridSizeZ  Sampling grid size along __z__-axis
@@ -1373,182 +1689,244 @@ bool cVoxelObject::polygonize(cMultiMesh* a_multiMesh, double a_gridSizeX, doubl
     \return __true__ of the operation succeeds, __false__otherwise.
 */
 //==============================================================================
-bool cVoxelObject::polygonize(cMesh* a_mesh, double a_gridSizeX, double a_gridSizeY, double a_gridSizeZ)
+bool cVoxelObject::polygonizeBlocks(cMultiMesh* a_multiMesh, double a_gridSizeX, double a_gridSizeY, double a_gridSizeZ)
 {
     // sanity check
-    if (a_mesh == NULL)
+    if (a_multiMesh == NULL)
     {
         return (C_ERROR);
     }
 
-    // backup border color
-    cColorb borderColor = m_texture->m_image->m_borderColor;
+    // setup polygonizer
+    cVoxelPolygonizer polygonizer;
+    if (!setupPolygonizer(polygonizer, a_gridSizeX, a_gridSizeY, a_gridSizeZ))
+    {
+        return (C_ERROR);
+    }
 
-    // assign new value to border color so that isovalue is zero when fetching
-    // voxel outside the boundaries of the 3D image
-    m_texture->m_image->m_borderColor.set(0.0, 0.0, 0.0, 0.0);
+    // polygonize blocks
+    int numBlocks[3];
+    for (int i=0; i<3; i++)
+    {
+        numBlocks[i] = (polygonizer.getNumCells(i) + C_VOXEL_POLYGONIZATION_BLOCK_SIZE - 1) / C_VOXEL_POLYGONIZATION_BLOCK_SIZE;
+    }
 
-    // get size of 3d texture
-    double texSize[3];
-    texSize[0] = (double)(m_texture->m_image->getWidth());
-    texSize[1] = (double)(m_texture->m_image->getHeight());
-    texSize[2] = (double)(m_texture->m_image->getImageCount());
+    for (int z=0; z<numBlocks[2]; z++)
+    {
+        for (int y=0; y<numBlocks[1]; y++)
+        {
+            for (int x=0; x<numBlocks[0]; x++)
+            {
+                cMesh* mesh = a_multiMesh->newMesh();
+                polygonizeBlock(polygonizer, mesh, x, y, z);
+            }
+        }
+    }
+
+    // return success
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method recomputes the blocks of a multi-mesh created by
+    polygonizeBlocks() that are affected by a modification of the voxels
+    located in a range. The multi-mesh must have been empty when
+    polygonizeBlocks() was called, and the same grid sizes must be used. \n
+
+    The occupancy pyramid is updated over the same range of voxels.
+
+    \param  a_multiMesh  Multi-mesh created by polygonizeBlocks().
+    \param  a_minX       Minimum voxel coordinate along __x__-axis of the modified range.
+    \param  a_minY       Minimum voxel coordinate along __y__-axis of the modified range.
+    \param  a_minZ       Minimum voxel coordinate along __z__-axis of the modified range.
+    \param  a_maxX       Maximum voxel coordinate along __x__-axis of the modified range.
+    \param  a_maxY       Maximum voxel coordinate along __y__-axis of the modified range.
+    \param  a_maxZ       Maximum voxel coordinate along __z__-axis of the modified range.
+    \param  a_gridSizeX  Sampling grid size along __x__-axis
+    \param  a_gridSizeY  Sampling grid size along __y__-axis
+    \param  a_gridSizeZ  Sampling grid size along __z__-axis
 
+    \return __true__ of the operation succeeds, __false__otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::updatePolygonization(cMultiMesh* a_multiMesh,
+                                        const int a_minX, const int a_minY, const int a_minZ,
+                                        const int a_maxX, const int a_maxY, const int a_maxZ,
+                                        double a_gridSizeX, double a_gridSizeY, double a_gridSizeZ)
+{
     // sanity check
-    if ((texSize[0] == 0) || (texSize[1] == 0) || (texSize[2] == 0))
+    if (a_multiMesh == NULL)
     {
-        return (false);
+        return (C_ERROR);
     }
 
-    // compute size of texels along each axis
-    double st[3];
-    for (int i = 0; i<3; i++)
+    // take modified voxels into account
+    updateOccupancy(a_minX, a_minY, a_minZ, a_maxX, a_maxY, a_maxZ);
+
+    // setup polygonizer
+    cVoxelPolygonizer polygonizer;
+    if (!setupPolygonizer(polygonizer, a_gridSizeX, a_gridSizeY, a_gridSizeZ))
     {
-        if (m_maxTextureCoord(i) == m_minTextureCoord(i))
-        {
-            st[i] = fabs(m_maxCorner(i) - m_minCorner(i));
-        }
-        else
-        {
-            double s = fabs(m_maxCorner(i) - m_minCorner(i));
-            st[i] = cMin(s, (s / ((m_maxTextureCoord(i) - m_minTextureCoord(i)) * texSize[i])));
-        }
+        return (C_ERROR);
     }
 
-    // compute range of object
-    cVector3d objectRange = m_maxCorner - m_minCorner;
+    int numBlocks[3];
+    for (int i=0; i<3; i++)
+    {
+        numBlocks[i] = (polygonizer.getNumCells(i) + C_VOXEL_POLYGONIZATION_BLOCK_SIZE - 1) / C_VOXEL_POLYGONIZATION_BLOCK_SIZE;
+    }
 
-    // compute range of texture
-    cVector3d texRange = m_maxTextureCoord - m_minTextureCoord;
+    if (a_multiMesh->getNumMeshes() < numBlocks[0] * numBlocks[1] * numBlocks[2])
+    {
+        return (C_ERROR);
+    }
 
-    // set grid size
-    double gridSize[3];
-    gridSize[0] = a_gridSizeX;
-    gridSize[1] = a_gridSizeY;
-    gridSize[2] = a_gridSizeZ;
+    // find affected cells
+    int voxelMin[3] = { a_minX, a_minY, a_minZ };
+    int voxelMax[3] = { a_maxX, a_maxY, a_maxZ };
+    int cellMin[3], cellMax[3];
+    if (!polygonizer.getCellRange(voxelMin, voxelMax, cellMin, cellMax))
+    {
+        return (C_SUCCESS);
+    }
 
-    for (int i = 0; i < 3; i++)
+    // polygonize affected blocks
+    for (int z=cellMin[2]/C_VOXEL_POLYGONIZATION_BLOCK_SIZE; z<=cellMax[2]/C_VOXEL_POLYGONIZATION_BLOCK_SIZE; z++)
     {
-        if (gridSize[i] < 0.0)
+        for (int y=cellMin[1]/C_VOXEL_POLYGONIZATION_BLOCK_SIZE; y<=cellMax[1]/C_VOXEL_POLYGONIZATION_BLOCK_SIZE; y++)
         {
-            gridSize[i] = st[i];
+            for (int x=cellMin[0]/C_VOXEL_POLYGONIZATION_BLOCK_SIZE; x<=cellMax[0]/C_VOXEL_POLYGONIZATION_BLOCK_SIZE; x++)
+            {
+                cMesh* mesh = a_multiMesh->getMesh(x + (y + z * numBlocks[1]) * numBlocks[0]);
+                mesh->clear();
+                polygonizeBlock(polygonizer, mesh, x, y, z);
+            }
         }
     }
 
-    // declared variables
-    cMarchingCubeGridCell gridCell;
-    cMarchingCubeTriangle triangles[16];
-    cVector3d p;
+    // return success
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method converts this voxel object into a triangle mesh. \n
+
+    The surface is extracted in parallel, and the vertices located on an
+    edge of the sampling grid are shared by all adjacent triangles.
+
+    \param  a_mesh  Mesh object.
+    \param  a_gridSizeX  Sampling grid size along __x__-axis
+    \param  a_gridSizeY  Sampling grid size along __y__-axis
+    \param  a_gridSizeZ  Sampling grid size along __z__-axis
 
-    // compute padding
-    double padding[3];
-    for (int i = 0; i < 3; i++)
+    \return __true__ of the operation succeeds, __false__otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::polygonize(cMesh* a_mesh, double a_gridSizeX, double a_gridSizeY, double a_gridSizeZ)
+{
+    // sanity check
+    if (a_mesh == NULL)
     {
-        padding[i] = cMax(st[i], gridSize[i]);
+        return (C_ERROR);
     }
 
-    // parse volume
-    p(2) = m_minCorner(2) - padding[2];
-    while (p(2) < (m_maxCorner(2) + padding[2]))
+    // setup polygonizer
+    cVoxelPolygonizer polygonizer;
+    if (!setupPolygonizer(polygonizer, a_gridSizeX, a_gridSizeY, a_gridSizeZ))
     {
-        p(1) = m_minCorner(1) - padding[1];
-        while (p(1) < (m_maxCorner(1) + padding[1]))
-        {
-            p(0) = m_minCorner(0) - padding[0];
-            while (p(0) < (m_maxCorner(0) + padding[0]))
-            {
-                // compute cell positions
-                gridCell.p[0] = p + cVector3d(0.0, 0.0, 0.0);
-                gridCell.p[1] = p + cVector3d(0.0, gridSize[1], 0.0);
-                gridCell.p[2] = p + cVector3d(gridSize[0], gridSize[1], 0.0);
-                gridCell.p[3] = p + cVector3d(gridSize[0], 0.0, 0.0);
-                gridCell.p[4] = p + cVector3d(0.0, 0.0, gridSize[2]);
-                gridCell.p[5] = p + cVector3d(0.0, gridSize[1], gridSize[2]);
-                gridCell.p[6] = p + cVector3d(gridSize[0], gridSize[1], gridSize[2]);
-                gridCell.p[7] = p + cVector3d(gridSize[0], 0.0, gridSize[2]);
-
-                // get cell value
-                for (int i = 0; i < 8; i++)
-                {
-                    // get voxel position
-                    cVector3d p = gridCell.p[i];
-
-                    // compute point in texels
-                    cVector3d texCoord;
-                    texCoord(0) = m_minTextureCoord(0) + ((p(0) - m_minCorner(0)) / (objectRange(0)) * (texRange(0)));
-                    texCoord(1) = m_minTextureCoord(1) + ((p(1) - m_minCorner(1)) / (objectRange(1)) * (texRange(1)));
-                    texCoord(2) = m_minTextureCoord(2) + ((p(2) - m_minCorner(2)) / (objectRange(2)) * (texRange(2)));
-
-                    // color variable
-                    cColorf color;
-
-                    // get voxel color given a texture coordinate
-#if 0
-                    // get voxel position
-                    double x, y, z;
-                    m_texture->m_image->getVoxelLocationInterpolated(texCoord, x, y, z, false);
-                  
-                    // get voxel color
-                    m_texture->m_image->getVoxelColorInterpolated(x, y, z, color);
-#else
-                    // get voxel position
-                    int x, y, z;
-                    m_texture->m_image->getVoxelLocation(texCoord, x, y, z, false);
-                  
-                    // get voxel color
-                    cColorb colorb;
-                    m_texture->m_image->getVoxelColor(x, y, z, colorb);
-                  
-                    // convert color to floating point format
-                    color = colorb.getColorf();
-#endif
-                  
-                    // convert color to isovalue by taking the luminance
-                    double isoValue = color.getA();
-                    gridCell.val[i] = isoValue;
-                }
+        return (C_ERROR);
+    }
 
-                // polygonize model
-                int numTriangles = cPolygonize(gridCell, m_isosurfaceValue, triangles);
+    // polygonize volume
+    return (polygonizer.polygonize(a_mesh));
+}
 
-                // add triangles to mesh
-                for (int j = 0; j < numTriangles; j++)
-                {
-                    // compute surface normal (an interpolated normal would be better!)
-                    cVector3d normal = cComputeSurfaceNormal(triangles[j].p[0], triangles[j].p[1], triangles[j].p[2]);
-
-                    // create new triangle
-                    a_mesh->newTriangle(triangles[j].p[0],
-                                        triangles[j].p[1],
-                                        triangles[j].p[2],
-                                        normal, normal, normal);
-                }
 
-                // increment x
-                p(0) = p(0) + gridSize[0];
-            }
+//==============================================================================
+/*!
+    This method sets up a polygonizer with the volume, the isosurface value,
+    the occupancy pyramid, and the worker pool of this object.
 
-            // increment y
-            p(1) = p(1) + gridSize[1];
-        }
+    \param  a_polygonizer  Polygonizer.
+    \param  a_gridSizeX    Sampling grid size along __x__-axis
+    \param  a_gridSizeY    Sampling grid size along __y__-axis
+    \param  a_gridSizeZ    Sampling grid size along __z__-axis
+
+    \return __true__ of the operation succeeds, __false__otherwise.
+*/
+//==============================================================================
+bool cVoxelObject::setupPolygonizer(cVoxelPolygonizer& a_polygonizer, double a_gridSizeX, double a_gridSizeY, double a_gridSizeZ)
+{
+    // sanity check
+    if ((m_texture == nullptr) || (m_texture->m_image == nullptr))
+    {
+        return (false);
+    }
+
+    // define grid
+    if (!a_polygonizer.setGrid(m_texture->m_image.get(),
+                               m_minCorner,
+                               m_maxCorner,
+                               m_minTextureCoord,
+                               m_maxTextureCoord,
+                               cVector3d(a_gridSizeX, a_gridSizeY, a_gridSizeZ)))
+    {
+        return (false);
+    }
 
-        // increment z
-        p(2) = p(2) + gridSize[2];
+    a_polygonizer.setIsosurfaceValue(m_isosurfaceValue);
 
-        // verbose progress
-        if (true)
+    // skip empty space
+    if (m_useOccupancy)
+    {
+        if (getOccupancy() == nullptr)
         {
-            double range = (m_maxCorner(2) + padding[2]) - (m_minCorner(2) - padding[2]);
-            int progress = 100 * ((p(2) - (m_minCorner(2) - padding[2])) / range);
-            cout << "polygonization: "+cStr(progress) + "%                                                       \r";
+            invalidateOccupancy();
         }
+        a_polygonizer.setOccupancy(getOccupancy());
     }
 
-    // restore border color
-    m_texture->m_image->m_borderColor = borderColor;
+    // create worker pool
+    if ((m_numPolygonizationThreads != 1) && (m_polygonizationPool == NULL))
+    {
+        m_polygonizationPool = new cWorkerPool(m_numPolygonizationThreads);
+    }
+    a_polygonizer.setWorkerPool(m_polygonizationPool);
 
-    // return success
-    return (C_SUCCESS);
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method polygonizes a block of grid cells into a mesh.
+
+    \param  a_polygonizer  Polygonizer.
+    \param  a_mesh         Mesh receiving the triangles.
+    \param  a_blockX       Block index along __x__-axis.
+    \param  a_blockY       Block index along __y__-axis.
+    \param  a_blockZ       Block index along __z__-axis.
+*/
+//==============================================================================
+void cVoxelObject::polygonizeBlock(cVoxelPolygonizer& a_polygonizer,
+                                   cMesh* a_mesh,
+                                   const int a_blockX,
+                                   const int a_blockY,
+                                   const int a_blockZ)
+{
+    int block[3] = { a_blockX, a_blockY, a_blockZ };
+    int cellMin[3], cellMax[3];
+    for (int i=0; i<3; i++)
+    {
+        cellMin[i] = block[i] * C_VOXEL_POLYGONIZATION_BLOCK_SIZE;
+        cellMax[i] = cellMin[i] + C_VOXEL_POLYGONIZATION_BLOCK_SIZE - 1;
+    }
+
+    a_polygonizer.polygonize(a_mesh, cellMin, cellMax);
 }
 
 
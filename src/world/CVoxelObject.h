@@ -48,12 +48,18 @@
 //------------------------------------------------------------------------------
 #include "world/CMesh.h"
 #include "world/CMultiMesh.h"
+#include "collisions/CVoxelOccupancy.h"
+#include "system/CMutex.h"
+#include "world/CVoxelPolygonizer.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
 const int C_NUM_VOXEL_RENDERING_MODES = 9;
+
+//! Edge length, in grid cells, of the blocks of a multi-mesh created by cVoxelObject::polygonizeBlocks().
+const int C_VOXEL_POLYGONIZATION_BLOCK_SIZE = 32;
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -101,7 +107,26 @@ struct cVoxelCoordList
     This class implements a 3D volumetric object composed of voxels.
 
     \details
-    This class implements a 3D volumetric object composed of voxels.
+    This class implements a 3D volumetric object composed of voxels. \n
+
+    Collision detection skips empty regions of the volume by using a
+    min/max occupancy pyramid (see cVoxelOccupancy). The pyramid is built on
+    the calling thread when a texture is assigned with setTexture() and when
+    invalidateOccupancy() is called, then published atomically, so that 
+    collision queries running on other threads never build it, wait for it,
+    nor free it: replaced pyramids are freed by the graphic thread once no
+    query uses them. Queries fall back to testing every step of the segment
+    while no pyramid matching the current image has been published. When
+    voxels are edited, call updateOccupancy() with the range of modified
+    voxels, or invalidateOccupancy() after larger changes or after assigning
+    a new image to the texture, so that newly filled voxels are taken into
+    account. \n
+
+    Polygonization extracts the isosurface in parallel with a
+    cVoxelPolygonizer. With polygonizeBlocks(), the volume is split into
+    blocks stored in a multi-mesh, so that updatePolygonization() can
+    recompute only the blocks affected by a modification of the voxels,
+    for instance while the volume is being carved.
 */
 //==============================================================================
 class cVoxelObject : public cMesh
@@ -199,6 +224,36 @@ public:
     bool getUseColorMap() const { return m_useColorMap; }
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - OCCUPANCY:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables empty space skipping during collision detection.
+    void setUseOccupancy(const bool a_useOccupancy) { m_useOccupancy = a_useOccupancy; }
+
+    //! This method returns __true__ if empty space skipping is enabled, __false__ otherwise.
+    bool getUseOccupancy() const { return (m_useOccupancy); }
+
+    //! This method rebuilds the occupancy pyramid from the entire volume and publishes it to collision queries.
+    void invalidateOccupancy();
+
+    //! This method updates the occupancy pyramid after the voxels located in a range have been modified.
+    void updateOccupancy(const int a_minX, const int a_minY, const int a_minZ,
+                         const int a_maxX, const int a_maxY, const int a_maxZ);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - TEXTURE PROPERTIES:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method sets a texture to this object and builds the occupancy pyramid of its image.
+    virtual void setTexture(cTexture1dPtr a_texture, const bool a_affectChildren = false);
+
+
     //--------------------------------------------------------------------------
     // PUBLIC METHODS - POLYGONIZATION:
     //--------------------------------------------------------------------------
@@ -211,6 +266,21 @@ public:
     //! This method converts this voxel object into a triangle multi-mesh.
     bool polygonize(cMultiMesh* a_multiMesh, double a_gridSizeX = -1.0, double a_gridSizeY = -1.0, double a_gridSizeZ = -1.0);
 
+    //! This method converts this voxel object into a triangle multi-mesh composed of one mesh per block.
+    bool polygonizeBlocks(cMultiMesh* a_multiMesh, double a_gridSizeX = -1.0, double a_gridSizeY = -1.0, double a_gridSizeZ = -1.0);
+
+    //! This method recomputes the blocks of a polygonized multi-mesh that are affected by a modification of a range of voxels.
+    bool updatePolygonization(cMultiMesh* a_multiMesh,
+                              const int a_minX, const int a_minY, const int a_minZ,
+                              const int a_maxX, const int a_maxY, const int a_maxZ,
+                              double a_gridSizeX = -1.0, double a_gridSizeY = -1.0, double a_gridSizeZ = -1.0);
+
+    //! This method sets the number of threads used for polygonization (0 to use one thread per processor core).
+    void setNumPolygonizationThreads(const unsigned int a_numThreads);
+
+    //! This method returns the number of threads used for polygonization.
+    unsigned int getNumPolygonizationThreads() const { return (m_numPolygonizationThreads); }
+
 
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
@@ -246,6 +316,22 @@ protected:
     //! This method updates the mesh model.
     void update(cRenderOptions& a_options);
 
+    //! This method returns the published occupancy pyramid if it matches the current image, __nullptr__ otherwise.
+    cVoxelOccupancyPtr getOccupancy() const;
+
+    //! This method frees the retired occupancy pyramids that collision queries no longer use.
+    void releaseRetiredOccupancy();
+
+    //! This method sets up a polygonizer for this object.
+    bool setupPolygonizer(cVoxelPolygonizer& a_polygonizer, double a_gridSizeX, double a_gridSizeY, double a_gridSizeZ);
+
+    //! This method polygonizes a block of grid cells into a mesh.
+    void polygonizeBlock(cVoxelPolygonizer& a_polygonizer,
+                         cMesh* a_mesh,
+                         const int a_blockX,
+                         const int a_blockY,
+                         const int a_blockZ);
+
     //! This method renders the object graphically using OpenGL.
     virtual void render(cRenderOptions& a_options);
 
@@ -255,6 +341,13 @@ protected:
         cCollisionRecorder& a_recorder,
         cCollisionSettings& a_settings);
 
+    //! This method enlarges a box to enclose the collisions computed with the voxels of this object.
+    virtual bool computeOtherCollisionBoundaryBox(cVector3d& a_boxMin,
+        cVector3d& a_boxMax);
+
+    //! This method returns __true__ since collisions with the voxels of this object are computed with all settings.
+    virtual bool hasOtherCollisionDetection(const cCollisionSettings& a_settings) const { return (true); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS:
@@ -292,6 +385,24 @@ protected:
     //! List of points.
     std::vector<cVoxelCoordList> m_voxelCoordList;
 
+    //! Occupancy pyramid of the volume, used to skip empty regions during collision detection. Accessed atomically.
+    cVoxelOccupancyPtr m_occupancy;
+
+    //! Previously published occupancy pyramids, kept until no collision query uses them, so that they are never released by a collision query.
+    std::vector<cVoxelOccupancyPtr> m_retiredOccupancy;
+
+    //! Mutex serializing the threads that build or update the occupancy pyramid. It is never acquired by collision queries.
+    cMutex m_occupancyMutex;
+
+    //! If __true__, empty regions of the volume are skipped during collision detection.
+    bool m_useOccupancy;
+
+    //! Number of threads used for polygonization.
+    unsigned int m_numPolygonizationThreads;
+
+    //! Worker pool used for polygonization, or __NULL__ if single threaded.
+    cWorkerPool* m_polygonizationPool;
+
 
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS - SHADERS:
@@ -0,0 +1,764 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "world/CVoxelPolygonizer.h"
+//------------------------------------------------------------------------------
+#include "math/CMarchingCubes.h"
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <climits>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//! Describes an edge of a grid cell: node plane (0: bottom, 1: top, 2: between planes), node offset and direction (0: x, 1: y, 2: z).
+struct cVoxelPolygonizerEdge
+{
+    int m_plane;
+    int m_dx;
+    int m_dy;
+    int m_dir;
+};
+
+//! Edges of a grid cell, numbered as in the marching cubes tables.
+static const cVoxelPolygonizerEdge C_VOXEL_POLYGONIZER_EDGES[12] =
+{
+    { 0, 0, 0, 1 }, { 0, 0, 1, 0 }, { 0, 1, 0, 1 }, { 0, 0, 0, 0 },
+    { 1, 0, 0, 1 }, { 1, 0, 1, 0 }, { 1, 1, 0, 1 }, { 1, 0, 0, 0 },
+    { 2, 0, 0, 2 }, { 2, 0, 1, 2 }, { 2, 1, 1, 2 }, { 2, 1, 0, 2 }
+};
+
+//! Corners of a grid cell, numbered as in the marching cubes tables.
+static const int C_VOXEL_POLYGONIZER_CORNERS[8][3] =
+{
+    { 0, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 }, { 1, 0, 0 },
+    { 0, 0, 1 }, { 0, 1, 1 }, { 1, 1, 1 }, { 1, 0, 1 }
+};
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cVoxelPolygonizer.
+*/
+//==============================================================================
+cVoxelPolygonizer::cVoxelPolygonizer()
+{
+    m_image = NULL;
+    m_occupancy = nullptr;
+    m_workerPool = NULL;
+    m_isosurfaceValue = 0.5f;
+    m_threshold = 0;
+    for (int i=0; i<3; i++)
+    {
+        m_imageSize[i] = 0;
+        m_origin[i] = 0.0;
+        m_gridSize[i] = 0.0;
+        m_numCells[i] = 0;
+        m_cellMin[i] = 0;
+        m_cellMax[i] = -1;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method defines the volume to be polygonized and the sampling grid.
+    The volume spans the box [__a_minCorner__, __a_maxCorner__], onto which
+    the texture coordinates [__a_minTextureCoord__, __a_maxTextureCoord__]
+    of the image are mapped. \n
+
+    The grid covers the volume, padded by one cell on each side so that the
+    isosurface is closed along the border of the volume. A negative grid
+    size selects the size of a texel along the corresponding axis.
+
+    \param  a_image            Image to be polygonized.
+    \param  a_minCorner        Corner of the volume with minimum coordinates.
+    \param  a_maxCorner        Corner of the volume with maximum coordinates.
+    \param  a_minTextureCoord  Texture coordinate at the minimum corner.
+    \param  a_maxTextureCoord  Texture coordinate at the maximum corner.
+    \param  a_gridSize         Size of the cells of the grid along each axis.
+
+    \return __true__ if the grid is valid, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelPolygonizer::setGrid(cImage* a_image,
+                                const cVector3d& a_minCorner,
+                                const cVector3d& a_maxCorner,
+                                const cVector3d& a_minTextureCoord,
+                                const cVector3d& a_maxTextureCoord,
+                                const cVector3d& a_gridSize)
+{
+    m_image = a_image;
+    for (int i=0; i<3; i++)
+    {
+        m_numCells[i] = 0;
+        m_nodeVoxels[i].clear();
+    }
+
+    // sanity check
+    if (m_image == NULL)
+    {
+        return (false);
+    }
+
+    m_imageSize[0] = (int)(m_image->getWidth());
+    m_imageSize[1] = (int)(m_image->getHeight());
+    m_imageSize[2] = (int)(m_image->getImageCount());
+    if ((m_imageSize[0] == 0) || (m_imageSize[1] == 0) || (m_imageSize[2] == 0))
+    {
+        return (false);
+    }
+
+    cVector3d objectRange = a_maxCorner - a_minCorner;
+    cVector3d texRange = a_maxTextureCoord - a_minTextureCoord;
+
+    for (int i=0; i<3; i++)
+    {
+        // compute size of texels
+        double s = fabs(objectRange(i));
+        double st = s;
+        if (texRange(i) != 0.0)
+        {
+            st = cMin(s, (s / (texRange(i) * (double)(m_imageSize[i]))));
+        }
+
+        // compute grid size
+        m_gridSize[i] = (a_gridSize(i) < 0.0) ? st : a_gridSize(i);
+        if (m_gridSize[i] <= 0.0)
+        {
+            return (false);
+        }
+
+        // compute grid extent
+        double padding = cMax(st, m_gridSize[i]);
+        m_origin[i] = a_minCorner(i) - padding;
+        m_numCells[i] = cMax(1, (int)(ceil(((a_maxCorner(i) + padding) - m_origin[i]) / m_gridSize[i])));
+    }
+
+    // compute voxel sampled by each node
+    for (int i=0; i<3; i++)
+    {
+        m_nodeVoxels[i].resize(m_numCells[i] + 1);
+        for (int j=0; j<=m_numCells[i]; j++)
+        {
+            double p = m_origin[i] + (double)(j) * m_gridSize[i];
+            cVector3d texCoord = a_minTextureCoord;
+            if (objectRange(i) != 0.0)
+            {
+                texCoord(i) = a_minTextureCoord(i) + ((p - a_minCorner(i)) / objectRange(i) * texRange(i));
+            }
+
+            int voxel[3];
+            m_image->getVoxelLocation(texCoord, voxel[0], voxel[1], voxel[2], false);
+            m_nodeVoxels[i][j] = voxel[i];
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method computes the range of cells whose triangles may change when
+    the voxels located in a range are modified.
+
+    \param  a_voxelMin  Minimum voxel coordinates of the modified range.
+    \param  a_voxelMax  Maximum voxel coordinates of the modified range (inclusive).
+    \param  a_cellMin   Returned minimum cell coordinates.
+    \param  a_cellMax   Returned maximum cell coordinates (inclusive).
+
+    \return __true__ if at least one cell is affected, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelPolygonizer::getCellRange(const int a_voxelMin[3],
+                                     const int a_voxelMax[3],
+                                     int a_cellMin[3],
+                                     int a_cellMax[3]) const
+{
+    for (int i=0; i<3; i++)
+    {
+        a_cellMin[i] = INT_MAX;
+        a_cellMax[i] = -1;
+
+        // a node is shared by the cells on both sides of it
+        for (int j=0; j<=m_numCells[i]; j++)
+        {
+            int voxel = m_nodeVoxels[i][j];
+            if ((voxel >= a_voxelMin[i]) && (voxel <= a_voxelMax[i]))
+            {
+                a_cellMin[i] = cMin(a_cellMin[i], j - 1);
+                a_cellMax[i] = cMax(a_cellMax[i], j);
+            }
+        }
+
+        a_cellMin[i] = cMax(a_cellMin[i], 0);
+        a_cellMax[i] = cMin(a_cellMax[i], m_numCells[i] - 1);
+        if (a_cellMin[i] > a_cellMax[i])
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method polygonizes the entire grid and appends the resulting
+    vertices and triangles to a mesh.
+
+    \param  a_mesh  Mesh receiving the triangles.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelPolygonizer::polygonize(cMesh* a_mesh)
+{
+    int cellMin[3] = { 0, 0, 0 };
+    int cellMax[3] = { m_numCells[0] - 1, m_numCells[1] - 1, m_numCells[2] - 1 };
+
+    return (polygonize(a_mesh, cellMin, cellMax));
+}
+
+
+//==============================================================================
+/*!
+    This method polygonizes a range of cells and appends the resulting
+    vertices and triangles to a mesh. The range is clamped to the grid.
+
+    \param  a_mesh     Mesh receiving the triangles.
+    \param  a_cellMin  Minimum cell coordinates.
+    \param  a_cellMax  Maximum cell coordinates (inclusive).
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVoxelPolygonizer::polygonize(cMesh* a_mesh,
+                                   const int a_cellMin[3],
+                                   const int a_cellMax[3])
+{
+    // sanity check
+    if ((a_mesh == NULL) || (m_image == NULL) || (m_numCells[0] == 0))
+    {
+        return (false);
+    }
+
+    // clamp range to grid
+    for (int i=0; i<3; i++)
+    {
+        m_cellMin[i] = cMax(a_cellMin[i], 0);
+        m_cellMax[i] = cMin(a_cellMax[i], m_numCells[i] - 1);
+        if (m_cellMin[i] > m_cellMax[i])
+        {
+            return (true);
+        }
+    }
+
+    // compute smallest alpha value reaching the isosurface
+    m_threshold = 0;
+    while ((m_threshold < 256) && (cColorBtoF((GLubyte)(m_threshold)) < m_isosurfaceValue))
+    {
+        m_threshold++;
+    }
+
+    // polygonize slabs
+    unsigned int numLayers = (unsigned int)(m_cellMax[2] - m_cellMin[2] + 1);
+    unsigned int numSlabs = (numLayers + C_VOXEL_POLYGONIZER_SLAB_SIZE - 1) / C_VOXEL_POLYGONIZER_SLAB_SIZE;
+    m_slabs.clear();
+    m_slabs.resize(numSlabs);
+
+    if (m_workerPool != NULL)
+    {
+        m_workerPool->execute(polygonizeSlabsTask, this, numSlabs, 1);
+    }
+    else
+    {
+        polygonizeSlabsTask(this, 0, numSlabs);
+    }
+
+    // weld slabs into mesh
+    mergeSlabs(a_mesh);
+    m_slabs.clear();
+
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method polygonizes the slabs in the range [__a_begin__, __a_end__).
+
+    \param  a_polygonizer  Polygonizer.
+    \param  a_begin        First slab.
+    \param  a_end          Slab following the last slab.
+*/
+//==============================================================================
+void cVoxelPolygonizer::polygonizeSlabsTask(void* a_polygonizer,
+                                            const unsigned int a_begin,
+                                            const unsigned int a_end)
+{
+    cVoxelPolygonizer* polygonizer = (cVoxelPolygonizer*)a_polygonizer;
+    for (unsigned int i=a_begin; i<a_end; i++)
+    {
+        polygonizer->polygonizeSlab(i);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method polygonizes one slab of cells. Cell layers are processed one
+    after the other, keeping the node values and the vertices of the two
+    node planes bounding the current layer. Nodes are sampled on demand, and
+    the vertex of each edge is created once and shared by all cells adjacent
+    to that edge.
+
+    \param  a_slab  Slab index.
+*/
+//==============================================================================
+void cVoxelPolygonizer::polygonizeSlab(const unsigned int a_slab)
+{
+    cVoxelPolygonizerSlab& slab = m_slabs[a_slab];
+
+    // range of cells of the slab
+    int minZ = m_cellMin[2] + (int)(a_slab) * C_VOXEL_POLYGONIZER_SLAB_SIZE;
+    int maxZ = cMin(minZ + C_VOXEL_POLYGONIZER_SLAB_SIZE - 1, m_cellMax[2]);
+    int numCellsX = m_cellMax[0] - m_cellMin[0] + 1;
+    int numCellsY = m_cellMax[1] - m_cellMin[1] + 1;
+    int numNodesX = numCellsX + 1;
+    int numNodesY = numCellsY + 1;
+    int numNodes = numNodesX * numNodesY;
+
+    // find tiles that may intersect the isosurface
+    int numTilesX = (numCellsX + C_VOXEL_POLYGONIZER_SLAB_SIZE - 1) / C_VOXEL_POLYGONIZER_SLAB_SIZE;
+    int numTilesY = (numCellsY + C_VOXEL_POLYGONIZER_SLAB_SIZE - 1) / C_VOXEL_POLYGONIZER_SLAB_SIZE;
+    std::vector<char> tiles(numTilesX * numTilesY, 1);
+    bool empty = true;
+
+    int voxelMin[3], voxelMax[3];
+    getVoxelRange(2, minZ, maxZ + 1, voxelMin[2], voxelMax[2]);
+    for (int ty=0; ty<numTilesY; ty++)
+    {
+        int y0 = m_cellMin[1] + ty * C_VOXEL_POLYGONIZER_SLAB_SIZE;
+        int y1 = cMin(y0 + C_VOXEL_POLYGONIZER_SLAB_SIZE, m_cellMax[1] + 1);
+        getVoxelRange(1, y0, y1, voxelMin[1], voxelMax[1]);
+
+        for (int tx=0; tx<numTilesX; tx++)
+        {
+            int x0 = m_cellMin[0] + tx * C_VOXEL_POLYGONIZER_SLAB_SIZE;
+            int x1 = cMin(x0 + C_VOXEL_POLYGONIZER_SLAB_SIZE, m_cellMax[0] + 1);
+            getVoxelRange(0, x0, x1, voxelMin[0], voxelMax[0]);
+
+            if ((m_occupancy != nullptr) && (!m_occupancy->isOccupied(voxelMin, voxelMax, m_threshold)))
+            {
+                tiles[tx + ty * numTilesX] = 0;
+            }
+            else
+            {
+                empty = false;
+            }
+        }
+    }
+
+    if (empty)
+    {
+        return;
+    }
+
+    // node values of the bottom and top planes of the current layer (negative if not sampled yet)
+    std::vector<float> values[2];
+    values[0].assign(numNodes, -1.0f);
+    values[1].assign(numNodes, -1.0f);
+
+    // vertices on the x and y edges of the bottom and top planes, and on the z edges of the current layer
+    std::vector<int> vertices[3];
+    vertices[0].assign(2 * numNodes, -1);
+    vertices[1].assign(2 * numNodes, -1);
+    vertices[2].assign(numNodes, -1);
+
+    float isosurfaceValue = m_isosurfaceValue;
+
+    for (int z=minZ; z<=maxZ; z++)
+    {
+        for (int y=0; y<numCellsY; y++)
+        {
+            int tileY = (y / C_VOXEL_POLYGONIZER_SLAB_SIZE) * numTilesX;
+
+            for (int x=0; x<numCellsX; x++)
+            {
+                // skip empty tiles
+                if (tiles[tileY + (x / C_VOXEL_POLYGONIZER_SLAB_SIZE)] == 0)
+                {
+                    continue;
+                }
+
+                // get cell values
+                int cubeIndex = 0;
+                for (int i=0; i<8; i++)
+                {
+                    const int* corner = C_VOXEL_POLYGONIZER_CORNERS[i];
+                    int node = (x + corner[0]) + (y + corner[1]) * numNodesX;
+                    float& value = values[corner[2]][node];
+                    if (value < 0.0f)
+                    {
+                        value = getNodeValue(m_cellMin[0] + x + corner[0],
+                                             m_cellMin[1] + y + corner[1],
+                                             z + corner[2]);
+                    }
+                    if (value < isosurfaceValue)
+                    {
+                        cubeIndex |= (1 << i);
+                    }
+                }
+
+                // cell is entirely inside or outside of the surface
+                int edges = C_MARCHING_CUBES_EDGE_TABLE[cubeIndex];
+                if (edges == 0)
+                {
+                    continue;
+                }
+
+                // find or create the vertices where the surface intersects the cell
+                int cellVertices[12];
+                for (int i=0; i<12; i++)
+                {
+                    if ((edges & (1 << i)) == 0)
+                    {
+                        continue;
+                    }
+
+                    const cVoxelPolygonizerEdge& edge = C_VOXEL_POLYGONIZER_EDGES[i];
+                    int node = (x + edge.m_dx) + (y + edge.m_dy) * numNodesX;
+                    int& vertex = (edge.m_plane < 2) ? vertices[edge.m_plane][2 * node + edge.m_dir] : vertices[2][node];
+                    if (vertex < 0)
+                    {
+                        // endpoints of the edge
+                        int n0[3] = { x + edge.m_dx, y + edge.m_dy, (edge.m_plane == 1) ? 1 : 0 };
+                        int n1[3] = { n0[0], n0[1], n0[2] };
+                        n1[edge.m_dir]++;
+
+                        int node0 = n0[0] + n0[1] * numNodesX;
+                        int node1 = n1[0] + n1[1] * numNodesX;
+
+                        cVector3d p0(m_origin[0] + (double)(m_cellMin[0] + n0[0]) * m_gridSize[0],
+                                     m_origin[1] + (double)(m_cellMin[1] + n0[1]) * m_gridSize[1],
+                                     m_origin[2] + (double)(z + n0[2]) * m_gridSize[2]);
+                        cVector3d p1(m_origin[0] + (double)(m_cellMin[0] + n1[0]) * m_gridSize[0],
+                                     m_origin[1] + (double)(m_cellMin[1] + n1[1]) * m_gridSize[1],
+                                     m_origin[2] + (double)(z + n1[2]) * m_gridSize[2]);
+
+                        vertex = (int)(slab.m_vertices.size());
+                        slab.m_vertices.push_back(cVertexInterpolation(isosurfaceValue, p0, p1,
+                                                                       values[n0[2]][node0],
+                                                                       values[n1[2]][node1]));
+                    }
+                    cellVertices[i] = vertex;
+                }
+
+                // create the triangles, in counter-clockwise order
+                const int* triangles = C_MARCHING_CUBES_TRIANGLE_TABLE[cubeIndex];
+                for (int i=0; triangles[i] != -1; i+=3)
+                {
+                    slab.m_triangles.push_back(cellVertices[triangles[i + 2]]);
+                    slab.m_triangles.push_back(cellVertices[triangles[i + 1]]);
+                    slab.m_triangles.push_back(cellVertices[triangles[i]]);
+                }
+            }
+        }
+
+        // store the vertices of the bottom plane of the slab
+        if (z == minZ)
+        {
+            for (int i=0; i<2*numNodes; i++)
+            {
+                if (vertices[0][i] >= 0)
+                {
+                    slab.m_bottomVertices.push_back(i);
+                    slab.m_bottomVertices.push_back(vertices[0][i]);
+                }
+            }
+        }
+
+        // move to next layer
+        values[0].swap(values[1]);
+        values[1].assign(numNodes, -1.0f);
+        vertices[0].swap(vertices[1]);
+        vertices[1].assign(2 * numNodes, -1);
+        vertices[2].assign(numNodes, -1);
+    }
+
+    // store the vertices of the top plane of the slab
+    for (int i=0; i<2*numNodes; i++)
+    {
+        if (vertices[0][i] >= 0)
+        {
+            slab.m_topVertices.push_back(i);
+            slab.m_topVertices.push_back(vertices[0][i]);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method merges the slabs into a mesh. Every vertex located on the
+    top plane of a slab is replaced by the matching vertex on the bottom
+    plane of the next slab. Vertex normals are averaged from the normals of
+    the adjacent triangles.
+
+    \param  a_mesh  Mesh receiving the triangles.
+*/
+//==============================================================================
+void cVoxelPolygonizer::mergeSlabs(cMesh* a_mesh)
+{
+    unsigned int numSlabs = (unsigned int)(m_slabs.size());
+    const unsigned int C_SHARED = UINT_MAX;
+
+    // mark the vertices shared with the next slab
+    for (unsigned int i=0; i<numSlabs; i++)
+    {
+        cVoxelPolygonizerSlab& slab = m_slabs[i];
+        slab.m_indices.assign(slab.m_vertices.size(), 0);
+
+        if (i + 1 < numSlabs)
+        {
+            std::vector<int>& top = slab.m_topVertices;
+            std::vector<int>& bottom = m_slabs[i + 1].m_bottomVertices;
+            size_t j = 0, k = 0;
+            while ((j < top.size()) && (k < bottom.size()))
+            {
+                if (top[j] < bottom[k])
+                {
+                    j += 2;
+                }
+                else if (top[j] > bottom[k])
+                {
+                    k += 2;
+                }
+                else
+                {
+                    slab.m_indices[top[j + 1]] = C_SHARED;
+                    j += 2;
+                    k += 2;
+                }
+            }
+        }
+    }
+
+    // assign mesh indices to all other vertices
+    unsigned int base = a_mesh->getNumVertices();
+    unsigned int numVertices = 0;
+    for (unsigned int i=0; i<numSlabs; i++)
+    {
+        cVoxelPolygonizerSlab& slab = m_slabs[i];
+        for (size_t j=0; j<slab.m_indices.size(); j++)
+        {
+            if (slab.m_indices[j] != C_SHARED)
+            {
+                slab.m_indices[j] = numVertices++;
+            }
+        }
+    }
+
+    // resolve shared vertices
+    for (unsigned int i=0; i+1<numSlabs; i++)
+    {
+        cVoxelPolygonizerSlab& slab = m_slabs[i];
+        cVoxelPolygonizerSlab& next = m_slabs[i + 1];
+        std::vector<int>& top = slab.m_topVertices;
+        std::vector<int>& bottom = next.m_bottomVertices;
+        size_t j = 0, k = 0;
+        while ((j < top.size()) && (k < bottom.size()))
+        {
+            if (top[j] < bottom[k])
+            {
+                j += 2;
+            }
+            else if (top[j] > bottom[k])
+            {
+                k += 2;
+            }
+            else
+            {
+                slab.m_indices[top[j + 1]] = next.m_indices[bottom[k + 1]];
+                j += 2;
+                k += 2;
+            }
+        }
+    }
+
+    // compute vertex normals
+    std::vector<cVector3d> normals(numVertices, cVector3d(0.0, 0.0, 0.0));
+    for (unsigned int i=0; i<numSlabs; i++)
+    {
+        cVoxelPolygonizerSlab& slab = m_slabs[i];
+        for (size_t j=0; j<slab.m_triangles.size(); j+=3)
+        {
+            unsigned int v0 = slab.m_triangles[j];
+            unsigned int v1 = slab.m_triangles[j + 1];
+            unsigned int v2 = slab.m_triangles[j + 2];
+
+            cVector3d normal = cCross(slab.m_vertices[v1] - slab.m_vertices[v0],
+                                      slab.m_vertices[v2] - slab.m_vertices[v0]);
+            double length = normal.length();
+            if (length > 0.0)
+            {
+                normal.div(length);
+                normals[slab.m_indices[v0]].add(normal);
+                normals[slab.m_indices[v1]].add(normal);
+                normals[slab.m_indices[v2]].add(normal);
+            }
+        }
+    }
+
+    // gather vertex positions
+    std::vector<cVector3d> positions(numVertices);
+    for (unsigned int i=0; i<numSlabs; i++)
+    {
+        cVoxelPolygonizerSlab& slab = m_slabs[i];
+        for (size_t j=0; j<slab.m_vertices.size(); j++)
+        {
+            positions[slab.m_indices[j]] = slab.m_vertices[j];
+        }
+    }
+
+    // create vertices
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        if (normals[i].length() > 0.000000001)
+        {
+            normals[i].normalize();
+        }
+        a_mesh->newVertex(positions[i], normals[i]);
+    }
+
+    // create triangles
+    for (unsigned int i=0; i<numSlabs; i++)
+    {
+        cVoxelPolygonizerSlab& slab = m_slabs[i];
+        for (size_t j=0; j<slab.m_triangles.size(); j+=3)
+        {
+            a_mesh->newTriangle(base + slab.m_indices[slab.m_triangles[j]],
+                                base + slab.m_indices[slab.m_triangles[j + 1]],
+                                base + slab.m_indices[slab.m_triangles[j + 2]]);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the alpha value of the voxel sampled at a node of
+    the grid. Voxels located outside of the image have a value of zero.
+
+    \param  a_x  Node index along the __x__-axis.
+    \param  a_y  Node index along the __y__-axis.
+    \param  a_z  Node index along the __z__-axis.
+
+    \return Value of the node.
+*/
+//==============================================================================
+float cVoxelPolygonizer::getNodeValue(const int a_x, const int a_y, const int a_z) const
+{
+    int x = m_nodeVoxels[0][a_x];
+    int y = m_nodeVoxels[1][a_y];
+    int z = m_nodeVoxels[2][a_z];
+
+    if ((x < 0) || (x >= m_imageSize[0]) ||
+        (y < 0) || (y >= m_imageSize[1]) ||
+        (z < 0) || (z >= m_imageSize[2]))
+    {
+        return (0.0f);
+    }
+
+    cColorb color;
+    m_image->getVoxelColor(x, y, z, color);
+
+    return (cColorBtoF(color.getA()));
+}
+
+
+//==============================================================================
+/*!
+    This method returns the range of voxels sampled by a range of nodes
+    along an axis.
+
+    \param  a_axis      Axis.
+    \param  a_nodeMin   First node.
+    \param  a_nodeMax   Last node (inclusive).
+    \param  a_voxelMin  Returned smallest voxel coordinate.
+    \param  a_voxelMax  Returned largest voxel coordinate.
+*/
+//==============================================================================
+void cVoxelPolygonizer::getVoxelRange(const int a_axis,
+                                      const int a_nodeMin,
+                                      const int a_nodeMax,
+                                      int& a_voxelMin,
+                                      int& a_voxelMax) const
+{
+    a_voxelMin = INT_MAX;
+    a_voxelMax = INT_MIN;
+    for (int i=a_nodeMin; i<=a_nodeMax; i++)
+    {
+        a_voxelMin = cMin(a_voxelMin, m_nodeVoxels[a_axis][i]);
+        a_voxelMax = cMax(a_voxelMax, m_nodeVoxels[a_axis][i]);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,275 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Francois Conti
+    \version   3.2.0 $Rev$
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CVoxelPolygonizerH
+#define CVoxelPolygonizerH
+//------------------------------------------------------------------------------
+#include "collisions/CVoxelOccupancy.h"
+#include "graphics/CImage.h"
+#include "system/CWorkerPool.h"
+#include "world/CMesh.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CVoxelPolygonizer.h
+    \ingroup    world
+
+    \brief
+    Implements a parallel marching cubes polygonizer for voxel volumes.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+//! Number of cell layers processed by a single task of the polygonizer. This is also the edge length, in cells, of the tiles used to skip empty space.
+const int C_VOXEL_POLYGONIZER_SLAB_SIZE = 8;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \struct     cVoxelPolygonizerSlab
+    \ingroup    world
+
+    \brief
+    This structure stores the output of the polygonizer for one slab of cells.
+*/
+//==============================================================================
+struct cVoxelPolygonizerSlab
+{
+    //! Vertices created by the slab.
+    std::vector<cVector3d> m_vertices;
+
+    //! Triangles created by the slab, given as triplets of indices into __m_vertices__.
+    std::vector<unsigned int> m_triangles;
+
+    //! Vertices located on the bottom plane of the slab, given as pairs of edge and vertex indices sorted by edge.
+    std::vector<int> m_bottomVertices;
+
+    //! Vertices located on the top plane of the slab, given as pairs of edge and vertex indices sorted by edge.
+    std::vector<int> m_topVertices;
+
+    //! Index of each vertex in the output mesh, assigned when the slabs are merged.
+    std::vector<unsigned int> m_indices;
+};
+
+
+//==============================================================================
+/*!
+    \class      cVoxelPolygonizer
+    \ingroup    world
+
+    \brief
+    This class implements a parallel marching cubes polygonizer for voxel
+    volumes.
+
+    \details
+    The polygonizer samples the alpha channel of a 3D image on a regular
+    grid of nodes and extracts the isosurface with the marching cubes
+    algorithm. Each node is sampled at most once per slab, and the vertex
+    created on an edge of the grid is shared by all cells adjacent to that
+    edge, so that the resulting mesh is indexed and welded. Vertex normals
+    are averaged from the normals of the adjacent triangles. \n
+
+    Cells are processed in slabs of C_VOXEL_POLYGONIZER_SLAB_SIZE layers
+    along the __z__-axis, which are distributed to the threads of a
+    \ref cWorkerPool when one is assigned. Vertices shared by two adjacent
+    slabs are welded when the slabs are merged. Slab boundaries do not
+    depend on the number of threads, hence the resulting mesh is identical
+    however many threads are used. \n
+
+    When an occupancy pyramid is assigned, tiles of cells in which no voxel
+    reaches the isosurface value are skipped without being sampled. \n
+
+    Polygonization can be restricted to a range of cells. Since the grid
+    only depends on the volume and on the grid size, meshes polygonized
+    from adjacent ranges of cells meet exactly along their common border.
+*/
+//==============================================================================
+class cVoxelPolygonizer
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cVoxelPolygonizer.
+    cVoxelPolygonizer();
+
+    //! Destructor of cVoxelPolygonizer.
+    virtual ~cVoxelPolygonizer() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method defines the volume and the sampling grid.
+    bool setGrid(cImage* a_image,
+                 const cVector3d& a_minCorner,
+                 const cVector3d& a_maxCorner,
+                 const cVector3d& a_minTextureCoord,
+                 const cVector3d& a_maxTextureCoord,
+                 const cVector3d& a_gridSize);
+
+    //! This method sets the isosurface value.
+    void setIsosurfaceValue(const float a_isosurfaceValue) { m_isosurfaceValue = a_isosurfaceValue; }
+
+    //! This method returns the isosurface value.
+    float getIsosurfaceValue() const { return (m_isosurfaceValue); }
+
+    //! This method sets the occupancy pyramid used to skip empty space (__nullptr__ to disable).
+    void setOccupancy(cVoxelOccupancyPtr a_occupancy) { m_occupancy = a_occupancy; }
+
+    //! This method sets the worker pool used to process slabs in parallel (__NULL__ to use the calling thread only).
+    void setWorkerPool(cWorkerPool* a_workerPool) { m_workerPool = a_workerPool; }
+
+    //! This method returns the number of cells of the grid along axis __a_axis__.
+    int getNumCells(const int a_axis) const { return (m_numCells[a_axis]); }
+
+    //! This method computes the range of cells affected by a modification of a range of voxels.
+    bool getCellRange(const int a_voxelMin[3],
+                      const int a_voxelMax[3],
+                      int a_cellMin[3],
+                      int a_cellMax[3]) const;
+
+    //! This method polygonizes the entire grid and appends the triangles to a mesh.
+    bool polygonize(cMesh* a_mesh);
+
+    //! This method polygonizes a range of cells and appends the triangles to a mesh.
+    bool polygonize(cMesh* a_mesh,
+                    const int a_cellMin[3],
+                    const int a_cellMax[3]);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method polygonizes a range of slabs.
+    static void polygonizeSlabsTask(void* a_polygonizer,
+                                    const unsigned int a_begin,
+                                    const unsigned int a_end);
+
+    //! This method polygonizes a slab.
+    void polygonizeSlab(const unsigned int a_slab);
+
+    //! This method merges the slabs into a mesh.
+    void mergeSlabs(cMesh* a_mesh);
+
+    //! This method returns the value sampled at a node of the grid.
+    float getNodeValue(const int a_x, const int a_y, const int a_z) const;
+
+    //! This method returns the range of voxels sampled by a range of nodes along an axis.
+    void getVoxelRange(const int a_axis,
+                       const int a_nodeMin,
+                       const int a_nodeMax,
+                       int& a_voxelMin,
+                       int& a_voxelMax) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Image being polygonized.
+    cImage* m_image;
+
+    //! Number of voxels along each axis of the image.
+    int m_imageSize[3];
+
+    //! Occupancy pyramid of the image, or __nullptr__.
+    cVoxelOccupancyPtr m_occupancy;
+
+    //! Worker pool, or __NULL__.
+    cWorkerPool* m_workerPool;
+
+    //! Isosurface value.
+    float m_isosurfaceValue;
+
+    //! Smallest alpha value reaching the isosurface value.
+    int m_threshold;
+
+    //! Position of the first node of the grid.
+    double m_origin[3];
+
+    //! Size of the cells of the grid.
+    double m_gridSize[3];
+
+    //! Number of cells along each axis.
+    int m_numCells[3];
+
+    //! Voxel sampled by each node along each axis.
+    std::vector<int> m_nodeVoxels[3];
+
+    //! First cell of the range being polygonized.
+    int m_cellMin[3];
+
+    //! Last cell of the range being polygonized.
+    int m_cellMax[3];
+
+    //! Slabs of the range being polygonized.
+    std::vector<cVoxelPolygonizerSlab> m_slabs;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
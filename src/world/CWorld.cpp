@@ -46,6 +46,8 @@
 //------------------------------------------------------------------------------
 #include "lighting/CSpotLight.h"
 //------------------------------------------------------------------------------
+#include <algorithm>
+//------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
@@ -73,6 +75,13 @@ cWorld::cWorld()
     // use shadow maps
     m_useShadowCasting = true;
 
+    // frustum culling is disabled
+    m_useFrustumCulling = false;
+
+    // broadphase is disabled
+    m_useBroadphase = false;
+    m_broadphaseChildrenVersion = 0;
+
     // initialize matrix
     memset(m_worldModelView, 0, sizeof(m_worldModelView));
 }
@@ -414,6 +423,53 @@ bool cWorld::computeCollisionDetection(const cVector3d& a_segmentPointA,
     // temp variable
     bool hit = false;
 
+    // check for collisions with the children selected by the broadphase
+    if (m_useBroadphase)
+    {
+        std::vector<int> candidates;
+
+        m_broadphaseMutex.acquire();
+
+        // the broadphase is only valid if no child was added or removed since its last update
+        bool valid = (m_broadphaseChildrenVersion == m_childrenVersion) &&
+                     (m_broadphaseProxies.size() == m_children.size());
+        if (valid)
+        {
+            m_broadphase.computeSegmentOverlaps(a_segmentPointA,
+                                                a_segmentPointB,
+                                                a_settings.m_collisionRadius,
+                                                candidates);
+
+            candidates.insert(candidates.end(), m_broadphaseUnbounded.begin(), m_broadphaseUnbounded.end());
+
+            // moving objects adjust the segment, which may then leave their box
+            if (a_settings.m_adjustObjectMotion)
+            {
+                candidates.insert(candidates.end(), m_broadphaseMoving.begin(), m_broadphaseMoving.end());
+            }
+        }
+
+        m_broadphaseMutex.release();
+
+        if (valid)
+        {
+            // visit candidates in the order of the children
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+            unsigned int nCandidates = (unsigned int)(candidates.size());
+            for (unsigned int i=0; i<nCandidates; i++)
+            {
+                hit = hit | m_children[candidates[i]]->computeCollisionDetection(a_segmentPointA,
+                                                                                a_segmentPointB,
+                                                                                a_recorder,
+                                                                                a_settings);
+            }
+
+            return (hit);
+        }
+    }
+
     // check for collisions with all children of this world
     unsigned int nChildren = (int)(m_children.size());
     for (unsigned int i=0; i<nChildren; i++)
@@ -429,6 +485,174 @@ bool cWorld::computeCollisionDetection(const cVector3d& a_segmentPointA,
 }
 
 
+//==============================================================================
+/*!
+    This method enables or disables the broadphase. When enabled, collision
+    detection only visits the children of this world whose boxes are crossed
+    by the segment, and the broadphase is updated every time
+    computeGlobalPositions() is called.
+
+    \param  a_useBroadphase  If __true__ then the broadphase is enabled.
+*/
+//==============================================================================
+void cWorld::setUseBroadphase(const bool a_useBroadphase)
+{
+    m_useBroadphase = a_useBroadphase;
+
+    if (m_useBroadphase)
+    {
+        updateBroadphase();
+    }
+    else
+    {
+        m_broadphaseUpdateMutex.acquire();
+        m_broadphaseMutex.acquire();
+        m_broadphase.clear();
+        m_broadphaseProxies.clear();
+        m_broadphaseUnbounded.clear();
+        m_broadphaseMoving.clear();
+        m_broadphaseMutex.release();
+        m_broadphaseStates.clear();
+        m_broadphaseUpdateMutex.release();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method updates the broadphase from the current boxes of the children
+    of this world. The method is called by computeGlobalPositions(), and only
+    needs to be called explicitly if objects are moved or modified between a
+    call to computeGlobalPositions() and a collision query. \n
+
+    The boxes are computed without holding the mutex used by collision
+    queries, which is only held to update the proxies of the children whose
+    box has changed and to publish the lists of unbounded and moving
+    children. Children whose box is unchanged keep their place in the tree.
+    Children that cannot be bounded are always visited, and children that
+    have moved during the last call to computeGlobalPositions() are always
+    visited when motion adjustment is enabled in the collision settings.
+*/
+//==============================================================================
+void cWorld::updateBroadphase()
+{
+    if (!m_useBroadphase) { return; }
+
+    m_broadphaseUpdateMutex.acquire();
+
+    // register children again if children were added or removed
+    int numChildren = (int)(m_children.size());
+    bool reset = (m_broadphaseChildrenVersion != m_childrenVersion) ||
+                 (m_broadphaseProxies.size() != m_children.size());
+    if (reset)
+    {
+        m_broadphaseStates.assign(numChildren, 0);
+        m_broadphaseBoxMin.resize(numChildren);
+        m_broadphaseBoxMax.resize(numChildren);
+    }
+
+    m_broadphaseChanged.clear();
+    m_broadphaseNewUnbounded.clear();
+    m_broadphaseNewMoving.clear();
+
+    // compute box of each child in world coordinates, and keep those which have changed
+    for (int i=0; i<numChildren; i++)
+    {
+        cVector3d boxMin( C_LARGE, C_LARGE, C_LARGE);
+        cVector3d boxMax(-C_LARGE,-C_LARGE,-C_LARGE);
+        bool moving = false;
+        bool bounded = encloseCollisionBoundaryBox(m_children[i], boxMin, boxMax, moving);
+        bool empty = (boxMin(0) > boxMax(0)) || (boxMin(1) > boxMax(1)) || (boxMin(2) > boxMax(2));
+
+        unsigned char state = !bounded ? 2 : (empty ? 0 : 1);
+        if (reset ||
+            (state != m_broadphaseStates[i]) ||
+            ((state == 1) && (!boxMin.equals(m_broadphaseBoxMin[i]) || !boxMax.equals(m_broadphaseBoxMax[i]))))
+        {
+            m_broadphaseStates[i] = state;
+            m_broadphaseBoxMin[i] = boxMin;
+            m_broadphaseBoxMax[i] = boxMax;
+            m_broadphaseChanged.push_back(i);
+        }
+
+        if (!bounded)
+        {
+            m_broadphaseNewUnbounded.push_back(i);
+        }
+        else if (!empty && moving)
+        {
+            m_broadphaseNewMoving.push_back(i);
+        }
+    }
+
+    // update proxies of modified children
+    m_broadphaseMutex.acquire();
+
+    if (reset)
+    {
+        m_broadphase.clear();
+        m_broadphaseChildrenVersion = m_childrenVersion;
+        m_broadphaseProxies.assign(numChildren, -1);
+    }
+
+    int numChanged = (int)(m_broadphaseChanged.size());
+    for (int k=0; k<numChanged; k++)
+    {
+        int i = m_broadphaseChanged[k];
+        int& proxy = m_broadphaseProxies[i];
+
+        // child is always tested, or can never collide
+        if (m_broadphaseStates[i] != 1)
+        {
+            if (proxy != -1)
+            {
+                m_broadphase.destroyProxy(proxy);
+                proxy = -1;
+            }
+        }
+
+        // insert or move proxy
+        else if (proxy == -1)
+        {
+            proxy = m_broadphase.createProxy(m_broadphaseBoxMin[i], m_broadphaseBoxMax[i], i);
+        }
+        else
+        {
+            m_broadphase.moveProxy(proxy, m_broadphaseBoxMin[i], m_broadphaseBoxMax[i]);
+        }
+    }
+
+    m_broadphaseUnbounded.swap(m_broadphaseNewUnbounded);
+    m_broadphaseMoving.swap(m_broadphaseNewMoving);
+
+    m_broadphaseMutex.release();
+
+    m_broadphaseUpdateMutex.release();
+}
+
+
+//==============================================================================
+/*!
+    This method computes the global position and rotation of this world and
+    its children, then updates the broadphase if it is enabled.
+
+    \param  a_frameOnly  If __true__ then only the global frame is computed.
+    \param  a_globalPos  Global position of parent object.
+    \param  a_globalRot  Global rotation matrix of parent object.
+*/
+//==============================================================================
+void cWorld::computeGlobalPositions(const bool a_frameOnly,
+                                    const cVector3d& a_globalPos,
+                                    const cMatrix3d& a_globalRot)
+{
+    // compute global positions
+    cGenericObject::computeGlobalPositions(a_frameOnly, a_globalPos, a_globalRot);
+
+    // update broadphase
+    updateBroadphase();
+}
+
+
 //==============================================================================
 /*!
     This method update interaction information between a tool and this world.
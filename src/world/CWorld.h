@@ -45,11 +45,13 @@
 #ifndef CWorldH
 #define CWorldH
 //------------------------------------------------------------------------------
+#include "collisions/CCollisionBroadphase.h"
 #include "display/CCamera.h"
 #include "graphics/CColor.h"
 #include "graphics/CTriangleArray.h"
 #include "graphics/CFog.h"
 #include "materials/CTexture2d.h"
+#include "system/CMutex.h"
 #include "world/CGenericObject.h"
 //------------------------------------------------------------------------------
 #include <vector>
@@ -86,7 +88,18 @@ class cShadowMap;
 
     \details
     cWorld defines the root of node the CHAI3D scene graph. It stores 
-    lights, cameras, tools, and objects.
+    lights, cameras, tools, and objects. \n
+
+    When the broadphase is enabled (see setUseBroadphase()), the boxes of the
+    children of the world are stored in a \ref cCollisionBroadphase tree that
+    is updated by computeGlobalPositions(). Collision detection then only
+    visits the children whose boxes are crossed by the segment. The boxes are
+    computed by cGenericObject::computeCollisionBoundaryBox(); objects that
+    implement their own collision detection must override that method, or
+    they may be skipped. The broadphase detects added or removed children
+    through cGenericObject::getChildrenVersion(), so children must be 
+    modified with addChild() and removeChild() rather than by editing 
+    \ref m_children directly.
 */
 //==============================================================================
 class cWorld : public cGenericObject
@@ -154,6 +167,30 @@ public:
                                          const cVector3d& a_toolVel,
                                          const unsigned int a_IDN);
 
+    //! This method enables or disables the broadphase that culls the children of this world during collision detection.
+    void setUseBroadphase(const bool a_useBroadphase);
+
+    //! This method returns __true__ if the broadphase is enabled, __false__ otherwise.
+    bool getUseBroadphase() const { return (m_useBroadphase); }
+
+    //! This method updates the broadphase from the current boxes of the children of this world.
+    void updateBroadphase();
+
+    //! This method returns the broadphase tree.
+    const cCollisionBroadphase& getBroadphase() const { return (m_broadphase); }
+
+
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - COMPUTING GLOBAL POSITIONS:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method computes the global position and rotation of this world and its children, and updates the broadphase.
+    virtual void computeGlobalPositions(const bool a_frameOnly = true,
+                                        const cVector3d& a_globalPos = cVector3d(0.0, 0.0, 0.0),
+                                        const cMatrix3d& a_globalRot = cIdentity3d());
+
 
     //-----------------------------------------------------------------------
     // PUBLIC METHODS - SHADOW CASTING:
@@ -178,6 +215,19 @@ public:
                                   const bool a_mirrorY = false);
 
 
+    //-----------------------------------------------------------------------
+    // PUBLIC METHODS - FRUSTUM CULLING:
+    //-----------------------------------------------------------------------
+
+public:
+
+    //! This method enables or disables the culling of objects located outside of the view frustum of cameras and light sources. Disabled by default, since the boundary boxes of meshes deformed by the application must be kept up to date.
+    void setUseFrustumCulling(bool a_enabled) { m_useFrustumCulling = a_enabled; }
+
+    //! This method returns __true__ if frustum culling is enabled, __false__ otherwise.
+    bool getUseFrustumCulling() const { return (m_useFrustumCulling); }
+
+
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
     //--------------------------------------------------------------------------
@@ -240,6 +290,51 @@ protected:
 
     //! If __true__ then shadow maps are used.
     bool m_useShadowCasting;
+
+    //! If __true__ then objects located outside of the view frustum are not rendered.
+    bool m_useFrustumCulling;
+
+    //! If __true__ then collision detection only visits the children whose boxes are crossed by the segment.
+    bool m_useBroadphase;
+
+    //! Broadphase tree storing the boxes of the children of this world.
+    cCollisionBroadphase m_broadphase;
+
+    //! Value of \ref m_childrenVersion when the broadphase was last updated.
+    unsigned int m_broadphaseChildrenVersion;
+
+    //! Broadphase proxy of each child, or -1 if the child has no proxy.
+    std::vector<int> m_broadphaseProxies;
+
+    //! Children that cannot be bounded, and are always tested.
+    std::vector<int> m_broadphaseUnbounded;
+
+    //! Children that are moving, and are always tested when motion adjustment is enabled.
+    std::vector<int> m_broadphaseMoving;
+
+    //! Mutex protecting the broadphase between the haptic and graphic threads.
+    cMutex m_broadphaseMutex;
+
+    //! Mutex serializing updates of the broadphase, so that boxes are computed without blocking collision queries.
+    cMutex m_broadphaseUpdateMutex;
+
+    //! State of each child at the last update: 0 if it has no box, 1 if it is bounded, 2 if it cannot be bounded.
+    std::vector<unsigned char> m_broadphaseStates;
+
+    //! Minimum point of the box of each bounded child at the last update.
+    std::vector<cVector3d> m_broadphaseBoxMin;
+
+    //! Maximum point of the box of each bounded child at the last update.
+    std::vector<cVector3d> m_broadphaseBoxMax;
+
+    //! Children whose state or box has changed during the current update.
+    std::vector<int> m_broadphaseChanged;
+
+    //! Children that cannot be bounded, computed during the current update.
+    std::vector<int> m_broadphaseNewUnbounded;
+
+    //! Children that are moving, computed during the current update.
+    std::vector<int> m_broadphaseNewMoving;
 };
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,2288 @@
+//===========================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+
+    \author    <http://www.chai3d.org>
+    \version   3.2.0 $Rev: 2177 $
+*/
+//===========================================================================
+
+//---------------------------------------------------------------------------
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <sstream>
+using namespace std;
+//---------------------------------------------------------------------------
+#include "chai3d.h"
+using namespace chai3d;
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+// DECLARED TYPES
+//---------------------------------------------------------------------------
+
+// benchmark segment
+struct BenchSegment
+{
+    cVector3d m_pointA;
+    cVector3d m_pointB;
+};
+
+// benchmark statistics
+struct BenchStats
+{
+    double m_mean;
+    double m_median;
+    double m_p99;
+    double m_max;
+};
+
+
+//---------------------------------------------------------------------------
+// DECLARED VARIABLES
+//---------------------------------------------------------------------------
+
+// number of queries per benchmark
+int numQueries = 100000;
+
+// radius of the haptic point relative to the size of the model
+double relativeRadius = 0.005;
+
+// state of the pseudo-random number generator
+unsigned int randomSeed = 12345;
+
+// number of deformation frames per refit benchmark
+int numFrames = 200;
+
+// duration of the haptic scheduler benchmark in seconds
+double schedulerDuration = 2.0;
+
+// vertex welding tolerance of the loading benchmark, relative to model size
+double relativeWeldingTolerance = 0.0;
+
+// recorded device trajectory replayed by the haptic benchmarks (synthetic if empty)
+string trajectoryFilename = "";
+
+// file receiving the forces computed by the haptic benchmarks (none if empty)
+string forcesFilename = "";
+
+// file receiving the forces computed by the haptic benchmarks
+FILE* forcesFile = NULL;
+
+
+//---------------------------------------------------------------------------
+// DECLARED FUNCTIONS
+//---------------------------------------------------------------------------
+
+// deterministic pseudo-random number in [0,1]
+double randomUniform()
+{
+    randomSeed = 1664525 * randomSeed + 1013904223;
+    return ((double)(randomSeed >> 8) / (double)(0x00ffffff));
+}
+
+
+// compute statistics from a list of timings (in seconds)
+BenchStats computeStats(vector<double>& a_timings)
+{
+    BenchStats stats;
+    stats.m_mean = stats.m_median = stats.m_p99 = stats.m_max = 0.0;
+
+    if (a_timings.size() == 0) return (stats);
+
+    double sum = 0.0;
+    for (unsigned int i=0; i<a_timings.size(); i++)
+    {
+        sum += a_timings[i];
+    }
+
+    sort(a_timings.begin(), a_timings.end());
+    stats.m_mean   = sum / (double)(a_timings.size());
+    stats.m_median = a_timings[a_timings.size() / 2];
+    stats.m_p99    = a_timings[(a_timings.size() * 99) / 100];
+    stats.m_max    = a_timings[a_timings.size() - 1];
+
+    return (stats);
+}
+
+
+// print statistics (in microseconds)
+void printStats(string a_label, const BenchStats& a_stats)
+{
+    cout << "  " << left << setw(24) << a_label << right << fixed << setprecision(3)
+         << "mean " << setw(9) << 1e6 * a_stats.m_mean << " us   "
+         << "median " << setw(9) << 1e6 * a_stats.m_median << " us   "
+         << "p99 " << setw(9) << 1e6 * a_stats.m_p99 << " us   "
+         << "max " << setw(9) << 1e6 * a_stats.m_max << " us" << endl;
+}
+
+
+// load a model and report its size
+bool loadModel(cMultiMesh* a_model, string a_filename)
+{
+    cout << "loading " << a_filename << "..." << endl;
+    if (!a_model->loadFromFile(a_filename))
+    {
+        cout << "error: cannot load model file " << a_filename << endl;
+        return (false);
+    }
+
+    a_model->computeBoundaryBox(true);
+    cout << "  " << a_model->getNumMeshes() << " meshes, "
+         << a_model->getNumTriangles() << " triangles, "
+         << a_model->getNumVertices() << " vertices" << endl;
+
+    return (true);
+}
+
+
+// generate short segments crossing the surface of a model, similar to proxy motions
+void createSegments(cMultiMesh* a_model, double a_length, vector<BenchSegment>& a_segments)
+{
+    a_segments.clear();
+
+    int numMeshes = a_model->getNumMeshes();
+    for (int i=0; i<numQueries; i++)
+    {
+        cMesh* mesh = a_model->getMesh((int)(randomUniform() * (numMeshes - 1) + 0.5));
+        int numTriangles = mesh->getNumTriangles();
+        if (numTriangles == 0) { i--; continue; }
+
+        // pick a random point on a random triangle
+        int triangle = cMin((int)(randomUniform() * numTriangles), numTriangles - 1);
+        cVector3d v0 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex0(triangle));
+        cVector3d v1 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex1(triangle));
+        cVector3d v2 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex2(triangle));
+        double u = randomUniform();
+        double v = randomUniform();
+        if (u + v > 1.0) { u = 1.0 - u; v = 1.0 - v; }
+        cVector3d point = v0 + u * (v1 - v0) + v * (v2 - v0);
+
+        // pick a random direction
+        cVector3d dir(randomUniform() - 0.5, randomUniform() - 0.5, randomUniform() - 0.5);
+        if (dir.length() < C_SMALL) { dir.set(0.0, 0.0, 1.0); }
+        dir.normalize();
+
+        BenchSegment segment;
+        segment.m_pointA = point - (0.5 * a_length) * dir;
+        segment.m_pointB = point + (0.5 * a_length) * dir;
+        a_segments.push_back(segment);
+    }
+}
+
+
+// run all segment queries against all meshes of a model and record per-query timings
+int runQueries(cMultiMesh* a_model,
+               vector<BenchSegment>& a_segments,
+               double a_radius,
+               vector<double>& a_timings,
+               double& a_distanceSum)
+{
+    cPrecisionClock clock;
+    cCollisionRecorder recorder;
+    cCollisionSettings settings;
+    settings.m_checkForNearestCollisionOnly = true;
+    settings.m_collisionRadius = a_radius;
+
+    int numHits = 0;
+    a_distanceSum = 0.0;
+    a_timings.resize(a_segments.size());
+
+    int numMeshes = a_model->getNumMeshes();
+    for (unsigned int i=0; i<a_segments.size(); i++)
+    {
+        bool hit = false;
+        recorder.clear();
+
+        double t0 = clock.getCPUTimeSeconds();
+        for (int j=0; j<numMeshes; j++)
+        {
+            cMesh* mesh = a_model->getMesh(j);
+            if (mesh->getCollisionDetector()->computeCollision(mesh,
+                                                               a_segments[i].m_pointA,
+                                                               a_segments[i].m_pointB,
+                                                               recorder,
+                                                               settings))
+            {
+                hit = true;
+            }
+        }
+        a_timings[i] = clock.getCPUTimeSeconds() - t0;
+
+        if (hit)
+        {
+            numHits++;
+            a_distanceSum += recorder.m_nearestCollision.m_squareDistance;
+        }
+    }
+
+    return (numHits);
+}
+
+
+// select the traversal mode of all AABB collision detectors of a model
+void setUsePackedTree(cMultiMesh* a_model, bool a_usePackedTree, bool a_useTriangleBuckets)
+{
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cCollisionAABB* detector = dynamic_cast<cCollisionAABB*>(a_model->getMesh(i)->getCollisionDetector());
+        if (detector != NULL)
+        {
+            detector->setUsePackedTree(a_usePackedTree);
+            detector->setUseTriangleBuckets(a_useTriangleBuckets);
+        }
+    }
+}
+
+
+// build AABB collision detectors for a model and report build time and tree quality
+void buildTree(cMultiMesh* a_model, double a_radius, cAABBBuildMethod a_buildMethod, string a_label)
+{
+    cPrecisionClock clock;
+    double t0 = clock.getCPUTimeSeconds();
+    a_model->createAABBCollisionDetector(a_radius, a_buildMethod);
+    double buildTime = clock.getCPUTimeSeconds() - t0;
+
+    // accumulate statistics of all meshes, weighting SAH cost by number of leaves
+    double sahCost = 0.0;
+    double leafDepth = 0.0;
+    int numLeaves = 0;
+    int maxDepth = 0;
+    int maxLeafSize = 0;
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cCollisionAABB* detector = dynamic_cast<cCollisionAABB*>(a_model->getMesh(i)->getCollisionDetector());
+        if (detector == NULL) continue;
+
+        cCollisionAABBStatistics stats = detector->computeStatistics();
+        sahCost += stats.m_sahCost * stats.m_numLeaves;
+        leafDepth += stats.m_averageLeafDepth * stats.m_numLeaves;
+        numLeaves += stats.m_numLeaves;
+        maxDepth = cMax(maxDepth, stats.m_maxDepth);
+        maxLeafSize = cMax(maxLeafSize, stats.m_maxLeafSize);
+    }
+    if (numLeaves > 0)
+    {
+        sahCost /= numLeaves;
+        leafDepth /= numLeaves;
+    }
+
+    cout << "  " << left << setw(24) << a_label << right << fixed << setprecision(3)
+         << "time " << setw(9) << 1e3 * buildTime << " ms   "
+         << "SAH cost " << setw(9) << sahCost << "   "
+         << "depth " << maxDepth << " (avg " << setprecision(1) << leafDepth << ")   "
+         << "leaf size " << maxLeafSize << endl;
+}
+
+
+// AABB collision query benchmark
+int benchmarkAABB(string a_filename)
+{
+    cMultiMesh* model = new cMultiMesh();
+    if (!loadModel(model, a_filename))
+    {
+        delete model;
+        return (-1);
+    }
+
+    // express query dimensions relative to model size
+    double size = cDistance(model->getBoundaryMin(), model->getBoundaryMax());
+    double radius = relativeRadius * size;
+
+    // build collision trees
+    buildTree(model, radius, C_AABB_BUILD_CENTER, "center split build");
+
+    // create queries
+    vector<BenchSegment> segments;
+    createSegments(model, 4.0 * radius, segments);
+
+    // run all traversal modes
+    vector<double> timings;
+    double distanceSumOriginal, distanceSumPacked, distanceSumBuckets, distanceSumSAH;
+
+    setUsePackedTree(model, false, false);
+    int hitsOriginal = runQueries(model, segments, radius, timings, distanceSumOriginal);
+    printStats("original traversal", computeStats(timings));
+
+    setUsePackedTree(model, true, false);
+    int hitsPacked = runQueries(model, segments, radius, timings, distanceSumPacked);
+    printStats("packed traversal", computeStats(timings));
+
+    setUsePackedTree(model, true, true);
+    int hitsBuckets = runQueries(model, segments, radius, timings, distanceSumBuckets);
+    printStats("packed, buckets", computeStats(timings));
+
+    // compare results
+    cout << "  " << hitsOriginal << " / " << segments.size() << " queries hit the model";
+    if ((hitsOriginal == hitsPacked) && (distanceSumOriginal == distanceSumPacked) &&
+        (hitsOriginal == hitsBuckets) && (distanceSumOriginal == distanceSumBuckets))
+    {
+        cout << ", results match" << endl;
+    }
+    else
+    {
+        cout << ", error: results differ (" << hitsPacked << " hits with packed tree, " 
+             << hitsBuckets << " hits with buckets)" << endl;
+    }
+
+    // rebuild trees using the surface area heuristic
+    buildTree(model, radius, C_AABB_BUILD_SAH, "SAH build");
+    int hitsSAH = runQueries(model, segments, radius, timings, distanceSumSAH);
+    printStats("SAH packed traversal", computeStats(timings));
+    if ((hitsOriginal != hitsSAH) || (cAbs(distanceSumOriginal - distanceSumSAH) > C_SMALL * cMax(1.0, distanceSumOriginal)))
+    {
+        cout << "  error: results differ (" << hitsSAH << " hits with SAH tree)" << endl;
+    }
+    cout << endl;
+
+    delete model;
+    return (0);
+}
+
+
+// displace all vertices of a model located within a sphere, or all vertices if the radius is zero
+void deformModel(cMultiMesh* a_model, const cVector3d& a_center, double a_radius, const cVector3d& a_offset)
+{
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cVertexArrayPtr vertices = a_model->getMesh(i)->m_vertices;
+        int numVertices = vertices->getNumElements();
+        for (int j=0; j<numVertices; j++)
+        {
+            cVector3d pos = vertices->getLocalPos(j);
+            if ((a_radius <= 0.0) || (cDistance(pos, a_center) < a_radius))
+            {
+                vertices->setLocalPos(j, pos + a_offset);
+            }
+        }
+    }
+}
+
+
+// update all collision detectors of a model, by rebuilding or refitting, and return the elapsed time
+double updateModel(cMultiMesh* a_model, bool a_refit)
+{
+    cPrecisionClock clock;
+    double t0 = clock.getCPUTimeSeconds();
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cCollisionAABB* detector = dynamic_cast<cCollisionAABB*>(a_model->getMesh(i)->getCollisionDetector());
+        if (a_refit && (detector != NULL))
+        {
+            detector->refit();
+        }
+        else
+        {
+            a_model->getMesh(i)->getCollisionDetector()->update();
+        }
+    }
+    return (clock.getCPUTimeSeconds() - t0);
+}
+
+
+// count refits and rebuilds of all collision detectors of a model
+void countUpdates(cMultiMesh* a_model, int& a_numRefits, int& a_numRebuilds)
+{
+    a_numRefits = 0;
+    a_numRebuilds = 0;
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cCollisionAABB* detector = dynamic_cast<cCollisionAABB*>(a_model->getMesh(i)->getCollisionDetector());
+        if (detector != NULL)
+        {
+            a_numRefits += detector->getNumRefits();
+            a_numRebuilds += detector->getNumRebuilds();
+        }
+    }
+}
+
+
+// AABB update benchmark on a deforming model: full rebuild versus incremental refit
+int benchmarkRefit(string a_filename, bool a_localDeformation)
+{
+    cMultiMesh* rebuildModel = new cMultiMesh();
+    cMultiMesh* refitModel = new cMultiMesh();
+    if (!loadModel(rebuildModel, a_filename) || !loadModel(refitModel, a_filename))
+    {
+        delete rebuildModel;
+        delete refitModel;
+        return (-1);
+    }
+
+    double size = cDistance(refitModel->getBoundaryMin(), refitModel->getBoundaryMax());
+    double radius = relativeRadius * size;
+
+    // the first model is rebuilt at every frame, the second one is refitted
+    rebuildModel->createAABBCollisionDetector(radius);
+    refitModel->createAABBCollisionDetector(radius);
+
+    // collect vertex positions used as centers of local deformations
+    vector<cVector3d> centers;
+    for (int i=0; i<refitModel->getNumMeshes(); i++)
+    {
+        cMesh* mesh = refitModel->getMesh(i);
+        for (unsigned int j=0; j<mesh->getNumVertices(); j++)
+        {
+            centers.push_back(mesh->m_vertices->getLocalPos(j));
+        }
+    }
+    if (centers.size() == 0)
+    {
+        delete rebuildModel;
+        delete refitModel;
+        return (-1);
+    }
+
+    // apply the same deformations to both models
+    vector<double> rebuildTimings(numFrames);
+    vector<double> refitTimings(numFrames);
+    for (int i=0; i<numFrames; i++)
+    {
+        cVector3d offset(randomUniform() - 0.5, randomUniform() - 0.5, randomUniform() - 0.5);
+        if (a_localDeformation)
+        {
+            // sculpt a small patch of the surface
+            cVector3d center = centers[(int)(randomUniform() * (centers.size() - 1))];
+            offset.mul(0.01 * size);
+            deformModel(rebuildModel, center, 0.05 * size, offset);
+            deformModel(refitModel, center, 0.05 * size, offset);
+        }
+        else
+        {
+            // translate the whole model
+            offset.mul(0.002 * size);
+            deformModel(rebuildModel, cVector3d(0,0,0), 0.0, offset);
+            deformModel(refitModel, cVector3d(0,0,0), 0.0, offset);
+        }
+
+        rebuildTimings[i] = updateModel(rebuildModel, false);
+        refitTimings[i] = updateModel(refitModel, true);
+    }
+
+    printStats(a_localDeformation ? "local, rebuild" : "global, rebuild", computeStats(rebuildTimings));
+    printStats(a_localDeformation ? "local, refit" : "global, refit", computeStats(refitTimings));
+
+    int numRefits, numRebuilds;
+    countUpdates(refitModel, numRefits, numRebuilds);
+    cout << "  " << numRefits << " refits, " << numRebuilds << " rebuilds";
+
+    // compare collision queries on both models
+    vector<BenchSegment> segments;
+    createSegments(refitModel, 4.0 * radius, segments);
+    vector<double> timings;
+    double distanceSumRebuild, distanceSumRefit;
+    int hitsRebuild = runQueries(rebuildModel, segments, radius, timings, distanceSumRebuild);
+    int hitsRefit = runQueries(refitModel, segments, radius, timings, distanceSumRefit);
+    if ((hitsRebuild == hitsRefit) && (cAbs(distanceSumRebuild - distanceSumRefit) <= C_SMALL * cMax(1.0, distanceSumRebuild)))
+    {
+        cout << ", results match" << endl;
+    }
+    else
+    {
+        cout << ", error: results differ (" << hitsRefit << " / " << hitsRebuild << " hits)" << endl;
+    }
+    cout << endl;
+
+    delete rebuildModel;
+    delete refitModel;
+    return (0);
+}
+
+
+// pack the vertex buffers of all meshes of a model and return the number of
+// bytes that are uploaded to the GPU
+size_t updateVertexBuffers(cMultiMesh* a_model)
+{
+    size_t numBytes = 0;
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cVertexArrayPtr vertices = a_model->getMesh(i)->m_vertices;
+        vertices->updateBufferData();
+        for (unsigned int j=0; j<2; j++)
+        {
+            const vector<pair<unsigned int, unsigned int> >& spans = vertices->getBufferSpans(j);
+            for (unsigned int k=0; k<spans.size(); k++)
+            {
+                numBytes += spans[k].second * vertices->getBufferStride(j);
+            }
+        }
+    }
+    return (numBytes);
+}
+
+
+// vertex buffer benchmark on a deforming model: bytes uploaded per frame and
+// packing time of the float and packed formats
+int benchmarkVertexBuffer(string a_filename, bool a_localDeformation)
+{
+    cMultiMesh* model = new cMultiMesh();
+    if (!loadModel(model, a_filename))
+    {
+        delete model;
+        return (-1);
+    }
+
+    double size = cDistance(model->getBoundaryMin(), model->getBoundaryMax());
+    unsigned int numVertices = model->getNumVertices();
+    if (numVertices == 0)
+    {
+        delete model;
+        return (-1);
+    }
+
+    // double precision buffers of positions and normals were uploaded entirely at every frame
+    cout << "  " << (a_localDeformation ? "local" : "global") << ", double buffers upload "
+         << fixed << setprecision(1) << (double)(numVertices * 2 * sizeof(cVector3d)) / 1024.0 << " kB per frame" << endl;
+
+    // apply the same deformations with both formats
+    unsigned int seed = randomSeed;
+    cVertexBufferFormat formats[2] = { C_VERTEX_BUFFER_FORMAT_FLOAT, C_VERTEX_BUFFER_FORMAT_PACKED };
+    bool match = true;
+    for (int k=0; k<2; k++)
+    {
+        randomSeed = seed;
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            model->getMesh(i)->m_vertices->setBufferFormat(formats[k]);
+        }
+        updateVertexBuffers(model);
+
+        vector<double> timings(numFrames);
+        size_t numBytes = 0;
+        cPrecisionClock clock;
+        for (int i=0; i<numFrames; i++)
+        {
+            cVector3d offset(randomUniform() - 0.5, randomUniform() - 0.5, randomUniform() - 0.5);
+            if (a_localDeformation)
+            {
+                // sculpt a small patch of the surface
+                cMesh* mesh = model->getMesh((int)(randomUniform() * (model->getNumMeshes() - 1)));
+                int vertex = (int)(randomUniform() * ((int)(mesh->getNumVertices()) - 1));
+                cVector3d center = mesh->m_vertices->getLocalPos(cMax(vertex, 0));
+                offset.mul(0.01 * size);
+                deformModel(model, center, 0.05 * size, offset);
+            }
+            else
+            {
+                // translate the whole model
+                offset.mul(0.002 * size);
+                deformModel(model, cVector3d(0,0,0), 0.0, offset);
+            }
+            for (int j=0; j<model->getNumMeshes(); j++)
+            {
+                model->getMesh(j)->computeAllNormals();
+            }
+
+            double t0 = clock.getCPUTimeSeconds();
+            numBytes += updateVertexBuffers(model);
+            timings[i] = clock.getCPUTimeSeconds() - t0;
+        }
+
+        // the partially updated buffers must equal fully packed buffers
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            cVertexArrayPtr vertices = model->getMesh(i)->m_vertices;
+            vector<unsigned char> data = vertices->getBufferData(C_VERTEX_BUFFER_GEOMETRY);
+            vertices->m_flagPositionData = true;
+            vertices->updateBufferData();
+            if (data != vertices->getBufferData(C_VERTEX_BUFFER_GEOMETRY)) match = false;
+        }
+
+        string label = string(a_localDeformation ? "local, " : "global, ") + (k == 0 ? "float" : "packed");
+        printStats(label, computeStats(timings));
+        cVertexArrayPtr vertices = model->getMesh(0)->m_vertices;
+        cout << "  " << fixed << setprecision(1) << (double)(numBytes) / (1024.0 * numFrames) << " kB per frame, "
+             << vertices->getBufferStride(C_VERTEX_BUFFER_GEOMETRY) << " + "
+             << vertices->getBufferStride(C_VERTEX_BUFFER_ATTRIBUTES) << " bytes per vertex" << endl;
+    }
+
+    if (match)
+    {
+        cout << "  partial updates match full updates" << endl;
+    }
+    else
+    {
+        cout << "  error: partial updates differ from full updates" << endl;
+    }
+    cout << endl;
+
+    delete model;
+    return (match ? 0 : -1);
+}
+
+
+// collect the edges of a mesh as sorted pairs of vertex positions
+void collectEdges(cMesh* a_mesh, vector<vector<double> >& a_edges)
+{
+    for (unsigned int i=0; i<a_mesh->m_edges.size(); i++)
+    {
+        cVector3d pos0 = a_mesh->m_vertices->getLocalPos(a_mesh->m_edges[i].m_vertex0);
+        cVector3d pos1 = a_mesh->m_vertices->getLocalPos(a_mesh->m_edges[i].m_vertex1);
+        vector<double> edge(6);
+        for (int j=0; j<3; j++)
+        {
+            edge[j] = pos0(j);
+            edge[j+3] = pos1(j);
+        }
+        a_edges.push_back(edge);
+    }
+    sort(a_edges.begin(), a_edges.end());
+}
+
+
+// compute the edges of all meshes of a model and return the computation time
+double computeEdges(cMultiMesh* a_model)
+{
+    cPrecisionClock clock;
+    double t0 = clock.getCPUTimeSeconds();
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        a_model->getMesh(i)->computeAllEdges(40.0);
+    }
+    return (clock.getCPUTimeSeconds() - t0);
+}
+
+
+// adjacency benchmark: edge extraction with and without adjacency index, and
+// incremental updates of the index
+int benchmarkAdjacency(string a_filename)
+{
+    cMultiMesh* model = new cMultiMesh();
+    if (!loadModel(model, a_filename))
+    {
+        delete model;
+        return (-1);
+    }
+
+    int numRuns = cMin(numFrames, 10);
+    vector<double> edgeTimings(numRuns);
+    vector<double> buildTimings(numRuns);
+
+    // reference results without adjacency index
+    for (int i=0; i<numRuns; i++)
+    {
+        edgeTimings[i] = computeEdges(model);
+    }
+    printStats("edges, multiset", computeStats(edgeTimings));
+
+    vector<vector<double> > edges;
+    for (int i=0; i<model->getNumMeshes(); i++)
+    {
+        collectEdges(model->getMesh(i), edges);
+    }
+
+    // results with adjacency index
+    cPrecisionClock clock;
+    for (int i=0; i<numRuns; i++)
+    {
+        double t0 = clock.getCPUTimeSeconds();
+        for (int j=0; j<model->getNumMeshes(); j++)
+        {
+            model->getMesh(j)->createAdjacency();
+        }
+        buildTimings[i] = clock.getCPUTimeSeconds() - t0;
+    }
+    for (int i=0; i<numRuns; i++)
+    {
+        edgeTimings[i] = computeEdges(model);
+    }
+    printStats("adjacency, build", computeStats(buildTimings));
+    printStats("edges, adjacency", computeStats(edgeTimings));
+
+    vector<vector<double> > adjacencyEdges;
+    for (int i=0; i<model->getNumMeshes(); i++)
+    {
+        collectEdges(model->getMesh(i), adjacencyEdges);
+    }
+    sort(edges.begin(), edges.end());
+    sort(adjacencyEdges.begin(), adjacencyEdges.end());
+    bool match = (edges == adjacencyEdges);
+    cout << "  " << edges.size() << " edges, " << (match ? "results match" : "error: results differ") << endl;
+
+    // remove triangles, then restore them: after each step, the edges found
+    // by the incrementally updated index must equal those of the multiset
+    bool incrementalMatch = true;
+    int numRemoved = 0;
+    for (int i=0; i<model->getNumMeshes(); i++)
+    {
+        cMesh* mesh = model->getMesh(i);
+        unsigned int numTriangles = mesh->getNumTriangles();
+        vector<unsigned int> removed;
+        for (unsigned int j=0; j<numTriangles; j++)
+        {
+            if (randomUniform() < 0.01)
+            {
+                removed.push_back(mesh->m_triangles->getVertexIndex0(j));
+                removed.push_back(mesh->m_triangles->getVertexIndex1(j));
+                removed.push_back(mesh->m_triangles->getVertexIndex2(j));
+                mesh->removeTriangle(j);
+            }
+        }
+        numRemoved += (int)(removed.size() / 3);
+
+        for (int step=0; step<2; step++)
+        {
+            if (step == 1)
+            {
+                for (unsigned int j=0; j<removed.size(); j+=3)
+                {
+                    mesh->newTriangle(removed[j], removed[j+1], removed[j+2]);
+                }
+            }
+
+            // the reference mesh shares the arrays but has no adjacency index
+            cMesh* reference = new cMesh();
+            reference->m_vertices = mesh->m_vertices;
+            reference->m_triangles = mesh->m_triangles;
+            reference->computeAllEdges(40.0);
+            mesh->computeAllEdges(40.0);
+
+            vector<vector<double> > referenceEdges, meshEdges;
+            collectEdges(reference, referenceEdges);
+            collectEdges(mesh, meshEdges);
+            if (referenceEdges != meshEdges) incrementalMatch = false;
+            delete reference;
+        }
+    }
+    cout << "  " << numRemoved << " triangles removed and restored, "
+         << (incrementalMatch ? "results match" : "error: results differ") << endl;
+    cout << endl;
+
+    delete model;
+    return ((match && incrementalMatch) ? 0 : -1);
+}
+
+
+// reference computation of the normals of a mesh, by the scalar loop used
+// before cMesh distributed vertex computations over the shared worker pool
+void referenceNormals(cMesh* a_mesh)
+{
+    unsigned int numTriangles = a_mesh->m_triangles->getNumElements();
+    unsigned int numVertices = a_mesh->m_vertices->getNumElements();
+    vector<cVector3d> normals(numVertices, cVector3d(0.0, 0.0, 0.0));
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        unsigned int vertexIndex0 = a_mesh->m_triangles->getVertexIndex0(i);
+        unsigned int vertexIndex1 = a_mesh->m_triangles->getVertexIndex1(i);
+        unsigned int vertexIndex2 = a_mesh->m_triangles->getVertexIndex2(i);
+
+        cVector3d vertex0 = a_mesh->m_vertices->getLocalPos(vertexIndex0);
+        cVector3d vertex1 = a_mesh->m_vertices->getLocalPos(vertexIndex1);
+        cVector3d vertex2 = a_mesh->m_vertices->getLocalPos(vertexIndex2);
+
+        cVector3d normal, v01, v02;
+        vertex1.subr(vertex0, v01);
+        vertex2.subr(vertex0, v02);
+        v01.crossr(v02, normal);
+        double length = normal.length();
+        if (length > 0.0)
+        {
+            normal.div(length);
+            normals[vertexIndex0].add(normal);
+            normals[vertexIndex1].add(normal);
+            normals[vertexIndex2].add(normal);
+        }
+    }
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        if (normals[i].length() > 0.000000001)
+        {
+            normals[i].normalize();
+        }
+        if (!normals[i].equals(a_mesh->m_vertices->m_normal[i]))
+        {
+            a_mesh->m_vertices->setNormal(i, normals[i]);
+        }
+    }
+}
+
+
+// return true if two arrays of vectors are equal within a tolerance; vectors
+// computed by different code paths may differ by rounding
+bool equalVectors(const vector<cVector3d>& a_vectors0, const vector<cVector3d>& a_vectors1, const double a_epsilon = 0.0)
+{
+    if (a_vectors0.size() != a_vectors1.size()) return (false);
+    for (unsigned int i=0; i<a_vectors0.size(); i++)
+    {
+        if (!a_vectors0[i].equals(a_vectors1[i], a_epsilon)) return (false);
+    }
+    return (true);
+}
+
+
+// reference computation of the boundary box of a mesh
+bool referenceBoundaryBox(cMesh* a_mesh, cVector3d& a_min, cVector3d& a_max)
+{
+    a_min.set(C_LARGE, C_LARGE, C_LARGE);
+    a_max.set(-C_LARGE, -C_LARGE, -C_LARGE);
+    bool flag = false;
+    unsigned int numTriangles = a_mesh->m_triangles->getNumElements();
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (a_mesh->m_triangles->m_allocated[i])
+        {
+            for (unsigned int j=0; j<3; j++)
+            {
+                cVector3d vertex = a_mesh->m_vertices->getLocalPos(a_mesh->m_triangles->getVertexIndex(i, j));
+                for (int k=0; k<3; k++)
+                {
+                    a_min(k) = cMin(vertex(k), a_min(k));
+                    a_max(k) = cMax(vertex(k), a_max(k));
+                }
+            }
+            flag = true;
+        }
+    }
+
+    // an empty mesh has a zero boundary box, as in cMesh::computeBoundaryBox()
+    if (!flag)
+    {
+        a_min.zero();
+        a_max.zero();
+    }
+    return (flag);
+}
+
+
+// reference computation of the global positions of the vertices of a mesh
+void referenceGlobalPositions(cMesh* a_mesh)
+{
+    unsigned int numVertices = a_mesh->m_vertices->getNumElements();
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        a_mesh->m_vertices->computeGlobalPosition(i, a_mesh->getGlobalPos(), a_mesh->getGlobalRot());
+    }
+}
+
+
+// mesh kernel benchmark: normals, boundary box, global positions and
+// tangent vectors, compared with the scalar loops they replace
+int benchmarkMeshKernels(string a_filename)
+{
+    cMultiMesh* model = new cMultiMesh();
+    if (!loadModel(model, a_filename))
+    {
+        delete model;
+        return (-1);
+    }
+
+    // place the model, and derive texture coordinates from vertex positions
+    // so that every triangle has tangent vectors
+    model->setLocalPos(0.1, -0.2, 0.3);
+    model->rotateAboutGlobalAxisDeg(cVector3d(1, 1, 0), 30);
+    model->computeGlobalPositions(true);
+    for (int i=0; i<model->getNumMeshes(); i++)
+    {
+        cVertexArrayPtr vertices = model->getMesh(i)->m_vertices;
+        for (unsigned int j=0; j<vertices->getNumElements(); j++)
+        {
+            cVector3d pos = vertices->getLocalPos(j);
+            vertices->setTexCoord(j, pos(0) + 0.5 * pos(2), pos(1) - 0.5 * pos(2));
+        }
+    }
+
+    cout << "  " << cWorkerPool::getSharedPool()->getNumThreads() << " threads, parallel above "
+         << C_MESH_PARALLEL_THRESHOLD << " vertices or triangles" << endl;
+
+    cPrecisionClock clock;
+    int numRuns = cMin(numFrames, 50);
+    vector<double> referenceTimings(numRuns);
+    vector<double> timings(numRuns);
+    vector<double> adjacencyTimings(numRuns);
+    bool match = true;
+
+    // normals
+    vector<cVector3d> referenceResults, results, adjacencyResults;
+    for (int k=0; k<3; k++)
+    {
+        vector<double>& kernelTimings = (k == 0) ? referenceTimings : ((k == 1) ? timings : adjacencyTimings);
+        vector<cVector3d>& kernelResults = (k == 0) ? referenceResults : ((k == 1) ? results : adjacencyResults);
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            cMesh* mesh = model->getMesh(i);
+            if (k == 2) mesh->createAdjacency();
+            mesh->m_vertices->m_normal.assign(mesh->m_vertices->m_normal.size(), cVector3d(0,0,0));
+        }
+        for (int r=0; r<numRuns; r++)
+        {
+            double t0 = clock.getCPUTimeSeconds();
+            for (int i=0; i<model->getNumMeshes(); i++)
+            {
+                if (k == 0) referenceNormals(model->getMesh(i));
+                else model->getMesh(i)->computeAllNormals();
+            }
+            kernelTimings[r] = clock.getCPUTimeSeconds() - t0;
+        }
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            cVertexArrayPtr vertices = model->getMesh(i)->m_vertices;
+            kernelResults.insert(kernelResults.end(), vertices->m_normal.begin(), vertices->m_normal.end());
+        }
+    }
+    printStats("normals, scalar loop", computeStats(referenceTimings));
+    printStats("normals, no adjacency", computeStats(timings));
+    printStats("normals, adjacency", computeStats(adjacencyTimings));
+    if (!equalVectors(referenceResults, results, 1e-12)) match = false;
+    if (!equalVectors(referenceResults, adjacencyResults, C_TINY)) match = false;
+
+    // boundary box
+    vector<cVector3d> boxMin(model->getNumMeshes()), boxMax(model->getNumMeshes());
+    for (int r=0; r<numRuns; r++)
+    {
+        double t0 = clock.getCPUTimeSeconds();
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            referenceBoundaryBox(model->getMesh(i), boxMin[i], boxMax[i]);
+        }
+        referenceTimings[r] = clock.getCPUTimeSeconds() - t0;
+    }
+    for (int r=0; r<numRuns; r++)
+    {
+        double t0 = clock.getCPUTimeSeconds();
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            model->getMesh(i)->computeBoundaryBox(false);
+        }
+        timings[r] = clock.getCPUTimeSeconds() - t0;
+    }
+    printStats("bounds, scalar loop", computeStats(referenceTimings));
+    printStats("bounds, kernels", computeStats(timings));
+    for (int i=0; i<model->getNumMeshes(); i++)
+    {
+        cMesh* mesh = model->getMesh(i);
+        if (!boxMin[i].equals(mesh->getBoundaryMin()) || !boxMax[i].equals(mesh->getBoundaryMax())) match = false;
+    }
+
+    // global positions
+    referenceResults.clear();
+    results.clear();
+    for (int k=0; k<2; k++)
+    {
+        vector<double>& kernelTimings = (k == 0) ? referenceTimings : timings;
+        vector<cVector3d>& kernelResults = (k == 0) ? referenceResults : results;
+        for (int r=0; r<numRuns; r++)
+        {
+            double t0 = clock.getCPUTimeSeconds();
+            for (int i=0; i<model->getNumMeshes(); i++)
+            {
+                if (k == 0) referenceGlobalPositions(model->getMesh(i));
+                else model->getMesh(i)->computeGlobalPositions(false, model->getGlobalPos(), model->getGlobalRot());
+            }
+            kernelTimings[r] = clock.getCPUTimeSeconds() - t0;
+        }
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            cVertexArrayPtr vertices = model->getMesh(i)->m_vertices;
+            kernelResults.insert(kernelResults.end(), vertices->m_globalPos.begin(), vertices->m_globalPos.end());
+            vertices->m_globalPos.assign(vertices->m_globalPos.size(), cVector3d(0,0,0));
+        }
+    }
+    printStats("positions, scalar loop", computeStats(referenceTimings));
+    printStats("positions, kernels", computeStats(timings));
+    if (!equalVectors(referenceResults, results)) match = false;
+
+    // tangent vectors, with the adjacency index created above
+    referenceResults.clear();
+    results.clear();
+    for (int k=0; k<2; k++)
+    {
+        vector<double>& kernelTimings = (k == 0) ? referenceTimings : timings;
+        vector<cVector3d>& kernelResults = (k == 0) ? referenceResults : results;
+        for (int r=0; r<numRuns; r++)
+        {
+            double t0 = clock.getCPUTimeSeconds();
+            for (int i=0; i<model->getNumMeshes(); i++)
+            {
+                if (k == 0) model->getMesh(i)->m_triangles->computeBTN();
+                else model->getMesh(i)->computeBTN();
+            }
+            kernelTimings[r] = clock.getCPUTimeSeconds() - t0;
+        }
+        for (int i=0; i<model->getNumMeshes(); i++)
+        {
+            cVertexArrayPtr vertices = model->getMesh(i)->m_vertices;
+            kernelResults.insert(kernelResults.end(), vertices->m_tangent.begin(), vertices->m_tangent.end());
+            kernelResults.insert(kernelResults.end(), vertices->m_bitangent.begin(), vertices->m_bitangent.end());
+            vertices->m_tangent.assign(vertices->m_tangent.size(), cVector3d(0,0,0));
+            vertices->m_bitangent.assign(vertices->m_bitangent.size(), cVector3d(0,0,0));
+        }
+    }
+    printStats("tangents, scalar loop", computeStats(referenceTimings));
+    printStats("tangents, adjacency", computeStats(timings));
+    if (!equalVectors(referenceResults, results, 1e-12)) match = false;
+
+    cout << "  " << (match ? "results match" : "error: results differ") << endl;
+    cout << endl;
+
+    delete model;
+    return (match ? 0 : -1);
+}
+
+
+// haptic scheduler callback: read the device state (the forces of the
+// default device are not sent, since it throttles each command by 1 ms)
+void updateSchedulerDevice(cGenericHapticDevicePtr a_device, const double a_timeStep, void* a_userData)
+{
+    cVector3d position;
+    cMatrix3d rotation;
+    a_device->getPosition(position);
+    a_device->getRotation(rotation);
+}
+
+
+// print a scheduler histogram summary (in microseconds)
+void printSchedulerStats(string a_label, const cHapticSchedulerStatistics& a_stats, bool a_jitter)
+{
+    double mean = a_jitter ? a_stats.m_meanJitter : a_stats.m_meanDuration;
+    double max  = a_jitter ? a_stats.m_maxJitter : a_stats.m_maxDuration;
+    double p50  = a_jitter ? a_stats.getJitterPercentile(0.5) : a_stats.getDurationPercentile(0.5);
+    double p99  = a_jitter ? a_stats.getJitterPercentile(0.99) : a_stats.getDurationPercentile(0.99);
+
+    cout << "  " << left << setw(24) << a_label << right << fixed << setprecision(3)
+         << "mean " << setw(9) << 1e6 * mean << " us   "
+         << "p50 < " << setw(9) << 1e6 * p50 << " us   "
+         << "p99 < " << setw(9) << 1e6 * p99 << " us   "
+         << "max " << setw(9) << 1e6 * max << " us" << endl;
+}
+
+
+// run a 1 kHz haptic scheduler loop on a virtual device and report its timing
+int benchmarkScheduler()
+{
+    cout << "haptic scheduler (1 kHz, " << schedulerDuration << " s)" << endl;
+
+    cGenericHapticDevicePtr device = cGenericHapticDevice::create();
+    device->open();
+
+    cHapticScheduler scheduler;
+    if (scheduler.addDevice(device, updateSchedulerDevice, NULL, 1000.0) < 0)
+    {
+        cout << "  error - cannot register device" << endl;
+        return (-1);
+    }
+
+    scheduler.start();
+    cSleepMs((unsigned int)(1000.0 * schedulerDuration));
+    scheduler.stop();
+
+    cHapticSchedulerStatistics stats;
+    scheduler.getStatistics(stats, 0);
+
+    cout << "  cycles " << stats.m_numCycles
+         << "   overruns " << stats.m_numOverruns
+         << "   skipped " << stats.m_numSkippedCycles << endl;
+    printSchedulerStats("jitter", stats, true);
+    printSchedulerStats("callback", stats, false);
+    cout << endl;
+
+    device->close();
+
+    return (0);
+}
+
+
+// scene snapshot test data
+struct SnapshotTest
+{
+    cSceneSnapshot* m_snapshot;
+    vector<cShapeSphere*> m_objects;
+    int m_counter;
+};
+
+
+// haptic scheduler callback: move all objects to the same pose and publish
+void updateSnapshotObjects(cGenericHapticDevicePtr a_device, const double a_timeStep, void* a_userData)
+{
+    SnapshotTest* test = (SnapshotTest*)a_userData;
+    test->m_counter++;
+
+    double value = (double)test->m_counter;
+    cMatrix3d rotation;
+    rotation.setAxisAngleRotationRad(0.0, 0.0, 1.0, 0.001 * value);
+    for (unsigned int i=0; i<test->m_objects.size(); i++)
+    {
+        test->m_objects[i]->setLocalPos(value, value, value);
+        test->m_objects[i]->setLocalRot(rotation);
+    }
+
+    test->m_snapshot->publish();
+}
+
+
+// compare two transformations element by element
+bool equalTransforms(const cTransform& a_transform0, const cTransform& a_transform1)
+{
+    for (int i=0; i<4; i++)
+    {
+        for (int j=0; j<4; j++)
+        {
+            if (a_transform0(i,j) != a_transform1(i,j)) return (false);
+        }
+    }
+    return (true);
+}
+
+
+// publish object poses from a haptic loop and check that every snapshot
+// acquired by the reading thread is consistent
+int benchmarkSnapshot()
+{
+    cout << "scene snapshot (1 kHz, " << schedulerDuration << " s)" << endl;
+
+    SnapshotTest test;
+    test.m_snapshot = new cSceneSnapshot();
+    test.m_counter = 0;
+    for (int i=0; i<100; i++)
+    {
+        cShapeSphere* object = new cShapeSphere(0.01);
+        test.m_objects.push_back(object);
+        test.m_snapshot->addObject(object);
+    }
+
+    cGenericHapticDevicePtr device = cGenericHapticDevice::create();
+    cHapticScheduler scheduler;
+    scheduler.addDevice(device, updateSnapshotObjects, &test, 1000.0);
+    scheduler.start();
+
+    int numUpdates = 0;
+    int numTorn = 0;
+    cPrecisionClock clock;
+    clock.start(true);
+    while (clock.getCurrentTimeSeconds() < schedulerDuration)
+    {
+        if (!test.m_snapshot->update()) continue;
+        numUpdates++;
+
+        cTransform reference = test.m_objects[0]->getRenderLocalTransform();
+        for (unsigned int i=1; i<test.m_objects.size(); i++)
+        {
+            cTransform transform = test.m_objects[i]->getRenderLocalTransform();
+            if (!equalTransforms(reference, transform))
+            {
+                numTorn++;
+                break;
+            }
+        }
+    }
+
+    scheduler.stop();
+
+    cout << "  published " << test.m_counter << "   acquired " << numUpdates << "   inconsistent " << numTorn << endl << endl;
+
+    delete test.m_snapshot;
+    for (unsigned int i=0; i<test.m_objects.size(); i++)
+    {
+        delete test.m_objects[i];
+    }
+
+    return ((numTorn == 0) ? 0 : -1);
+}
+
+
+// run simulation ticks on a world of moving spheres: each tick moves a few
+// objects, updates the world and runs the proxy queries of a haptic tick
+void runBroadphaseTicks(cWorld* a_world,
+                        vector<cShapeSphere*>& a_objects,
+                        int a_numTicks,
+                        vector<double>& a_timings,
+                        int& a_numHits,
+                        double& a_distanceSum)
+{
+    cPrecisionClock clock;
+    cCollisionRecorder recorder;
+    cCollisionSettings settings;
+    settings.m_checkForNearestCollisionOnly = true;
+    settings.m_collisionRadius = 0.005;
+
+    a_numHits = 0;
+    a_distanceSum = 0.0;
+    a_timings.resize(a_numTicks);
+
+    randomSeed = 12345;
+    for (int i=0; i<a_numTicks; i++)
+    {
+        vector<cShapeSphere*> moved;
+        for (int j=0; j<10; j++)
+        {
+            int index = (int)(randomUniform() * (double)(a_objects.size() - 1));
+            cVector3d offset(0.01 * (randomUniform() - 0.5), 0.01 * (randomUniform() - 0.5), 0.01 * (randomUniform() - 0.5));
+            moved.push_back(a_objects[index]);
+            moved.back()->setLocalPos(moved.back()->getLocalPos() + offset);
+        }
+
+        vector<BenchSegment> segments(3);
+        for (int j=0; j<3; j++)
+        {
+            segments[j].m_pointA.set(randomUniform(), randomUniform(), 0.2 * randomUniform());
+            segments[j].m_pointB = segments[j].m_pointA + cVector3d(0.002 * (randomUniform() - 0.5), 0.002 * (randomUniform() - 0.5), 0.002 * (randomUniform() - 0.5));
+        }
+
+        double t0 = clock.getCPUTimeSeconds();
+        a_world->computeGlobalPositions(true);
+        for (int j=0; j<3; j++)
+        {
+            recorder.clear();
+            if (a_world->computeCollisionDetection(segments[j].m_pointA, segments[j].m_pointB, recorder, settings))
+            {
+                a_numHits++;
+                a_distanceSum += recorder.m_nearestCollision.m_squareDistance;
+            }
+        }
+        a_timings[i] = clock.getCPUTimeSeconds() - t0;
+    }
+}
+
+
+// broadphase benchmark: full simulation tick (world update and proxy queries)
+// on a large scene, with and without broadphase
+int benchmarkBroadphase()
+{
+    const int size = 40;
+    cout << "broadphase (" << size * size * 5 << " spheres, " << numFrames << " ticks)" << endl;
+
+    int result = 0;
+    int numHits[2];
+    double distanceSum[2];
+    for (int pass=0; pass<2; pass++)
+    {
+        cWorld* world = new cWorld();
+        vector<cShapeSphere*> objects;
+        for (int i=0; i<size; i++)
+        {
+            for (int j=0; j<size; j++)
+            {
+                for (int k=0; k<5; k++)
+                {
+                    cShapeSphere* object = new cShapeSphere(0.008);
+                    object->setLocalPos((double)i / (double)size, (double)j / (double)size, 0.04 * (double)k);
+                    world->addChild(object);
+                    objects.push_back(object);
+                }
+            }
+        }
+        world->setUseBroadphase(pass == 1);
+        world->computeGlobalPositions(true);
+
+        vector<double> timings;
+        runBroadphaseTicks(world, objects, numFrames, timings, numHits[pass], distanceSum[pass]);
+        printStats((pass == 1) ? "tick (broadphase)" : "tick (all objects)", computeStats(timings));
+
+        delete world;
+    }
+
+    if ((numHits[0] != numHits[1]) || (fabs(distanceSum[0] - distanceSum[1]) > 1e-12))
+    {
+        cout << "  error: results differ" << endl;
+        result = -1;
+    }
+    else
+    {
+        cout << "  results match (" << numHits[0] << " hits)" << endl;
+    }
+    cout << endl;
+
+    return (result);
+}
+
+
+// estimate the memory used by the vertex and triangle arrays of a model
+size_t computeModelMemory(cMultiMesh* a_model)
+{
+    size_t size = 0;
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cMesh* mesh = a_model->getMesh(i);
+        cVertexArrayPtr vertices = mesh->m_vertices;
+        size += vertices->m_localPos.capacity() * sizeof(cVector3d);
+        size += vertices->m_globalPos.capacity() * sizeof(cVector3d);
+        size += vertices->m_normal.capacity() * sizeof(cVector3d);
+        size += vertices->m_texCoord.capacity() * sizeof(cVector3d);
+        size += vertices->m_color.capacity() * sizeof(cColorf);
+        size += vertices->m_tangent.capacity() * sizeof(cVector3d);
+        size += vertices->m_bitangent.capacity() * sizeof(cVector3d);
+        size += vertices->m_userData.capacity() * sizeof(int);
+        size += mesh->m_triangles->m_indices.capacity() * sizeof(unsigned int);
+        size += mesh->m_triangles->m_allocated.capacity() / 8;
+    }
+    return (size);
+}
+
+
+// compute the surface area of a model
+double computeModelArea(cMultiMesh* a_model)
+{
+    double area = 0.0;
+    for (int i=0; i<a_model->getNumMeshes(); i++)
+    {
+        cMesh* mesh = a_model->getMesh(i);
+        int numTriangles = mesh->getNumTriangles();
+        for (int j=0; j<numTriangles; j++)
+        {
+            cVector3d vertex0 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex0(j));
+            cVector3d vertex1 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex1(j));
+            cVector3d vertex2 = mesh->m_vertices->getLocalPos(mesh->m_triangles->getVertexIndex2(j));
+            area += 0.5 * cCross(vertex1 - vertex0, vertex2 - vertex0).length();
+        }
+    }
+    return (area);
+}
+
+
+// load a model with the given vertex welding settings and report load time and memory
+double loadWeldedModel(string a_filename, bool a_weld, double a_tolerance, string a_label)
+{
+    g_objLoaderWeldVertices = a_weld;
+    g_objLoaderWeldingTolerance = a_tolerance;
+    g_stlLoaderWeldVertices = a_weld;
+    g_stlLoaderWeldingTolerance = a_tolerance;
+
+    cMultiMesh* model = new cMultiMesh();
+    cPrecisionClock clock;
+    clock.start(true);
+    bool result = model->loadFromFile(a_filename);
+    double time = clock.getCurrentTimeSeconds();
+
+    double area = -1.0;
+    if (result)
+    {
+        area = computeModelArea(model);
+        cout << "  " << left << setw(24) << a_label << right << fixed << setprecision(3)
+             << "load " << setw(9) << 1e3 * time << " ms   "
+             << setw(9) << model->getNumVertices() << " vertices   "
+             << setw(9) << model->getNumTriangles() << " triangles   "
+             << setprecision(2) << setw(8) << (double)(computeModelMemory(model)) / 1048576.0 << " MB" << endl;
+    }
+
+    delete model;
+
+    g_objLoaderWeldVertices = false;
+    g_objLoaderWeldingTolerance = 0.0;
+    g_stlLoaderWeldVertices = false;
+    g_stlLoaderWeldingTolerance = 0.0;
+
+    return (area);
+}
+
+
+// model loading benchmark: separate versus welded vertices
+int benchmarkLoad(string a_filename)
+{
+    cout << "loading " << a_filename << " with and without vertex welding..." << endl;
+
+    // express welding tolerance relative to model size
+    double tolerance = 0.0;
+    if (relativeWeldingTolerance > 0.0)
+    {
+        cMultiMesh* model = new cMultiMesh();
+        if (!model->loadFromFile(a_filename))
+        {
+            cout << "error: cannot load model file " << a_filename << endl;
+            delete model;
+            return (-1);
+        }
+        model->computeBoundaryBox(true);
+        tolerance = relativeWeldingTolerance * cDistance(model->getBoundaryMin(), model->getBoundaryMax());
+        delete model;
+    }
+
+    double areaSeparate = loadWeldedModel(a_filename, false, 0.0, "separate vertices");
+    double areaWelded = loadWeldedModel(a_filename, true, tolerance, "welded vertices");
+    if ((areaSeparate < 0.0) || (areaWelded < 0.0))
+    {
+        cout << "error: cannot load model file " << a_filename << endl << endl;
+        return (-1);
+    }
+
+    // welding with a zero tolerance must preserve the surface exactly
+    if ((tolerance == 0.0) && (cAbs(areaSeparate - areaWelded) > C_SMALL * cMax(1.0, areaSeparate)))
+    {
+        cout << "  error: surface areas differ (" << areaSeparate << " / " << areaWelded << ")" << endl << endl;
+        return (-1);
+    }
+    cout << endl;
+
+    return (0);
+}
+
+
+// OBJ parser benchmark: standard library versus memory-mapped parallel parser
+int benchmarkParser(string a_filename)
+{
+    if (cStrToLower(cGetFileExtension(a_filename)) != "obj") return (0);
+
+    cout << "parsing " << a_filename << "..." << endl;
+
+    int numVertices[2], numTriangles[2];
+    double area[2];
+    for (int i=0; i<2; i++)
+    {
+        g_objLoaderUseFastParser = (i == 1);
+
+        cMultiMesh* model = new cMultiMesh();
+        cPrecisionClock clock;
+        clock.start(true);
+        bool result = model->loadFromFile(a_filename);
+        double time = clock.getCurrentTimeSeconds();
+        if (!result)
+        {
+            cout << "error: cannot load model file " << a_filename << endl << endl;
+            delete model;
+            g_objLoaderUseFastParser = true;
+            return (-1);
+        }
+
+        numVertices[i] = model->getNumVertices();
+        numTriangles[i] = model->getNumTriangles();
+        area[i] = computeModelArea(model);
+        cout << "  " << left << setw(24) << ((i == 0) ? "standard parser" : "mapped parser") << right << fixed << setprecision(3)
+             << "load " << setw(9) << 1e3 * time << " ms" << endl;
+
+        delete model;
+    }
+    g_objLoaderUseFastParser = true;
+
+    // both parsers must produce the same meshes, unless the file contains lines the standard parser ignores
+    if ((numVertices[0] != numVertices[1]) || (numTriangles[0] != numTriangles[1]) || (area[0] != area[1]))
+    {
+        cout << "  warning: models differ (" << numTriangles[0] << " / " << numTriangles[1] << " triangles)" << endl;
+    }
+    cout << endl;
+
+    return (0);
+}
+
+
+// cached model benchmark: source file versus CMESH cache file
+int benchmarkCache(string a_filename)
+{
+    cout << "loading " << a_filename << " from its source and cache files..." << endl;
+
+    // write the cache file in the current directory
+    g_meshLoaderUseCache = true;
+    g_meshLoaderCacheDirectory = ".";
+    string cacheFilename = cGetCacheFilenameCMESH(a_filename);
+    remove(cacheFilename.c_str());
+
+    // the first load parses the source file and creates the cache file, the second load restores it
+    cMultiMesh* models[2] = { NULL, NULL };
+    double radius = 0.0;
+    int result = 0;
+    for (int i=0; (i<2) && (result == 0); i++)
+    {
+        models[i] = new cMultiMesh();
+        cPrecisionClock clock;
+        clock.start(true);
+        if (!models[i]->loadFromFile(a_filename))
+        {
+            cout << "error: cannot load model file " << a_filename << endl;
+            result = -1;
+            break;
+        }
+        double loadTime = clock.getCurrentTimeSeconds();
+
+        models[i]->computeBoundaryBox(true);
+        radius = relativeRadius * cDistance(models[i]->getBoundaryMin(), models[i]->getBoundaryMax());
+
+        clock.start(true);
+        models[i]->createAABBCollisionDetector(radius, C_AABB_BUILD_SAH);
+        double buildTime = clock.getCurrentTimeSeconds();
+
+        cout << "  " << left << setw(24) << ((i == 0) ? "source file" : "cache file") << right << fixed << setprecision(3)
+             << "load " << setw(9) << 1e3 * loadTime << " ms   "
+             << "collision tree " << setw(9) << 1e3 * buildTime << " ms   "
+             << "total " << setw(9) << 1e3 * (loadTime + buildTime) << " ms" << endl;
+    }
+
+    // both models must produce the same collisions
+    if (result == 0)
+    {
+        vector<BenchSegment> segments;
+        createSegments(models[0], 4.0 * radius, segments);
+
+        vector<double> timings;
+        double distanceSum[2];
+        int numHits[2];
+        for (int i=0; i<2; i++)
+        {
+            numHits[i] = runQueries(models[i], segments, radius, timings, distanceSum[i]);
+        }
+
+        if ((numHits[0] != numHits[1]) || (distanceSum[0] != distanceSum[1]) || 
+            (computeModelArea(models[0]) != computeModelArea(models[1])))
+        {
+            cout << "  error: models differ (" << numHits[0] << " / " << numHits[1] << " hits)" << endl;
+            result = -1;
+        }
+    }
+    cout << endl;
+
+    // cleanup
+    delete models[0];
+    delete models[1];
+    remove(cacheFilename.c_str());
+    g_meshLoaderUseCache = false;
+    g_meshLoaderCacheDirectory = "";
+
+    return (result);
+}
+
+
+// create a world containing a model and a set of tools (two cursors and a gripper)
+cWorld* createToolWorld(string a_filename, double a_radius, vector<cGenericTool*>& a_tools)
+{
+    cWorld* world = new cWorld();
+    cMultiMesh* model = new cMultiMesh();
+    world->addChild(model);
+    model->loadFromFile(a_filename);
+    model->createAABBCollisionDetector(a_radius);
+    model->setStiffness(1000.0, true);
+    world->computeGlobalPositions(true);
+
+    a_tools.clear();
+    for (int i=0; i<2; i++)
+    {
+        cToolCursor* cursor = new cToolCursor(world);
+        cursor->setRadius(a_radius);
+        a_tools.push_back(cursor);
+    }
+
+    cToolGripper* gripper = new cToolGripper(world);
+    gripper->setHapticDevice(cGenericHapticDevice::create());
+    gripper->setRadius(a_radius);
+    a_tools.push_back(gripper);
+
+    return (world);
+}
+
+
+// move the tools along the segments and compute their forces, either tool
+// by tool or through a tool group, and record the resulting forces
+void runTools(vector<cGenericTool*>& a_tools,
+              cToolGroup* a_group,
+              vector<BenchSegment>& a_segments,
+              int a_stepsPerSegment,
+              vector<double>& a_timings,
+              vector<cVector3d>& a_forces)
+{
+    cPrecisionClock clock;
+    int numTools = (int)(a_tools.size());
+    int numTicks = ((int)(a_segments.size()) / numTools) * a_stepsPerSegment;
+
+    a_timings.resize(numTicks);
+    a_forces.resize(2 * numTicks * numTools);
+
+    for (int tick=0; tick<numTicks; tick++)
+    {
+        int step = tick % a_stepsPerSegment;
+        double t = (double)(step) / (double)(a_stepsPerSegment - 1);
+
+        for (int i=0; i<numTools; i++)
+        {
+            BenchSegment& segment = a_segments[(tick / a_stepsPerSegment) * numTools + i];
+            if (step == 0)
+            {
+                for (int j=0; j<a_tools[i]->getNumHapticPoints(); j++)
+                {
+                    a_tools[i]->getHapticPoint(j)->initialize(segment.m_pointA);
+                }
+            }
+            a_tools[i]->setDeviceGlobalPos(segment.m_pointA + t * (segment.m_pointB - segment.m_pointA));
+        }
+
+        double t0 = clock.getCPUTimeSeconds();
+        if (a_group != NULL)
+        {
+            a_group->computeInteractionForces();
+        }
+        else
+        {
+            for (int i=0; i<numTools; i++)
+            {
+                a_tools[i]->computeInteractionForces();
+            }
+        }
+        a_timings[tick] = clock.getCPUTimeSeconds() - t0;
+
+        for (int i=0; i<numTools; i++)
+        {
+            a_forces[2 * (tick * numTools + i)]     = a_tools[i]->getDeviceGlobalForce();
+            a_forces[2 * (tick * numTools + i) + 1] = a_tools[i]->getDeviceGlobalTorque();
+        }
+    }
+}
+
+
+// compute the forces of several tools sequentially and through a tool group
+int benchmarkToolGroup(string a_filename)
+{
+    cout << "tool group " << a_filename << endl;
+
+    // create two identical worlds
+    cMultiMesh* model = new cMultiMesh();
+    if (!model->loadFromFile(a_filename))
+    {
+        cout << "error: cannot load model file " << a_filename << endl;
+        delete model;
+        return (-1);
+    }
+    model->computeBoundaryBox(true);
+    double size = cDistance(model->getBoundaryMin(), model->getBoundaryMax());
+    double radius = relativeRadius * size;
+
+    vector<BenchSegment> segments;
+    createSegments(model, 4.0 * radius, segments);
+    delete model;
+
+    vector<cGenericTool*> sequentialTools, groupTools;
+    cWorld* sequentialWorld = createToolWorld(a_filename, radius, sequentialTools);
+    cWorld* groupWorld = createToolWorld(a_filename, radius, groupTools);
+
+    cToolGroup group;
+    for (unsigned int i=0; i<groupTools.size(); i++)
+    {
+        group.addTool(groupTools[i]);
+    }
+
+    // run both modes over the same trajectories
+    const int stepsPerSegment = 20;
+    vector<double> timings;
+    vector<cVector3d> sequentialForces, groupForces;
+
+    runTools(sequentialTools, NULL, segments, stepsPerSegment, timings, sequentialForces);
+    printStats("sequential tools", computeStats(timings));
+
+    runTools(groupTools, &group, segments, stepsPerSegment, timings, groupForces);
+    stringstream label;
+    label << "tool group (" << group.getNumThreads() << " threads)";
+    printStats(label.str(), computeStats(timings));
+
+    // compare results
+    int numContacts = 0;
+    int numDifferences = 0;
+    for (unsigned int i=0; i<sequentialForces.size(); i++)
+    {
+        if (!sequentialForces[i].equals(groupForces[i])) numDifferences++;
+        if ((i % 2 == 0) && (sequentialForces[i].lengthsq() > 0.0)) numContacts++;
+    }
+    cout << "  " << numContacts << " / " << sequentialForces.size() / 2 << " tool updates in contact";
+    if (numDifferences == 0)
+    {
+        cout << ", results match" << endl << endl;
+    }
+    else
+    {
+        cout << ", error: " << numDifferences << " forces or torques differ" << endl << endl;
+    }
+
+    for (unsigned int i=0; i<sequentialTools.size(); i++)
+    {
+        delete sequentialTools[i];
+        delete groupTools[i];
+    }
+    delete sequentialWorld;
+    delete groupWorld;
+
+    return ((numDifferences == 0) ? 0 : -1);
+}
+
+
+// fill a simulated device with the recorded trajectory, or with a synthetic
+// trajectory sweeping the workspace while rotating and opening the gripper
+bool createTrajectory(cSimulatedDevicePtr a_device, int a_numTicks)
+{
+    if (trajectoryFilename != "")
+    {
+        return (a_device->loadTrajectory(trajectoryFilename));
+    }
+
+    double radius = 0.8 * a_device->getSpecifications().m_workspaceRadius;
+    double timeStep = a_device->getTimeStep();
+    a_device->clearTrajectory();
+    for (int i=0; i<a_numTicks; i++)
+    {
+        double t = timeStep * (double)(i);
+        cSimulatedDeviceState state;
+        state.m_position.set(radius * sin(2.0 * C_PI * 1.3 * t),
+                             radius * sin(2.0 * C_PI * 0.7 * t + 0.5),
+                             radius * sin(2.0 * C_PI * 0.3 * t + 1.0));
+        state.m_rotation.setAxisAngleRotationRad(0.0, 0.0, 1.0, 0.5 * sin(2.0 * C_PI * 0.4 * t));
+        state.m_gripperAngle = cDegToRad(15.0) * (1.0 + sin(2.0 * C_PI * 2.0 * t));
+        a_device->addState(state);
+    }
+
+    return (true);
+}
+
+
+// create a scene of primitive shapes
+cWorld* createShapeScene()
+{
+    cWorld* world = new cWorld();
+
+    cShapeSphere* sphere = new cShapeSphere(0.3);
+    sphere->setLocalPos(0.0, -0.5, 0.0);
+    sphere->createEffectSurface();
+    world->addChild(sphere);
+
+    cShapeBox* box = new cShapeBox(0.4, 0.4, 0.4);
+    box->setLocalPos(0.0, 0.5, 0.0);
+    box->createEffectSurface();
+    world->addChild(box);
+
+    cShapeCylinder* cylinder = new cShapeCylinder(0.2, 0.2, 0.4);
+    cylinder->setLocalPos(0.5, 0.0, 0.3);
+    cylinder->createEffectSurface();
+    world->addChild(cylinder);
+
+    cShapeTorus* torus = new cShapeTorus(0.08, 0.25);
+    torus->setLocalPos(-0.4, 0.0, -0.3);
+    torus->createEffectSurface();
+    world->addChild(torus);
+
+    world->setStiffness(200.0, true);
+
+    return (world);
+}
+
+
+// create a scene containing a model scaled to the workspace
+cWorld* createMeshScene(string a_filename, double a_toolRadius)
+{
+    cMultiMesh* model = new cMultiMesh();
+    if (!model->loadFromFile(a_filename))
+    {
+        delete model;
+        return (NULL);
+    }
+
+    model->computeBoundaryBox(true);
+    double size = cDistance(model->getBoundaryMin(), model->getBoundaryMax());
+    cVector3d center = 0.5 * (model->getBoundaryMin() + model->getBoundaryMax());
+    double scale = 1.2 / size;
+    model->scale(scale);
+    model->setLocalPos(-scale * center);
+    model->createAABBCollisionDetector(a_toolRadius);
+    model->setStiffness(200.0, true);
+
+    cWorld* world = new cWorld();
+    world->addChild(model);
+
+    return (world);
+}
+
+
+// create a scene containing a voxel volume: a sphere crossed by a tunnel
+cWorld* createVoxelScene()
+{
+    const int resolution = 64;
+
+    cVoxelObject* object = new cVoxelObject();
+    object->m_minCorner.set(-0.5,-0.5,-0.5);
+    object->m_maxCorner.set( 0.5, 0.5, 0.5);
+    object->m_minTextureCoord.set(0.0, 0.0, 0.0);
+    object->m_maxTextureCoord.set(1.0, 1.0, 1.0);
+    object->setStiffness(200.0);
+
+    cMultiImagePtr image = cMultiImage::create();
+    image->allocate(resolution, resolution, resolution, GL_RGBA);
+    for (int z=0; z<resolution; z++)
+    {
+        for (int y=0; y<resolution; y++)
+        {
+            for (int x=0; x<resolution; x++)
+            {
+                cVector3d p((x + 0.5) / resolution - 0.5, (y + 0.5) / resolution - 0.5, (z + 0.5) / resolution - 0.5);
+                bool inside = (p.length() < 0.45) && ((p(0) * p(0) + p(1) * p(1)) > 0.15 * 0.15);
+                image->setVoxelColor(x, y, z, inside ? cColorb(0xff, 0x80, 0x40, 0xff) : cColorb(0x00, 0x00, 0x00, 0x00));
+            }
+        }
+    }
+
+    cTexture3dPtr texture = cTexture3d::create();
+    object->setTexture(texture);
+    texture->setImage(image);
+    object->invalidateOccupancy();
+
+    cWorld* world = new cWorld();
+    world->addChild(object);
+
+    return (world);
+}
+
+
+// create a scene of objects with haptic effects and friction
+cWorld* createEffectScene()
+{
+    cWorld* world = new cWorld();
+
+    // magnetic sphere with a viscous surface
+    cShapeSphere* magnet = new cShapeSphere(0.3);
+    magnet->setLocalPos(0.0, -0.5, 0.0);
+    magnet->m_material->setStiffness(200.0);
+    magnet->m_material->setMagnetMaxForce(3.0);
+    magnet->m_material->setMagnetMaxDistance(0.15);
+    magnet->m_material->setViscosity(2.0);
+    magnet->createEffectSurface();
+    magnet->createEffectMagnetic();
+    magnet->createEffectViscosity();
+    world->addChild(magnet);
+
+    // stick-slip sphere
+    cShapeSphere* stickSlip = new cShapeSphere(0.3);
+    stickSlip->setLocalPos(0.0, 0.5, 0.0);
+    stickSlip->m_material->setStickSlipForceMax(1.5);
+    stickSlip->m_material->setStickSlipStiffness(140.0);
+    stickSlip->m_material->setStiffness(200.0);
+    stickSlip->createEffectSurface();
+    stickSlip->createEffectStickSlip();
+    world->addChild(stickSlip);
+
+    // box with static and dynamic friction
+    cShapeBox* box = new cShapeBox(0.5, 0.5, 0.3);
+    box->setLocalPos(0.0, 0.0, -0.45);
+    box->m_material->setStiffness(200.0);
+    box->m_material->setStaticFriction(0.4);
+    box->m_material->setDynamicFriction(0.2);
+    box->createEffectSurface();
+    world->addChild(box);
+
+    return (world);
+}
+
+
+// drive a cursor tool through a scene with a simulated device, and record the
+// latency of each haptic tick together with the force sent to the device;
+// paced ticks run at about 1 kHz, so that a local model is extracted at its
+// nominal rate
+cToolCursor* runHapticTicks(cWorld* a_world,
+                            double a_toolRadius,
+                            int a_numTicks,
+                            bool a_useContactCache,
+                            bool a_useLocalModel,
+                            bool a_paced,
+                            vector<double>& a_timings,
+                            vector<cVector3d>& a_forces)
+{
+    // create device and tool
+    cSimulatedDevicePtr device = cSimulatedDevice::create();
+    if (!createTrajectory(device, a_numTicks))
+    {
+        return (NULL);
+    }
+
+    cToolCursor* tool = new cToolCursor(a_world);
+    a_world->addChild(tool);
+    tool->setHapticDevice(device);
+    tool->setRadius(a_toolRadius);
+    tool->setWorkspaceRadius(1.0);
+    tool->setWaitForSmallForce(false);
+    tool->setUseForceRise(false);
+    tool->start();
+    tool->getHapticPoint(0)->m_algorithmFingerProxy->setUseContactCache(a_useContactCache);
+    tool->getHapticPoint(0)->m_algorithmFingerProxy->setUseLocalModel(a_useLocalModel);
+    a_world->computeGlobalPositions(true);
+
+    // run haptic ticks
+    cPrecisionClock clock;
+    int numTicks = (int)(device->getNumStates());
+    a_timings.resize(numTicks);
+    a_forces.resize(numTicks);
+    for (int i=0; i<numTicks; i++)
+    {
+        if (i > 0) device->step();
+
+        double t0 = clock.getCPUTimeSeconds();
+        tool->updateFromDevice();
+        tool->computeInteractionForces();
+        tool->applyToDevice();
+        a_timings[i] = clock.getCPUTimeSeconds() - t0;
+
+        device->getForce(a_forces[i]);
+
+        if (a_paced) cSleepMs(1);
+    }
+
+    tool->stop();
+    tool->getHapticPoint(0)->m_algorithmFingerProxy->setUseLocalModel(false);
+
+    return (tool);
+}
+
+
+// drive a cursor tool through a scene and report the latency of each haptic
+// tick together with the computed forces
+int benchmarkHaptics(string a_label, cWorld* a_world, double a_toolRadius)
+{
+    cout << "haptic scene " << a_label << endl;
+
+    if (a_world == NULL)
+    {
+        cout << "  error: cannot create scene" << endl << endl;
+        return (-1);
+    }
+
+    vector<double> timings;
+    vector<cVector3d> forces;
+    if (runHapticTicks(a_world, a_toolRadius, numQueries, false, false, false, timings, forces) == NULL)
+    {
+        cout << "  error: cannot load trajectory " << trajectoryFilename << endl << endl;
+        delete a_world;
+        return (-1);
+    }
+
+    int numTicks = (int)(forces.size());
+    int numContacts = 0;
+    double maxForce = 0.0;
+    double meanForce = 0.0;
+    cVector3d sumForce(0.0, 0.0, 0.0);
+    for (int i=0; i<numTicks; i++)
+    {
+        double magnitude = forces[i].length();
+        if (magnitude > 0.0) numContacts++;
+        maxForce = cMax(maxForce, magnitude);
+        meanForce += magnitude / (double)(numTicks);
+        sumForce.add(forces[i]);
+
+        if (forcesFile != NULL)
+        {
+            fprintf(forcesFile, "%s,%d,%.17g,%.17g,%.17g\n", a_label.c_str(), i, forces[i](0), forces[i](1), forces[i](2));
+        }
+    }
+
+    printStats("haptic tick", computeStats(timings));
+    cout << "  " << numContacts << " / " << numTicks << " ticks with force   "
+         << "mean " << setprecision(6) << meanForce << " N   max " << maxForce << " N   "
+         << "sum (" << sumForce.str(9) << ")" << endl << endl;
+
+    delete a_world;
+
+    return (0);
+}
+
+
+// compare the haptic ticks of a cursor tool with and without contact cache
+int benchmarkContactCache(string a_filename, double a_toolRadius)
+{
+    cout << "contact cache " << a_filename << endl;
+
+    cWorld* worlds[2] = { createMeshScene(a_filename, a_toolRadius), createMeshScene(a_filename, a_toolRadius) };
+    if ((worlds[0] == NULL) || (worlds[1] == NULL))
+    {
+        cout << "  error: cannot create scene" << endl << endl;
+        delete worlds[0];
+        delete worlds[1];
+        return (-1);
+    }
+
+    vector<double> timings[2];
+    vector<cVector3d> forces[2];
+    cToolCursor* tool = NULL;
+    for (int i=0; i<2; i++)
+    {
+        tool = runHapticTicks(worlds[i], a_toolRadius, numQueries, (i == 1), false, false, timings[i], forces[i]);
+        if (tool == NULL)
+        {
+            cout << "  error: cannot load trajectory " << trajectoryFilename << endl << endl;
+            delete worlds[0];
+            delete worlds[1];
+            return (-1);
+        }
+    }
+
+    printStats("without cache", computeStats(timings[0]));
+    printStats("with cache", computeStats(timings[1]));
+
+    int numDifferences = 0;
+    for (unsigned int i=0; i<forces[0].size(); i++)
+    {
+        if (!forces[0][i].equals(forces[1][i])) numDifferences++;
+    }
+
+    cCollisionCache& cache = tool->getHapticPoint(0)->m_algorithmFingerProxy->getContactCache();
+    cout << "  " << cache.getNumCacheHits() << " hits, " << cache.getNumCacheMisses() << " misses ("
+         << setprecision(1) << 100.0 * cache.getHitRate() << "%), " << cache.getNumRebuilds() << " rebuilds";
+    if (numDifferences == 0)
+    {
+        cout << ", results match" << endl << endl;
+    }
+    else
+    {
+        cout << ", error: " << numDifferences << " forces differ" << endl << endl;
+    }
+
+    delete worlds[0];
+    delete worlds[1];
+
+    return ((numDifferences == 0) ? 0 : -1);
+}
+
+
+// compare the haptic ticks of a cursor tool querying the world and querying a
+// local model extracted by a background thread
+int benchmarkLocalModel(string a_filename, double a_toolRadius)
+{
+    cout << "local model " << a_filename << endl;
+
+    cWorld* worlds[2] = { createMeshScene(a_filename, a_toolRadius), createMeshScene(a_filename, a_toolRadius) };
+    if ((worlds[0] == NULL) || (worlds[1] == NULL))
+    {
+        cout << "  error: cannot create scene" << endl << endl;
+        delete worlds[0];
+        delete worlds[1];
+        return (-1);
+    }
+
+    // ticks are paced in real time, so limit their number
+    int numTicks = cMin(numQueries, 3000);
+
+    vector<double> timings[2];
+    vector<cVector3d> forces[2];
+    cToolCursor* tool = NULL;
+    for (int i=0; i<2; i++)
+    {
+        tool = runHapticTicks(worlds[i], a_toolRadius, numTicks, false, (i == 1), true, timings[i], forces[i]);
+        if (tool == NULL)
+        {
+            cout << "  error: cannot load trajectory " << trajectoryFilename << endl << endl;
+            delete worlds[0];
+            delete worlds[1];
+            return (-1);
+        }
+    }
+
+    printStats("world queries", computeStats(timings[0]));
+    printStats("local model", computeStats(timings[1]));
+
+    int numDifferences = 0;
+    for (unsigned int i=0; i<forces[0].size(); i++)
+    {
+        if (!forces[0][i].equals(forces[1][i])) numDifferences++;
+    }
+
+    cAlgorithmFingerProxy* proxy = tool->getHapticPoint(0)->m_algorithmFingerProxy;
+    unsigned int numHits = proxy->getNumLocalModelHits();
+    unsigned int numMisses = proxy->getNumLocalModelMisses();
+    cout << "  " << numHits << " local queries, " << numMisses << " world queries ("
+         << setprecision(1) << 100.0 * (double)(numHits) / (double)(cMax(1u, numHits + numMisses)) << "%), "
+         << proxy->getNumLocalModelUpdates() << " updates";
+    if (numDifferences == 0)
+    {
+        cout << ", results match" << endl << endl;
+    }
+    else
+    {
+        cout << ", error: " << numDifferences << " forces differ" << endl << endl;
+    }
+
+    delete worlds[0];
+    delete worlds[1];
+
+    return ((numDifferences == 0) ? 0 : -1);
+}
+
+
+// simple usage printer
+int usage()
+{
+    cout << endl << "cbench [-n queries] [-f frames] [-r radius] [-s seconds] [-w tolerance] [-p trajectory] [-o forces.csv] [model.{obj|3ds|stl} ...]" << endl;
+    cout << "\t-n\tnumber of queries per benchmark (default " << numQueries << ")" << endl;
+    cout << "\t-f\tnumber of deformation frames per refit benchmark (default " << numFrames << ")" << endl;
+    cout << "\t-s\tduration of the haptic scheduler benchmark, 0 to skip (default " << schedulerDuration << ")" << endl;
+    cout << "\t-r\thaptic point radius relative to model size (default " << relativeRadius << ")" << endl;
+    cout << "\t-w\tvertex welding tolerance relative to model size (default " << relativeWeldingTolerance << ")" << endl;
+    cout << "\t-p\tdevice trajectory replayed by the haptic benchmarks (default synthetic)" << endl;
+    cout << "\t-o\tCSV file receiving the forces computed by the haptic benchmarks" << endl;
+    cout << "\t-h\tdisplay this message" << endl << endl;
+
+    return -1;
+}
+
+
+//===========================================================================
+/*
+    UTILITY:    cbench.cpp
+
+    This utility measures the performance of the CHAI3D haptic rendering
+    pipeline without requiring a haptic device or a display. If no model is
+    specified, the models of the 23-tooth and 24-turntable examples are used.
+ */
+//===========================================================================
+
+int main(int argc, char* argv[])
+{
+    vector<string> models;
+
+    // process arguments
+    for (int i=1; i<argc; i++)
+    {
+        if (argv[i][0] != '-') {
+            models.push_back(string(argv[i]));
+        }
+        else switch (argv[i][1]) {
+            case 'h':
+                return usage ();
+            case 'n':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    numQueries = atoi(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 'f':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    numFrames = atoi(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 'r':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    relativeRadius = atof(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 's':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    schedulerDuration = atof(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 'w':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    relativeWeldingTolerance = atof(argv[i]);
+                }
+                else return usage ();
+                break;
+            case 'p':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    trajectoryFilename = argv[i];
+                }
+                else return usage ();
+                break;
+            case 'o':
+                if ((i+1 < argc) && (argv[i+1][0] != '-')) {
+                    i++;
+                    forcesFilename = argv[i];
+                }
+                else return usage ();
+                break;
+            default:
+                return usage ();
+        }
+    }
+    if ((numQueries <= 0) || (numFrames <= 0) || (schedulerDuration < 0.0) || (relativeWeldingTolerance < 0.0)) return usage();
+
+    // default models
+    if (models.size() == 0)
+    {
+        models.push_back("../resources/models/tooth/tooth.obj");
+        models.push_back("../resources/models/turntable/turntable.obj");
+    }
+
+    // pretty message
+    cout << endl;
+    cout << "-----------------------------------" << endl;
+    cout << "CHAI3D" << endl;
+    cout << "Benchmark" << endl;
+    cout << "Copyright 2003-2016" << endl;
+    cout << "-----------------------------------" << endl;
+    cout << endl;
+
+    // run benchmarks
+    int result = 0;
+    for (unsigned int i=0; i<models.size(); i++)
+    {
+        if (benchmarkParser(models[i]) < 0) result = -1;
+        if (benchmarkLoad(models[i]) < 0) result = -1;
+        if (benchmarkCache(models[i]) < 0) result = -1;
+        if (benchmarkAABB(models[i]) < 0) result = -1;
+        if (benchmarkRefit(models[i], true) < 0) result = -1;
+        if (benchmarkRefit(models[i], false) < 0) result = -1;
+        if (benchmarkVertexBuffer(models[i], true) < 0) result = -1;
+        if (benchmarkVertexBuffer(models[i], false) < 0) result = -1;
+        if (benchmarkAdjacency(models[i]) < 0) result = -1;
+        if (benchmarkMeshKernels(models[i]) < 0) result = -1;
+        if (benchmarkToolGroup(models[i]) < 0) result = -1;
+    }
+
+    // run haptic benchmarks
+    if (forcesFilename != "")
+    {
+        forcesFile = fopen(forcesFilename.c_str(), "w");
+        if (forcesFile == NULL)
+        {
+            cout << "error: cannot create file " << forcesFilename << endl;
+            return (-1);
+        }
+        fprintf(forcesFile, "scene,tick,fx,fy,fz\n");
+    }
+
+    const double toolRadius = 0.02;
+    if (benchmarkHaptics("shapes", createShapeScene(), toolRadius) < 0) result = -1;
+    for (unsigned int i=0; i<models.size(); i++)
+    {
+        if (benchmarkHaptics("mesh " + models[i], createMeshScene(models[i], toolRadius), toolRadius) < 0) result = -1;
+        if (benchmarkContactCache(models[i], toolRadius) < 0) result = -1;
+        if (benchmarkLocalModel(models[i], toolRadius) < 0) result = -1;
+    }
+    if (benchmarkHaptics("voxels", createVoxelScene(), toolRadius) < 0) result = -1;
+    if (benchmarkHaptics("effects", createEffectScene(), toolRadius) < 0) result = -1;
+
+    if (forcesFile != NULL)
+    {
+        fclose(forcesFile);
+    }
+    if (schedulerDuration > 0.0)
+    {
+        if (benchmarkScheduler() < 0) result = -1;
+        if (benchmarkSnapshot() < 0) result = -1;
+    }
+    if (benchmarkBroadphase() < 0) result = -1;
+
+    return result;
+}
+
+//---------------------------------------------------------------------------